@@ -0,0 +1,75 @@
+# Compile an nmap-services style file into ServiceTableData.inc
+#
+# Each "name port/proto frequency" line becomes a static entry; entries are
+# emitted per protocol in descending open-frequency order so the array index
+# is the port's rank. The output is only rewritten when its content changes,
+# and CMake reconfigures when the input file is edited.
+
+function(lanscan_generate_service_table input output)
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${input}")
+
+    file(READ "${input}" content)
+    # Keep list handling safe: ';' and brackets have meaning in CMake lists
+    string(REGEX REPLACE "[;\\[\\]]" " " content "${content}")
+    string(REPLACE "\n" ";" lines "${content}")
+
+    set(tcp_keys "")
+    set(udp_keys "")
+
+    foreach(line IN LISTS lines)
+        if(line MATCHES "^([^# \t][^ \t]*)[ \t]+([0-9]+)/(tcp|udp)[ \t]+([0-9]+)\\.?([0-9]*)")
+            set(name "${CMAKE_MATCH_1}")
+            set(port "${CMAKE_MATCH_2}")
+            set(proto "${CMAKE_MATCH_3}")
+            set(whole "${CMAKE_MATCH_4}")
+            set(fraction "${CMAKE_MATCH_5}000000")
+            string(SUBSTRING "${fraction}" 0 6 fraction)
+
+            if(port GREATER 0 AND port LESS 65536 AND whole LESS 2)
+                # Sort key: frequency descending, then port ascending
+                math(EXPR inverse "99999 - ${port}")
+                string(LENGTH "${inverse}" length)
+                while(length LESS 5)
+                    set(inverse "0${inverse}")
+                    string(LENGTH "${inverse}" length)
+                endwhile()
+                list(APPEND ${proto}_keys "${whole}${fraction}|${inverse}|${port}|${whole}.${fraction}|${name}")
+            endif()
+        endif()
+    endforeach()
+
+    set(data "// Generated from ${input} by cmake/ServiceTable.cmake - do not edit\n")
+
+    foreach(proto tcp udp)
+        string(TOUPPER "${proto}" upper)
+        set(keys ${${proto}_keys})
+        list(SORT keys ORDER DESCENDING)
+
+        string(APPEND data "\nstatic const ServiceTable::Entry ${upper}_SERVICES[] = {\n")
+        set(count 0)
+        foreach(key IN LISTS keys)
+            string(REPLACE "|" ";" fields "${key}")
+            list(GET fields 2 port)
+            list(GET fields 3 frequency)
+            list(GET fields 4 name)
+            # First (most frequent) name wins for ports listed twice
+            if(NOT DEFINED seen_${proto}_${port})
+                set(seen_${proto}_${port} TRUE)
+                string(REPLACE "\\" "\\\\" name "${name}")
+                string(REPLACE "\"" "\\\"" name "${name}")
+                string(APPEND data "    { ${port}, \"${name}\", ${frequency} },\n")
+                math(EXPR count "${count} + 1")
+            endif()
+        endforeach()
+        string(APPEND data "    { 0, nullptr, 0.0 }\n};\n")
+        string(APPEND data "static const int ${upper}_SERVICE_COUNT = ${count};\n")
+        message(STATUS "Service table: ${count} ${proto} ports from ${input}")
+    endforeach()
+
+    if(EXISTS "${output}")
+        file(READ "${output}" previous)
+    endif()
+    if(NOT "${previous}" STREQUAL "${data}")
+        file(WRITE "${output}" "${data}")
+    endif()
+endfunction()
@@ -15,8 +15,10 @@
  * @class JitterChart
  * @brief Real-time jitter chart with spline series
  *
- * Displays network jitter over time using a smooth spline curve (purple).
- * Jitter represents the variance in latency and indicates network stability.
+ * Displays network jitter over time using a smooth spline curve (purple):
+ * the RFC 3550 interarrival jitter, with the windowed mean of the RTT
+ * differences as a thinner dashed curve. Jitter represents the variation
+ * in latency and indicates network stability.
  */
 class JitterChart : public QChartView {
     Q_OBJECT
@@ -40,6 +42,14 @@ public:
      */
     void addDataPoint(double jitter, const QDateTime& timestamp);
 
+    /**
+     * @brief Add a new data point to both jitter curves
+     * @param jitter RFC 3550 jitter in milliseconds
+     * @param windowedJitter Windowed jitter in milliseconds
+     * @param timestamp Time of the measurement
+     */
+    void addDataPoint(double jitter, double windowedJitter, const QDateTime& timestamp);
+
     /**
      * @brief Clear all chart data
      */
@@ -73,10 +83,12 @@ signals:
 private:
     QChart* chart;                      ///< Chart container
     QSplineSeries* jitterSeries;        ///< Jitter spline series
+    QSplineSeries* windowedSeries;      ///< Windowed jitter spline series
     QDateTimeAxis* axisX;               ///< Time axis (X)
     QValueAxis* axisY;                  ///< Jitter axis (Y)
 
     QList<QPointF> dataPoints;          ///< Jitter data points
+    QList<QPointF> windowedPoints;      ///< Windowed jitter data points
     int maxDataPointsLimit;             ///< Maximum data points to retain
 
     /**
@@ -89,6 +101,11 @@ private:
      */
     void setupAxes();
 
+    /**
+     * @brief Drop the oldest points beyond maxDataPointsLimit
+     */
+    void pruneData();
+
     /**
      * @brief Update chart with current data
      */
@@ -0,0 +1,80 @@
+#ifndef LATENCYDISTRIBUTIONCHART_H
+#define LATENCYDISTRIBUTIONCHART_H
+
+#include <QChartView>
+#include <QChart>
+#include <QBarSeries>
+#include <QBarSet>
+#include <QBarCategoryAxis>
+#include <QValueAxis>
+#include "utils/LatencyHistogram.h"
+
+/**
+ * @class LatencyDistributionChart
+ * @brief Latency distribution of a device as a bar chart
+ *
+ * Groups the buckets of a LatencyHistogram into at most MAX_BARS
+ * logarithmically spaced bars between the minimum and maximum latency,
+ * so tail latency stays visible next to the bulk of the samples. The
+ * title shows the median, p95 and p99.
+ */
+class LatencyDistributionChart : public QChartView {
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_BARS = 20;
+
+    /**
+     * @brief Constructor
+     * @param parent Optional parent widget
+     */
+    explicit LatencyDistributionChart(QWidget* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     */
+    ~LatencyDistributionChart() override = default;
+
+    /**
+     * @brief Show the distribution of a histogram
+     * @param histogram Latency histogram
+     */
+    void setHistogram(const LatencyHistogram& histogram);
+
+    /**
+     * @brief Clear all chart data
+     */
+    void clearData();
+
+signals:
+    /**
+     * @brief Emitted when chart data has been updated
+     */
+    void chartUpdated();
+
+private:
+    QChart* chart;                          ///< Chart container
+    QBarSeries* barSeries;                  ///< Bar series
+    QBarSet* samplesSet;                    ///< Share of samples per bar
+    QBarCategoryAxis* axisX;                ///< Latency axis (X)
+    QValueAxis* axisY;                      ///< Sample share axis (Y)
+
+    /**
+     * @brief Setup chart appearance and properties
+     */
+    void setupChart();
+
+    /**
+     * @brief Setup chart axes
+     */
+    void setupAxes();
+
+    /**
+     * @brief Format a latency for an axis label
+     * @param ms Latency in milliseconds
+     * @return Label text
+     */
+    static QString formatLatency(double ms);
+};
+
+#endif // LATENCYDISTRIBUTIONCHART_H
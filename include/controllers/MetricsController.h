@@ -3,15 +3,21 @@
 
 #include <QObject>
 #include <QString>
-#include <QMap>
+#include <QHash>
 #include <QTimer>
+#include "models/NetworkMetrics.h"
+#include "utils/LatencyHistogram.h"
 
 class MetricsAggregator;
+class MonitoringEngine;
 class DeviceRepository;
-class NetworkMetrics;
 
 /**
  * @brief Controls metrics collection and continuous monitoring
+ *
+ * All monitored devices share one MonitoringEngine, which probes them from
+ * a single socket and reports metrics per device. Metrics are written to
+ * the repository at most once per SAVE_INTERVAL_MS per device.
  */
 class MetricsController : public QObject {
     Q_OBJECT
@@ -29,6 +35,20 @@ public:
         QObject* parent = nullptr
     );
 
+    /**
+     * @brief Constructor over an existing monitoring engine
+     * @param aggregator Metrics aggregator instance (unused when engine is given)
+     * @param repository Device repository instance
+     * @param engine Monitoring engine (not owned), nullptr to create one
+     * @param parent Parent QObject
+     */
+    MetricsController(
+        MetricsAggregator* aggregator,
+        DeviceRepository* repository,
+        MonitoringEngine* engine,
+        QObject* parent = nullptr
+    );
+
     /**
      * @brief Destructor
      */
@@ -77,6 +97,23 @@ public:
      */
     int getMonitoredDeviceCount() const;
 
+    /**
+     * @brief Latency distribution of a monitored device since monitoring started
+     * @param deviceId Device identifier
+     * @return Histogram of the replies (empty if the device is not monitored)
+     */
+    LatencyHistogram latencyHistogram(const QString& deviceId) const;
+
+    /**
+     * @brief Take the latency distribution recorded since the previous call
+     *
+     * Used to store one histogram per history row; the rows' histograms
+     * then merge into the distribution of any time range.
+     * @param deviceId Device identifier
+     * @return Histogram of the replies since the previous call
+     */
+    LatencyHistogram takeLatencyHistogram(const QString& deviceId);
+
 signals:
     /**
      * @brief Emitted when metrics are collected for a device
@@ -105,19 +142,18 @@ signals:
     void monitoringStopped(const QString& deviceId);
 
 private slots:
-    void onMetricsUpdated(const NetworkMetrics& metrics);
-    void collectMetricsForDevice(const QString& deviceId);
+    void onMetricsUpdated(const QString& deviceId, const NetworkMetrics& metrics);
+    void flushMetrics();
 
 private:
-    MetricsAggregator* aggregator;
+    static constexpr int SAVE_INTERVAL_MS = 5000;
+
+    MonitoringEngine* engine;
     DeviceRepository* repository;
 
-    QMap<QString, QTimer*> monitoringTimers;
-    QString currentMonitoringDevice;  // Track currently monitored device
-    int defaultInterval;
+    QHash<QString, NetworkMetrics> unsavedMetrics;  // Latest per device since the last flush
+    QTimer* saveTimer;
 
-    void setupTimer(const QString& deviceId, int intervalMs);
-    void cleanupTimer(const QString& deviceId);
     void saveMetrics(const QString& deviceId, const NetworkMetrics& metrics);
 };
 
@@ -9,6 +9,8 @@
 class Device;
 class DeviceRepository;
 class DeviceCache;
+class PassiveDiscovery;
+class ScanCheckpointDao;
 
 /**
  * @brief Controls scan workflow and device management
@@ -64,6 +66,41 @@ public:
      */
     void resumeCurrentScan();
 
+    /**
+     * @brief Scan one host again, ahead of any scan in progress
+     * @param ip Host address
+     */
+    void rescanDevice(const QString& ip);
+
+    /**
+     * @brief Persist scan checkpoints so interrupted scans can be resumed
+     * @param dao Checkpoint DAO (not owned), nullptr disables checkpointing
+     */
+    void setCheckpointDao(ScanCheckpointDao* dao);
+
+    /**
+     * @brief Check for an interrupted scan that can be resumed
+     */
+    bool hasResumableScan();
+
+    /**
+     * @brief Most recent interrupted scan
+     * @return Invalid checkpoint if there is none
+     */
+    ScanCheckpoint latestResumableScan();
+
+    /**
+     * @brief Continue an interrupted scan from its last checkpoint
+     *
+     * Positions below the checkpoint cursor are not probed again; hosts that
+     * were alive but unfinished go straight back to the identity, DNS and
+     * port stages.
+     *
+     * @param checkpointId Scan to resume, empty for the most recent one
+     * @return false if there is no such resumable scan
+     */
+    bool resumeInterruptedScan(const QString& checkpointId = QString());
+
     /**
      * @brief Get all devices from cache and repository
      * @return List of all devices
@@ -75,6 +112,26 @@ public:
      */
     void clearAllDevices();
 
+    /**
+     * @brief Start listening for ARP/DHCP/mDNS/SSDP traffic
+     * @param interfaceName Interface to capture on, empty for all
+     * @return false if the capture could not be started
+     */
+    bool startPassiveDiscovery(const QString& interfaceName = QString());
+
+    /**
+     * @brief Stop the passive listener
+     */
+    void stopPassiveDiscovery();
+
+    bool isPassiveDiscoveryActive() const;
+
+    /**
+     * @brief Import hosts from a saved pcap capture
+     * @return Number of frames read, -1 on error
+     */
+    int replayPassiveCapture(const QString& path);
+
 signals:
     /**
      * @brief Emitted when a new scan is about to start
@@ -107,6 +164,13 @@ signals:
      */
     void scanProgressUpdated(int current, int total, double percentage);
 
+    /**
+     * @brief Emitted periodically with the probe send rate
+     * @param effectivePps Packets per second actually sent
+     * @param limitPps Current adaptive rate limit (0 when unlimited)
+     */
+    void scanRateUpdated(double effectivePps, double limitPps);
+
 private slots:
     void onScanStarted(int totalHosts);
     void onDeviceDiscovered(const Device& device);
@@ -115,14 +179,20 @@ private slots:
     void onScanError(const QString& error);
     void onScanPaused();
     void onScanResumed();
+    void onHostRescanned(const Device& device);
+    void onDevicesObserved(const QList<Device>& devices);
+    void onScanCheckpoint(const ScanCheckpoint& checkpoint);
 
 private:
     ScanCoordinator* coordinator;
     DeviceRepository* repository;
     DeviceCache* cache;
+    PassiveDiscovery* passiveDiscovery;
+    ScanCheckpointDao* checkpointDao;
 
     ScanCoordinator::ScanConfig createQuickScanConfig(const QString& subnet);
     ScanCoordinator::ScanConfig createDeepScanConfig(const QString& subnet);
+    void addIpv6Seeds(ScanCoordinator::ScanConfig& config);
 
     void saveDevice(const Device& device);
     void connectSignals();
@@ -3,18 +3,28 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QList>
 #include <QThreadPool>
 #include <QFuture>
+#include <QJsonObject>
 #include <QMap>
+#include <QHash>
+#include <QVector>
 #include <QMutex>
 #include <atomic>
+#include <memory>
+#include "network/diagnostics/PortScanner.h"
+#include "network/scanner/ScanPipeline.h"
+#include "network/scanner/ScanScheduler.h"
+#include "database/ScanCheckpointDao.h"
 
 class Device;
+class QTimer;
 class IpScanner;
-class PortScanner;
 class MetricsAggregator;
 class IScanStrategy;
+class Ipv6ScanStrategy;
 
 /**
  * @brief Coordinates multiple scan operations with multi-threading support
@@ -23,25 +33,76 @@ class ScanCoordinator : public QObject {
     Q_OBJECT
 
 public:
+    static constexpr int DEEP_SCAN_TOP_PORTS = 20;  ///< Frequency-ranked TCP ports of the Deep preset
+
     /**
      * @brief Configuration for scan operations
      */
     struct ScanConfig {
-        QString subnet;              ///< Target subnet (e.g., "192.168.1.0/24")
+        QString subnet;              ///< Targets: CIDRs, ranges, "!" exclusions (e.g., "192.168.1.0/24")
+        QString targetFile;          ///< Optional target file, used instead of subnet when set
         bool resolveDns;             ///< Enable DNS resolution
+        bool discoverNames;          ///< Bulk mDNS/LLMNR/NetBIOS name pass before per-host PTR
         bool resolveArp;             ///< Enable ARP resolution
         bool scanPorts;              ///< Enable port scanning
         QList<int> portsToScan;      ///< List of ports to scan (empty for default)
-        int timeout;                 ///< Timeout in milliseconds
+        int topPorts;                ///< Scan the N most frequently open TCP ports, plus portsToScan (0 = off)
+        QList<int> udpPortsToScan;   ///< UDP ports to probe (empty with udpTopPorts 0 = no UDP scan)
+        int udpTopPorts;             ///< Probe the N most frequently open UDP ports, plus udpPortsToScan (0 = off)
+        bool detectVersions;         ///< Read banners / send light probes on open TCP ports
+        int timeout;                 ///< Upper bound for RTT-derived probe timeouts in milliseconds
+        int minTimeout;              ///< Lower bound for RTT-derived probe timeouts in milliseconds
         int maxThreads;              ///< Maximum concurrent threads
+        int maxInFlightProbes;       ///< Global cap on concurrent port probes across all hosts
+        bool randomizeOrder;         ///< Probe targets in a keyed pseudo-random order
+        quint64 orderSeed;           ///< Seed for randomized order (0 picks one at start)
+        quint64 startIndex;          ///< Position in scan order to start (resume) from
+        double targetRate;           ///< Probe rate ceiling in packets per second (0 = unlimited)
+        int identityWorkers;         ///< Deep scan MAC/vendor stage concurrency (0 = default)
+        int dnsWorkers;              ///< Deep scan DNS stage concurrency (0 = default)
+        int portWorkers;             ///< Deep scan port stage concurrency (0 = default)
+        bool discoverIpv6;           ///< Also find IPv6 hosts on the attached links (no port scan)
+        QString ipv6Interface;       ///< Interface for IPv6 discovery (empty = all)
+        QStringList ipv6Candidates;  ///< IPv6 addresses to probe directly, e.g. seen passively
+        QStringList knownMacs;       ///< MACs whose SLAAC EUI-64 addresses are probed
+        QString checkpointId;        ///< Scan id for checkpoints (empty = new scan, id generated)
+        QStringList resumeHosts;     ///< Live hosts whose later stages must run again on resume
+        int resumedDevicesFound;     ///< Devices found before the checkpoint, for the totals
+        ScanScheduler::Priority priority;  ///< Higher priority scans and rescans hold this one back
 
         ScanConfig()
             : resolveDns(true)
+            , discoverNames(true)
             , resolveArp(true)
             , scanPorts(false)
+            , topPorts(0)
+            , udpTopPorts(0)
+            , detectVersions(false)
             , timeout(3000)
+            , minTimeout(100)
             , maxThreads(0)  // 0 means auto-detect
+            , maxInFlightProbes(0)  // 0 means engine default
+            , randomizeOrder(false)
+            , orderSeed(0)
+            , startIndex(0)
+            , targetRate(0.0)  // 0 means unlimited
+            , identityWorkers(0)
+            , dnsWorkers(0)
+            , portWorkers(0)
+            , discoverIpv6(false)
+            , resumedDevicesFound(0)
+            , priority(ScanScheduler::Normal)
         {}
+
+        /**
+         * @brief Serialize the settings (not the resume state) for a checkpoint
+         */
+        QJsonObject toJson() const;
+
+        /**
+         * @brief Settings from a checkpoint; fields missing from @p json keep their defaults
+         */
+        static ScanConfig fromJson(const QJsonObject& json);
     };
 
     /**
@@ -76,14 +137,26 @@ public:
 
     /**
      * @brief Pause the current scan operation
+     *
+     * Workers stop before their next probe; probes in flight finish and
+     * their results are kept.
      */
     void pauseScan();
 
     /**
-     * @brief Resume a paused scan operation
+     * @brief Resume a paused scan operation where each worker stopped
      */
     void resumeScan();
 
+    /**
+     * @brief Scan one host again at interactive priority
+     *
+     * Runs beside any scan in progress, which yields to it probe by probe
+     * until the rescan is done. The result arrives via hostRescanned(),
+     * and via deviceDiscovered() if the host is up.
+     */
+    void rescanHost(const QString& ip);
+
     /**
      * @brief Check if a scan is currently running
      * @return True if scan is running
@@ -96,6 +169,23 @@ public:
      */
     bool isPaused() const { return paused; }
 
+    /**
+     * @brief Seed of the current (or last) randomized scan, to reproduce its order
+     */
+    quint64 orderSeed() const { return currentConfig.orderSeed; }
+
+    /**
+     * @brief Snapshot of the running scan's resumable state
+     * @param status One of the ScanCheckpoint::STATUS_* values
+     */
+    ScanCheckpoint checkpoint(const QString& status) const;
+
+    /**
+     * @brief Queue depth, concurrency and latency of each deep scan stage
+     * @return One entry per ScanPipeline::Stage, empty when no pipeline is in use
+     */
+    QVector<ScanPipeline::StageStats> pipelineStats() const;
+
 signals:
     /**
      * @brief Emitted when scan starts
@@ -130,6 +220,23 @@ signals:
      */
     void scanError(const QString& error);
 
+    /**
+     * @brief Emitted once per second while scanning with the probe send rate
+     * @param effectivePps Packets per second actually sent over the last second
+     * @param limitPps Current adaptive rate limit (0 when unlimited)
+     */
+    void scanRateUpdated(double effectivePps, double limitPps);
+
+    /**
+     * @brief Emitted when a rescanHost() request completes
+     */
+    void hostRescanned(const Device& device);
+
+    /**
+     * @brief Emitted every CHECKPOINT_INTERVAL_MS while scanning, and when the scan stops or completes
+     */
+    void scanCheckpoint(const ScanCheckpoint& checkpoint);
+
     /**
      * @brief Emitted when scan is paused
      */
@@ -143,20 +250,37 @@ signals:
 private slots:
     void onDeviceFound(const Device& device);
     void onScanFinished();
-    void onPortFound(const QString& host, int port, const QString& service);
-    void onPortScanCompleted(const QString& host);
+    void onPortScanCompleted(const QString& host, const QList<PortScanner::PortScanResult>& openPorts);
+    void onPipelineUpdate(const Device& device, int stage);
+    void onPipelineIdle();
+    void onIpv6DiscoveryFinished(const QList<Device>& devices);
 
 private:
+    static constexpr int CHECKPOINT_INTERVAL_MS = 5000;
+
     IpScanner* ipScanner;
     PortScanner* portScanner;
     MetricsAggregator* metricsAggregator;
 
     QThreadPool* threadPool;
     QFuture<void> scanFuture;
+    QTimer* rateTimer;
+    QTimer* checkpointTimer;
+    QFuture<void> requeueFuture;      ///< Resubmits a checkpoint's pending hosts to the pipeline
+
+    IScanStrategy* currentStrategy;   ///< Owned; replaced on the next scan
+    QList<IScanStrategy*> retiredStrategies;  ///< Owned; replaced while workers of a stopped scan still ran
+    ScanPipeline* pipeline;           ///< Stages of currentStrategy, nullptr for quick scans
+    QHash<QString, int> pipelineStages;  ///< IP -> last stage reported (GUI thread only)
 
     std::atomic<bool> scanning;
     std::atomic<bool> paused;
     std::atomic<bool> stopRequested;
+    bool discoveryFinished;  ///< IpScanner done, waiting for outstanding port scans
+    bool requeueing;         ///< Pending hosts of a resumed scan still being resubmitted
+    int scanGeneration;      ///< Drops late results of a stopped scan
+    int schedulerJob;        ///< ScanScheduler job of the running scan, 0 if none
+    std::shared_ptr<Ipv6ScanStrategy> ipv6Strategy;  ///< Running IPv6 link discovery, shared with its worker
 
     std::atomic<int> currentProgress;
     std::atomic<int> totalProgress;
@@ -164,22 +288,27 @@ private:
 
     qint64 scanStartTime;
     ScanConfig currentConfig;
+    QString targetDescription;
 
     mutable QMutex mutex;
 
     // Port scanning data structures
     QMap<QString, Device> pendingDevices;  ///< Devices waiting for port scan completion (IP -> Device)
-    QMap<QString, QList<QPair<int, QString>>> portScanResults;  ///< Port scan results (IP -> List of (port, service))
-    QString currentPortScanHost;  ///< Currently scanning host IP
-    QList<QString> portScanQueue;  ///< Queue of IPs waiting for port scan
 
     void coordinateScan(const ScanConfig& config);
     void processDiscoveredDevice(Device& device);
     void updateProgress(const QString& currentIp);
     void cleanup();
+    void retireStrategy(IScanStrategy* strategy);
+    void deleteRetiredStrategies();
+    void logPipelineStats();
     IScanStrategy* createScanStrategy(const ScanConfig& config);
-    void emitDeviceWithPorts(const QString& ip);
-    void processNextPortScan();  ///< Process next device in port scan queue
+    static QList<int> resolvePorts(const QList<int>& ports, int topPorts, bool udp);
+    void emitDeviceWithPorts(const QString& ip, const QList<PortScanner::PortScanResult>& openPorts);
+    bool hasOutstandingWork() const;
+    void finishScan();
+    void startIpv6Discovery();
+    void requeueHosts(const QStringList& hosts);
 };
 
 #endif // SCANCOORDINATOR_H
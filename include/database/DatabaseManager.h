@@ -18,6 +18,9 @@ public:
     QSqlQuery prepareQuery(const QString& query);
     bool createSchema();
 
+    // Migration of tables created by older versions
+    bool addColumnIfMissing(const QString& table, const QString& column, const QString& type);
+
     QString getLastError() const;
 
     // Database access
@@ -36,6 +39,7 @@ private:
 
     bool createDevicesTable();
     bool createPortsTable();
+    bool createIpv6AddressesTable();
     bool createMetricsTable();
     bool createIndices();
     bool createSchemaVersionTable();
@@ -21,6 +21,8 @@ public:
 
     // Additional methods
     Device findByIp(const QString& ip);
+    Device findByIpv6(const QString& address);
+    Device findByMac(const QString& mac);
     QList<Device> findBySubnet(const QString& cidr);
     void update(const Device& device);
     bool exists(const QString& id);
@@ -34,6 +36,7 @@ private:
     void saveToDatabase(const Device& device);
     void updateInDatabase(const Device& device);
     void savePorts(const QString& deviceId, const QList<PortInfo>& ports);
+    void saveIpv6Addresses(const QString& deviceId, const QStringList& addresses, const QDateTime& lastSeen);
     void saveMetrics(const QString& deviceId, const NetworkMetrics& metrics);
 
     DatabaseManager* db;
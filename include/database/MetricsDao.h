@@ -5,6 +5,7 @@
 #include <QDateTime>
 #include <QList>
 #include "models/NetworkMetrics.h"
+#include "utils/LatencyHistogram.h"
 
 class DatabaseManager;
 class QSqlQuery;
@@ -32,9 +33,11 @@ public:
      * @brief Insert metrics for a device
      * @param deviceId Device identifier
      * @param metrics Network metrics to insert
+     * @param histogram Latencies measured since the previous row (stored as a blob)
      * @return True if successful
      */
-    bool insert(const QString& deviceId, const NetworkMetrics& metrics);
+    bool insert(const QString& deviceId, const NetworkMetrics& metrics,
+                const LatencyHistogram& histogram = LatencyHistogram());
 
     /**
      * @brief Insert multiple metrics in a single transaction
@@ -118,6 +121,20 @@ public:
                            const QDateTime& start,
                            const QDateTime& end);
 
+    /**
+     * @brief Get the latency distribution of a device in a date range
+     *
+     * Merges the histograms stored with the rows in the range, so any
+     * percentile of the range is available without the raw samples.
+     * @param deviceId Device identifier
+     * @param start Start date/time (inclusive)
+     * @param end End date/time (inclusive)
+     * @return Merged histogram (empty if no row in range has one)
+     */
+    LatencyHistogram getLatencyHistogram(const QString& deviceId,
+                                         const QDateTime& start,
+                                         const QDateTime& end);
+
     /**
      * @brief Delete metrics older than specified date
      * @param cutoffDate Cutoff date (metrics before this will be deleted)
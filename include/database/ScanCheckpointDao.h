@@ -0,0 +1,118 @@
+#ifndef SCANCHECKPOINTDAO_H
+#define SCANCHECKPOINTDAO_H
+
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QList>
+#include <QJsonObject>
+
+class DatabaseManager;
+class QSqlQuery;
+
+/**
+ * @brief Saved progress of one scan
+ *
+ * Everything needed to continue an interrupted scan without probing
+ * completed ranges again: the configuration, the order seed, the cursor
+ * below which every position in scan order has finished, and the live
+ * hosts whose later stages (identity, DNS, ports) had not finished yet.
+ * Results found so far are already in the devices table.
+ */
+class ScanCheckpoint {
+public:
+    static const QString STATUS_RUNNING;       ///< Still running, or the application died
+    static const QString STATUS_INTERRUPTED;   ///< Stopped by the user
+    static const QString STATUS_COMPLETED;
+
+    QString id;                 ///< Unique scan identifier
+    QString targetSpec;         ///< Subnet or target file, for display
+    QJsonObject config;         ///< Serialized ScanCoordinator::ScanConfig
+    quint64 orderSeed;          ///< Seed of the randomized order (0 = sequential)
+    quint64 completedIndex;     ///< Positions below this are done
+    quint64 totalHosts;
+    int devicesFound;
+    QStringList pendingHosts;   ///< Alive, but later stages unfinished
+    QString status;
+    QDateTime startedAt;
+    QDateTime updatedAt;
+
+    ScanCheckpoint()
+        : orderSeed(0)
+        , completedIndex(0)
+        , totalHosts(0)
+        , devicesFound(0)
+        , status(STATUS_RUNNING)
+    {}
+
+    bool isValid() const {
+        return !id.isEmpty() && totalHosts > 0;
+    }
+
+    /**
+     * @brief Can a scan continue from this checkpoint
+     */
+    bool isResumable() const {
+        return isValid() && status != STATUS_COMPLETED
+            && (completedIndex < totalHosts || !pendingHosts.isEmpty());
+    }
+};
+
+/**
+ * @brief Data Access Object for scan checkpoints
+ *
+ * One row per scan, overwritten on every checkpoint.
+ */
+class ScanCheckpointDao {
+public:
+    /**
+     * @brief Constructor
+     * @param dbManager Database manager instance
+     */
+    explicit ScanCheckpointDao(DatabaseManager* dbManager);
+
+    ~ScanCheckpointDao();
+
+    /**
+     * @brief Insert or replace the checkpoint with the same id
+     * @return True if successful
+     */
+    bool save(const ScanCheckpoint& checkpoint);
+
+    /**
+     * @brief Find a checkpoint by scan id
+     * @return Invalid checkpoint if not found
+     */
+    ScanCheckpoint findById(const QString& id);
+
+    /**
+     * @brief Unfinished scans, most recently updated first
+     */
+    QList<ScanCheckpoint> findResumable();
+
+    /**
+     * @brief Most recently updated unfinished scan
+     * @return Invalid checkpoint if there is none
+     */
+    ScanCheckpoint findLatestResumable();
+
+    /**
+     * @brief Delete a checkpoint
+     * @return True if successful
+     */
+    bool remove(const QString& id);
+
+    /**
+     * @brief Delete completed checkpoints last updated before the cutoff
+     * @return Number of checkpoints deleted
+     */
+    int deleteCompletedBefore(const QDateTime& cutoffDate);
+
+private:
+    DatabaseManager* dbManager;
+
+    void createTable();
+    ScanCheckpoint checkpointFromQuery(QSqlQuery& query);
+};
+
+#endif // SCANCHECKPOINTDAO_H
@@ -20,6 +20,8 @@ public:
     bool resolveArp;         ///< Enable ARP resolution
     bool scanPorts;          ///< Enable port scanning
     QList<int> portsToScan;  ///< Ports to scan (empty for default)
+    int topPorts;            ///< Also scan the N most frequently open TCP ports (0 = list only)
+    bool detectVersions;     ///< Read service banners/versions on open ports
     int timeout;             ///< Timeout in milliseconds
     QDateTime createdAt;     ///< Creation timestamp
     QDateTime modifiedAt;    ///< Last modification timestamp
@@ -31,6 +33,8 @@ public:
         : resolveDns(true)
         , resolveArp(true)
         , scanPorts(false)
+        , topPorts(0)
+        , detectVersions(false)
         , timeout(3000)
         , createdAt(QDateTime::currentDateTime())
         , modifiedAt(QDateTime::currentDateTime())
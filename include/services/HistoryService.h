@@ -7,6 +7,7 @@
 #include <QList>
 #include "models/NetworkMetrics.h"
 #include "database/DatabaseManager.h"
+#include "utils/LatencyHistogram.h"
 
 /**
  * @brief Historical event record
@@ -62,9 +63,11 @@ public:
      * @brief Save network metrics to database
      * @param deviceId Device identifier
      * @param metrics Network metrics to save
+     * @param histogram Latencies measured since the previous row (stored as a blob)
      * @return True if save successful
      */
-    bool saveMetrics(const QString& deviceId, const NetworkMetrics& metrics);
+    bool saveMetrics(const QString& deviceId, const NetworkMetrics& metrics,
+                     const LatencyHistogram& histogram = LatencyHistogram());
 
     /**
      * @brief Save an event to database
@@ -95,6 +98,20 @@ public:
      */
     QList<NetworkMetrics> getAllMetricsForDevice(const QString& deviceId, int limit = 100);
 
+    /**
+     * @brief Get the latency distribution of a device over a time range
+     *
+     * Merges the histograms stored with the rows in the range; no raw
+     * samples are read.
+     * @param deviceId Device identifier
+     * @param start Start time
+     * @param end End time
+     * @return Merged histogram (empty if no row in range has one)
+     */
+    LatencyHistogram getLatencyHistogram(const QString& deviceId,
+                                         const QDateTime& start,
+                                         const QDateTime& end);
+
     /**
      * @brief Get event history for a device within time range
      * @param deviceId Device identifier
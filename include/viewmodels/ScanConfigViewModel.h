@@ -9,6 +9,7 @@
 
 class IpAddressValidator;
 class NetworkInterfaceDetector;
+class ScanProfile;
 
 /**
  * @brief ViewModel for scan configuration dialog
@@ -38,6 +39,8 @@ public:
     bool isResolveArp() const;
     bool isScanPorts() const;
     QList<int> getPortsToScan() const;
+    int getTopPorts() const;
+    bool isDetectVersions() const;
 
     // Setters
     void setSubnet(const QString& subnet);
@@ -48,6 +51,8 @@ public:
     void setResolveArp(bool resolve);
     void setScanPorts(bool scan);
     void setPortsToScan(const QList<int>& ports);
+    void setTopPorts(int count);            // N most frequently open TCP ports, 0 = list only
+    void setDetectVersions(bool detect);
 
     // Validation
     bool isSubnetValid() const;
@@ -59,6 +64,7 @@ public:
     void loadDeepScanPreset();
     void loadCustomScanPreset();
     void loadPreset(ScanType type);
+    void loadProfile(const ScanProfile& profile);  // Saved profile's settings, as a Custom scan
 
     // Network detection
     QStringList detectLocalNetworks();
@@ -80,6 +86,8 @@ private:
     bool resolveArp;
     bool scanPorts;
     QList<int> portsToScan;
+    int topPorts;
+    bool detectVersions;
 
     NetworkInterfaceDetector* interfaceDetector;
 
@@ -20,6 +20,7 @@ class DeviceDetailDialog;
 
 class MetricsWidget;
 class MetricsViewModel;
+class LatencyDistributionChart;
 class MetricsController;
 
 /**
@@ -28,7 +29,7 @@ class MetricsController;
  * Provides a tabbed interface with:
  * - Overview: Basic device information
  * - Ports: Open ports list
- * - Metrics: Real-time monitoring with MetricsWidget
+ * - Metrics: Real-time monitoring with MetricsWidget and the latency distribution
  * - History: Historical events and metrics
  * - Diagnostics: Traceroute, MTU, Bandwidth, DNS tools
  */
@@ -90,6 +91,7 @@ private:
     MetricsWidget* m_metricsWidget;
     MetricsViewModel* m_metricsViewModel;
     QualityGauge* m_qualityGauge;
+    LatencyDistributionChart* m_latencyDistributionChart;
 
     // UI setup methods
     void setupUi();
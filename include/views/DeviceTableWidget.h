@@ -36,6 +36,7 @@ signals:
     void deviceDoubleClicked(const Device& device);
     void contextMenuRequested(const Device& device, const QPoint& pos);
     void pingDeviceRequested(const Device& device);
+    void rescanDeviceRequested(const Device& device);
 
 private slots:
     void onSelectionChanged(const QItemSelection& selected, const QItemSelection& deselected);
@@ -46,6 +47,7 @@ private slots:
     // Context menu actions
     void onPingDevice();
     void onShowDetails();
+    void onRescanDevice();
     void onWakeOnLan();
     void onAddToFavorites();
     void onRemoveDevice();
@@ -67,6 +67,9 @@ private slots:
     void onAboutTriggered();
     void onQuickScan();
     void onDeepScan();
+    void onPassiveListenToggled(bool enabled);
+    void onReplayCapture();
+    void onResumeInterruptedScan();
     void onRefresh();
     void onClearResults();
 
@@ -79,10 +82,12 @@ private slots:
     void onDevicesUpdated();
     void onDeviceDiscovered(const Device& device);
     void onScanProgressUpdated(int current, int total, double percentage);
+    void onScanRateUpdated(double effectivePps, double limitPps);
 
     // Device table signals
     void onDeviceDoubleClicked(const Device& device);
     void onPingDevice(const Device& device);
+    void onRescanDevice(const Device& device);
     void onShowDeviceDetails(const Device& device);
 
     // System tray slots
@@ -124,7 +129,10 @@ private:
     GradientProgressBar* progressBar;
     QLabel* statusLabel;
     QLabel* deviceCountLabel;
+    QLabel* rateLabel;
     NetworkActivityIndicator* activityIndicator;
+    QAction* passiveListenAction;
+    QAction* resumeScanAction;
 
     // Metrics widgets
     MetricsWidget* metricsWidget;
@@ -2,16 +2,24 @@
 """
 Download and convert IEEE OUI database to LanScan format.
 
-Downloads the official IEEE OUI database and converts it to the format
-expected by MacVendorLookup: OUI<TAB>Vendor Name
+Downloads the official IEEE MA-L (OUI), MA-M and MA-S registries and
+converts them to the format expected by MacVendorLookup: Prefix<TAB>Vendor Name
 
 Format:
     Input (IEEE):
         28-6F-B9   (hex)		Company Name
         286FB9     (base 16)		Company Name
 
+        MA-M / MA-S blocks give the rest of the prefix in the base 16 line:
+        70-B3-D5   (hex)		Company Name
+        F2F000-F2FFFF     (base 16)		Company Name
+
     Output (LanScan):
-        286FB9<TAB>Company Name
+        286FB9<TAB>Company Name          24-bit MA-L
+        70B3D5F2F/36<TAB>Company Name    28/36-bit MA-M / MA-S
+
+MacVendorLookup compiles this file into a binary index (oui_database.idx)
+the first time it is loaded and whenever it changes.
 """
 
 import urllib.request
@@ -19,15 +27,17 @@ import re
 import sys
 
 OUI_URL = "https://standards-oui.ieee.org/oui/oui.txt"
+MAM_URL = "https://standards-oui.ieee.org/oui28/mam.txt"
+MAS_URL = "https://standards-oui.ieee.org/oui36/oui36.txt"
 OUTPUT_FILE = "oui_database.txt"
 
-def download_oui_database():
-    """Download the IEEE OUI database."""
-    print(f"Downloading IEEE OUI database from {OUI_URL}...")
+def download_oui_database(url=OUI_URL):
+    """Download an IEEE registry file."""
+    print(f"Downloading IEEE registry from {url}...")
     try:
         # Add user agent to avoid 418 error
         req = urllib.request.Request(
-            OUI_URL,
+            url,
             headers={'User-Agent': 'LanScan-OUI-Updater/1.0'}
         )
         with urllib.request.urlopen(req, timeout=60) as response:
@@ -61,6 +71,33 @@ def parse_oui_database(content):
 
     return oui_map
 
+def parse_block_registry(content, bits):
+    """Parse an IEEE MA-M (28-bit) or MA-S (36-bit) registry into prefix -> vendor."""
+    block_map = {}
+
+    hex_pattern = re.compile(r'^([0-9A-F]{2}-[0-9A-F]{2}-[0-9A-F]{2})\s+\(hex\)\s+(.+)$')
+    range_pattern = re.compile(r'^([0-9A-F]{6})-[0-9A-F]{6}\s+\(base 16\)')
+    extra_digits = (bits - 24) // 4
+
+    oui_hex = None
+    vendor = None
+    for line in content.split('\n'):
+        line = line.strip()
+
+        match = hex_pattern.match(line)
+        if match:
+            oui_hex = match.group(1).replace('-', '')
+            vendor = ' '.join(match.group(2).split())
+            continue
+
+        match = range_pattern.match(line)
+        if match and oui_hex:
+            prefix = oui_hex + match.group(1)[:extra_digits]
+            block_map[f"{prefix}/{bits}"] = vendor
+            oui_hex = None
+
+    return block_map
+
 def save_oui_database(oui_map, output_file):
     """Save the OUI database in LanScan format."""
     print(f"Writing {len(oui_map)} entries to {output_file}...")
@@ -69,7 +106,7 @@ def save_oui_database(oui_map, output_file):
         with open(output_file, 'w', encoding='utf-8') as f:
             # Write header comment
             f.write("# IEEE OUI Database\n")
-            f.write("# Format: OUI<TAB>Vendor Name\n")
+            f.write("# Format: Prefix[/bits]<TAB>Vendor Name (24-bit OUI, 28-bit MA-M, 36-bit MA-S)\n")
             f.write("# Auto-generated by download_oui.py\n")
             f.write("#\n")
 
@@ -99,6 +136,12 @@ def main():
     oui_map = parse_oui_database(content)
     print(f"Found {len(oui_map)} unique OUI entries")
 
+    # MA-M and MA-S blocks take precedence over their OUI at lookup time
+    for url, bits in ((MAM_URL, 28), (MAS_URL, 36)):
+        blocks = parse_block_registry(download_oui_database(url), bits)
+        print(f"Found {len(blocks)} {bits}-bit block entries")
+        oui_map.update(blocks)
+
     # Show some examples
     print("\nExample entries:")
     count = 0
@@ -7,6 +7,7 @@ JitterChart::JitterChart(QWidget* parent)
     : QChartView(parent)
     , chart(nullptr)
     , jitterSeries(nullptr)
+    , windowedSeries(nullptr)
     , axisX(nullptr)
     , axisY(nullptr)
     , maxDataPointsLimit(60)
@@ -27,7 +28,12 @@ void JitterChart::setupChart() {
     jitterSeries->setName("Jitter");
     jitterSeries->setPen(QPen(QColor("#9C27B0"), 2)); // Purple
 
+    windowedSeries = new QSplineSeries();
+    windowedSeries->setName("Jitter (window)");
+    windowedSeries->setPen(QPen(QColor("#CE93D8"), 1, Qt::DashLine)); // Light purple
+
     chart->addSeries(jitterSeries);
+    chart->addSeries(windowedSeries);
     chart->legend()->setVisible(true);
     chart->legend()->setAlignment(Qt::AlignBottom);
 
@@ -43,6 +49,7 @@ void JitterChart::setupAxes() {
     axisX->setLabelsAngle(-45);
     chart->addAxis(axisX, Qt::AlignBottom);
     jitterSeries->attachAxis(axisX);
+    windowedSeries->attachAxis(axisX);
 
     // Y axis (jitter in ms)
     axisY = new QValueAxis();
@@ -51,28 +58,37 @@ void JitterChart::setupAxes() {
     axisY->setLabelFormat("%.2f");
     chart->addAxis(axisY, Qt::AlignLeft);
     jitterSeries->attachAxis(axisY);
+    windowedSeries->attachAxis(axisY);
 }
 
 void JitterChart::addDataPoint(double jitter, const QDateTime& timestamp) {
     qint64 msecs = timestamp.toMSecsSinceEpoch();
     dataPoints.append(QPointF(msecs, jitter));
 
-    // Prune old data
-    while (dataPoints.size() > maxDataPointsLimit) {
-        dataPoints.removeFirst();
-    }
+    pruneData();
+    updateChart();
+    emit chartUpdated();
+}
 
+void JitterChart::addDataPoint(double jitter, double windowedJitter, const QDateTime& timestamp) {
+    qint64 msecs = timestamp.toMSecsSinceEpoch();
+    dataPoints.append(QPointF(msecs, jitter));
+    windowedPoints.append(QPointF(msecs, windowedJitter));
+
+    pruneData();
     updateChart();
     emit chartUpdated();
 }
 
 void JitterChart::onMetricsUpdated(const NetworkMetrics& metrics) {
-    addDataPoint(metrics.jitter(), QDateTime::currentDateTime());
+    addDataPoint(metrics.jitter(), metrics.jitterWindowed(), QDateTime::currentDateTime());
 }
 
 void JitterChart::clearData() {
     dataPoints.clear();
+    windowedPoints.clear();
     jitterSeries->clear();
+    windowedSeries->clear();
 
     Logger::debug("JitterChart: Data cleared");
     emit chartUpdated();
@@ -99,12 +115,25 @@ int JitterChart::getMaxDataPoints() const {
     return maxDataPointsLimit;
 }
 
+void JitterChart::pruneData() {
+    while (dataPoints.size() > maxDataPointsLimit) {
+        dataPoints.removeFirst();
+    }
+    while (windowedPoints.size() > maxDataPointsLimit) {
+        windowedPoints.removeFirst();
+    }
+}
+
 void JitterChart::updateChart() {
     // Update spline series
     jitterSeries->clear();
     for (const QPointF& point : dataPoints) {
         jitterSeries->append(point);
     }
+    windowedSeries->clear();
+    for (const QPointF& point : windowedPoints) {
+        windowedSeries->append(point);
+    }
 
     if (dataPoints.isEmpty()) {
         return;
@@ -123,6 +152,11 @@ void JitterChart::updateChart() {
             maxJitter = point.y();
         }
     }
+    for (const QPointF& point : windowedPoints) {
+        if (point.y() > maxJitter) {
+            maxJitter = point.y();
+        }
+    }
 
     if (maxJitter > 0) {
         axisY->setRange(0, maxJitter * 1.2);
@@ -0,0 +1,125 @@
+#include "charts/LatencyDistributionChart.h"
+#include "utils/Logger.h"
+#include <QColor>
+#include <QVector>
+#include <cmath>
+
+LatencyDistributionChart::LatencyDistributionChart(QWidget* parent)
+    : QChartView(parent)
+    , chart(nullptr)
+    , barSeries(nullptr)
+    , samplesSet(nullptr)
+    , axisX(nullptr)
+    , axisY(nullptr)
+{
+    setupChart();
+    setupAxes();
+
+    Logger::debug("LatencyDistributionChart: Initialized with bar series");
+}
+
+void LatencyDistributionChart::setupChart() {
+    chart = new QChart();
+    chart->setTitle("Latency Distribution");
+    chart->legend()->setVisible(false);
+
+    samplesSet = new QBarSet("Samples");
+    samplesSet->setColor(QColor("#2196F3"));
+
+    barSeries = new QBarSeries();
+    barSeries->setBarWidth(0.9);
+    barSeries->append(samplesSet);
+
+    chart->addSeries(barSeries);
+
+    setChart(chart);
+    setRenderHint(QPainter::Antialiasing);
+}
+
+void LatencyDistributionChart::setupAxes() {
+    // X axis (latency ranges, lower bound of each bar)
+    axisX = new QBarCategoryAxis();
+    axisX->setTitleText("Latency (ms)");
+    chart->addAxis(axisX, Qt::AlignBottom);
+    barSeries->attachAxis(axisX);
+
+    // Y axis (share of samples)
+    axisY = new QValueAxis();
+    axisY->setTitleText("Samples (%)");
+    axisY->setRange(0, 100);
+    axisY->setLabelFormat("%.0f");
+    chart->addAxis(axisY, Qt::AlignLeft);
+    barSeries->attachAxis(axisY);
+}
+
+void LatencyDistributionChart::setHistogram(const LatencyHistogram& histogram) {
+    if (histogram.isEmpty()) {
+        clearData();
+        return;
+    }
+
+    const QVector<LatencyHistogram::Bucket> buckets = histogram.buckets();
+
+    // Logarithmic bars between min and max; a bucket goes to the bar of its midpoint
+    double low = qMax(histogram.min(), 0.001);
+    double high = qMax(histogram.max(), low);
+    int barCount = qMin(static_cast<int>(MAX_BARS), static_cast<int>(buckets.size()));
+    double span = std::log(high / low);
+
+    QVector<double> shares(barCount, 0.0);
+    for (const LatencyHistogram::Bucket& bucket : buckets) {
+        double midpoint = qBound(low, (bucket.lowerMs + bucket.upperMs) / 2.0, high);
+        int bar = span > 0.0 ? static_cast<int>(std::log(midpoint / low) / span * barCount) : 0;
+        shares[qBound(0, bar, barCount - 1)] +=
+            bucket.count * 100.0 / histogram.totalCount();
+    }
+
+    QStringList categories;
+    double maxShare = 0.0;
+    samplesSet->remove(0, samplesSet->count());
+    for (int i = 0; i < barCount; ++i) {
+        // Category names must be unique; narrow bars need more digits
+        double edge = low * std::exp(span * i / barCount);
+        QString label = formatLatency(edge);
+        if (categories.contains(label)) {
+            label = QString::number(edge, 'f', 3);
+        }
+        while (categories.contains(label)) {
+            label.append(QChar(0x200B));    // Zero-width space
+        }
+        categories << label;
+        *samplesSet << shares[i];
+        maxShare = qMax(maxShare, shares[i]);
+    }
+
+    axisX->clear();
+    axisX->append(categories);
+    axisY->setRange(0, qMin(100.0, maxShare * 1.2));
+
+    chart->setTitle(QString("Latency Distribution - p50: %1 ms, p95: %2 ms, p99: %3 ms (%4 samples)")
+                    .arg(formatLatency(histogram.percentile(50.0)))
+                    .arg(formatLatency(histogram.percentile(95.0)))
+                    .arg(formatLatency(histogram.percentile(99.0)))
+                    .arg(histogram.totalCount()));
+
+    emit chartUpdated();
+}
+
+void LatencyDistributionChart::clearData() {
+    samplesSet->remove(0, samplesSet->count());
+    axisX->clear();
+    axisY->setRange(0, 100);
+    chart->setTitle("Latency Distribution - No samples yet");
+
+    emit chartUpdated();
+}
+
+QString LatencyDistributionChart::formatLatency(double ms) {
+    if (ms < 1.0) {
+        return QString::number(ms, 'f', 2);
+    }
+    if (ms < 10.0) {
+        return QString::number(ms, 'f', 1);
+    }
+    return QString::number(ms, 'f', 0);
+}
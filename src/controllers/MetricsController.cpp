@@ -1,5 +1,5 @@
 #include "controllers/MetricsController.h"
-#include "../network/diagnostics/MetricsAggregator.h"
+#include "../network/diagnostics/MonitoringEngine.h"
 #include "database/DeviceRepository.h"
 #include "../models/NetworkMetrics.h"
 #include "../models/Device.h"
@@ -11,21 +11,36 @@ MetricsController::MetricsController(
     MetricsAggregator* aggregator,
     DeviceRepository* repository,
     QObject* parent
+)
+    : MetricsController(aggregator, repository, nullptr, parent)
+{
+}
+
+MetricsController::MetricsController(
+    MetricsAggregator* aggregator,
+    DeviceRepository* repository,
+    MonitoringEngine* engine,
+    QObject* parent
 )
     : QObject(parent)
-    , aggregator(aggregator)
+    , engine(engine ? engine : new MonitoringEngine(aggregator, nullptr, nullptr, this))
     , repository(repository)
-    , defaultInterval(1000)
+    , saveTimer(new QTimer(this))
 {
-    // Connect aggregator signals
-    connect(aggregator, &MetricsAggregator::metricsUpdated,
+    connect(this->engine, &MonitoringEngine::metricsUpdated,
             this, &MetricsController::onMetricsUpdated);
+    connect(this->engine, &MonitoringEngine::errorOccurred,
+            this, &MetricsController::metricsError);
+
+    saveTimer->setInterval(SAVE_INTERVAL_MS);
+    connect(saveTimer, &QTimer::timeout, this, &MetricsController::flushMetrics);
 
     Logger::info("MetricsController initialized");
 }
 
 MetricsController::~MetricsController() {
     stopMonitoringAll();
+    flushMetrics();
 }
 
 void MetricsController::startContinuousMonitoring(const QString& deviceId, int intervalMs) {
@@ -34,7 +49,7 @@ void MetricsController::startContinuousMonitoring(const QString& deviceId, int i
         return;
     }
 
-    if (monitoringTimers.contains(deviceId)) {
+    if (engine->hasTarget(deviceId)) {
         Logger::warn("Device " + deviceId + " is already being monitored");
         return;
     }
@@ -42,22 +57,25 @@ void MetricsController::startContinuousMonitoring(const QString& deviceId, int i
     Logger::info("Starting continuous monitoring for " + deviceId +
                  " (interval: " + QString::number(intervalMs) + "ms)");
 
-    setupTimer(deviceId, intervalMs);
+    // The first probe goes out within one interval, phased against the other devices
+    if (!engine->addTarget(deviceId, intervalMs)) {
+        return;  // errorOccurred already reported why
+    }
     emit monitoringStarted(deviceId);
-
-    // Collect initial metrics immediately
-    collectMetricsForDevice(deviceId);
 }
 
 void MetricsController::stopContinuousMonitoring(const QString& deviceId) {
-    if (!monitoringTimers.contains(deviceId)) {
+    if (!engine->hasTarget(deviceId)) {
         Logger::warn("Device " + deviceId + " is not being monitored");
         return;
     }
 
     Logger::info("Stopping continuous monitoring for " + deviceId);
 
-    cleanupTimer(deviceId);
+    engine->removeTarget(deviceId);
+    if (unsavedMetrics.contains(deviceId)) {
+        saveMetrics(deviceId, unsavedMetrics.take(deviceId));
+    }
     emit monitoringStopped(deviceId);
 }
 
@@ -69,7 +87,9 @@ void MetricsController::collectMetricsOnce(const QString& deviceId) {
     }
 
     Logger::debug("Collecting metrics once for " + deviceId);
-    collectMetricsForDevice(deviceId);
+    if (!engine->probeOnce(deviceId)) {
+        emit metricsError(deviceId, "Monitoring needs an IPv4 address");
+    }
 }
 
 void MetricsController::startMonitoringAll(int intervalMs) {
@@ -83,13 +103,13 @@ void MetricsController::startMonitoringAll(int intervalMs) {
         }
     }
 
-    Logger::info("Started monitoring " + QString::number(monitoringTimers.size()) + " devices");
+    Logger::info("Started monitoring " + QString::number(engine->targetCount()) + " devices");
 }
 
 void MetricsController::stopMonitoringAll() {
     Logger::info("Stopping monitoring for all devices");
 
-    QStringList deviceIds = monitoringTimers.keys();
+    QStringList deviceIds = engine->targets();
     for (const QString& deviceId : deviceIds) {
         stopContinuousMonitoring(deviceId);
     }
@@ -98,74 +118,41 @@ void MetricsController::stopMonitoringAll() {
 }
 
 bool MetricsController::isMonitoring(const QString& deviceId) const {
-    return monitoringTimers.contains(deviceId);
+    return engine->hasTarget(deviceId);
 }
 
 int MetricsController::getMonitoredDeviceCount() const {
-    return monitoringTimers.size();
+    return engine->targetCount();
 }
 
-void MetricsController::onMetricsUpdated(const NetworkMetrics& metrics) {
-    // This slot is called when aggregator updates metrics
-    // Emit with the current monitoring device ID
-    if (!currentMonitoringDevice.isEmpty()) {
-        Logger::debug(QString("Metrics updated for device %1").arg(currentMonitoringDevice));
-        emit metricsCollected(currentMonitoringDevice, metrics);
-
-        // Optionally save to repository
-        saveMetrics(currentMonitoringDevice, metrics);
-    } else {
-        Logger::warn("Metrics updated but no current monitoring device set");
-    }
+LatencyHistogram MetricsController::latencyHistogram(const QString& deviceId) const {
+    return engine->latencyHistogram(deviceId);
 }
 
-void MetricsController::collectMetricsForDevice(const QString& deviceId) {
-    try {
-        // Set current monitoring device
-        currentMonitoringDevice = deviceId;
-
-        // Only start continuous collection if not already collecting
-        if (!aggregator->isCollecting()) {
-            // Start collecting metrics using aggregator
-            aggregator->startContinuousCollection(deviceId);
-        }
+LatencyHistogram MetricsController::takeLatencyHistogram(const QString& deviceId) {
+    return engine->takeLatencyHistogram(deviceId);
+}
 
-        // Note: Metrics will be emitted via metricsUpdated signal
-        // We'll handle saving in the onMetricsUpdated slot if needed
+void MetricsController::onMetricsUpdated(const QString& deviceId, const NetworkMetrics& metrics) {
+    emit metricsCollected(deviceId, metrics);
 
-    } catch (const std::exception& e) {
-        QString error = "Failed to collect metrics: " + QString(e.what());
-        Logger::error(error);
-        emit metricsError(deviceId, error);
+    // Only the latest metrics per device reach the repository
+    unsavedMetrics.insert(deviceId, metrics);
+    if (!saveTimer->isActive()) {
+        saveTimer->start();
     }
 }
 
-void MetricsController::setupTimer(const QString& deviceId, int intervalMs) {
-    QTimer* timer = new QTimer(this);
-    timer->setInterval(intervalMs);
-
-    // Connect timer to collection function
-    connect(timer, &QTimer::timeout, this, [this, deviceId]() {
-        collectMetricsForDevice(deviceId);
-    });
+void MetricsController::flushMetrics() {
+    QHash<QString, NetworkMetrics> pending;
+    pending.swap(unsavedMetrics);
 
-    monitoringTimers[deviceId] = timer;
-    timer->start();
-}
-
-void MetricsController::cleanupTimer(const QString& deviceId) {
-    if (monitoringTimers.contains(deviceId)) {
-        QTimer* timer = monitoringTimers.take(deviceId);
-        timer->stop();
-        timer->deleteLater();
+    for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+        saveMetrics(it.key(), it.value());
     }
 
-    // Always stop aggregator collection when stopping monitoring
-    if (aggregator && currentMonitoringDevice == deviceId) {
-        if (aggregator->isCollecting()) {
-            aggregator->stopContinuousCollection();
-        }
-        currentMonitoringDevice.clear();
+    if (unsavedMetrics.isEmpty()) {
+        saveTimer->stop();
     }
 }
 
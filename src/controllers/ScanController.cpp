@@ -2,6 +2,8 @@
 #include "../models/Device.h"
 #include "database/DeviceRepository.h"
 #include "database/DeviceCache.h"
+#include "database/ScanCheckpointDao.h"
+#include "network/discovery/PassiveDiscovery.h"
 #include "../utils/Logger.h"
 
 ScanController::ScanController(
@@ -14,6 +16,8 @@ ScanController::ScanController(
     , coordinator(coordinator)
     , repository(repository)
     , cache(cache)
+    , passiveDiscovery(new PassiveDiscovery(this))
+    , checkpointDao(nullptr)
 {
     connectSignals();
     Logger::info("ScanController initialized");
@@ -28,12 +32,17 @@ void ScanController::executeQuickScan(const QString& subnet) {
 void ScanController::executeDeepScan(const QString& subnet) {
     Logger::info("Executing deep scan on " + subnet);
     ScanCoordinator::ScanConfig config = createDeepScanConfig(subnet);
+    addIpv6Seeds(config);
     coordinator->startScan(config);
 }
 
 void ScanController::executeCustomScan(const ScanCoordinator::ScanConfig& config) {
     Logger::info("Executing custom scan on " + config.subnet);
-    coordinator->startScan(config);
+    ScanCoordinator::ScanConfig seeded = config;
+    if (seeded.discoverIpv6) {
+        addIpv6Seeds(seeded);
+    }
+    coordinator->startScan(seeded);
 }
 
 void ScanController::stopCurrentScan() {
@@ -51,6 +60,54 @@ void ScanController::resumeCurrentScan() {
     coordinator->resumeScan();
 }
 
+void ScanController::rescanDevice(const QString& ip) {
+    Logger::info("Rescanning device " + ip);
+    coordinator->rescanHost(ip);
+}
+
+void ScanController::setCheckpointDao(ScanCheckpointDao* dao) {
+    checkpointDao = dao;
+}
+
+bool ScanController::hasResumableScan() {
+    return latestResumableScan().isResumable();
+}
+
+ScanCheckpoint ScanController::latestResumableScan() {
+    if (!checkpointDao) {
+        return ScanCheckpoint();
+    }
+    return checkpointDao->findLatestResumable();
+}
+
+bool ScanController::resumeInterruptedScan(const QString& checkpointId) {
+    if (!checkpointDao || coordinator->isScanning()) {
+        return false;
+    }
+
+    ScanCheckpoint checkpoint = checkpointId.isEmpty()
+        ? checkpointDao->findLatestResumable()
+        : checkpointDao->findById(checkpointId);
+    if (!checkpoint.isResumable()) {
+        Logger::warn("No resumable scan " + checkpointId);
+        return false;
+    }
+
+    // Same seed, same order: the cursor means the same hosts as before
+    ScanCoordinator::ScanConfig config = ScanCoordinator::ScanConfig::fromJson(checkpoint.config);
+    config.checkpointId = checkpoint.id;
+    config.orderSeed = checkpoint.orderSeed;
+    config.startIndex = checkpoint.completedIndex;
+    config.resumeHosts = checkpoint.pendingHosts;
+    config.resumedDevicesFound = checkpoint.devicesFound;
+
+    Logger::info(QString("Resuming scan of %1 at %2/%3 with %4 unfinished hosts")
+                .arg(checkpoint.targetSpec).arg(checkpoint.completedIndex)
+                .arg(checkpoint.totalHosts).arg(checkpoint.pendingHosts.size()));
+    coordinator->startScan(config);
+    return coordinator->isScanning();
+}
+
 QList<Device> ScanController::getAllDevices() {
     // First try to get from cache
     QList<Device> devices = cache->getAll();
@@ -75,6 +132,37 @@ void ScanController::clearAllDevices() {
     emit devicesUpdated();
 }
 
+bool ScanController::startPassiveDiscovery(const QString& interfaceName) {
+    Logger::info("Starting passive discovery");
+    if (!passiveDiscovery->startCapture(interfaceName)) {
+        return false;
+    }
+    emit scanStatusChanged("Passive discovery listening");
+    return true;
+}
+
+void ScanController::stopPassiveDiscovery() {
+    if (!passiveDiscovery->isCapturing()) {
+        return;
+    }
+    passiveDiscovery->stop();
+    emit scanStatusChanged("Passive discovery stopped");
+}
+
+bool ScanController::isPassiveDiscoveryActive() const {
+    return passiveDiscovery->isCapturing();
+}
+
+int ScanController::replayPassiveCapture(const QString& path) {
+    Logger::info("Replaying capture " + path);
+    int frames = passiveDiscovery->replay(path);
+    if (frames >= 0) {
+        emit scanStatusChanged("Capture replayed: " + QString::number(frames) + " frames, " +
+                               QString::number(passiveDiscovery->inventory().size()) + " hosts");
+    }
+    return frames;
+}
+
 void ScanController::onScanStarted(int totalHosts) {
     QString status = "Scan started: " + QString::number(totalHosts) + " hosts to scan";
     Logger::info(status);
@@ -132,6 +220,62 @@ void ScanController::onScanResumed() {
     emit scanStatusChanged("Scan resumed");
 }
 
+void ScanController::onHostRescanned(const Device& device) {
+    // Online results were already saved via deviceDiscovered
+    emit scanStatusChanged(QString("Rescan of %1: %2")
+                           .arg(device.getIp(), device.isOnline() ? "online" : "no response"));
+}
+
+void ScanController::onScanCheckpoint(const ScanCheckpoint& checkpoint) {
+    if (checkpointDao) {
+        checkpointDao->save(checkpoint);
+    }
+}
+
+void ScanController::onDevicesObserved(const QList<Device>& devices) {
+    for (const Device& observed : devices) {
+        Device known = cache->contains(observed.getIp()) ? cache->get(observed.getIp()) : Device();
+        if (known.getIp().isEmpty() && repository) {
+            known = repository->findByIp(observed.getIp());
+        }
+
+        if (known.getIp().isEmpty()) {
+            saveDevice(observed);
+            emit deviceDiscovered(observed);
+            continue;
+        }
+
+        // Traffic only adds to what active scans found: ports, metrics and names stay
+        Device merged = known;
+        if (!observed.getMacAddress().isEmpty()) {
+            merged.setMacAddress(observed.getMacAddress());
+        }
+        if (!observed.getVendor().isEmpty()) {
+            merged.setVendor(observed.getVendor());
+        }
+        if (merged.getHostname().isEmpty()) {
+            merged.setHostname(observed.getHostname());
+        }
+        for (const QString& address : observed.getIpv6Addresses()) {
+            merged.addIpv6Address(address);
+        }
+        merged.setOnline(true);
+
+        bool changed = merged.getMacAddress() != known.getMacAddress()
+                    || merged.getVendor() != known.getVendor()
+                    || merged.getHostname() != known.getHostname()
+                    || merged.getIpv6Addresses() != known.getIpv6Addresses()
+                    || !known.isOnline();
+
+        // A periodic sighting only refreshes last seen
+        merged.setLastSeen(observed.getLastSeen());
+        saveDevice(merged);
+        if (changed) {
+            emit deviceDiscovered(merged);
+        }
+    }
+}
+
 ScanCoordinator::ScanConfig ScanController::createQuickScanConfig(const QString& subnet) {
     ScanCoordinator::ScanConfig config;
     config.subnet = subnet;
@@ -149,12 +293,28 @@ ScanCoordinator::ScanConfig ScanController::createDeepScanConfig(const QString&
     config.resolveDns = true;
     config.resolveArp = true;
     config.scanPorts = true;
-    config.portsToScan = {21, 22, 23, 25, 53, 80, 110, 135, 139, 143, 443, 445, 3389, 8080};
+    config.topPorts = ScanCoordinator::DEEP_SCAN_TOP_PORTS;
     config.timeout = 3000;  // 3 second timeout for deep scan
     config.maxThreads = 0;  // Auto-detect
+    config.discoverIpv6 = true;
     return config;
 }
 
+void ScanController::addIpv6Seeds(ScanCoordinator::ScanConfig& config) {
+    // Known MACs yield EUI-64 candidates; addresses seen passively are probed directly
+    const QList<Device> devices = getAllDevices();
+    for (const Device& device : devices) {
+        if (!device.getMacAddress().isEmpty() && !config.knownMacs.contains(device.getMacAddress())) {
+            config.knownMacs.append(device.getMacAddress());
+        }
+        for (const QString& address : device.getIpv6Addresses()) {
+            if (!config.ipv6Candidates.contains(address)) {
+                config.ipv6Candidates.append(address);
+            }
+        }
+    }
+}
+
 void ScanController::saveDevice(const Device& device) {
     // Save to cache
     cache->put(device.getIp(), device);
@@ -190,4 +350,19 @@ void ScanController::connectSignals() {
 
     connect(coordinator, &ScanCoordinator::scanResumed,
             this, &ScanController::onScanResumed);
+
+    connect(coordinator, &ScanCoordinator::hostRescanned,
+            this, &ScanController::onHostRescanned);
+
+    connect(coordinator, &ScanCoordinator::scanCheckpoint,
+            this, &ScanController::onScanCheckpoint);
+
+    connect(coordinator, &ScanCoordinator::scanRateUpdated,
+            this, &ScanController::scanRateUpdated);
+
+    connect(passiveDiscovery, &PassiveDiscovery::devicesObserved,
+            this, &ScanController::onDevicesObserved);
+
+    connect(passiveDiscovery, &PassiveDiscovery::captureError,
+            this, &ScanController::onScanError);
 }
@@ -3,14 +3,24 @@
 #include "../network/scanner/IpScanner.h"
 #include "../network/scanner/QuickScanStrategy.h"
 #include "../network/scanner/DeepScanStrategy.h"
+#include "../network/scanner/Ipv6ScanStrategy.h"
 #include "../network/diagnostics/PortScanner.h"
 #include "../network/diagnostics/MetricsAggregator.h"
-#include "../network/services/SubnetCalculator.h"
+#include "../network/services/TargetSet.h"
+#include "../network/services/ServiceTable.h"
+#include "../network/sockets/RateController.h"
+#include "../network/sockets/RttEstimator.h"
 #include "../utils/Logger.h"
 
 #include <QtConcurrent>
 #include <QThread>
 #include <QElapsedTimer>
+#include <QTimer>
+#include <QRandomGenerator>
+#include <QUuid>
+#include <QJsonArray>
+#include <QSet>
+#include <climits>
 
 ScanCoordinator::ScanCoordinator(
     IpScanner* ipScanner,
@@ -23,9 +33,17 @@ ScanCoordinator::ScanCoordinator(
     , portScanner(portScanner)
     , metricsAggregator(metricsAggregator)
     , threadPool(new QThreadPool(this))
+    , rateTimer(new QTimer(this))
+    , checkpointTimer(new QTimer(this))
+    , currentStrategy(nullptr)
+    , pipeline(nullptr)
     , scanning(false)
     , paused(false)
     , stopRequested(false)
+    , discoveryFinished(false)
+    , requeueing(false)
+    , scanGeneration(0)
+    , schedulerJob(0)
     , currentProgress(0)
     , totalProgress(0)
     , devicesFoundCount(0)
@@ -41,8 +59,13 @@ ScanCoordinator::ScanCoordinator(
 
     // Connect IpScanner signals
     if (ipScanner) {
-        connect(ipScanner, &IpScanner::deviceDiscovered,
-                this, &ScanCoordinator::onDeviceFound);
+        // Results arrive in batches from the scanner's workers
+        connect(ipScanner, &IpScanner::devicesDiscovered,
+                this, [this](const QVector<Device>& devices) {
+                    for (const Device& device : devices) {
+                        onDeviceFound(device);
+                    }
+                });
         connect(ipScanner, &IpScanner::scanFinished,
                 this, &ScanCoordinator::onScanFinished);
         connect(ipScanner, &IpScanner::scanProgress,
@@ -53,42 +76,41 @@ ScanCoordinator::ScanCoordinator(
                 });
     }
 
-    // Connect PortScanner signals
+    // Connect PortScanner signals - hosts are scanned concurrently and
+    // reported individually, so results never depend on a "current" host
     if (portScanner) {
-        connect(portScanner, &PortScanner::portFound,
-                this, [this](const PortScanner::PortScanResult& result) {
-                    onPortFound(result.host, result.port, result.service);
-                });
-        connect(portScanner, &PortScanner::scanCompleted,
-                this, [this](const QList<PortScanner::PortScanResult>& results) {
-                    // Get host from results OR from currentPortScanHost as fallback
-                    QString host;
-
-                    if (!results.isEmpty()) {
-                        // Use host from first result (all results are for same host)
-                        host = results.first().host;
-                    } else {
-                        // Fallback: use currentPortScanHost (but this might have race condition)
-                        QMutexLocker locker(&mutex);
-                        host = currentPortScanHost;
-                    }
-
-                    if (!host.isEmpty()) {
-                        Logger::debug(QString("scanCompleted signal received for host: %1").arg(host));
-                        onPortScanCompleted(host);
-                    } else {
-                        Logger::warn("scanCompleted signal received but host is empty!");
-                    }
-                });
+        connect(portScanner, &PortScanner::hostScanCompleted,
+                this, &ScanCoordinator::onPortScanCompleted);
     }
 
+    // Report the probe send rate while a scan runs
+    rateTimer->setInterval(1000);
+    connect(rateTimer, &QTimer::timeout, this, [this]() {
+        RateController* rate = RateController::instance();
+        emit scanRateUpdated(rate->effectiveRate(), rate->currentRate());
+    });
+
+    // Periodic snapshot for resuming after a crash or a stop
+    checkpointTimer->setInterval(CHECKPOINT_INTERVAL_MS);
+    connect(checkpointTimer, &QTimer::timeout, this, [this]() {
+        if (scanning) {
+            emit scanCheckpoint(checkpoint(ScanCheckpoint::STATUS_RUNNING));
+        }
+    });
+
     Logger::info("ScanCoordinator initialized with " +
                  QString::number(threadPool->maxThreadCount()) + " threads");
 }
 
 ScanCoordinator::~ScanCoordinator() {
     stopScan();
+    requeueFuture.waitForFinished();
     threadPool->waitForDone();
+    if (ipScanner) {
+        ipScanner->waitForWorkers();
+    }
+    delete currentStrategy;
+    qDeleteAll(retiredStrategies);
 }
 
 void ScanCoordinator::startScan(const ScanConfig& config) {
@@ -98,10 +120,16 @@ void ScanCoordinator::startScan(const ScanConfig& config) {
         return;
     }
 
-    // Validate subnet (basic check - CIDR format should have a slash)
-    if (!config.subnet.contains('/')) {
-        Logger::error("Invalid subnet: " + config.subnet);
-        emit scanError("Invalid subnet: " + config.subnet);
+    // Parse targets once; the same set is handed to the scanner
+    QString parseError;
+    TargetSet targets = config.targetFile.isEmpty()
+        ? TargetSet::parse(config.subnet, &parseError)
+        : TargetSet::fromFile(config.targetFile, &parseError);
+    targetDescription = config.targetFile.isEmpty() ? config.subnet : config.targetFile;
+
+    if (targets.isEmpty()) {
+        Logger::error("Invalid subnet: " + targetDescription + " " + parseError);
+        emit scanError("Invalid subnet: " + targetDescription);
         return;
     }
 
@@ -110,30 +138,117 @@ void ScanCoordinator::startScan(const ScanConfig& config) {
     paused = false;
     stopRequested = false;
     currentProgress = 0;
-    devicesFoundCount = 0;
+    devicesFoundCount = config.resumedDevicesFound;
+    discoveryFinished = false;
+    requeueing = false;
+    ++scanGeneration;
     currentConfig = config;
+    currentConfig.portsToScan = resolvePorts(config.portsToScan, config.topPorts, false);
+    currentConfig.udpPortsToScan = resolvePorts(config.udpPortsToScan, config.udpTopPorts, true);
+
+    // Pick a seed now so the order can be reproduced or resumed later
+    if (currentConfig.randomizeOrder && currentConfig.orderSeed == 0) {
+        currentConfig.orderSeed = QRandomGenerator::global()->generate64();
+    }
+
+    // Workers check in with the scheduler between probes, for pause and preemption
+    schedulerJob = ScanScheduler::instance()->registerJob(currentConfig.priority);
+
+    if (currentConfig.checkpointId.isEmpty()) {
+        currentConfig.checkpointId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    }
 
-    // Calculate total IPs to scan
-    QStringList ipList = SubnetCalculator::getIpRange(config.subnet);
-    totalProgress = ipList.size();
+    totalProgress = static_cast<int>(qMin<quint64>(targets.size(), INT_MAX));
 
     // Configure thread pool
     if (config.maxThreads > 0) {
         threadPool->setMaxThreadCount(config.maxThreads);
     }
 
+    // Global probe budget shared by every host being port scanned
+    if (portScanner && config.maxInFlightProbes > 0) {
+        portScanner->setConcurrencyLimits(config.maxInFlightProbes,
+                                          qMin(config.maxInFlightProbes, 1024));
+    }
+
+    if (portScanner) {
+        portScanner->setServiceDetection(config.detectVersions);
+    }
+
+    // Rate ceiling shared by the ICMP, TCP and DNS probe paths
+    RateController::instance()->setTargetRate(config.targetRate);
+    rateTimer->start();
+
+    // Probe timeouts follow measured RTTs within the configured bounds
+    RttEstimator::instance()->setBounds(config.minTimeout, config.timeout);
+
     scanStartTime = QDateTime::currentMSecsSinceEpoch();
 
-    Logger::info("Starting scan of " + config.subnet +
+    Logger::info("Starting scan of " + targetDescription +
                  " (" + QString::number(totalProgress) + " hosts)");
 
     emit scanStarted(totalProgress);
 
     // Create and set the appropriate scan strategy based on config
-    IScanStrategy* strategy = createScanStrategy(config);
+    IScanStrategy* strategy = createScanStrategy(currentConfig);
     if (ipScanner && strategy) {
         ipScanner->setScanStrategy(strategy);
-        ipScanner->startScan(config.subnet);
+
+        // Resubmitted hosts are done with the previous strategy; workers of a
+        // stopped scan may still be finishing their probe with it
+        requeueFuture.waitForFinished();
+        retireStrategy(currentStrategy);
+        currentStrategy = strategy;
+        pipelineStages.clear();
+
+        DeepScanStrategy* deepStrategy = dynamic_cast<DeepScanStrategy*>(strategy);
+
+        // Names for the whole segment in one window; PTR only runs for hosts left unnamed
+        if (deepStrategy && currentConfig.resolveDns && currentConfig.discoverNames
+            && targets.size() <= static_cast<quint64>(NameDiscovery::MAX_TARGETS)) {
+            QVector<quint32> addresses;
+            addresses.reserve(static_cast<int>(targets.size()));
+            for (quint32 address : targets) {
+                addresses.append(address);
+            }
+            deepStrategy->startNameDiscovery(addresses);
+        }
+        pipeline = (deepStrategy && deepStrategy->isPipelined()) ? deepStrategy->pipeline() : nullptr;
+        if (pipeline) {
+            pipeline->setScheduler(ScanScheduler::instance(), schedulerJob);
+            connect(pipeline, &ScanPipeline::deviceUpdated,
+                    this, &ScanCoordinator::onPipelineUpdate);
+            connect(pipeline, &ScanPipeline::idle,
+                    this, &ScanCoordinator::onPipelineIdle);
+        }
+
+        ipScanner->setRandomOrder(currentConfig.randomizeOrder, currentConfig.orderSeed);
+        ipScanner->setStartIndex(currentConfig.startIndex);
+        ipScanner->setScheduler(ScanScheduler::instance(), schedulerJob);
+
+        // Runs beside the IPv4 sweep; a /64 is found by listening, not by sweeping
+        if (currentConfig.discoverIpv6) {
+            startIpv6Discovery();
+        }
+
+        if (!currentConfig.resumeHosts.isEmpty()) {
+            requeueHosts(currentConfig.resumeHosts);
+        }
+
+        if (currentConfig.startIndex < targets.size()) {
+            ipScanner->startScan(targets, targetDescription);
+        } else {
+            // Every target was probed before the checkpoint; only the requeued hosts remain
+            int generation = scanGeneration;
+            QTimer::singleShot(0, this, [this, generation]() {
+                if (scanning && generation == scanGeneration) {
+                    onScanFinished();
+                }
+            });
+        }
+
+        emit scanCheckpoint(checkpoint(ScanCheckpoint::STATUS_RUNNING));
+        checkpointTimer->start();
     } else {
         Logger::error("Failed to create scan strategy");
         emit scanError("Failed to create scan strategy");
@@ -147,6 +262,9 @@ void ScanCoordinator::stopScan() {
     }
 
     Logger::info("Stopping scan...");
+
+    // Snapshot before cancelling, while the stages still hold their hosts
+    emit scanCheckpoint(checkpoint(ScanCheckpoint::STATUS_INTERRUPTED));
     stopRequested = true;
 
     // Stop IpScanner
@@ -155,10 +273,19 @@ void ScanCoordinator::stopScan() {
     }
 
     // Stop PortScanner if running
-    if (portScanner && portScanner->isScanning()) {
+    if (portScanner && (portScanner->isScanning() || portScanner->isScanningHosts())) {
         portScanner->cancelScan();
     }
 
+    // Drop hosts still queued in the deep scan stages
+    if (pipeline) {
+        pipeline->cancel();
+    }
+
+    if (ipv6Strategy) {
+        ipv6Strategy->cancel();
+    }
+
     cleanup();
 }
 
@@ -169,6 +296,7 @@ void ScanCoordinator::pauseScan() {
 
     Logger::info("Pausing scan...");
     paused = true;
+    ScanScheduler::instance()->pause(schedulerJob);
     emit scanPaused();
 }
 
@@ -179,9 +307,36 @@ void ScanCoordinator::resumeScan() {
 
     Logger::info("Resuming scan...");
     paused = false;
+    ScanScheduler::instance()->resume(schedulerJob);
     emit scanResumed();
 }
 
+void ScanCoordinator::rescanHost(const QString& ip) {
+    // The running scan's settings, or a deep scan's when idle; liveness and
+    // every later stage run inline on one pool thread
+    ScanConfig config = scanning ? currentConfig : ScanConfig();
+    IScanStrategy* strategy = createScanStrategy(config);
+    if (DeepScanStrategy* deepStrategy = dynamic_cast<DeepScanStrategy*>(strategy)) {
+        deepStrategy->setPipelined(false);
+    }
+
+    int job = ScanScheduler::instance()->registerJob(ScanScheduler::Interactive);
+    Logger::info("Rescanning " + ip + " at interactive priority");
+
+    QtConcurrent::run(threadPool, [this, strategy, ip, job]() {
+        Device device = strategy->scan(ip);
+        ScanScheduler::instance()->unregisterJob(job);
+        delete strategy;
+
+        QMetaObject::invokeMethod(this, [this, device]() {
+            if (device.isOnline()) {
+                emit deviceDiscovered(device);
+            }
+            emit hostRescanned(device);
+        }, Qt::QueuedConnection);
+    });
+}
+
 void ScanCoordinator::coordinateScan(const ScanConfig& config) {
     // This method is now handled by IpScanner callbacks
     // Kept for potential future use
@@ -192,12 +347,11 @@ void ScanCoordinator::processDiscoveredDevice(Device& device) {
                 .arg(device.getIp())
                 .arg(currentConfig.scanPorts ? "true" : "false"));
 
-    // Additional processing can be done here
-    // For example, collect metrics if aggregator is available
-    if (metricsAggregator && currentConfig.timeout > 0) {
-        // Start collecting metrics for the device
-        // This is optional and can be done asynchronously
-        metricsAggregator->startContinuousCollection(device.getIp(), currentConfig.timeout);
+    // Latency monitoring is MetricsController's job; the scan only discovers
+
+    // Pipelined deep scans probe ports in their own stage
+    if (pipeline) {
+        return;
     }
 
     // Scan ports if requested AND device doesn't already have ports from DeepScanStrategy
@@ -213,24 +367,20 @@ void ScanCoordinator::processDiscoveredDevice(Device& device) {
         }
 
         Logger::info(QString("Port scanning enabled for %1").arg(device.getIp()));
-        QMutexLocker locker(&mutex);
-
-        // Add device to pending map and queue
-        pendingDevices[device.getIp()] = device;
-        portScanResults[device.getIp()].clear();  // Initialize empty port list
-
-        // Add to queue if not already there
-        if (!portScanQueue.contains(device.getIp())) {
-            portScanQueue.append(device.getIp());
-            Logger::debug(QString("Added %1 to port scan queue (position %2)")
-                         .arg(device.getIp())
-                         .arg(portScanQueue.size()));
+        {
+            QMutexLocker locker(&mutex);
+            if (pendingDevices.contains(device.getIp())) {
+                return;
+            }
+            pendingDevices[device.getIp()] = device;
         }
 
-        locker.unlock();
-
-        // Try to process next in queue (will only start if scanner is free)
-        processNextPortScan();
+        // Queue immediately; the scanner runs all queued hosts in parallel
+        QList<int> tcpPorts = currentConfig.portsToScan;
+        if (tcpPorts.isEmpty()) {
+            tcpPorts = ServiceTable::instance().topPorts(PortScanner::QUICK_SCAN_PORTS);
+        }
+        portScanner->queueHost(device.getIp(), tcpPorts, currentConfig.udpPortsToScan);
     }
 }
 
@@ -242,30 +392,39 @@ void ScanCoordinator::cleanup() {
     scanning = false;
     paused = false;
     stopRequested = false;
+    discoveryFinished = false;
+    requeueing = false;
 
-    // Stop metrics collection
-    if (metricsAggregator && metricsAggregator->isCollecting()) {
-        metricsAggregator->stopContinuousCollection();
-    }
+    rateTimer->stop();
+    checkpointTimer->stop();
+    RateController::instance()->setTargetRate(0.0);
+
+    pipelineStages.clear();
+    ipv6Strategy.reset();
+
+    ScanScheduler::instance()->unregisterJob(schedulerJob);
+    schedulerJob = 0;
 
     // Clear port scanning data
     QMutexLocker locker(&mutex);
     pendingDevices.clear();
-    portScanResults.clear();
-    portScanQueue.clear();
-    currentPortScanHost.clear();
 }
 
 void ScanCoordinator::onDeviceFound(const Device& device) {
-    if (stopRequested || paused) {
+    // Results still arrive while paused: they were probed before the pause took effect
+    if (stopRequested) {
         return;
     }
 
     Device deviceCopy = device;
 
     // Always emit device immediately (even if we'll scan ports later)
-    // This ensures users see discovered devices right away
-    emit deviceDiscovered(deviceCopy);
+    // This ensures users see discovered devices right away. A batched
+    // liveness result can arrive after a pipeline stage already reported
+    // the host; it must not overwrite the richer update.
+    if (!pipelineStages.contains(deviceCopy.getIp())) {
+        emit deviceDiscovered(deviceCopy);
+    }
     devicesFoundCount++;
 
     // Process device (including port scanning if enabled)
@@ -274,15 +433,316 @@ void ScanCoordinator::onDeviceFound(const Device& device) {
 }
 
 void ScanCoordinator::onScanFinished() {
+    if (!stopRequested && hasOutstandingWork()) {
+        // Host discovery is done, but port scans, pipeline stages or IPv6 discovery are still running
+        discoveryFinished = true;
+        Logger::info(QString("Host discovery finished, waiting for %1 port scans and %2 pipelined hosts")
+                    .arg(pendingDevices.size())
+                    .arg(pipeline ? pipeline->pendingDevices() : 0));
+        return;
+    }
+
+    finishScan();
+}
+
+bool ScanCoordinator::hasOutstandingWork() const {
+    if (pipeline && !pipeline->isIdle()) {
+        return true;
+    }
+
+    if (ipv6Strategy || requeueing) {
+        return true;
+    }
+
+    QMutexLocker locker(&mutex);
+    return !pendingDevices.isEmpty();
+}
+
+void ScanCoordinator::onPipelineUpdate(const Device& device, int stage) {
+    if (stopRequested || !scanning) {
+        return;
+    }
+
+    // Partial result: identity, then hostname, then ports
+    pipelineStages[device.getIp()] = stage;
+    emit deviceDiscovered(device);
+}
+
+void ScanCoordinator::onPipelineIdle() {
+    // Devices may have entered again since the signal was queued
+    if (scanning && discoveryFinished && !hasOutstandingWork()) {
+        finishScan();
+    }
+}
+
+void ScanCoordinator::startIpv6Discovery() {
+    std::shared_ptr<Ipv6ScanStrategy> strategy = std::make_shared<Ipv6ScanStrategy>();
+    strategy->setInterface(currentConfig.ipv6Interface);
+    strategy->setCandidates(currentConfig.ipv6Candidates);
+    strategy->setKnownMacs(currentConfig.knownMacs);
+    ipv6Strategy = strategy;
+
+    Logger::info(QString("Starting IPv6 discovery (%1 candidates, %2 known MACs)")
+                .arg(currentConfig.ipv6Candidates.size()).arg(currentConfig.knownMacs.size()));
+
+    // The result is handed back on this thread; a stopped scan's late result is dropped there
+    QtConcurrent::run(threadPool, [this, strategy]() {
+        QList<Device> devices = strategy->discoverAll();
+        QMetaObject::invokeMethod(this, [this, strategy, devices]() {
+            if (strategy == ipv6Strategy) {
+                onIpv6DiscoveryFinished(devices);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ScanCoordinator::onIpv6DiscoveryFinished(const QList<Device>& devices) {
+    ipv6Strategy.reset();
+
+    if (stopRequested || !scanning) {
+        return;
+    }
+
+    // Dual-stack hosts come back under their IPv4 address and merge with the sweep's record
+    for (const Device& device : devices) {
+        emit deviceDiscovered(device);
+        if (device.getIp().contains(':')) {
+            devicesFoundCount++;
+        }
+    }
+
+    if (discoveryFinished && !hasOutstandingWork()) {
+        finishScan();
+    }
+}
+
+void ScanCoordinator::requeueHosts(const QStringList& hosts) {
+    Logger::info(QString("Resuming %1 hosts left unfinished at the checkpoint").arg(hosts.size()));
+
+    if (!pipeline) {
+        for (const QString& ip : hosts) {
+            Device device(ip);
+            device.setOnline(true);
+            processDiscoveredDevice(device);
+        }
+        return;
+    }
+
+    // submit() blocks while a stage queue is full, so feed the pipeline off this thread
+    requeueing = true;
+    ScanPipeline* stages = pipeline;
+    int generation = scanGeneration;
+    requeueFuture = QtConcurrent::run(threadPool, [this, stages, hosts, generation]() {
+        for (const QString& ip : hosts) {
+            Device device(ip);
+            device.setOnline(true);
+            if (!stages->submit(device)) {
+                break;  // Cancelled
+            }
+        }
+        QMetaObject::invokeMethod(this, [this, generation]() {
+            if (generation != scanGeneration || !scanning) {
+                return;
+            }
+            requeueing = false;
+            if (discoveryFinished && !hasOutstandingWork()) {
+                finishScan();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+ScanCheckpoint ScanCoordinator::checkpoint(const QString& status) const {
+    ScanCheckpoint result;
+    result.id = currentConfig.checkpointId;
+    result.targetSpec = targetDescription;
+    result.config = currentConfig.toJson();
+    result.orderSeed = currentConfig.randomizeOrder ? currentConfig.orderSeed : 0;
+    result.totalHosts = static_cast<quint64>(totalProgress);
+    result.devicesFound = devicesFoundCount;
+    result.status = status;
+    result.startedAt = QDateTime::fromMSecsSinceEpoch(scanStartTime);
+    result.updatedAt = QDateTime::currentDateTime();
+
+    if (currentConfig.startIndex >= result.totalHosts) {
+        result.completedIndex = result.totalHosts;
+    } else {
+        result.completedIndex = ipScanner ? ipScanner->completedIndex() : currentConfig.startIndex;
+    }
+
+    // Alive hosts whose identity, DNS or port stages are still to finish
+    QSet<QString> pending;
+    if (pipeline) {
+        for (const QString& ip : pipeline->pendingHosts()) {
+            pending.insert(ip);
+        }
+    }
+    if (requeueing) {
+        for (const QString& ip : currentConfig.resumeHosts) {
+            pending.insert(ip);
+        }
+    }
+    {
+        QMutexLocker locker(&mutex);
+        for (auto it = pendingDevices.constBegin(); it != pendingDevices.constEnd(); ++it) {
+            pending.insert(it.key());
+        }
+    }
+    result.pendingHosts = QStringList(pending.begin(), pending.end());
+    result.pendingHosts.sort();
+
+    return result;
+}
+
+QJsonObject ScanCoordinator::ScanConfig::toJson() const {
+    auto intArray = [](const QList<int>& values) {
+        QJsonArray array;
+        for (int value : values) {
+            array.append(value);
+        }
+        return array;
+    };
+
+    QJsonObject json;
+    json["subnet"] = subnet;
+    json["targetFile"] = targetFile;
+    json["resolveDns"] = resolveDns;
+    json["discoverNames"] = discoverNames;
+    json["resolveArp"] = resolveArp;
+    json["scanPorts"] = scanPorts;
+    json["portsToScan"] = intArray(portsToScan);
+    json["topPorts"] = topPorts;
+    json["udpPortsToScan"] = intArray(udpPortsToScan);
+    json["udpTopPorts"] = udpTopPorts;
+    json["detectVersions"] = detectVersions;
+    json["timeout"] = timeout;
+    json["minTimeout"] = minTimeout;
+    json["maxThreads"] = maxThreads;
+    json["maxInFlightProbes"] = maxInFlightProbes;
+    json["randomizeOrder"] = randomizeOrder;
+    json["orderSeed"] = QString::number(orderSeed);  // Doubles lose 64-bit seeds
+    json["targetRate"] = targetRate;
+    json["identityWorkers"] = identityWorkers;
+    json["dnsWorkers"] = dnsWorkers;
+    json["portWorkers"] = portWorkers;
+    json["discoverIpv6"] = discoverIpv6;
+    json["ipv6Interface"] = ipv6Interface;
+    json["ipv6Candidates"] = QJsonArray::fromStringList(ipv6Candidates);
+    json["knownMacs"] = QJsonArray::fromStringList(knownMacs);
+    json["priority"] = static_cast<int>(priority);
+    return json;
+}
+
+ScanCoordinator::ScanConfig ScanCoordinator::ScanConfig::fromJson(const QJsonObject& json) {
+    auto intList = [](const QJsonValue& value) {
+        QList<int> values;
+        for (const QJsonValue& item : value.toArray()) {
+            values.append(item.toInt());
+        }
+        return values;
+    };
+    auto stringList = [](const QJsonValue& value) {
+        QStringList values;
+        for (const QJsonValue& item : value.toArray()) {
+            values.append(item.toString());
+        }
+        return values;
+    };
+
+    ScanConfig config;
+    config.subnet = json.value("subnet").toString();
+    config.targetFile = json.value("targetFile").toString();
+    config.resolveDns = json.value("resolveDns").toBool(config.resolveDns);
+    config.discoverNames = json.value("discoverNames").toBool(config.discoverNames);
+    config.resolveArp = json.value("resolveArp").toBool(config.resolveArp);
+    config.scanPorts = json.value("scanPorts").toBool(config.scanPorts);
+    config.portsToScan = intList(json.value("portsToScan"));
+    config.topPorts = json.value("topPorts").toInt(config.topPorts);
+    config.udpPortsToScan = intList(json.value("udpPortsToScan"));
+    config.udpTopPorts = json.value("udpTopPorts").toInt(config.udpTopPorts);
+    config.detectVersions = json.value("detectVersions").toBool(config.detectVersions);
+    config.timeout = json.value("timeout").toInt(config.timeout);
+    config.minTimeout = json.value("minTimeout").toInt(config.minTimeout);
+    config.maxThreads = json.value("maxThreads").toInt(config.maxThreads);
+    config.maxInFlightProbes = json.value("maxInFlightProbes").toInt(config.maxInFlightProbes);
+    config.randomizeOrder = json.value("randomizeOrder").toBool(config.randomizeOrder);
+    config.orderSeed = json.value("orderSeed").toString().toULongLong();
+    config.targetRate = json.value("targetRate").toDouble(config.targetRate);
+    config.identityWorkers = json.value("identityWorkers").toInt(config.identityWorkers);
+    config.dnsWorkers = json.value("dnsWorkers").toInt(config.dnsWorkers);
+    config.portWorkers = json.value("portWorkers").toInt(config.portWorkers);
+    config.discoverIpv6 = json.value("discoverIpv6").toBool(config.discoverIpv6);
+    config.ipv6Interface = json.value("ipv6Interface").toString();
+    config.ipv6Candidates = stringList(json.value("ipv6Candidates"));
+    config.knownMacs = stringList(json.value("knownMacs"));
+    config.priority = static_cast<ScanScheduler::Priority>(
+        qBound<int>(ScanScheduler::Background, json.value("priority").toInt(config.priority), ScanScheduler::Interactive));
+    return config;
+}
+
+QVector<ScanPipeline::StageStats> ScanCoordinator::pipelineStats() const {
+    QVector<ScanPipeline::StageStats> result;
+    if (pipeline) {
+        for (int i = 0; i < ScanPipeline::StageCount; ++i) {
+            result.append(pipeline->stats(static_cast<ScanPipeline::Stage>(i)));
+        }
+    }
+    return result;
+}
+
+void ScanCoordinator::finishScan() {
     qint64 duration = QDateTime::currentMSecsSinceEpoch() - scanStartTime;
 
     if (!stopRequested) {
         Logger::info("Scan completed: " + QString::number(devicesFoundCount) +
                      " devices found in " + QString::number(duration) + " ms");
+        emit scanCheckpoint(checkpoint(ScanCheckpoint::STATUS_COMPLETED));
         emit scanCompleted(devicesFoundCount, duration);
     }
 
+    logPipelineStats();
     cleanup();
+    deleteRetiredStrategies();
+}
+
+void ScanCoordinator::retireStrategy(IScanStrategy* strategy) {
+    if (!strategy) {
+        return;
+    }
+
+    retiredStrategies.append(strategy);
+    deleteRetiredStrategies();
+    if (!retiredStrategies.isEmpty()) {
+        Logger::warn("Previous scan's workers still running, keeping its strategy until they finish");
+    }
+}
+
+void ScanCoordinator::deleteRetiredStrategies() {
+    // Workers of every scan share the scanner's pool: once it is drained,
+    // nothing can still reach a retired strategy
+    if (retiredStrategies.isEmpty() || (ipScanner && !ipScanner->waitForWorkers(0))) {
+        return;
+    }
+
+    qDeleteAll(retiredStrategies);
+    retiredStrategies.clear();
+}
+
+void ScanCoordinator::logPipelineStats() {
+    if (!pipeline) {
+        return;
+    }
+
+    QStringList stages;
+    for (int i = 0; i < ScanPipeline::StageCount; ++i) {
+        ScanPipeline::StageStats stats = pipeline->stats(static_cast<ScanPipeline::Stage>(i));
+        stages << QString("%1 n=%2 avg=%3ms max=%4ms")
+                  .arg(ScanPipeline::stageName(static_cast<ScanPipeline::Stage>(i)))
+                  .arg(stats.processed)
+                  .arg(stats.averageLatencyMs, 0, 'f', 1)
+                  .arg(stats.maxLatencyMs, 0, 'f', 1);
+    }
+    Logger::info("Pipeline: " + stages.join(", "));
 }
 
 IScanStrategy* ScanCoordinator::createScanStrategy(const ScanConfig& config) {
@@ -297,6 +757,23 @@ IScanStrategy* ScanCoordinator::createScanStrategy(const ScanConfig& config) {
         DeepScanStrategy* strategy = new DeepScanStrategy();
         // Only enable port scanning if explicitly requested
         strategy->setPortScanningEnabled(config.scanPorts);
+        strategy->setDnsEnabled(config.resolveDns);
+        strategy->setPorts(config.portsToScan);
+        strategy->setUdpPorts(config.udpPortsToScan);
+        strategy->setServiceDetection(config.detectVersions);
+
+        // Liveness stays on the scanner's workers; the other stages get their own
+        strategy->setPipelined(true);
+        ScanPipeline* stages = strategy->pipeline();
+        if (config.identityWorkers > 0) {
+            stages->setConcurrency(ScanPipeline::Identity, config.identityWorkers);
+        }
+        if (config.dnsWorkers > 0) {
+            stages->setConcurrency(ScanPipeline::Dns, config.dnsWorkers);
+        }
+        if (config.portWorkers > 0) {
+            stages->setConcurrency(ScanPipeline::Ports, config.portWorkers);
+        }
         return strategy;
     } else {
         // QuickScanStrategy: basic ping-only scan
@@ -305,33 +782,17 @@ IScanStrategy* ScanCoordinator::createScanStrategy(const ScanConfig& config) {
     }
 }
 
-void ScanCoordinator::onPortFound(const QString& host, int port, const QString& service) {
-    QMutexLocker locker(&mutex);
-
-    // Store port result for this host
-    if (portScanResults.contains(host)) {
-        portScanResults[host].append(qMakePair(port, service));
-        Logger::debug(QString("Port found on %1: %2 (%3)").arg(host).arg(port).arg(service));
-    }
-}
-
-void ScanCoordinator::onPortScanCompleted(const QString& host) {
-    Logger::info(QString("onPortScanCompleted called for host: %1").arg(host));
-
-    QMutexLocker locker(&mutex);
-    int portsFound = portScanResults.value(host).size();
-    locker.unlock();
-
-    Logger::info(QString("Port scan completed for %1 - found %2 ports").arg(host).arg(portsFound));
+void ScanCoordinator::onPortScanCompleted(const QString& host, const QList<PortScanner::PortScanResult>& openPorts) {
+    Logger::info(QString("Port scan completed for %1 - found %2 ports").arg(host).arg(openPorts.size()));
 
-    emitDeviceWithPorts(host);
+    emitDeviceWithPorts(host, openPorts);
 
-    // Process next device in queue
-    Logger::debug("Calling processNextPortScan from onPortScanCompleted");
-    processNextPortScan();
+    if (discoveryFinished && !hasOutstandingWork()) {
+        finishScan();
+    }
 }
 
-void ScanCoordinator::emitDeviceWithPorts(const QString& ip) {
+void ScanCoordinator::emitDeviceWithPorts(const QString& ip, const QList<PortScanner::PortScanResult>& openPorts) {
     QMutexLocker locker(&mutex);
 
     // Check if we have this device in pending list
@@ -340,32 +801,23 @@ void ScanCoordinator::emitDeviceWithPorts(const QString& ip) {
         return;
     }
 
-    // Get the device and port results
-    Device device = pendingDevices[ip];
-    QList<QPair<int, QString>> ports = portScanResults.value(ip);
+    // Take the device and add all found ports
+    Device device = pendingDevices.take(ip);
+    locker.unlock();
 
-    // Add all found ports to the device
-    for (const auto& portPair : ports) {
-        PortInfo portInfo(portPair.first, PortInfo::TCP);
-        portInfo.setService(portPair.second);
+    for (const PortScanner::PortScanResult& result : openPorts) {
+        PortInfo portInfo(result.port, result.protocol == "udp" ? PortInfo::UDP : PortInfo::TCP);
+        portInfo.setService(result.service);
+        portInfo.setVersion(result.version);
         portInfo.setState(PortInfo::Open);
         device.addPort(portInfo);
     }
 
-    // Clean up
-    pendingDevices.remove(ip);
-    portScanResults.remove(ip);
-    if (currentPortScanHost == ip) {
-        currentPortScanHost.clear();
-    }
-
-    locker.unlock();
-
     // Emit the device with ports
     emit deviceDiscovered(device);
     devicesFoundCount++;
 
-    Logger::info(QString("Device %1 discovered with %2 open ports").arg(ip).arg(ports.size()));
+    Logger::info(QString("Device %1 discovered with %2 open ports").arg(ip).arg(openPorts.size()));
 
     // Debug: Log each port
     for (const PortInfo& port : device.getOpenPorts()) {
@@ -377,44 +829,29 @@ void ScanCoordinator::emitDeviceWithPorts(const QString& ip) {
     }
 }
 
-void ScanCoordinator::processNextPortScan() {
-    QMutexLocker locker(&mutex);
-
-    Logger::debug(QString("processNextPortScan called - queue size: %1").arg(portScanQueue.size()));
-
-    // Check if there's anything in the queue
-    if (portScanQueue.isEmpty()) {
-        Logger::debug("Port scan queue is empty, nothing to process");
-        return;
+QList<int> ScanCoordinator::resolvePorts(const QList<int>& explicitPorts, int topPorts, bool udp) {
+    if (topPorts <= 0) {
+        return explicitPorts;
     }
 
-    // Check if scanner is already busy
-    if (portScanner && portScanner->isScanning()) {
-        Logger::debug("PortScanner is busy, waiting...");
-        return;
+    // Frequency-ranked ports first, then any explicitly listed extras
+    const ServiceTable& services = ServiceTable::instance();
+    ServiceTable::Protocol protocol = udp ? ServiceTable::Udp : ServiceTable::Tcp;
+    QList<int> ports = services.topPorts(topPorts, protocol);
+    if (topPorts > services.size(protocol)) {
+        Logger::warn(QString("Top %1 %2 ports requested, the service table ranks only %3")
+                    .arg(topPorts).arg(udp ? "UDP" : "TCP").arg(services.size(protocol)));
     }
-
-    if (!portScanner) {
-        Logger::error("PortScanner is null!");
-        return;
+    for (int port : explicitPorts) {
+        if (!ports.contains(port)) {
+            ports.append(port);
+        }
     }
 
-    // Get next IP from queue
-    QString nextIp = portScanQueue.takeFirst();
-    currentPortScanHost = nextIp;
-
-    locker.unlock();
-
-    Logger::info(QString("Processing port scan for %1 (%2 remaining in queue)")
-                .arg(nextIp)
-                .arg(portScanQueue.size()));
-
-    // Log the ports we're going to scan
-    if (currentConfig.portsToScan.isEmpty()) {
-        Logger::debug("Using QUICK_SCAN (common ports)");
-        portScanner->scanPorts(nextIp, PortScanner::QUICK_SCAN);
-    } else {
-        Logger::debug(QString("Scanning custom ports: %1").arg(currentConfig.portsToScan.size()));
-        portScanner->scanPorts(nextIp, currentConfig.portsToScan);
-    }
+    Logger::info(QString("Scanning top %1 %2 ports (%3 total, ~%4 open per host expected)")
+                .arg(qMin(topPorts, services.size(protocol)))
+                .arg(udp ? "UDP" : "TCP")
+                .arg(ports.size())
+                .arg(services.expectedOpen(topPorts, protocol), 0, 'f', 2));
+    return ports;
 }
@@ -93,6 +93,7 @@ bool DatabaseManager::createSchema() {
     bool success = createSchemaVersionTable() &&
                    createDevicesTable() &&
                    createPortsTable() &&
+                   createIpv6AddressesTable() &&
                    createMetricsTable() &&
                    createIndices();
 
@@ -157,14 +158,53 @@ bool DatabaseManager::createPortsTable() {
             port_number INTEGER,
             protocol TEXT,
             service TEXT,
+            version TEXT,
             state TEXT,
             FOREIGN KEY (device_id) REFERENCES devices(id) ON DELETE CASCADE
         )
     )";
 
+    if (!executeQuery(query)) {
+        return false;
+    }
+
+    // Databases created before version detection lack the column
+    return addColumnIfMissing("ports", "version", "TEXT");
+}
+
+bool DatabaseManager::createIpv6AddressesTable() {
+    // A device has any number of IPv6 addresses (link-local, SLAAC, temporary)
+    QString query = R"(
+        CREATE TABLE IF NOT EXISTS ipv6_addresses (
+            device_id TEXT NOT NULL,
+            address TEXT NOT NULL,
+            last_seen DATETIME,
+            PRIMARY KEY (device_id, address),
+            FOREIGN KEY (device_id) REFERENCES devices(id) ON DELETE CASCADE
+        )
+    )";
+
     return executeQuery(query);
 }
 
+bool DatabaseManager::addColumnIfMissing(const QString& table, const QString& column, const QString& type) {
+    QSqlQuery query(db);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        lastError = query.lastError().text();
+        Logger::error("DatabaseManager: " + lastError);
+        return false;
+    }
+
+    while (query.next()) {
+        if (query.value("name").toString() == column) {
+            return true;
+        }
+    }
+
+    Logger::info(QString("DatabaseManager: Adding column %1.%2").arg(table, column));
+    return executeQuery(QString("ALTER TABLE %1 ADD COLUMN %2 %3").arg(table, column, type));
+}
+
 bool DatabaseManager::createMetricsTable() {
     QString query = R"(
         CREATE TABLE IF NOT EXISTS metrics (
@@ -190,7 +230,8 @@ bool DatabaseManager::createIndices() {
         "CREATE INDEX IF NOT EXISTS idx_devices_ip ON devices(ip)",
         "CREATE INDEX IF NOT EXISTS idx_devices_last_seen ON devices(last_seen)",
         "CREATE INDEX IF NOT EXISTS idx_metrics_device_timestamp ON metrics(device_id, timestamp)",
-        "CREATE INDEX IF NOT EXISTS idx_ports_device ON ports(device_id)"
+        "CREATE INDEX IF NOT EXISTS idx_ports_device ON ports(device_id)",
+        "CREATE INDEX IF NOT EXISTS idx_ipv6_addresses_address ON ipv6_addresses(address)"
     };
 
     for (const QString& index : indices) {
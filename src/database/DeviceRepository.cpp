@@ -13,11 +13,30 @@ void DeviceRepository::save(const Device& device) {
     // Check if device exists by IP (not ID, since new devices don't have ID yet)
     Device existing = findByIp(device.getIp());
 
+    // A host found over IPv6 may already be known by another address:
+    // one of its stored IPv6 addresses, or its MAC on an existing record
+    bool ipv6Only = device.getIp().contains(':');
+    if (existing.getIp().isEmpty() && ipv6Only) {
+        existing = findByIpv6(device.getIp());
+        if (existing.getIp().isEmpty() && !device.getMacAddress().isEmpty()) {
+            existing = findByMac(device.getMacAddress());
+        }
+    }
+
     if (!existing.getIp().isEmpty()) {
         // Device exists, update it
         Device updatedDevice = device;
         updatedDevice.setId(existing.getId());  // Keep the same ID
 
+        // Keep the primary (usually IPv4) address; the IPv6 one joins the list
+        if (ipv6Only && existing.getIp() != device.getIp()) {
+            updatedDevice.setIp(existing.getIp());
+            updatedDevice.addIpv6Address(device.getIp());
+        }
+        for (const QString& address : existing.getIpv6Addresses()) {
+            updatedDevice.addIpv6Address(address);
+        }
+
         // Preserve existing comments if new device doesn't have them
         if (updatedDevice.getComments().isEmpty() && !existing.getComments().isEmpty()) {
             updatedDevice.setComments(existing.getComments());
@@ -70,6 +89,43 @@ Device DeviceRepository::findById(const QString& id) {
     return Device(); // Not found
 }
 
+Device DeviceRepository::findByIpv6(const QString& address) {
+    QSqlQuery query = db->prepareQuery(
+        "SELECT devices.* FROM devices JOIN ipv6_addresses ON ipv6_addresses.device_id = devices.id "
+        "WHERE ipv6_addresses.address = :address"
+    );
+    query.bindValue(":address", Device::normalizeIpv6(address));
+
+    if (!query.exec()) {
+        Logger::error("DeviceRepository: Failed to find device by IPv6 address: " + query.lastError().text());
+        return Device();
+    }
+
+    if (query.next()) {
+        return mapFromQuery(query);
+    }
+
+    return Device();
+}
+
+Device DeviceRepository::findByMac(const QString& mac) {
+    QSqlQuery query = db->prepareQuery(
+        "SELECT * FROM devices WHERE UPPER(mac_address) = :mac ORDER BY last_seen DESC"
+    );
+    query.bindValue(":mac", mac.toUpper());
+
+    if (!query.exec()) {
+        Logger::error("DeviceRepository: Failed to find device by MAC: " + query.lastError().text());
+        return Device();
+    }
+
+    if (query.next()) {
+        return mapFromQuery(query);
+    }
+
+    return Device();
+}
+
 Device DeviceRepository::findByIp(const QString& ip) {
     QSqlQuery query = db->prepareQuery("SELECT * FROM devices WHERE ip = :ip");
     query.bindValue(":ip", ip);
@@ -146,6 +202,11 @@ void DeviceRepository::remove(const QString& id) {
         return;
     }
 
+    // SQLite only cascades with foreign_keys enabled
+    QSqlQuery addressQuery = db->prepareQuery("DELETE FROM ipv6_addresses WHERE device_id = :id");
+    addressQuery.bindValue(":id", id);
+    addressQuery.exec();
+
     // Remove from cache
     if (cacheEnabled) {
         cache.remove(id);
@@ -187,6 +248,7 @@ void DeviceRepository::enableCache(bool enable) {
 }
 
 void DeviceRepository::clear() {
+    db->executeQuery("DELETE FROM ipv6_addresses");
     db->executeQuery("DELETE FROM devices");
     clearCache();
     Logger::info("DeviceRepository: All devices cleared");
@@ -228,6 +290,7 @@ Device DeviceRepository::mapFromQuery(const QSqlQuery& query) {
             port.setProtocol(protocolStr == "UDP" ? PortInfo::UDP : PortInfo::TCP);
 
             port.setService(portsQuery.value("service").toString());
+            port.setVersion(portsQuery.value("version").toString());
 
             // Convert state string to enum
             QString stateStr = portsQuery.value("state").toString();
@@ -244,6 +307,19 @@ Device DeviceRepository::mapFromQuery(const QSqlQuery& query) {
         device.setOpenPorts(ports);
     }
 
+    QSqlQuery addressQuery = db->prepareQuery(
+        "SELECT address FROM ipv6_addresses WHERE device_id = :device_id ORDER BY last_seen DESC"
+    );
+    addressQuery.bindValue(":device_id", device.getId());
+
+    if (addressQuery.exec()) {
+        QStringList addresses;
+        while (addressQuery.next()) {
+            addresses.append(addressQuery.value(0).toString());
+        }
+        device.setIpv6Addresses(addresses);
+    }
+
     return device;
 }
 
@@ -279,6 +355,7 @@ void DeviceRepository::saveToDatabase(const Device& device) {
 
     // Save ports
     savePorts(device.getId(), device.getOpenPorts());
+    saveIpv6Addresses(deviceToSave.getId(), device.getIpv6Addresses(), device.getLastSeen());
 
     Logger::info("DeviceRepository: Device saved: " + device.getIp());
 }
@@ -359,6 +436,9 @@ void DeviceRepository::updateInDatabase(const Device& device) {
         savePorts(device.getId(), device.getOpenPorts());
     }
 
+    // Addresses accumulate; each sighting refreshes its last_seen
+    saveIpv6Addresses(device.getId(), device.getIpv6Addresses(), device.getLastSeen());
+
     Logger::info(QString("DeviceRepository: Device updated: %1 (hostname: %2)")
                 .arg(device.getIp()).arg(hostname.isEmpty() ? "none" : hostname));
 }
@@ -366,8 +446,8 @@ void DeviceRepository::updateInDatabase(const Device& device) {
 void DeviceRepository::savePorts(const QString& deviceId, const QList<PortInfo>& ports) {
     for (const PortInfo& port : ports) {
         QString query = R"(
-            INSERT INTO ports (device_id, port_number, protocol, service, state)
-            VALUES (:device_id, :port, :protocol, :service, :state)
+            INSERT INTO ports (device_id, port_number, protocol, service, version, state)
+            VALUES (:device_id, :port, :protocol, :service, :version, :state)
         )";
 
         QSqlQuery sqlQuery = db->prepareQuery(query);
@@ -375,6 +455,7 @@ void DeviceRepository::savePorts(const QString& deviceId, const QList<PortInfo>&
         sqlQuery.bindValue(":port", port.getPort());
         sqlQuery.bindValue(":protocol", port.protocolString());
         sqlQuery.bindValue(":service", port.getService());
+        sqlQuery.bindValue(":version", port.getVersion());
         sqlQuery.bindValue(":state", port.stateString());
 
         if (!sqlQuery.exec()) {
@@ -383,6 +464,23 @@ void DeviceRepository::savePorts(const QString& deviceId, const QList<PortInfo>&
     }
 }
 
+void DeviceRepository::saveIpv6Addresses(const QString& deviceId, const QStringList& addresses,
+                                         const QDateTime& lastSeen) {
+    for (const QString& address : addresses) {
+        QSqlQuery sqlQuery = db->prepareQuery(R"(
+            INSERT OR REPLACE INTO ipv6_addresses (device_id, address, last_seen)
+            VALUES (:device_id, :address, :last_seen)
+        )");
+        sqlQuery.bindValue(":device_id", deviceId);
+        sqlQuery.bindValue(":address", address);
+        sqlQuery.bindValue(":last_seen", lastSeen.isValid() ? lastSeen : QDateTime::currentDateTime());
+
+        if (!sqlQuery.exec()) {
+            Logger::warn("DeviceRepository: Failed to save IPv6 address: " + sqlQuery.lastError().text());
+        }
+    }
+}
+
 void DeviceRepository::saveMetrics(const QString& deviceId, const NetworkMetrics& metrics) {
     QString query = R"(
         INSERT INTO metrics (device_id, latency_min, latency_avg, latency_max,
@@ -35,6 +35,7 @@ void MetricsDao::createTable() {
             packets_received INTEGER,
             quality_score INTEGER,
             timestamp DATETIME NOT NULL,
+            latency_histogram BLOB,
             FOREIGN KEY (device_id) REFERENCES devices(id)
         )
     )";
@@ -44,6 +45,9 @@ void MetricsDao::createTable() {
         return;
     }
 
+    // Tables created before latency histograms were stored lack the column
+    dbManager->addColumnIfMissing("metrics_history", "latency_histogram", "BLOB");
+
     // Create indices for faster queries
     query.exec("CREATE INDEX IF NOT EXISTS idx_metrics_device ON metrics_history(device_id)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_metrics_timestamp ON metrics_history(timestamp)");
@@ -52,7 +56,8 @@ void MetricsDao::createTable() {
     Logger::debug("Metrics history table created/verified");
 }
 
-bool MetricsDao::insert(const QString& deviceId, const NetworkMetrics& metrics) {
+bool MetricsDao::insert(const QString& deviceId, const NetworkMetrics& metrics,
+                        const LatencyHistogram& histogram) {
     if (deviceId.isEmpty()) {
         Logger::error("Cannot insert metrics: device ID is empty");
         return false;
@@ -62,10 +67,12 @@ bool MetricsDao::insert(const QString& deviceId, const NetworkMetrics& metrics)
     query.prepare(R"(
         INSERT INTO metrics_history (
             id, device_id, latency_min, latency_avg, latency_max, latency_median, latency_stddev,
-            jitter, packet_loss, packets_sent, packets_received, quality_score, timestamp
+            jitter, packet_loss, packets_sent, packets_received, quality_score, timestamp,
+            latency_histogram
         ) VALUES (
             :id, :device_id, :latency_min, :latency_avg, :latency_max, :latency_median, :latency_stddev,
-            :jitter, :packet_loss, :packets_sent, :packets_received, :quality_score, :timestamp
+            :jitter, :packet_loss, :packets_sent, :packets_received, :quality_score, :timestamp,
+            :latency_histogram
         )
     )");
 
@@ -84,6 +91,7 @@ bool MetricsDao::insert(const QString& deviceId, const NetworkMetrics& metrics)
     query.bindValue(":packets_received", 0); // Not available in NetworkMetrics
     query.bindValue(":quality_score", static_cast<int>(metrics.getQualityScore()));
     query.bindValue(":timestamp", metrics.timestamp().toString(Qt::ISODate));
+    query.bindValue(":latency_histogram", histogram.isEmpty() ? QVariant() : QVariant(histogram.toBlob()));
 
     if (!query.exec()) {
         Logger::error("Failed to insert metrics: " + query.lastError().text());
@@ -316,6 +324,46 @@ double MetricsDao::getAverageJitter(const QString& deviceId,
     return query.value("avg_jitter").toDouble();
 }
 
+LatencyHistogram MetricsDao::getLatencyHistogram(const QString& deviceId,
+                                                 const QDateTime& start,
+                                                 const QDateTime& end) {
+    LatencyHistogram histogram;
+
+    QSqlQuery query(dbManager->database());
+    query.prepare(R"(
+        SELECT latency_histogram
+        FROM metrics_history
+        WHERE device_id = :device_id
+        AND timestamp BETWEEN :start AND :end
+        AND latency_histogram IS NOT NULL
+    )");
+
+    query.bindValue(":device_id", deviceId);
+    query.bindValue(":start", start.toString(Qt::ISODate));
+    query.bindValue(":end", end.toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        Logger::error("Failed to get latency histogram: " + query.lastError().text());
+        return histogram;
+    }
+
+    int malformed = 0;
+    while (query.next()) {
+        bool ok = false;
+        histogram.merge(LatencyHistogram::fromBlob(query.value(0).toByteArray(), &ok));
+        if (!ok) {
+            malformed++;
+        }
+    }
+
+    if (malformed > 0) {
+        Logger::warn("Skipped " + QString::number(malformed) +
+                    " malformed latency histograms for device " + deviceId);
+    }
+
+    return histogram;
+}
+
 int MetricsDao::deleteOlderThan(const QDateTime& cutoffDate) {
     QSqlQuery query(dbManager->database());
     query.prepare("DELETE FROM metrics_history WHERE timestamp < :cutoff");
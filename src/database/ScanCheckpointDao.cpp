@@ -0,0 +1,192 @@
+#include "database/ScanCheckpointDao.h"
+#include "database/DatabaseManager.h"
+#include "utils/Logger.h"
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QVariant>
+
+const QString ScanCheckpoint::STATUS_RUNNING = "running";
+const QString ScanCheckpoint::STATUS_INTERRUPTED = "interrupted";
+const QString ScanCheckpoint::STATUS_COMPLETED = "completed";
+
+ScanCheckpointDao::ScanCheckpointDao(DatabaseManager* dbManager)
+    : dbManager(dbManager)
+{
+    createTable();
+    Logger::info("ScanCheckpointDao initialized");
+}
+
+ScanCheckpointDao::~ScanCheckpointDao() {
+}
+
+void ScanCheckpointDao::createTable() {
+    QSqlQuery query(dbManager->database());
+
+    // order_seed is TEXT: SQLite integers are signed and seeds use all 64 bits
+    QString sql = R"(
+        CREATE TABLE IF NOT EXISTS scan_checkpoints (
+            id TEXT PRIMARY KEY,
+            target_spec TEXT NOT NULL,
+            config TEXT NOT NULL,
+            order_seed TEXT,
+            completed_index INTEGER NOT NULL,
+            total_hosts INTEGER NOT NULL,
+            devices_found INTEGER,
+            pending_hosts TEXT,
+            status TEXT NOT NULL,
+            started_at DATETIME,
+            updated_at DATETIME NOT NULL
+        )
+    )";
+
+    if (!query.exec(sql)) {
+        Logger::error("Failed to create scan_checkpoints table: " + query.lastError().text());
+        return;
+    }
+
+    query.exec("CREATE INDEX IF NOT EXISTS idx_scan_checkpoints_status ON scan_checkpoints(status, updated_at)");
+
+    Logger::debug("Scan checkpoints table created/verified");
+}
+
+bool ScanCheckpointDao::save(const ScanCheckpoint& checkpoint) {
+    if (!checkpoint.isValid()) {
+        Logger::error("Cannot save invalid scan checkpoint");
+        return false;
+    }
+
+    QSqlQuery query(dbManager->database());
+    query.prepare(R"(
+        INSERT OR REPLACE INTO scan_checkpoints
+            (id, target_spec, config, order_seed, completed_index, total_hosts,
+             devices_found, pending_hosts, status, started_at, updated_at)
+        VALUES (:id, :target_spec, :config, :order_seed, :completed_index, :total_hosts,
+                :devices_found, :pending_hosts, :status, :started_at, :updated_at)
+    )");
+
+    QDateTime updatedAt = checkpoint.updatedAt.isValid() ? checkpoint.updatedAt : QDateTime::currentDateTime();
+
+    query.bindValue(":id", checkpoint.id);
+    query.bindValue(":target_spec", checkpoint.targetSpec);
+    query.bindValue(":config", QJsonDocument(checkpoint.config).toJson(QJsonDocument::Compact));
+    query.bindValue(":order_seed", QString::number(checkpoint.orderSeed));
+    query.bindValue(":completed_index", static_cast<qint64>(checkpoint.completedIndex));
+    query.bindValue(":total_hosts", static_cast<qint64>(checkpoint.totalHosts));
+    query.bindValue(":devices_found", checkpoint.devicesFound);
+    query.bindValue(":pending_hosts",
+                    QJsonDocument(QJsonArray::fromStringList(checkpoint.pendingHosts)).toJson(QJsonDocument::Compact));
+    query.bindValue(":status", checkpoint.status);
+    query.bindValue(":started_at", checkpoint.startedAt.toString(Qt::ISODateWithMs));
+    query.bindValue(":updated_at", updatedAt.toString(Qt::ISODateWithMs));
+
+    if (!query.exec()) {
+        Logger::error("Failed to save scan checkpoint: " + query.lastError().text());
+        return false;
+    }
+
+    Logger::debug(QString("Scan checkpoint %1: %2/%3, %4 pending, %5")
+                 .arg(checkpoint.id).arg(checkpoint.completedIndex).arg(checkpoint.totalHosts)
+                 .arg(checkpoint.pendingHosts.size()).arg(checkpoint.status));
+    return true;
+}
+
+ScanCheckpoint ScanCheckpointDao::findById(const QString& id) {
+    QSqlQuery query(dbManager->database());
+    query.prepare("SELECT * FROM scan_checkpoints WHERE id = :id");
+    query.bindValue(":id", id);
+
+    if (!query.exec()) {
+        Logger::error("Failed to query scan checkpoint: " + query.lastError().text());
+        return ScanCheckpoint();
+    }
+
+    if (query.next()) {
+        return checkpointFromQuery(query);
+    }
+    return ScanCheckpoint();
+}
+
+QList<ScanCheckpoint> ScanCheckpointDao::findResumable() {
+    QList<ScanCheckpoint> checkpoints;
+
+    QSqlQuery query(dbManager->database());
+    query.prepare("SELECT * FROM scan_checkpoints WHERE status != :completed ORDER BY updated_at DESC");
+    query.bindValue(":completed", ScanCheckpoint::STATUS_COMPLETED);
+
+    if (!query.exec()) {
+        Logger::error("Failed to query resumable scans: " + query.lastError().text());
+        return checkpoints;
+    }
+
+    while (query.next()) {
+        ScanCheckpoint checkpoint = checkpointFromQuery(query);
+        if (checkpoint.isResumable()) {
+            checkpoints.append(checkpoint);
+        }
+    }
+
+    return checkpoints;
+}
+
+ScanCheckpoint ScanCheckpointDao::findLatestResumable() {
+    QList<ScanCheckpoint> checkpoints = findResumable();
+    return checkpoints.isEmpty() ? ScanCheckpoint() : checkpoints.first();
+}
+
+bool ScanCheckpointDao::remove(const QString& id) {
+    QSqlQuery query(dbManager->database());
+    query.prepare("DELETE FROM scan_checkpoints WHERE id = :id");
+    query.bindValue(":id", id);
+
+    if (!query.exec()) {
+        Logger::error("Failed to delete scan checkpoint: " + query.lastError().text());
+        return false;
+    }
+
+    return query.numRowsAffected() > 0;
+}
+
+int ScanCheckpointDao::deleteCompletedBefore(const QDateTime& cutoffDate) {
+    QSqlQuery query(dbManager->database());
+    query.prepare("DELETE FROM scan_checkpoints WHERE status = :completed AND updated_at < :cutoff");
+    query.bindValue(":completed", ScanCheckpoint::STATUS_COMPLETED);
+    query.bindValue(":cutoff", cutoffDate.toString(Qt::ISODateWithMs));
+
+    if (!query.exec()) {
+        Logger::error("Failed to delete old scan checkpoints: " + query.lastError().text());
+        return 0;
+    }
+
+    return query.numRowsAffected();
+}
+
+ScanCheckpoint ScanCheckpointDao::checkpointFromQuery(QSqlQuery& query) {
+    ScanCheckpoint checkpoint;
+
+    checkpoint.id = query.value("id").toString();
+    checkpoint.targetSpec = query.value("target_spec").toString();
+    checkpoint.orderSeed = query.value("order_seed").toString().toULongLong();
+    checkpoint.completedIndex = static_cast<quint64>(query.value("completed_index").toLongLong());
+    checkpoint.totalHosts = static_cast<quint64>(query.value("total_hosts").toLongLong());
+    checkpoint.devicesFound = query.value("devices_found").toInt();
+    checkpoint.status = query.value("status").toString();
+    checkpoint.startedAt = QDateTime::fromString(query.value("started_at").toString(), Qt::ISODateWithMs);
+    checkpoint.updatedAt = QDateTime::fromString(query.value("updated_at").toString(), Qt::ISODateWithMs);
+
+    QJsonDocument config = QJsonDocument::fromJson(query.value("config").toString().toUtf8());
+    if (config.isObject()) {
+        checkpoint.config = config.object();
+    }
+
+    QJsonDocument pending = QJsonDocument::fromJson(query.value("pending_hosts").toString().toUtf8());
+    if (pending.isArray()) {
+        for (const QJsonValue& host : pending.array()) {
+            checkpoint.pendingHosts.append(host.toString());
+        }
+    }
+
+    return checkpoint;
+}
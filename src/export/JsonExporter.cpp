@@ -75,6 +75,7 @@ QJsonObject JsonExporter::portToJson(const PortInfo& port) {
     obj["port"] = port.getPort();
     obj["protocol"] = port.getProtocol();
     obj["service"] = port.getService();
+    obj["version"] = port.getVersion();
     obj["state"] = port.getState();
 
     return obj;
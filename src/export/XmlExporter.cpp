@@ -111,6 +111,9 @@ void XmlExporter::writePort(QXmlStreamWriter& writer, const PortInfo& port) {
     writer.writeAttribute("number", QString::number(port.getPort()));
     writer.writeTextElement("Protocol", port.protocolString());
     writer.writeTextElement("Service", port.getService());
+    if (!port.getVersion().isEmpty()) {
+        writer.writeTextElement("Version", port.getVersion());
+    }
     writer.writeTextElement("State", port.stateString());
     writer.writeEndElement(); // Port
 }
@@ -11,6 +11,7 @@
 #include "../database/DatabaseManager.h"
 #include "../database/DeviceRepository.h"
 #include "../database/DeviceCache.h"
+#include "../database/ScanCheckpointDao.h"
 #include "../network/scanner/IpScanner.h"
 #include "../network/diagnostics/PortScanner.h"
 #include "../network/diagnostics/MetricsAggregator.h"
@@ -97,6 +98,8 @@ int main(int argc, char *argv[])
     // Repositories and cache
     DeviceRepository* deviceRepo = new DeviceRepository(db);
     DeviceCache* cache = new DeviceCache();
+    ScanCheckpointDao* checkpointDao = new ScanCheckpointDao(db);
+    checkpointDao->deleteCompletedBefore(QDateTime::currentDateTime().addDays(-30));
 
     // ========== Network Services Setup ==========
 
@@ -132,6 +135,7 @@ int main(int argc, char *argv[])
         deviceRepo,
         cache
     );
+    scanCtrl->setCheckpointDao(checkpointDao);
 
     MetricsController* metricsCtrl = new MetricsController(
         metricsAgg,
@@ -213,6 +217,7 @@ int main(int argc, char *argv[])
     delete pingService;
     delete portScanner;
     delete ipScanner;
+    delete checkpointDao;
     delete cache;
     delete deviceRepo;
     db->close();
@@ -107,12 +107,12 @@ ScanProfile ProfileManager::createDeepProfile(const QString& subnet, const QStri
     ScanProfile profile;
     profile.id = generateProfileId();
     profile.name = name;
-    profile.description = "Deep scan: Ping, DNS, ARP, and common ports";
+    profile.description = "Deep scan: Ping, DNS, ARP, and the top 100 ports";
     profile.subnet = subnet;
     profile.resolveDns = true;
     profile.resolveArp = true;
     profile.scanPorts = true;
-    profile.portsToScan = {21, 22, 23, 25, 53, 80, 110, 135, 139, 143, 443, 445, 3389, 8080};
+    profile.topPorts = 100;
     profile.timeout = 3000;
     profile.createdAt = QDateTime::currentDateTime();
     profile.modifiedAt = QDateTime::currentDateTime();
@@ -202,6 +202,8 @@ QJsonObject ProfileManager::profileToJson(const ScanProfile& profile) const {
     json["resolveDns"] = profile.resolveDns;
     json["resolveArp"] = profile.resolveArp;
     json["scanPorts"] = profile.scanPorts;
+    json["topPorts"] = profile.topPorts;
+    json["detectVersions"] = profile.detectVersions;
     json["timeout"] = profile.timeout;
     json["createdAt"] = profile.createdAt.toString(Qt::ISODate);
     json["modifiedAt"] = profile.modifiedAt.toString(Qt::ISODate);
@@ -226,6 +228,8 @@ ScanProfile ProfileManager::profileFromJson(const QJsonObject& json) const {
     profile.resolveDns = json["resolveDns"].toBool(true);
     profile.resolveArp = json["resolveArp"].toBool(true);
     profile.scanPorts = json["scanPorts"].toBool(false);
+    profile.topPorts = json["topPorts"].toInt(0);
+    profile.detectVersions = json["detectVersions"].toBool(false);
     profile.timeout = json["timeout"].toInt(3000);
 
     // Parse timestamps
@@ -340,11 +344,7 @@ ScanProfile ProfileManager::createEnterpriseNetworkProfile() {
     profile.resolveDns = true;
     profile.resolveArp = true;
     profile.scanPorts = true;
-    profile.portsToScan = {
-        20, 21, 22, 23, 25, 53, 80, 110, 135, 139, 143, 389, 443, 445,
-        636, 993, 995, 1433, 1521, 3306, 3389, 5432, 5900, 8080, 8443
-    }; // FTP, SSH, Telnet, SMTP, DNS, HTTP, POP3, RPC, SMB, IMAP, LDAP, HTTPS,
-       // LDAPS, IMAPS, POP3S, MSSQL, Oracle, MySQL, RDP, PostgreSQL, VNC, Alt-HTTP, HTTPS-Alt
+    profile.topPorts = 100; // Most frequently open TCP services
     profile.timeout = 3000;
     profile.createdAt = QDateTime::currentDateTime();
     profile.modifiedAt = QDateTime::currentDateTime();
@@ -356,17 +356,13 @@ ScanProfile ProfileManager::createSecurityAuditProfile() {
     ScanProfile profile;
     profile.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
     profile.name = "Security Audit";
-    profile.description = "Security audit scan: Extensive port scan for vulnerability assessment";
+    profile.description = "Security audit scan: Top 250 ports with service detection for vulnerability assessment";
     profile.subnet = "192.168.1.0/24";
     profile.resolveDns = true;
     profile.resolveArp = true;
     profile.scanPorts = true;
-    profile.portsToScan = {
-        20, 21, 22, 23, 25, 53, 69, 79, 80, 110, 111, 123, 135, 137, 138, 139, 143, 161, 162,
-        389, 443, 445, 465, 514, 515, 587, 636, 873, 989, 990, 992, 993, 995, 1080, 1433, 1434,
-        1521, 1723, 2049, 2082, 2083, 2181, 2222, 3000, 3306, 3389, 4000, 4444, 5000, 5432, 5900,
-        6379, 6667, 7001, 8000, 8080, 8443, 8888, 9000, 9001, 9200, 9300, 10000, 27017, 50000
-    }; // Common ports + potentially vulnerable services
+    profile.topPorts = 250; // Frequency-ranked ports; the bundled table ranks 269 TCP ports
+    profile.detectVersions = true;
     profile.timeout = 5000;
     profile.createdAt = QDateTime::currentDateTime();
     profile.modifiedAt = QDateTime::currentDateTime();
@@ -42,6 +42,9 @@ NetworkMetrics Device::metrics() const { return m_metrics; }
 QString Device::getComments() const { return m_comments; }
 QString Device::comments() const { return m_comments; }
 
+QStringList Device::getIpv6Addresses() const { return m_ipv6Addresses; }
+QStringList Device::ipv6Addresses() const { return m_ipv6Addresses; }
+
 // Setters
 void Device::setId(const QString& id) { m_id = id; }
 
@@ -90,10 +93,18 @@ void Device::setComments(const QString& comments)
     m_comments = comments;
 }
 
+void Device::setIpv6Addresses(const QStringList& addresses)
+{
+    m_ipv6Addresses.clear();
+    for (const QString& address : addresses) {
+        addIpv6Address(address);
+    }
+}
+
 // Utility methods
 void Device::addPort(const PortInfo& port)
 {
-    if (!hasPort(port.portNumber())) {
+    if (!hasPort(port.portNumber(), port.protocol())) {
         m_openPorts.append(port);
     }
 }
@@ -117,3 +128,37 @@ bool Device::hasPort(int portNumber) const
     }
     return false;
 }
+
+bool Device::hasPort(int portNumber, PortInfo::Protocol protocol) const
+{
+    for (const PortInfo& port : m_openPorts) {
+        if (port.portNumber() == portNumber && port.protocol() == protocol) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Device::addIpv6Address(const QString& address)
+{
+    QString normalized = normalizeIpv6(address);
+    if (!normalized.isEmpty() && !m_ipv6Addresses.contains(normalized)) {
+        m_ipv6Addresses.append(normalized);
+    }
+}
+
+bool Device::hasIpv6Address(const QString& address) const
+{
+    return m_ipv6Addresses.contains(normalizeIpv6(address));
+}
+
+QString Device::normalizeIpv6(const QString& address)
+{
+    // Hex digits lowercase as RFC 5952 recommends; a zone ("%eth0") keeps its case
+    QString trimmed = address.trimmed();
+    int zone = trimmed.indexOf('%');
+    if (zone < 0) {
+        return trimmed.toLower();
+    }
+    return trimmed.left(zone).toLower() + trimmed.mid(zone);
+}
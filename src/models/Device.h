@@ -4,6 +4,7 @@
 #include <QString>
 #include <QDateTime>
 #include <QList>
+#include <QStringList>
 #include <QMetaType>
 #include "PortInfo.h"
 #include "NetworkMetrics.h"
@@ -33,6 +34,8 @@ public:
     NetworkMetrics metrics() const;
     QString getComments() const;
     QString comments() const;
+    QStringList getIpv6Addresses() const;
+    QStringList ipv6Addresses() const;
 
     // Setters
     void setId(const QString& id);
@@ -45,11 +48,22 @@ public:
     void setOpenPorts(const QList<PortInfo>& ports);
     void setMetrics(const NetworkMetrics& metrics);
     void setComments(const QString& comments);
+    void setIpv6Addresses(const QStringList& addresses);
 
     // Utility methods
     void addPort(const PortInfo& port);
     void removePort(int portNumber);
     bool hasPort(int portNumber) const;
+    bool hasPort(int portNumber, PortInfo::Protocol protocol) const;
+
+    // IPv6 addresses are kept alongside the primary IP (which may itself be IPv6)
+    void addIpv6Address(const QString& address);
+    bool hasIpv6Address(const QString& address) const;
+
+    /**
+     * @brief Canonical text for comparing IPv6 addresses (lowercase hex, zone kept)
+     */
+    static QString normalizeIpv6(const QString& address);
 
 private:
     QString m_id;
@@ -62,6 +76,7 @@ private:
     QList<PortInfo> m_openPorts;
     NetworkMetrics m_metrics;
     QString m_comments;
+    QStringList m_ipv6Addresses;
 };
 
 #endif // DEVICE_H
@@ -5,7 +5,10 @@ NetworkMetrics::NetworkMetrics()
     , m_latencyAvg(0.0)
     , m_latencyMax(0.0)
     , m_latencyMedian(0.0)
+    , m_latencyP95(0.0)
+    , m_latencyP99(0.0)
     , m_jitter(0.0)
+    , m_jitterWindowed(0.0)
     , m_packetLoss(0.0)
     , m_qualityScore(Critical)
 {
@@ -32,11 +35,26 @@ double NetworkMetrics::latencyMedian() const
     return m_latencyMedian;
 }
 
+double NetworkMetrics::latencyP95() const
+{
+    return m_latencyP95;
+}
+
+double NetworkMetrics::latencyP99() const
+{
+    return m_latencyP99;
+}
+
 double NetworkMetrics::jitter() const
 {
     return m_jitter;
 }
 
+double NetworkMetrics::jitterWindowed() const
+{
+    return m_jitterWindowed;
+}
+
 double NetworkMetrics::packetLoss() const
 {
     return m_packetLoss;
@@ -90,11 +108,26 @@ double NetworkMetrics::getLatencyMedian() const
     return latencyMedian();
 }
 
+double NetworkMetrics::getLatencyP95() const
+{
+    return latencyP95();
+}
+
+double NetworkMetrics::getLatencyP99() const
+{
+    return latencyP99();
+}
+
 double NetworkMetrics::getJitter() const
 {
     return jitter();
 }
 
+double NetworkMetrics::getJitterWindowed() const
+{
+    return jitterWindowed();
+}
+
 double NetworkMetrics::getPacketLoss() const
 {
     return packetLoss();
@@ -126,11 +159,26 @@ void NetworkMetrics::setLatencyMedian(double latency)
     m_latencyMedian = latency;
 }
 
+void NetworkMetrics::setLatencyP95(double latency)
+{
+    m_latencyP95 = latency;
+}
+
+void NetworkMetrics::setLatencyP99(double latency)
+{
+    m_latencyP99 = latency;
+}
+
 void NetworkMetrics::setJitter(double jitter)
 {
     m_jitter = jitter;
 }
 
+void NetworkMetrics::setJitterWindowed(double jitter)
+{
+    m_jitterWindowed = jitter;
+}
+
 void NetworkMetrics::setPacketLoss(double loss)
 {
     m_packetLoss = loss;
@@ -149,20 +197,22 @@ void NetworkMetrics::setTimestamp(const QDateTime& timestamp)
 // Utility methods
 void NetworkMetrics::calculateQualityScore()
 {
+    double jitter = scoringJitter();
+
     // Excellent: <20ms, <5% loss, <2ms jitter
-    if (m_latencyAvg < 20.0 && m_packetLoss < 5.0 && m_jitter < 2.0) {
+    if (m_latencyAvg < 20.0 && m_packetLoss < 5.0 && jitter < 2.0) {
         m_qualityScore = Excellent;
     }
     // Good: <50ms, <10% loss, <5ms jitter
-    else if (m_latencyAvg < 50.0 && m_packetLoss < 10.0 && m_jitter < 5.0) {
+    else if (m_latencyAvg < 50.0 && m_packetLoss < 10.0 && jitter < 5.0) {
         m_qualityScore = Good;
     }
     // Fair: <100ms, <20% loss, <10ms jitter
-    else if (m_latencyAvg < 100.0 && m_packetLoss < 20.0 && m_jitter < 10.0) {
+    else if (m_latencyAvg < 100.0 && m_packetLoss < 20.0 && jitter < 10.0) {
         m_qualityScore = Fair;
     }
     // Poor: <200ms, <30% loss, <20ms jitter
-    else if (m_latencyAvg < 200.0 && m_packetLoss < 30.0 && m_jitter < 20.0) {
+    else if (m_latencyAvg < 200.0 && m_packetLoss < 30.0 && jitter < 20.0) {
         m_qualityScore = Poor;
     }
     // Critical: everything else
@@ -175,3 +225,8 @@ bool NetworkMetrics::isValid() const
 {
     return m_latencyAvg > 0.0 || m_packetLoss > 0.0;
 }
+
+double NetworkMetrics::scoringJitter() const
+{
+    return qMax(m_jitter, m_jitterWindowed);
+}
@@ -22,7 +22,10 @@ public:
     double latencyAvg() const;
     double latencyMax() const;
     double latencyMedian() const;
+    double latencyP95() const;
+    double latencyP99() const;
     double jitter() const;
+    double jitterWindowed() const;
     double packetLoss() const;
     QualityScore qualityScore() const;
     QString qualityScoreString() const;
@@ -33,7 +36,10 @@ public:
     double getLatencyAvg() const;
     double getLatencyMax() const;
     double getLatencyMedian() const;
+    double getLatencyP95() const;
+    double getLatencyP99() const;
     double getJitter() const;
+    double getJitterWindowed() const;
     double getPacketLoss() const;
     QualityScore getQualityScore() const;
     QString getQualityScoreString() const;
@@ -43,7 +49,10 @@ public:
     void setLatencyAvg(double latency);
     void setLatencyMax(double latency);
     void setLatencyMedian(double latency);
+    void setLatencyP95(double latency);
+    void setLatencyP99(double latency);
     void setJitter(double jitter);
+    void setJitterWindowed(double jitter);
     void setPacketLoss(double loss);
     void setQualityScore(QualityScore score);
     void setTimestamp(const QDateTime& timestamp);
@@ -52,12 +61,24 @@ public:
     void calculateQualityScore();
     bool isValid() const;
 
+    /**
+     * @brief Jitter used for scoring: the larger of jitter() and jitterWindowed()
+     *
+     * jitter() is the RFC 3550 estimate, which starts at 0 and follows a
+     * change with a gain of 1/16; the window mean catches a fresh burst
+     * sooner, so neither can hide it from the score.
+     */
+    double scoringJitter() const;
+
 private:
     double m_latencyMin;
     double m_latencyAvg;
     double m_latencyMax;
     double m_latencyMedian;
+    double m_latencyP95;
+    double m_latencyP99;
     double m_jitter;
+    double m_jitterWindowed;
     double m_packetLoss;
     QualityScore m_qualityScore;
     QDateTime m_timestamp;
@@ -37,6 +37,11 @@ QString PortInfo::service() const
     return m_service;
 }
 
+QString PortInfo::version() const
+{
+    return m_version;
+}
+
 PortInfo::State PortInfo::state() const
 {
     return m_state;
@@ -68,6 +73,11 @@ QString PortInfo::getService() const
     return service();
 }
 
+QString PortInfo::getVersion() const
+{
+    return version();
+}
+
 PortInfo::State PortInfo::getState() const
 {
     return state();
@@ -89,6 +99,11 @@ void PortInfo::setService(const QString& service)
     m_service = service;
 }
 
+void PortInfo::setVersion(const QString& version)
+{
+    m_version = version;
+}
+
 void PortInfo::setState(State state)
 {
     m_state = state;
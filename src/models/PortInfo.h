@@ -25,6 +25,7 @@ public:
     Protocol protocol() const;
     QString protocolString() const;
     QString service() const;
+    QString version() const;
     State state() const;
     QString stateString() const;
 
@@ -32,12 +33,14 @@ public:
     int getPort() const;
     Protocol getProtocol() const;
     QString getService() const;
+    QString getVersion() const;
     State getState() const;
 
     // Setters
     void setPortNumber(int portNumber);
     void setProtocol(Protocol protocol);
     void setService(const QString& service);
+    void setVersion(const QString& version);
     void setState(State state);
 
     // Utility methods
@@ -47,6 +50,7 @@ private:
     int m_portNumber;
     Protocol m_protocol;
     QString m_service;
+    QString m_version;      ///< Banner/product version from service detection
     State m_state;
 };
 
@@ -1,19 +1,24 @@
 #include "JitterCalculator.h"
+#include "../../utils/StreamingStatistics.h"
 #include <cmath>
 
 double JitterCalculator::calculate(const QVector<double>& rttValues) {
-    if (rttValues.size() <= 1) {
-        return 0.0;
+    InterarrivalJitter jitter;
+    for (double rtt : rttValues) {
+        jitter.add(rtt);
     }
-
-    double mean = calculateAverage(rttValues);
-    return calculateStdDev(rttValues, mean);
+    return jitter.smoothed();
 }
 
 QString JitterCalculator::getCalculatorName() const {
     return "JitterCalculator";
 }
 
+double JitterCalculator::calculateWindowedJitter(const QVector<double>& rttValues) {
+    int first = qMax(0, static_cast<int>(rttValues.size()) - InterarrivalJitter::WINDOW - 1);
+    return calculateConsecutiveJitter(rttValues.mid(first));
+}
+
 double JitterCalculator::calculateConsecutiveJitter(const QVector<double>& rttValues) {
     if (rttValues.size() <= 1) {
         return 0.0;
@@ -31,21 +36,6 @@ double JitterCalculator::calculateConsecutiveJitter(const QVector<double>& rttVa
     return calculateAverage(differences);
 }
 
-double JitterCalculator::calculateStdDev(const QVector<double>& values, double mean) {
-    if (values.size() <= 1) {
-        return 0.0;
-    }
-
-    double sumSquaredDiff = 0.0;
-    for (double value : values) {
-        double diff = value - mean;
-        sumSquaredDiff += diff * diff;
-    }
-
-    // Using sample standard deviation (n-1)
-    return std::sqrt(sumSquaredDiff / (values.size() - 1));
-}
-
 double JitterCalculator::calculateAverage(const QVector<double>& values) {
     if (values.isEmpty()) {
         return 0.0;
@@ -7,9 +7,10 @@
 /**
  * @brief Calculator for jitter (latency variation)
  *
- * Jitter represents the variability in packet delay and is calculated
- * as the standard deviation of RTT values or the average of consecutive
- * RTT differences.
+ * Batch counterpart of InterarrivalJitter for a stored sequence of RTTs,
+ * e.g. to recompute jitter from history: the values are fed through the
+ * same estimator in order, so the results match what live monitoring
+ * reports for the same replies.
  */
 class JitterCalculator : public IMetricsCalculator {
 public:
@@ -17,9 +18,9 @@ public:
     ~JitterCalculator() override = default;
 
     /**
-     * @brief Calculate jitter as standard deviation (IMetricsCalculator interface)
-     * @param rttValues Vector of round-trip time values in milliseconds
-     * @return Jitter value (standard deviation of latencies)
+     * @brief Calculate RFC 3550 interarrival jitter (IMetricsCalculator interface)
+     * @param rttValues Round-trip times of consecutive replies in milliseconds, oldest first
+     * @return Smoothed jitter after the last value
      */
     double calculate(const QVector<double>& rttValues) override;
 
@@ -29,6 +30,17 @@ public:
      */
     QString getCalculatorName() const override;
 
+    /**
+     * @brief Calculate windowed jitter
+     *
+     * Mean absolute difference of the last InterarrivalJitter::WINDOW
+     * consecutive pairs, as InterarrivalJitter::windowed().
+     *
+     * @param rttValues Round-trip times of consecutive replies in milliseconds, oldest first
+     * @return Windowed jitter
+     */
+    double calculateWindowedJitter(const QVector<double>& rttValues);
+
     /**
      * @brief Calculate consecutive jitter (difference between adjacent RTTs)
      *
@@ -42,14 +54,6 @@ public:
     double calculateConsecutiveJitter(const QVector<double>& rttValues);
 
 private:
-    /**
-     * @brief Calculate standard deviation
-     * @param values Input values
-     * @param mean Mean of the values
-     * @return Standard deviation
-     */
-    double calculateStdDev(const QVector<double>& values, double mean);
-
     /**
      * @brief Calculate average value
      * @param values Input values
@@ -22,10 +22,11 @@ LatencyCalculator::LatencyStats LatencyCalculator::calculateStats(const QVector<
     stats.max = calculateMax(rttValues);
     stats.avg = calculateAverage(rttValues);
 
-    // Create sorted copy for median calculation
-    QVector<double> sorted = rttValues;
-    std::sort(sorted.begin(), sorted.end());
-    stats.median = calculateMedian(sorted);
+    // Order statistics by selection on one scratch copy instead of a full sort
+    QVector<double> scratch = rttValues;
+    stats.median = calculateMedian(scratch);
+    stats.p95 = calculatePercentile(scratch, 95.0);
+    stats.p99 = calculatePercentile(scratch, 99.0);
 
     stats.stdDev = calculateStdDev(rttValues, stats.avg);
 
@@ -72,19 +73,37 @@ double LatencyCalculator::calculateAverage(const QVector<double>& values) {
     return sum / values.size();
 }
 
-double LatencyCalculator::calculateMedian(const QVector<double>& sorted) {
-    if (sorted.isEmpty()) {
+double LatencyCalculator::calculateMedian(QVector<double>& values) {
+    if (values.isEmpty()) {
         return 0.0;
     }
 
-    int size = sorted.size();
+    int size = values.size();
+    auto middle = values.begin() + size / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    double upper = *middle;
+
     if (size % 2 == 0) {
-        // Even number of elements: average of two middle values
-        return (sorted[size / 2 - 1] + sorted[size / 2]) / 2.0;
+        // Even number of elements: average of two middle values; the lower
+        // one is the largest of the partition left of the middle
+        double lower = *std::max_element(values.begin(), middle);
+        return (lower + upper) / 2.0;
     } else {
         // Odd number of elements: middle value
-        return sorted[size / 2];
+        return upper;
+    }
+}
+
+double LatencyCalculator::calculatePercentile(QVector<double>& values, double percentile) {
+    if (values.isEmpty()) {
+        return 0.0;
     }
+
+    int rank = static_cast<int>(std::ceil(percentile / 100.0 * values.size()));
+    int index = qBound(0, rank - 1, static_cast<int>(values.size()) - 1);
+    auto nth = values.begin() + index;
+    std::nth_element(values.begin(), nth, values.end());
+    return *nth;
 }
 
 double LatencyCalculator::calculateStdDev(const QVector<double>& values, double mean) {
@@ -21,9 +21,12 @@ public:
         double avg;      ///< Average latency (ms)
         double median;   ///< Median latency (ms)
         double stdDev;   ///< Standard deviation (ms)
+        double p95;      ///< 95th percentile latency (ms)
+        double p99;      ///< 99th percentile latency (ms)
 
         LatencyStats()
-            : min(0.0), max(0.0), avg(0.0), median(0.0), stdDev(0.0) {}
+            : min(0.0), max(0.0), avg(0.0), median(0.0), stdDev(0.0)
+            , p95(0.0), p99(0.0) {}
     };
 
     LatencyCalculator() = default;
@@ -73,10 +76,18 @@ private:
 
     /**
      * @brief Calculate median value
-     * @param sorted Sorted input values
+     * @param values Input values, partially reordered in place
      * @return Median value
      */
-    double calculateMedian(const QVector<double>& sorted);
+    double calculateMedian(QVector<double>& values);
+
+    /**
+     * @brief Calculate a nearest-rank percentile
+     * @param values Input values, partially reordered in place
+     * @param percentile Percentile in [0, 100]
+     * @return Percentile value
+     */
+    double calculatePercentile(QVector<double>& values, double percentile);
 
     /**
      * @brief Calculate standard deviation
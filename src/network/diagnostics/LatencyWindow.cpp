@@ -0,0 +1,139 @@
+#include "LatencyWindow.h"
+#include <cmath>
+
+LatencyWindow::LatencyWindow()
+    : m_sortedCount(0)
+    , m_p95(0.95)
+    , m_p99(0.99)
+{
+}
+
+void LatencyWindow::add(const PingService::PingResult& result) {
+    // Same rule as MetricsAggregator::extractRttValues()
+    double rtt = (result.success && result.latency > 0.0) ? result.latency : LOST;
+
+    double evicted = LOST;
+    if (m_samples.push(rtt, &evicted) && evicted != LOST) {
+        m_stats.remove(evicted);
+        removeSorted(evicted);
+    }
+
+    if (rtt == LOST) {
+        m_range.skip();
+        return;
+    }
+
+    m_stats.add(rtt);
+    m_range.push(rtt);
+    insertSorted(rtt);
+    m_p95.add(rtt);
+    m_p99.add(rtt);
+    m_jitter.add(rtt);
+}
+
+void LatencyWindow::clear() {
+    m_samples.clear();
+    m_stats.clear();
+    m_range.clear();
+    m_sortedCount = 0;
+    m_p95.clear();
+    m_p99.clear();
+    m_jitter.clear();
+}
+
+int LatencyWindow::count() const {
+    return m_samples.size();
+}
+
+int LatencyWindow::replies() const {
+    return m_sortedCount;
+}
+
+double LatencyWindow::packetLoss() const {
+    if (m_samples.isEmpty()) {
+        return 0.0;
+    }
+    return (m_samples.size() - m_sortedCount) * 100.0 / m_samples.size();
+}
+
+double LatencyWindow::min() const {
+    return m_range.min();
+}
+
+double LatencyWindow::max() const {
+    return m_range.max();
+}
+
+double LatencyWindow::mean() const {
+    return m_stats.mean();
+}
+
+double LatencyWindow::median() const {
+    if (m_sortedCount == 0) {
+        return 0.0;
+    }
+    int middle = m_sortedCount / 2;
+    if (m_sortedCount % 2 == 0) {
+        return (m_sorted[middle - 1] + m_sorted[middle]) / 2.0;
+    }
+    return m_sorted[middle];
+}
+
+double LatencyWindow::stdDev() const {
+    return m_stats.stdDev();
+}
+
+double LatencyWindow::p95() const {
+    return percentile(95.0);
+}
+
+double LatencyWindow::p99() const {
+    return percentile(99.0);
+}
+
+double LatencyWindow::lifetimeP95() const {
+    return m_p95.value();
+}
+
+double LatencyWindow::lifetimeP99() const {
+    return m_p99.value();
+}
+
+double LatencyWindow::jitter() const {
+    return m_jitter.smoothed();
+}
+
+double LatencyWindow::windowedJitter() const {
+    return m_jitter.windowed();
+}
+
+void LatencyWindow::insertSorted(double rtt) {
+    int i = m_sortedCount;
+    while (i > 0 && m_sorted[i - 1] > rtt) {
+        m_sorted[i] = m_sorted[i - 1];
+        --i;
+    }
+    m_sorted[i] = rtt;
+    ++m_sortedCount;
+}
+
+void LatencyWindow::removeSorted(double rtt) {
+    for (int i = 0; i < m_sortedCount; ++i) {
+        if (m_sorted[i] == rtt) {
+            for (int j = i; j < m_sortedCount - 1; ++j) {
+                m_sorted[j] = m_sorted[j + 1];
+            }
+            --m_sortedCount;
+            return;
+        }
+    }
+}
+
+double LatencyWindow::percentile(double percentile) const {
+    if (m_sortedCount == 0) {
+        return 0.0;
+    }
+    // Same rule as LatencyCalculator::calculatePercentile()
+    int rank = static_cast<int>(std::ceil(percentile / 100.0 * m_sortedCount));
+    return m_sorted[qBound(0, rank - 1, m_sortedCount - 1)];
+}
@@ -0,0 +1,83 @@
+#ifndef LATENCYWINDOW_H
+#define LATENCYWINDOW_H
+
+#include "PingService.h"
+#include "../../utils/StreamingStatistics.h"
+
+/**
+ * @brief Streaming latency state of one monitored target
+ *
+ * Holds the last SIZE probe results and keeps their statistics current as
+ * each result arrives: loss, mean and standard deviation (Welford, with
+ * the evicted sample removed), min/max (monotonic deques) and the exact
+ * median and p95/p99 (a small sorted copy of the window). lifetimeP95/P99
+ * are P² estimates and jitter() the RFC 3550 interarrival jitter, all over
+ * every reply since the last clear(), not just the window.
+ *
+ * add() is O(SIZE) at worst for the median and otherwise O(1); nothing
+ * allocates, so one instance per target costs a fixed few hundred bytes.
+ */
+class LatencyWindow
+{
+public:
+    static constexpr int SIZE = 10;
+
+    LatencyWindow();
+
+    void add(const PingService::PingResult& result);
+    void clear();
+
+    int count() const;          ///< Results in the window
+    int replies() const;        ///< Answered probes in the window
+
+    /**
+     * @brief Lost probes in the window, in percent
+     */
+    double packetLoss() const;
+
+    double min() const;
+    double max() const;
+    double mean() const;
+    double median() const;
+    double stdDev() const;
+
+    /**
+     * @brief Nearest-rank percentiles of the replies in the window
+     */
+    double p95() const;
+    double p99() const;
+
+    /**
+     * @brief P² estimates over every reply since the last clear()
+     */
+    double lifetimeP95() const;
+    double lifetimeP99() const;
+
+    /**
+     * @brief RFC 3550 interarrival jitter of the replies
+     */
+    double jitter() const;
+
+    /**
+     * @brief Mean RTT difference of the last InterarrivalJitter::WINDOW reply pairs
+     */
+    double windowedJitter() const;
+
+private:
+    static constexpr double LOST = -1.0;    ///< Window entry of an unanswered probe
+
+    RingBuffer<double, SIZE> m_samples;
+    RunningStats m_stats;
+    WindowedMinMax<SIZE> m_range;
+    double m_sorted[SIZE];
+    int m_sortedCount;
+    P2Quantile m_p95;
+    P2Quantile m_p99;
+    InterarrivalJitter m_jitter;
+
+    void insertSorted(double rtt);
+    void removeSorted(double rtt);
+    double percentile(double percentile) const;
+};
+
+#endif // LATENCYWINDOW_H
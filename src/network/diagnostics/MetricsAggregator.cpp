@@ -1,8 +1,10 @@
 #include "MetricsAggregator.h"
 #include "QualityScoreCalculator.h"
 #include "LatencyCalculator.h"
+#include "JitterCalculator.h"
 #include "../../utils/Logger.h"
 #include <QDateTime>
+#include <QMetaMethod>
 
 MetricsAggregator::MetricsAggregator(
     IMetricsCalculator* latencyCalc,
@@ -16,8 +18,8 @@ MetricsAggregator::MetricsAggregator(
     , packetLossCalculator(packetLossCalc)
     , qualityCalculator(qualityCalc)
     , pingService(new PingService(this))
+    , m_historyStart(0)
     , m_isCollecting(false)
-    , maxHistorySize(1000)
 {
     connect(pingService, &PingService::pingResult,
             this, &MetricsAggregator::onPingResult);
@@ -51,7 +53,7 @@ NetworkMetrics MetricsAggregator::aggregate(const QVector<PingService::PingResul
 
     if (rttValues.isEmpty()) {
         // All pings failed - set 100% packet loss, no latency/jitter data
-        Logger::warn("MetricsAggregator: No successful pings in results (100% packet loss)");
+        Logger::debug("MetricsAggregator: No successful pings in results (100% packet loss)");
         metrics.setLatencyMin(0.0);
         metrics.setLatencyAvg(0.0);
         metrics.setLatencyMax(0.0);
@@ -64,16 +66,58 @@ NetworkMetrics MetricsAggregator::aggregate(const QVector<PingService::PingResul
     // Calculate latency metrics (only if we have successful pings)
     calculateLatencyMetrics(results, metrics);
 
-    // Calculate jitter
+    // Calculate jitter (RFC 3550 over the replies in order)
     double jitter = jitterCalculator->calculate(rttValues);
     metrics.setJitter(jitter);
 
+    JitterCalculator* jitCalc = dynamic_cast<JitterCalculator*>(jitterCalculator);
+    if (jitCalc) {
+        metrics.setJitterWindowed(jitCalc->calculateWindowedJitter(rttValues));
+    }
+
     // Calculate quality score
     metrics.calculateQualityScore();
 
     return metrics;
 }
 
+NetworkMetrics MetricsAggregator::aggregate(const LatencyWindow& window) {
+    NetworkMetrics metrics;
+    metrics.setTimestamp(QDateTime::currentDateTime());
+
+    if (window.count() == 0) {
+        return metrics;
+    }
+
+    metrics.setPacketLoss(window.packetLoss());
+
+    if (window.replies() == 0) {
+        // All probes in the window lost: no latency/jitter data
+        metrics.setLatencyMin(0.0);
+        metrics.setLatencyAvg(0.0);
+        metrics.setLatencyMax(0.0);
+        metrics.setLatencyMedian(0.0);
+        metrics.setJitter(0.0);
+        metrics.calculateQualityScore();
+        return metrics;
+    }
+
+    metrics.setLatencyMin(window.min());
+    metrics.setLatencyAvg(window.mean());
+    metrics.setLatencyMax(window.max());
+    metrics.setLatencyMedian(window.median());
+    metrics.setLatencyP95(window.p95());
+    metrics.setLatencyP99(window.p99());
+
+    // RFC 3550 interarrival jitter, kept current by the window per reply
+    metrics.setJitter(window.jitter());
+    metrics.setJitterWindowed(window.windowedJitter());
+
+    metrics.calculateQualityScore();
+
+    return metrics;
+}
+
 void MetricsAggregator::startContinuousCollection(const QString& host, int interval) {
     if (m_isCollecting) {
         Logger::warn("MetricsAggregator: Already collecting metrics");
@@ -82,8 +126,10 @@ void MetricsAggregator::startContinuousCollection(const QString& host, int inter
 
     m_currentHost = host;
     m_isCollecting = true;
-    resultHistory.clear();
+    m_window.clear();
     metricsHistory.clear();
+    metricsHistory.reserve(MAX_HISTORY_SIZE);
+    m_historyStart = 0;
 
     pingService->continuousPing(host, interval);
 
@@ -110,20 +156,10 @@ QString MetricsAggregator::currentHost() const {
 }
 
 void MetricsAggregator::onPingResult(const PingService::PingResult& result) {
-    // Add to rolling history
-    resultHistory.append(result);
-
-    // Limit history size
-    if (resultHistory.size() > maxHistorySize) {
-        resultHistory.removeFirst();
-    }
-
-    // Calculate metrics from recent history (e.g., last 10 pings)
-    int recentCount = std::min(10, static_cast<int>(resultHistory.size()));
-    QVector<PingService::PingResult> recentResults =
-        resultHistory.mid(resultHistory.size() - recentCount);
+    // The window keeps the last LatencyWindow::SIZE results and their statistics
+    m_window.add(result);
 
-    NetworkMetrics metrics = aggregate(recentResults);
+    NetworkMetrics metrics = aggregate(m_window);
     addToHistory(metrics);
 
     emit metricsUpdated(metrics);
@@ -180,6 +216,8 @@ void MetricsAggregator::calculateLatencyMetrics(
         metrics.setLatencyAvg(stats.avg);
         metrics.setLatencyMax(stats.max);
         metrics.setLatencyMedian(stats.median);
+        metrics.setLatencyP95(stats.p95);
+        metrics.setLatencyP99(stats.p99);
     } else {
         Logger::warn("MetricsAggregator: LatencyCalculator cast failed, using fallback");
         // Fallback: just set average
@@ -189,12 +227,25 @@ void MetricsAggregator::calculateLatencyMetrics(
 }
 
 void MetricsAggregator::addToHistory(const NetworkMetrics& metrics) {
-    metricsHistory.append(metrics);
+    // Overwrites the oldest entry once full
+    if (metricsHistory.size() < MAX_HISTORY_SIZE) {
+        metricsHistory.append(metrics);
+    } else {
+        metricsHistory[m_historyStart] = metrics;
+        m_historyStart = (m_historyStart + 1) % MAX_HISTORY_SIZE;
+    }
 
-    // Limit history size
-    if (metricsHistory.size() > maxHistorySize) {
-        metricsHistory.removeFirst();
+    // Copying the history out is the only O(n) step; skip it when nobody listens
+    static const QMetaMethod historySignal =
+        QMetaMethod::fromSignal(&MetricsAggregator::metricsHistoryUpdated);
+    if (!isSignalConnected(historySignal)) {
+        return;
     }
 
-    emit metricsHistoryUpdated(metricsHistory);
+    QVector<NetworkMetrics> history;
+    history.reserve(metricsHistory.size());
+    for (int i = 0; i < metricsHistory.size(); ++i) {
+        history.append(metricsHistory.at((m_historyStart + i) % metricsHistory.size()));
+    }
+    emit metricsHistoryUpdated(history);
 }
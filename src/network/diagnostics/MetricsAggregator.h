@@ -5,6 +5,7 @@
 #include <QVector>
 #include <QTimer>
 #include "PingService.h"
+#include "LatencyWindow.h"
 #include "../../models/NetworkMetrics.h"
 #include "../../interfaces/IMetricsCalculator.h"
 
@@ -47,6 +48,15 @@ public:
      */
     NetworkMetrics aggregate(const QVector<PingService::PingResult>& results);
 
+    /**
+     * @brief Read metrics off a streaming window
+     *
+     * Constant time: the window already keeps its statistics current.
+     * @param window Recent results of one target
+     * @return Aggregated NetworkMetrics
+     */
+    NetworkMetrics aggregate(const LatencyWindow& window);
+
     /**
      * @brief Start continuous metric collection
      * @param host Target host to monitor
@@ -106,11 +116,13 @@ private:
     PingService* pingService;
 
     // State
+    static constexpr int MAX_HISTORY_SIZE = 1000;
+
     QString m_currentHost;
-    QVector<PingService::PingResult> resultHistory;
-    QVector<NetworkMetrics> metricsHistory;
+    LatencyWindow m_window;
+    QVector<NetworkMetrics> metricsHistory;  // Reserved on start; a ring once full
+    int m_historyStart;                      // Oldest entry once full
     bool m_isCollecting;
-    int maxHistorySize;
 
     /**
      * @brief Extract RTT values from ping results
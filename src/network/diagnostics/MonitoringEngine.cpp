@@ -0,0 +1,317 @@
+#include "MonitoringEngine.h"
+#include "MetricsAggregator.h"
+#include "ProbeScheduler.h"
+#include "../sockets/IcmpEchoEngine.h"
+#include "../../utils/Logger.h"
+#include <QHostAddress>
+#include <QMutexLocker>
+
+MonitoringEngine::MonitoringEngine(MetricsAggregator* aggregator,
+                                   IcmpEchoEngine* echoEngine,
+                                   ProbeScheduler* scheduler,
+                                   QObject* parent)
+    : QObject(parent)
+    , m_aggregator(aggregator)
+    , m_echo(echoEngine ? echoEngine : IcmpEchoEngine::instance())
+    , m_scheduler(scheduler ? scheduler : ProbeScheduler::instance())
+    , m_sendPool(new QThreadPool(this))
+    , m_fallbackPool(new QThreadPool(this))
+    , m_outstanding(0)
+    , m_lastGeneration(0)
+    , m_shuttingDown(0)
+{
+    m_sendPool->setMaxThreadCount(1);
+    m_fallbackPool->setMaxThreadCount(FALLBACK_THREADS);
+}
+
+MonitoringEngine::~MonitoringEngine() {
+    m_shuttingDown.storeRelease(1);
+    removeAllTargets();
+
+    // No sends after this, then no callbacks after cancel() returns
+    m_sendPool->waitForDone();
+    m_echo->cancel(this);
+    m_fallbackPool->waitForDone();
+}
+
+bool MonitoringEngine::addTarget(const QString& deviceId, int intervalMs) {
+    quint32 address = 0;
+    if (!parseAddress(deviceId, address)) {
+        Logger::warn("MonitoringEngine: Not an IPv4 address: " + deviceId);
+        emit errorOccurred(deviceId, "Monitoring needs an IPv4 address");
+        return false;
+    }
+
+    if (m_targets.contains(address)) {
+        return false;
+    }
+
+    Target& target = m_targets[address];
+    target.deviceId = deviceId;
+    target.address = address;
+    target.intervalMs = qMax(MIN_INTERVAL_MS, intervalMs);
+    target.generation = ++m_lastGeneration;
+    target.task = m_scheduler->add(this, target.intervalMs, [this, address]() {
+        onDue(address);
+    });
+
+    Logger::debug(QString("MonitoringEngine: Monitoring %1 every %2ms (%3 targets)")
+                 .arg(deviceId).arg(target.intervalMs).arg(m_targets.size()));
+    return true;
+}
+
+void MonitoringEngine::removeTarget(const QString& deviceId) {
+    quint32 address = 0;
+    if (!parseAddress(deviceId, address)) {
+        return;
+    }
+
+    auto target = m_targets.find(address);
+    if (target != m_targets.end()) {
+        m_scheduler->remove(target->task);
+        m_targets.erase(target);
+    }
+}
+
+void MonitoringEngine::removeAllTargets() {
+    for (const Target& target : m_targets) {
+        m_scheduler->remove(target.task);
+    }
+    m_targets.clear();
+}
+
+bool MonitoringEngine::probeOnce(const QString& deviceId) {
+    quint32 address = 0;
+    if (!parseAddress(deviceId, address)) {
+        Logger::warn("MonitoringEngine: Not an IPv4 address: " + deviceId);
+        return false;
+    }
+
+    auto target = m_targets.find(address);
+    if (target != m_targets.end()) {
+        m_scheduler->runSoon(target->task);
+        return true;
+    }
+
+    if (m_oneShots.contains(address)) {
+        return true;  // Already on its way
+    }
+
+    OneShot& shot = m_oneShots[address];
+    shot.deviceId = deviceId;
+    shot.outstanding = ONE_SHOT_PROBES;
+
+    QVector<Probe> probes(ONE_SHOT_PROBES, Probe{address, MAX_TIMEOUT_MS, true, 0});
+    m_outstanding += probes.size();
+    dispatch(probes);
+    return true;
+}
+
+bool MonitoringEngine::hasTarget(const QString& deviceId) const {
+    quint32 address = 0;
+    return parseAddress(deviceId, address) && m_targets.contains(address);
+}
+
+int MonitoringEngine::targetCount() const {
+    return m_targets.size();
+}
+
+QStringList MonitoringEngine::targets() const {
+    QStringList ids;
+    ids.reserve(m_targets.size());
+    for (const Target& target : m_targets) {
+        ids.append(target.deviceId);
+    }
+    return ids;
+}
+
+int MonitoringEngine::intervalMs(const QString& deviceId) const {
+    quint32 address = 0;
+    if (!parseAddress(deviceId, address)) {
+        return 0;
+    }
+    auto target = m_targets.constFind(address);
+    return target != m_targets.constEnd() ? target->intervalMs : 0;
+}
+
+NetworkMetrics MonitoringEngine::latestMetrics(const QString& deviceId) const {
+    quint32 address = 0;
+    if (!parseAddress(deviceId, address)) {
+        return NetworkMetrics();
+    }
+    auto target = m_targets.constFind(address);
+    return target != m_targets.constEnd() ? target->latest : NetworkMetrics();
+}
+
+LatencyHistogram MonitoringEngine::latencyHistogram(const QString& deviceId) const {
+    quint32 address = 0;
+    if (!parseAddress(deviceId, address)) {
+        return LatencyHistogram();
+    }
+    auto target = m_targets.constFind(address);
+    return target != m_targets.constEnd() ? target->histogram : LatencyHistogram();
+}
+
+LatencyHistogram MonitoringEngine::takeLatencyHistogram(const QString& deviceId) {
+    quint32 address = 0;
+    if (!parseAddress(deviceId, address)) {
+        return LatencyHistogram();
+    }
+    auto target = m_targets.find(address);
+    if (target == m_targets.end()) {
+        return LatencyHistogram();
+    }
+
+    LatencyHistogram taken = target->untaken;
+    target->untaken.clear();
+    return taken;
+}
+
+int MonitoringEngine::outstandingProbes() const {
+    return m_outstanding;
+}
+
+void MonitoringEngine::onDue(quint32 address) {
+    auto target = m_targets.constFind(address);
+    if (target == m_targets.constEnd()) {
+        return;
+    }
+
+    // Everything due in this scheduler tick goes out as one batch
+    if (m_due.isEmpty()) {
+        QMetaObject::invokeMethod(this, &MonitoringEngine::flushDue, Qt::QueuedConnection);
+    }
+    m_due.append(Probe{address, qMin(target->intervalMs, MAX_TIMEOUT_MS), false, target->generation});
+}
+
+void MonitoringEngine::flushDue() {
+    QVector<Probe> probes;
+    probes.swap(m_due);
+
+    // Ping processes are slow; never queue more than the fallback pool can work off
+    if (!m_echo->isAvailable()) {
+        int room = qMax(0, FALLBACK_THREADS * 4 - m_outstanding);
+        if (probes.size() > room) {
+            probes.resize(room);
+        }
+    }
+
+    if (!probes.isEmpty()) {
+        m_outstanding += probes.size();
+        dispatch(probes);
+    }
+}
+
+void MonitoringEngine::dispatch(const QVector<Probe>& probes) {
+    if (m_echo->isAvailable()) {
+        // Unpaced: fixed-interval probes stay out of the scans' rate control.
+        // send() can still wait briefly on a full socket queue, so it runs off this thread
+        m_sendPool->start([this, probes]() {
+            for (const Probe& probe : probes) {
+                if (m_shuttingDown.loadAcquire()) {
+                    return;
+                }
+
+                bool oneShot = probe.oneShot;
+                int generation = probe.generation;
+                m_echo->submit(probe.address, probe.timeoutMs,
+                    [this, oneShot, generation](const IcmpEchoEngine::EchoResult& echo) {
+                        PingService::PingResult result;
+                        result.success = echo.success;
+                        result.latency = echo.latency;
+                        result.ttl = echo.ttl;
+                        result.bytes = echo.bytes;
+                        if (!echo.success) {
+                            result.errorMessage = "No response";
+                        }
+
+                        queueReply(Reply{echo.address, oneShot, generation, result});
+                    }, this, IcmpEchoEngine::Unpaced);
+            }
+        });
+        return;
+    }
+
+    for (const Probe& probe : probes) {
+        m_fallbackPool->start([this, probe]() {
+            PingService::PingResult result;
+            if (!m_shuttingDown.loadAcquire()) {
+                PingService service;
+                result = service.pingSync(QHostAddress(probe.address).toString(), probe.timeoutMs);
+            }
+
+            queueReply(Reply{probe.address, probe.oneShot, probe.generation, result});
+        });
+    }
+}
+
+void MonitoringEngine::queueReply(const Reply& reply) {
+    QMutexLocker locker(&m_replyMutex);
+    m_replies.append(reply);
+
+    // The first reply of a batch schedules one collect() for all that follow
+    if (m_replies.size() == 1) {
+        QMetaObject::invokeMethod(this, &MonitoringEngine::collect, Qt::QueuedConnection);
+    }
+}
+
+void MonitoringEngine::collect() {
+    QVector<Reply> replies;
+    {
+        QMutexLocker locker(&m_replyMutex);
+        replies.swap(m_replies);
+    }
+
+    for (const Reply& reply : replies) {
+        m_outstanding = qMax(0, m_outstanding - 1);
+
+        if (reply.oneShot) {
+            auto shot = m_oneShots.find(reply.address);
+            if (shot != m_oneShots.end()) {
+                PingService::PingResult result = reply.result;
+                result.host = shot->deviceId;
+                shot->results.append(result);
+                if (--shot->outstanding == 0) {
+                    finishOneShot(reply.address);
+                }
+            }
+            continue;
+        }
+
+        // Removed while the probe was in flight, possibly re-added since
+        auto target = m_targets.find(reply.address);
+        if (target == m_targets.end() || target->generation != reply.generation) {
+            continue;
+        }
+
+        target->window.add(reply.result);
+        if (reply.result.success && reply.result.latency > 0.0) {
+            target->histogram.record(reply.result.latency);
+            target->untaken.record(reply.result.latency);
+        }
+        if (!m_aggregator) {
+            continue;
+        }
+        target->latest = m_aggregator->aggregate(target->window);
+
+        // Receivers may add or remove targets; nothing below touches the iterator
+        QString deviceId = target->deviceId;
+        NetworkMetrics metrics = target->latest;
+        emit metricsUpdated(deviceId, metrics);
+    }
+}
+
+void MonitoringEngine::finishOneShot(quint32 address) {
+    OneShot shot = m_oneShots.take(address);
+    if (!m_aggregator) {
+        return;
+    }
+    NetworkMetrics metrics = m_aggregator->aggregate(shot.results);
+    emit metricsUpdated(shot.deviceId, metrics);
+}
+
+bool MonitoringEngine::parseAddress(const QString& deviceId, quint32& address) {
+    bool isIpv4 = false;
+    address = QHostAddress(deviceId).toIPv4Address(&isIpv4);
+    return isIpv4;
+}
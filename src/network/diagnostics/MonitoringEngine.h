@@ -0,0 +1,187 @@
+#ifndef MONITORINGENGINE_H
+#define MONITORINGENGINE_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QThreadPool>
+#include <QStringList>
+#include "PingService.h"
+#include "LatencyWindow.h"
+#include "../../models/NetworkMetrics.h"
+#include "../../utils/LatencyHistogram.h"
+
+class MetricsAggregator;
+class IcmpEchoEngine;
+class ProbeScheduler;
+
+/**
+ * @brief Continuous latency monitoring of many targets at once
+ *
+ * Every monitored device is a target with its own interval, window of
+ * recent results and latest metrics. Targets are periodic tasks on the
+ * shared ProbeScheduler, which spreads them across their interval; the
+ * requests that fall due in one scheduler tick are sent as a batch through
+ * IcmpEchoEngine (one socket for all targets, replies matched by sequence
+ * number). Replies are queued by the receiver thread and folded into the
+ * per-target windows in one pass on the engine's thread.
+ * Each window is a LatencyWindow that keeps its statistics current per
+ * result, so MetricsAggregator::aggregate() reads the metrics off it in
+ * constant time before they are reported per device.
+ *
+ * Requests are sent from a single pool thread, so the shared probe rate
+ * limit never blocks the caller's thread. When no ICMP socket can be
+ * opened, probes fall back to PingService::pingSync() on a small pool.
+ *
+ * Every reply is also recorded in the target's LatencyHistogram, which
+ * keeps the full distribution since the target was added.
+ *
+ * Memory per target is fixed (window and histograms); work is
+ * proportional to the probes due and the replies received. IPv4 targets
+ * only.
+ */
+class MonitoringEngine : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int WINDOW_SIZE = LatencyWindow::SIZE;   ///< Results per metrics window
+    static constexpr int MAX_TIMEOUT_MS = 1000;     ///< Reply deadline (or the interval, if shorter)
+    static constexpr int MIN_INTERVAL_MS = 100;
+    static constexpr int ONE_SHOT_PROBES = 4;       ///< Echo requests behind probeOnce()
+    static constexpr int FALLBACK_THREADS = 16;     ///< Concurrent ping processes without a socket
+
+    /**
+     * @param aggregator Computes metrics from result windows (not owned); without one nothing is reported
+     * @param echoEngine Probe socket, nullptr for the shared IcmpEchoEngine (not owned)
+     * @param scheduler Probe clock, nullptr for the shared ProbeScheduler (not owned)
+     */
+    explicit MonitoringEngine(MetricsAggregator* aggregator,
+                              IcmpEchoEngine* echoEngine = nullptr,
+                              ProbeScheduler* scheduler = nullptr,
+                              QObject* parent = nullptr);
+    ~MonitoringEngine() override;
+
+    /**
+     * @brief Start probing a device every @p intervalMs
+     *
+     * The first probe goes out within one interval, at the target's phase.
+     * @param deviceId IPv4 address of the device
+     * @return False if @p deviceId is not an IPv4 address or is already monitored
+     */
+    bool addTarget(const QString& deviceId, int intervalMs = 1000);
+
+    /**
+     * @brief Stop probing a device; replies still in flight are dropped
+     */
+    void removeTarget(const QString& deviceId);
+    void removeAllTargets();
+
+    /**
+     * @brief Send ONE_SHOT_PROBES requests and report their metrics once
+     *
+     * For a monitored device the next probe is simply sent on the next
+     * scheduler tick.
+     * @return False if @p deviceId is not an IPv4 address
+     */
+    bool probeOnce(const QString& deviceId);
+
+    bool hasTarget(const QString& deviceId) const;
+    int targetCount() const;
+    QStringList targets() const;
+    int intervalMs(const QString& deviceId) const;
+
+    /**
+     * @brief Metrics of the device's last window (default-constructed if none yet)
+     */
+    NetworkMetrics latestMetrics(const QString& deviceId) const;
+
+    /**
+     * @brief Latency distribution of every reply since the device was added
+     */
+    LatencyHistogram latencyHistogram(const QString& deviceId) const;
+
+    /**
+     * @brief Latency distribution of the replies since the previous call, which is reset
+     *
+     * Consecutive calls partition the replies, so the results can be stored
+     * per interval and merged again for any time range.
+     */
+    LatencyHistogram takeLatencyHistogram(const QString& deviceId);
+
+    /**
+     * @brief Echo requests sent and not yet answered or expired
+     */
+    int outstandingProbes() const;
+
+signals:
+    /**
+     * @brief Emitted for every reply or timeout of a monitored device, and once per probeOnce()
+     */
+    void metricsUpdated(const QString& deviceId, const NetworkMetrics& metrics);
+
+    void errorOccurred(const QString& deviceId, const QString& error);
+
+private:
+    struct Target {
+        QString deviceId;
+        quint32 address;
+        int intervalMs;
+        int task;                   ///< ProbeScheduler task id
+        int generation;             ///< Tags this session's probes; a re-added target gets a new one
+        LatencyWindow window;
+        LatencyHistogram histogram;     ///< Replies since addTarget()
+        LatencyHistogram untaken;       ///< Replies since takeLatencyHistogram()
+        NetworkMetrics latest;
+
+        Target() : address(0), intervalMs(0), task(0), generation(0) {}
+    };
+
+    struct OneShot {
+        QString deviceId;
+        QVector<PingService::PingResult> results;
+        int outstanding;
+
+        OneShot() : outstanding(0) {}
+    };
+
+    struct Reply {
+        quint32 address;
+        bool oneShot;
+        int generation;
+        PingService::PingResult result;
+    };
+
+    struct Probe {
+        quint32 address;
+        int timeoutMs;
+        bool oneShot;
+        int generation;             ///< Target generation at send time, 0 for one-shots
+    };
+
+    MetricsAggregator* m_aggregator;
+    IcmpEchoEngine* m_echo;
+    ProbeScheduler* m_scheduler;
+    QThreadPool* m_sendPool;        ///< One thread: sends stay ordered, caller never blocks
+    QThreadPool* m_fallbackPool;
+
+    QHash<quint32, Target> m_targets;
+    QHash<quint32, OneShot> m_oneShots;
+    QVector<Probe> m_due;           ///< Fell due this tick, sent by flushDue()
+    int m_outstanding;
+    int m_lastGeneration;
+
+    QMutex m_replyMutex;
+    QVector<Reply> m_replies;       ///< Filled on the receiver thread, drained by collect()
+    QAtomicInt m_shuttingDown;
+
+    void onDue(quint32 address);
+    void flushDue();
+    void dispatch(const QVector<Probe>& probes);
+    void queueReply(const Reply& reply);
+    void collect();
+    void finishOneShot(quint32 address);
+    static bool parseAddress(const QString& deviceId, quint32& address);
+};
+
+#endif // MONITORINGENGINE_H
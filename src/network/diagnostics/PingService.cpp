@@ -1,25 +1,37 @@
 #include "PingService.h"
+#include "ProbeScheduler.h"
+#include "../sockets/IcmpEchoEngine.h"
 #include "../../utils/Logger.h"
 #include <QRegularExpression>
 #include <QStringList>
+#include <QHostAddress>
+
+namespace {
+const int ENGINE_REPLY_TIMEOUT_MS = 2000;
+const int ENGINE_ECHO_INTERVAL_MS = 1000;  // Same spacing as ping -c N
+}
 
 PingService::PingService(QObject* parent)
     : QObject(parent)
     , pingProcess(new QProcess(this))
-    , continuousTimer(new QTimer(this))
+    , continuousTask(0)
+    , continuousInterval(0)
     , currentCount(0)
     , isContinuous(false)
+    , engineOutstanding(0)
+    , pacingTask(0)
+    , echoesToSend(0)
+    , pingGeneration(0)
 {
     connect(pingProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
             this, &PingService::onProcessFinished);
     connect(pingProcess, &QProcess::errorOccurred,
             this, &PingService::onProcessError);
-    connect(continuousTimer, &QTimer::timeout,
-            this, &PingService::onContinuousPingTimeout);
 }
 
 PingService::~PingService() {
     stopContinuousPing();
+    cancelEngineEchoes();
     if (pingProcess->state() == QProcess::Running) {
         pingProcess->kill();
         pingProcess->waitForFinished();
@@ -27,7 +39,7 @@ PingService::~PingService() {
 }
 
 void PingService::ping(const QString& host, int count) {
-    if (pingProcess->state() == QProcess::Running) {
+    if (pingProcess->state() == QProcess::Running || engineOutstanding > 0) {
         Logger::warn("PingService: Ping already in progress");
         return;
     }
@@ -37,6 +49,12 @@ void PingService::ping(const QString& host, int count) {
     currentResults.clear();
     isContinuous = false;
 
+    quint32 address = 0;
+    if (engineAddress(host, address)) {
+        pingWithEngine(address, count, ENGINE_REPLY_TIMEOUT_MS);
+        return;
+    }
+
     QStringList args = buildPingCommand(host, count);
     QString program = args.takeFirst();
 
@@ -46,6 +64,22 @@ void PingService::ping(const QString& host, int count) {
 }
 
 PingService::PingResult PingService::pingSync(const QString& host, int timeout) {
+    quint32 address = 0;
+    if (engineAddress(host, address)) {
+        IcmpEchoEngine::EchoResult reply = IcmpEchoEngine::instance()->echo(address, timeout);
+
+        PingResult result;
+        result.host = host;
+        result.success = reply.success;
+        result.latency = reply.latency;
+        result.ttl = reply.ttl;
+        result.bytes = reply.bytes;
+        if (!reply.success) {
+            result.errorMessage = "Request timed out";
+        }
+        return result;
+    }
+
     QProcess process;
     QStringList args = buildPingCommand(host, 1);
     QString program = args.takeFirst();
@@ -75,9 +109,16 @@ PingService::PingResult PingService::pingSync(const QString& host, int timeout)
 }
 
 void PingService::continuousPing(const QString& host, int interval) {
+    if (continuousTask != 0) {
+        ProbeScheduler::instance()->remove(continuousTask);
+    }
+
     currentHost = host;
     isContinuous = true;
-    continuousTimer->start(interval);
+    continuousInterval = interval;
+    continuousTask = ProbeScheduler::instance()->add(this, interval, [this]() {
+        onContinuousPingTimeout();
+    });
 
     // Send first ping immediately
     onContinuousPingTimeout();
@@ -87,15 +128,17 @@ void PingService::continuousPing(const QString& host, int interval) {
 }
 
 void PingService::stopContinuousPing() {
-    if (continuousTimer->isActive()) {
-        continuousTimer->stop();
+    if (continuousTask != 0) {
+        ProbeScheduler::instance()->remove(continuousTask);
+        continuousTask = 0;
         isContinuous = false;
+        cancelEngineEchoes();
         Logger::info("PingService: Stopped continuous ping");
     }
 }
 
 bool PingService::isContinuousPingActive() const {
-    return continuousTimer->isActive();
+    return continuousTask != 0;
 }
 
 void PingService::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
@@ -149,9 +192,98 @@ void PingService::onProcessError(QProcess::ProcessError error) {
 }
 
 void PingService::onContinuousPingTimeout() {
+    quint32 address = 0;
+    if (engineAddress(currentHost, address)) {
+        // One echo per tick; the engine needs no process startup, so no batching of samples
+        pingWithEngine(address, 1, qMin(continuousInterval, ENGINE_REPLY_TIMEOUT_MS));
+        return;
+    }
+
     ping(currentHost, 4);  // Collect 4 samples for balance between speed and statistical variance
 }
 
+bool PingService::engineAddress(const QString& host, quint32& address) const {
+    if (!IcmpEchoEngine::instance()->isAvailable()) {
+        return false;
+    }
+
+    bool isIpv4 = false;
+    address = QHostAddress(host).toIPv4Address(&isIpv4);
+    return isIpv4;
+}
+
+void PingService::pingWithEngine(quint32 address, int count, int timeout) {
+    // Counted up front so the run completes only once the last paced echo is answered
+    engineOutstanding += count;
+    sendEngineEcho(address, timeout);
+    if (count <= 1) {
+        return;
+    }
+
+    echoesToSend = count - 1;
+
+    pacingTask = ProbeScheduler::instance()->add(this, ENGINE_ECHO_INTERVAL_MS, [this, address, timeout]() {
+        sendEngineEcho(address, timeout);
+        if (--echoesToSend == 0) {
+            ProbeScheduler::instance()->remove(pacingTask);
+            pacingTask = 0;
+        }
+    });
+    // Next echo one interval after the first, not at the task's phase slot
+    ProbeScheduler::instance()->setInterval(pacingTask, ENGINE_ECHO_INTERVAL_MS);
+}
+
+void PingService::sendEngineEcho(quint32 address, int timeout) {
+    int generation = pingGeneration;
+
+    // Callback runs on the engine thread - hop back to ours before touching state.
+    // Unpaced: single-host pings must not wait behind, or slow down, a running scan
+    IcmpEchoEngine::instance()->submit(address, timeout,
+        [this, generation](const IcmpEchoEngine::EchoResult& reply) {
+            PingResult result;
+            result.success = reply.success;
+            result.latency = reply.latency;
+            result.ttl = reply.ttl;
+            result.bytes = reply.bytes;
+            if (!reply.success) {
+                result.errorMessage = "No response";
+            }
+            QMetaObject::invokeMethod(this, [this, generation, result]() {
+                if (generation == pingGeneration) {
+                    onEngineResult(result);
+                }
+            }, Qt::QueuedConnection);
+        }, this, IcmpEchoEngine::Unpaced);
+}
+
+void PingService::cancelEngineEchoes() {
+    // Replies already queued to this thread carry the old generation and are dropped
+    ++pingGeneration;
+    IcmpEchoEngine::instance()->cancel(this);
+    engineOutstanding = 0;
+
+    if (pacingTask != 0) {
+        ProbeScheduler::instance()->remove(pacingTask);
+        pacingTask = 0;
+    }
+    echoesToSend = 0;
+}
+
+void PingService::onEngineResult(PingResult result) {
+    result.host = currentHost;
+    engineOutstanding = qMax(0, engineOutstanding - 1);
+
+    if (isContinuous) {
+        emit pingResult(result);
+        return;
+    }
+
+    currentResults.append(result);
+    if (engineOutstanding == 0) {
+        emit pingCompleted(currentResults);
+    }
+}
+
 QStringList PingService::buildPingCommand(const QString& host, int count) {
     QStringList command;
     QString platform = detectPlatform();
@@ -5,7 +5,6 @@
 #include <QProcess>
 #include <QString>
 #include <QVector>
-#include <QTimer>
 
 /**
  * @brief Service for executing ping operations
@@ -52,6 +51,9 @@ public:
 
     /**
      * @brief Start continuous ping at regular intervals
+     *
+     * The first ping is sent at once; the following ones run on the shared
+     * ProbeScheduler, phased and jittered against other monitored hosts.
      * @param host Target IP address or hostname
      * @param interval Interval between pings in milliseconds (default: 1000)
      */
@@ -94,11 +96,50 @@ private slots:
 
 private:
     QProcess* pingProcess;
-    QTimer* continuousTimer;
+    int continuousTask;     ///< ProbeScheduler task id, 0 when stopped
+    int continuousInterval;
     QString currentHost;
     int currentCount;
     QVector<PingResult> currentResults;
     bool isContinuous;
+    int engineOutstanding;  ///< Echo requests not yet answered on IcmpEchoEngine
+    int pacingTask;         ///< ProbeScheduler task sending the remaining echoes, 0 when idle
+    int echoesToSend;       ///< Echoes the pacing task has yet to send
+    int pingGeneration;     ///< Drops late engine results of a stopped ping
+
+    /**
+     * @brief Resolve host to an IPv4 address usable by IcmpEchoEngine
+     * @param host Target host
+     * @param address Receives the address in host byte order
+     * @return True if the native engine can handle this host
+     */
+    bool engineAddress(const QString& host, quint32& address) const;
+
+    /**
+     * @brief Send echo requests through IcmpEchoEngine, one per second
+     * @param address Target IPv4 address
+     * @param count Number of requests
+     * @param timeout Reply timeout in milliseconds
+     */
+    void pingWithEngine(quint32 address, int count, int timeout);
+
+    /**
+     * @brief Submit a single echo tagged with the current generation
+     * @param address Target IPv4 address
+     * @param timeout Reply timeout in milliseconds
+     */
+    void sendEngineEcho(quint32 address, int timeout);
+
+    /**
+     * @brief Drop pending and paced echoes; late replies are ignored
+     */
+    void cancelEngineEchoes();
+
+    /**
+     * @brief Handle an engine reply on the service thread
+     * @param result Converted ping result
+     */
+    void onEngineResult(PingResult result);
 
     /**
      * @brief Build platform-specific ping command
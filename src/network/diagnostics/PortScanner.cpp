@@ -1,27 +1,79 @@
 #include "PortScanner.h"
 #include "../sockets/TcpSocketManager.h"
-#include "../services/PortServiceMapper.h"
+#include "../sockets/TcpConnectEngine.h"
+#include "../sockets/UdpScanEngine.h"
+#include "../sockets/RttEstimator.h"
+#include "../services/ServiceTable.h"
 #include "../../utils/Logger.h"
 #include <QElapsedTimer>
+#include <QHostAddress>
+#include <QHostInfo>
 #include <QtConcurrent>
 
 PortScanner::PortScanner(QObject* parent)
     : QObject(parent)
     , socketManager(new TcpSocketManager(this))
-    , serviceMapper(new PortServiceMapper())
+    , connectEngine(new TcpConnectEngine())
     , totalPorts(0)
     , scannedPorts(0)
     , scanning(false)
     , scanWatcher(new QFutureWatcher<void>(this))
+    , hostEngine(new TcpConnectEngine())
+    , udpEngine(new UdpScanEngine())
+    , hostRunActive(false)
+    , udpRunActive(false)
+    , pendingHostCount(0)
 {
     // Connect watcher to slot
     connect(scanWatcher, &QFutureWatcher<void>::finished,
             this, &PortScanner::onScanFinished);
+
+    // Multi-host engine: results are grouped per host on the worker thread
+    hostEngine->setResultCallback([this](const TcpConnectEngine::ProbeResult& probe) {
+        if (probe.state != TcpConnectEngine::Open) {
+            return;
+        }
+
+        PortScanResult result;
+        result.host = QHostAddress(probe.address).toString();
+        result.port = probe.port;
+        result.state = "open";
+        result.service = probe.service.isEmpty() ? ServiceTable::instance().serviceName(probe.port) : probe.service;
+        result.version = probe.version;
+        result.responseTime = probe.responseTime;
+
+        addHostResult(probe.address, result);
+    });
+    hostEngine->setHostCompletedCallback([this](quint32 address) {
+        finishHostPass(address);
+    });
+
+    // UDP pass: only ports that answered are open; silence is open|filtered
+    udpEngine->setResultCallback([this](const UdpScanEngine::ProbeResult& probe) {
+        if (probe.state != UdpScanEngine::Open) {
+            return;
+        }
+
+        PortScanResult result;
+        result.host = QHostAddress(probe.address).toString();
+        result.port = probe.port;
+        result.state = "open";
+        result.service = ServiceTable::instance().serviceName(probe.port, ServiceTable::Udp);
+        result.protocol = "udp";
+        result.responseTime = probe.responseTime;
+
+        addHostResult(probe.address, result);
+    });
+    udpEngine->setHostCompletedCallback([this](quint32 address) {
+        finishHostPass(address);
+    });
 }
 
 PortScanner::~PortScanner() {
     cancelScan();
-    delete serviceMapper;
+    delete udpEngine;
+    delete hostEngine;
+    delete connectEngine;
 }
 
 void PortScanner::scanPorts(const QString& host, ScanType type) {
@@ -81,9 +133,206 @@ void PortScanner::scanPortRange(const QString& host, int startPort, int endPort)
     scanPorts(host, ports);
 }
 
+void PortScanner::queueHost(const QString& host, ScanType type) {
+    if (type == FULL_SCAN) {
+        QList<int> ports;
+        for (int i = 1; i <= 65535; ++i) {
+            ports.append(i);
+        }
+        queueHost(host, ports);
+    } else {
+        queueHost(host, getCommonPorts());
+    }
+}
+
+void PortScanner::queueHost(const QString& host, const QList<int>& ports) {
+    queueHost(host, ports, QList<int>());
+}
+
+void PortScanner::queueHost(const QString& host, const QList<int>& ports, const QList<int>& udpPorts) {
+    bool isIpv4 = false;
+    quint32 target = QHostAddress(host).toIPv4Address(&isIpv4);
+
+    if (!isIpv4) {
+        Logger::warn(QString("PortScanner: Cannot queue %1, not an IPv4 address").arg(host));
+        emit hostScanCompleted(host, QList<PortScanResult>());
+        return;
+    }
+
+    bool scanUdp = !udpPorts.isEmpty() && UdpScanEngine::isSupported();
+    if (!udpPorts.isEmpty() && !scanUdp) {
+        Logger::warn(QString("PortScanner: UDP scanning not supported on this platform, skipping UDP for %1").arg(host));
+    }
+
+    // Deadline from the host's measured RTT (its ping usually just provided one)
+    int timeout = RttEstimator::instance()->timeoutFor(target);
+
+    QMutexLocker locker(&hostQueueMutex);
+    {
+        QMutexLocker resultsLocker(&hostResultsMutex);
+        int& passes = hostPassesPending[target];
+        if (passes == 0) {
+            pendingHostCount++;
+        }
+        passes += scanUdp ? 2 : 1;
+    }
+
+    if (scanUdp) {
+        udpEngine->addHost(target, toPortVector(udpPorts), timeout);
+        if (!udpRunActive) {
+            udpRunActive = true;
+            udpEngine->reset();
+            udpRunFuture = QtConcurrent::run([this]() { runUdpQueue(); });
+        }
+    }
+
+    if (TcpConnectEngine::isSupported()) {
+        hostEngine->addHost(target, toPortVector(ports), timeout);
+    } else {
+        fallbackQueue.append(qMakePair(host, ports));
+    }
+
+    // Start a worker if none is draining the queue; a running one picks the host up
+    if (!hostRunActive) {
+        hostRunActive = true;
+        hostEngine->reset();
+        hostRunFuture = QtConcurrent::run([this]() { runHostQueue(); });
+    }
+
+    Logger::debug(QString("PortScanner: Queued %1 (%2 TCP + %3 UDP ports, %4 hosts pending)")
+                 .arg(host).arg(ports.size()).arg(scanUdp ? udpPorts.size() : 0).arg(pendingHostCount));
+}
+
+int PortScanner::pendingHosts() const {
+    QMutexLocker locker(&hostQueueMutex);
+    return pendingHostCount;
+}
+
+void PortScanner::runHostQueue() {
+    while (true) {
+        if (TcpConnectEngine::isSupported()) {
+            hostEngine->run();
+        } else {
+            runFallbackQueue();
+        }
+
+        QMutexLocker locker(&hostQueueMutex);
+        bool moreWork = TcpConnectEngine::isSupported()
+            ? hostEngine->queuedHosts() > 0
+            : !fallbackQueue.isEmpty();
+
+        if (hostEngine->isCancelled() || !moreWork) {
+            hostRunActive = false;
+            return;
+        }
+    }
+}
+
+void PortScanner::runUdpQueue() {
+    while (true) {
+        udpEngine->run();
+
+        QMutexLocker locker(&hostQueueMutex);
+        if (udpEngine->isCancelled() || udpEngine->queuedHosts() == 0) {
+            udpRunActive = false;
+            return;
+        }
+    }
+}
+
+void PortScanner::runFallbackQueue() {
+    while (!hostEngine->isCancelled()) {
+        QPair<QString, QList<int>> job;
+        {
+            QMutexLocker locker(&hostQueueMutex);
+            if (fallbackQueue.isEmpty()) {
+                return;
+            }
+            job = fallbackQueue.takeFirst();
+        }
+
+        quint32 address = QHostAddress(job.first).toIPv4Address();
+        for (int port : job.second) {
+            if (hostEngine->isCancelled()) {
+                return;
+            }
+            PortScanResult result = scanSinglePort(job.first, port, estimatedTimeout(job.first));
+            if (result.state == "open") {
+                addHostResult(address, result);
+            }
+        }
+
+        finishHostPass(address);
+    }
+}
+
+void PortScanner::addHostResult(quint32 address, const PortScanResult& result) {
+    {
+        QMutexLocker locker(&hostResultsMutex);
+        hostResults[address].append(result);
+    }
+    emit portFound(result);
+}
+
+void PortScanner::finishHostPass(quint32 address) {
+    QList<PortScanResult> openPorts;
+    {
+        QMutexLocker locker(&hostResultsMutex);
+        auto it = hostPassesPending.find(address);
+        if (it == hostPassesPending.end()) {
+            return;
+        }
+        if (--it.value() > 0) {
+            return;
+        }
+        hostPassesPending.erase(it);
+        openPorts = hostResults.take(address);
+    }
+
+    finishQueuedHost(QHostAddress(address).toString(), openPorts);
+}
+
+void PortScanner::finishQueuedHost(const QString& host, const QList<PortScanResult>& openPorts) {
+    {
+        QMutexLocker locker(&hostQueueMutex);
+        pendingHostCount = qMax(0, pendingHostCount - 1);
+    }
+
+    Logger::debug(QString("PortScanner: Host %1 done, %2 open ports").arg(host).arg(openPorts.size()));
+    emit hostScanCompleted(host, openPorts);
+}
+
+QVector<quint16> PortScanner::toPortVector(const QList<int>& ports) {
+    QVector<quint16> result;
+    result.reserve(ports.size());
+    for (int port : ports) {
+        if (port > 0 && port <= 65535) {
+            result.append(static_cast<quint16>(port));
+        }
+    }
+    return result;
+}
+
 void PortScanner::cancelScan() {
+    if (hostRunFuture.isRunning() || udpRunFuture.isRunning()) {
+        hostEngine->cancel();
+        udpEngine->cancel();
+        hostRunFuture.waitForFinished();
+        udpRunFuture.waitForFinished();
+
+        QMutexLocker locker(&hostQueueMutex);
+        pendingHostCount = 0;
+        fallbackQueue.clear();
+
+        QMutexLocker resultsLocker(&hostResultsMutex);
+        hostResults.clear();
+        hostPassesPending.clear();
+        Logger::info("PortScanner: Multi-host scan cancelled");
+    }
+
     if (scanning) {
         scanning = false;
+        connectEngine->cancel();
         Logger::info("PortScanner: Cancelling scan...");
 
         // Wait for the scan to finish (it will stop at the next port check)
@@ -99,25 +348,27 @@ bool PortScanner::isScanning() const {
     return scanning;
 }
 
+bool PortScanner::isScanningHosts() const {
+    QMutexLocker locker(&hostQueueMutex);
+    return pendingHostCount > 0;
+}
+
+int PortScanner::peakInFlightProbes() const {
+    return hostEngine->peakInFlight();
+}
+
+void PortScanner::setConcurrencyLimits(int globalLimit, int perHostLimit) {
+    connectEngine->setLimits(globalLimit, perHostLimit);
+    hostEngine->setLimits(globalLimit, perHostLimit);
+}
+
+void PortScanner::setServiceDetection(bool enabled) {
+    connectEngine->setServiceProbing(enabled);
+    hostEngine->setServiceProbing(enabled);
+}
+
 QList<int> PortScanner::getCommonPorts() {
-    return {
-        21,    // FTP
-        22,    // SSH
-        23,    // Telnet
-        25,    // SMTP
-        53,    // DNS
-        80,    // HTTP
-        110,   // POP3
-        143,   // IMAP
-        443,   // HTTPS
-        445,   // SMB
-        3306,  // MySQL
-        3389,  // RDP
-        5432,  // PostgreSQL
-        5900,  // VNC
-        8080,  // HTTP-Alt
-        8443   // HTTPS-Alt
-    };
+    return ServiceTable::instance().topPorts(QUICK_SCAN_PORTS);
 }
 
 PortScanner::PortScanResult PortScanner::scanSinglePort(const QString& host, int port, int timeout) {
@@ -132,8 +383,9 @@ PortScanner::PortScanResult PortScanner::scanSinglePort(const QString& host, int
     result.responseTime = timer.elapsed();
 
     if (connected) {
+        RttEstimator::instance()->addSample(QHostAddress(host).toIPv4Address(), result.responseTime);
         result.state = "open";
-        result.service = serviceMapper->getServiceName(port);
+        result.service = ServiceTable::instance().serviceName(port);
         socketManager->disconnect();
     } else {
         result.state = "closed";
@@ -153,7 +405,16 @@ void PortScanner::executeScan(const QString& host, const QList<int>& ports) {
     Logger::info(QString("PortScanner: Starting async scan of %1 ports on %2")
                  .arg(totalPorts).arg(host));
 
-    // Run scan asynchronously using QtConcurrent
+    if (TcpConnectEngine::isSupported()) {
+        connectEngine->reset();
+        QFuture<void> future = QtConcurrent::run([this, host, ports]() {
+            executeEngineScan(host, ports);
+        });
+        scanWatcher->setFuture(future);
+        return;
+    }
+
+    // Fallback: blocking connects, one port at a time
     QFuture<void> future = QtConcurrent::run([this, host, ports]() {
         // Scan ports sequentially in background thread
         for (int port : ports) {
@@ -162,7 +423,7 @@ void PortScanner::executeScan(const QString& host, const QList<int>& ports) {
                 break;
             }
 
-            PortScanResult result = scanSinglePort(host, port, 1000);
+            PortScanResult result = scanSinglePort(host, port, estimatedTimeout(host));
 
             if (result.state == "open") {
                 scanResults.append(result);
@@ -179,6 +440,70 @@ void PortScanner::executeScan(const QString& host, const QList<int>& ports) {
     scanWatcher->setFuture(future);
 }
 
+void PortScanner::executeEngineScan(const QString& host, const QList<int>& ports) {
+    QHostAddress address(host);
+    bool isIpv4 = false;
+    quint32 target = address.toIPv4Address(&isIpv4);
+
+    if (!isIpv4) {
+        // Hostname: resolve once instead of letting every connect resolve it
+        const QList<QHostAddress> addresses = QHostInfo::fromName(host).addresses();
+        for (const QHostAddress& candidate : addresses) {
+            target = candidate.toIPv4Address(&isIpv4);
+            if (isIpv4) {
+                break;
+            }
+        }
+    }
+
+    if (!isIpv4) {
+        Logger::error(QString("PortScanner: Cannot resolve %1 to an IPv4 address").arg(host));
+        emit errorOccurred(QString("Cannot resolve host: %1").arg(host));
+        return;
+    }
+
+    QVector<quint16> targetPorts = toPortVector(ports);
+    totalPorts = targetPorts.size();
+
+    // Coalesce progress to ~100 updates per scan
+    int progressStep = qMax(1, totalPorts / 100);
+
+    connectEngine->setResultCallback([this, host, progressStep](const TcpConnectEngine::ProbeResult& probe) {
+        if (probe.state == TcpConnectEngine::Open) {
+            PortScanResult result;
+            result.host = host;
+            result.port = probe.port;
+            result.state = "open";
+            result.service = probe.service.isEmpty() ? ServiceTable::instance().serviceName(probe.port) : probe.service;
+            result.version = probe.version;
+            result.responseTime = probe.responseTime;
+
+            scanResults.append(result);
+            emit portFound(result);
+            Logger::debug(QString("PortScanner: Port %1 is open (%2)")
+                         .arg(probe.port).arg(result.service));
+        }
+
+        scannedPorts++;
+        if (scannedPorts % progressStep == 0 || scannedPorts == totalPorts) {
+            updateProgress();
+        }
+    });
+    connectEngine->setHostCompletedCallback(nullptr);
+
+    connectEngine->addHost(target, targetPorts, RttEstimator::instance()->timeoutFor(target));
+    connectEngine->run();
+
+    if (connectEngine->isCancelled()) {
+        Logger::info("PortScanner: Scan cancelled by user");
+    }
+}
+
+int PortScanner::estimatedTimeout(const QString& host) {
+    // Hostnames get the estimator's initial timeout (address 0 has no samples)
+    return RttEstimator::instance()->timeoutFor(QHostAddress(host).toIPv4Address());
+}
+
 void PortScanner::updateProgress() {
     if (totalPorts > 0) {
         emit scanProgress(scannedPorts, totalPorts);
@@ -6,17 +6,24 @@
 #include <QString>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QVector>
 
 // Forward declarations
 class TcpSocketManager;
-class PortServiceMapper;
+class TcpConnectEngine;
+class UdpScanEngine;
 
 /**
- * @brief TCP port scanning service
+ * @brief TCP and UDP port scanning service
  *
  * Provides flexible port scanning with support for quick scans
  * (common ports), full scans (1-65535), and custom port ranges.
- * Uses thread pool for parallel scanning operations.
+ * On Linux ports are probed concurrently by TcpConnectEngine; other
+ * platforms fall back to sequential blocking connects. Queued hosts can
+ * also get a UDP pass through UdpScanEngine (Linux only).
  */
 class PortScanner : public QObject {
     Q_OBJECT
@@ -26,11 +33,13 @@ public:
      * @brief Port scan types
      */
     enum ScanType {
-        QUICK_SCAN,    ///< Scan common ports only (~20 ports)
+        QUICK_SCAN,    ///< Scan the QUICK_SCAN_PORTS most frequently open ports
         FULL_SCAN,     ///< Scan all ports 1-65535
         CUSTOM_SCAN    ///< Scan user-defined port list/range
     };
 
+    static constexpr int QUICK_SCAN_PORTS = 20;
+
     /**
      * @brief Result of a single port scan
      */
@@ -39,10 +48,12 @@ public:
         int port;              ///< Port number
         QString state;         ///< Port state: "open", "closed", "filtered"
         QString service;       ///< Service name (e.g., "HTTP", "SSH")
+        QString protocol;      ///< Transport: "tcp" or "udp"
+        QString version;       ///< Banner/version from service detection, empty if none
         double responseTime;   ///< Response time in milliseconds
 
         PortScanResult()
-            : port(0), state("unknown"), responseTime(0.0) {}
+            : port(0), state("unknown"), protocol("tcp"), responseTime(0.0) {}
     };
 
     explicit PortScanner(QObject* parent = nullptr);
@@ -71,7 +82,52 @@ public:
     void scanPortRange(const QString& host, int startPort, int endPort);
 
     /**
-     * @brief Cancel ongoing scan operation
+     * @brief Queue a host for concurrent multi-host scanning
+     *
+     * All queued hosts share one connect engine and its global in-flight
+     * budget, so many hosts are scanned at once. Results are reported per
+     * host through hostScanCompleted(). Independent of scanPorts().
+     * @param host Target IPv4 address
+     * @param ports List of port numbers to scan
+     */
+    void queueHost(const QString& host, const QList<int>& ports);
+
+    /**
+     * @brief Queue a host for TCP and UDP scanning
+     *
+     * Both passes run concurrently; hostScanCompleted() is emitted once,
+     * after both, with the open ports of either protocol. UDP ports that
+     * stay silent (open|filtered) are not reported.
+     * @param host Target IPv4 address
+     * @param ports TCP ports to scan
+     * @param udpPorts UDP ports to scan (ignored where UDP scanning is unsupported)
+     */
+    void queueHost(const QString& host, const QList<int>& ports, const QList<int>& udpPorts);
+
+    /**
+     * @brief Queue a host with a predefined port set
+     * @param host Target IPv4 address
+     * @param type QUICK_SCAN or FULL_SCAN
+     */
+    void queueHost(const QString& host, ScanType type);
+
+    /**
+     * @brief Number of queued hosts whose scan has not completed
+     */
+    int pendingHosts() const;
+
+    /**
+     * @brief Check if any queued host is still being scanned
+     */
+    bool isScanningHosts() const;
+
+    /**
+     * @brief Most TCP probes in flight at once since the multi-host worker started
+     */
+    int peakInFlightProbes() const;
+
+    /**
+     * @brief Cancel ongoing scan operations (single and multi-host)
      */
     void cancelScan();
 
@@ -81,6 +137,25 @@ public:
      */
     bool isScanning() const;
 
+    /**
+     * @brief Set the connect concurrency caps
+     *
+     * UDP probes keep their own, lower caps: their pace is set by the
+     * targets' ICMP rate limits rather than by local resources.
+     * @param globalLimit Maximum connects in flight in total
+     * @param perHostLimit Maximum connects in flight per target host
+     */
+    void setConcurrencyLimits(int globalLimit, int perHostLimit);
+
+    /**
+     * @brief Read banners / send light probes on open TCP ports
+     *
+     * Runs inside the connect engine, so it applies to engine scans only
+     * (not the blocking fallback). Results then carry the version string.
+     * @param enabled Enable service and version detection
+     */
+    void setServiceDetection(bool enabled);
+
 signals:
     /**
      * @brief Emitted when an open port is found
@@ -101,6 +176,13 @@ signals:
      */
     void scanCompleted(const QList<PortScanResult>& results);
 
+    /**
+     * @brief Emitted when a host queued with queueHost() is done
+     * @param host Target host
+     * @param openPorts Open ports found on this host
+     */
+    void hostScanCompleted(const QString& host, const QList<PortScanResult>& openPorts);
+
     /**
      * @brief Emitted when an error occurs
      * @param error Error message
@@ -112,7 +194,7 @@ private slots:
 
 private:
     TcpSocketManager* socketManager;
-    PortServiceMapper* serviceMapper;
+    TcpConnectEngine* connectEngine;
 
     QString currentHost;
     QList<PortScanResult> scanResults;
@@ -122,9 +204,25 @@ private:
 
     QFutureWatcher<void>* scanWatcher;
 
+    // Multi-host scanning (queueHost)
+    TcpConnectEngine* hostEngine;
+    UdpScanEngine* udpEngine;
+    mutable QMutex hostQueueMutex;
+    bool hostRunActive;                                 ///< Worker draining the host queue
+    bool udpRunActive;                                  ///< Worker draining the UDP host queue
+    int pendingHostCount;
+    QFuture<void> hostRunFuture;
+    QFuture<void> udpRunFuture;
+    QList<QPair<QString, QList<int>>> fallbackQueue;    ///< Hosts for non-epoll platforms
+
+    // Shared by the TCP and UDP workers
+    QMutex hostResultsMutex;
+    QHash<quint32, QList<PortScanResult>> hostResults;
+    QHash<quint32, int> hostPassesPending;              ///< Engine passes left per queued host
+
     /**
      * @brief Get list of common ports for quick scan
-     * @return List of common port numbers
+     * @return Most frequently open TCP ports, most frequent first
      */
     QList<int> getCommonPorts();
 
@@ -144,10 +242,56 @@ private:
      */
     void executeScan(const QString& host, const QList<int>& ports);
 
+    /**
+     * @brief Probe all ports concurrently with TcpConnectEngine (worker thread)
+     * @param host Target host
+     * @param ports List of ports to scan
+     */
+    void executeEngineScan(const QString& host, const QList<int>& ports);
+
     /**
      * @brief Update scan progress
      */
     void updateProgress();
+
+    /**
+     * @brief Drain the multi-host queue (worker thread)
+     */
+    void runHostQueue();
+
+    /**
+     * @brief Drain the UDP host queue (worker thread)
+     */
+    void runUdpQueue();
+
+    /**
+     * @brief Sequential multi-host scanning where the engine is unsupported
+     */
+    void runFallbackQueue();
+
+    /**
+     * @brief Record an open port for a queued host and announce it
+     */
+    void addHostResult(quint32 address, const PortScanResult& result);
+
+    /**
+     * @brief Mark one engine pass of a queued host done; reports the host after the last
+     */
+    void finishHostPass(quint32 address);
+
+    /**
+     * @brief Report completion of a queued host
+     * @param host Target host
+     * @param openPorts Open ports found
+     */
+    void finishQueuedHost(const QString& host, const QList<PortScanResult>& openPorts);
+
+    static QVector<quint16> toPortVector(const QList<int>& ports);
+
+    /**
+     * @brief Connect timeout derived from the host's RTT estimate
+     */
+    static int estimatedTimeout(const QString& host);
 };
 
 #endif // PORTSCANNER_H
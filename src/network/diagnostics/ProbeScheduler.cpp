@@ -0,0 +1,173 @@
+#include "ProbeScheduler.h"
+#include "../../utils/Logger.h"
+#include <QMutexLocker>
+#include <QRandomGenerator>
+
+namespace {
+
+// Van der Corput sequence in base 2: 0, 1/2, 1/4, 3/4, 1/8, 5/8, ...
+double bitReversedFraction(quint32 n)
+{
+    n = ((n >> 1) & 0x55555555u) | ((n & 0x55555555u) << 1);
+    n = ((n >> 2) & 0x33333333u) | ((n & 0x33333333u) << 2);
+    n = ((n >> 4) & 0x0f0f0f0fu) | ((n & 0x0f0f0f0fu) << 4);
+    n = ((n >> 8) & 0x00ff00ffu) | ((n & 0x00ff00ffu) << 8);
+    n = (n >> 16) | (n << 16);
+    return n / 4294967296.0;
+}
+
+}
+
+ProbeScheduler* ProbeScheduler::instance()
+{
+    // Function-local static: initialized once, thread-safe
+    static ProbeScheduler* scheduler = new ProbeScheduler();
+    return scheduler;
+}
+
+ProbeScheduler::ProbeScheduler(QObject* parent)
+    : QObject(parent)
+    , m_tick(new QTimer(this))
+    , m_wheel(TICK_MS)
+    , m_nextId(1)
+{
+    m_clock.start();
+    m_tick->setInterval(TICK_MS);
+    m_tick->setTimerType(Qt::PreciseTimer);
+    connect(m_tick, &QTimer::timeout, this, &ProbeScheduler::onTick);
+}
+
+int ProbeScheduler::add(QObject* context, int intervalMs, Callback callback)
+{
+    int taskId = m_nextId++;
+    int interval = qMax(MIN_INTERVAL_MS, intervalMs);
+
+    Task task;
+    task.context = context;
+    task.callback = std::move(callback);
+    task.intervalMs = interval;
+    task.nominalMs = m_clock.elapsed() + phaseOffset(interval);
+    task.timer = m_wheel.schedule(jittered(task.nominalMs, interval), static_cast<quint64>(taskId));
+    m_tasks.insert(taskId, std::move(task));
+
+    updateTimer();
+    return taskId;
+}
+
+void ProbeScheduler::remove(int taskId)
+{
+    auto task = m_tasks.find(taskId);
+    if (task == m_tasks.end()) {
+        return;
+    }
+
+    m_wheel.remove(task->timer);
+    m_tasks.erase(task);
+    updateTimer();
+}
+
+void ProbeScheduler::setInterval(int taskId, int intervalMs)
+{
+    auto task = m_tasks.find(taskId);
+    if (task == m_tasks.end()) {
+        return;
+    }
+
+    task->intervalMs = qMax(MIN_INTERVAL_MS, intervalMs);
+    task->nominalMs = m_clock.elapsed() + task->intervalMs;
+    m_wheel.reschedule(task->timer, jittered(task->nominalMs, task->intervalMs));
+}
+
+void ProbeScheduler::runSoon(int taskId)
+{
+    auto task = m_tasks.find(taskId);
+    if (task == m_tasks.end()) {
+        return;
+    }
+
+    task->nominalMs = m_clock.elapsed();
+    m_wheel.reschedule(task->timer, task->nominalMs);
+}
+
+bool ProbeScheduler::contains(int taskId) const
+{
+    return m_tasks.contains(taskId);
+}
+
+int ProbeScheduler::interval(int taskId) const
+{
+    auto task = m_tasks.constFind(taskId);
+    return task != m_tasks.constEnd() ? task->intervalMs : 0;
+}
+
+int ProbeScheduler::taskCount() const
+{
+    return m_tasks.size();
+}
+
+qint64 ProbeScheduler::remainingMs(int taskId) const
+{
+    auto task = m_tasks.constFind(taskId);
+    if (task == m_tasks.constEnd()) {
+        return -1;
+    }
+    return qMax<qint64>(0, m_wheel.dueMs(task->timer) - m_clock.elapsed());
+}
+
+void ProbeScheduler::onTick()
+{
+    const qint64 now = m_clock.elapsed();
+    QVector<quint64> fired;
+    m_wheel.advance(now, fired);
+
+    for (quint64 id : fired) {
+        int taskId = static_cast<int>(id);
+        auto task = m_tasks.find(taskId);
+        if (task == m_tasks.end()) {
+            continue;  // Removed by an earlier callback in this tick
+        }
+
+        if (task->context.isNull()) {
+            m_wheel.remove(task->timer);
+            m_tasks.erase(task);
+            continue;
+        }
+
+        // Next slot on the nominal grid; slots missed during a stall are skipped, not bunched
+        task->nominalMs += task->intervalMs;
+        if (task->nominalMs <= now) {
+            task->nominalMs += ((now - task->nominalMs) / task->intervalMs + 1) * task->intervalMs;
+        }
+        m_wheel.reschedule(task->timer, jittered(task->nominalMs, task->intervalMs));
+
+        // The callback may remove this task
+        Callback callback = task->callback;
+        callback();
+    }
+
+    updateTimer();
+}
+
+qint64 ProbeScheduler::phaseOffset(int intervalMs)
+{
+    quint32 n = m_phaseCounters[intervalMs]++;
+    return static_cast<qint64>(bitReversedFraction(n) * intervalMs);
+}
+
+qint64 ProbeScheduler::jittered(qint64 nominalMs, int intervalMs) const
+{
+    int range = intervalMs * JITTER_PERCENT / 100;
+    if (range <= 0) {
+        return nominalMs;
+    }
+    return nominalMs + QRandomGenerator::global()->bounded(-range, range + 1);
+}
+
+void ProbeScheduler::updateTimer()
+{
+    if (!m_tasks.isEmpty() && !m_tick->isActive()) {
+        m_tick->start();
+    } else if (m_tasks.isEmpty() && m_tick->isActive()) {
+        m_tick->stop();
+    }
+}
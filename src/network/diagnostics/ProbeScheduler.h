@@ -0,0 +1,102 @@
+#ifndef PROBESCHEDULER_H
+#define PROBESCHEDULER_H
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+#include "../../utils/TimerWheel.h"
+
+/**
+ * @brief One clock for every periodic probe
+ *
+ * Monitoring components register periodic tasks here instead of running a
+ * QTimer each. All tasks live in one TimerWheel driven by a single timer,
+ * so adding, removing or re-timing a task is O(1) and a tick only touches
+ * the tasks that are due.
+ *
+ * Tasks with the same interval are spread evenly across it: the n-th task
+ * starts at the bit-reversed fraction of n (0, 1/2, 1/4, 3/4, ...), which
+ * keeps any number of them evenly spaced without moving existing ones.
+ * Each run is also shifted by up to JITTER_PERCENT of the interval around
+ * its nominal time, so targets never settle into lockstep; the nominal
+ * schedule itself does not drift.
+ *
+ * Lives on the thread that created it and runs callbacks there; use it
+ * from that thread only, like a QTimer.
+ */
+class ProbeScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int TICK_MS = 10;
+    static constexpr int JITTER_PERCENT = 5;
+    static constexpr int MIN_INTERVAL_MS = TICK_MS;
+
+    using Callback = std::function<void()>;
+
+    /**
+     * @brief Scheduler shared by all monitoring components (GUI thread)
+     */
+    static ProbeScheduler* instance();
+
+    explicit ProbeScheduler(QObject* parent = nullptr);
+    ~ProbeScheduler() override = default;
+
+    ProbeScheduler(const ProbeScheduler&) = delete;
+    ProbeScheduler& operator=(const ProbeScheduler&) = delete;
+
+    /**
+     * @brief Run @p callback every @p intervalMs
+     * @param context Task is dropped once this object is destroyed
+     * @return Task id, always > 0
+     */
+    int add(QObject* context, int intervalMs, Callback callback);
+
+    void remove(int taskId);
+
+    /**
+     * @brief Change a task's interval; the next run is one new interval from now
+     */
+    void setInterval(int taskId, int intervalMs);
+
+    /**
+     * @brief Run the task on the next tick, then continue at its interval
+     */
+    void runSoon(int taskId);
+
+    bool contains(int taskId) const;
+    int interval(int taskId) const;
+    int taskCount() const;
+
+    /**
+     * @brief Milliseconds until the task's next run, -1 if unknown
+     */
+    qint64 remainingMs(int taskId) const;
+
+private:
+    struct Task {
+        QPointer<QObject> context;
+        Callback callback;
+        int intervalMs;
+        qint64 nominalMs;           ///< Unjittered time of the next run
+        TimerWheel::Id timer;
+    };
+
+    QTimer* m_tick;
+    QElapsedTimer m_clock;
+    TimerWheel m_wheel;
+    QHash<int, Task> m_tasks;
+    QHash<int, quint32> m_phaseCounters;    ///< Interval -> tasks started with it
+    int m_nextId;
+
+    void onTick();
+    qint64 phaseOffset(int intervalMs);
+    qint64 jittered(qint64 nominalMs, int intervalMs) const;
+    void updateTimer();
+};
+
+#endif // PROBESCHEDULER_H
@@ -5,7 +5,7 @@ QualityScoreCalculator::QualityScore QualityScoreCalculator::calculate(const Net
     return calculate(
         metrics.latencyAvg(),
         metrics.packetLoss(),
-        metrics.jitter(),
+        metrics.scoringJitter(),
         100.0  // Assume 100% availability if not tracked
     );
 }
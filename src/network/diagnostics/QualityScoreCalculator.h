@@ -8,6 +8,8 @@
  *
  * Combines latency, packet loss, jitter, and availability metrics
  * to produce a comprehensive quality score (0-100) and rating.
+ * Jitter is the RFC 3550 interarrival jitter, the measure the jitter
+ * thresholds of VoIP guidance refer to.
  */
 class QualityScoreCalculator {
 public:
@@ -39,6 +41,9 @@ public:
 
     /**
      * @brief Calculate quality score from network metrics
+     *
+     * Scores NetworkMetrics::scoringJitter(), so a jitter burst counts
+     * before the smoothed estimate has caught up with it.
      * @param metrics NetworkMetrics containing latency, jitter, packet loss
      * @return QualityScore with overall assessment
      */
@@ -48,7 +53,7 @@ public:
      * @brief Calculate quality score from individual metrics
      * @param latency Average latency in milliseconds
      * @param packetLoss Packet loss percentage (0-100)
-     * @param jitter Jitter in milliseconds
+     * @param jitter Interarrival jitter in milliseconds
      * @param availability Availability percentage (0-100)
      * @return QualityScore with overall assessment
      */
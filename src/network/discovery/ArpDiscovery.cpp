@@ -1,12 +1,22 @@
 #include "ArpDiscovery.h"
+#include "NeighborTable.h"
 #include "utils/Logger.h"
 #include <QProcess>
 #include <QRegularExpression>
-#include <QNetworkInterface>
+#include <QHostAddress>
 #include <QList>
 
 QMap<QString, QString> ArpDiscovery::getArpTable()
 {
+#ifdef Q_OS_LINUX
+    // Read the kernel table directly instead of spawning arp
+    QMap<QString, QString> arpTable;
+    QHash<quint32, QString> table = NeighborTable::readKernelTable();
+    for (auto it = table.constBegin(); it != table.constEnd(); ++it) {
+        arpTable.insert(QHostAddress(it.key()).toString(), it.value());
+    }
+    return arpTable;
+#else
     QProcess process;
 
 #ifdef Q_OS_WIN
@@ -27,47 +37,18 @@ QMap<QString, QString> ArpDiscovery::getArpTable()
 #else
     return parseArpTableLinux(output);
 #endif
+#endif
 }
 
 QString ArpDiscovery::getMacAddress(const QString& ip)
 {
-    // First check if this IP belongs to a local interface
-    QString localMac = getLocalMacAddress(ip);
-    if (!localMac.isEmpty()) {
-        return localMac;
-    }
-
-    // Otherwise check ARP table
-    QMap<QString, QString> arpTable = getArpTable();
-    return arpTable.value(ip, QString());
+    // Local interfaces first, then the shared per-scan neighbour snapshot
+    return NeighborTable::instance()->macAddress(ip);
 }
 
 QString ArpDiscovery::getLocalMacAddress(const QString& ip)
 {
-    // Check all network interfaces to see if the IP matches a local interface
-    QList<QNetworkInterface> interfaces = QNetworkInterface::allInterfaces();
-
-    for (const QNetworkInterface& iface : interfaces) {
-        // Skip loopback
-        if (iface.flags() & QNetworkInterface::IsLoopBack) {
-            continue;
-        }
-
-        // Check all addresses on this interface
-        QList<QNetworkAddressEntry> entries = iface.addressEntries();
-        for (const QNetworkAddressEntry& entry : entries) {
-            if (entry.ip().toString() == ip) {
-                // Found matching IP - return MAC address
-                QString mac = iface.hardwareAddress();
-                if (!mac.isEmpty()) {
-                    Logger::debug(QString("Found local MAC for %1: %2").arg(ip).arg(mac));
-                    return mac;
-                }
-            }
-        }
-    }
-
-    return QString();
+    return NeighborTable::instance()->localMacAddress(ip);
 }
 
 QString ArpDiscovery::parseArpOutput(const QString& output)
@@ -86,9 +67,10 @@ QMap<QString, QString> ArpDiscovery::parseArpTableWindows(const QString& output)
 
     QStringList lines = output.split('\n');
 
+    // Match IP and MAC address
+    static const QRegularExpression re("(\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}\\.\\d{1,3})\\s+([0-9a-fA-F]{2}-[0-9a-fA-F]{2}-[0-9a-fA-F]{2}-[0-9a-fA-F]{2}-[0-9a-fA-F]{2}-[0-9a-fA-F]{2})");
+
     for (const QString& line : lines) {
-        // Match IP and MAC address
-        QRegularExpression re("(\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}\\.\\d{1,3})\\s+([0-9a-fA-F]{2}-[0-9a-fA-F]{2}-[0-9a-fA-F]{2}-[0-9a-fA-F]{2}-[0-9a-fA-F]{2}-[0-9a-fA-F]{2})");
         QRegularExpressionMatch match = re.match(line);
 
         if (match.hasMatch()) {
@@ -116,14 +98,15 @@ QMap<QString, QString> ArpDiscovery::parseArpTableLinux(const QString& output)
 
     QStringList lines = output.split('\n');
 
+    // Match IP and MAC address
+    static const QRegularExpression re("(\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}).*?([0-9a-fA-F]{2}:[0-9a-fA-F]{2}:[0-9a-fA-F]{2}:[0-9a-fA-F]{2}:[0-9a-fA-F]{2}:[0-9a-fA-F]{2})");
+
     for (const QString& line : lines) {
         // Skip header and incomplete entries
         if (line.contains("Address") || line.contains("incomplete")) {
             continue;
         }
 
-        // Match IP and MAC address
-        QRegularExpression re("(\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}).*?([0-9a-fA-F]{2}:[0-9a-fA-F]{2}:[0-9a-fA-F]{2}:[0-9a-fA-F]{2}:[0-9a-fA-F]{2}:[0-9a-fA-F]{2})");
         QRegularExpressionMatch match = re.match(line);
 
         if (match.hasMatch()) {
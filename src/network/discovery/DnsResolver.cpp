@@ -1,9 +1,13 @@
 #include "DnsResolver.h"
+#include "PtrResolver.h"
+#include "network/sockets/RateController.h"
 #include "utils/Logger.h"
 #include <QEventLoop>
 #include <QTimer>
 #include <QThread>
 #include <QRegularExpression>
+#include <QHostAddress>
+#include <QDateTime>
 
 DnsResolver::DnsResolver(QObject *parent)
     : QObject(parent)
@@ -20,6 +24,7 @@ DnsResolver::~DnsResolver()
 {
     m_destroyed = true;
     cancel();
+    cancelPending();
 
     // Give pending callbacks a moment to finish
     QThread::msleep(100);
@@ -46,35 +51,114 @@ void DnsResolver::resolveHostname(const QString& ip)
 
 QString DnsResolver::resolveSync(const QString& ip, int timeout, int maxRetries)
 {
-    // Check cache first
-    {
-        QMutexLocker locker(&m_cacheMutex);
-        QString* cached = m_dnsCache.object(ip);
-        if (cached) {
-            m_cacheHits++;
-            Logger::debug(QString("DNS Cache HIT for %1 -> %2 (hits: %3, misses: %4)")
-                         .arg(ip).arg(*cached).arg(m_cacheHits).arg(m_cacheMisses));
-            return *cached;
-        }
-        m_cacheMisses++;
+    QString result;
+    if (cachedName(ip, result)) {
+        return result;
     }
 
+    bool ok = false;
+    quint32 address = QHostAddress(ip).toIPv4Address(&ok);
+    PtrResolver* resolver = PtrResolver::instance();
+
+    if (ok && resolver->isAvailable()) {
+        // Multiplexed PTR query; negative answers are cached by the resolver
+        return finishPtr(ip, resolver->resolve(address, timeout, maxRetries));
+    }
+
+    countLookup(false);
     Logger::debug(QString("DNS Cache MISS for %1 - performing lookup (timeout: %2ms, retries: %3)")
                  .arg(ip).arg(timeout).arg(maxRetries));
 
     // Perform resolution with retry
-    QString result = resolveWithRetry(ip, timeout, maxRetries);
-
-    // Cache successful results (but not failures)
+    result = resolveWithRetry(ip, timeout, maxRetries);
     if (!result.isEmpty()) {
-        QMutexLocker locker(&m_cacheMutex);
-        m_dnsCache.insert(ip, new QString(result));
-        Logger::debug(QString("Cached DNS result: %1 -> %2").arg(ip).arg(result));
+        storeName(ip, result, FALLBACK_TTL_SECONDS);
     }
-
     return result;
 }
 
+void DnsResolver::resolveAsync(const QString& ip, int timeout, int maxRetries, Callback callback)
+{
+    QString cached;
+    if (cachedName(ip, cached)) {
+        callback(cached);
+        return;
+    }
+
+    bool ok = false;
+    quint32 address = QHostAddress(ip).toIPv4Address(&ok);
+    PtrResolver* resolver = PtrResolver::instance();
+
+    if (!ok || !resolver->isAvailable()) {
+        callback(resolveSync(ip, timeout, maxRetries));
+        return;
+    }
+
+    resolver->submit(address, timeout, [this, ip, callback](const PtrResolver::PtrResult& ptr) {
+        callback(finishPtr(ip, ptr));
+    }, this, maxRetries);
+}
+
+void DnsResolver::cancelPending()
+{
+    PtrResolver::instance()->cancel(this);
+}
+
+bool DnsResolver::cachedName(const QString& ip, QString& hostname)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    CachedName* cached = m_dnsCache.object(ip);
+    if (!cached) {
+        return false;
+    }
+    if (cached->expiresMs <= QDateTime::currentMSecsSinceEpoch()) {
+        m_dnsCache.remove(ip);
+        return false;
+    }
+
+    m_cacheHits++;
+    hostname = cached->hostname;
+    Logger::debug(QString("DNS Cache HIT for %1 -> %2 (hits: %3, misses: %4)")
+                 .arg(ip).arg(hostname).arg(m_cacheHits).arg(m_cacheMisses));
+    return true;
+}
+
+void DnsResolver::storeName(const QString& ip, const QString& hostname, quint32 ttlSeconds)
+{
+    // Only successful results; negative answers are cached by PtrResolver
+    QMutexLocker locker(&m_cacheMutex);
+    CachedName* entry = new CachedName;
+    entry->hostname = hostname;
+    entry->expiresMs = QDateTime::currentMSecsSinceEpoch() + static_cast<qint64>(ttlSeconds) * 1000;
+    m_dnsCache.insert(ip, entry);
+    Logger::debug(QString("Cached DNS result: %1 -> %2 (ttl %3s)").arg(ip).arg(hostname).arg(ttlSeconds));
+}
+
+void DnsResolver::countLookup(bool cached)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    if (cached) {
+        m_cacheHits++;
+    } else {
+        m_cacheMisses++;
+    }
+}
+
+QString DnsResolver::finishPtr(const QString& ip, const PtrResolver::PtrResult& ptr)
+{
+    // A miss only when the resolver's cache missed as well
+    countLookup(ptr.cached);
+    if (ptr.status != PtrResolver::Resolved) {
+        return QString();
+    }
+
+    Logger::info(QString("DNS resolved %1 -> %2 (ttl %3s)").arg(ip).arg(ptr.hostname).arg(ptr.ttl));
+    if (ptr.ttl > 0) {
+        storeName(ip, ptr.hostname, ptr.ttl);
+    }
+    return ptr.hostname;
+}
+
 QString DnsResolver::resolveWithRetry(const QString& ip, int timeout, int retriesLeft)
 {
     QEventLoop loop;
@@ -122,7 +206,8 @@ QString DnsResolver::resolveWithRetry(const QString& ip, int timeout, int retrie
             loop.quit();
         });
 
-        // Start async resolution
+        // Start async resolution, paced with the other probes
+        RateController::instance()->acquire();
         resolveHostname(ip);
 
         Logger::debug(QString("resolveSync: Waiting for %1... (timeout: %2ms)").arg(ip).arg(currentTimeout));
@@ -134,6 +219,12 @@ QString DnsResolver::resolveWithRetry(const QString& ip, int timeout, int retrie
         disconnect(conn1);
         disconnect(conn2);
 
+        if (signalReceived) {
+            RateController::instance()->reportResponse();
+        } else {
+            RateController::instance()->reportTimeout();
+        }
+
         // If we got a result, return it
         if (!result.isEmpty()) {
             Logger::info(QString("DNS resolved %1 -> %2 (attempt %3/%4)")
@@ -164,6 +255,45 @@ QString DnsResolver::resolveWithRetry(const QString& ip, int timeout, int retrie
     return QString();
 }
 
+QHash<QString, QString> DnsResolver::resolveBatch(const QStringList& ips, int timeout, int maxRetries)
+{
+    QHash<QString, QString> results;
+
+    PtrResolver* resolver = PtrResolver::instance();
+    QVector<quint32> addresses;
+    QStringList queried;
+    QStringList fallback;
+
+    for (const QString& ip : ips) {
+        bool ok = false;
+        quint32 address = QHostAddress(ip).toIPv4Address(&ok);
+        if (ok && resolver->isAvailable()) {
+            addresses.append(address);
+            queried.append(ip);
+        } else {
+            fallback.append(ip);
+        }
+    }
+
+    // All PTR queries go out at once and complete in a single timeout window
+    const QVector<PtrResolver::PtrResult> resolved = resolver->resolveBatch(addresses, timeout, maxRetries);
+    for (int i = 0; i < resolved.size(); ++i) {
+        if (resolved[i].status == PtrResolver::Resolved) {
+            results.insert(queried[i], resolved[i].hostname);
+        }
+    }
+
+    for (const QString& ip : fallback) {
+        QString hostname = resolveSync(ip, timeout, maxRetries);
+        if (!hostname.isEmpty()) {
+            results.insert(ip, hostname);
+        }
+    }
+
+    Logger::debug(QString("DNS batch resolved %1/%2 addresses").arg(results.size()).arg(ips.size()));
+    return results;
+}
+
 void DnsResolver::cancel()
 {
     // QHostInfo doesn't provide a way to cancel lookups
@@ -175,6 +305,7 @@ void DnsResolver::clearCache()
 {
     QMutexLocker locker(&m_cacheMutex);
     m_dnsCache.clear();
+    PtrResolver::instance()->clearCache();
     Logger::info(QString("DNS cache cleared (hits: %1, misses: %2, retries: %3)")
                 .arg(m_cacheHits).arg(m_cacheMisses).arg(m_retryCount));
     m_cacheHits = 0;
@@ -7,6 +7,10 @@
 #include <QCache>
 #include <QMutex>
 #include <QMap>
+#include <QHash>
+#include <QStringList>
+#include <functional>
+#include "PtrResolver.h"
 
 class DnsResolver : public QObject
 {
@@ -17,8 +21,20 @@ public:
     ~DnsResolver();
 
     void resolveHostname(const QString& ip);
+    using Callback = std::function<void(const QString& hostname)>;
+
     QString resolveSync(const QString& ip, int timeout = 2000, int maxRetries = 2);
 
+    // Returns at once for IPv4 over PtrResolver (callback on its receiver thread, or
+    // here on a cache hit); other addresses fall back to resolveSync() before calling back
+    void resolveAsync(const QString& ip, int timeout, int maxRetries, Callback callback);
+
+    // Drop lookups started by resolveAsync(); their callbacks never run
+    void cancelPending();
+
+    // Resolve many addresses concurrently; returns only the resolved ones (ip -> hostname)
+    QHash<QString, QString> resolveBatch(const QStringList& ips, int timeout = 2000, int maxRetries = 2);
+
     void cancel();
     void clearCache();
 
@@ -35,14 +51,26 @@ private slots:
     void onLookupFinished(const QHostInfo& info);
 
 private:
+    struct CachedName {
+        QString hostname;
+        qint64 expiresMs;
+    };
+
+    // QHostInfo reports no TTL; its names are kept this long
+    static constexpr quint32 FALLBACK_TTL_SECONDS = 300;
+
     QString resolveWithRetry(const QString& ip, int timeout, int retriesLeft);
+    bool cachedName(const QString& ip, QString& hostname);
+    void storeName(const QString& ip, const QString& hostname, quint32 ttlSeconds);
+    void countLookup(bool cached);
+    QString finishPtr(const QString& ip, const PtrResolver::PtrResult& ptr);
 
     int m_lookupId;
     QString m_currentIp;
     bool m_destroyed;
 
-    // DNS cache: IP -> hostname mapping
-    QCache<QString, QString> m_dnsCache;
+    // DNS cache: IP -> hostname until the record's TTL runs out
+    QCache<QString, CachedName> m_dnsCache;
     mutable QMutex m_cacheMutex;
 
     // Map lookupId -> IP address to avoid race conditions
@@ -0,0 +1,447 @@
+#include "FrameParser.h"
+#include <cstring>
+
+namespace {
+const quint16 ETHERTYPE_IPV4 = 0x0800;
+const quint16 ETHERTYPE_ARP = 0x0806;
+const quint16 ETHERTYPE_VLAN = 0x8100;
+const quint16 ETHERTYPE_IPV6 = 0x86DD;
+const int ETHERNET_HEADER = 14;
+const int SLL_HEADER = 16;
+
+const quint8 IP_PROTOCOL_UDP = 17;
+const int UDP_HEADER = 8;
+
+const quint16 PORT_DHCP_SERVER = 67;
+const quint16 PORT_DHCP_CLIENT = 68;
+const quint16 PORT_MDNS = 5353;
+const quint16 PORT_SSDP = 1900;
+
+const int BOOTP_CHADDR = 28;
+const int BOOTP_OPTIONS = 240;
+const quint32 DHCP_MAGIC = 0x63825363;
+const quint8 DHCP_OPTION_PAD = 0;
+const quint8 DHCP_OPTION_HOSTNAME = 12;
+const quint8 DHCP_OPTION_REQUESTED_IP = 50;
+const quint8 DHCP_OPTION_MESSAGE_TYPE = 53;
+const quint8 DHCP_OPTION_END = 255;
+const quint8 DHCP_ACK = 5;
+
+const int DNS_HEADER = 12;
+const quint16 DNS_FLAG_RESPONSE = 0x8000;
+const quint16 DNS_TYPE_A = 1;
+const int MAX_POINTER_JUMPS = 16;
+
+const int IPV6_HEADER = 40;
+const quint8 IPV6_NEXT_ICMPV6 = 58;
+const quint8 NDP_HOP_LIMIT = 255;
+const quint8 NDP_ROUTER_SOLICITATION = 133;
+const quint8 NDP_ROUTER_ADVERTISEMENT = 134;
+const quint8 NDP_NEIGHBOR_SOLICITATION = 135;
+const quint8 NDP_NEIGHBOR_ADVERTISEMENT = 136;
+const quint8 NDP_OPTION_SOURCE_LLADDR = 1;
+const quint8 NDP_OPTION_TARGET_LLADDR = 2;
+
+inline quint16 readU16(const quint8* data)
+{
+    return static_cast<quint16>((data[0] << 8) | data[1]);
+}
+
+inline quint32 readU32(const quint8* data)
+{
+    return (static_cast<quint32>(data[0]) << 24) | (static_cast<quint32>(data[1]) << 16)
+         | (static_cast<quint32>(data[2]) << 8) | data[3];
+}
+
+inline bool startsWith(const quint8* data, int length, const char* prefix)
+{
+    int prefixLength = static_cast<int>(std::strlen(prefix));
+    return length >= prefixLength && std::memcmp(data, prefix, prefixLength) == 0;
+}
+}
+
+bool FrameParser::parse(const quint8* frame, int length, Observation& observation, int linkType)
+{
+    observation.protocol = None;
+    observation.address = 0;
+    observation.hasAddress6 = false;
+    observation.hostname[0] = '\0';
+    observation.hostnameLength = 0;
+
+    const quint8* sourceMac = nullptr;
+    quint16 etherType = 0;
+    int offset = 0;
+
+    if (linkType == Ethernet) {
+        if (length < ETHERNET_HEADER) {
+            return false;
+        }
+        sourceMac = frame + 6;
+        etherType = readU16(frame + 12);
+        offset = ETHERNET_HEADER;
+
+        if (etherType == ETHERTYPE_VLAN) {
+            if (length < ETHERNET_HEADER + 4) {
+                return false;
+            }
+            etherType = readU16(frame + 16);
+            offset += 4;
+        }
+    } else if (linkType == LinuxCooked) {
+        // Packet type, ARPHRD type, address length, 8 address bytes, protocol
+        if (length < SLL_HEADER || readU16(frame + 4) != 6) {
+            return false;
+        }
+        sourceMac = frame + 6;
+        etherType = readU16(frame + 14);
+        offset = SLL_HEADER;
+    } else {
+        return false;
+    }
+
+    std::memcpy(observation.mac, sourceMac, 6);
+
+    if (etherType == ETHERTYPE_ARP) {
+        return parseArp(frame + offset, length - offset, observation);
+    }
+    if (etherType == ETHERTYPE_IPV4) {
+        return parseIpv4(frame + offset, length - offset, observation);
+    }
+    if (etherType == ETHERTYPE_IPV6) {
+        return parseIpv6(frame + offset, length - offset, observation);
+    }
+    return false;
+}
+
+bool FrameParser::parseArp(const quint8* data, int length, Observation& observation)
+{
+    // Ethernet/IPv4 ARP only: htype 1, ptype 0x0800, hlen 6, plen 4
+    if (length < 28 || readU16(data) != 1 || readU16(data + 2) != ETHERTYPE_IPV4
+        || data[4] != 6 || data[5] != 4) {
+        return false;
+    }
+
+    // ARP probes (RFC 5227) carry sender address 0.0.0.0: the host has no address yet
+    quint32 sender = readU32(data + 14);
+    if (sender == 0) {
+        return false;
+    }
+
+    observation.protocol = Arp;
+    std::memcpy(observation.mac, data + 8, 6);
+    observation.address = sender;
+    return true;
+}
+
+bool FrameParser::parseIpv4(const quint8* data, int length, Observation& observation)
+{
+    if (length < 20 || (data[0] >> 4) != 4) {
+        return false;
+    }
+
+    int headerLength = (data[0] & 0x0F) * 4;
+    int totalLength = readU16(data + 2);
+    if (headerLength < 20 || totalLength < headerLength || data[9] != IP_PROTOCOL_UDP) {
+        return false;
+    }
+
+    // Later fragments have no UDP header
+    if (readU16(data + 6) & 0x1FFF) {
+        return false;
+    }
+
+    // Ethernet pads short frames; trust the IP length when it is smaller
+    length = qMin(length, totalLength);
+    if (length < headerLength + UDP_HEADER) {
+        return false;
+    }
+
+    quint32 source = readU32(data + 12);
+    const quint8* udp = data + headerLength;
+    quint16 sourcePort = readU16(udp);
+    quint16 destinationPort = readU16(udp + 2);
+    const quint8* payload = udp + UDP_HEADER;
+    int payloadLength = length - headerLength - UDP_HEADER;
+
+    if ((sourcePort == PORT_DHCP_CLIENT && destinationPort == PORT_DHCP_SERVER)
+        || (sourcePort == PORT_DHCP_SERVER && destinationPort == PORT_DHCP_CLIENT)) {
+        return parseDhcp(payload, payloadLength, observation);
+    }
+
+    if (source == 0) {
+        return false;
+    }
+
+    if (sourcePort == PORT_MDNS || destinationPort == PORT_MDNS) {
+        return parseMdns(payload, payloadLength, source, observation);
+    }
+
+    if ((sourcePort == PORT_SSDP || destinationPort == PORT_SSDP) && isSsdp(payload, payloadLength)) {
+        observation.protocol = Ssdp;
+        observation.address = source;
+        return true;
+    }
+
+    return false;
+}
+
+bool FrameParser::parseIpv6(const quint8* data, int length, Observation& observation)
+{
+    // NDP messages carry no extension headers and must arrive with hop limit 255 (RFC 4861)
+    if (length < IPV6_HEADER || (data[0] >> 4) != 6 || data[6] != IPV6_NEXT_ICMPV6
+        || data[7] != NDP_HOP_LIMIT) {
+        return false;
+    }
+
+    length = qMin(length, IPV6_HEADER + readU16(data + 4));
+    const quint8* source = data + 8;
+    const quint8* icmp = data + IPV6_HEADER;
+    int icmpLength = length - IPV6_HEADER;
+    if (icmpLength < 8) {
+        return false;
+    }
+
+    // Where the options start, and which address the message vouches for
+    const quint8* address = source;
+    int options = 0;
+    quint8 linkOption = NDP_OPTION_SOURCE_LLADDR;
+
+    switch (icmp[0]) {
+    case NDP_ROUTER_SOLICITATION:
+        options = 8;
+        break;
+    case NDP_ROUTER_ADVERTISEMENT:
+        options = 16;
+        break;
+    case NDP_NEIGHBOR_SOLICITATION:
+        options = 24;
+        break;
+    case NDP_NEIGHBOR_ADVERTISEMENT:
+        // The target is the address being advertised, often a global one
+        options = 24;
+        address = icmp + 8;
+        linkOption = NDP_OPTION_TARGET_LLADDR;
+        break;
+    default:
+        return false;
+    }
+
+    if (icmpLength < options) {
+        return false;
+    }
+
+    // Unspecified source: duplicate address detection for an address not yet in use
+    static const quint8 unspecified[16] = {};
+    if (std::memcmp(address, unspecified, 16) == 0 || address[0] == 0xFF) {
+        return false;
+    }
+
+    for (int offset = options; offset + 8 <= icmpLength;) {
+        int optionLength = icmp[offset + 1] * 8;
+        if (optionLength == 0 || offset + optionLength > icmpLength) {
+            break;
+        }
+        if (icmp[offset] == linkOption && optionLength == 8) {
+            std::memcpy(observation.mac, icmp + offset + 2, 6);
+        }
+        offset += optionLength;
+    }
+
+    observation.protocol = Ndp;
+    std::memcpy(observation.address6, address, 16);
+    observation.hasAddress6 = true;
+    return true;
+}
+
+bool FrameParser::parseDhcp(const quint8* data, int length, Observation& observation)
+{
+    // BOOTP header up to the magic cookie; hardware type Ethernet, 6-byte address
+    if (length < BOOTP_OPTIONS || data[1] != 1 || data[2] != 6 || readU32(data + 236) != DHCP_MAGIC) {
+        return false;
+    }
+
+    bool reply = (data[0] == 2);
+    quint32 clientAddress = readU32(data + 12);
+    quint32 yourAddress = readU32(data + 16);
+    quint32 requested = 0;
+    int messageType = 0;
+
+    int offset = BOOTP_OPTIONS;
+    while (offset < length) {
+        quint8 option = data[offset];
+        if (option == DHCP_OPTION_END) {
+            break;
+        }
+        if (option == DHCP_OPTION_PAD) {
+            offset++;
+            continue;
+        }
+        if (offset + 2 > length) {
+            break;
+        }
+
+        int optionLength = data[offset + 1];
+        const quint8* value = data + offset + 2;
+        if (offset + 2 + optionLength > length) {
+            break;
+        }
+
+        if (option == DHCP_OPTION_MESSAGE_TYPE && optionLength == 1) {
+            messageType = value[0];
+        } else if (option == DHCP_OPTION_REQUESTED_IP && optionLength == 4) {
+            requested = readU32(value);
+        } else if (option == DHCP_OPTION_HOSTNAME && !reply) {
+            setHostname(observation, value, optionLength);
+        }
+        offset += 2 + optionLength;
+    }
+
+    if (reply) {
+        // Only an ACK confirms the lease; OFFERs may never be taken
+        if (messageType != DHCP_ACK || yourAddress == 0) {
+            return false;
+        }
+        observation.address = yourAddress;
+    } else {
+        // DISCOVER has neither; the name still attaches to the MAC until an address shows up
+        observation.address = clientAddress != 0 ? clientAddress : requested;
+    }
+
+    observation.protocol = Dhcp;
+    std::memcpy(observation.mac, data + BOOTP_CHADDR, 6);
+    return true;
+}
+
+bool FrameParser::parseMdns(const quint8* data, int length, quint32 source, Observation& observation)
+{
+    if (length < DNS_HEADER) {
+        return false;
+    }
+
+    observation.protocol = Mdns;
+    observation.address = source;
+
+    // Queries still show the sender is present; only responses can name it
+    if (!(readU16(data + 2) & DNS_FLAG_RESPONSE)) {
+        return true;
+    }
+
+    int questions = readU16(data + 4);
+    int records = readU16(data + 6) + readU16(data + 8) + readU16(data + 10);
+    int offset = DNS_HEADER;
+
+    for (int i = 0; i < questions; ++i) {
+        offset = readName(data, length, offset, nullptr, 0, nullptr);
+        if (offset < 0 || offset + 4 > length) {
+            return true;
+        }
+        offset += 4;
+    }
+
+    for (int i = 0; i < records; ++i) {
+        int ownerOffset = offset;
+        offset = readName(data, length, offset, nullptr, 0, nullptr);
+        if (offset < 0 || offset + 10 > length) {
+            return true;
+        }
+
+        quint16 type = readU16(data + offset);
+        int rdLength = readU16(data + offset + 8);
+        int rdata = offset + 10;
+        if (rdata + rdLength > length) {
+            return true;
+        }
+
+        // The responder's own A record carries its hostname
+        if (type == DNS_TYPE_A && rdLength == 4 && readU32(data + rdata) == source) {
+            int written = 0;
+            if (readName(data, length, ownerOffset, observation.hostname, MAX_HOSTNAME, &written) >= 0) {
+                observation.hostname[written] = '\0';
+                observation.hostnameLength = written;
+            }
+            return true;
+        }
+
+        offset = rdata + rdLength;
+    }
+
+    return true;
+}
+
+bool FrameParser::isSsdp(const quint8* data, int length)
+{
+    return startsWith(data, length, "NOTIFY * HTTP/1.1")
+        || startsWith(data, length, "M-SEARCH * HTTP/1.1")
+        || startsWith(data, length, "HTTP/1.1 200");
+}
+
+int FrameParser::readName(const quint8* data, int length, int offset, char* out, int capacity, int* written)
+{
+    int position = offset;
+    int resume = -1;
+    int jumps = 0;
+    int count = 0;
+
+    while (true) {
+        if (position >= length) {
+            return -1;
+        }
+
+        quint8 labelLength = data[position];
+
+        if ((labelLength & 0xC0) == 0xC0) {
+            if (position + 1 >= length || ++jumps > MAX_POINTER_JUMPS) {
+                return -1;
+            }
+            if (resume < 0) {
+                resume = position + 2;
+            }
+            position = ((labelLength & 0x3F) << 8) | data[position + 1];
+            continue;
+        }
+
+        if (labelLength & 0xC0) {
+            return -1;
+        }
+
+        if (labelLength == 0) {
+            if (written) {
+                *written = count;
+            }
+            return resume >= 0 ? resume : position + 1;
+        }
+
+        if (position + 1 + labelLength > length) {
+            return -1;
+        }
+
+        if (out) {
+            if (count > 0 && count < capacity) {
+                out[count++] = '.';
+            }
+            for (int i = 0; i < labelLength && count < capacity; ++i) {
+                quint8 c = data[position + 1 + i];
+                if (c > 0x20 && c < 0x7F) {
+                    out[count++] = static_cast<char>(c);
+                }
+            }
+        }
+        position += 1 + labelLength;
+    }
+}
+
+void FrameParser::setHostname(Observation& observation, const quint8* text, int length)
+{
+    int count = 0;
+    for (int i = 0; i < length && count < MAX_HOSTNAME; ++i) {
+        // Some clients NUL-terminate option 12
+        if (text[i] == 0) {
+            break;
+        }
+        if (text[i] > 0x20 && text[i] < 0x7F) {
+            observation.hostname[count++] = static_cast<char>(text[i]);
+        }
+    }
+    observation.hostname[count] = '\0';
+    observation.hostnameLength = count;
+}
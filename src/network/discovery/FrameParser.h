@@ -0,0 +1,75 @@
+#ifndef FRAMEPARSER_H
+#define FRAMEPARSER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Allocation-free decoder for frames that reveal LAN hosts
+ *
+ * Extracts the sender's MAC address, IPv4 address and, where the
+ * protocol carries one, its hostname from:
+ * - ARP requests and replies (sender hardware/protocol address)
+ * - DHCP client messages and server ACKs (chaddr, yiaddr/ciaddr/option 50,
+ *   option 12 hostname)
+ * - mDNS traffic (hostname from the A record for the sender's own address)
+ * - SSDP announcements, searches and replies
+ * - IPv6 neighbour discovery (RS/RA/NS/NA): the advertised or source
+ *   IPv6 address and the link-layer address option
+ *
+ * Works on the raw frame bytes and writes into a caller-provided
+ * Observation, so the capture loop does not touch the heap per packet.
+ * Ethernet (with one 802.1Q tag) and Linux cooked (SLL) link layers
+ * are understood.
+ */
+class FrameParser
+{
+public:
+    enum LinkType {
+        Ethernet = 1,           ///< DLT_EN10MB
+        LinuxCooked = 113       ///< DLT_LINUX_SLL
+    };
+
+    enum Protocol {
+        None = 0,
+        Arp = 0x01,
+        Dhcp = 0x02,
+        Mdns = 0x04,
+        Ssdp = 0x08,
+        Ndp = 0x10
+    };
+
+    static constexpr int MAX_HOSTNAME = 63;
+
+    struct Observation {
+        Protocol protocol;
+        quint8 mac[6];
+        quint32 address;                    ///< IPv4 (host byte order), 0 if not known yet
+        quint8 address6[16];                ///< IPv6 address, valid if hasAddress6
+        bool hasAddress6;
+        char hostname[MAX_HOSTNAME + 1];    ///< NUL-terminated, printable ASCII
+        int hostnameLength;
+    };
+
+    /**
+     * @brief Decode one frame
+     * @return true if the frame identified a host (observation filled in)
+     */
+    static bool parse(const quint8* frame, int length, Observation& observation, int linkType = Ethernet);
+
+private:
+    static bool parseArp(const quint8* data, int length, Observation& observation);
+    static bool parseIpv4(const quint8* data, int length, Observation& observation);
+    static bool parseIpv6(const quint8* data, int length, Observation& observation);
+    static bool parseDhcp(const quint8* data, int length, Observation& observation);
+    static bool parseMdns(const quint8* data, int length, quint32 source, Observation& observation);
+    static bool isSsdp(const quint8* data, int length);
+
+    /**
+     * @brief Read a (possibly compressed) DNS name into @p out
+     * @return Offset just past the name, -1 if malformed
+     */
+    static int readName(const quint8* data, int length, int offset, char* out, int capacity, int* written);
+    static void setHostname(Observation& observation, const quint8* text, int length);
+};
+
+#endif // FRAMEPARSER_H
@@ -1,6 +1,8 @@
 #include "HostDiscovery.h"
+#include "network/sockets/IcmpEchoEngine.h"
 #include "utils/Logger.h"
 #include <QRegularExpression>
+#include <QHostAddress>
 
 HostDiscovery::HostDiscovery(QObject *parent)
     : QObject(parent)
@@ -38,6 +40,15 @@ void HostDiscovery::pingHost(const QString& ip)
 
 bool HostDiscovery::isHostAlive(const QString& ip, int timeout)
 {
+    // Native ICMP engine: no process spawn, shared socket across threads
+    IcmpEchoEngine* engine = IcmpEchoEngine::instance();
+    bool isIpv4 = false;
+    quint32 address = QHostAddress(ip).toIPv4Address(&isIpv4);
+
+    if (engine->isAvailable() && isIpv4) {
+        return engine->echo(address, timeout).success;
+    }
+
     QProcess process;
 
 #ifdef Q_OS_WIN
@@ -0,0 +1,474 @@
+#include "Ipv6Discovery.h"
+#include "NeighborTable.h"
+#include "network/sockets/RateController.h"
+#include "utils/Logger.h"
+#include <QHostAddress>
+#include <QNetworkInterface>
+#include <QRandomGenerator>
+#include <QSet>
+#include <cstring>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <netinet/icmp6.h>
+    #include <arpa/inet.h>
+    #include <net/if.h>
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace {
+const quint8 ICMPV6_ECHO_REQUEST = 128;
+const quint8 ICMPV6_ECHO_REPLY = 129;
+const int ECHO_HEADER = 8;
+const char ECHO_PAYLOAD[] = "LanScan6";
+
+// Up, running, multicast-capable links that have IPv6 configured
+QList<QNetworkInterface> linkInterfaces(const QString& interfaceName)
+{
+    QList<QNetworkInterface> interfaces;
+    const QList<QNetworkInterface> all = QNetworkInterface::allInterfaces();
+    for (const QNetworkInterface& iface : all) {
+        if (!interfaceName.isEmpty() && iface.name() != interfaceName) {
+            continue;
+        }
+        QNetworkInterface::InterfaceFlags flags = iface.flags();
+        if (!(flags & QNetworkInterface::IsUp) || !(flags & QNetworkInterface::IsRunning)
+            || !(flags & QNetworkInterface::CanMulticast) || (flags & QNetworkInterface::IsLoopBack)) {
+            continue;
+        }
+
+        const QList<QNetworkAddressEntry> entries = iface.addressEntries();
+        for (const QNetworkAddressEntry& entry : entries) {
+            if (entry.ip().protocol() == QAbstractSocket::IPv6Protocol) {
+                interfaces.append(iface);
+                break;
+            }
+        }
+    }
+    return interfaces;
+}
+}
+
+Ipv6Discovery::Ipv6Discovery()
+    : m_multicastDestination("ff02::1")
+    , m_useNeighborTable(true)
+    , m_socketFd(-1)
+    , m_identifier(0)
+    , m_cancelled(false)
+{
+}
+
+Ipv6Discovery::~Ipv6Discovery()
+{
+    closeSocket();
+}
+
+bool Ipv6Discovery::isSupported()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Ipv6Discovery::setInterface(const QString& interfaceName)
+{
+    m_interface = interfaceName;
+}
+
+void Ipv6Discovery::setMulticastDestination(const QString& address)
+{
+    m_multicastDestination = address;
+}
+
+void Ipv6Discovery::setCandidates(const QStringList& addresses)
+{
+    m_candidates = addresses.mid(0, MAX_CANDIDATES);
+    if (addresses.size() > MAX_CANDIDATES) {
+        Logger::warn(QString("Ipv6Discovery: Probing only the first %1 of %2 candidates")
+                    .arg(MAX_CANDIDATES).arg(addresses.size()));
+    }
+}
+
+void Ipv6Discovery::setUseNeighborTable(bool enabled)
+{
+    m_useNeighborTable = enabled;
+}
+
+void Ipv6Discovery::cancel()
+{
+    m_cancelled = true;
+}
+
+QString Ipv6Discovery::transportName() const
+{
+    return m_transportName;
+}
+
+QList<Ipv6Discovery::Host> Ipv6Discovery::discover(int windowMs)
+{
+    m_hosts.clear();
+    m_sentAtUs.clear();
+    m_cancelled = false;
+
+    if (!isSupported()) {
+        return QList<Host>();
+    }
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    m_clock.start();
+
+    if (!openSocket()) {
+        Logger::warn(QString("Ipv6Discovery: No ICMPv6 socket available (%1); using the neighbour cache only")
+                    .arg(QString::fromLocal8Bit(strerror(errno))));
+    } else {
+        // All-nodes echo: one packet per link reaches every host that answers multicast
+        QHostAddress destination(m_multicastDestination);
+        if (destination.isMulticast()) {
+            const QList<QNetworkInterface> interfaces = linkInterfaces(m_interface);
+            for (const QNetworkInterface& iface : interfaces) {
+                sendEcho(m_multicastDestination, iface.index());
+            }
+        } else if (!destination.isNull()) {
+            sendEcho(m_multicastDestination, 0);
+        }
+
+        RateController* rate = RateController::instance();
+        pollfd pfd;
+        pfd.fd = m_socketFd;
+        pfd.events = POLLIN;
+
+        for (int i = 0; i < m_candidates.size() && !m_cancelled.load(); ++i) {
+            // Drain replies while waiting for rate tokens so the receive buffer never fills
+            while (!rate->tryAcquire()) {
+                if (m_cancelled.load()) {
+                    break;
+                }
+                pfd.revents = 0;
+                if (::poll(&pfd, 1, qBound(1, rate->waitTimeMs(), IDLE_WAIT_MS)) > 0) {
+                    receive();
+                }
+            }
+            sendEcho(m_candidates[i], 0);
+        }
+
+        // One collection window, counted from the last probe
+        qint64 windowEnd = m_clock.elapsed() + qMax(0, windowMs);
+        while (!m_cancelled.load()) {
+            qint64 remaining = windowEnd - m_clock.elapsed();
+            if (remaining <= 0) {
+                break;
+            }
+            pfd.revents = 0;
+            if (::poll(&pfd, 1, static_cast<int>(qMin<qint64>(remaining, IDLE_WAIT_MS))) > 0) {
+                receive();
+            }
+        }
+
+        closeSocket();
+    }
+
+    int answered = m_hosts.size();
+    if (m_useNeighborTable) {
+        mergeNeighborTable();
+    }
+
+    Logger::info(QString("Ipv6Discovery: %1 hosts (%2 answered echo, %3 candidates) in %4 ms")
+                .arg(m_hosts.size()).arg(answered).arg(m_candidates.size()).arg(m_clock.elapsed()));
+#else
+    Q_UNUSED(windowMs);
+#endif
+
+    return m_hosts.values();
+}
+
+QByteArray Ipv6Discovery::echoRequest(quint16 identifier, quint16 sequence)
+{
+    // The kernel fills in the ICMPv6 checksum on both ping and raw sockets
+    QByteArray packet(ECHO_HEADER, '\0');
+    packet[0] = static_cast<char>(ICMPV6_ECHO_REQUEST);
+    packet[4] = static_cast<char>(identifier >> 8);
+    packet[5] = static_cast<char>(identifier & 0xFF);
+    packet[6] = static_cast<char>(sequence >> 8);
+    packet[7] = static_cast<char>(sequence & 0xFF);
+    packet.append(ECHO_PAYLOAD, sizeof(ECHO_PAYLOAD) - 1);
+    return packet;
+}
+
+bool Ipv6Discovery::parseEchoReply(const quint8* data, int length, quint16 identifier, quint16* sequence)
+{
+    if (length < ECHO_HEADER || data[0] != ICMPV6_ECHO_REPLY || data[1] != 0) {
+        return false;
+    }
+
+    quint16 replyIdentifier = static_cast<quint16>((data[4] << 8) | data[5]);
+    if (identifier != 0 && replyIdentifier != identifier) {
+        return false;
+    }
+    if (sequence) {
+        *sequence = static_cast<quint16>((data[6] << 8) | data[7]);
+    }
+    return true;
+}
+
+QByteArray Ipv6Discovery::eui64InterfaceId(const QString& mac)
+{
+    QString hex;
+    hex.reserve(12);
+    for (QChar c : mac) {
+        if ((c >= '0' && c <= '9') || (c.toLower() >= 'a' && c.toLower() <= 'f')) {
+            hex.append(c);
+        } else if (c != ':' && c != '-' && c != '.') {
+            return QByteArray();
+        }
+    }
+
+    if (hex.size() != 12) {
+        return QByteArray();
+    }
+    QByteArray bytes = QByteArray::fromHex(hex.toLatin1());
+    if (bytes.size() != 6) {
+        return QByteArray();
+    }
+
+    // Flip the universal/local bit and put FFFE in the middle
+    QByteArray id(8, '\0');
+    id[0] = static_cast<char>(bytes[0] ^ 0x02);
+    id[1] = bytes[1];
+    id[2] = bytes[2];
+    id[3] = static_cast<char>(0xFF);
+    id[4] = static_cast<char>(0xFE);
+    id[5] = bytes[3];
+    id[6] = bytes[4];
+    id[7] = bytes[5];
+    return id;
+}
+
+QString Ipv6Discovery::eui64Address(const QByteArray& prefix, const QString& mac, const QString& zone)
+{
+    QByteArray id = eui64InterfaceId(mac);
+    if (prefix.size() < 8 || id.isEmpty()) {
+        return QString();
+    }
+
+    Q_IPV6ADDR bytes;
+    std::memcpy(bytes.c, prefix.constData(), 8);
+    std::memcpy(bytes.c + 8, id.constData(), 8);
+    QHostAddress address(bytes);
+    if (!zone.isEmpty()) {
+        address.setScopeId(zone);
+    }
+    return address.toString();
+}
+
+QStringList Ipv6Discovery::eui64Candidates(const QStringList& macs, const QString& interfaceName)
+{
+    // fe80::/64 on every link, plus each on-link /64 the interfaces have an address in
+    QList<QPair<QByteArray, QString>> prefixes;
+    QSet<QByteArray> globalPrefixes;
+    const QByteArray linkLocal = QByteArray::fromHex("fe80000000000000");
+
+    const QList<QNetworkInterface> interfaces = linkInterfaces(interfaceName);
+    for (const QNetworkInterface& iface : interfaces) {
+        prefixes.append(qMakePair(linkLocal, iface.name()));
+
+        const QList<QNetworkAddressEntry> entries = iface.addressEntries();
+        for (const QNetworkAddressEntry& entry : entries) {
+            QHostAddress ip = entry.ip();
+            if (ip.protocol() != QAbstractSocket::IPv6Protocol || ip.isLinkLocal() || ip.isLoopback()
+                || entry.prefixLength() > 64) {
+                continue;
+            }
+            Q_IPV6ADDR bytes = ip.toIPv6Address();
+            QByteArray prefix(reinterpret_cast<const char*>(bytes.c), 8);
+            if (!globalPrefixes.contains(prefix)) {
+                globalPrefixes.insert(prefix);
+                prefixes.append(qMakePair(prefix, QString()));
+            }
+        }
+    }
+
+    QStringList candidates;
+    for (const QString& mac : macs) {
+        for (const auto& prefix : prefixes) {
+            QString address = eui64Address(prefix.first, mac, prefix.second);
+            if (!address.isEmpty()) {
+                candidates.append(address);
+            }
+        }
+    }
+    return candidates;
+}
+
+bool Ipv6Discovery::openSocket()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    closeSocket();
+
+    // Unprivileged ping socket first, raw socket as fallback
+    m_socketFd = ::socket(AF_INET6, SOCK_DGRAM, IPPROTO_ICMPV6);
+    bool raw = false;
+    if (m_socketFd < 0) {
+        m_socketFd = ::socket(AF_INET6, SOCK_RAW, IPPROTO_ICMPV6);
+        raw = true;
+    }
+    if (m_socketFd < 0) {
+        m_transportName.clear();
+        return false;
+    }
+
+    if (raw) {
+        // The kernel would otherwise hand us every ICMPv6 message on the host
+        icmp6_filter filter;
+        ICMP6_FILTER_SETBLOCKALL(&filter);
+        ICMP6_FILTER_SETPASS(ICMPV6_ECHO_REPLY, &filter);
+        ::setsockopt(m_socketFd, IPPROTO_ICMPV6, ICMP6_FILTER, &filter, sizeof(filter));
+        m_identifier = static_cast<quint16>(QRandomGenerator::global()->bounded(1, 0xFFFF));
+        m_transportName = "raw ICMPv6 socket";
+    } else {
+        // Ping sockets rewrite the identifier and only deliver our own replies
+        m_identifier = 0;
+        m_transportName = "ICMPv6 ping socket";
+    }
+
+    int flags = ::fcntl(m_socketFd, F_GETFL, 0);
+    ::fcntl(m_socketFd, F_SETFL, flags | O_NONBLOCK);
+    ::fcntl(m_socketFd, F_SETFD, FD_CLOEXEC);
+
+    // A whole link answers the all-nodes echo at once
+    int bufferSize = 1 << 20;
+    ::setsockopt(m_socketFd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    int hops = 1;
+    ::setsockopt(m_socketFd, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &hops, sizeof(hops));
+
+    Logger::debug("Ipv6Discovery: Using " + m_transportName);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Ipv6Discovery::closeSocket()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    if (m_socketFd >= 0) {
+        ::close(m_socketFd);
+        m_socketFd = -1;
+    }
+#endif
+}
+
+bool Ipv6Discovery::sendEcho(const QString& address, int scopeId)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    QString text = address;
+    QString zone;
+    int percent = text.indexOf('%');
+    if (percent >= 0) {
+        zone = text.mid(percent + 1);
+        text.truncate(percent);
+    }
+
+    sockaddr_in6 dest;
+    std::memset(&dest, 0, sizeof(dest));
+    dest.sin6_family = AF_INET6;
+    if (::inet_pton(AF_INET6, text.toLatin1().constData(), &dest.sin6_addr) != 1) {
+        return false;
+    }
+    if (!zone.isEmpty()) {
+        scopeId = static_cast<int>(::if_nametoindex(zone.toLocal8Bit().constData()));
+        if (scopeId == 0) {
+            return false;
+        }
+    }
+    dest.sin6_scope_id = static_cast<uint32_t>(scopeId);
+
+    if (scopeId != 0 && IN6_IS_ADDR_MULTICAST(&dest.sin6_addr)) {
+        unsigned int index = static_cast<unsigned int>(scopeId);
+        ::setsockopt(m_socketFd, IPPROTO_IPV6, IPV6_MULTICAST_IF, &index, sizeof(index));
+    }
+
+    // Sequence numbers index the send times; 16 bits cover MAX_CANDIDATES plus the links
+    quint16 sequence = static_cast<quint16>(m_sentAtUs.size());
+    QByteArray packet = echoRequest(m_identifier, sequence);
+    m_sentAtUs.append(m_clock.nsecsElapsed() / 1000);
+
+    ssize_t sent = ::sendto(m_socketFd, packet.constData(), packet.size(), 0,
+                            reinterpret_cast<sockaddr*>(&dest), sizeof(dest));
+    if (sent < 0) {
+        if (errno == EAGAIN || errno == ENOBUFS) {
+            RateController::instance()->reportCongestion();
+        }
+        Logger::debug(QString("Ipv6Discovery: Echo to %1 failed (%2)")
+                     .arg(address, QString::fromLocal8Bit(strerror(errno))));
+    }
+    return sent == packet.size();
+#else
+    Q_UNUSED(address);
+    Q_UNUSED(scopeId);
+    return false;
+#endif
+}
+
+void Ipv6Discovery::receive()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    quint8 buffer[MAX_PACKET_SIZE];
+    sockaddr_in6 source;
+    socklen_t sourceLength = sizeof(source);
+
+    ssize_t received;
+    while ((received = ::recvfrom(m_socketFd, buffer, sizeof(buffer), 0,
+                                  reinterpret_cast<sockaddr*>(&source), &sourceLength)) > 0) {
+        sourceLength = sizeof(source);
+
+        // IPv6 sockets deliver the ICMPv6 message without the IP header
+        quint16 sequence = 0;
+        if (!parseEchoReply(buffer, static_cast<int>(received), m_identifier, &sequence)
+            || sequence >= m_sentAtUs.size()) {
+            continue;
+        }
+        double latencyMs = (m_clock.nsecsElapsed() / 1000 - m_sentAtUs[sequence]) / 1000.0;
+
+        QHostAddress address(reinterpret_cast<const quint8*>(source.sin6_addr.s6_addr));
+        if (address.isLinkLocal() && source.sin6_scope_id != 0) {
+            address.setScopeId(QNetworkInterface::interfaceNameFromIndex(static_cast<int>(source.sin6_scope_id)));
+        }
+        QString text = address.toString();
+
+        Host& host = m_hosts[text];
+        host.address = text;
+        host.sources |= Echo;
+        if (host.latencyMs < 0 || latencyMs < host.latencyMs) {
+            host.latencyMs = latencyMs;
+        }
+        RateController::instance()->reportResponse();
+    }
+#endif
+}
+
+void Ipv6Discovery::mergeNeighborTable()
+{
+    const QHash<QString, QString> neighbors = NeighborTable::readKernelTable6();
+    for (auto it = neighbors.constBegin(); it != neighbors.constEnd(); ++it) {
+        const QString& address = it.key();
+
+        // Link-local entries of other links are out of scope when one interface is selected
+        int percent = address.indexOf('%');
+        if (!m_interface.isEmpty() && percent >= 0 && address.mid(percent + 1) != m_interface) {
+            continue;
+        }
+
+        Host& host = m_hosts[address];
+        host.address = address;
+        host.mac = it.value();
+        host.sources |= Neighbor;
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef IPV6DISCOVERY_H
+#define IPV6DISCOVERY_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+#include <atomic>
+
+/**
+ * @brief Host discovery on IPv6 links
+ *
+ * A /64 cannot be swept address by address, so hosts are found the way
+ * routers find them:
+ *
+ * - one ICMPv6 echo request to the all-nodes group ff02::1 per interface;
+ *   every host on the link that answers multicast echo replies from its
+ *   link-local address (and, on many stacks, from its global ones);
+ * - unicast echo requests to candidate addresses, typically addresses
+ *   already seen passively or SLAAC EUI-64 addresses derived from known
+ *   MAC addresses (see eui64Candidates());
+ * - the kernel neighbour cache, read after the window closes, which the
+ *   replies above have just populated and which also lists hosts that
+ *   answered NDP but ignore multicast echo.
+ *
+ * Everything runs on one ICMPv6 socket: an unprivileged ping socket when
+ * net.ipv4.ping_group_range allows it, a raw socket (CAP_NET_RAW)
+ * otherwise. Unicast probes go through the shared RateController.
+ *
+ * Linux/macOS only (POSIX sockets); isSupported() is false elsewhere.
+ */
+class Ipv6Discovery
+{
+public:
+    enum Source {
+        Echo = 0x1,         ///< Answered an echo request
+        Neighbor = 0x2      ///< Listed in the kernel neighbour cache
+    };
+
+    struct Host {
+        QString address;    ///< Canonical text, link-local with zone ("fe80::1%eth0")
+        QString mac;        ///< Uppercase colon-separated, empty if unknown
+        double latencyMs;   ///< Echo round trip, -1 if the host did not answer
+        int sources;        ///< Source bits
+
+        Host() : latencyMs(-1.0), sources(0) {}
+    };
+
+    static constexpr int DEFAULT_WINDOW_MS = 1500;
+    static constexpr int MAX_CANDIDATES = 4096;
+
+    Ipv6Discovery();
+    ~Ipv6Discovery();
+
+    Ipv6Discovery(const Ipv6Discovery&) = delete;
+    Ipv6Discovery& operator=(const Ipv6Discovery&) = delete;
+
+    /**
+     * @brief Check whether discovery can run on this platform
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Restrict discovery to one interface (default: every multicast-capable one)
+     */
+    void setInterface(const QString& interfaceName);
+
+    /**
+     * @brief Where the multicast echo goes (default ff02::1, sent once per interface)
+     *
+     * A unicast destination is sent once, without a scope.
+     */
+    void setMulticastDestination(const QString& address);
+
+    /**
+     * @brief Addresses to probe with unicast echo (capped at MAX_CANDIDATES)
+     */
+    void setCandidates(const QStringList& addresses);
+
+    /**
+     * @brief Merge the kernel neighbour cache into the results (default true)
+     */
+    void setUseNeighborTable(bool enabled);
+
+    /**
+     * @brief Probe and collect replies for @p windowMs, blocking the caller
+     * @return Hosts found; empty if unsupported or no socket could be opened
+     */
+    QList<Host> discover(int windowMs = DEFAULT_WINDOW_MS);
+
+    /**
+     * @brief Stop a running discover() early (thread-safe)
+     */
+    void cancel();
+
+    /**
+     * @brief Name of the socket used by the last discover(), empty if none
+     */
+    QString transportName() const;
+
+    // Wire format helpers (public for tests)
+    static QByteArray echoRequest(quint16 identifier, quint16 sequence);
+
+    /**
+     * @brief Check an ICMPv6 message for an echo reply
+     * @param identifier Expected identifier, 0 to accept any (ping sockets filter in the kernel)
+     */
+    static bool parseEchoReply(const quint8* data, int length, quint16 identifier, quint16* sequence);
+
+    /**
+     * @brief Modified EUI-64 interface identifier of a MAC address (RFC 4291 appendix A)
+     * @return 8 bytes, empty if @p mac is not a valid MAC address
+     */
+    static QByteArray eui64InterfaceId(const QString& mac);
+
+    /**
+     * @brief SLAAC address a host with @p mac would form in @p prefix (first 8 bytes used)
+     * @return Canonical text with @p zone appended if given, empty on invalid input
+     */
+    static QString eui64Address(const QByteArray& prefix, const QString& mac, const QString& zone = QString());
+
+    /**
+     * @brief EUI-64 addresses for @p macs in fe80::/64 and every /64 on the interface(s)
+     */
+    static QStringList eui64Candidates(const QStringList& macs, const QString& interfaceName = QString());
+
+private:
+    static constexpr int MAX_PACKET_SIZE = 1280;
+    static constexpr int IDLE_WAIT_MS = 50;
+
+    QString m_interface;
+    QString m_multicastDestination;
+    QStringList m_candidates;
+    bool m_useNeighborTable;
+
+    int m_socketFd;
+    quint16 m_identifier;
+    QString m_transportName;
+    std::atomic<bool> m_cancelled;
+    QElapsedTimer m_clock;
+
+    QVector<qint64> m_sentAtUs;         ///< Indexed by sequence number
+    QHash<QString, Host> m_hosts;
+
+    bool openSocket();
+    void closeSocket();
+    QList<int> interfaceIndexes() const;
+    bool sendEcho(const QString& address, int scopeId);
+    void receive();
+    void mergeNeighborTable();
+};
+
+#endif // IPV6DISCOVERY_H
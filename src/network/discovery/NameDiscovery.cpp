@@ -0,0 +1,614 @@
+#include "NameDiscovery.h"
+#include "PtrResolver.h"
+#include "network/sockets/RateController.h"
+#include "utils/Logger.h"
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+#include <cstring>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace {
+const int DNS_HEADER_SIZE = 12;
+const quint16 DNS_FLAG_RESPONSE = 0x8000;
+const quint16 DNS_TYPE_A = 1;
+const quint16 DNS_TYPE_PTR = 12;
+const quint16 NETBIOS_TYPE_NBSTAT = 0x21;
+const int NETBIOS_NAME_ENTRY = 18;              // 15 name bytes, suffix, flags
+const quint16 NETBIOS_GROUP_FLAG = 0x8000;
+const int MDNS_QUESTIONS_PER_PACKET = 32;       // Longest reverse question is 33 bytes
+const char* SERVICES_NAME = "_services._dns-sd._udp.local";
+
+quint16 readU16(const quint8* data)
+{
+    return static_cast<quint16>((data[0] << 8) | data[1]);
+}
+
+void appendU16(QByteArray& data, quint16 value)
+{
+    data.append(static_cast<char>(value >> 8));
+    data.append(static_cast<char>(value & 0xFF));
+}
+
+void appendName(QByteArray& data, const QString& name)
+{
+    const QStringList labels = name.split('.', Qt::SkipEmptyParts);
+    for (const QString& label : labels) {
+        QByteArray bytes = label.toUtf8().left(63);
+        data.append(static_cast<char>(bytes.size()));
+        data.append(bytes);
+    }
+    data.append('\0');
+}
+
+QByteArray header(quint16 id, int questions)
+{
+    QByteArray data;
+    data.reserve(512);
+    appendU16(data, id);
+    appendU16(data, 0);                         // Standard query, no flags
+    appendU16(data, static_cast<quint16>(questions));
+    data.append("\x00\x00\x00\x00\x00\x00", 6);
+    return data;
+}
+
+// d.c.b.a.in-addr.arpa -> a.b.c.d
+bool addressFromReverseName(const QString& name, quint32& address)
+{
+    const QStringList labels = name.split('.');
+    if (labels.size() != 6 || labels[4].compare("in-addr", Qt::CaseInsensitive) != 0
+        || labels[5].compare("arpa", Qt::CaseInsensitive) != 0) {
+        return false;
+    }
+
+    address = 0;
+    for (int i = 0; i < 4; ++i) {
+        bool ok = false;
+        uint octet = labels[i].toUInt(&ok);
+        if (!ok || octet > 255) {
+            return false;
+        }
+        address |= octet << (8 * i);
+    }
+    return true;
+}
+
+// Names end up in tables and the database: drop the trailing dot and anything unprintable
+QString cleanName(const QString& name)
+{
+    QString clean;
+    clean.reserve(name.size());
+    for (QChar c : name) {
+        if (c.isPrint() && !c.isSpace()) {
+            clean.append(c);
+        }
+    }
+    while (clean.endsWith('.')) {
+        clean.chop(1);
+    }
+    return clean;
+}
+}
+
+NameDiscovery::NameDiscovery()
+    : m_mdnsAddress(MDNS_GROUP)
+    , m_mdnsPort(MDNS_PORT)
+    , m_llmnrPort(LLMNR_PORT)
+    , m_netbiosPort(NETBIOS_PORT)
+    , m_socketFd(-1)
+    , m_worker(nullptr)
+    , m_running(false)
+    , m_cancelled(false)
+    , m_windowMs(DEFAULT_WINDOW_MS)
+{
+}
+
+NameDiscovery::~NameDiscovery()
+{
+    cancel();
+    if (m_worker) {
+        m_worker->wait();
+        delete m_worker;
+    }
+    closeSocket();
+}
+
+bool NameDiscovery::isSupported()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void NameDiscovery::setMdnsDestination(quint32 address, quint16 port)
+{
+    m_mdnsAddress = address;
+    m_mdnsPort = port;
+}
+
+void NameDiscovery::setUnicastPorts(quint16 llmnrPort, quint16 netbiosPort)
+{
+    m_llmnrPort = llmnrPort;
+    m_netbiosPort = netbiosPort;
+}
+
+void NameDiscovery::setCallback(Callback callback)
+{
+    m_callback = std::move(callback);
+}
+
+bool NameDiscovery::start(const QVector<quint32>& addresses, int windowMs)
+{
+    if (!isSupported() || m_running.load()) {
+        return false;
+    }
+
+    if (m_worker) {
+        m_worker->wait();
+        delete m_worker;
+        m_worker = nullptr;
+    }
+
+    if (!openSocket()) {
+        Logger::warn("NameDiscovery: Failed to open UDP socket");
+        return false;
+    }
+
+    m_targets = addresses;
+    m_targetSet = QSet<quint32>(addresses.constBegin(), addresses.constEnd());
+    m_directQueried.clear();
+    m_windowMs = qMax(0, windowMs);
+    m_cancelled = false;
+    m_running = true;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_names.clear();
+    }
+
+    m_worker = QThread::create([this]() { run(); });
+    m_worker->start();
+
+    Logger::debug(QString("NameDiscovery: Querying %1 hosts over mDNS, LLMNR and NetBIOS (%2 ms window)")
+                 .arg(addresses.size()).arg(m_windowMs));
+    return true;
+}
+
+bool NameDiscovery::wait(int timeoutMs)
+{
+    if (!m_worker) {
+        return true;
+    }
+    return m_worker->wait(timeoutMs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(timeoutMs));
+}
+
+void NameDiscovery::cancel()
+{
+    m_cancelled = true;
+}
+
+bool NameDiscovery::isRunning() const
+{
+    return m_running.load();
+}
+
+QString NameDiscovery::hostname(quint32 address) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_names.constFind(address);
+    return it == m_names.constEnd() ? QString() : it->hostname;
+}
+
+QHash<quint32, QString> NameDiscovery::names() const
+{
+    QMutexLocker locker(&m_mutex);
+    QHash<quint32, QString> names;
+    names.reserve(m_names.size());
+    for (auto it = m_names.constBegin(); it != m_names.constEnd(); ++it) {
+        names.insert(it.key(), it->hostname);
+    }
+    return names;
+}
+
+QByteArray NameDiscovery::mdnsQuery(const QVector<quint32>& addresses, bool enumerateServices)
+{
+    QByteArray query = header(0, addresses.size() + (enumerateServices ? 1 : 0));
+
+    if (enumerateServices) {
+        appendName(query, SERVICES_NAME);
+        appendU16(query, DNS_TYPE_PTR);
+        appendU16(query, 1);
+    }
+    for (quint32 address : addresses) {
+        appendName(query, PtrResolver::reverseName(address));
+        appendU16(query, DNS_TYPE_PTR);
+        appendU16(query, 1);
+    }
+    return query;
+}
+
+QByteArray NameDiscovery::llmnrQuery(quint16 id, quint32 address)
+{
+    // Same wire format as DNS; the RD position is LLMNR's T bit and must be clear
+    QByteArray query = PtrResolver::buildQuery(id, address);
+    query[2] = '\0';
+    query[3] = '\0';
+    return query;
+}
+
+QByteArray NameDiscovery::nodeStatusQuery(quint16 id)
+{
+    QByteArray query = header(id, 1);
+
+    // "*" padded with NULs, first-level encoded (RFC 1002 4.1)
+    query.append('\x20');
+    query.append("CK");
+    query.append(QByteArray(30, 'A'));
+    query.append('\0');
+
+    appendU16(query, NETBIOS_TYPE_NBSTAT);
+    appendU16(query, 1);
+    return query;
+}
+
+QList<NameDiscovery::NameResult> NameDiscovery::parseMdns(const quint8* data, int length, bool* servicesAnswered)
+{
+    QList<NameResult> results;
+    if (servicesAnswered) {
+        *servicesAnswered = false;
+    }
+
+    if (length < DNS_HEADER_SIZE || !(readU16(data + 2) & DNS_FLAG_RESPONSE)) {
+        return results;
+    }
+
+    int questions = readU16(data + 4);
+    int records = readU16(data + 6) + readU16(data + 8) + readU16(data + 10);
+    int offset = DNS_HEADER_SIZE;
+
+    for (int i = 0; i < questions; ++i) {
+        if (!PtrResolver::readName(data, length, offset, nullptr) || offset + 4 > length) {
+            return results;
+        }
+        offset += 4;
+    }
+
+    for (int i = 0; i < records; ++i) {
+        QString owner;
+        if (!PtrResolver::readName(data, length, offset, &owner) || offset + 10 > length) {
+            break;
+        }
+
+        quint16 type = readU16(data + offset);
+        int rdLength = readU16(data + offset + 8);
+        int rdata = offset + 10;
+        if (rdata + rdLength > length) {
+            break;
+        }
+        offset = rdata + rdLength;
+
+        if (type == DNS_TYPE_PTR) {
+            if (owner.compare(SERVICES_NAME, Qt::CaseInsensitive) == 0) {
+                if (servicesAnswered) {
+                    *servicesAnswered = true;
+                }
+                continue;
+            }
+
+            quint32 address;
+            QString target;
+            int nameOffset = rdata;
+            if (addressFromReverseName(owner, address)
+                && PtrResolver::readName(data, length, nameOffset, &target)) {
+                target = cleanName(target);
+                if (!target.isEmpty()) {
+                    results.append(NameResult(address, target, Mdns));
+                }
+            }
+        } else if (type == DNS_TYPE_A && rdLength == 4) {
+            quint32 address = (static_cast<quint32>(data[rdata]) << 24) | (static_cast<quint32>(data[rdata + 1]) << 16)
+                            | (static_cast<quint32>(data[rdata + 2]) << 8) | data[rdata + 3];
+            QString name = cleanName(owner);
+            if (!name.isEmpty()) {
+                results.append(NameResult(address, name, Mdns));
+            }
+        }
+    }
+
+    return results;
+}
+
+QString NameDiscovery::parseLlmnr(const quint8* data, int length, quint32 address)
+{
+    PtrResolver::Response response;
+    if (!PtrResolver::parseResponse(data, length, response) || response.rcode != 0) {
+        return QString();
+    }
+
+    // The question must be the reverse name we asked this host for
+    if (response.questionName.compare(PtrResolver::reverseName(address), Qt::CaseInsensitive) != 0) {
+        return QString();
+    }
+    return cleanName(response.hostname);
+}
+
+QString NameDiscovery::parseNodeStatus(const quint8* data, int length)
+{
+    if (length < DNS_HEADER_SIZE || !(readU16(data + 2) & DNS_FLAG_RESPONSE) || readU16(data + 6) < 1) {
+        return QString();
+    }
+
+    int offset = DNS_HEADER_SIZE;
+    if (!PtrResolver::readName(data, length, offset, nullptr) || offset + 10 > length) {
+        return QString();
+    }
+    if (readU16(data + offset) != NETBIOS_TYPE_NBSTAT) {
+        return QString();
+    }
+
+    int rdLength = readU16(data + offset + 8);
+    int rdata = offset + 10;
+    int end = qMin(length, rdata + rdLength);
+    if (rdata >= end) {
+        return QString();
+    }
+
+    int count = data[rdata];
+    QString fallback;
+
+    for (int i = 0; i < count; ++i) {
+        int entry = rdata + 1 + i * NETBIOS_NAME_ENTRY;
+        if (entry + NETBIOS_NAME_ENTRY > end) {
+            break;
+        }
+
+        quint8 suffix = data[entry + 15];
+        bool group = readU16(data + entry + 16) & NETBIOS_GROUP_FLAG;
+        if (group) {
+            continue;
+        }
+
+        QString name = cleanName(QString::fromLatin1(reinterpret_cast<const char*>(data + entry), 15));
+        if (name.isEmpty()) {
+            continue;
+        }
+
+        // Suffix 0x00 is the workstation service: the machine name
+        if (suffix == 0x00) {
+            return name;
+        }
+        if (fallback.isEmpty()) {
+            fallback = name;
+        }
+    }
+
+    return fallback;
+}
+
+bool NameDiscovery::openSocket()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    closeSocket();
+
+    m_socketFd = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (m_socketFd < 0) {
+        return false;
+    }
+
+    int flags = ::fcntl(m_socketFd, F_GETFL, 0);
+    ::fcntl(m_socketFd, F_SETFL, flags | O_NONBLOCK);
+    ::fcntl(m_socketFd, F_SETFD, FD_CLOEXEC);
+
+    // Link-local multicast: mDNS expects TTL 255
+    unsigned char ttl = 255;
+    ::setsockopt(m_socketFd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+
+    // A /22 of answers can arrive at once
+    int bufferSize = 1 << 20;
+    ::setsockopt(m_socketFd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    // Ephemeral source port: responders treat the queries as one-shot and answer unicast
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (::bind(m_socketFd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) {
+        closeSocket();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void NameDiscovery::closeSocket()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    if (m_socketFd >= 0) {
+        ::close(m_socketFd);
+        m_socketFd = -1;
+    }
+#endif
+}
+
+void NameDiscovery::run()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    m_clock.start();
+    sendQueries();
+
+    // One collection window for the whole segment, counted from the last query
+    qint64 windowEnd = m_clock.elapsed() + m_windowMs;
+    pollfd pfd;
+    pfd.fd = m_socketFd;
+    pfd.events = POLLIN;
+
+    while (!m_cancelled.load()) {
+        qint64 remaining = windowEnd - m_clock.elapsed();
+        if (remaining <= 0) {
+            break;
+        }
+
+        pfd.revents = 0;
+        int ready = ::poll(&pfd, 1, static_cast<int>(qMin<qint64>(remaining, IDLE_WAIT_MS)));
+        if (ready > 0) {
+            receive();
+        }
+    }
+
+    closeSocket();
+
+    int found;
+    {
+        QMutexLocker locker(&m_mutex);
+        found = m_names.size();
+    }
+    Logger::info(QString("NameDiscovery: %1 of %2 hosts named in %3 ms")
+                .arg(found).arg(m_targets.size()).arg(m_clock.elapsed()));
+#endif
+    m_running = false;
+}
+
+bool NameDiscovery::sendTo(quint32 address, quint16 port, const QByteArray& data)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    sockaddr_in dest;
+    std::memset(&dest, 0, sizeof(dest));
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(port);
+    dest.sin_addr.s_addr = htonl(address);
+
+    ssize_t sent = ::sendto(m_socketFd, data.constData(), data.size(), 0,
+                            reinterpret_cast<sockaddr*>(&dest), sizeof(dest));
+    if (sent < 0 && (errno == EAGAIN || errno == ENOBUFS)) {
+        RateController::instance()->reportCongestion();
+    }
+    return sent == data.size();
+#else
+    Q_UNUSED(address);
+    Q_UNUSED(port);
+    Q_UNUSED(data);
+    return false;
+#endif
+}
+
+void NameDiscovery::sendQueries()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    // mDNS: a handful of multicast packets cover the whole target set
+    int first = 0;
+    do {
+        sendTo(m_mdnsAddress, m_mdnsPort, mdnsQuery(m_targets.mid(first, MDNS_QUESTIONS_PER_PACKET), first == 0));
+        first += MDNS_QUESTIONS_PER_PACKET;
+    } while (first < m_targets.size());
+
+    // LLMNR and NetBIOS have no usable multicast form: one unicast query per host each
+    const QByteArray nodeStatus = nodeStatusQuery(0x4C53);
+    RateController* rate = RateController::instance();
+    pollfd pfd;
+    pfd.fd = m_socketFd;
+    pfd.events = POLLIN;
+
+    for (int i = 0; i < m_targets.size() && !m_cancelled.load(); ++i) {
+        // Drain answers while waiting for rate tokens so the receive buffer never fills
+        while (!rate->tryAcquire(2)) {
+            if (m_cancelled.load()) {
+                return;
+            }
+            pfd.revents = 0;
+            if (::poll(&pfd, 1, qBound(1, rate->waitTimeMs(2), IDLE_WAIT_MS)) > 0) {
+                receive();
+            }
+        }
+
+        quint32 address = m_targets[i];
+        sendTo(address, m_netbiosPort, nodeStatus);
+        sendTo(address, m_llmnrPort, llmnrQuery(static_cast<quint16>(i), address));
+    }
+#endif
+}
+
+void NameDiscovery::receive()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    static thread_local quint8 buffer[MAX_MESSAGE_SIZE];
+    sockaddr_in source;
+    socklen_t sourceLength = sizeof(source);
+
+    ssize_t received;
+    while ((received = ::recvfrom(m_socketFd, buffer, sizeof(buffer), 0,
+                                  reinterpret_cast<sockaddr*>(&source), &sourceLength)) > 0) {
+        handleDatagram(ntohl(source.sin_addr.s_addr), ntohs(source.sin_port),
+                       buffer, static_cast<int>(received));
+        sourceLength = sizeof(source);
+    }
+#endif
+}
+
+void NameDiscovery::handleDatagram(quint32 source, quint16 port, const quint8* data, int length)
+{
+    if (port == m_netbiosPort) {
+        if (m_targetSet.contains(source)) {
+            QString name = parseNodeStatus(data, length);
+            if (!name.isEmpty()) {
+                store(NameResult(source, name, NetBios));
+            }
+        }
+        return;
+    }
+
+    if (port == m_llmnrPort) {
+        QString name = parseLlmnr(data, length, source);
+        if (!name.isEmpty() && m_targetSet.contains(source)) {
+            store(NameResult(source, name, Llmnr));
+        }
+        return;
+    }
+
+    bool servicesAnswered = false;
+    const QList<NameResult> results = parseMdns(data, length, &servicesAnswered);
+    for (const NameResult& result : results) {
+        if (m_targetSet.contains(result.address)) {
+            store(result);
+        }
+    }
+
+    // An mDNS speaker that only listed its services: ask it directly for its own name
+    if (servicesAnswered && m_targetSet.contains(source) && !m_directQueried.contains(source)
+        && hostname(source).isEmpty()) {
+        m_directQueried.insert(source);
+        sendTo(source, port, mdnsQuery(QVector<quint32>() << source, false));
+    }
+}
+
+void NameDiscovery::store(const NameResult& result)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_names.find(result.address);
+        if (it != m_names.end() && it->source >= result.source) {
+            return;
+        }
+        m_names.insert(result.address, result);
+    }
+
+    Logger::debug(QString("NameDiscovery: %1.%2.%3.%4 -> %5")
+                 .arg(result.address >> 24).arg((result.address >> 16) & 0xFF)
+                 .arg((result.address >> 8) & 0xFF).arg(result.address & 0xFF)
+                 .arg(result.hostname));
+
+    if (m_callback) {
+        m_callback(result);
+    }
+}
@@ -0,0 +1,173 @@
+#ifndef NAMEDISCOVERY_H
+#define NAMEDISCOVERY_H
+
+#include <QString>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QThread>
+#include <QElapsedTimer>
+#include <functional>
+#include <atomic>
+
+/**
+ * @brief Bulk hostname discovery over mDNS, LLMNR and NetBIOS
+ *
+ * Most LAN devices have no reverse DNS but answer one of the link-local
+ * name protocols. Instead of a PTR lookup per host, one pass collects
+ * names for a whole segment in a single window:
+ *
+ * - mDNS: one-shot queries to 224.0.0.251 for _services._dns-sd._udp.local
+ *   plus reverse PTR questions packed many per packet; every mDNS speaker
+ *   that answers the service enumeration without a name gets a direct
+ *   reverse query. A records in any answer are used as well.
+ * - LLMNR: reverse PTR query sent unicast to each target (RFC 4795 does
+ *   not allow reverse queries on the multicast address).
+ * - NetBIOS: node status query to each target; the unique workstation
+ *   name from the name table is used.
+ *
+ * When a host answers more than one protocol, mDNS wins over LLMNR and
+ * LLMNR over NetBIOS. Everything runs on one UDP socket and a worker
+ * thread; unicast sends go through the shared RateController.
+ *
+ * Linux/macOS only (POSIX sockets); isSupported() is false elsewhere.
+ */
+class NameDiscovery
+{
+public:
+    enum Source {
+        NetBios,        ///< Lowest preference
+        Llmnr,
+        Mdns
+    };
+
+    struct NameResult {
+        quint32 address;    ///< IPv4 address (host byte order)
+        QString hostname;
+        Source source;
+
+        NameResult() : address(0), source(NetBios) {}
+        NameResult(quint32 address, const QString& hostname, Source source)
+            : address(address), hostname(hostname), source(source) {}
+    };
+
+    using Callback = std::function<void(const NameResult&)>;
+
+    static constexpr int DEFAULT_WINDOW_MS = 1500;
+    static constexpr int MAX_TARGETS = 4096;            ///< Larger target sets fall back to PTR only
+    static constexpr quint32 MDNS_GROUP = 0xE00000FB;   ///< 224.0.0.251
+    static constexpr quint16 MDNS_PORT = 5353;
+    static constexpr quint16 LLMNR_PORT = 5355;
+    static constexpr quint16 NETBIOS_PORT = 137;
+
+    NameDiscovery();
+    ~NameDiscovery();
+
+    NameDiscovery(const NameDiscovery&) = delete;
+    NameDiscovery& operator=(const NameDiscovery&) = delete;
+
+    /**
+     * @brief Check whether discovery can run on this platform
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Where the multicast mDNS queries go (default 224.0.0.251:5353)
+     */
+    void setMdnsDestination(quint32 address, quint16 port);
+
+    /**
+     * @brief Target ports of the unicast LLMNR and NetBIOS queries
+     */
+    void setUnicastPorts(quint16 llmnrPort, quint16 netbiosPort);
+
+    /**
+     * @brief Called on the worker thread whenever a name is found or improved
+     */
+    void setCallback(Callback callback);
+
+    /**
+     * @brief Send the queries and collect answers for @p windowMs in the background
+     * @return false if already running, unsupported or the socket failed
+     */
+    bool start(const QVector<quint32>& addresses, int windowMs = DEFAULT_WINDOW_MS);
+
+    /**
+     * @brief Block until the collection window closes
+     * @param timeoutMs Longest wait, -1 for no limit
+     * @return true if discovery has finished
+     */
+    bool wait(int timeoutMs = -1);
+
+    /**
+     * @brief Stop early; names found so far stay available
+     */
+    void cancel();
+
+    bool isRunning() const;
+
+    /**
+     * @brief Best name found for an address, empty if none
+     */
+    QString hostname(quint32 address) const;
+    QHash<quint32, QString> names() const;
+
+    // Wire format helpers (public for tests)
+    static QByteArray mdnsQuery(const QVector<quint32>& addresses, bool enumerateServices);
+    static QByteArray llmnrQuery(quint16 id, quint32 address);
+    static QByteArray nodeStatusQuery(quint16 id);
+
+    /**
+     * @brief Address/name pairs from an mDNS response (reverse PTR and A records)
+     * @param servicesAnswered Set when the response enumerates DNS-SD services
+     */
+    static QList<NameResult> parseMdns(const quint8* data, int length, bool* servicesAnswered = nullptr);
+
+    /**
+     * @brief Hostname from an LLMNR reverse answer for @p address
+     */
+    static QString parseLlmnr(const quint8* data, int length, quint32 address);
+
+    /**
+     * @brief Workstation name from a NetBIOS node status response
+     */
+    static QString parseNodeStatus(const quint8* data, int length);
+
+private:
+    static constexpr int MAX_PACKET_SIZE = 1200;
+    static constexpr int MAX_MESSAGE_SIZE = 9000;       ///< mDNS allows jumbo responses
+    static constexpr int IDLE_WAIT_MS = 50;
+
+    quint32 m_mdnsAddress;
+    quint16 m_mdnsPort;
+    quint16 m_llmnrPort;
+    quint16 m_netbiosPort;
+
+    int m_socketFd;
+    QThread* m_worker;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_cancelled;
+
+    QVector<quint32> m_targets;
+    QSet<quint32> m_targetSet;
+    QSet<quint32> m_directQueried;      ///< mDNS speakers already sent a direct reverse query
+    int m_windowMs;
+    QElapsedTimer m_clock;
+
+    mutable QMutex m_mutex;             ///< Guards m_names
+    QHash<quint32, NameResult> m_names;
+    Callback m_callback;
+
+    bool openSocket();
+    void closeSocket();
+    void run();
+    bool sendTo(quint32 address, quint16 port, const QByteArray& data);
+    void sendQueries();
+    void receive();
+    void handleDatagram(quint32 source, quint16 port, const quint8* data, int length);
+    void store(const NameResult& result);
+};
+
+#endif // NAMEDISCOVERY_H
@@ -0,0 +1,437 @@
+#include "NeighborTable.h"
+#include "ArpDiscovery.h"
+#include "utils/Logger.h"
+#include <QFile>
+#include <QHostAddress>
+#include <QNetworkInterface>
+#include <QMutexLocker>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <linux/netlink.h>
+    #include <linux/rtnetlink.h>
+    #include <linux/neighbour.h>
+    #include <arpa/inet.h>
+    #include <unistd.h>
+#endif
+
+NeighborTable::NeighborTable()
+    : m_interfacesLoaded(false)
+    , m_lastRefreshStart(-1)
+    , m_refreshCount(0)
+{
+    m_clock.start();
+}
+
+NeighborTable* NeighborTable::instance()
+{
+    // Function-local static: initialized once, thread-safe
+    static NeighborTable* table = new NeighborTable();
+    return table;
+}
+
+void NeighborTable::beginScan()
+{
+    loadInterfaces();
+
+    QMutexLocker refreshLocker(&m_refreshMutex);
+    qint64 start = m_clock.nsecsElapsed();
+    QHash<quint32, QString> table = readKernelTable();
+
+    QMutexLocker locker(&m_mutex);
+    m_neighbors = table;
+    m_lastRefreshStart = start;
+    m_refreshCount++;
+
+    Logger::debug(QString("NeighborTable: Snapshot with %1 entries").arg(m_neighbors.size()));
+}
+
+QString NeighborTable::macAddress(const QString& ip)
+{
+    QString localMac = localMacAddress(ip);
+    if (!localMac.isEmpty()) {
+        return localMac;
+    }
+
+    bool isIpv4 = false;
+    quint32 address = QHostAddress(ip).toIPv4Address(&isIpv4);
+    if (!isIpv4) {
+        return QString();
+    }
+
+    qint64 requestedAt = m_clock.nsecsElapsed();
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_neighbors.constFind(address);
+        if (it != m_neighbors.constEnd()) {
+            return it.value();
+        }
+    }
+
+    // Entry may have appeared since the last read (host just answered a probe)
+    refresh(requestedAt);
+
+    QMutexLocker locker(&m_mutex);
+    return m_neighbors.value(address);
+}
+
+QString NeighborTable::localMacAddress(const QString& ip)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_interfacesLoaded) {
+            return m_localMacs.value(ip);
+        }
+    }
+
+    loadInterfaces();
+
+    QMutexLocker locker(&m_mutex);
+    return m_localMacs.value(ip);
+}
+
+int NeighborTable::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_neighbors.size();
+}
+
+int NeighborTable::refreshCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_refreshCount;
+}
+
+void NeighborTable::refresh(qint64 requestedAt)
+{
+    QMutexLocker refreshLocker(&m_refreshMutex);
+
+    {
+        // A read that started after this request already covers it
+        QMutexLocker locker(&m_mutex);
+        if (m_lastRefreshStart >= requestedAt) {
+            return;
+        }
+    }
+
+    qint64 start = m_clock.nsecsElapsed();
+    QHash<quint32, QString> table = readKernelTable();
+
+    // Merge: entries are added or updated, never dropped mid-scan
+    QMutexLocker locker(&m_mutex);
+    for (auto it = table.constBegin(); it != table.constEnd(); ++it) {
+        m_neighbors.insert(it.key(), it.value());
+    }
+    m_lastRefreshStart = start;
+    m_refreshCount++;
+}
+
+void NeighborTable::loadInterfaces()
+{
+    QHash<QString, QString> localMacs;
+
+    for (const QNetworkInterface& iface : QNetworkInterface::allInterfaces()) {
+        if (iface.flags() & QNetworkInterface::IsLoopBack) {
+            continue;
+        }
+
+        QString mac = iface.hardwareAddress();
+        if (mac.isEmpty()) {
+            continue;
+        }
+
+        for (const QNetworkAddressEntry& entry : iface.addressEntries()) {
+            localMacs.insert(entry.ip().toString(), mac);
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_localMacs = localMacs;
+    m_interfacesLoaded = true;
+}
+
+QHash<quint32, QString> NeighborTable::readKernelTable()
+{
+#ifdef Q_OS_LINUX
+    bool ok = false;
+    QHash<quint32, QString> table = readNetlink(ok);
+    if (ok) {
+        return table;
+    }
+
+    Logger::debug("NeighborTable: rtnetlink unavailable, reading /proc/net/arp");
+    return readProcNetArp();
+#else
+    QHash<quint32, QString> table;
+    QMap<QString, QString> arpTable = ArpDiscovery::getArpTable();
+    for (auto it = arpTable.constBegin(); it != arpTable.constEnd(); ++it) {
+        bool isIpv4 = false;
+        quint32 address = QHostAddress(it.key()).toIPv4Address(&isIpv4);
+        if (isIpv4) {
+            table.insert(address, it.value());
+        }
+    }
+    return table;
+#endif
+}
+
+QHash<quint32, QString> NeighborTable::readNetlink(bool& ok)
+{
+    QHash<quint32, QString> table;
+#ifdef Q_OS_LINUX
+    ok = dumpNeighbors(AF_INET, [&table](const char* data, int length) {
+        return parseNeighborDump(data, length, table);
+    });
+#else
+    ok = false;
+#endif
+    return table;
+}
+
+QHash<QString, QString> NeighborTable::readKernelTable6()
+{
+    QHash<QString, QString> table;
+#ifdef Q_OS_LINUX
+    if (!dumpNeighbors(AF_INET6, [&table](const char* data, int length) {
+            return parseNeighborDump6(data, length, table);
+        })) {
+        Logger::debug("NeighborTable: IPv6 neighbour dump failed");
+    }
+#endif
+    return table;
+}
+
+bool NeighborTable::dumpNeighbors(int family, const std::function<int(const char*, int)>& parse)
+{
+#ifdef Q_OS_LINUX
+    int fd = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) {
+        return false;
+    }
+
+    timeval timeout;
+    timeout.tv_sec = 1;
+    timeout.tv_usec = 0;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct {
+        nlmsghdr header;
+        ndmsg message;
+    } request;
+    std::memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(ndmsg));
+    request.header.nlmsg_type = RTM_GETNEIGH;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = 1;
+    request.message.ndm_family = static_cast<unsigned char>(family);
+
+    sockaddr_nl kernel;
+    std::memset(&kernel, 0, sizeof(kernel));
+    kernel.nl_family = AF_NETLINK;
+
+    if (::sendto(fd, &request, request.header.nlmsg_len, 0,
+                 reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // Aligned for nlmsghdr; a dump arrives as several datagrams
+    alignas(nlmsghdr) char buffer[32768];
+    int status = 1;
+
+    while (status > 0) {
+        ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            status = -1;
+            break;
+        }
+        status = parse(buffer, static_cast<int>(received));
+    }
+
+    ::close(fd);
+    return status == 0;
+#else
+    Q_UNUSED(family);
+    Q_UNUSED(parse);
+    return false;
+#endif
+}
+
+int NeighborTable::parseNeighborDump(const char* data, int length, QHash<quint32, QString>& table)
+{
+#ifdef Q_OS_LINUX
+    const nlmsghdr* header = reinterpret_cast<const nlmsghdr*>(data);
+    int remaining = length;
+
+    for (; NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+        if (header->nlmsg_type == NLMSG_DONE) {
+            return 0;
+        }
+        if (header->nlmsg_type == NLMSG_ERROR) {
+            return -1;
+        }
+        if (header->nlmsg_type != RTM_NEWNEIGH
+            || header->nlmsg_len < NLMSG_LENGTH(sizeof(ndmsg))) {
+            continue;
+        }
+
+        const ndmsg* neighbor = static_cast<const ndmsg*>(NLMSG_DATA(header));
+        if (neighbor->ndm_family != AF_INET
+            || (neighbor->ndm_state & (NUD_INCOMPLETE | NUD_FAILED | NUD_NOARP))) {
+            continue;
+        }
+
+        quint32 address = 0;
+        bool hasAddress = false;
+        QString mac;
+
+        const rtattr* attribute = reinterpret_cast<const rtattr*>(
+            reinterpret_cast<const char*>(neighbor) + NLMSG_ALIGN(sizeof(ndmsg)));
+        int attributeLength = static_cast<int>(header->nlmsg_len - NLMSG_LENGTH(sizeof(ndmsg)));
+
+        for (; RTA_OK(attribute, attributeLength); attribute = RTA_NEXT(attribute, attributeLength)) {
+            if (attribute->rta_type == NDA_DST && RTA_PAYLOAD(attribute) == sizeof(quint32)) {
+                quint32 networkOrder;
+                std::memcpy(&networkOrder, RTA_DATA(attribute), sizeof(networkOrder));
+                address = ntohl(networkOrder);
+                hasAddress = true;
+            } else if (attribute->rta_type == NDA_LLADDR && RTA_PAYLOAD(attribute) == MAC_LENGTH) {
+                mac = formatMac(static_cast<const quint8*>(RTA_DATA(attribute)));
+            }
+        }
+
+        if (hasAddress && !mac.isEmpty()) {
+            table.insert(address, mac);
+        }
+    }
+
+    return 1;
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(length);
+    Q_UNUSED(table);
+    return -1;
+#endif
+}
+
+int NeighborTable::parseNeighborDump6(const char* data, int length, QHash<QString, QString>& table)
+{
+#ifdef Q_OS_LINUX
+    const nlmsghdr* header = reinterpret_cast<const nlmsghdr*>(data);
+    int remaining = length;
+
+    for (; NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+        if (header->nlmsg_type == NLMSG_DONE) {
+            return 0;
+        }
+        if (header->nlmsg_type == NLMSG_ERROR) {
+            return -1;
+        }
+        if (header->nlmsg_type != RTM_NEWNEIGH
+            || header->nlmsg_len < NLMSG_LENGTH(sizeof(ndmsg))) {
+            continue;
+        }
+
+        // NOARP covers the multicast entries (ff02::1 and friends)
+        const ndmsg* neighbor = static_cast<const ndmsg*>(NLMSG_DATA(header));
+        if (neighbor->ndm_family != AF_INET6
+            || (neighbor->ndm_state & (NUD_INCOMPLETE | NUD_FAILED | NUD_NOARP))) {
+            continue;
+        }
+
+        const quint8* address = nullptr;
+        QString mac;
+
+        const rtattr* attribute = reinterpret_cast<const rtattr*>(
+            reinterpret_cast<const char*>(neighbor) + NLMSG_ALIGN(sizeof(ndmsg)));
+        int attributeLength = static_cast<int>(header->nlmsg_len - NLMSG_LENGTH(sizeof(ndmsg)));
+
+        for (; RTA_OK(attribute, attributeLength); attribute = RTA_NEXT(attribute, attributeLength)) {
+            if (attribute->rta_type == NDA_DST && RTA_PAYLOAD(attribute) == 16) {
+                address = static_cast<const quint8*>(RTA_DATA(attribute));
+            } else if (attribute->rta_type == NDA_LLADDR && RTA_PAYLOAD(attribute) == MAC_LENGTH) {
+                mac = formatMac(static_cast<const quint8*>(RTA_DATA(attribute)));
+            }
+        }
+
+        if (address && !mac.isEmpty()) {
+            QHostAddress host(address);
+            if (host.isLinkLocal()) {
+                host.setScopeId(QNetworkInterface::interfaceNameFromIndex(neighbor->ndm_ifindex));
+            }
+            table.insert(host.toString(), mac);
+        }
+    }
+
+    return 1;
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(length);
+    Q_UNUSED(table);
+    return -1;
+#endif
+}
+
+QHash<quint32, QString> NeighborTable::readProcNetArp()
+{
+    QFile file("/proc/net/arp");
+    if (!file.open(QIODevice::ReadOnly)) {
+        Logger::warn("NeighborTable: Cannot read /proc/net/arp");
+        return QHash<quint32, QString>();
+    }
+
+    // procfs reports size 0, so read until EOF
+    return parseProcNetArp(file.readAll());
+}
+
+QHash<quint32, QString> NeighborTable::parseProcNetArp(const QByteArray& content)
+{
+    QHash<quint32, QString> table;
+
+    // Format:
+    // IP address       HW type     Flags       HW address            Mask     Device
+    // 192.168.1.1      0x1         0x2         aa:bb:cc:dd:ee:ff     *        eth0
+
+    const QList<QByteArray> lines = content.split('\n');
+
+    for (int i = 1; i < lines.size(); ++i) {
+        QList<QByteArray> fields = lines[i].simplified().split(' ');
+        if (fields.size() < 4) {
+            continue;
+        }
+
+        // ATF_COM (0x2) marks a completed entry
+        bool ok = false;
+        int flags = fields[2].toInt(&ok, 16);
+        if (!ok || !(flags & 0x2)) {
+            continue;
+        }
+
+        bool isIpv4 = false;
+        quint32 address = QHostAddress(QString::fromLatin1(fields[0])).toIPv4Address(&isIpv4);
+        QString mac = QString::fromLatin1(fields[3]).toUpper();
+
+        if (isIpv4 && mac.size() == 17 && mac != "00:00:00:00:00:00") {
+            table.insert(address, mac);
+        }
+    }
+
+    return table;
+}
+
+QString NeighborTable::formatMac(const quint8* bytes)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    bool allZero = true;
+
+    QString mac(MAC_LENGTH * 3 - 1, ':');
+    for (int i = 0; i < MAC_LENGTH; ++i) {
+        mac[i * 3] = QLatin1Char(hex[bytes[i] >> 4]);
+        mac[i * 3 + 1] = QLatin1Char(hex[bytes[i] & 0x0F]);
+        allZero = allZero && bytes[i] == 0;
+    }
+
+    return allZero ? QString() : mac;
+}
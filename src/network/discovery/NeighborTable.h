@@ -0,0 +1,100 @@
+#ifndef NEIGHBORTABLE_H
+#define NEIGHBORTABLE_H
+
+#include <QString>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <functional>
+
+/**
+ * @brief Shared snapshot of the kernel IPv4 neighbour (ARP) table
+ *
+ * Read directly from the kernel instead of spawning `arp` per host: an
+ * rtnetlink RTM_GETNEIGH dump on Linux, /proc/net/arp if netlink is
+ * unavailable, and the `arp` command on other platforms. The snapshot is
+ * reset by beginScan() and refreshed incrementally on lookup misses;
+ * concurrent misses share a single refresh. Local interface addresses
+ * are served from a cached map.
+ */
+class NeighborTable
+{
+public:
+    static NeighborTable* instance();
+
+    /**
+     * @brief Start a new per-scan snapshot (re-reads neighbours and interfaces)
+     */
+    void beginScan();
+
+    /**
+     * @brief MAC address for an IP: local interface first, then neighbours
+     * @return Uppercase colon-separated MAC, or empty if unknown
+     */
+    QString macAddress(const QString& ip);
+
+    /**
+     * @brief MAC address of the local interface owning @p ip, if any
+     */
+    QString localMacAddress(const QString& ip);
+
+    int size() const;
+    int refreshCount() const;
+
+    /**
+     * @brief Read the complete kernel table (netlink, then /proc/net/arp)
+     * @return IPv4 address (host byte order) -> MAC address
+     */
+    static QHash<quint32, QString> readKernelTable();
+
+    /**
+     * @brief Parse /proc/net/arp contents, skipping incomplete entries
+     */
+    static QHash<quint32, QString> parseProcNetArp(const QByteArray& content);
+
+    /**
+     * @brief Parse one recv() worth of an RTM_GETNEIGH dump (Linux)
+     * @return 1 if more messages follow, 0 on NLMSG_DONE, -1 on NLMSG_ERROR
+     */
+    static int parseNeighborDump(const char* data, int length, QHash<quint32, QString>& table);
+
+    /**
+     * @brief Read the kernel IPv6 neighbour (NDP) cache (Linux rtnetlink only)
+     * @return IPv6 address text -> MAC address; link-local addresses carry their zone ("fe80::1%eth0")
+     */
+    static QHash<QString, QString> readKernelTable6();
+
+    /**
+     * @brief Parse one recv() worth of an AF_INET6 RTM_GETNEIGH dump (Linux)
+     * @return 1 if more messages follow, 0 on NLMSG_DONE, -1 on NLMSG_ERROR
+     */
+    static int parseNeighborDump6(const char* data, int length, QHash<QString, QString>& table);
+
+private:
+    NeighborTable();
+
+    NeighborTable(const NeighborTable&) = delete;
+    NeighborTable& operator=(const NeighborTable&) = delete;
+
+    static constexpr int MAC_LENGTH = 6;
+
+    mutable QMutex m_mutex;                  ///< Guards the snapshot and interface map
+    QMutex m_refreshMutex;                   ///< Serializes kernel reads
+    QHash<quint32, QString> m_neighbors;
+    QHash<QString, QString> m_localMacs;     ///< Local IP -> interface MAC
+    bool m_interfacesLoaded;
+    qint64 m_lastRefreshStart;               ///< -1 before the first refresh
+    int m_refreshCount;
+    QElapsedTimer m_clock;
+
+    void refresh(qint64 requestedAt);
+    void loadInterfaces();
+
+    static QHash<quint32, QString> readNetlink(bool& ok);
+    static bool dumpNeighbors(int family, const std::function<int(const char*, int)>& parse);
+    static QHash<quint32, QString> readProcNetArp();
+    static QString formatMac(const quint8* bytes);
+};
+
+#endif // NEIGHBORTABLE_H
@@ -0,0 +1,459 @@
+#include "PassiveDiscovery.h"
+#include "FrameParser.h"
+#include "PcapReader.h"
+#include "network/services/MacVendorLookup.h"
+#include "utils/Logger.h"
+#include <QDateTime>
+#include <QHostAddress>
+#include <QMutexLocker>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+    #include <sys/socket.h>
+    #include <sys/mman.h>
+    #include <linux/if_packet.h>
+    #include <linux/if_ether.h>
+    #include <linux/filter.h>
+    #include <net/if.h>
+    #include <arpa/inet.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace {
+quint64 macKey(const quint8* mac)
+{
+    quint64 key = 0;
+    for (int i = 0; i < 6; ++i) {
+        key = (key << 8) | mac[i];
+    }
+    return key;
+}
+
+QString macString(quint64 key)
+{
+    return QString::asprintf("%02X:%02X:%02X:%02X:%02X:%02X",
+                             static_cast<uint>((key >> 40) & 0xFF), static_cast<uint>((key >> 32) & 0xFF),
+                             static_cast<uint>((key >> 24) & 0xFF), static_cast<uint>((key >> 16) & 0xFF),
+                             static_cast<uint>((key >> 8) & 0xFF), static_cast<uint>(key & 0xFF));
+}
+
+#ifdef Q_OS_LINUX
+// ARP; unfragmented IPv4 UDP with either port in 67/68/5353/1900; ICMPv6 types 133-136
+sock_filter CAPTURE_FILTER[] = {
+    { 0x28, 0, 0, 12 },             // 0  ldh [12]              ethertype
+    { 0x15, 23, 0, ETH_P_ARP },     // 1  jeq ARP -> accept
+    { 0x15, 16, 0, ETH_P_IPV6 },    // 2  jeq IPv6 -> 19
+    { 0x15, 0, 20, ETH_P_IP },      // 3  jeq IPv4, else reject
+    { 0x30, 0, 0, 23 },             // 4  ldb [23]              IP protocol
+    { 0x15, 0, 18, 17 },            // 5  jeq UDP, else reject
+    { 0x28, 0, 0, 20 },             // 6  ldh [20]              flags/fragment offset
+    { 0x45, 16, 0, 0x1FFF },        // 7  jset offset -> reject
+    { 0xB1, 0, 0, 14 },             // 8  ldxb 4*([14]&0xf)     IP header length
+    { 0x48, 0, 0, 14 },             // 9  ldh [x+14]            source port
+    { 0x15, 14, 0, 67 },
+    { 0x15, 13, 0, 68 },
+    { 0x15, 12, 0, 5353 },
+    { 0x15, 11, 0, 1900 },
+    { 0x48, 0, 0, 16 },             // 14 ldh [x+16]            destination port
+    { 0x15, 9, 0, 67 },
+    { 0x15, 8, 0, 68 },
+    { 0x15, 7, 0, 5353 },
+    { 0x15, 6, 5, 1900 },
+    { 0x30, 0, 0, 20 },             // 19 ldb [20]              IPv6 next header
+    { 0x15, 0, 3, 58 },             // 20 jeq ICMPv6, else reject
+    { 0x30, 0, 0, 54 },             // 21 ldb [54]              ICMPv6 type
+    { 0x35, 0, 1, 133 },            // 22 jge 133, else reject
+    { 0x25, 0, 1, 136 },            // 23 jgt 136 -> reject, else accept
+    { 0x06, 0, 0, 0 },              // 24 reject
+    { 0x06, 0, 0, 0x00040000 },     // 25 accept
+};
+#endif
+}
+
+PassiveDiscovery::PassiveDiscovery(QObject* parent)
+    : QObject(parent)
+    , m_socketFd(-1)
+    , m_ring(nullptr)
+    , m_worker(nullptr)
+    , m_capturing(false)
+    , m_stopRequested(false)
+    , m_frames(0)
+    , m_flushTimer(new QTimer(this))
+{
+    m_flushTimer->setInterval(DEFAULT_FLUSH_INTERVAL_MS);
+    connect(m_flushTimer, &QTimer::timeout, this, &PassiveDiscovery::flush);
+}
+
+PassiveDiscovery::~PassiveDiscovery()
+{
+    m_stopRequested = true;
+    if (m_worker) {
+        m_worker->wait();
+        delete m_worker;
+    }
+    closeRing();
+}
+
+bool PassiveDiscovery::isCaptureSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PassiveDiscovery::startCapture(const QString& interfaceName)
+{
+    if (m_capturing) {
+        return false;
+    }
+    if (!isCaptureSupported()) {
+        emit captureError("Passive capture is not supported on this platform");
+        return false;
+    }
+
+    if (m_worker) {
+        m_worker->wait();
+        delete m_worker;
+        m_worker = nullptr;
+    }
+
+    if (!openRing(interfaceName)) {
+        return false;
+    }
+
+    m_stopRequested = false;
+    m_capturing = true;
+    m_worker = QThread::create([this]() { run(); });
+    m_worker->start();
+    m_flushTimer->start();
+
+    Logger::info(QString("PassiveDiscovery: Listening on %1")
+                 .arg(interfaceName.isEmpty() ? QString("all interfaces") : interfaceName));
+    return true;
+}
+
+void PassiveDiscovery::stop()
+{
+    if (!m_worker) {
+        return;
+    }
+
+    m_stopRequested = true;
+    m_worker->wait();
+    delete m_worker;
+    m_worker = nullptr;
+    closeRing();
+
+    m_flushTimer->stop();
+    flush();
+    Logger::info(QString("PassiveDiscovery: Stopped after %1 frames").arg(m_frames.load()));
+}
+
+bool PassiveDiscovery::isCapturing() const
+{
+    return m_capturing;
+}
+
+int PassiveDiscovery::replay(const QString& path)
+{
+    PcapReader reader;
+    if (!reader.open(path)) {
+        QString error = QString("Cannot read %1: %2").arg(path, reader.errorString());
+        Logger::warn("PassiveDiscovery: " + error);
+        emit captureError(error);
+        return -1;
+    }
+
+    const quint8* data = nullptr;
+    int length = 0;
+    qint64 timestampUs = 0;
+    int frames = 0;
+    int identified = 0;
+
+    while (reader.next(data, length, timestampUs)) {
+        frames++;
+        if (processFrame(data, length, reader.linkType(), timestampUs)) {
+            identified++;
+        }
+    }
+
+    if (!reader.errorString().isEmpty()) {
+        Logger::warn("PassiveDiscovery: " + path + ": " + reader.errorString());
+    }
+    Logger::info(QString("PassiveDiscovery: Replayed %1 frames from %2 (%3 identified a host)")
+                 .arg(frames).arg(path).arg(identified));
+
+    flush();
+    return frames;
+}
+
+bool PassiveDiscovery::processFrame(const quint8* frame, int length, int linkType, qint64 timestampUs)
+{
+    m_frames++;
+
+    FrameParser::Observation observation;
+    if (!FrameParser::parse(frame, length, observation, linkType)) {
+        return false;
+    }
+
+    // Group/broadcast and all-zero sources are never a single host
+    if ((observation.mac[0] & 0x01) != 0) {
+        return false;
+    }
+    quint64 key = macKey(observation.mac);
+    if (key == 0) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    HostRecord& record = m_hosts[key];
+
+    if (record.mac == 0) {
+        record.mac = key;
+        record.firstSeenUs = timestampUs;
+        record.dirty = true;
+    }
+    record.lastSeenUs = qMax(record.lastSeenUs, timestampUs);
+
+    if (observation.address != 0 && observation.address != record.address) {
+        record.address = observation.address;
+        record.dirty = true;
+    }
+
+    if (observation.hostnameLength > 0
+        && record.hostname != QLatin1String(observation.hostname, observation.hostnameLength)) {
+        record.hostname = QString::fromLatin1(observation.hostname, observation.hostnameLength);
+        record.dirty = true;
+    }
+
+    if (observation.hasAddress6) {
+        bool known = false;
+        for (const QByteArray& address : record.ipv6) {
+            if (std::memcmp(address.constData(), observation.address6, 16) == 0) {
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            if (record.ipv6.size() >= MAX_IPV6_PER_HOST) {
+                record.ipv6.removeFirst();
+            }
+            record.ipv6.append(QByteArray(reinterpret_cast<const char*>(observation.address6), 16));
+            record.dirty = true;
+        }
+    }
+
+    if ((record.protocols & observation.protocol) == 0) {
+        record.protocols |= observation.protocol;
+        record.dirty = true;
+    }
+
+    if (record.lastSeenUs - record.lastEmittedUs >= SEEN_REFRESH_US) {
+        record.dirty = true;
+    }
+
+    return true;
+}
+
+void PassiveDiscovery::setFlushInterval(int ms)
+{
+    m_flushTimer->setInterval(ms);
+}
+
+QList<PassiveDiscovery::HostRecord> PassiveDiscovery::inventory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hosts.values();
+}
+
+quint64 PassiveDiscovery::framesProcessed() const
+{
+    return m_frames;
+}
+
+void PassiveDiscovery::flush()
+{
+    QList<Device> devices;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto it = m_hosts.begin(); it != m_hosts.end(); ++it) {
+            HostRecord& record = it.value();
+            // Hosts seen only in a DHCP DISCOVER wait until an address turns up
+            if (!record.dirty || (record.address == 0 && record.ipv6.isEmpty())) {
+                continue;
+            }
+            record.dirty = false;
+            record.lastEmittedUs = record.lastSeenUs;
+            devices.append(toDevice(record));
+        }
+    }
+
+    if (!devices.isEmpty()) {
+        Logger::debug(QString("PassiveDiscovery: %1 hosts new or updated").arg(devices.size()));
+        emit devicesObserved(devices);
+    }
+}
+
+Device PassiveDiscovery::toDevice(const HostRecord& record)
+{
+    Device device;
+    device.setHostname(record.hostname);
+
+    // IPv6-only hosts are listed under their best address: global, then link-local
+    QString primary = record.address != 0 ? QHostAddress(record.address).toString() : QString();
+    for (const QByteArray& bytes : record.ipv6) {
+        QHostAddress address(reinterpret_cast<const quint8*>(bytes.constData()));
+        device.addIpv6Address(address.toString());
+        if (primary.isEmpty() || (record.address == 0 && !address.isLinkLocal())) {
+            primary = address.toString();
+        }
+    }
+    device.setIp(primary);
+
+    QString mac = macString(record.mac);
+    device.setMacAddress(mac);
+    device.setVendor(MacVendorLookup::instance()->lookupVendor(mac));
+    device.setOnline(true);
+    device.setLastSeen(QDateTime::fromMSecsSinceEpoch(record.lastSeenUs / 1000));
+    return device;
+}
+
+bool PassiveDiscovery::openRing(const QString& interfaceName)
+{
+#ifdef Q_OS_LINUX
+    auto fail = [this](const QString& what) {
+        QString error = QString("%1: %2").arg(what, QString::fromLocal8Bit(strerror(errno)));
+        Logger::warn("PassiveDiscovery: " + error);
+        closeRing();
+        emit captureError(error);
+        return false;
+    };
+
+    // Protocol 0: nothing is queued until bind(), after the filter is in place
+    m_socketFd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, 0);
+    if (m_socketFd < 0) {
+        return fail("Cannot open packet socket (CAP_NET_RAW required)");
+    }
+
+    int version = TPACKET_V3;
+    if (setsockopt(m_socketFd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        return fail("TPACKET_V3 not available");
+    }
+
+    tpacket_req3 request;
+    std::memset(&request, 0, sizeof(request));
+    request.tp_block_size = RING_BLOCK_SIZE;
+    request.tp_block_nr = RING_BLOCK_COUNT;
+    request.tp_frame_size = RING_FRAME_SIZE;
+    request.tp_frame_nr = (RING_BLOCK_SIZE / RING_FRAME_SIZE) * RING_BLOCK_COUNT;
+    request.tp_retire_blk_tov = RING_RETIRE_MS;
+    if (setsockopt(m_socketFd, SOL_PACKET, PACKET_RX_RING, &request, sizeof(request)) < 0) {
+        return fail("Cannot set up receive ring");
+    }
+
+    void* ring = mmap(nullptr, static_cast<size_t>(RING_BLOCK_SIZE) * RING_BLOCK_COUNT,
+                      PROT_READ | PROT_WRITE, MAP_SHARED, m_socketFd, 0);
+    if (ring == MAP_FAILED) {
+        return fail("Cannot map receive ring");
+    }
+    m_ring = static_cast<quint8*>(ring);
+
+    sock_fprog program;
+    program.len = sizeof(CAPTURE_FILTER) / sizeof(CAPTURE_FILTER[0]);
+    program.filter = CAPTURE_FILTER;
+    if (setsockopt(m_socketFd, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program)) < 0) {
+        return fail("Cannot attach capture filter");
+    }
+
+    sockaddr_ll address;
+    std::memset(&address, 0, sizeof(address));
+    address.sll_family = AF_PACKET;
+    address.sll_protocol = htons(ETH_P_ALL);
+    if (!interfaceName.isEmpty()) {
+        address.sll_ifindex = static_cast<int>(if_nametoindex(interfaceName.toLocal8Bit().constData()));
+        if (address.sll_ifindex == 0) {
+            return fail("Unknown interface " + interfaceName);
+        }
+    }
+    if (bind(m_socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        return fail("Cannot bind packet socket");
+    }
+
+    return true;
+#else
+    Q_UNUSED(interfaceName);
+    return false;
+#endif
+}
+
+void PassiveDiscovery::closeRing()
+{
+#ifdef Q_OS_LINUX
+    if (m_ring) {
+        munmap(m_ring, static_cast<size_t>(RING_BLOCK_SIZE) * RING_BLOCK_COUNT);
+        m_ring = nullptr;
+    }
+    if (m_socketFd >= 0) {
+        tpacket_stats_v3 stats;
+        socklen_t length = sizeof(stats);
+        if (getsockopt(m_socketFd, SOL_PACKET, PACKET_STATISTICS, &stats, &length) == 0 && stats.tp_drops > 0) {
+            Logger::warn(QString("PassiveDiscovery: Kernel dropped %1 frames").arg(stats.tp_drops));
+        }
+        close(m_socketFd);
+        m_socketFd = -1;
+    }
+#endif
+}
+
+void PassiveDiscovery::run()
+{
+#ifdef Q_OS_LINUX
+    int blockIndex = 0;
+
+    while (!m_stopRequested) {
+        auto* block = reinterpret_cast<tpacket_block_desc*>(m_ring + blockIndex * RING_BLOCK_SIZE);
+
+        if ((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0) {
+            pollfd descriptor;
+            descriptor.fd = m_socketFd;
+            descriptor.events = POLLIN | POLLERR;
+            descriptor.revents = 0;
+            if (poll(&descriptor, 1, POLL_TIMEOUT_MS) < 0 && errno != EINTR) {
+                Logger::warn(QString("PassiveDiscovery: poll failed: %1").arg(strerror(errno)));
+                break;
+            }
+            continue;
+        }
+
+        walkBlock(reinterpret_cast<quint8*>(block));
+
+        // Hand the block back to the kernel
+        __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        blockIndex = (blockIndex + 1) % RING_BLOCK_COUNT;
+    }
+#endif
+
+    m_capturing = false;
+}
+
+void PassiveDiscovery::walkBlock(quint8* block)
+{
+#ifdef Q_OS_LINUX
+    auto* descriptor = reinterpret_cast<tpacket_block_desc*>(block);
+    quint32 count = descriptor->hdr.bh1.num_pkts;
+    auto* header = reinterpret_cast<tpacket3_hdr*>(block + descriptor->hdr.bh1.offset_to_first_pkt);
+
+    for (quint32 i = 0; i < count; ++i) {
+        const quint8* frame = reinterpret_cast<const quint8*>(header) + header->tp_mac;
+        qint64 timestampUs = static_cast<qint64>(header->tp_sec) * 1000000 + header->tp_nsec / 1000;
+        processFrame(frame, static_cast<int>(header->tp_snaplen), FrameParser::Ethernet, timestampUs);
+        header = reinterpret_cast<tpacket3_hdr*>(reinterpret_cast<quint8*>(header) + header->tp_next_offset);
+    }
+#else
+    Q_UNUSED(block);
+#endif
+}
@@ -0,0 +1,141 @@
+#ifndef PASSIVEDISCOVERY_H
+#define PASSIVEDISCOVERY_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include "models/Device.h"
+
+/**
+ * @brief Builds a device inventory from broadcast/multicast traffic alone
+ *
+ * Hosts constantly announce themselves with ARP, DHCP, mDNS, SSDP and
+ * IPv6 neighbour discovery. Listening to that traffic finds devices that
+ * never answer a ping and keeps their last-seen time fresh without
+ * sending a single probe.
+ *
+ * On Linux the live capture uses an AF_PACKET socket with a TPACKET_V3
+ * memory-mapped ring: the kernel fills whole blocks of frames and a
+ * classic BPF filter drops everything except ARP, UDP 67/68/5353/1900
+ * and ICMPv6 neighbour discovery before it reaches the ring, so the
+ * capture thread wakes once per block rather than once per packet.
+ * Frames are decoded in place by FrameParser. Capturing requires
+ * CAP_NET_RAW.
+ *
+ * Saved captures (classic pcap) can be replayed through the same path on
+ * any platform.
+ *
+ * Hosts are keyed by MAC address. New or changed hosts are batched and
+ * emitted through devicesObserved() every flush interval on the thread
+ * that owns this object, which is where the database writes happen.
+ */
+class PassiveDiscovery : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct HostRecord {
+        quint64 mac;                ///< 48-bit MAC in the low bits
+        quint32 address;            ///< IPv4 (host byte order), 0 until seen
+        QVector<QByteArray> ipv6;   ///< Raw 16-byte IPv6 addresses, newest last
+        QString hostname;
+        int protocols;              ///< FrameParser::Protocol bits seen from this host
+        qint64 firstSeenUs;
+        qint64 lastSeenUs;
+        qint64 lastEmittedUs;
+        bool dirty;
+
+        HostRecord() : mac(0), address(0), protocols(0), firstSeenUs(0), lastSeenUs(0),
+                       lastEmittedUs(0), dirty(false) {}
+    };
+
+    static constexpr int DEFAULT_FLUSH_INTERVAL_MS = 2000;
+    static constexpr qint64 SEEN_REFRESH_US = 60000000;    ///< Re-emit unchanged hosts at most once a minute
+    static constexpr int MAX_IPV6_PER_HOST = 16;           ///< Privacy addresses rotate; oldest are dropped
+
+    explicit PassiveDiscovery(QObject* parent = nullptr);
+    ~PassiveDiscovery();
+
+    /**
+     * @brief Check whether live capture is available on this platform
+     */
+    static bool isCaptureSupported();
+
+    /**
+     * @brief Start listening in the background
+     * @param interfaceName Interface to capture on, empty for all
+     * @return false if already capturing, unsupported or the ring could not be set up
+     */
+    bool startCapture(const QString& interfaceName = QString());
+
+    /**
+     * @brief Stop the live capture and flush what is pending
+     */
+    void stop();
+
+    bool isCapturing() const;
+
+    /**
+     * @brief Feed a saved capture through the parser synchronously
+     * @return Number of frames read, -1 if the file could not be opened
+     */
+    int replay(const QString& path);
+
+    /**
+     * @brief Merge one frame into the inventory (thread-safe)
+     * @return true if the frame identified a host
+     */
+    bool processFrame(const quint8* frame, int length, int linkType, qint64 timestampUs);
+
+    void setFlushInterval(int ms);
+
+    /**
+     * @brief Snapshot of every host seen so far
+     */
+    QList<HostRecord> inventory() const;
+
+    quint64 framesProcessed() const;
+
+public slots:
+    /**
+     * @brief Emit devicesObserved() for hosts that changed since the last flush
+     */
+    void flush();
+
+signals:
+    void devicesObserved(const QList<Device>& devices);
+    void captureError(const QString& error);
+
+private:
+    static constexpr int RING_BLOCK_SIZE = 1 << 18;        ///< 256 KiB
+    static constexpr int RING_BLOCK_COUNT = 16;
+    static constexpr int RING_FRAME_SIZE = 2048;
+    static constexpr int RING_RETIRE_MS = 100;             ///< Hand partially filled blocks over after this
+    static constexpr int POLL_TIMEOUT_MS = 200;
+
+    int m_socketFd;
+    quint8* m_ring;
+    QThread* m_worker;
+    std::atomic<bool> m_capturing;
+    std::atomic<bool> m_stopRequested;
+    std::atomic<quint64> m_frames;
+    QTimer* m_flushTimer;
+
+    mutable QMutex m_mutex;             ///< Guards m_hosts
+    QHash<quint64, HostRecord> m_hosts;
+
+    bool openRing(const QString& interfaceName);
+    void closeRing();
+    void run();
+    void walkBlock(quint8* block);
+
+    static Device toDevice(const HostRecord& record);
+};
+
+#endif // PASSIVEDISCOVERY_H
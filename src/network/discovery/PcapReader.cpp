@@ -0,0 +1,117 @@
+#include "PcapReader.h"
+#include <QtEndian>
+
+namespace {
+const quint32 MAGIC_MICROSECONDS = 0xA1B2C3D4;
+const quint32 MAGIC_NANOSECONDS = 0xA1B23C4D;
+const int GLOBAL_HEADER_SIZE = 24;
+const int RECORD_HEADER_SIZE = 16;
+}
+
+PcapReader::PcapReader()
+    : m_swapped(false)
+    , m_nanosecond(false)
+    , m_linkType(0)
+{
+}
+
+PcapReader::~PcapReader()
+{
+    close();
+}
+
+bool PcapReader::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    char header[GLOBAL_HEADER_SIZE];
+    if (m_file.read(header, GLOBAL_HEADER_SIZE) != GLOBAL_HEADER_SIZE) {
+        m_error = "File too short for a pcap header";
+        close();
+        return false;
+    }
+
+    // The magic is written in the capturing host's byte order
+    quint32 magic = qFromLittleEndian<quint32>(header);
+    m_swapped = false;
+    if (magic == MAGIC_MICROSECONDS || magic == MAGIC_NANOSECONDS) {
+        m_nanosecond = (magic == MAGIC_NANOSECONDS);
+    } else {
+        magic = qFromBigEndian<quint32>(header);
+        if (magic != MAGIC_MICROSECONDS && magic != MAGIC_NANOSECONDS) {
+            m_error = "Not a pcap file (pcapng is not supported)";
+            close();
+            return false;
+        }
+        m_swapped = true;
+        m_nanosecond = (magic == MAGIC_NANOSECONDS);
+    }
+
+    // Upper bits of the link type field carry FCS information
+    m_linkType = static_cast<int>(field(header + 20) & 0x0FFFFFFF);
+    m_buffer.resize(MAX_SNAPLEN);
+    m_error.clear();
+    return true;
+}
+
+void PcapReader::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+int PcapReader::linkType() const
+{
+    return m_linkType;
+}
+
+bool PcapReader::next(const quint8*& data, int& length, qint64& timestampUs)
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    char header[RECORD_HEADER_SIZE];
+    qint64 read = m_file.read(header, RECORD_HEADER_SIZE);
+    if (read == 0) {
+        return false;
+    }
+    if (read != RECORD_HEADER_SIZE) {
+        m_error = "Truncated record header";
+        return false;
+    }
+
+    quint32 seconds = field(header);
+    quint32 fraction = field(header + 4);
+    quint32 captured = field(header + 8);
+
+    if (captured > static_cast<quint32>(MAX_SNAPLEN)) {
+        m_error = QString("Record of %1 bytes exceeds the snapshot limit").arg(captured);
+        return false;
+    }
+    if (m_file.read(m_buffer.data(), captured) != static_cast<qint64>(captured)) {
+        m_error = "Truncated record";
+        return false;
+    }
+
+    data = reinterpret_cast<const quint8*>(m_buffer.constData());
+    length = static_cast<int>(captured);
+    timestampUs = static_cast<qint64>(seconds) * 1000000 + (m_nanosecond ? fraction / 1000 : fraction);
+    return true;
+}
+
+QString PcapReader::errorString() const
+{
+    return m_error;
+}
+
+quint32 PcapReader::field(const char* data) const
+{
+    return m_swapped ? qFromBigEndian<quint32>(data) : qFromLittleEndian<quint32>(data);
+}
@@ -0,0 +1,60 @@
+#ifndef PCAPREADER_H
+#define PCAPREADER_H
+
+#include <QString>
+#include <QFile>
+#include <QByteArray>
+
+/**
+ * @brief Minimal reader for classic libpcap capture files
+ *
+ * Handles both byte orders and the microsecond and nanosecond variants
+ * of the format. pcapng is not supported. Records are read into one
+ * reusable buffer, so iterating a capture does not allocate per packet.
+ */
+class PcapReader
+{
+public:
+    static constexpr int MAX_SNAPLEN = 262144;
+
+    PcapReader();
+    ~PcapReader();
+
+    PcapReader(const PcapReader&) = delete;
+    PcapReader& operator=(const PcapReader&) = delete;
+
+    /**
+     * @brief Open a capture and read its global header
+     * @return false if the file cannot be read or is not a pcap file
+     */
+    bool open(const QString& path);
+    void close();
+
+    /**
+     * @brief Link-layer type from the global header (DLT_* value)
+     */
+    int linkType() const;
+
+    /**
+     * @brief Read the next record
+     * @param data Set to the captured bytes, valid until the next call
+     * @param length Captured length
+     * @param timestampUs Capture time in microseconds since the epoch
+     * @return false at end of file or on a truncated/corrupt record
+     */
+    bool next(const quint8*& data, int& length, qint64& timestampUs);
+
+    QString errorString() const;
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;
+    bool m_swapped;
+    bool m_nanosecond;
+    int m_linkType;
+    QString m_error;
+
+    quint32 field(const char* data) const;
+};
+
+#endif // PCAPREADER_H
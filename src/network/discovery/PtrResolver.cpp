@@ -0,0 +1,708 @@
+#include "PtrResolver.h"
+#include "network/sockets/RateController.h"
+#include "utils/Logger.h"
+#include <QFile>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QRandomGenerator>
+#include <cstring>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace {
+const int DNS_HEADER_SIZE = 12;
+const quint16 DNS_FLAG_RESPONSE = 0x8000;
+const quint16 DNS_FLAG_RECURSION_DESIRED = 0x0100;
+const int DNS_RCODE_NXDOMAIN = 3;
+const int MAX_NAME_LENGTH = 255;
+const int MAX_POINTER_JUMPS = 16;
+
+quint16 readU16(const quint8* data)
+{
+    return static_cast<quint16>((data[0] << 8) | data[1]);
+}
+
+quint32 readU32(const quint8* data)
+{
+    return (static_cast<quint32>(data[0]) << 24) | (static_cast<quint32>(data[1]) << 16)
+         | (static_cast<quint32>(data[2]) << 8) | data[3];
+}
+
+// Some servers answer with the address itself; that is not a name
+bool looksLikeAddress(const QString& name)
+{
+    int dots = 0;
+    for (QChar c : name) {
+        if (c == '.') {
+            dots++;
+        } else if (!c.isDigit()) {
+            return false;
+        }
+    }
+    return dots == 3;
+}
+}
+
+PtrResolver* PtrResolver::instance()
+{
+    // Function-local static: initialized once, thread-safe
+    static PtrResolver* resolver = new PtrResolver(systemNameserver());
+    return resolver;
+}
+
+PtrResolver::PtrResolver(quint32 server, quint16 port, int socketCount)
+    : m_server(server)
+    , m_port(port)
+    , m_available(false)
+    , m_retries(DEFAULT_RETRIES)
+    , m_nextSocket(0)
+    , m_receiver(nullptr)
+    , m_running(false)
+{
+    m_clock.start();
+    m_sockets.fill(-1, qBound(1, socketCount, 64));
+
+    if (m_server != 0 && openSockets()) {
+        m_available = true;
+        m_running = true;
+        m_receiver = QThread::create([this]() { receiveLoop(); });
+        m_receiver->start();
+        Logger::info(QString("PtrResolver: Using nameserver %1.%2.%3.%4:%5 over %6 sockets")
+                    .arg(m_server >> 24).arg((m_server >> 16) & 0xFF)
+                    .arg((m_server >> 8) & 0xFF).arg(m_server & 0xFF)
+                    .arg(m_port).arg(m_sockets.size()));
+    } else {
+        Logger::warn("PtrResolver: No usable IPv4 nameserver, falling back to system resolver");
+    }
+}
+
+PtrResolver::~PtrResolver()
+{
+    m_running = false;
+    if (m_receiver) {
+        m_receiver->wait();
+        delete m_receiver;
+    }
+
+    // Fail anything still outstanding so blocking callers wake up
+    QMutexLocker dispatchLocker(&m_dispatchMutex);
+    QMutexLocker locker(&m_mutex);
+    QHash<quint32, Pending> pending = m_pending;
+    m_pending.clear();
+    m_deadlines.clear();
+    locker.unlock();
+
+    for (const Pending& entry : pending) {
+        PtrResult result;
+        result.address = entry.address;
+        entry.callback(result);
+    }
+    dispatchLocker.unlock();
+
+    closeSockets();
+}
+
+bool PtrResolver::isAvailable() const
+{
+    return m_available;
+}
+
+void PtrResolver::setRetries(int retries)
+{
+    QMutexLocker locker(&m_mutex);
+    m_retries = qMax(0, retries);
+}
+
+void PtrResolver::submit(quint32 address, int timeoutMs, Callback callback, const void* owner, int retries)
+{
+    PtrResult result;
+    if (cachedResult(address, result)) {
+        callback(result);
+        return;
+    }
+
+    result.address = address;
+    if (!m_available) {
+        callback(result);
+        return;
+    }
+
+    // Paced by the shared probe budget; never while holding m_mutex
+    RateController::instance()->acquire();
+
+    bool sent = false;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        Pending entry;
+        entry.address = address;
+        entry.socket = 0;
+        entry.id = 0;
+        entry.attempt = 0;
+        entry.retries = (retries < 0) ? m_retries : retries;
+        entry.timeoutMs = qMax(1, timeoutMs);
+        entry.deadlineMs = 0;
+        entry.callback = callback;
+        entry.owner = owner;
+
+        sent = sendQuery(entry);
+    }
+
+    if (!sent) {
+        callback(result);
+    }
+}
+
+void PtrResolver::submitBatch(const QVector<quint32>& addresses, int timeoutMs, Callback callback,
+                              const void* owner, int retries)
+{
+    for (quint32 address : addresses) {
+        submit(address, timeoutMs, callback, owner, retries);
+    }
+}
+
+void PtrResolver::cancel(const void* owner)
+{
+    if (owner == nullptr) {
+        return;
+    }
+
+    QMutexLocker dispatchLocker(&m_dispatchMutex);
+    QMutexLocker locker(&m_mutex);
+
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it->owner == owner) {
+            m_deadlines.remove(it->deadlineMs, it.key());
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+PtrResolver::PtrResult PtrResolver::resolve(quint32 address, int timeoutMs, int retries)
+{
+    return resolveBatch(QVector<quint32>() << address, timeoutMs, retries).first();
+}
+
+QVector<PtrResolver::PtrResult> PtrResolver::resolveBatch(const QVector<quint32>& addresses, int timeoutMs,
+                                                          int retries)
+{
+    QVector<PtrResult> results(addresses.size());
+    if (addresses.isEmpty()) {
+        return results;
+    }
+
+    QMutex mutex;
+    QWaitCondition finished;
+    int remaining = addresses.size();
+
+    for (int i = 0; i < addresses.size(); ++i) {
+        submit(addresses[i], timeoutMs, [&, i](const PtrResult& result) {
+            QMutexLocker locker(&mutex);
+            results[i] = result;
+            if (--remaining == 0) {
+                finished.wakeAll();
+            }
+        }, nullptr, retries);
+    }
+
+    // Every submitted lookup gets exactly one callback (answer, timeout or failure)
+    QMutexLocker locker(&mutex);
+    while (remaining > 0) {
+        finished.wait(&mutex);
+    }
+
+    return results;
+}
+
+bool PtrResolver::cachedResult(quint32 address, PtrResult& result) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_cache.constFind(address);
+    if (it == m_cache.constEnd()) {
+        return false;
+    }
+
+    qint64 remainingMs = it->expiresMs - m_clock.elapsed();
+    if (remainingMs <= 0) {
+        return false;
+    }
+
+    result.address = address;
+    result.status = it->status;
+    result.hostname = it->hostname;
+    result.ttl = static_cast<quint32>((remainingMs + 999) / 1000);
+    result.cached = true;
+    return true;
+}
+
+void PtrResolver::clearCache()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+int PtrResolver::cacheSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.size();
+}
+
+int PtrResolver::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending.size();
+}
+
+quint32 PtrResolver::systemNameserver()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    QFile file("/etc/resolv.conf");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return 0;
+    }
+
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().simplified();
+        if (!line.startsWith("nameserver ")) {
+            continue;
+        }
+
+        in_addr parsed;
+        QByteArray value = line.mid(11).trimmed();
+        if (::inet_pton(AF_INET, value.constData(), &parsed) == 1) {
+            return ntohl(parsed.s_addr);
+        }
+    }
+#endif
+    return 0;
+}
+
+QString PtrResolver::reverseName(quint32 address)
+{
+    return QString("%1.%2.%3.%4.in-addr.arpa")
+        .arg(address & 0xFF)
+        .arg((address >> 8) & 0xFF)
+        .arg((address >> 16) & 0xFF)
+        .arg(address >> 24);
+}
+
+QByteArray PtrResolver::buildQuery(quint16 id, quint32 address)
+{
+    QByteArray query;
+    query.reserve(DNS_HEADER_SIZE + 32);
+
+    // Header: ID, flags (RD), QDCOUNT 1, ANCOUNT/NSCOUNT/ARCOUNT 0
+    query.append(static_cast<char>(id >> 8));
+    query.append(static_cast<char>(id & 0xFF));
+    query.append(static_cast<char>(DNS_FLAG_RECURSION_DESIRED >> 8));
+    query.append(static_cast<char>(DNS_FLAG_RECURSION_DESIRED & 0xFF));
+    query.append("\x00\x01\x00\x00\x00\x00\x00\x00", 8);
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        QByteArray label = QByteArray::number((address >> shift) & 0xFF);
+        query.append(static_cast<char>(label.size()));
+        query.append(label);
+    }
+    query.append("\x07in-addr\x04" "arpa\x00", 14);
+
+    // QTYPE PTR, QCLASS IN
+    query.append("\x00\x0c\x00\x01", 4);
+    return query;
+}
+
+bool PtrResolver::readName(const quint8* data, int length, int& offset, QString* name)
+{
+    int position = offset;
+    int resume = -1;
+    int jumps = 0;
+    int nameLength = 0;
+
+    if (name) {
+        name->clear();
+    }
+
+    while (true) {
+        if (position >= length) {
+            return false;
+        }
+
+        quint8 labelLength = data[position];
+
+        if ((labelLength & 0xC0) == 0xC0) {
+            // Compression pointer
+            if (position + 1 >= length || ++jumps > MAX_POINTER_JUMPS) {
+                return false;
+            }
+            if (resume < 0) {
+                resume = position + 2;
+            }
+            position = ((labelLength & 0x3F) << 8) | data[position + 1];
+            continue;
+        }
+
+        if (labelLength & 0xC0) {
+            return false;
+        }
+
+        if (labelLength == 0) {
+            offset = (resume >= 0) ? resume : position + 1;
+            return true;
+        }
+
+        if (position + 1 + labelLength > length) {
+            return false;
+        }
+
+        nameLength += labelLength + 1;
+        if (nameLength > MAX_NAME_LENGTH) {
+            return false;
+        }
+
+        if (name) {
+            if (!name->isEmpty()) {
+                name->append('.');
+            }
+            name->append(QString::fromLatin1(reinterpret_cast<const char*>(data + position + 1), labelLength));
+        }
+        position += 1 + labelLength;
+    }
+}
+
+bool PtrResolver::parseResponse(const quint8* data, int length, Response& response)
+{
+    if (length < DNS_HEADER_SIZE) {
+        return false;
+    }
+
+    quint16 flags = readU16(data + 2);
+    if (!(flags & DNS_FLAG_RESPONSE)) {
+        return false;
+    }
+
+    response.id = readU16(data);
+    response.rcode = flags & 0x000F;
+    response.hostname.clear();
+    response.ttl = 0;
+    response.negativeTtl = -1;
+
+    int questions = readU16(data + 4);
+    int answers = readU16(data + 6);
+    int authorities = readU16(data + 8);
+    int offset = DNS_HEADER_SIZE;
+
+    for (int i = 0; i < questions; ++i) {
+        if (!readName(data, length, offset, i == 0 ? &response.questionName : nullptr)) {
+            return false;
+        }
+        offset += 4;
+        if (offset > length) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < answers + authorities; ++i) {
+        if (!readName(data, length, offset, nullptr) || offset + 10 > length) {
+            return false;
+        }
+
+        quint16 type = readU16(data + offset);
+        quint32 ttl = readU32(data + offset + 4);
+        int rdLength = readU16(data + offset + 8);
+        int rdata = offset + 10;
+        if (rdata + rdLength > length) {
+            return false;
+        }
+
+        if (i < answers && type == DNS_TYPE_PTR && response.hostname.isEmpty()) {
+            // Owner may be a CNAME target (RFC 2317 delegation); the first PTR wins
+            int nameOffset = rdata;
+            if (!readName(data, length, nameOffset, &response.hostname)) {
+                return false;
+            }
+            response.ttl = ttl;
+        } else if (i >= answers && type == DNS_TYPE_SOA) {
+            // RFC 2308: negative TTL is min(SOA TTL, SOA MINIMUM)
+            int soaOffset = rdata;
+            if (readName(data, length, soaOffset, nullptr) && readName(data, length, soaOffset, nullptr)
+                && soaOffset + 20 <= rdata + rdLength) {
+                response.negativeTtl = qMin(ttl, readU32(data + soaOffset + 16));
+            }
+        }
+
+        offset = rdata + rdLength;
+    }
+
+    return true;
+}
+
+bool PtrResolver::openSockets()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    sockaddr_in dest;
+    std::memset(&dest, 0, sizeof(dest));
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(m_port);
+    dest.sin_addr.s_addr = htonl(m_server);
+
+    for (int i = 0; i < m_sockets.size(); ++i) {
+        int fd = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (fd < 0) {
+            closeSockets();
+            return false;
+        }
+        m_sockets[i] = fd;
+
+        int flags = ::fcntl(fd, F_GETFL, 0);
+        ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+        // Connected: the kernel drops datagrams from anyone but the server
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&dest), sizeof(dest)) < 0) {
+            closeSockets();
+            return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PtrResolver::closeSockets()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    for (int& fd : m_sockets) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+#endif
+}
+
+bool PtrResolver::sendQuery(Pending& entry)
+{
+    // Caller holds m_mutex
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    int socket = m_nextSocket;
+    m_nextSocket = (m_nextSocket + 1) % m_sockets.size();
+
+    // Random IDs so off-path replies cannot be matched by guessing
+    quint16 id = 0;
+    int tries = 0;
+    do {
+        id = static_cast<quint16>(QRandomGenerator::global()->bounded(0x10000));
+    } while (m_pending.contains(pendingKey(socket, id)) && ++tries < 64);
+
+    if (m_pending.contains(pendingKey(socket, id))) {
+        return false;
+    }
+
+    QByteArray query = buildQuery(id, entry.address);
+    ssize_t sent = ::send(m_sockets[socket], query.constData(), query.size(), 0);
+    if (sent != query.size()) {
+        if (errno == ENOBUFS || errno == EAGAIN || errno == EWOULDBLOCK) {
+            RateController::instance()->reportCongestion();
+        }
+        return false;
+    }
+
+    // Later attempts wait longer: 1x, 1.5x, 2x the base timeout
+    entry.socket = socket;
+    entry.id = id;
+    entry.deadlineMs = m_clock.elapsed() + entry.timeoutMs + entry.timeoutMs * entry.attempt / 2;
+
+    quint32 key = pendingKey(socket, id);
+    m_pending.insert(key, entry);
+    m_deadlines.insert(entry.deadlineMs, key);
+    return true;
+#else
+    Q_UNUSED(entry);
+    return false;
+#endif
+}
+
+void PtrResolver::receiveLoop()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    QVector<pollfd> fds(m_sockets.size());
+    for (int i = 0; i < m_sockets.size(); ++i) {
+        fds[i].fd = m_sockets[i];
+        fds[i].events = POLLIN;
+    }
+
+    quint8 buffer[MAX_MESSAGE_SIZE];
+
+    while (m_running.load()) {
+        for (pollfd& pfd : fds) {
+            pfd.revents = 0;
+        }
+
+        int ready = ::poll(fds.data(), static_cast<nfds_t>(fds.size()), nextWaitMs());
+
+        if (ready > 0) {
+            for (int i = 0; i < fds.size(); ++i) {
+                if (!(fds[i].revents & POLLIN)) {
+                    continue;
+                }
+                ssize_t received;
+                while ((received = ::recv(fds[i].fd, buffer, sizeof(buffer), 0)) > 0) {
+                    handleDatagram(i, buffer, static_cast<int>(received));
+                }
+            }
+        } else if (ready < 0 && errno != EINTR) {
+            // Persistent socket error - avoid spinning
+            QThread::msleep(IDLE_WAIT_MS);
+        }
+
+        expireDeadlines();
+    }
+#endif
+}
+
+void PtrResolver::handleDatagram(int socket, const quint8* data, int length)
+{
+    Response response;
+    if (!parseResponse(data, length, response)) {
+        return;
+    }
+
+    QMutexLocker dispatchLocker(&m_dispatchMutex);
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_pending.find(pendingKey(socket, response.id));
+    if (it == m_pending.end()) {
+        return;
+    }
+
+    // The question must echo ours, otherwise this is a stale or forged reply
+    if (response.questionName.compare(reverseName(it->address), Qt::CaseInsensitive) != 0) {
+        return;
+    }
+
+    Pending entry = it.value();
+    m_deadlines.remove(entry.deadlineMs, it.key());
+    m_pending.erase(it);
+    locker.unlock();
+
+    PtrResult result;
+    result.address = entry.address;
+
+    if (response.rcode == 0 && !response.hostname.isEmpty() && !looksLikeAddress(response.hostname)) {
+        result.status = Resolved;
+        result.hostname = response.hostname;
+        result.ttl = qMin(response.ttl, MAX_TTL);
+    } else if (response.rcode == 0 || response.rcode == DNS_RCODE_NXDOMAIN) {
+        result.status = NotFound;
+        result.ttl = response.negativeTtl >= 0
+            ? static_cast<quint32>(qMin<qint64>(response.negativeTtl, MAX_TTL))
+            : NEGATIVE_TTL;
+    } else {
+        // SERVFAIL, REFUSED, ... - retry on a later scan
+        result.status = Failed;
+        result.ttl = TIMEOUT_TTL;
+    }
+
+    storeResult(result);
+    RateController::instance()->reportResponse();
+    entry.callback(result);
+}
+
+void PtrResolver::expireDeadlines()
+{
+    QMutexLocker dispatchLocker(&m_dispatchMutex);
+    QMutexLocker locker(&m_mutex);
+
+    qint64 now = m_clock.elapsed();
+    QList<Pending> timedOut;
+
+    auto it = m_deadlines.begin();
+    while (it != m_deadlines.end() && it.key() <= now) {
+        auto pendingIt = m_pending.find(it.value());
+        if (pendingIt != m_pending.end()) {
+            timedOut.append(pendingIt.value());
+            m_pending.erase(pendingIt);
+        }
+        it = m_deadlines.erase(it);
+    }
+
+    // Resend under a fresh ID; replies to the old one are no longer matched
+    QList<Pending> expired;
+    for (Pending& entry : timedOut) {
+        entry.attempt++;
+        if (entry.attempt > entry.retries || !sendQuery(entry)) {
+            expired.append(entry);
+        }
+    }
+    locker.unlock();
+
+    int timeouts = timedOut.size();
+
+    for (int i = 0; i < timeouts; ++i) {
+        RateController::instance()->reportTimeout();
+    }
+
+    for (const Pending& entry : expired) {
+        PtrResult result;
+        result.address = entry.address;
+        result.status = Timeout;
+        result.ttl = TIMEOUT_TTL;
+        storeResult(result);
+        entry.callback(result);
+    }
+}
+
+int PtrResolver::nextWaitMs() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_deadlines.isEmpty()) {
+        return IDLE_WAIT_MS;
+    }
+
+    qint64 wait = m_deadlines.firstKey() - m_clock.elapsed();
+    return static_cast<int>(qBound<qint64>(0, wait, IDLE_WAIT_MS));
+}
+
+void PtrResolver::storeResult(const PtrResult& result)
+{
+    // A TTL of 0 means the answer must not be cached
+    if (result.ttl == 0) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    qint64 now = m_clock.elapsed();
+
+    if (m_cache.size() >= MAX_CACHE_ENTRIES && !m_cache.contains(result.address)) {
+        for (auto it = m_cache.begin(); it != m_cache.end();) {
+            if (it->expiresMs <= now) {
+                it = m_cache.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (m_cache.size() >= MAX_CACHE_ENTRIES) {
+            m_cache.clear();
+        }
+    }
+
+    CacheEntry entry;
+    entry.status = result.status;
+    entry.hostname = result.hostname;
+    entry.ttl = result.ttl;
+    entry.expiresMs = now + static_cast<qint64>(result.ttl) * 1000;
+    m_cache.insert(result.address, entry);
+}
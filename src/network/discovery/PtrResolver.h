@@ -0,0 +1,204 @@
+#ifndef PTRRESOLVER_H
+#define PTRRESOLVER_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMultiMap>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QThread>
+#include <functional>
+#include <atomic>
+
+/**
+ * @brief Multiplexed asynchronous reverse-DNS (PTR) resolver
+ *
+ * Sends raw DNS queries for d.c.b.a.in-addr.arpa over a few connected
+ * UDP sockets and matches answers by socket and transaction ID, so any
+ * number of lookups are in flight without a thread each. A receiver
+ * thread handles replies and deadlines; unanswered queries are resent
+ * with a fresh ID until the retries run out.
+ *
+ * Results are cached for the record TTL. NXDOMAIN and empty answers
+ * are cached negatively for the SOA minimum (RFC 2308), timeouts and
+ * server failures for a short fixed time, so hosts without a name do
+ * not cost the full timeout on every rescan.
+ *
+ * Linux/macOS only (POSIX sockets); isAvailable() is false elsewhere or
+ * when no IPv4 nameserver is configured, and DnsResolver falls back to
+ * QHostInfo.
+ */
+class PtrResolver
+{
+public:
+    enum Status {
+        Resolved,
+        NotFound,       ///< NXDOMAIN or no PTR record
+        Timeout,
+        Failed          ///< Server error or resolver unavailable
+    };
+
+    struct PtrResult {
+        quint32 address;    ///< Queried IPv4 address (host byte order)
+        Status status;
+        QString hostname;   ///< Without the trailing dot
+        quint32 ttl;        ///< Seconds the result is cached for
+        bool cached;        ///< Served from the cache
+
+        PtrResult()
+            : address(0), status(Failed), ttl(0), cached(false) {}
+    };
+
+    /**
+     * @brief Decoded DNS response (see parseResponse())
+     */
+    struct Response {
+        quint16 id;
+        int rcode;
+        QString questionName;
+        QString hostname;       ///< First PTR answer, empty if none
+        quint32 ttl;            ///< TTL of that answer
+        qint64 negativeTtl;     ///< SOA minimum from the authority section, -1 if absent
+
+        Response() : id(0), rcode(0), ttl(0), negativeTtl(-1) {}
+    };
+
+    using Callback = std::function<void(const PtrResult&)>;
+
+    static constexpr int DEFAULT_SOCKETS = 4;
+    static constexpr int DEFAULT_RETRIES = 2;
+    static constexpr quint32 TIMEOUT_TTL = 60;      ///< Seconds a timeout is cached
+    static constexpr quint32 NEGATIVE_TTL = 300;    ///< NXDOMAIN without SOA
+    static constexpr quint32 MAX_TTL = 86400;
+
+    /**
+     * @brief Shared resolver using the first IPv4 nameserver of the system
+     */
+    static PtrResolver* instance();
+
+    /**
+     * @brief Construct a resolver for a specific server
+     * @param server Nameserver IPv4 address (host byte order)
+     * @param port Nameserver UDP port
+     * @param socketCount Number of UDP sockets queries are spread over
+     */
+    explicit PtrResolver(quint32 server, quint16 port = 53, int socketCount = DEFAULT_SOCKETS);
+    ~PtrResolver();
+
+    PtrResolver(const PtrResolver&) = delete;
+    PtrResolver& operator=(const PtrResolver&) = delete;
+
+    bool isAvailable() const;
+
+    /**
+     * @brief Resend attempts after the first query times out
+     */
+    void setRetries(int retries);
+
+    /**
+     * @brief Start a lookup; the callback runs on the receiver thread, or
+     *        on the calling thread for cache hits and failures
+     * @param timeoutMs Deadline of the first attempt in milliseconds
+     * @param retries Resend attempts, -1 for the configured default
+     */
+    void submit(quint32 address, int timeoutMs, Callback callback, const void* owner = nullptr,
+                int retries = -1);
+
+    /**
+     * @brief Start lookups for all addresses at once
+     */
+    void submitBatch(const QVector<quint32>& addresses, int timeoutMs, Callback callback,
+                     const void* owner = nullptr, int retries = -1);
+
+    /**
+     * @brief Drop pending lookups of an owner; their callbacks never run
+     */
+    void cancel(const void* owner);
+
+    /**
+     * @brief Blocking single lookup
+     */
+    PtrResult resolve(quint32 address, int timeoutMs, int retries = -1);
+
+    /**
+     * @brief Blocking batch lookup, results in the same order as @p addresses
+     */
+    QVector<PtrResult> resolveBatch(const QVector<quint32>& addresses, int timeoutMs, int retries = -1);
+
+    /**
+     * @brief Cached result if present and not expired
+     */
+    bool cachedResult(quint32 address, PtrResult& result) const;
+
+    void clearCache();
+    int cacheSize() const;
+    int pendingCount() const;
+
+    static quint32 systemNameserver();
+    static QString reverseName(quint32 address);
+    static QByteArray buildQuery(quint16 id, quint32 address);
+    static bool parseResponse(const quint8* data, int length, Response& response);
+
+    /**
+     * @brief Read a (possibly compressed) DNS name at @p offset and advance past it
+     * @param name Receives the dotted name, may be null to skip
+     */
+    static bool readName(const quint8* data, int length, int& offset, QString* name);
+
+private:
+    struct Pending {
+        quint32 address;
+        int socket;
+        quint16 id;
+        int attempt;
+        int retries;
+        int timeoutMs;
+        qint64 deadlineMs;
+        Callback callback;
+        const void* owner;
+    };
+
+    struct CacheEntry {
+        Status status;
+        QString hostname;
+        quint32 ttl;
+        qint64 expiresMs;
+    };
+
+    static constexpr int MAX_MESSAGE_SIZE = 1232;
+    static constexpr int IDLE_WAIT_MS = 50;
+    static constexpr int MAX_CACHE_ENTRIES = 65536;
+    static constexpr quint16 DNS_TYPE_PTR = 12;
+    static constexpr quint16 DNS_TYPE_SOA = 6;
+
+    quint32 m_server;
+    quint16 m_port;
+    QVector<int> m_sockets;
+    bool m_available;
+    int m_retries;
+
+    mutable QMutex m_mutex;              ///< Guards pending state and the cache
+    QMutex m_dispatchMutex;              ///< Held while callbacks run (see cancel())
+    QHash<quint32, Pending> m_pending;   ///< (socket << 16 | id) -> query
+    QMultiMap<qint64, quint32> m_deadlines;
+    QHash<quint32, CacheEntry> m_cache;
+    int m_nextSocket;
+
+    QElapsedTimer m_clock;
+    QThread* m_receiver;
+    std::atomic<bool> m_running;
+
+    bool openSockets();
+    void closeSockets();
+    bool sendQuery(Pending& entry);
+    void receiveLoop();
+    void handleDatagram(int socket, const quint8* data, int length);
+    void expireDeadlines();
+    int nextWaitMs() const;
+    void storeResult(const PtrResult& result);
+
+    static quint32 pendingKey(int socket, quint16 id) { return (static_cast<quint32>(socket) << 16) | id; }
+};
+
+#endif // PTRRESOLVER_H
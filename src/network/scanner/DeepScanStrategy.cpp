@@ -1,45 +1,44 @@
 #include "DeepScanStrategy.h"
 #include "network/services/MacVendorLookup.h"
-#include "network/services/PortServiceMapper.h"
+#include "network/services/ServiceTable.h"
+#include "network/sockets/RttEstimator.h"
+#include "network/sockets/TcpConnectEngine.h"
+#include "network/sockets/UdpScanEngine.h"
 #include "utils/Logger.h"
 #include "models/PortInfo.h"
 #include "models/NetworkMetrics.h"
 #include <QDateTime>
-
-// Common ports to scan
-const QList<int> DeepScanStrategy::COMMON_PORTS = {
-    21,   // FTP
-    22,   // SSH
-    23,   // Telnet
-    25,   // SMTP
-    53,   // DNS
-    80,   // HTTP
-    110,  // POP3
-    143,  // IMAP
-    443,  // HTTPS
-    445,  // SMB
-    3306, // MySQL
-    3389, // RDP
-    5432, // PostgreSQL
-    5900, // VNC
-    8080, // HTTP-Alt
-    8443  // HTTPS-Alt
-};
+#include <QElapsedTimer>
+#include <QHostAddress>
 
 DeepScanStrategy::DeepScanStrategy()
     : m_hostDiscovery(new HostDiscovery())
     , m_dnsResolver(new DnsResolver())
     , m_pingService(new PingService())
+    , m_nameDiscovery(new NameDiscovery())
+    , m_pipeline(new ScanPipeline())
     , m_portScanningEnabled(true)  // Default: enabled for backward compatibility
+    , m_dnsEnabled(true)
+    , m_pipelined(false)
+    , m_serviceDetection(false)
     , m_dnsTimeout(3000)            // Default: 3 seconds (increased from 2s)
     , m_dnsMaxRetries(2)            // Default: 2 retries
 {
+    configureStages();
+
     Logger::debug(QString("DeepScanStrategy initialized (DNS timeout: %1ms, retries: %2)")
                  .arg(m_dnsTimeout).arg(m_dnsMaxRetries));
 }
 
 DeepScanStrategy::~DeepScanStrategy()
 {
+    // Stage workers use the services below. Once they are done no lookup
+    // starts; lookups still out are dropped so none completes into the pipeline
+    m_pipeline->cancel();
+    m_pipeline->waitForWorkers();
+    m_dnsResolver->cancelPending();
+    delete m_pipeline;
+    delete m_nameDiscovery;
     delete m_pingService;
     delete m_hostDiscovery;
     delete m_dnsResolver;
@@ -51,8 +50,13 @@ Device DeepScanStrategy::scan(const QString& ip)
     device.setIp(ip);
     device.setOnline(false);
 
-    // Use PingService to check if host is alive AND collect latency metrics
-    PingService::PingResult pingResult = m_pingService->pingSync(ip, 2000);
+    // Use PingService to check if host is alive AND collect latency metrics;
+    // the wait comes from the subnet's measured RTT instead of a fixed 2 s
+    quint32 address = QHostAddress(ip).toIPv4Address();
+    QElapsedTimer livenessTimer;
+    livenessTimer.start();
+    PingService::PingResult pingResult = m_pingService->pingSync(ip, RttEstimator::instance()->timeoutFor(address));
+    m_pipeline->recordStage(ScanPipeline::Liveness, livenessTimer.nsecsElapsed() / 1000000.0);
 
     if (!pingResult.success) {
         // Host is offline - return device with default metrics (0 latency, 0 quality)
@@ -89,8 +93,43 @@ Device DeepScanStrategy::scan(const QString& ip)
                   .arg(pingResult.latency, 0, 'f', 1)
                   .arg(metrics.getQualityScore()));
 
+    if (m_pipelined) {
+        // The remaining stages run on their own workers; this thread goes
+        // back to liveness checks (blocking only while the next queue is full)
+        m_pipeline->submit(device);
+        return device;
+    }
+
+    m_pipeline->runInline(device);
+
+    Logger::debug(QString("Deep scan complete: %1 has %2 open ports").arg(ip).arg(device.getOpenPorts().size()));
+
+    return device;
+}
+
+void DeepScanStrategy::configureStages()
+{
+    m_pipeline->setHandler(ScanPipeline::Identity, [this](Device& device) { lookupIdentity(device); });
+
+    if (m_dnsEnabled) {
+        // PTR queries overlap on the resolver's sockets instead of holding a worker each
+        m_pipeline->setAsyncHandler(ScanPipeline::Dns,
+            [this](const Device& device, ScanPipeline::Completion done) { resolveHostname(device, done); });
+    } else {
+        m_pipeline->setHandler(ScanPipeline::Dns, nullptr);
+    }
+
+    if (m_portScanningEnabled) {
+        m_pipeline->setHandler(ScanPipeline::Ports, [this](Device& device) { scanPorts(device); });
+    } else {
+        m_pipeline->setHandler(ScanPipeline::Ports, nullptr);
+    }
+}
+
+void DeepScanStrategy::lookupIdentity(Device& device)
+{
     // Get MAC address from ARP cache
-    QString mac = ArpDiscovery::getMacAddress(ip);
+    QString mac = ArpDiscovery::getMacAddress(device.getIp());
     if (!mac.isEmpty()) {
         device.setMacAddress(mac);
 
@@ -100,43 +139,161 @@ Device DeepScanStrategy::scan(const QString& ip)
             device.setVendor(vendor);
         }
     }
+}
+
+void DeepScanStrategy::resolveHostname(const Device& device, ScanPipeline::Completion done)
+{
+    QString ip = device.getIp();
+
+    // Names from the bulk pass first; wait for its window at most as long as a PTR lookup would take
+    if (m_nameDiscovery->isRunning()) {
+        m_nameDiscovery->wait(m_dnsTimeout);
+    }
+    QString discovered = m_nameDiscovery->hostname(QHostAddress(ip).toIPv4Address());
+    if (!discovered.isEmpty()) {
+        Device named = device;
+        named.setHostname(discovered);
+        Logger::debug(QString("Hostname discovered: %1 -> %2").arg(ip).arg(discovered));
+        done(named);
+        return;
+    }
 
     // Reverse DNS lookup for hostname with configured timeout and retries
-    QString hostname = m_dnsResolver->resolveSync(ip, m_dnsTimeout, m_dnsMaxRetries);
-    if (!hostname.isEmpty()) {
-        device.setHostname(hostname);
-        Logger::debug(QString("Hostname resolved: %1 -> %2").arg(ip).arg(hostname));
-    } else {
-        Logger::debug(QString("No hostname found for %1").arg(ip));
+    m_dnsResolver->resolveAsync(ip, m_dnsTimeout, m_dnsMaxRetries, [device, done](const QString& hostname) {
+        Device named = device;
+        if (!hostname.isEmpty()) {
+            named.setHostname(hostname);
+            Logger::debug(QString("Hostname resolved: %1 -> %2").arg(named.getIp()).arg(hostname));
+        } else {
+            Logger::debug(QString("No hostname found for %1").arg(named.getIp()));
+        }
+        done(named);
+    });
+}
+
+void DeepScanStrategy::scanPorts(Device& device)
+{
+    const ServiceTable& services = ServiceTable::instance();
+    const QList<int> ports = m_ports.isEmpty() ? services.topPorts(DEFAULT_TOP_PORTS) : m_ports;
+
+    if (m_serviceDetection && TcpConnectEngine::isSupported()) {
+        scanTcpPorts(device, ports);
+        if (!m_udpPorts.isEmpty()) {
+            scanUdpPorts(device);
+        }
+        return;
     }
 
-    // Scan common ports (only if enabled)
-    int openPortCount = 0;
+    for (int port : ports) {
+        if (scanPort(device.getIp(), port)) {
+            PortInfo portInfo;
+            portInfo.setPortNumber(port);
+            portInfo.setProtocol(PortInfo::TCP);
+            portInfo.setState(PortInfo::Open);
 
-    if (m_portScanningEnabled) {
-        PortServiceMapper portMapper;
+            QString service = services.serviceName(port, ServiceTable::Tcp);
+            portInfo.setService(service);
 
-        for (int port : COMMON_PORTS) {
-            if (scanPort(ip, port)) {
-                PortInfo portInfo;
-                portInfo.setPortNumber(port);
-                portInfo.setProtocol(PortInfo::TCP);
-                portInfo.setState(PortInfo::Open);
+            device.addPort(portInfo);
 
-                QString service = portMapper.getServiceName(port, "tcp");
-                portInfo.setService(service);
+            Logger::debug(QString("Port %1/%2 open (%3)").arg(port).arg("tcp").arg(service));
+        }
+    }
 
-                device.addPort(portInfo);
-                openPortCount++;
+    if (!m_udpPorts.isEmpty()) {
+        scanUdpPorts(device);
+    }
+}
 
-                Logger::debug(QString("Port %1/%2 open (%3)").arg(port).arg("tcp").arg(service));
-            }
+void DeepScanStrategy::scanTcpPorts(Device& device, const QList<int>& ports)
+{
+    bool isIpv4 = false;
+    quint32 address = QHostAddress(device.getIp()).toIPv4Address(&isIpv4);
+    if (!isIpv4) {
+        return;
+    }
+
+    QVector<quint16> targets;
+    targets.reserve(ports.size());
+    for (int port : ports) {
+        if (port > 0 && port <= 65535) {
+            targets.append(static_cast<quint16>(port));
         }
     }
 
-    Logger::debug(QString("Deep scan complete: %1 has %2 open ports").arg(ip).arg(openPortCount));
+    // Connects and banner sessions share one event loop on this port-stage worker
+    const ServiceTable& services = ServiceTable::instance();
+    TcpConnectEngine engine;
+    engine.setServiceProbing(true);
+    engine.setResultCallback([&](const TcpConnectEngine::ProbeResult& result) {
+        if (result.state != TcpConnectEngine::Open) {
+            return;
+        }
 
-    return device;
+        PortInfo portInfo;
+        portInfo.setPortNumber(result.port);
+        portInfo.setProtocol(PortInfo::TCP);
+        portInfo.setState(PortInfo::Open);
+
+        QString service = result.service.isEmpty()
+            ? services.serviceName(result.port, ServiceTable::Tcp)
+            : result.service;
+        portInfo.setService(service);
+        portInfo.setVersion(result.version);
+
+        device.addPort(portInfo);
+
+        Logger::debug(QString("Port %1/%2 open (%3 %4)").arg(result.port).arg("tcp")
+                     .arg(service).arg(result.version));
+    });
+
+    engine.addHost(address, targets, RttEstimator::instance()->timeoutFor(address));
+    engine.run();
+}
+
+void DeepScanStrategy::scanUdpPorts(Device& device)
+{
+    if (!UdpScanEngine::isSupported()) {
+        return;
+    }
+
+    bool isIpv4 = false;
+    quint32 address = QHostAddress(device.getIp()).toIPv4Address(&isIpv4);
+    if (!isIpv4) {
+        return;
+    }
+
+    QVector<quint16> ports;
+    ports.reserve(m_udpPorts.size());
+    for (int port : m_udpPorts) {
+        if (port > 0 && port <= 65535) {
+            ports.append(static_cast<quint16>(port));
+        }
+    }
+
+    // One engine per host: runs on this port-stage worker and returns when the host is done
+    const ServiceTable& services = ServiceTable::instance();
+    UdpScanEngine engine;
+    engine.setResultCallback([&](const UdpScanEngine::ProbeResult& result) {
+        if (result.state != UdpScanEngine::Open) {
+            return;
+        }
+
+        PortInfo portInfo;
+        portInfo.setPortNumber(result.port);
+        portInfo.setProtocol(PortInfo::UDP);
+        portInfo.setState(PortInfo::Open);
+
+        QString service = services.serviceName(result.port, ServiceTable::Udp);
+        portInfo.setService(service);
+
+        device.addPort(portInfo);
+
+        Logger::debug(QString("Port %1/%2 open (%3)").arg(result.port).arg("udp").arg(service));
+    });
+
+    engine.addHost(address, ports, RttEstimator::instance()->timeoutFor(address));
+    engine.run();
 }
 
 QString DeepScanStrategy::getName() const
@@ -152,6 +309,7 @@ QString DeepScanStrategy::getDescription() const
 void DeepScanStrategy::setPortScanningEnabled(bool enabled)
 {
     m_portScanningEnabled = enabled;
+    configureStages();
     Logger::debug(QString("Port scanning %1").arg(enabled ? "enabled" : "disabled"));
 }
 
@@ -167,8 +325,53 @@ void DeepScanStrategy::setDnsRetries(int maxRetries)
     Logger::debug(QString("DNS max retries set to %1").arg(m_dnsMaxRetries));
 }
 
+void DeepScanStrategy::setDnsEnabled(bool enabled)
+{
+    m_dnsEnabled = enabled;
+    configureStages();
+}
+
+bool DeepScanStrategy::startNameDiscovery(const QVector<quint32>& addresses)
+{
+    if (!NameDiscovery::isSupported() || addresses.size() > NameDiscovery::MAX_TARGETS) {
+        return false;
+    }
+    return m_nameDiscovery->start(addresses);
+}
+
+void DeepScanStrategy::setPorts(const QList<int>& ports)
+{
+    m_ports = ports;
+}
+
+void DeepScanStrategy::setUdpPorts(const QList<int>& ports)
+{
+    m_udpPorts = ports;
+}
+
+void DeepScanStrategy::setServiceDetection(bool enabled)
+{
+    m_serviceDetection = enabled;
+}
+
+void DeepScanStrategy::setPipelined(bool enabled)
+{
+    m_pipelined = enabled;
+}
+
 bool DeepScanStrategy::scanPort(const QString& ip, int port)
 {
+    quint32 address = QHostAddress(ip).toIPv4Address();
+    RttEstimator* estimator = RttEstimator::instance();
+
     TcpSocketManager socket;
-    return socket.connectToHost(ip, port, 500);
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!socket.connectToHost(ip, port, estimator->timeoutFor(address))) {
+        return false;
+    }
+
+    estimator->addSample(address, timer.nsecsElapsed() / 1000000.0);
+    return true;
 }
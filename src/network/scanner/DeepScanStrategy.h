@@ -5,16 +5,23 @@
 #include "network/discovery/HostDiscovery.h"
 #include "network/discovery/DnsResolver.h"
 #include "network/discovery/ArpDiscovery.h"
+#include "network/discovery/NameDiscovery.h"
 #include "network/sockets/TcpSocketManager.h"
 #include "network/diagnostics/PingService.h"
+#include "network/scanner/ScanPipeline.h"
 
 /**
  * Deep scan strategy - comprehensive host analysis
  * - Ping for host discovery with latency measurement
- * - DNS reverse lookup for hostname
+ * - Hostname from a bulk mDNS/LLMNR/NetBIOS pass, reverse DNS for the rest
  * - MAC address from ARP
- * - Common port scanning
- * - Service identification
+ * - Common port scanning (TCP, plus UDP when UDP ports are set)
+ * - Service identification (plus banner/version probes when enabled)
+ *
+ * By default scan() runs every step in order and returns the full result.
+ * In pipelined mode scan() only checks liveness and returns; online hosts
+ * continue through pipeline() stages (identity, DNS, ports), each with its
+ * own workers and queue, and the partial results arrive via its signals.
  */
 class DeepScanStrategy : public IScanStrategy
 {
@@ -32,19 +39,53 @@ public:
     // Configure DNS timeout and retries
     void setDnsTimeout(int timeoutMs);
     void setDnsRetries(int maxRetries);
+    void setDnsEnabled(bool enabled);
+
+    // Collect link-local names for all targets at once; the DNS stage then
+    // only does PTR lookups for hosts this pass could not name
+    bool startNameDiscovery(const QVector<quint32>& addresses);
+
+    // Ports probed by the port stage (empty for the DEFAULT_TOP_PORTS most frequent)
+    void setPorts(const QList<int>& ports);
+
+    // UDP ports probed by the port stage (empty for no UDP pass)
+    void setUdpPorts(const QList<int>& ports);
+
+    // Read banners / send light probes on open TCP ports to fill in versions
+    void setServiceDetection(bool enabled);
+
+    // Hand online hosts to the staged pipeline instead of finishing them in scan()
+    void setPipelined(bool enabled);
+    bool isPipelined() const { return m_pipelined; }
+    ScanPipeline* pipeline() const { return m_pipeline; }
 
 private:
     HostDiscovery* m_hostDiscovery;
     DnsResolver* m_dnsResolver;
     PingService* m_pingService;
+    NameDiscovery* m_nameDiscovery;
+    ScanPipeline* m_pipeline;
     bool m_portScanningEnabled;
+    bool m_dnsEnabled;
+    bool m_pipelined;
+    bool m_serviceDetection;
     int m_dnsTimeout;       // DNS timeout in milliseconds
     int m_dnsMaxRetries;    // Max DNS retry attempts
+    QList<int> m_ports;
+    QList<int> m_udpPorts;
 
-    // Common ports to scan
-    static const QList<int> COMMON_PORTS;
+    // Default port stage: most frequently open TCP ports from the service table
+    static constexpr int DEFAULT_TOP_PORTS = 20;
 
     bool scanPort(const QString& ip, int port);
+    void scanTcpPorts(Device& device, const QList<int>& ports);
+    void scanUdpPorts(Device& device);
+    void configureStages();
+
+    // Pipeline stages
+    void lookupIdentity(Device& device);
+    void resolveHostname(const Device& device, ScanPipeline::Completion done);
+    void scanPorts(Device& device);
 };
 
 #endif // DEEPSCANSTRATEGY_H
@@ -1,42 +1,134 @@
 #include "IpScanner.h"
+#include "ScanScheduler.h"
 #include "utils/Logger.h"
-#include "network/services/SubnetCalculator.h"
+#include "network/discovery/NeighborTable.h"
+#include "network/services/IndexPermutation.h"
 #include <QRunnable>
+#include <QElapsedTimer>
+#include <QHostAddress>
 
-// Worker class for scanning individual IPs
-class ScanWorker : public QObject, public QRunnable
+namespace {
+const int MAX_CHUNK_SIZE = 16;       // Contiguous addresses claimed per step
+const int BATCH_INTERVAL_MS = 250;   // Longest a worker holds results before delivering
+const quint64 MAX_TARGETS = 0x3FFFFFFF; // Keeps the shared chunk cursor within int range
+}
+
+// State shared by all workers of one scan
+struct ScanJob
 {
-    Q_OBJECT
+    TargetSet targets;
+    IndexPermutation order;
+    bool randomOrder;
+    IScanStrategy* strategy;
+    ScanScheduler* scheduler;
+    int schedulerJob;
+    int generation;
+    int chunkSize;
+    QAtomicInt cursor;
+    QAtomicInt scanned;
+    QAtomicInt activeWorkers;
+    QAtomicInt cancelled;
+};
 
+// Long-lived worker: claims address chunks until the job is drained and
+// delivers results in batches, so queued events scale with batches, not hosts
+class ScanWorker : public QRunnable
+{
 public:
-    ScanWorker(const QString& ip, IScanStrategy* strategy)
-        : m_ip(ip)
-        , m_strategy(strategy)
+    ScanWorker(IpScanner* scanner, const QSharedPointer<ScanJob>& job)
+        : m_scanner(scanner)
+        , m_job(job)
+        , m_pendingScanned(0)
     {
         setAutoDelete(true);
     }
 
     void run() override
     {
-        if (m_strategy) {
-            Device device = m_strategy->scan(m_ip);
-            if (device.isOnline()) {
-                emit deviceScanned(device);
-            } else {
-                // Still emit for progress tracking, even if offline
-                emit deviceScanned(device);
+        m_sinceFlush.start();
+        const int total = static_cast<int>(m_job->targets.size());
+
+        while (!m_job->cancelled.loadAcquire()) {
+            int start = m_job->cursor.fetchAndAddRelaxed(m_job->chunkSize);
+            if (start >= total) {
+                break;
+            }
+
+            int end = qMin(start + m_job->chunkSize, total);
+            int i = start;
+            for (; i < end && !m_job->cancelled.loadAcquire(); ++i) {
+                // Paused or preempted: deliver what is held, then wait at this position
+                if (m_job->scheduler && !m_job->scheduler->mayRun(m_job->schedulerJob)) {
+                    flush();
+                    if (!m_job->scheduler->waitTurn(m_job->schedulerJob, &m_job->cancelled)) {
+                        break;
+                    }
+                }
+
+                // Positions map through the permutation when the order is randomized
+                quint64 position = m_job->randomOrder ? m_job->order.map(i) : static_cast<quint64>(i);
+
+                // The only per-host string, built just before the strategy needs it
+                QString ip = QHostAddress(m_job->targets.at(position)).toString();
+                Device device = m_job->strategy->scan(ip);
+                if (device.isOnline()) {
+                    m_batch.append(device);
+                }
+                m_pendingScanned++;
+
+                if (m_sinceFlush.elapsed() >= BATCH_INTERVAL_MS) {
+                    flush();
+                }
+            }
+
+            // Only whole chunks count towards the resumable cursor
+            if (i == end) {
+                m_completedChunks.append(qMakePair(start, end));
             }
+            flush();
         }
-        emit scanComplete();
-    }
 
-signals:
-    void deviceScanned(const Device& device);
-    void scanComplete();
+        flush();
+
+        // Posted after this worker's last batch, so it is delivered after it
+        if (m_job->activeWorkers.fetchAndSubOrdered(1) == 1) {
+            IpScanner* scanner = m_scanner;
+            int generation = m_job->generation;
+            QMetaObject::invokeMethod(scanner, [scanner, generation]() {
+                scanner->onWorkersFinished(generation);
+            }, Qt::QueuedConnection);
+        }
+    }
 
 private:
-    QString m_ip;
-    IScanStrategy* m_strategy;
+    IpScanner* m_scanner;
+    QSharedPointer<ScanJob> m_job;
+    QVector<Device> m_batch;
+    QVector<QPair<int, int>> m_completedChunks;
+    int m_pendingScanned;
+    QElapsedTimer m_sinceFlush;
+
+    void flush()
+    {
+        m_sinceFlush.restart();
+        if (m_pendingScanned == 0 && m_completedChunks.isEmpty()) {
+            return;
+        }
+
+        int scanned = m_job->scanned.fetchAndAddOrdered(m_pendingScanned) + m_pendingScanned;
+        m_pendingScanned = 0;
+
+        IpScanner* scanner = m_scanner;
+        int generation = m_job->generation;
+        QVector<Device> batch;
+        batch.swap(m_batch);
+        QVector<QPair<int, int>> chunks;
+        chunks.swap(m_completedChunks);
+
+        QMetaObject::invokeMethod(scanner, [scanner, generation, batch, scanned, chunks]() {
+            scanner->onBatchScanned(generation, batch, scanned, chunks);
+        }, Qt::QueuedConnection);
+    }
 };
 
 IpScanner::IpScanner(QObject *parent)
@@ -47,6 +139,13 @@ IpScanner::IpScanner(QObject *parent)
     , m_scannedCount(0)
     , m_totalHosts(0)
     , m_devicesFound(0)
+    , m_generation(0)
+    , m_randomOrder(false)
+    , m_orderSeed(0)
+    , m_startIndex(0)
+    , m_scheduler(nullptr)
+    , m_schedulerJob(0)
+    , m_completedIndex(0)
 {
     // Set optimal thread count (CPU cores)
     m_threadPool->setMaxThreadCount(QThread::idealThreadCount());
@@ -65,7 +164,48 @@ void IpScanner::setScanStrategy(IScanStrategy* strategy)
     Logger::debug("Scan strategy set");
 }
 
-void IpScanner::startScan(const QString& cidr)
+void IpScanner::setRandomOrder(bool enabled, quint64 seed)
+{
+    m_randomOrder = enabled;
+    m_orderSeed = seed;
+}
+
+void IpScanner::setStartIndex(quint64 index)
+{
+    m_startIndex = index;
+}
+
+void IpScanner::setScheduler(ScanScheduler* scheduler, int jobId)
+{
+    m_scheduler = scheduler;
+    m_schedulerJob = jobId;
+}
+
+quint64 IpScanner::orderSeed() const
+{
+    return m_orderSeed;
+}
+
+quint64 IpScanner::completedIndex() const
+{
+    return m_completedIndex;
+}
+
+void IpScanner::startScan(const QString& targetSpec)
+{
+    QString error;
+    TargetSet targets = TargetSet::parse(targetSpec, &error);
+
+    if (targets.isEmpty()) {
+        Logger::error(QString("Invalid target specification: %1 %2").arg(targetSpec, error));
+        emit scanError("Invalid CIDR notation");
+        return;
+    }
+
+    startScan(targets, targetSpec);
+}
+
+void IpScanner::startScan(const TargetSet& targets, const QString& description)
 {
     if (m_isScanning.loadAcquire()) {
         Logger::warn("Scan already in progress");
@@ -79,30 +219,56 @@ void IpScanner::startScan(const QString& cidr)
         return;
     }
 
-    // Get IP range from CIDR
-    QStringList ipRange = SubnetCalculator::getIpRange(cidr);
+    if (targets.isEmpty() || targets.size() > MAX_TARGETS) {
+        Logger::error(QString("Target set size not supported: %1").arg(targets.size()));
+        emit scanError("Invalid target set");
+        return;
+    }
 
-    if (ipRange.isEmpty()) {
-        Logger::error(QString("Invalid CIDR notation: %1").arg(cidr));
-        emit scanError("Invalid CIDR notation");
+    if (m_startIndex >= targets.size()) {
+        Logger::error(QString("Start index %1 is beyond the %2 targets").arg(m_startIndex).arg(targets.size()));
+        emit scanError("Invalid start index");
         return;
     }
 
     resetCounters();
-    m_totalHosts = ipRange.size();
+    m_totalHosts = static_cast<int>(targets.size());
+    int startIndex = static_cast<int>(m_startIndex);
+
+    // Fresh neighbour snapshot; strategies then look MACs up without spawning arp
+    NeighborTable::instance()->beginScan();
     m_isScanning.storeRelease(1);
 
-    Logger::info(QString("Starting scan of %1 (%2 hosts)").arg(cidr).arg(m_totalHosts));
+    Logger::info(QString("Starting scan of %1 (%2 hosts, %3 order, from %4)")
+                 .arg(description).arg(m_totalHosts)
+                 .arg(m_randomOrder ? QString("random seed %1").arg(m_orderSeed) : QString("sequential"))
+                 .arg(startIndex));
     emit scanStarted(m_totalHosts);
 
-    // Create and queue scan workers
-    for (const QString& ip : ipRange) {
-        ScanWorker* worker = new ScanWorker(ip, m_strategy);
+    // A fixed set of workers shares the address list through a chunk cursor.
+    // Chunks shrink on small ranges so every worker still gets work.
+    int remaining = m_totalHosts - startIndex;
+    int workerCount = qMax(1, qMin(m_threadPool->maxThreadCount(), remaining));
 
-        connect(worker, &ScanWorker::deviceScanned, this, &IpScanner::onHostScanned, Qt::QueuedConnection);
-        connect(worker, &ScanWorker::scanComplete, this, &IpScanner::onScanComplete, Qt::QueuedConnection);
+    m_job.reset(new ScanJob);
+    m_job->targets = targets;
+    m_job->order = IndexPermutation(targets.size(), m_orderSeed);
+    m_job->randomOrder = m_randomOrder;
+    m_job->strategy = m_strategy;
+    m_job->scheduler = m_scheduler;
+    m_job->schedulerJob = m_schedulerJob;
+    m_job->generation = ++m_generation;
+    m_job->chunkSize = qBound(1, remaining / (workerCount * 4), MAX_CHUNK_SIZE);
+    m_job->cursor.storeRelaxed(startIndex);
+    m_job->scanned.storeRelaxed(startIndex);
+    m_scannedCount.storeRelease(startIndex);
+    m_completedIndex = m_startIndex;
+    m_completedChunks.clear();
+    m_job->activeWorkers.storeRelaxed(workerCount);
+    m_job->cancelled.storeRelaxed(0);
 
-        m_threadPool->start(worker);
+    for (int i = 0; i < workerCount; ++i) {
+        m_threadPool->start(new ScanWorker(this, m_job));
     }
 }
 
@@ -111,13 +277,24 @@ void IpScanner::stopScan()
     if (m_isScanning.loadAcquire()) {
         Logger::info("Stopping scan...");
         m_isScanning.storeRelease(0);
+        if (m_job) {
+            m_job->cancelled.storeRelease(1);
+        }
+        m_generation++;
         m_threadPool->clear();
-        m_threadPool->waitForDone(5000);
+        if (!m_threadPool->waitForDone(5000)) {
+            Logger::warn("Scan workers still running after stop; they exit after their current probe");
+        }
 
         emit scanFinished(m_devicesFound);
     }
 }
 
+bool IpScanner::waitForWorkers(int msecs)
+{
+    return m_threadPool->waitForDone(msecs);
+}
+
 bool IpScanner::isScanning() const
 {
     return m_isScanning.loadAcquire() != 0;
@@ -133,28 +310,53 @@ int IpScanner::getTotalHosts() const
     return m_totalHosts;
 }
 
-void IpScanner::onHostScanned(const Device& device)
+void IpScanner::onBatchScanned(int generation, const QVector<Device>& devices, int scanned,
+                               const QVector<QPair<int, int>>& chunks)
 {
-    if (device.isOnline()) {
-        m_devicesFound++;
+    if (generation != m_generation) {
+        return;
+    }
+
+    // Chunks finish out of order; the cursor only passes a contiguous run of them
+    for (const QPair<int, int>& chunk : chunks) {
+        m_completedChunks.insert(chunk.first, chunk.second);
+    }
+    auto next = m_completedChunks.find(static_cast<int>(m_completedIndex));
+    while (next != m_completedChunks.end()) {
+        m_completedIndex = static_cast<quint64>(next.value());
+        m_completedChunks.erase(next);
+        next = m_completedChunks.find(static_cast<int>(m_completedIndex));
+    }
+
+    m_devicesFound += devices.size();
+
+    if (!devices.isEmpty()) {
+        emit devicesDiscovered(devices);
+    }
+
+    for (const Device& device : devices) {
         Logger::debug(QString("Device found: %1 (%2)").arg(device.ip()).arg(device.hostname()));
         emit deviceDiscovered(device);
     }
 
-    int current = m_scannedCount.fetchAndAddAcquire(1) + 1;
-    emit scanProgress(current, m_totalHosts);
+    // Batches from different workers can arrive out of order
+    if (scanned > m_scannedCount.loadAcquire()) {
+        m_scannedCount.storeRelease(scanned);
+        emit scanProgress(scanned, m_totalHosts);
+    }
 }
 
-void IpScanner::onScanComplete()
+void IpScanner::onWorkersFinished(int generation)
 {
-    int scanned = m_scannedCount.loadAcquire();
-
-    if (scanned >= m_totalHosts) {
-        m_isScanning.storeRelease(0);
-        Logger::info(QString("Scan completed. Found %1 devices out of %2 hosts")
-                     .arg(m_devicesFound).arg(m_totalHosts));
-        emit scanFinished(m_devicesFound);
+    if (generation != m_generation || !m_isScanning.loadAcquire()) {
+        return;
     }
+
+    m_isScanning.storeRelease(0);
+    m_job.reset();
+    Logger::info(QString("Scan completed. Found %1 devices out of %2 hosts")
+                 .arg(m_devicesFound).arg(m_totalHosts));
+    emit scanFinished(m_devicesFound);
 }
 
 void IpScanner::resetCounters()
@@ -163,5 +365,3 @@ void IpScanner::resetCounters()
     m_totalHosts = 0;
     m_devicesFound = 0;
 }
-
-#include "IpScanner.moc"
@@ -4,8 +4,16 @@
 #include <QObject>
 #include <QThreadPool>
 #include <QAtomicInt>
+#include <QSharedPointer>
+#include <QVector>
+#include <QHash>
+#include <QPair>
 #include "models/Device.h"
 #include "interfaces/IScanStrategy.h"
+#include "network/services/TargetSet.h"
+
+struct ScanJob;
+class ScanScheduler;
 
 class IpScanner : public QObject
 {
@@ -16,8 +24,18 @@ public:
     ~IpScanner();
 
     void setScanStrategy(IScanStrategy* strategy);
-    void startScan(const QString& cidr);
+    void setRandomOrder(bool enabled, quint64 seed = 0);  // Same seed, same order
+    void setStartIndex(quint64 index);                     // Position in scan order to resume from
+    void setScheduler(ScanScheduler* scheduler, int jobId); // Workers wait their turn before each probe
+    quint64 orderSeed() const;
+
+    // Every position in scan order below this has been probed and its results
+    // delivered; resuming from here re-probes nothing that finished
+    quint64 completedIndex() const;
+    void startScan(const QString& targetSpec);
+    void startScan(const TargetSet& targets, const QString& description = QString());
     void stopScan();
+    bool waitForWorkers(int msecs = -1);  // True once no worker of any scan is left running
 
     bool isScanning() const;
     int getProgress() const;
@@ -25,23 +43,34 @@ public:
 
 signals:
     void deviceDiscovered(const Device& device);
+    void devicesDiscovered(const QVector<Device>& devices);  // Batched, emitted before the per-device signals
     void scanProgress(int current, int total);
     void scanStarted(int totalHosts);
     void scanFinished(int devicesFound);
     void scanError(const QString& error);
 
-private slots:
-    void onHostScanned(const Device& device);
-    void onScanComplete();
-
 private:
+    friend class ScanWorker;
+
     IScanStrategy* m_strategy;
     QThreadPool* m_threadPool;
     QAtomicInt m_isScanning;
     QAtomicInt m_scannedCount;
     int m_totalHosts;
     int m_devicesFound;
+    int m_generation;                  // Drops batches from a stopped scan
+    bool m_randomOrder;
+    quint64 m_orderSeed;
+    quint64 m_startIndex;
+    ScanScheduler* m_scheduler;        // Not owned, nullptr = never held back
+    int m_schedulerJob;
+    quint64 m_completedIndex;          // Resumable cursor, see completedIndex()
+    QHash<int, int> m_completedChunks; // Finished chunks past the cursor: start -> end
+    QSharedPointer<ScanJob> m_job;
 
+    void onBatchScanned(int generation, const QVector<Device>& devices, int scanned,
+                        const QVector<QPair<int, int>>& chunks);
+    void onWorkersFinished(int generation);
     void resetCounters();
 };
 
@@ -0,0 +1,165 @@
+#include "Ipv6ScanStrategy.h"
+#include "network/discovery/NeighborTable.h"
+#include "network/services/MacVendorLookup.h"
+#include "utils/Logger.h"
+#include <QHostAddress>
+#include <QHash>
+#include <QDateTime>
+
+namespace {
+const int UNICAST_TIMEOUT_MS = 1000;
+
+// Global and unique-local addresses are stable across links; link-local ones need a zone
+bool preferredOver(const QString& candidate, const QString& current)
+{
+    if (current.isEmpty()) {
+        return true;
+    }
+    return !QHostAddress(candidate).isLinkLocal() && QHostAddress(current).isLinkLocal();
+}
+}
+
+Ipv6ScanStrategy::Ipv6ScanStrategy()
+    : m_windowMs(Ipv6Discovery::DEFAULT_WINDOW_MS)
+{
+}
+
+Ipv6ScanStrategy::~Ipv6ScanStrategy()
+{
+}
+
+Device Ipv6ScanStrategy::scan(const QString& ip)
+{
+    Device device;
+    device.setIp(ip);
+    device.setOnline(false);
+
+    // A private engine: scan() may run on several pool threads at once
+    Ipv6Discovery discovery;
+    discovery.setMulticastDestination(QString());
+    discovery.setUseNeighborTable(false);
+    discovery.setCandidates(QStringList() << ip);
+
+    const QList<Ipv6Discovery::Host> hosts = discovery.discover(UNICAST_TIMEOUT_MS);
+    if (hosts.isEmpty()) {
+        return device;
+    }
+
+    device.setOnline(true);
+    device.setLastSeen(QDateTime::currentDateTime());
+    device.addIpv6Address(ip);
+
+    QString normalized = Device::normalizeIpv6(ip);
+    const QHash<QString, QString> neighbors = NeighborTable::readKernelTable6();
+    for (auto it = neighbors.constBegin(); it != neighbors.constEnd(); ++it) {
+        if (Device::normalizeIpv6(it.key()) == normalized) {
+            device.setMacAddress(it.value());
+            QString vendor = MacVendorLookup::instance()->lookupVendor(it.value());
+            if (!vendor.isEmpty() && vendor != "Unknown") {
+                device.setVendor(vendor);
+            }
+            break;
+        }
+    }
+
+    Logger::debug(QString("IPv6 scan: %1 is online").arg(ip));
+    return device;
+}
+
+QString Ipv6ScanStrategy::getName() const
+{
+    return "IPv6 Scan";
+}
+
+QString Ipv6ScanStrategy::getDescription() const
+{
+    return "IPv6 link discovery using multicast echo, the neighbour cache and EUI-64 candidates. No port scanning.";
+}
+
+void Ipv6ScanStrategy::setInterface(const QString& interfaceName)
+{
+    m_interface = interfaceName;
+}
+
+void Ipv6ScanStrategy::setKnownMacs(const QStringList& macs)
+{
+    m_knownMacs = macs;
+}
+
+void Ipv6ScanStrategy::setCandidates(const QStringList& addresses)
+{
+    m_candidates = addresses;
+}
+
+void Ipv6ScanStrategy::setWindowMs(int windowMs)
+{
+    m_windowMs = windowMs;
+}
+
+void Ipv6ScanStrategy::cancel()
+{
+    m_discovery.cancel();
+}
+
+QList<Device> Ipv6ScanStrategy::discoverAll()
+{
+    QStringList candidates = m_candidates;
+    candidates.append(Ipv6Discovery::eui64Candidates(m_knownMacs, m_interface));
+    candidates.removeDuplicates();
+
+    m_discovery.setInterface(m_interface);
+    m_discovery.setCandidates(candidates);
+    const QList<Ipv6Discovery::Host> hosts = m_discovery.discover(m_windowMs);
+
+    // One device per MAC; hosts without one (no neighbour entry yet) stand alone
+    QHash<QString, QList<Ipv6Discovery::Host>> byMac;
+    QList<Device> devices;
+    const QHash<quint32, QString> ipv4Neighbors = NeighborTable::readKernelTable();
+    QHash<QString, quint32> ipv4ByMac;
+    for (auto it = ipv4Neighbors.constBegin(); it != ipv4Neighbors.constEnd(); ++it) {
+        ipv4ByMac.insert(it.value().toUpper(), it.key());
+    }
+
+    for (const Ipv6Discovery::Host& host : hosts) {
+        if (host.mac.isEmpty()) {
+            devices.append(toDevice(QList<Ipv6Discovery::Host>() << host, QString()));
+        } else {
+            byMac[host.mac.toUpper()].append(host);
+        }
+    }
+
+    for (auto it = byMac.constBegin(); it != byMac.constEnd(); ++it) {
+        auto ipv4 = ipv4ByMac.constFind(it.key());
+        devices.append(toDevice(it.value(), ipv4 == ipv4ByMac.constEnd()
+                                            ? QString() : QHostAddress(ipv4.value()).toString()));
+    }
+
+    Logger::info(QString("IPv6 scan: %1 devices from %2 addresses").arg(devices.size()).arg(hosts.size()));
+    return devices;
+}
+
+Device Ipv6ScanStrategy::toDevice(const QList<Ipv6Discovery::Host>& hosts, const QString& ipv4)
+{
+    Device device;
+    QString primary;
+
+    for (const Ipv6Discovery::Host& host : hosts) {
+        device.addIpv6Address(host.address);
+        if (preferredOver(host.address, primary)) {
+            primary = host.address;
+        }
+    }
+    device.setIp(ipv4.isEmpty() ? primary : ipv4);
+    device.setOnline(true);
+    device.setLastSeen(QDateTime::currentDateTime());
+
+    QString mac = hosts.first().mac;
+    if (!mac.isEmpty()) {
+        device.setMacAddress(mac.toUpper());
+        QString vendor = MacVendorLookup::instance()->lookupVendor(mac);
+        if (!vendor.isEmpty() && vendor != "Unknown") {
+            device.setVendor(vendor);
+        }
+    }
+    return device;
+}
@@ -0,0 +1,65 @@
+#ifndef IPV6SCANSTRATEGY_H
+#define IPV6SCANSTRATEGY_H
+
+#include "interfaces/IScanStrategy.h"
+#include "network/discovery/Ipv6Discovery.h"
+#include <QList>
+#include <QStringList>
+
+/**
+ * IPv6 scan strategy - link discovery instead of an address sweep
+ * discoverAll() finds the hosts on the attached links through multicast
+ * echo, the neighbour cache and EUI-64 candidates derived from MAC
+ * addresses already known from IPv4 scans or passive listening.
+ * scan() checks a single IPv6 address with unicast echo.
+ * No port scanning.
+ */
+class Ipv6ScanStrategy : public IScanStrategy
+{
+public:
+    Ipv6ScanStrategy();
+    ~Ipv6ScanStrategy() override;
+
+    Device scan(const QString& ip) override;
+    QString getName() const override;
+    QString getDescription() const override;
+
+    void setInterface(const QString& interfaceName);
+
+    /**
+     * @brief MAC addresses whose SLAAC EUI-64 addresses are probed
+     */
+    void setKnownMacs(const QStringList& macs);
+
+    /**
+     * @brief Extra IPv6 addresses to probe, e.g. seen passively
+     */
+    void setCandidates(const QStringList& addresses);
+
+    void setWindowMs(int windowMs);
+
+    /**
+     * @brief Find every IPv6 host on the link(s), one Device per MAC
+     *
+     * Hosts with a known IPv4 neighbour entry keep the IPv4 address as
+     * their primary IP so they merge with the existing record; the rest
+     * are listed under their best IPv6 address (global before link-local).
+     */
+    QList<Device> discoverAll();
+
+    /**
+     * @brief Stop a running discoverAll() early (thread-safe)
+     */
+    void cancel();
+
+private:
+    Ipv6Discovery m_discovery;
+    QString m_interface;
+    QStringList m_knownMacs;
+    QStringList m_candidates;
+    int m_windowMs;
+
+    static Device toDevice(const QList<Ipv6Discovery::Host>& hosts, const QString& ipv4);
+};
+
+#endif // IPV6SCANSTRATEGY_H
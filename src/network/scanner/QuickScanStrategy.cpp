@@ -1,6 +1,8 @@
 #include "QuickScanStrategy.h"
 #include "network/services/MacVendorLookup.h"
+#include "network/sockets/RttEstimator.h"
 #include "utils/Logger.h"
+#include <QHostAddress>
 
 QuickScanStrategy::QuickScanStrategy()
     : m_hostDiscovery(new HostDiscovery())
@@ -18,8 +20,9 @@ Device QuickScanStrategy::scan(const QString& ip)
     device.setIp(ip);
     device.setOnline(false);
 
-    // Check if host is alive
-    bool alive = m_hostDiscovery->isHostAlive(ip, 1000);
+    // Check if host is alive; dead hosts cost one subnet RTO, not a fixed second
+    int timeout = RttEstimator::instance()->timeoutFor(QHostAddress(ip).toIPv4Address());
+    bool alive = m_hostDiscovery->isHostAlive(ip, timeout);
 
     if (alive) {
         device.setOnline(true);
@@ -0,0 +1,342 @@
+#include "ScanPipeline.h"
+#include "ScanScheduler.h"
+#include "utils/Logger.h"
+#include <QElapsedTimer>
+#include <QThread>
+
+namespace {
+// Defaults per stage: DNS mostly waits on the resolver, port probing holds sockets.
+// Liveness runs on the caller's threads and gets no pool.
+const int DEFAULT_CONCURRENCY[ScanPipeline::StageCount] = { 0, 4, 16, 8 };
+}
+
+ScanPipeline::ScanPipeline(QObject* parent)
+    : QObject(parent)
+    , m_pending(0)
+    , m_cancelled(0)
+    , m_scheduler(nullptr)
+    , m_schedulerJob(0)
+{
+    for (int i = 0; i < StageCount; ++i) {
+        StageState& state = m_stages[i];
+        state.pool = nullptr;
+        if (i != Liveness) {
+            state.pool = new QThreadPool(this);
+            state.pool->setMaxThreadCount(DEFAULT_CONCURRENCY[i]);
+        }
+        state.slots = new QSemaphore(DEFAULT_QUEUE_CAPACITY);
+        state.inFlight = new QSemaphore(ASYNC_IN_FLIGHT);
+        state.capacity = DEFAULT_QUEUE_CAPACITY;
+        state.processed = 0;
+        state.totalLatencyMs = 0.0;
+        state.maxLatencyMs = 0.0;
+    }
+}
+
+ScanPipeline::~ScanPipeline()
+{
+    cancel();
+    for (StageState& state : m_stages) {
+        if (state.pool) {
+            state.pool->waitForDone();
+        }
+    }
+    for (StageState& state : m_stages) {
+        delete state.slots;
+        delete state.inFlight;
+    }
+}
+
+void ScanPipeline::setHandler(Stage stage, StageHandler handler)
+{
+    m_stages[stage].handler = std::move(handler);
+    m_stages[stage].asyncHandler = nullptr;
+}
+
+void ScanPipeline::setAsyncHandler(Stage stage, AsyncStageHandler handler)
+{
+    m_stages[stage].asyncHandler = std::move(handler);
+    m_stages[stage].handler = nullptr;
+}
+
+void ScanPipeline::setConcurrency(Stage stage, int workers)
+{
+    if (!m_stages[stage].pool) {
+        Logger::warn("ScanPipeline: " + stageName(stage) + " runs on the caller's threads");
+        return;
+    }
+    m_stages[stage].pool->setMaxThreadCount(qMax(1, workers));
+}
+
+void ScanPipeline::setQueueCapacity(Stage stage, int capacity)
+{
+    if (!isIdle()) {
+        Logger::warn("ScanPipeline: Queue capacity can only change while idle");
+        return;
+    }
+
+    StageState& state = m_stages[stage];
+    delete state.slots;
+    state.capacity = qMax(1, capacity);
+    state.slots = new QSemaphore(state.capacity);
+}
+
+void ScanPipeline::setScheduler(ScanScheduler* scheduler, int jobId)
+{
+    m_scheduler = scheduler;
+    m_schedulerJob = jobId;
+}
+
+bool ScanPipeline::isEnabled(Stage stage) const
+{
+    return stage != Liveness
+        && (static_cast<bool>(m_stages[stage].handler) || static_cast<bool>(m_stages[stage].asyncHandler));
+}
+
+bool ScanPipeline::submit(const Device& device, Stage stage)
+{
+    if (m_cancelled.loadAcquire()) {
+        return false;
+    }
+
+    int first = nextStage(qMax<int>(stage, Identity));
+    if (first < 0) {
+        emit deviceCompleted(device);
+        return true;
+    }
+
+    m_pending.ref();
+    {
+        QMutexLocker locker(&m_hostsMutex);
+        m_pendingHosts[device.getIp()]++;
+    }
+    if (!enqueue(first, device)) {
+        leave(device, false);
+        return false;
+    }
+    return true;
+}
+
+void ScanPipeline::runInline(Device& device, Stage stage)
+{
+    for (int s = nextStage(qMax<int>(stage, Identity)); s >= 0; s = nextStage(s + 1)) {
+        QElapsedTimer timer;
+        timer.start();
+        if (m_stages[s].asyncHandler) {
+            QSemaphore done;
+            m_stages[s].asyncHandler(device, [&device, &done](const Device& result) {
+                device = result;
+                done.release();
+            });
+            done.acquire();
+        } else {
+            m_stages[s].handler(device);
+        }
+        recordStage(static_cast<Stage>(s), timer.nsecsElapsed() / 1000000.0);
+    }
+}
+
+void ScanPipeline::recordStage(Stage stage, double latencyMs)
+{
+    QMutexLocker locker(&m_statsMutex);
+    StageState& state = m_stages[stage];
+    state.processed++;
+    state.totalLatencyMs += latencyMs;
+    state.maxLatencyMs = qMax(state.maxLatencyMs, latencyMs);
+}
+
+ScanPipeline::StageStats ScanPipeline::stats(Stage stage) const
+{
+    const StageState& state = m_stages[stage];
+
+    StageStats result;
+    result.queueDepth = state.queued.loadAcquire();
+    result.active = state.active.loadAcquire();
+    result.concurrency = state.pool ? state.pool->maxThreadCount() : 0;
+    result.queueCapacity = state.capacity;
+
+    QMutexLocker locker(&m_statsMutex);
+    result.processed = state.processed;
+    result.averageLatencyMs = state.processed > 0 ? state.totalLatencyMs / state.processed : 0.0;
+    result.maxLatencyMs = state.maxLatencyMs;
+    return result;
+}
+
+int ScanPipeline::pendingDevices() const
+{
+    return m_pending.loadAcquire();
+}
+
+QStringList ScanPipeline::pendingHosts() const
+{
+    QMutexLocker locker(&m_hostsMutex);
+    return m_pendingHosts.keys();
+}
+
+bool ScanPipeline::isIdle() const
+{
+    return m_pending.loadAcquire() == 0;
+}
+
+bool ScanPipeline::waitForWorkers(int msecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    for (StageState& state : m_stages) {
+        if (!state.pool) {
+            continue;
+        }
+        int remaining = msecs < 0 ? -1 : qMax<int>(0, msecs - static_cast<int>(timer.elapsed()));
+        if (!state.pool->waitForDone(remaining)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ScanPipeline::waitForIdle(int msecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (!isIdle()) {
+        if (msecs >= 0 && timer.elapsed() >= msecs) {
+            return false;
+        }
+        QThread::msleep(10);
+    }
+    return true;
+}
+
+void ScanPipeline::cancel()
+{
+    m_cancelled.storeRelease(1);
+}
+
+void ScanPipeline::reset()
+{
+    m_cancelled.storeRelease(0);
+}
+
+QString ScanPipeline::stageName(Stage stage)
+{
+    switch (stage) {
+        case Liveness: return "liveness";
+        case Identity: return "identity";
+        case Dns: return "dns";
+        case Ports: return "ports";
+        default: return "unknown";
+    }
+}
+
+int ScanPipeline::nextStage(int stage) const
+{
+    for (int s = stage; s < StageCount; ++s) {
+        if (isEnabled(static_cast<Stage>(s))) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+bool ScanPipeline::enqueue(int stage, const Device& device)
+{
+    StageState& state = m_stages[stage];
+
+    // Bounded queue: wait for a free entry, giving up on cancel
+    while (!state.slots->tryAcquire(1, SUBMIT_POLL_MS)) {
+        if (m_cancelled.loadAcquire()) {
+            return false;
+        }
+    }
+
+    state.queued.ref();
+    state.pool->start([this, stage, device]() {
+        runStage(stage, device);
+    });
+    return true;
+}
+
+void ScanPipeline::runStage(int stage, Device device)
+{
+    StageState& state = m_stages[stage];
+    state.queued.deref();
+    state.slots->release();
+
+    if (m_cancelled.loadAcquire()) {
+        leave(device, false);
+        return;
+    }
+
+    // Paused or preempted: the device keeps its place in the stage until resumed
+    if (m_scheduler && !m_scheduler->waitTurn(m_schedulerJob, &m_cancelled)) {
+        leave(device, false);
+        return;
+    }
+
+    if (state.asyncHandler) {
+        // Bounded like the queues: wait for a free operation slot, giving up on cancel
+        while (!state.inFlight->tryAcquire(1, SUBMIT_POLL_MS)) {
+            if (m_cancelled.loadAcquire()) {
+                leave(device, false);
+                return;
+            }
+        }
+
+        state.active.ref();
+        QElapsedTimer timer;
+        timer.start();
+        state.asyncHandler(device, [this, stage, timer](const Device& result) {
+            StageState& done = m_stages[stage];
+            double latency = timer.nsecsElapsed() / 1000000.0;
+            done.active.deref();
+            done.inFlight->release();
+
+            // May run on another component's thread; hand over from a stage worker
+            done.pool->start([this, stage, result, latency]() {
+                finishStage(stage, result, latency);
+            });
+        });
+        return;
+    }
+
+    state.active.ref();
+    QElapsedTimer timer;
+    timer.start();
+    state.handler(device);
+    double latency = timer.nsecsElapsed() / 1000000.0;
+    state.active.deref();
+
+    finishStage(stage, device, latency);
+}
+
+void ScanPipeline::finishStage(int stage, const Device& device, double latencyMs)
+{
+    recordStage(static_cast<Stage>(stage), latencyMs);
+    emit deviceUpdated(device, stage);
+
+    int next = nextStage(stage + 1);
+    if (next < 0) {
+        leave(device, true);
+    } else if (!enqueue(next, device)) {
+        leave(device, false);
+    }
+}
+
+void ScanPipeline::leave(const Device& device, bool completed)
+{
+    {
+        QMutexLocker locker(&m_hostsMutex);
+        auto it = m_pendingHosts.find(device.getIp());
+        if (it != m_pendingHosts.end() && --it.value() <= 0) {
+            m_pendingHosts.erase(it);
+        }
+    }
+    if (completed) {
+        emit deviceCompleted(device);
+    }
+    if (!m_pending.deref()) {
+        emit idle();
+    }
+}
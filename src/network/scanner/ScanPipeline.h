@@ -0,0 +1,138 @@
+#ifndef SCANPIPELINE_H
+#define SCANPIPELINE_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QVector>
+#include <QHash>
+#include <QStringList>
+#include <functional>
+#include "models/Device.h"
+
+class ScanScheduler;
+
+/**
+ * Staged host analysis: liveness -> identity (MAC/vendor) -> DNS -> ports.
+ *
+ * Every stage after liveness has its own worker pool (concurrency limit)
+ * and a bounded input queue. A stage hands the device to the next enabled
+ * stage and emits deviceUpdated() with the partial result, so a slow DNS
+ * server only backs up the DNS queue. When a queue is full the submitter
+ * blocks, which throttles the stage feeding it.
+ *
+ * A stage with an asynchronous handler is done when the handler calls its
+ * completion, not when it returns: its workers only start operations, so
+ * up to ASYNC_IN_FLIGHT of them overlap (e.g. PTR queries on one socket).
+ *
+ * Liveness runs on the caller's threads (the IpScanner workers); it is
+ * only measured here via recordStage(). Stages without a handler are
+ * skipped. With a scheduler set, each stage step waits for the job's turn
+ * first, so a paused scan stops its later stages too.
+ */
+class ScanPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Stage {
+        Liveness = 0,
+        Identity,
+        Dns,
+        Ports,
+        StageCount
+    };
+
+    struct StageStats {
+        int queueDepth;         // Waiting for a worker
+        int active;             // Being processed
+        int concurrency;
+        int queueCapacity;
+        quint64 processed;
+        double averageLatencyMs;
+        double maxLatencyMs;
+
+        StageStats()
+            : queueDepth(0), active(0), concurrency(0), queueCapacity(0)
+            , processed(0), averageLatencyMs(0.0), maxLatencyMs(0.0) {}
+    };
+
+    using StageHandler = std::function<void(Device&)>;
+    using Completion = std::function<void(const Device&)>;
+    using AsyncStageHandler = std::function<void(const Device&, Completion)>;
+
+    static constexpr int DEFAULT_QUEUE_CAPACITY = 256;
+    static constexpr int ASYNC_IN_FLIGHT = 256;     // Outstanding operations per asynchronous stage
+
+    explicit ScanPipeline(QObject* parent = nullptr);
+    ~ScanPipeline() override;
+
+    void setHandler(Stage stage, StageHandler handler);   // Empty handler skips the stage
+    void setAsyncHandler(Stage stage, AsyncStageHandler handler);  // Completion may run on any thread
+    void setConcurrency(Stage stage, int workers);
+    void setQueueCapacity(Stage stage, int capacity);     // Only while idle
+    void setScheduler(ScanScheduler* scheduler, int jobId); // Only while idle; nullptr = never held back
+    bool isEnabled(Stage stage) const;
+
+    // Enter the device at the first enabled stage from `stage` on; blocks
+    // while that stage's queue is full. False if cancelled.
+    bool submit(const Device& device, Stage stage = Identity);
+
+    // Run the enabled stages from `stage` on, on the calling thread
+    void runInline(Device& device, Stage stage = Identity);
+
+    void recordStage(Stage stage, double latencyMs);      // For stages run outside the pools
+
+    StageStats stats(Stage stage) const;
+    int pendingDevices() const;                           // Queued or in a stage
+    QStringList pendingHosts() const;                     // IPs of those devices, for checkpoints
+    bool isIdle() const;
+    bool waitForIdle(int msecs = -1);
+    bool waitForWorkers(int msecs = -1);                  // Asynchronous operations may still be out
+
+    void cancel();                                        // Queued devices are dropped
+    void reset();
+
+    static QString stageName(Stage stage);
+
+signals:
+    void deviceUpdated(const Device& device, int stage);  // After each completed stage
+    void deviceCompleted(const Device& device);
+    void idle();                                          // Last device left the pipeline
+
+private:
+    struct StageState {
+        StageHandler handler;
+        AsyncStageHandler asyncHandler;
+        QThreadPool* pool;      // nullptr for Liveness
+        QSemaphore* slots;      // Free queue entries
+        QSemaphore* inFlight;   // Free operation slots of an asynchronous stage
+        int capacity;
+        QAtomicInt queued;
+        QAtomicInt active;
+        quint64 processed;
+        double totalLatencyMs;
+        double maxLatencyMs;
+    };
+
+    StageState m_stages[StageCount];
+    mutable QMutex m_statsMutex;
+    QAtomicInt m_pending;
+    mutable QMutex m_hostsMutex;
+    QHash<QString, int> m_pendingHosts;   // IP -> devices in flight for it
+    QAtomicInt m_cancelled;
+    ScanScheduler* m_scheduler;
+    int m_schedulerJob;
+
+    static constexpr int SUBMIT_POLL_MS = 50;
+
+    int nextStage(int stage) const;
+    bool enqueue(int stage, const Device& device);
+    void runStage(int stage, Device device);
+    void finishStage(int stage, const Device& device, double latencyMs);
+    void leave(const Device& device, bool completed);
+};
+
+#endif // SCANPIPELINE_H
@@ -0,0 +1,116 @@
+#include "ScanScheduler.h"
+#include "utils/Logger.h"
+#include <QMutexLocker>
+
+ScanScheduler::ScanScheduler()
+    : m_nextId(1)
+{
+}
+
+ScanScheduler* ScanScheduler::instance()
+{
+    // Function-local static: initialized once, thread-safe
+    static ScanScheduler* scheduler = new ScanScheduler();
+    return scheduler;
+}
+
+int ScanScheduler::registerJob(Priority priority)
+{
+    QMutexLocker locker(&m_mutex);
+    int jobId = m_nextId++;
+    m_jobs.insert(jobId, Job{priority, false});
+
+    // A higher priority job holds back the others from their next probe on
+    m_changed.wakeAll();
+    Logger::debug(QString("ScanScheduler: Job %1 registered with priority %2").arg(jobId).arg(priority));
+    return jobId;
+}
+
+void ScanScheduler::unregisterJob(int jobId)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_jobs.remove(jobId) > 0) {
+        m_changed.wakeAll();
+    }
+}
+
+void ScanScheduler::setPriority(int jobId, Priority priority)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_jobs.find(jobId);
+    if (it != m_jobs.end()) {
+        it->priority = priority;
+        m_changed.wakeAll();
+    }
+}
+
+void ScanScheduler::pause(int jobId)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_jobs.find(jobId);
+    if (it != m_jobs.end()) {
+        it->paused = true;
+        // A paused job no longer holds back lower priorities
+        m_changed.wakeAll();
+    }
+}
+
+void ScanScheduler::resume(int jobId)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_jobs.find(jobId);
+    if (it != m_jobs.end()) {
+        it->paused = false;
+        m_changed.wakeAll();
+    }
+}
+
+bool ScanScheduler::isPaused(int jobId) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_jobs.constFind(jobId);
+    return it != m_jobs.constEnd() && it->paused;
+}
+
+int ScanScheduler::jobCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_jobs.size();
+}
+
+bool ScanScheduler::mayRun(int jobId) const
+{
+    QMutexLocker locker(&m_mutex);
+    return mayRunLocked(jobId);
+}
+
+bool ScanScheduler::waitTurn(int jobId, const QAtomicInt* cancelled)
+{
+    QMutexLocker locker(&m_mutex);
+    while (!mayRunLocked(jobId)) {
+        if (cancelled && cancelled->loadAcquire()) {
+            return false;
+        }
+        // Cancel flags belong to the callers and do not signal; poll them
+        m_changed.wait(&m_mutex, CANCEL_POLL_MS);
+    }
+    return !(cancelled && cancelled->loadAcquire());
+}
+
+bool ScanScheduler::mayRunLocked(int jobId) const
+{
+    auto self = m_jobs.constFind(jobId);
+    if (self == m_jobs.constEnd()) {
+        return true;
+    }
+    if (self->paused) {
+        return false;
+    }
+
+    for (auto it = m_jobs.constBegin(); it != m_jobs.constEnd(); ++it) {
+        if (it.key() != jobId && !it->paused && it->priority > self->priority) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef SCANSCHEDULER_H
+#define SCANSCHEDULER_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QHash>
+
+/**
+ * @brief Cooperative gate between scan jobs and their probe workers
+ *
+ * Every scan registers a job. Its workers call waitTurn() before each
+ * probe (IpScanner) or stage step (ScanPipeline); the call returns at once
+ * while the job may run and blocks otherwise, so a pause takes effect
+ * before the next probe is issued. Probes already in flight finish and
+ * their results are delivered; nothing is dropped or re-probed, and a
+ * resumed worker continues with the next position it would have taken.
+ *
+ * A job may run while it is not paused and no other unpaused job has a
+ * higher priority: an interactive rescan of one host preempts a
+ * background sweep for as long as it is registered.
+ *
+ * All methods are thread-safe.
+ */
+class ScanScheduler
+{
+public:
+    enum Priority {
+        Background = 0,     ///< Large sweeps that can wait
+        Normal,             ///< Scans started by the user
+        Interactive         ///< Single-host requests the user is waiting on
+    };
+
+    static ScanScheduler* instance();
+
+    ScanScheduler();
+
+    ScanScheduler(const ScanScheduler&) = delete;
+    ScanScheduler& operator=(const ScanScheduler&) = delete;
+
+    /**
+     * @brief Add a job
+     * @return Job id, always > 0
+     */
+    int registerJob(Priority priority);
+
+    /**
+     * @brief Remove a job; lower-priority jobs it held back continue
+     */
+    void unregisterJob(int jobId);
+
+    void setPriority(int jobId, Priority priority);
+    void pause(int jobId);
+    void resume(int jobId);
+    bool isPaused(int jobId) const;
+    int jobCount() const;
+
+    /**
+     * @brief Check whether the job may issue probes now, without waiting
+     *
+     * Unknown ids (including 0) are never held back.
+     */
+    bool mayRun(int jobId) const;
+
+    /**
+     * @brief Block until the job may issue its next probe
+     * @param cancelled Polled while waiting; a non-zero value ends the wait
+     * @return False if cancelled
+     */
+    bool waitTurn(int jobId, const QAtomicInt* cancelled = nullptr);
+
+private:
+    static constexpr int CANCEL_POLL_MS = 20;
+
+    struct Job {
+        Priority priority;
+        bool paused;
+    };
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_changed;
+    QHash<int, Job> m_jobs;
+    int m_nextId;
+
+    bool mayRunLocked(int jobId) const;
+};
+
+#endif // SCANSCHEDULER_H
@@ -0,0 +1,63 @@
+#include "IndexPermutation.h"
+
+IndexPermutation::IndexPermutation(quint64 size, quint64 seed)
+    : m_size(size)
+    , m_seed(seed)
+    , m_halfBits(1)
+    , m_halfMask(1)
+{
+    int bits = 0;
+    while (bits < 62 && (quint64(1) << bits) < size) {
+        ++bits;
+    }
+
+    // Balanced halves: the walked domain is at most 4x the range
+    m_halfBits = qMax(1, (bits + 1) / 2);
+    m_halfMask = (quint64(1) << m_halfBits) - 1;
+
+    // Round keys derived from the seed (splitmix64 sequence)
+    quint64 state = seed;
+    for (int i = 0; i < ROUNDS; ++i) {
+        state += 0x9E3779B97F4A7C15ULL;
+        m_keys[i] = mix(state);
+    }
+}
+
+quint64 IndexPermutation::map(quint64 index) const
+{
+    if (m_size <= 1 || index >= m_size) {
+        return index;
+    }
+
+    // Cycle walking: re-encrypt until the value falls back inside the range
+    quint64 value = index;
+    do {
+        value = encrypt(value);
+    } while (value >= m_size);
+
+    return value;
+}
+
+quint64 IndexPermutation::encrypt(quint64 value) const
+{
+    quint64 left = value >> m_halfBits;
+    quint64 right = value & m_halfMask;
+
+    for (int i = 0; i < ROUNDS; ++i) {
+        quint64 next = left ^ (mix(right ^ m_keys[i]) & m_halfMask);
+        left = right;
+        right = next;
+    }
+
+    return (left << m_halfBits) | right;
+}
+
+quint64 IndexPermutation::mix(quint64 value)
+{
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ULL;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBULL;
+    value ^= value >> 31;
+    return value;
+}
@@ -0,0 +1,48 @@
+#ifndef INDEXPERMUTATION_H
+#define INDEXPERMUTATION_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Keyed pseudo-random permutation of the index range [0, size)
+ *
+ * A balanced Feistel network over the smallest even bit width covering
+ * size, with cycle walking to stay inside the range. map() is a stateless
+ * bijection: no shuffled array is held, the same seed always gives the
+ * same order, and a scan can resume at any position by mapping from that
+ * index onward. Not a cryptographic primitive - only meant to spread
+ * probes across the address space.
+ */
+class IndexPermutation
+{
+public:
+    /**
+     * @param size Number of indices to permute
+     * @param seed Key selecting the order
+     */
+    explicit IndexPermutation(quint64 size = 0, quint64 seed = 0);
+
+    quint64 size() const { return m_size; }
+    quint64 seed() const { return m_seed; }
+
+    /**
+     * @brief Position in the permuted order -> original index
+     * @return Permuted index, or @p index itself if out of range
+     */
+    quint64 map(quint64 index) const;
+
+private:
+    static constexpr int ROUNDS = 4;
+
+    quint64 m_size;
+    quint64 m_seed;
+    int m_halfBits;
+    quint64 m_halfMask;
+    quint64 m_keys[ROUNDS];
+
+    quint64 encrypt(quint64 value) const;
+
+    static quint64 mix(quint64 value);
+};
+
+#endif // INDEXPERMUTATION_H
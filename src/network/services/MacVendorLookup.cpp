@@ -1,21 +1,86 @@
 #include "MacVendorLookup.h"
+#include "OuiIndex.h"
 #include "utils/Logger.h"
 #include <QFile>
-#include <QTextStream>
+#include <QFileInfo>
 #include <QCoreApplication>
 #include <QDir>
 #include <QMutexLocker>
 
+namespace {
+struct BuiltinVendor {
+    quint32 oui;
+    const char* vendor;
+};
+
+// Common vendors (subset of IEEE OUI database)
+const BuiltinVendor BUILTIN_VENDORS[] = {
+    { 0x000000, "Xerox" },
+    { 0x000001, "Xerox" },
+    { 0x000D3A, "Microsoft" },
+    { 0x001C42, "Parallels" },
+    { 0x0050F2, "Microsoft" },
+    { 0x00155D, "Microsoft" },
+    { 0x001B21, "Intel" },
+    { 0x001E67, "Intel" },
+    { 0x0022FB, "Intel" },
+    { 0x003065, "Apple" },
+    { 0x0050E4, "Apple" },
+    { 0x001451, "Apple" },
+    { 0x001EC2, "Apple" },
+    { 0x002332, "Apple" },
+    { 0xD8A25E, "Apple" },
+    { 0xF0B479, "Apple" },
+    { 0x001A11, "Google" },
+    { 0x00241D, "Cisco" },
+    { 0x00D0BC, "Cisco" },
+    { 0x001B4F, "Cisco" },
+    { 0x001CFE, "Cisco" },
+    { 0x002618, "Cisco" },
+    { 0x002248, "Dell" },
+    { 0x0019B9, "Dell" },
+    { 0x001E4F, "Dell" },
+    { 0x00507B, "Dell" },
+    { 0x001B63, "Hewlett Packard" },
+    { 0x001CC4, "Hewlett Packard" },
+    { 0x002264, "Hewlett Packard" },
+    { 0x0024A5, "Hewlett Packard" },
+    { 0x001E0B, "ASUSTek" },
+    { 0x0026B6, "ASUSTek" },
+    { 0x50E549, "ASUSTek" },
+    { 0x00E04C, "Realtek" },
+    { 0x525400, "QEMU/KVM" },
+    { 0x020054, "Novell" },
+};
+
+OuiIndex* buildBuiltinIndex()
+{
+    QVector<OuiIndex::Record> records;
+    for (const BuiltinVendor& entry : BUILTIN_VENDORS) {
+        records.append({ entry.oui, 24, QString::fromLatin1(entry.vendor) });
+    }
+
+    OuiIndex* index = new OuiIndex();
+    index->load(OuiIndex::build(records));
+    return index;
+}
+}
+
 MacVendorLookup* MacVendorLookup::m_instance = nullptr;
 QMutex MacVendorLookup::m_mutex;
 
 MacVendorLookup::MacVendorLookup()
+    : m_index(nullptr)
+    , m_builtin(buildBuiltinIndex())
 {
     // Don't load anything in constructor - use loadDefaultDatabase() instead
 }
 
 MacVendorLookup::~MacVendorLookup()
 {
+    delete m_index.load();
+    qDeleteAll(m_retired);
+    delete m_builtin;
 }
 
 MacVendorLookup* MacVendorLookup::instance()
@@ -32,119 +97,69 @@ MacVendorLookup* MacVendorLookup::instance()
 
 QString MacVendorLookup::lookupVendor(const QString& macAddress)
 {
-    QString oui = extractOui(macAddress);
-
-    if (oui.isEmpty()) {
+    quint64 mac = 0;
+    if (!OuiIndex::parseMac(macAddress, mac)) {
         return "Unknown";
     }
 
     // Check if this is a locally administered address (LAA)
-    if (isLocallyAdministered(oui)) {
+    if (isLocallyAdministered(mac)) {
         return "Locally Administered";
     }
 
-    return m_ouiDatabase.value(oui, "Unknown");
-}
+    const OuiIndex* index = m_index.load(std::memory_order_acquire);
+    QByteArrayView vendor = index ? index->lookup(mac) : QByteArrayView();
 
-bool MacVendorLookup::isLocallyAdministered(const QString& oui)
-{
-    // Check the second bit of the first octet
-    // If set, this is a locally administered address (not globally unique)
-    if (oui.length() < 2) {
-        return false;
+    // A downloaded database may lack or predate entries the built-in table has
+    if (vendor.isEmpty()) {
+        vendor = m_builtin->lookup(mac);
     }
 
-    bool ok;
-    int firstByte = oui.left(2).toInt(&ok, 16);
-
-    if (!ok) {
-        return false;
-    }
+    return vendor.isEmpty() ? QString("Unknown") : QString::fromUtf8(vendor);
+}
 
-    // Bit 1 (second bit from right) indicates local/universal
+bool MacVendorLookup::isLocallyAdministered(quint64 mac)
+{
+    // Bit 1 (second bit from right) of the first octet indicates local/universal
     // 0 = Universally Administered (UAA), 1 = Locally Administered (LAA)
-    return (firstByte & 0x02) != 0;
+    return ((mac >> 40) & 0x02) != 0;
 }
 
 bool MacVendorLookup::loadOuiDatabase(const QString& filepath)
 {
-    QFile file(filepath);
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    quint64 stamp = OuiIndex::stampOf(filepath);
+    if (stamp == 0) {
         Logger::error(QString("Failed to load OUI database: %1").arg(filepath));
         return false;
     }
 
-    QTextStream in(&file);
-    int count = 0;
-
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-
-        // Skip comments and empty lines
-        if (line.isEmpty() || line.startsWith('#')) {
-            continue;
-        }
-
-        // Format: AA:BB:CC<TAB>Vendor Name
-        QStringList parts = line.split('\t', Qt::SkipEmptyParts);
-
-        if (parts.size() >= 2) {
-            QString oui = parts[0].toUpper().remove(':').remove('-');
-            QString vendor = parts[1].trimmed();
-
-            m_ouiDatabase[oui] = vendor;
-            count++;
+    OuiIndex* index = new OuiIndex();
+    QString indexPath = indexPathFor(filepath);
+
+    // Reuse the compiled index while the text file is unchanged
+    if (!index->open(indexPath, stamp)) {
+        if (OuiIndex::compile(filepath, indexPath) < 0 || !index->open(indexPath, stamp)) {
+            // Index not writable: keep the image in memory for this run
+            QVector<OuiIndex::Record> records;
+            if (!OuiIndex::readText(filepath, records) || !index->load(OuiIndex::build(records, stamp))) {
+                Logger::error(QString("Failed to load OUI database: %1").arg(filepath));
+                delete index;
+                return false;
+            }
         }
     }
 
-    file.close();
-
-    Logger::info(QString("Loaded %1 OUI entries from database").arg(count));
+    install(index);
+    Logger::info(QString("Loaded %1 OUI entries from database").arg(index->size()));
     return true;
 }
 
 void MacVendorLookup::loadBuiltinDatabase()
 {
-    // Common vendors (subset of IEEE OUI database)
-    m_ouiDatabase["000000"] = "Xerox";
-    m_ouiDatabase["000001"] = "Xerox";
-    m_ouiDatabase["000D3A"] = "Microsoft";
-    m_ouiDatabase["001C42"] = "Parallels";
-    m_ouiDatabase["0050F2"] = "Microsoft";
-    m_ouiDatabase["00155D"] = "Microsoft";
-    m_ouiDatabase["001B21"] = "Intel";
-    m_ouiDatabase["001E67"] = "Intel";
-    m_ouiDatabase["0022FB"] = "Intel";
-    m_ouiDatabase["003065"] = "Apple";
-    m_ouiDatabase["0050E4"] = "Apple";
-    m_ouiDatabase["001451"] = "Apple";
-    m_ouiDatabase["001EC2"] = "Apple";
-    m_ouiDatabase["002332"] = "Apple";
-    m_ouiDatabase["D8A25E"] = "Apple";
-    m_ouiDatabase["F0B479"] = "Apple";
-    m_ouiDatabase["001A11"] = "Google";
-    m_ouiDatabase["00241D"] = "Cisco";
-    m_ouiDatabase["00D0BC"] = "Cisco";
-    m_ouiDatabase["001B4F"] = "Cisco";
-    m_ouiDatabase["001CFE"] = "Cisco";
-    m_ouiDatabase["002618"] = "Cisco";
-    m_ouiDatabase["002248"] = "Dell";
-    m_ouiDatabase["0019B9"] = "Dell";
-    m_ouiDatabase["001E4F"] = "Dell";
-    m_ouiDatabase["00507B"] = "Dell";
-    m_ouiDatabase["001B63"] = "Hewlett Packard";
-    m_ouiDatabase["001CC4"] = "Hewlett Packard";
-    m_ouiDatabase["002264"] = "Hewlett Packard";
-    m_ouiDatabase["0024A5"] = "Hewlett Packard";
-    m_ouiDatabase["001E0B"] = "ASUSTek";
-    m_ouiDatabase["0026B6"] = "ASUSTek";
-    m_ouiDatabase["50E549"] = "ASUSTek";
-    m_ouiDatabase["00E04C"] = "Realtek";
-    m_ouiDatabase["525400"] = "QEMU/KVM";
-    m_ouiDatabase["020054"] = "Novell";
-
-    Logger::debug(QString("Loaded %1 built-in OUI entries").arg(m_ouiDatabase.size()));
+    OuiIndex* index = buildBuiltinIndex();
+    install(index);
+
+    Logger::debug(QString("Loaded %1 built-in OUI entries").arg(index->size()));
 }
 
 bool MacVendorLookup::loadDefaultDatabase()
@@ -162,7 +177,7 @@ bool MacVendorLookup::loadDefaultDatabase()
         if (file.exists()) {
             Logger::info(QString("Found OUI database at: %1").arg(path));
             if (loadOuiDatabase(path)) {
-                Logger::info(QString("Successfully loaded %1 OUI entries from external database").arg(m_ouiDatabase.size()));
+                Logger::info(QString("Successfully loaded %1 OUI entries from external database").arg(databaseSize()));
                 return true;
             }
         }
@@ -176,18 +191,29 @@ bool MacVendorLookup::loadDefaultDatabase()
 
 int MacVendorLookup::databaseSize() const
 {
-    return m_ouiDatabase.size();
+    const OuiIndex* index = m_index.load(std::memory_order_acquire);
+    return index ? index->size() : 0;
 }
 
-QString MacVendorLookup::extractOui(const QString& macAddress)
+void MacVendorLookup::install(OuiIndex* index)
 {
-    // Remove separators and take first 6 characters (OUI)
-    QString cleaned = macAddress;
-    cleaned = cleaned.remove(':').remove('-').remove('.').toUpper();
+    QMutexLocker locker(&m_loadMutex);
 
-    if (cleaned.length() < 6) {
-        return QString();
+    // Readers may still hold the previous index, so it is retired rather than freed
+    OuiIndex* previous = m_index.exchange(index, std::memory_order_acq_rel);
+    if (previous) {
+        m_retired.append(previous);
     }
+}
 
-    return cleaned.left(6);
+QString MacVendorLookup::indexPathFor(const QString& textPath)
+{
+    QFileInfo text(textPath);
+    QString name = text.completeBaseName() + ".idx";
+
+    // Next to the text database if possible, otherwise in the user directory
+    if (QFileInfo(text.absolutePath()).isWritable()) {
+        return text.absolutePath() + "/" + name;
+    }
+    return QDir::homePath() + "/.lanscan/" + name;
 }
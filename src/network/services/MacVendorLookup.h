@@ -2,8 +2,11 @@
 #define MACVENDORLOOKUP_H
 
 #include <QString>
-#include <QMap>
+#include <QVector>
 #include <QMutex>
+#include <atomic>
+
+class OuiIndex;
 
 class MacVendorLookup
 {
@@ -11,7 +14,10 @@ public:
     // Singleton instance
     static MacVendorLookup* instance();
 
+    // Lock-free; safe to call from any thread
     QString lookupVendor(const QString& macAddress);
+
+    // Compiles the text database to a binary index on first use, then maps the index
     bool loadOuiDatabase(const QString& filepath);
     void loadBuiltinDatabase();
     bool loadDefaultDatabase();
@@ -29,9 +35,15 @@ private:
     static MacVendorLookup* m_instance;
     static QMutex m_mutex;
 
-    QMap<QString, QString> m_ouiDatabase;
-    QString extractOui(const QString& macAddress);
-    bool isLocallyAdministered(const QString& oui);
+    // Current index; replaced ones are kept until destruction since readers hold no lock
+    std::atomic<OuiIndex*> m_index;
+    const OuiIndex* m_builtin;      // Consulted when the current index has no entry
+    QVector<OuiIndex*> m_retired;
+    QMutex m_loadMutex;
+
+    void install(OuiIndex* index);
+    static QString indexPathFor(const QString& textPath);
+    static bool isLocallyAdministered(quint64 mac);
 };
 
 #endif // MACVENDORLOOKUP_H
@@ -0,0 +1,399 @@
+#include "OuiIndex.h"
+#include "utils/Logger.h"
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QDir>
+#include <QHash>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const char INDEX_MAGIC[8] = { 'L', 'S', 'O', 'U', 'I', 'I', 'D', 'X' };
+const quint64 MAC_MASK = 0xFFFFFFFFFFFFULL;
+
+int hexValue(QChar c)
+{
+    ushort u = c.unicode();
+    if (u >= '0' && u <= '9') return u - '0';
+    if (u >= 'a' && u <= 'f') return u - 'a' + 10;
+    if (u >= 'A' && u <= 'F') return u - 'A' + 10;
+    return -1;
+}
+
+bool isSeparator(QChar c)
+{
+    return c == ':' || c == '-' || c == '.';
+}
+}
+
+OuiIndex::OuiIndex()
+    : m_header(nullptr)
+    , m_tables{ nullptr, nullptr, nullptr }
+    , m_strings(nullptr)
+{
+}
+
+OuiIndex::~OuiIndex()
+{
+    close();
+}
+
+bool OuiIndex::open(const QString& indexPath, quint64 sourceStamp)
+{
+    close();
+
+    m_file.setFileName(indexPath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // Read-only shared mapping: pages are loaded on first access and shared
+    // with every other process using the same index
+    uchar* data = m_file.map(0, m_file.size());
+    if (data == nullptr || !attach(data, m_file.size())) {
+        Logger::warn(QString("OuiIndex: Ignoring invalid index %1").arg(indexPath));
+        close();
+        return false;
+    }
+
+    if (sourceStamp != 0 && m_header->sourceStamp != sourceStamp) {
+        Logger::debug(QString("OuiIndex: %1 is older than its text database").arg(indexPath));
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool OuiIndex::load(const QByteArray& image)
+{
+    close();
+    if (image.isEmpty()) {
+        return false;
+    }
+
+    m_buffer.resize((image.size() + 7) / 8);
+    std::memcpy(m_buffer.data(), image.constData(), image.size());
+
+    if (!attach(reinterpret_cast<const uchar*>(m_buffer.constData()), image.size())) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+QByteArrayView OuiIndex::lookup(quint64 mac, int* bits) const
+{
+    if (m_header == nullptr) {
+        return QByteArrayView();
+    }
+
+    mac &= MAC_MASK;
+
+    // Longest prefix first: an MA-S block overrides the MA-L owner of its OUI
+    for (int table = TABLES - 1; table >= 0; --table) {
+        const Entry* begin = m_tables[table];
+        const Entry* end = begin + m_header->counts[table];
+        quint64 key = mac >> (48 - TABLE_BITS[table]);
+
+        const Entry* it = std::lower_bound(begin, end, key, [](const Entry& entry, quint64 value) {
+            return entry.prefix < value;
+        });
+
+        if (it != end && it->prefix == key) {
+            if (static_cast<quint64>(it->vendorOffset) + it->vendorLength > m_header->stringsSize) {
+                return QByteArrayView();
+            }
+            if (bits) {
+                *bits = TABLE_BITS[table];
+            }
+            return QByteArrayView(m_strings + it->vendorOffset, it->vendorLength);
+        }
+    }
+
+    return QByteArrayView();
+}
+
+int OuiIndex::size() const
+{
+    if (m_header == nullptr) {
+        return 0;
+    }
+    return static_cast<int>(m_header->counts[0] + m_header->counts[1] + m_header->counts[2]);
+}
+
+int OuiIndex::vendorCount() const
+{
+    return m_header ? static_cast<int>(m_header->vendorCount) : 0;
+}
+
+quint64 OuiIndex::sourceStamp() const
+{
+    return m_header ? m_header->sourceStamp : 0;
+}
+
+bool OuiIndex::parseLine(QStringView line, Record& record)
+{
+    line = line.trimmed();
+    if (line.isEmpty() || line.startsWith(QLatin1Char('#'))) {
+        return false;
+    }
+
+    // Prefix and vendor are tab separated; tolerate spaces after the prefix
+    qsizetype split = line.indexOf(QLatin1Char('\t'));
+    if (split < 0) {
+        split = line.indexOf(QLatin1Char(' '));
+    }
+    if (split <= 0) {
+        return false;
+    }
+
+    QStringView prefixText = line.left(split);
+    QStringView vendor = line.mid(split + 1).trimmed();
+    if (vendor.isEmpty()) {
+        return false;
+    }
+
+    int bits = 0;
+    qsizetype slash = prefixText.indexOf(QLatin1Char('/'));
+    if (slash >= 0) {
+        bool ok = false;
+        bits = prefixText.mid(slash + 1).toInt(&ok);
+        if (!ok) {
+            return false;
+        }
+        prefixText = prefixText.left(slash);
+    }
+
+    quint64 value = 0;
+    int digits = 0;
+    for (QChar c : prefixText) {
+        if (isSeparator(c)) {
+            continue;
+        }
+        int nibble = hexValue(c);
+        if (nibble < 0 || digits == 12) {
+            return false;
+        }
+        value = (value << 4) | nibble;
+        digits++;
+    }
+
+    if (bits == 0) {
+        bits = digits * 4;
+    }
+    if (tableFor(bits) < 0 || digits * 4 < bits) {
+        return false;
+    }
+
+    record.prefix = value >> (digits * 4 - bits);
+    record.bits = bits;
+    record.vendor = vendor.toString();
+    return true;
+}
+
+bool OuiIndex::parseMac(QStringView text, quint64& mac)
+{
+    quint64 value = 0;
+    int digits = 0;
+
+    for (QChar c : text) {
+        if (isSeparator(c)) {
+            continue;
+        }
+        int nibble = hexValue(c);
+        if (nibble < 0 || digits == 12) {
+            return false;
+        }
+        value = (value << 4) | nibble;
+        digits++;
+    }
+
+    if (digits < 6) {
+        return false;
+    }
+
+    mac = value << (4 * (12 - digits));
+    return true;
+}
+
+QByteArray OuiIndex::build(const QVector<Record>& records, quint64 sourceStamp)
+{
+    QVector<Entry> tables[TABLES];
+    QHash<quint64, int> positions;        // (table << 48 | prefix) -> entry index
+    QHash<QString, quint32> interned;     // vendor -> offset in the string table
+    QByteArray strings;
+
+    for (const Record& record : records) {
+        int table = tableFor(record.bits);
+        if (table < 0) {
+            continue;
+        }
+
+        // Vendor names repeat heavily (one company owns many blocks); store each once
+        QByteArray name = record.vendor.toUtf8();
+        auto internedIt = interned.constFind(record.vendor);
+        quint32 offset;
+        if (internedIt != interned.constEnd()) {
+            offset = internedIt.value();
+        } else {
+            offset = static_cast<quint32>(strings.size());
+            strings.append(name);
+            strings.append('\0');
+            interned.insert(record.vendor, offset);
+        }
+
+        Entry entry;
+        entry.prefix = record.prefix;
+        entry.vendorOffset = offset;
+        entry.vendorLength = static_cast<quint32>(name.size());
+
+        quint64 key = (static_cast<quint64>(table) << 48) | record.prefix;
+        auto positionIt = positions.constFind(key);
+        if (positionIt != positions.constEnd()) {
+            tables[table][positionIt.value()] = entry;
+        } else {
+            positions.insert(key, tables[table].size());
+            tables[table].append(entry);
+        }
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.sourceStamp = sourceStamp;
+    header.vendorCount = static_cast<quint32>(interned.size());
+    header.stringsSize = static_cast<quint32>(strings.size());
+
+    QByteArray image;
+    qsizetype entryCount = 0;
+    for (int table = 0; table < TABLES; ++table) {
+        std::sort(tables[table].begin(), tables[table].end(), [](const Entry& a, const Entry& b) {
+            return a.prefix < b.prefix;
+        });
+        header.counts[table] = static_cast<quint32>(tables[table].size());
+        entryCount += tables[table].size();
+    }
+
+    image.reserve(sizeof(Header) + entryCount * sizeof(Entry) + strings.size());
+    image.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int table = 0; table < TABLES; ++table) {
+        image.append(reinterpret_cast<const char*>(tables[table].constData()),
+                     tables[table].size() * sizeof(Entry));
+    }
+    image.append(strings);
+
+    return image;
+}
+
+bool OuiIndex::readText(const QString& textPath, QVector<Record>& records)
+{
+    QFile text(textPath);
+    if (!text.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        Logger::error(QString("OuiIndex: Failed to open %1").arg(textPath));
+        return false;
+    }
+
+    records.reserve(records.size() + 40000);
+
+    Record record;
+    while (!text.atEnd()) {
+        QString line = QString::fromUtf8(text.readLine());
+        if (parseLine(line, record)) {
+            records.append(record);
+        }
+    }
+    return true;
+}
+
+int OuiIndex::compile(const QString& textPath, const QString& indexPath)
+{
+    QVector<Record> records;
+    if (!readText(textPath, records)) {
+        return -1;
+    }
+
+    QByteArray image = build(records, stampOf(textPath));
+
+    QDir().mkpath(QFileInfo(indexPath).absolutePath());
+    QSaveFile output(indexPath);
+    if (!output.open(QIODevice::WriteOnly) || output.write(image) != image.size() || !output.commit()) {
+        Logger::warn(QString("OuiIndex: Cannot write index %1").arg(indexPath));
+        return -1;
+    }
+
+    const Header* header = reinterpret_cast<const Header*>(image.constData());
+    int count = static_cast<int>(header->counts[0] + header->counts[1] + header->counts[2]);
+    Logger::info(QString("OuiIndex: Compiled %1 prefixes (%2 vendors, %3 KB) into %4")
+                .arg(count).arg(header->vendorCount).arg(image.size() / 1024).arg(indexPath));
+    return count;
+}
+
+quint64 OuiIndex::stampOf(const QString& textPath)
+{
+    QFileInfo info(textPath);
+    if (!info.exists()) {
+        return 0;
+    }
+
+    quint64 size = static_cast<quint64>(info.size());
+    quint64 modified = static_cast<quint64>(info.lastModified().toMSecsSinceEpoch());
+    quint64 stamp = (size * 0x9E3779B97F4A7C15ULL) ^ modified;
+    return stamp != 0 ? stamp : 1;
+}
+
+bool OuiIndex::attach(const uchar* data, qint64 size)
+{
+    if (size < static_cast<qint64>(sizeof(Header))) {
+        return false;
+    }
+
+    const Header* header = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0
+        || header->version != VERSION || header->headerSize != sizeof(Header)) {
+        return false;
+    }
+
+    quint64 entries = static_cast<quint64>(header->counts[0]) + header->counts[1] + header->counts[2];
+    quint64 required = sizeof(Header) + entries * sizeof(Entry) + header->stringsSize;
+    if (required > static_cast<quint64>(size)) {
+        return false;
+    }
+
+    const Entry* table = reinterpret_cast<const Entry*>(data + sizeof(Header));
+    for (int i = 0; i < TABLES; ++i) {
+        m_tables[i] = table;
+        table += header->counts[i];
+    }
+    m_strings = reinterpret_cast<const char*>(table);
+    m_header = header;
+    return true;
+}
+
+void OuiIndex::close()
+{
+    m_header = nullptr;
+    m_strings = nullptr;
+    for (const Entry*& table : m_tables) {
+        table = nullptr;
+    }
+
+    // Closing the file also removes its mapping
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_buffer.clear();
+}
+
+int OuiIndex::tableFor(int bits)
+{
+    for (int i = 0; i < TABLES; ++i) {
+        if (TABLE_BITS[i] == bits) {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,142 @@
+#ifndef OUIINDEX_H
+#define OUIINDEX_H
+
+#include <QString>
+#include <QStringView>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QVector>
+#include <QFile>
+
+/**
+ * @brief Compiled, memory-mappable MAC vendor index
+ *
+ * Holds the IEEE MA-L (24-bit), MA-M (28-bit) and MA-S (36-bit) prefix
+ * registries as three sorted entry tables plus one table of interned,
+ * NUL-separated vendor names. The image is built once from the text
+ * database (compile()) and then mapped read-only (open()), so startup
+ * costs one mmap and only the pages touched by lookups become resident.
+ *
+ * Image layout (native byte order, guarded by the magic and version):
+ *   Header
+ *   Entry[count24] | Entry[count28] | Entry[count36]   sorted by prefix
+ *   char vendors[stringsSize]
+ *
+ * An opened index is immutable: lookup() takes no lock and allocates
+ * nothing, so any number of threads can share it.
+ */
+class OuiIndex
+{
+public:
+    /**
+     * @brief One registry assignment parsed from the text database
+     */
+    struct Record {
+        quint64 prefix;     ///< Prefix value, right-aligned (bits wide)
+        int bits;           ///< 24, 28 or 36
+        QString vendor;
+    };
+
+    static constexpr quint32 VERSION = 1;
+
+    OuiIndex();
+    ~OuiIndex();
+
+    OuiIndex(const OuiIndex&) = delete;
+    OuiIndex& operator=(const OuiIndex&) = delete;
+
+    /**
+     * @brief Map a compiled index file
+     * @param sourceStamp Expected stamp of the text database, 0 to skip the check
+     * @return false if the file is missing, corrupt, of another version or stale
+     */
+    bool open(const QString& indexPath, quint64 sourceStamp = 0);
+
+    /**
+     * @brief Use an image held in memory (see build())
+     */
+    bool load(const QByteArray& image);
+
+    bool isValid() const { return m_header != nullptr; }
+
+    /**
+     * @brief Longest-prefix match of a 48-bit MAC address
+     * @param mac Address in the low 48 bits
+     * @param bits Receives the matched prefix length, if non-null
+     * @return Vendor name (UTF-8, not NUL-terminated in the view), empty if none
+     */
+    QByteArrayView lookup(quint64 mac, int* bits = nullptr) const;
+
+    int size() const;           ///< Number of prefixes
+    int vendorCount() const;    ///< Number of distinct vendor names
+    quint64 sourceStamp() const;
+
+    /**
+     * @brief Parse "AABBCC", "AA:BB:CC", "AABBCCD" (28), "AABBCCDDE" (36) or
+     *        "AA:BB:CC:D0:00:00/28" style prefixes followed by a tab and the vendor
+     */
+    static bool parseLine(QStringView line, Record& record);
+
+    /**
+     * @brief Parse a MAC address in colon, dash, dot or bare notation
+     *
+     * Needs at least the 6 OUI digits; missing trailing digits are zero.
+     * Does not allocate.
+     */
+    static bool parseMac(QStringView text, quint64& mac);
+
+    /**
+     * @brief Parse every valid line of a text database
+     */
+    static bool readText(const QString& textPath, QVector<Record>& records);
+
+    /**
+     * @brief Serialize records into an index image; later duplicates win
+     */
+    static QByteArray build(const QVector<Record>& records, quint64 sourceStamp = 0);
+
+    /**
+     * @brief Parse a text database and write its index image atomically
+     * @return Number of prefixes written, -1 on error
+     */
+    static int compile(const QString& textPath, const QString& indexPath);
+
+    /**
+     * @brief Identity of a text database version (size and modification time)
+     */
+    static quint64 stampOf(const QString& textPath);
+
+private:
+    struct Header {
+        char magic[8];
+        quint32 version;
+        quint32 headerSize;
+        quint64 sourceStamp;
+        quint32 counts[3];      ///< 24-, 28- and 36-bit tables
+        quint32 vendorCount;
+        quint32 stringsSize;
+        quint32 reserved;
+    };
+
+    struct Entry {
+        quint64 prefix;
+        quint32 vendorOffset;
+        quint32 vendorLength;
+    };
+
+    static constexpr int TABLES = 3;
+    static constexpr int TABLE_BITS[TABLES] = { 24, 28, 36 };
+
+    QFile m_file;
+    QVector<quint64> m_buffer;  ///< 8-byte aligned backing store when not mapped
+    const Header* m_header;
+    const Entry* m_tables[TABLES];
+    const char* m_strings;
+
+    bool attach(const uchar* data, qint64 size);
+    void close();
+
+    static int tableFor(int bits);
+};
+
+#endif // OUIINDEX_H
@@ -0,0 +1,457 @@
+#include "ServiceProbe.h"
+#include <QRandomGenerator>
+
+namespace {
+const int PASSIVE_LIMIT = 1024;
+const int HTTP_LIMIT = 2048;
+const int TLS_LIMIT = 16384;    // One maximum-size record: room for a typical leaf certificate
+
+const quint8 TLS_HANDSHAKE = 22;
+const quint8 TLS_ALERT = 21;
+const quint8 HANDSHAKE_CERTIFICATE = 11;
+const quint8 HANDSHAKE_SERVER_HELLO_DONE = 14;
+
+const quint8 DER_SEQUENCE = 0x30;
+const quint8 DER_SET = 0x31;
+const quint8 DER_OID = 0x06;
+const quint8 DER_EXPLICIT_0 = 0xA0;
+
+void appendU16(QByteArray& data, int value)
+{
+    data.append(static_cast<char>((value >> 8) & 0xFF));
+    data.append(static_cast<char>(value & 0xFF));
+}
+
+void appendU24(QByteArray& data, int value)
+{
+    data.append(static_cast<char>((value >> 16) & 0xFF));
+    appendU16(data, value & 0xFFFF);
+}
+
+int readU16(const QByteArray& data, int offset)
+{
+    return (static_cast<quint8>(data[offset]) << 8) | static_cast<quint8>(data[offset + 1]);
+}
+
+int readU24(const QByteArray& data, int offset)
+{
+    return (static_cast<quint8>(data[offset]) << 16) | readU16(data, offset + 1);
+}
+
+/**
+ * @brief One DER tag-length-value header; false if truncated or too long
+ */
+bool readTlv(const QByteArray& der, int offset, int end, quint8& tag, int& contentOffset, int& contentLength)
+{
+    if (offset + 2 > end) {
+        return false;
+    }
+
+    tag = static_cast<quint8>(der[offset]);
+    int length = static_cast<quint8>(der[offset + 1]);
+    int position = offset + 2;
+
+    if (length & 0x80) {
+        int bytes = length & 0x7F;
+        if (bytes == 0 || bytes > 3 || position + bytes > end) {
+            return false;
+        }
+        length = 0;
+        for (int i = 0; i < bytes; ++i) {
+            length = (length << 8) | static_cast<quint8>(der[position++]);
+        }
+    }
+
+    if (position + length > end) {
+        return false;
+    }
+
+    contentOffset = position;
+    contentLength = length;
+    return true;
+}
+
+bool isHttpPort(quint16 port)
+{
+    switch (port) {
+        case 80: case 81: case 591: case 8000: case 8008: case 8080: case 8081: case 8888:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isTlsPort(quint16 port)
+{
+    switch (port) {
+        case 443: case 465: case 636: case 993: case 995: case 8443: case 9443:
+            return true;
+        default:
+            return false;
+    }
+}
+}
+
+ServiceProbe::Kind ServiceProbe::kindFor(quint16 port)
+{
+    if (isHttpPort(port)) {
+        return HttpHead;
+    }
+    if (isTlsPort(port)) {
+        return TlsHello;
+    }
+    return Passive;
+}
+
+QByteArray ServiceProbe::request(Kind kind, quint32 address)
+{
+    switch (kind) {
+        case HttpHead:
+            return QString("HEAD / HTTP/1.0\r\nHost: %1.%2.%3.%4\r\nUser-Agent: LanScan\r\nAccept: */*\r\n\r\n")
+                .arg(address >> 24).arg((address >> 16) & 0xFF).arg((address >> 8) & 0xFF).arg(address & 0xFF)
+                .toLatin1();
+        case TlsHello:
+            return clientHello();
+        case Passive:
+        default:
+            return QByteArray();
+    }
+}
+
+int ServiceProbe::responseLimit(Kind kind)
+{
+    switch (kind) {
+        case HttpHead: return HTTP_LIMIT;
+        case TlsHello: return TLS_LIMIT;
+        case Passive:
+        default: return PASSIVE_LIMIT;
+    }
+}
+
+bool ServiceProbe::isComplete(Kind kind, const QByteArray& data)
+{
+    switch (kind) {
+        case HttpHead:
+            return data.contains("\r\n\r\n") || data.contains("\n\n");
+        case TlsHello: {
+            bool complete = false;
+            return !firstCertificate(data, &complete).isEmpty() || complete;
+        }
+        case Passive:
+        default:
+            return data.contains('\n');
+    }
+}
+
+ServiceProbe::Identity ServiceProbe::identify(Kind kind, quint16 port, const QByteArray& data)
+{
+    if (data.isEmpty()) {
+        return Identity();
+    }
+
+    switch (kind) {
+        case HttpHead:
+            return identifyHttp(data);
+        case TlsHello: {
+            Identity identity;
+            QString commonName = certificateCommonName(firstCertificate(data));
+            if (!commonName.isEmpty()) {
+                // TLS wraps the port's own protocol, so the service name is left to the table
+                identity.version = QString("CN=%1").arg(commonName).left(MAX_VERSION_LENGTH);
+            }
+            return identity;
+        }
+        case Passive:
+        default:
+            return identifyGreeting(port, data);
+    }
+}
+
+ServiceProbe::Identity ServiceProbe::identifyGreeting(quint16 port, const QByteArray& data)
+{
+    Identity identity;
+    QString line = firstLine(data);
+    if (line.isEmpty()) {
+        return identity;
+    }
+
+    if (line.startsWith("SSH-")) {
+        // SSH-protoversion-softwareversion SP comments
+        identity.service = "SSH";
+        identity.version = line.section('-', 2);
+    } else if (line.startsWith("220")) {
+        // SMTP and FTP share the greeting code; the text or the port tells them apart
+        QString text = line.mid(3).trimmed();
+        if (text.startsWith('-')) {
+            text = text.mid(1).trimmed();
+        }
+        bool smtp = text.contains("SMTP", Qt::CaseInsensitive) || port == 25 || port == 587;
+        identity.service = smtp ? "SMTP" : (text.contains("FTP", Qt::CaseInsensitive) || port == 21 ? "FTP" : QString());
+        identity.version = text;
+    } else if (line.startsWith("+OK")) {
+        identity.service = "POP3";
+        identity.version = line.mid(3).trimmed();
+    } else if (line.startsWith("* OK")) {
+        identity.service = "IMAP";
+        identity.version = line.mid(4).trimmed();
+    } else {
+        identity.version = line;
+    }
+
+    identity.version = identity.version.left(MAX_VERSION_LENGTH);
+    return identity;
+}
+
+ServiceProbe::Identity ServiceProbe::identifyHttp(const QByteArray& data)
+{
+    Identity identity;
+    if (!data.startsWith("HTTP/")) {
+        return identity;
+    }
+
+    identity.service = "HTTP";
+
+    int headerEnd = data.indexOf("\r\n\r\n");
+    const QList<QByteArray> lines = data.left(headerEnd < 0 ? data.size() : headerEnd).split('\n');
+    for (const QByteArray& line : lines) {
+        if (line.size() > 7 && qstrnicmp(line.constData(), "server:", 7) == 0) {
+            identity.version = firstLine(line.mid(7).trimmed());
+            break;
+        }
+    }
+    return identity;
+}
+
+QString ServiceProbe::firstLine(const QByteArray& data)
+{
+    int end = data.indexOf('\n');
+    return printableText((end < 0 ? data : data.left(end)).trimmed());
+}
+
+QString ServiceProbe::printableText(const QByteArray& bytes)
+{
+    // Keep printable ASCII only: banners and names end up in tables and exports
+    QString text;
+    text.reserve(qMin(static_cast<int>(bytes.size()), MAX_VERSION_LENGTH));
+    for (char c : bytes) {
+        if (text.size() >= MAX_VERSION_LENGTH) {
+            break;
+        }
+        if (c >= 0x20 && c < 0x7F) {
+            text.append(QLatin1Char(c));
+        }
+    }
+    return text.trimmed();
+}
+
+QByteArray ServiceProbe::clientHello()
+{
+    QByteArray body;
+    appendU16(body, 0x0303);    // client_version TLS 1.2
+
+    QByteArray random(32, '\0');
+    QRandomGenerator::global()->fillRange(reinterpret_cast<quint32*>(random.data()), 8);
+    body.append(random);
+
+    body.append('\0');          // session_id length
+
+    // ECDHE and RSA suites widely enabled on TLS 1.2 servers and appliances
+    const int suites[] = { 0xC02F, 0xC030, 0xC02B, 0xC02C, 0xCCA8, 0xCCA9, 0xC013, 0xC014,
+                           0xC009, 0xC00A, 0x009C, 0x009D, 0x002F, 0x0035, 0x000A };
+    appendU16(body, static_cast<int>(sizeof(suites) / sizeof(suites[0])) * 2);
+    for (int suite : suites) {
+        appendU16(body, suite);
+    }
+
+    body.append('\x01');        // compression_methods: null only
+    body.append('\0');
+
+    QByteArray extensions;
+    // supported_groups: x25519, secp256r1, secp384r1
+    appendU16(extensions, 0x000A);
+    appendU16(extensions, 8);
+    appendU16(extensions, 6);
+    appendU16(extensions, 0x001D);
+    appendU16(extensions, 0x0017);
+    appendU16(extensions, 0x0018);
+    // ec_point_formats: uncompressed
+    appendU16(extensions, 0x000B);
+    appendU16(extensions, 2);
+    extensions.append('\x01');
+    extensions.append('\0');
+    // signature_algorithms
+    const int algorithms[] = { 0x0403, 0x0503, 0x0603, 0x0804, 0x0805, 0x0806,
+                               0x0401, 0x0501, 0x0601, 0x0201, 0x0203 };
+    int algorithmBytes = static_cast<int>(sizeof(algorithms) / sizeof(algorithms[0])) * 2;
+    appendU16(extensions, 0x000D);
+    appendU16(extensions, algorithmBytes + 2);
+    appendU16(extensions, algorithmBytes);
+    for (int algorithm : algorithms) {
+        appendU16(extensions, algorithm);
+    }
+
+    appendU16(body, extensions.size());
+    body.append(extensions);
+
+    QByteArray handshake;
+    handshake.append('\x01');   // ClientHello
+    appendU24(handshake, body.size());
+    handshake.append(body);
+
+    QByteArray record;
+    record.append(static_cast<char>(TLS_HANDSHAKE));
+    appendU16(record, 0x0301);  // Record version 1.0 for compatibility
+    appendU16(record, handshake.size());
+    record.append(handshake);
+    return record;
+}
+
+QByteArray ServiceProbe::firstCertificate(const QByteArray& records, bool* complete)
+{
+    if (complete) {
+        *complete = false;
+    }
+
+    // Reassemble the handshake stream; messages may span records
+    QByteArray handshake;
+    int offset = 0;
+    while (offset + 5 <= records.size()) {
+        quint8 type = static_cast<quint8>(records[offset]);
+        int length = readU16(records, offset + 3);
+
+        if (type != TLS_HANDSHAKE) {
+            // Alert or anything unexpected: the server will not send a certificate
+            if (complete && (type == TLS_ALERT || type < 20 || type > 23)) {
+                *complete = true;
+            }
+            break;
+        }
+
+        int available = qMin(length, static_cast<int>(records.size()) - offset - 5);
+        handshake.append(records.constData() + offset + 5, available);
+        if (available < length) {
+            break;
+        }
+        offset += 5 + length;
+    }
+
+    int position = 0;
+    while (position + 4 <= handshake.size()) {
+        quint8 type = static_cast<quint8>(handshake[position]);
+        int length = readU24(handshake, position + 1);
+        int body = position + 4;
+
+        if (type == HANDSHAKE_CERTIFICATE) {
+            // certificate_list<3> { certificate<3> ... }
+            if (body + 6 > handshake.size()) {
+                return QByteArray();
+            }
+            int certificateLength = readU24(handshake, body + 3);
+            if (certificateLength <= 0 || body + 6 + certificateLength > handshake.size()) {
+                return QByteArray();
+            }
+            return handshake.mid(body + 6, certificateLength);
+        }
+
+        if (type == HANDSHAKE_SERVER_HELLO_DONE) {
+            if (complete) {
+                *complete = true;
+            }
+            return QByteArray();
+        }
+
+        position = body + length;
+    }
+
+    return QByteArray();
+}
+
+QString ServiceProbe::certificateCommonName(const QByteArray& der)
+{
+    quint8 tag;
+    int content, length;
+
+    // Certificate ::= SEQUENCE { tbsCertificate, signatureAlgorithm, signature }
+    if (!readTlv(der, 0, der.size(), tag, content, length) || tag != DER_SEQUENCE) {
+        return QString();
+    }
+    if (!readTlv(der, content, content + length, tag, content, length) || tag != DER_SEQUENCE) {
+        return QString();
+    }
+
+    // tbsCertificate: [0] version (optional), serial, signature, issuer, validity, subject
+    int position = content;
+    int end = content + length;
+    int field = 0;
+    int subjectOffset = -1, subjectLength = 0;
+
+    while (position < end) {
+        int fieldContent, fieldLength;
+        if (!readTlv(der, position, end, tag, fieldContent, fieldLength)) {
+            return QString();
+        }
+        position = fieldContent + fieldLength;
+
+        if (field == 0 && tag == DER_EXPLICIT_0) {
+            continue;
+        }
+        if (field == 4) {
+            subjectOffset = fieldContent;
+            subjectLength = fieldLength;
+            break;
+        }
+        field++;
+    }
+
+    if (subjectOffset < 0) {
+        return QString();
+    }
+
+    // Name ::= SEQUENCE OF SET OF SEQUENCE { type OID, value }; keep the last CN (most specific)
+    QString commonName;
+    int setPosition = subjectOffset;
+    int subjectEnd = subjectOffset + subjectLength;
+
+    while (setPosition < subjectEnd) {
+        int setContent, setLength;
+        if (!readTlv(der, setPosition, subjectEnd, tag, setContent, setLength) || tag != DER_SET) {
+            break;
+        }
+        setPosition = setContent + setLength;
+
+        int attribute = setContent;
+        while (attribute < setContent + setLength) {
+            int attributeContent, attributeLength;
+            if (!readTlv(der, attribute, setContent + setLength, tag, attributeContent, attributeLength)
+                || tag != DER_SEQUENCE) {
+                break;
+            }
+            attribute = attributeContent + attributeLength;
+
+            int oidContent, oidLength;
+            if (!readTlv(der, attributeContent, attribute, tag, oidContent, oidLength) || tag != DER_OID) {
+                continue;
+            }
+
+            // id-at-commonName 2.5.4.3
+            if (oidLength == 3 && der.mid(oidContent, 3) == QByteArray("\x55\x04\x03", 3)) {
+                int valueContent, valueLength;
+                if (readTlv(der, oidContent + oidLength, attribute, tag, valueContent, valueLength)) {
+                    QByteArray value = der.mid(valueContent, valueLength);
+                    if (tag == 0x1E) {
+                        // BMPString: big-endian UTF-16; non-ASCII units become NUL and are dropped
+                        QByteArray ascii;
+                        for (int i = 0; i + 1 < value.size(); i += 2) {
+                            quint16 unit = readU16(value, i);
+                            ascii.append(unit < 0x80 ? static_cast<char>(unit) : '\0');
+                        }
+                        value = ascii;
+                    }
+                    commonName = printableText(value);
+                }
+            }
+        }
+    }
+
+    return commonName;
+}
@@ -0,0 +1,87 @@
+#ifndef SERVICEPROBE_H
+#define SERVICEPROBE_H
+
+#include <QString>
+#include <QByteArray>
+
+/**
+ * @brief Light service probes and banner parsing for open TCP ports
+ *
+ * Protocol knowledge only: what to send after connect, when a reply is
+ * complete, and how to turn it into a service and version string. The
+ * socket work is done by TcpConnectEngine's service probing stage.
+ *
+ * - HTTP ports: HEAD request, version from the Server header
+ * - TLS ports: TLS 1.2 ClientHello, version is the certificate subject CN
+ *   (1.2 only, so the certificate is sent in clear)
+ * - Everything else: wait for a greeting (SSH ident, SMTP/FTP 220,
+ *   POP3 +OK, IMAP * OK) and use its first line
+ */
+class ServiceProbe
+{
+public:
+    enum Kind {
+        Passive,        ///< Send nothing, read the server greeting
+        HttpHead,       ///< HEAD / HTTP/1.0
+        TlsHello        ///< ClientHello, read up to the certificate
+    };
+
+    struct Identity {
+        QString service;    ///< Detected protocol (e.g. "SSH"), empty if unknown
+        QString version;    ///< Product/version string, empty if unknown
+
+        bool isValid() const { return !service.isEmpty() || !version.isEmpty(); }
+    };
+
+    static constexpr int MAX_VERSION_LENGTH = 128;
+
+    /**
+     * @brief Probe to run on an open port
+     */
+    static Kind kindFor(quint16 port);
+
+    /**
+     * @brief Bytes to send after connect (empty for Passive)
+     * @param address Target IPv4 address, used for the HTTP Host header
+     */
+    static QByteArray request(Kind kind, quint32 address);
+
+    /**
+     * @brief Most response bytes worth keeping for this probe
+     */
+    static int responseLimit(Kind kind);
+
+    /**
+     * @brief True once @p data holds everything identify() needs
+     */
+    static bool isComplete(Kind kind, const QByteArray& data);
+
+    /**
+     * @brief Service and version from a (possibly partial) response
+     */
+    static Identity identify(Kind kind, quint16 port, const QByteArray& data);
+
+    /**
+     * @brief TLS 1.2 ClientHello record without SNI
+     */
+    static QByteArray clientHello();
+
+    /**
+     * @brief DER of the first certificate in a server's TLS records, empty if not (yet) present
+     * @param complete Set when the records prove no certificate will follow (alert, ServerHelloDone)
+     */
+    static QByteArray firstCertificate(const QByteArray& records, bool* complete = nullptr);
+
+    /**
+     * @brief Subject common name of a DER-encoded X.509 certificate
+     */
+    static QString certificateCommonName(const QByteArray& der);
+
+private:
+    static Identity identifyGreeting(quint16 port, const QByteArray& data);
+    static Identity identifyHttp(const QByteArray& data);
+    static QString firstLine(const QByteArray& data);
+    static QString printableText(const QByteArray& bytes);
+};
+
+#endif // SERVICEPROBE_H
@@ -0,0 +1,85 @@
+#include "ServiceTable.h"
+
+// Generated at configure time into the build directory
+#include "ServiceTableData.inc"
+
+const ServiceTable& ServiceTable::instance()
+{
+    // Function-local static: initialized once, thread-safe
+    static const ServiceTable table;
+    return table;
+}
+
+ServiceTable::ServiceTable()
+{
+    m_tables[Tcp].entries = TCP_SERVICES;
+    m_tables[Tcp].count = TCP_SERVICE_COUNT;
+    m_tables[Udp].entries = UDP_SERVICES;
+    m_tables[Udp].count = UDP_SERVICE_COUNT;
+
+    index(m_tables[Tcp]);
+    index(m_tables[Udp]);
+}
+
+QString ServiceTable::serviceName(int port, Protocol protocol) const
+{
+    const Entry* entry = find(port, protocol);
+    return entry ? QString::fromLatin1(entry->name) : QString("Unknown");
+}
+
+const ServiceTable::Entry* ServiceTable::find(int port, Protocol protocol) const
+{
+    int position = rank(port, protocol);
+    return position > 0 ? &m_tables[protocol].entries[position - 1] : nullptr;
+}
+
+int ServiceTable::rank(int port, Protocol protocol) const
+{
+    if (port < 0 || port > 65535) {
+        return 0;
+    }
+    return m_tables[protocol].rankByPort[port];
+}
+
+QList<int> ServiceTable::topPorts(int count, Protocol protocol) const
+{
+    const Table& table = m_tables[protocol];
+    int limit = qBound(0, count, table.count);
+
+    QList<int> ports;
+    ports.reserve(limit);
+    for (int i = 0; i < limit; ++i) {
+        ports.append(table.entries[i].port);
+    }
+    return ports;
+}
+
+double ServiceTable::expectedOpen(int count, Protocol protocol) const
+{
+    const Table& table = m_tables[protocol];
+    int limit = qBound(0, count, table.count);
+
+    double total = 0.0;
+    for (int i = 0; i < limit; ++i) {
+        total += table.entries[i].frequency;
+    }
+    return total;
+}
+
+int ServiceTable::size(Protocol protocol) const
+{
+    return m_tables[protocol].count;
+}
+
+ServiceTable::Protocol ServiceTable::protocolFromString(const QString& protocol)
+{
+    return protocol.compare("udp", Qt::CaseInsensitive) == 0 ? Udp : Tcp;
+}
+
+void ServiceTable::index(Table& table)
+{
+    table.rankByPort.fill(0, 65536);
+    for (int i = 0; i < table.count; ++i) {
+        table.rankByPort[table.entries[i].port] = static_cast<quint16>(i + 1);
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef SERVICETABLE_H
+#define SERVICETABLE_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief Shared, immutable port -> service table ranked by open frequency
+ *
+ * Compiled in at configure time from an nmap-services style file (see
+ * cmake/ServiceTable.cmake and LANSCAN_SERVICES_FILE). Entries of each
+ * protocol are stored in descending open-frequency order, so "top N
+ * ports" is a prefix of the table. A port index built on first use makes
+ * name lookups O(1). There is a single instance and it never changes,
+ * so it is safe to use from any thread without locking.
+ */
+class ServiceTable
+{
+public:
+    enum Protocol {
+        Tcp,
+        Udp
+    };
+
+    struct Entry {
+        int port;
+        const char* name;
+        double frequency;   ///< Fraction of scanned hosts with the port open
+    };
+
+    static const ServiceTable& instance();
+
+    /**
+     * @brief Service name for a port, "Unknown" if not in the table
+     */
+    QString serviceName(int port, Protocol protocol = Tcp) const;
+
+    /**
+     * @brief Table entry for a port, nullptr if not listed
+     */
+    const Entry* find(int port, Protocol protocol = Tcp) const;
+
+    /**
+     * @brief 1-based frequency rank of a port, 0 if not listed
+     */
+    int rank(int port, Protocol protocol = Tcp) const;
+
+    /**
+     * @brief The @p count most frequently open ports, most frequent first
+     *
+     * Returns fewer ports if the table holds fewer.
+     */
+    QList<int> topPorts(int count, Protocol protocol = Tcp) const;
+
+    /**
+     * @brief Expected open ports per host among the top @p count (sum of frequencies)
+     */
+    double expectedOpen(int count, Protocol protocol = Tcp) const;
+
+    int size(Protocol protocol = Tcp) const;
+
+    /**
+     * @brief "tcp"/"udp" (case-insensitive) to Protocol; anything else is Tcp
+     */
+    static Protocol protocolFromString(const QString& protocol);
+
+private:
+    ServiceTable();
+
+    ServiceTable(const ServiceTable&) = delete;
+    ServiceTable& operator=(const ServiceTable&) = delete;
+
+    struct Table {
+        const Entry* entries;
+        int count;
+        QVector<quint16> rankByPort;    ///< port -> rank (1-based), 0 = not listed
+    };
+
+    Table m_tables[2];
+
+    static void index(Table& table);
+};
+
+#endif // SERVICETABLE_H
@@ -1,4 +1,5 @@
 #include "SubnetCalculator.h"
+#include "TargetSet.h"
 #include "utils/IpAddressValidator.h"
 #include <QHostAddress>
 
@@ -35,32 +36,19 @@ QStringList SubnetCalculator::getIpRange(const QString& cidr)
         return QStringList();
     }
 
-    QPair<QString, int> parsed = IpAddressValidator::parseCidr(cidr);
-    QString baseIp = parsed.first;
-    int prefixLength = parsed.second;
-
-    QString mask = cidrToSubnetMask(prefixLength);
-    QString networkAddr = getNetworkAddress(baseIp, mask);
-    QString broadcastAddr = getBroadcastAddress(baseIp, mask);
-
-    quint32 start = ipToUInt32(networkAddr);
-    quint32 end = ipToUInt32(broadcastAddr);
-
-    QStringList range;
-
-    // Skip network address and broadcast address for usable IPs
-    if (prefixLength < 31) {
-        start++; // Skip network address
-        end--;   // Skip broadcast address
-    }
+    TargetSet targets = TargetSet::fromCidr(cidr);
 
+    // Materializes one string per address - scanners iterate TargetSet instead.
     // Limit to reasonable range size (e.g., /16 = 65534 hosts)
-    if (end - start > 65534) {
+    if (targets.size() > 65535) {
         return QStringList(); // Too large
     }
 
-    for (quint32 i = start; i <= end; ++i) {
-        range.append(uInt32ToIp(i));
+    QStringList range;
+    range.reserve(static_cast<int>(targets.size()));
+
+    for (quint32 address : targets) {
+        range.append(uInt32ToIp(address));
     }
 
     return range;
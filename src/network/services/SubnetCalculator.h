@@ -9,7 +9,7 @@ class SubnetCalculator
 public:
     static QString getNetworkAddress(const QString& ip, const QString& mask);
     static QString getBroadcastAddress(const QString& ip, const QString& mask);
-    static QStringList getIpRange(const QString& cidr);
+    static QStringList getIpRange(const QString& cidr);  // Up to a /16; use TargetSet for scanning
     static int getHostCount(const QString& cidr);
     static bool isIpInSubnet(const QString& ip, const QString& cidr);
 
@@ -0,0 +1,309 @@
+#include "TargetSet.h"
+#include "utils/Logger.h"
+#include <QFile>
+#include <algorithm>
+
+TargetSet::TargetSet()
+    : m_size(0)
+{
+}
+
+TargetSet TargetSet::fromCidr(const QString& cidr)
+{
+    Builder builder;
+    QByteArray token = cidr.trimmed().toLatin1();
+
+    if (!token.contains('/') || !builder.addToken(token.constBegin(), token.constEnd())) {
+        return TargetSet();
+    }
+
+    return build(builder);
+}
+
+TargetSet TargetSet::parse(const QString& spec, QString* error)
+{
+    Builder builder;
+
+    if (!builder.addText(spec.toLatin1())) {
+        if (error) {
+            *error = builder.error;
+        }
+        return TargetSet();
+    }
+
+    return build(builder);
+}
+
+TargetSet TargetSet::fromFile(const QString& path, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) {
+            *error = QString("Cannot open target file: %1").arg(path);
+        }
+        return TargetSet();
+    }
+
+    // Stream the file; only the parsed ranges are kept
+    Builder builder;
+    int lineNumber = 0;
+
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        lineNumber++;
+
+        if (!builder.addText(line)) {
+            if (error) {
+                *error = QString("%1 (line %2)").arg(builder.error).arg(lineNumber);
+            }
+            return TargetSet();
+        }
+    }
+
+    TargetSet set = build(builder);
+    Logger::debug(QString("TargetSet: Loaded %1 targets in %2 ranges from %3")
+                 .arg(set.size()).arg(set.m_ranges.size()).arg(path));
+    return set;
+}
+
+bool TargetSet::contains(quint32 address) const
+{
+    auto it = std::upper_bound(m_ranges.constBegin(), m_ranges.constEnd(), address,
+                               [](quint32 value, const Range& range) { return value < range.first; });
+    if (it == m_ranges.constBegin()) {
+        return false;
+    }
+    return address <= (it - 1)->last;
+}
+
+quint32 TargetSet::at(quint64 index) const
+{
+    if (index >= m_size) {
+        return 0;
+    }
+
+    auto it = std::upper_bound(m_offsets.constBegin(), m_offsets.constEnd(), index);
+    int range = static_cast<int>(it - m_offsets.constBegin()) - 1;
+    return m_ranges[range].first + static_cast<quint32>(index - m_offsets[range]);
+}
+
+bool TargetSet::parseAddress(const char* begin, const char* end, quint32& address)
+{
+    quint32 result = 0;
+    int octets = 0;
+    const char* p = begin;
+
+    while (octets < 4) {
+        int value = 0;
+        int digits = 0;
+        while (p < end && *p >= '0' && *p <= '9' && digits < 3) {
+            value = value * 10 + (*p - '0');
+            ++p;
+            ++digits;
+        }
+        if (digits == 0 || value > 255) {
+            return false;
+        }
+
+        result = (result << 8) | static_cast<quint32>(value);
+        ++octets;
+
+        if (octets < 4) {
+            if (p >= end || *p != '.') {
+                return false;
+            }
+            ++p;
+        }
+    }
+
+    if (p != end) {
+        return false;
+    }
+
+    address = result;
+    return true;
+}
+
+bool TargetSet::parseRange(const char* begin, const char* end, Range& range)
+{
+    const char* slash = std::find(begin, end, '/');
+    if (slash != end) {
+        quint32 base;
+        if (!parseAddress(begin, slash, base) || slash + 1 == end || end - slash > 3) {
+            return false;
+        }
+
+        int prefix = 0;
+        for (const char* p = slash + 1; p < end; ++p) {
+            if (*p < '0' || *p > '9') {
+                return false;
+            }
+            prefix = prefix * 10 + (*p - '0');
+        }
+        if (prefix > 32) {
+            return false;
+        }
+
+        quint32 mask = (prefix == 0) ? 0 : (0xFFFFFFFFu << (32 - prefix));
+        range.first = base & mask;
+        range.last = range.first | ~mask;
+
+        // Skip network and broadcast addresses for usable IPs
+        if (prefix < 31) {
+            range.first++;
+            range.last--;
+        }
+        return true;
+    }
+
+    const char* dash = std::find(begin, end, '-');
+    if (dash != end) {
+        if (!parseAddress(begin, dash, range.first)) {
+            return false;
+        }
+
+        const char* right = dash + 1;
+        if (std::find(right, end, '.') != end) {
+            if (!parseAddress(right, end, range.last)) {
+                return false;
+            }
+        } else {
+            // Last-octet shorthand: 10.0.0.1-50
+            int value = 0;
+            if (right == end || end - right > 3) {
+                return false;
+            }
+            for (const char* p = right; p < end; ++p) {
+                if (*p < '0' || *p > '9') {
+                    return false;
+                }
+                value = value * 10 + (*p - '0');
+            }
+            if (value > 255) {
+                return false;
+            }
+            range.last = (range.first & 0xFFFFFF00u) | static_cast<quint32>(value);
+        }
+        return range.first <= range.last;
+    }
+
+    if (!parseAddress(begin, end, range.first)) {
+        return false;
+    }
+    range.last = range.first;
+    return true;
+}
+
+bool TargetSet::Builder::addToken(const char* begin, const char* end)
+{
+    bool exclusion = (*begin == '!');
+    if (exclusion) {
+        ++begin;
+    }
+
+    Range range;
+    if (begin == end || !parseRange(begin, end, range)) {
+        error = QString("Invalid target: %1").arg(QString::fromLatin1(begin, static_cast<int>(end - begin)));
+        return false;
+    }
+
+    (exclusion ? exclude : include).append(range);
+    return true;
+}
+
+bool TargetSet::Builder::addText(const QByteArray& text)
+{
+    const char* p = text.constBegin();
+    const char* end = text.constEnd();
+
+    while (p < end) {
+        char c = *p;
+
+        if (c == '#') {
+            while (p < end && *p != '\n') {
+                ++p;
+            }
+            continue;
+        }
+        if (c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            ++p;
+            continue;
+        }
+
+        const char* tokenEnd = p;
+        while (tokenEnd < end && *tokenEnd != ',' && *tokenEnd != ' ' && *tokenEnd != '\t'
+               && *tokenEnd != '\r' && *tokenEnd != '\n' && *tokenEnd != '#') {
+            ++tokenEnd;
+        }
+
+        if (!addToken(p, tokenEnd)) {
+            return false;
+        }
+        p = tokenEnd;
+    }
+
+    return true;
+}
+
+void TargetSet::mergeRanges(QVector<Range>& ranges)
+{
+    if (ranges.isEmpty()) {
+        return;
+    }
+
+    std::sort(ranges.begin(), ranges.end(),
+              [](const Range& a, const Range& b) { return a.first < b.first; });
+
+    int out = 0;
+    for (int i = 1; i < ranges.size(); ++i) {
+        Range& current = ranges[out];
+        const Range& next = ranges[i];
+
+        // Overlapping or adjacent ranges collapse into one
+        if (static_cast<quint64>(next.first) <= static_cast<quint64>(current.last) + 1) {
+            current.last = qMax(current.last, next.last);
+        } else {
+            ranges[++out] = next;
+        }
+    }
+    ranges.resize(out + 1);
+}
+
+TargetSet TargetSet::build(Builder& builder)
+{
+    mergeRanges(builder.include);
+    mergeRanges(builder.exclude);
+
+    TargetSet set;
+    const QVector<Range>& exclude = builder.exclude;
+    int skip = 0;
+
+    for (const Range& range : builder.include) {
+        while (skip < exclude.size() && exclude[skip].last < range.first) {
+            ++skip;
+        }
+
+        quint64 start = range.first;
+        for (int k = skip; k < exclude.size() && exclude[k].first <= range.last; ++k) {
+            if (exclude[k].first > start) {
+                set.m_ranges.append({static_cast<quint32>(start), exclude[k].first - 1});
+            }
+            start = qMax<quint64>(start, static_cast<quint64>(exclude[k].last) + 1);
+            if (start > range.last) {
+                break;
+            }
+        }
+
+        if (start <= range.last) {
+            set.m_ranges.append({static_cast<quint32>(start), range.last});
+        }
+    }
+
+    set.m_offsets.reserve(set.m_ranges.size());
+    for (const Range& range : set.m_ranges) {
+        set.m_offsets.append(set.m_size);
+        set.m_size += static_cast<quint64>(range.last) - range.first + 1;
+    }
+
+    return set;
+}
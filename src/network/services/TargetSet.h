@@ -0,0 +1,138 @@
+#ifndef TARGETSET_H
+#define TARGETSET_H
+
+#include <QString>
+#include <QVector>
+#include <iterator>
+
+/**
+ * @brief Set of IPv4 scan targets stored as sorted, disjoint ranges
+ *
+ * Built from CIDRs, address ranges, single addresses and exclusions, and
+ * iterated (or indexed) as quint32 without creating strings. Memory grows
+ * with the number of disjoint ranges, not with the number of addresses:
+ * a /8 is one range.
+ *
+ * Specification syntax (comma, whitespace or newline separated):
+ *   192.168.1.0/24          CIDR, network/broadcast skipped below /31
+ *   10.0.0.1-10.0.3.254     Inclusive range
+ *   10.0.0.1-50             Range in the last octet
+ *   10.0.0.7                Single address
+ *   !10.0.0.0/29            Exclusion (any of the forms above)
+ *   # comment               Ignored up to end of line
+ *
+ * A built set is immutable, so it can be shared between threads.
+ */
+class TargetSet
+{
+public:
+    struct Range {
+        quint32 first;      ///< First address (host byte order)
+        quint32 last;       ///< Last address, inclusive
+    };
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = quint32;
+        using difference_type = qint64;
+        using pointer = const quint32*;
+        using reference = quint32;
+
+        const_iterator() : m_ranges(nullptr), m_range(0), m_address(0) {}
+
+        quint32 operator*() const { return m_address; }
+
+        const_iterator& operator++()
+        {
+            if (m_address == m_ranges->at(m_range).last) {
+                ++m_range;
+                if (m_range < m_ranges->size()) {
+                    m_address = m_ranges->at(m_range).first;
+                }
+            } else {
+                ++m_address;
+            }
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            return m_range == other.m_range && (m_range >= m_ranges->size() || m_address == other.m_address);
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class TargetSet;
+
+        const_iterator(const QVector<Range>* ranges, int range)
+            : m_ranges(ranges), m_range(range)
+            , m_address(range < ranges->size() ? ranges->at(range).first : 0) {}
+
+        const QVector<Range>* m_ranges;
+        int m_range;
+        quint32 m_address;
+    };
+
+    TargetSet();
+
+    /**
+     * @brief Usable hosts of a single CIDR (same semantics as getIpRange)
+     */
+    static TargetSet fromCidr(const QString& cidr);
+
+    /**
+     * @brief Parse a target specification (see class description)
+     * @param error Receives a description of the first invalid token
+     * @return Target set, empty if @p spec is invalid
+     */
+    static TargetSet parse(const QString& spec, QString* error = nullptr);
+
+    /**
+     * @brief Read a target file line by line, one or more tokens per line
+     */
+    static TargetSet fromFile(const QString& path, QString* error = nullptr);
+
+    quint64 size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    bool contains(quint32 address) const;
+
+    /**
+     * @brief Address at a position in ascending order, O(log ranges)
+     */
+    quint32 at(quint64 index) const;
+
+    const QVector<Range>& ranges() const { return m_ranges; }
+
+    const_iterator begin() const { return const_iterator(&m_ranges, 0); }
+    const_iterator end() const { return const_iterator(&m_ranges, m_ranges.size()); }
+
+    /**
+     * @brief Parse a dotted-quad IPv4 address without allocating
+     */
+    static bool parseAddress(const char* begin, const char* end, quint32& address);
+
+private:
+    QVector<Range> m_ranges;        ///< Sorted, disjoint, non-adjacent
+    QVector<quint64> m_offsets;     ///< Index of each range's first address
+    quint64 m_size;
+
+    /**
+     * @brief Accumulates tokens before the set is normalized
+     */
+    struct Builder {
+        QVector<Range> include;
+        QVector<Range> exclude;
+        QString error;
+
+        bool addToken(const char* begin, const char* end);
+        bool addText(const QByteArray& text);
+    };
+
+    static TargetSet build(Builder& builder);
+    static void mergeRanges(QVector<Range>& ranges);
+    static bool parseRange(const char* begin, const char* end, Range& range);
+};
+
+#endif // TARGETSET_H
@@ -0,0 +1,618 @@
+#include "IcmpEchoEngine.h"
+#include "RateController.h"
+#include "RttEstimator.h"
+#include "utils/Logger.h"
+#include <QWaitCondition>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <cstring>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace {
+const quint8 ICMP_ECHO_REPLY = 0;
+const quint8 ICMP_ECHO_REQUEST = 8;
+const int ICMP_HEADER_SIZE = 8;
+}
+
+// ----------------------------------------------------------------------------
+// IcmpSocketTransport
+// ----------------------------------------------------------------------------
+
+IcmpSocketTransport::IcmpSocketTransport()
+    : m_fd(-1)
+    , m_raw(false)
+    , m_identifier(0)
+    , m_congested(false)
+{
+}
+
+IcmpSocketTransport::~IcmpSocketTransport()
+{
+    close();
+}
+
+bool IcmpSocketTransport::open()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    if (m_fd >= 0) {
+        return true;
+    }
+
+    // Unprivileged ping socket first, raw socket as fallback
+    m_fd = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_ICMP);
+    m_raw = false;
+
+    if (m_fd < 0) {
+        m_fd = ::socket(AF_INET, SOCK_RAW, IPPROTO_ICMP);
+        m_raw = true;
+    }
+
+    if (m_fd < 0) {
+        Logger::debug(QString("IcmpSocketTransport: No ICMP socket available (%1)")
+                     .arg(QString::fromLocal8Bit(strerror(errno))));
+        return false;
+    }
+
+    m_identifier = 0;
+
+    if (!m_raw) {
+        // Linux assigns the echo identifier on bind and rewrites it on send
+        sockaddr_in local;
+        std::memset(&local, 0, sizeof(local));
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (::bind(m_fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) == 0) {
+            socklen_t length = sizeof(local);
+            if (::getsockname(m_fd, reinterpret_cast<sockaddr*>(&local), &length) == 0) {
+                m_identifier = ntohs(local.sin_port);
+            }
+        }
+
+        int on = 1;
+        ::setsockopt(m_fd, IPPROTO_IP, IP_RECVTTL, &on, sizeof(on));
+    }
+
+    if (m_identifier == 0) {
+        m_identifier = static_cast<quint16>(QRandomGenerator::global()->bounded(1, 0xFFFF));
+    }
+
+    // Large receive buffer so replies to a burst are not dropped
+    int bufferSize = 1024 * 1024;
+    ::setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    int flags = ::fcntl(m_fd, F_GETFL, 0);
+    ::fcntl(m_fd, F_SETFL, flags | O_NONBLOCK);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void IcmpSocketTransport::close()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+}
+
+quint16 IcmpSocketTransport::identifier() const
+{
+    return m_identifier;
+}
+
+bool IcmpSocketTransport::send(quint32 address, const quint8* data, int length)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    if (m_fd < 0) {
+        return false;
+    }
+
+    sockaddr_in dest;
+    std::memset(&dest, 0, sizeof(dest));
+    dest.sin_family = AF_INET;
+    dest.sin_addr.s_addr = htonl(address);
+    m_congested = false;
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        ssize_t sent = ::sendto(m_fd, data, length, 0,
+                                reinterpret_cast<sockaddr*>(&dest), sizeof(dest));
+        if (sent == length) {
+            return true;
+        }
+
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+            return false;
+        }
+
+        // Send queue full - wait briefly for it to drain
+        pollfd pfd;
+        pfd.fd = m_fd;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        ::poll(&pfd, 1, 10);
+    }
+
+    // Still full after retrying; the engine reports it for paced probes
+    m_congested = true;
+    return false;
+#else
+    Q_UNUSED(address);
+    Q_UNUSED(data);
+    Q_UNUSED(length);
+    return false;
+#endif
+}
+
+int IcmpSocketTransport::receive(quint32& address, quint8* buffer, int capacity, int& ttl, int timeoutMs)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    if (m_fd < 0) {
+        return -1;
+    }
+
+    pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ready = ::poll(&pfd, 1, timeoutMs);
+    if (ready <= 0) {
+        return (ready == 0 || errno == EINTR) ? 0 : -1;
+    }
+
+    quint8 packet[2048];
+    char control[64];
+    sockaddr_in from;
+    iovec iov;
+    iov.iov_base = packet;
+    iov.iov_len = sizeof(packet);
+
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &from;
+    msg.msg_namelen = sizeof(from);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received = ::recvmsg(m_fd, &msg, 0);
+    if (received < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    }
+
+    address = ntohl(from.sin_addr.s_addr);
+    ttl = 0;
+
+    const quint8* icmp = packet;
+    int length = static_cast<int>(received);
+
+    // Raw sockets deliver the IP header as well, and so do datagram sockets
+    // on macOS; no ICMP type has 4 in its high nibble, an IPv4 header does
+    bool hasIpHeader = m_raw;
+#ifdef Q_OS_MACOS
+    hasIpHeader = hasIpHeader || (length > 0 && (packet[0] >> 4) == 4);
+#endif
+
+    if (hasIpHeader) {
+        if (length < 20) {
+            return 0;
+        }
+        int headerLength = (packet[0] & 0x0F) * 4;
+        if (length < headerLength + ICMP_HEADER_SIZE) {
+            return 0;
+        }
+        ttl = packet[8];
+        icmp = packet + headerLength;
+        length -= headerLength;
+    } else {
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != IPPROTO_IP) {
+                continue;
+            }
+#ifdef Q_OS_LINUX
+            if (cmsg->cmsg_type == IP_TTL) {
+                int value = 0;
+                std::memcpy(&value, CMSG_DATA(cmsg), sizeof(value));
+                ttl = value;
+            }
+#else
+            if (cmsg->cmsg_type == IP_RECVTTL) {
+                ttl = *reinterpret_cast<const quint8*>(CMSG_DATA(cmsg));
+            }
+#endif
+        }
+    }
+
+    length = qMin(length, capacity);
+    std::memcpy(buffer, icmp, length);
+    return length;
+#else
+    Q_UNUSED(address);
+    Q_UNUSED(buffer);
+    Q_UNUSED(capacity);
+    Q_UNUSED(ttl);
+    Q_UNUSED(timeoutMs);
+    return -1;
+#endif
+}
+
+bool IcmpSocketTransport::congested() const
+{
+    return m_congested;
+}
+
+QString IcmpSocketTransport::name() const
+{
+    if (m_fd < 0) {
+        return "none";
+    }
+    return m_raw ? "raw ICMP socket" : "unprivileged ICMP datagram socket";
+}
+
+// ----------------------------------------------------------------------------
+// IcmpEchoEngine
+// ----------------------------------------------------------------------------
+
+IcmpEchoEngine* IcmpEchoEngine::instance()
+{
+    // Function-local static: initialized once, thread-safe
+    static IcmpEchoEngine* engine = new IcmpEchoEngine(new IcmpSocketTransport());
+    return engine;
+}
+
+IcmpEchoEngine::IcmpEchoEngine(IcmpTransport* transport)
+    : m_transport(transport)
+    , m_available(false)
+    , m_nextSequence(static_cast<quint16>(QRandomGenerator::global()->bounded(0x10000)))
+    , m_receiver(nullptr)
+    , m_running(false)
+{
+    m_clock.start();
+    m_available = m_transport->open();
+
+    if (m_available) {
+        m_running = true;
+        m_receiver = QThread::create([this]() { receiveLoop(); });
+        m_receiver->start();
+        Logger::info(QString("IcmpEchoEngine: Using %1 (identifier %2)")
+                    .arg(m_transport->name()).arg(m_transport->identifier()));
+    } else {
+        Logger::warn("IcmpEchoEngine: ICMP socket unavailable, falling back to ping process");
+    }
+}
+
+IcmpEchoEngine::~IcmpEchoEngine()
+{
+    m_running = false;
+    if (m_receiver) {
+        m_receiver->wait();
+        delete m_receiver;
+    }
+
+    // Fail anything still outstanding so blocking callers wake up
+    QMutexLocker dispatchLocker(&m_dispatchMutex);
+    QMutexLocker locker(&m_mutex);
+    QHash<quint16, Pending> pending = m_pending;
+    m_pending.clear();
+    m_deadlines.clear();
+    locker.unlock();
+
+    for (const Pending& entry : pending) {
+        EchoResult result;
+        result.address = entry.address;
+        entry.callback(result);
+    }
+    dispatchLocker.unlock();
+
+    m_transport->close();
+    delete m_transport;
+}
+
+bool IcmpEchoEngine::isAvailable() const
+{
+    return m_available;
+}
+
+void IcmpEchoEngine::submit(quint32 address, int timeoutMs, Callback callback, const void* owner,
+                            Pacing pacing)
+{
+    EchoResult failed;
+    failed.address = address;
+
+    if (!m_available) {
+        callback(failed);
+        return;
+    }
+
+    // Paced by the shared probe budget; never while holding m_mutex
+    if (pacing == Paced) {
+        RateController::instance()->acquire();
+    }
+
+    quint8 packet[ICMP_HEADER_SIZE + PAYLOAD_SIZE];
+    bool sent = false;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_pending.size() >= 0xFFFF) {
+            locker.unlock();
+            Logger::warn("IcmpEchoEngine: Sequence space exhausted, dropping request");
+            callback(failed);
+            return;
+        }
+
+        quint16 sequence = allocateSequence();
+        int length = buildRequest(packet, sequence);
+
+        Pending entry;
+        entry.address = address;
+        entry.sentNs = m_clock.nsecsElapsed();
+        entry.deadlineMs = m_clock.elapsed() + qMax(1, timeoutMs);
+        entry.callback = callback;
+        entry.owner = owner;
+        entry.paced = pacing == Paced;
+
+        m_pending.insert(sequence, entry);
+        m_deadlines.insert(entry.deadlineMs, sequence);
+
+        sent = m_transport->send(address, packet, length);
+        if (!sent) {
+            m_deadlines.remove(entry.deadlineMs, sequence);
+            m_pending.remove(sequence);
+        }
+    }
+
+    if (!sent) {
+        if (pacing == Paced && m_transport->congested()) {
+            RateController::instance()->reportCongestion();
+        }
+        callback(failed);
+    }
+}
+
+void IcmpEchoEngine::submitBatch(const QVector<quint32>& addresses, int timeoutMs, Callback callback,
+                                 const void* owner)
+{
+    for (quint32 address : addresses) {
+        submit(address, timeoutMs, callback, owner);
+    }
+}
+
+void IcmpEchoEngine::cancel(const void* owner)
+{
+    if (owner == nullptr) {
+        return;
+    }
+
+    QMutexLocker dispatchLocker(&m_dispatchMutex);
+    QMutexLocker locker(&m_mutex);
+
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it->owner == owner) {
+            m_deadlines.remove(it->deadlineMs, it.key());
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+IcmpEchoEngine::EchoResult IcmpEchoEngine::echo(quint32 address, int timeoutMs, Pacing pacing)
+{
+    return echoBatch(QVector<quint32>() << address, timeoutMs, pacing).first();
+}
+
+QVector<IcmpEchoEngine::EchoResult> IcmpEchoEngine::echoBatch(const QVector<quint32>& addresses, int timeoutMs,
+                                                              Pacing pacing)
+{
+    QVector<EchoResult> results(addresses.size());
+    if (addresses.isEmpty()) {
+        return results;
+    }
+
+    QMutex mutex;
+    QWaitCondition finished;
+    int remaining = addresses.size();
+
+    for (int i = 0; i < addresses.size(); ++i) {
+        submit(addresses[i], timeoutMs, [&, i](const EchoResult& result) {
+            QMutexLocker locker(&mutex);
+            results[i] = result;
+            if (--remaining == 0) {
+                finished.wakeAll();
+            }
+        }, nullptr, pacing);
+    }
+
+    // Every submitted request gets exactly one callback (reply, timeout or failure)
+    QMutexLocker locker(&mutex);
+    while (remaining > 0) {
+        finished.wait(&mutex);
+    }
+
+    return results;
+}
+
+int IcmpEchoEngine::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending.size();
+}
+
+QString IcmpEchoEngine::transportName() const
+{
+    return m_transport->name();
+}
+
+void IcmpEchoEngine::receiveLoop()
+{
+    quint8 buffer[MAX_MESSAGE_SIZE];
+
+    while (m_running.load()) {
+        quint32 from = 0;
+        int ttl = 0;
+        int length = m_transport->receive(from, buffer, sizeof(buffer), ttl, nextWaitMs());
+
+        if (length > 0) {
+            handleMessage(from, buffer, length, ttl);
+        } else if (length < 0) {
+            // Persistent socket error - avoid spinning
+            QThread::msleep(IDLE_WAIT_MS);
+        }
+
+        expireDeadlines();
+    }
+}
+
+void IcmpEchoEngine::handleMessage(quint32 from, const quint8* data, int length, int ttl)
+{
+    if (length < ICMP_HEADER_SIZE || data[0] != ICMP_ECHO_REPLY || data[1] != 0) {
+        return;
+    }
+
+    quint16 identifier = static_cast<quint16>((data[4] << 8) | data[5]);
+    quint16 sequence = static_cast<quint16>((data[6] << 8) | data[7]);
+
+    if (identifier != m_transport->identifier()) {
+        return;
+    }
+
+    QMutexLocker dispatchLocker(&m_dispatchMutex);
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_pending.find(sequence);
+    if (it == m_pending.end() || it->address != from) {
+        return;
+    }
+
+    Pending entry = it.value();
+    m_pending.erase(it);
+    m_deadlines.remove(entry.deadlineMs, sequence);
+    qint64 nowNs = m_clock.nsecsElapsed();
+    locker.unlock();
+
+    EchoResult result;
+    result.address = from;
+    result.success = true;
+    result.latency = (nowNs - entry.sentNs) / 1000000.0;
+    result.ttl = ttl;
+    result.bytes = length;
+
+    if (entry.paced) {
+        RateController::instance()->reportResponse();
+    }
+    RttEstimator::instance()->addSample(from, result.latency);
+    entry.callback(result);
+}
+
+void IcmpEchoEngine::expireDeadlines()
+{
+    QMutexLocker dispatchLocker(&m_dispatchMutex);
+    QMutexLocker locker(&m_mutex);
+
+    qint64 now = m_clock.elapsed();
+    if (m_deadlines.isEmpty() || m_deadlines.firstKey() > now) {
+        return;
+    }
+
+    QVector<Pending> expired;
+    auto it = m_deadlines.begin();
+    while (it != m_deadlines.end() && it.key() <= now) {
+        auto pendingIt = m_pending.find(it.value());
+        if (pendingIt != m_pending.end()) {
+            expired.append(pendingIt.value());
+            m_pending.erase(pendingIt);
+        }
+        it = m_deadlines.erase(it);
+    }
+    locker.unlock();
+
+    for (const Pending& entry : expired) {
+        EchoResult result;
+        result.address = entry.address;
+        if (entry.paced) {
+            RateController::instance()->reportTimeout();
+        }
+        entry.callback(result);
+    }
+}
+
+int IcmpEchoEngine::nextWaitMs() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_deadlines.isEmpty()) {
+        return IDLE_WAIT_MS;
+    }
+
+    qint64 wait = m_deadlines.firstKey() - m_clock.elapsed();
+    return static_cast<int>(qBound<qint64>(0, wait, IDLE_WAIT_MS));
+}
+
+quint16 IcmpEchoEngine::allocateSequence()
+{
+    // Caller holds m_mutex and has checked that a free slot exists
+    while (m_pending.contains(m_nextSequence)) {
+        ++m_nextSequence;
+    }
+    return m_nextSequence++;
+}
+
+int IcmpEchoEngine::buildRequest(quint8* buffer, quint16 sequence) const
+{
+    quint16 identifier = m_transport->identifier();
+    int length = ICMP_HEADER_SIZE + PAYLOAD_SIZE;
+
+    buffer[0] = ICMP_ECHO_REQUEST;
+    buffer[1] = 0;
+    buffer[2] = 0;
+    buffer[3] = 0;
+    buffer[4] = static_cast<quint8>(identifier >> 8);
+    buffer[5] = static_cast<quint8>(identifier & 0xFF);
+    buffer[6] = static_cast<quint8>(sequence >> 8);
+    buffer[7] = static_cast<quint8>(sequence & 0xFF);
+
+    for (int i = 0; i < PAYLOAD_SIZE; ++i) {
+        buffer[ICMP_HEADER_SIZE + i] = static_cast<quint8>('a' + (i % 26));
+    }
+
+    quint16 sum = checksum(buffer, length);
+    buffer[2] = static_cast<quint8>(sum >> 8);
+    buffer[3] = static_cast<quint8>(sum & 0xFF);
+
+    return length;
+}
+
+quint16 IcmpEchoEngine::checksum(const quint8* data, int length)
+{
+    quint32 sum = 0;
+
+    for (int i = 0; i + 1 < length; i += 2) {
+        sum += (data[i] << 8) | data[i + 1];
+    }
+    if (length & 1) {
+        sum += data[length - 1] << 8;
+    }
+
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+
+    return static_cast<quint16>(~sum);
+}
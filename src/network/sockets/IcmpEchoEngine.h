@@ -0,0 +1,220 @@
+#ifndef ICMPECHOENGINE_H
+#define ICMPECHOENGINE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMultiMap>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QThread>
+#include <functional>
+#include <atomic>
+
+/**
+ * @brief Datagram transport used by IcmpEchoEngine
+ *
+ * Abstracts the socket so the engine can run against the kernel
+ * (IcmpSocketTransport) or against a scripted responder in tests.
+ * Buffers always start at the ICMP header; transports that receive
+ * IP headers (raw sockets) must strip them.
+ */
+class IcmpTransport
+{
+public:
+    virtual ~IcmpTransport() = default;
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+
+    /**
+     * @brief Echo identifier carried by replies to this transport
+     *
+     * For Linux ping sockets this is the kernel-assigned identifier,
+     * which overrides whatever the request carries.
+     */
+    virtual quint16 identifier() const = 0;
+
+    virtual bool send(quint32 address, const quint8* data, int length) = 0;
+
+    /**
+     * @brief Whether the last failed send() failed because the send queue stayed full
+     */
+    virtual bool congested() const { return false; }
+
+    /**
+     * @brief Wait for a single ICMP message
+     * @param address Source IPv4 address (host byte order)
+     * @param buffer Destination buffer, receives the ICMP header and payload
+     * @param capacity Buffer size in bytes
+     * @param ttl Receives the IP TTL of the reply, or 0 if unknown
+     * @param timeoutMs Maximum wait in milliseconds
+     * @return Message length, 0 on timeout, -1 on error
+     */
+    virtual int receive(quint32& address, quint8* buffer, int capacity, int& ttl, int timeoutMs) = 0;
+
+    virtual QString name() const = 0;
+};
+
+/**
+ * @brief Kernel ICMP transport
+ *
+ * Prefers unprivileged SOCK_DGRAM/IPPROTO_ICMP sockets (Linux ping
+ * sockets, allowed by net.ipv4.ping_group_range) and falls back to a
+ * raw socket when running with CAP_NET_RAW. Not available on Windows.
+ */
+class IcmpSocketTransport : public IcmpTransport
+{
+public:
+    IcmpSocketTransport();
+    ~IcmpSocketTransport() override;
+
+    bool open() override;
+    void close() override;
+    quint16 identifier() const override;
+    bool send(quint32 address, const quint8* data, int length) override;
+    bool congested() const override;
+    int receive(quint32& address, quint8* buffer, int capacity, int& ttl, int timeoutMs) override;
+    QString name() const override;
+
+    bool isRaw() const { return m_raw; }
+
+private:
+    int m_fd;
+    bool m_raw;
+    quint16 m_identifier;
+    bool m_congested;
+};
+
+/**
+ * @brief Native ICMP echo engine
+ *
+ * A single socket sends echo requests for any number of targets and a
+ * receiver thread matches replies by identifier and sequence number.
+ * Callers can submit asynchronously (callback invoked on the receiver
+ * thread) or use the blocking echo()/echoBatch() wrappers from worker
+ * threads. Replaces one `ping` process per probe.
+ *
+ * Scan probes are paced by the shared RateController and report their
+ * outcome to it. Monitoring probes are sent Unpaced: they run at a fixed
+ * interval, so a running scan must not delay them and their losses must
+ * not slow scans down.
+ */
+class IcmpEchoEngine
+{
+public:
+    /**
+     * @brief Outcome of a single echo request
+     */
+    enum Pacing {
+        Paced,      ///< Waits on and reports to RateController::instance()
+        Unpaced     ///< Sent at once and not counted by the rate controller
+    };
+
+    struct EchoResult {
+        quint32 address;    ///< Target IPv4 address (host byte order)
+        bool success;       ///< Whether an echo reply was received
+        double latency;     ///< Round-trip time in milliseconds
+        int ttl;            ///< TTL of the reply (0 if unknown)
+        int bytes;          ///< Size of the ICMP reply
+
+        EchoResult()
+            : address(0), success(false), latency(0.0), ttl(0), bytes(0) {}
+    };
+
+    using Callback = std::function<void(const EchoResult&)>;
+
+    /**
+     * @brief Shared engine backed by the kernel socket transport
+     */
+    static IcmpEchoEngine* instance();
+
+    /**
+     * @brief Construct an engine over the given transport (takes ownership)
+     */
+    explicit IcmpEchoEngine(IcmpTransport* transport);
+    ~IcmpEchoEngine();
+
+    IcmpEchoEngine(const IcmpEchoEngine&) = delete;
+    IcmpEchoEngine& operator=(const IcmpEchoEngine&) = delete;
+
+    /**
+     * @brief Check whether the transport could be opened
+     */
+    bool isAvailable() const;
+
+    /**
+     * @brief Send one echo request
+     * @param address Target IPv4 address (host byte order)
+     * @param timeoutMs Reply deadline in milliseconds
+     * @param callback Invoked once with the result, on the receiver thread
+     * @param owner Optional tag used by cancel()
+     * @param pacing Whether the shared rate controller applies
+     */
+    void submit(quint32 address, int timeoutMs, Callback callback, const void* owner = nullptr,
+                Pacing pacing = Paced);
+
+    /**
+     * @brief Send echo requests to all addresses in one batch
+     */
+    void submitBatch(const QVector<quint32>& addresses, int timeoutMs, Callback callback,
+                     const void* owner = nullptr);
+
+    /**
+     * @brief Drop pending requests of an owner; their callbacks never run
+     *
+     * Once this returns no callback for @p owner is executing or will execute.
+     */
+    void cancel(const void* owner);
+
+    /**
+     * @brief Blocking single echo
+     */
+    EchoResult echo(quint32 address, int timeoutMs, Pacing pacing = Paced);
+
+    /**
+     * @brief Blocking batch echo, results in the same order as @p addresses
+     */
+    QVector<EchoResult> echoBatch(const QVector<quint32>& addresses, int timeoutMs, Pacing pacing = Paced);
+
+    int pendingCount() const;
+    QString transportName() const;
+
+private:
+    struct Pending {
+        quint32 address;
+        qint64 sentNs;
+        qint64 deadlineMs;
+        Callback callback;
+        const void* owner;
+        bool paced;
+    };
+
+    static constexpr int MAX_MESSAGE_SIZE = 1500;
+    static constexpr int PAYLOAD_SIZE = 32;
+    static constexpr int IDLE_WAIT_MS = 50;
+
+    IcmpTransport* m_transport;
+    bool m_available;
+
+    mutable QMutex m_mutex;              ///< Guards pending state
+    QMutex m_dispatchMutex;              ///< Held while callbacks run (see cancel())
+    QHash<quint16, Pending> m_pending;   ///< Sequence -> pending request
+    QMultiMap<qint64, quint16> m_deadlines;
+    quint16 m_nextSequence;
+
+    QElapsedTimer m_clock;
+    QThread* m_receiver;
+    std::atomic<bool> m_running;
+
+    void receiveLoop();
+    void handleMessage(quint32 from, const quint8* data, int length, int ttl);
+    void expireDeadlines();
+    int nextWaitMs() const;
+    quint16 allocateSequence();
+    int buildRequest(quint8* buffer, quint16 sequence) const;
+
+    static quint16 checksum(const quint8* data, int length);
+};
+
+#endif // ICMPECHOENGINE_H
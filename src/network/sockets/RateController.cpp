@@ -0,0 +1,229 @@
+#include "RateController.h"
+#include "utils/Logger.h"
+#include <QMutexLocker>
+#include <QThread>
+#include <cmath>
+#include <cstring>
+
+RateController::RateController()
+    : m_ceiling(0.0)
+    , m_rate(0.0)
+    , m_tokens(0.0)
+    , m_lastRefillNs(0)
+    , m_windowStartMs(0)
+    , m_windowResponses(0)
+    , m_windowTimeouts(0)
+    , m_baseline(-1.0)
+    , m_lastDecreaseMs(-WINDOW_MS)
+    , m_bucketEpoch(0)
+{
+    std::memset(m_sentBuckets, 0, sizeof(m_sentBuckets));
+    m_clock.start();
+}
+
+RateController* RateController::instance()
+{
+    // Function-local static: initialized once, thread-safe
+    static RateController* controller = new RateController();
+    return controller;
+}
+
+void RateController::setTargetRate(double packetsPerSecond)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_ceiling = qMax(0.0, packetsPerSecond);
+    m_rate = m_ceiling;
+    m_tokens = qMax(1.0, m_rate * BURST_SECONDS);
+    m_lastRefillNs = m_clock.nsecsElapsed();
+
+    m_windowStartMs = m_clock.elapsed();
+    m_windowResponses = 0;
+    m_windowTimeouts = 0;
+    m_baseline = -1.0;
+
+    Logger::debug(m_ceiling > 0
+        ? QString("RateController: Ceiling set to %1 pps").arg(m_ceiling)
+        : QString("RateController: Unlimited rate"));
+}
+
+double RateController::targetRate() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_ceiling;
+}
+
+double RateController::currentRate() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_rate;
+}
+
+double RateController::effectiveRate() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    qint64 nowSlot = m_clock.elapsed() / 100;
+    if (nowSlot - m_bucketEpoch >= RATE_BUCKETS) {
+        return 0.0;
+    }
+
+    // Buckets cover the last second (RATE_BUCKETS x 100 ms)
+    qint64 sent = 0;
+    for (qint64 slot = nowSlot - RATE_BUCKETS + 1; slot <= m_bucketEpoch; ++slot) {
+        if (slot >= 0) {
+            sent += m_sentBuckets[slot % RATE_BUCKETS];
+        }
+    }
+    return static_cast<double>(sent);
+}
+
+bool RateController::tryAcquire(int tokens)
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 nowNs = m_clock.nsecsElapsed();
+
+    if (m_ceiling <= 0) {
+        recordSent(tokens, nowNs / 1000000);
+        return true;
+    }
+
+    refill(nowNs);
+
+    // Requests larger than the bucket go through once it is full and leave a debt
+    double capacity = qMax(1.0, m_rate * BURST_SECONDS);
+    if (m_tokens < qMin(static_cast<double>(tokens), capacity)) {
+        return false;
+    }
+
+    m_tokens -= tokens;
+    recordSent(tokens, nowNs / 1000000);
+    return true;
+}
+
+void RateController::acquire(int tokens)
+{
+    while (!tryAcquire(tokens)) {
+        int waitMs = waitTimeMs(tokens);
+        if (waitMs > 0) {
+            QThread::msleep(static_cast<unsigned long>(waitMs));
+        } else {
+            // Sub-millisecond wait at high rates
+            QThread::usleep(100);
+        }
+    }
+}
+
+int RateController::waitTimeMs(int tokens) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_ceiling <= 0 || m_rate <= 0) {
+        return 0;
+    }
+
+    double elapsed = (m_clock.nsecsElapsed() - m_lastRefillNs) / 1e9;
+    double capacity = qMax(1.0, m_rate * BURST_SECONDS);
+    double available = qMin(capacity, m_tokens + elapsed * m_rate);
+    double missing = qMin(static_cast<double>(tokens), capacity) - available;
+
+    if (missing <= 0) {
+        return 0;
+    }
+    return static_cast<int>(std::floor(missing / m_rate * 1000.0));
+}
+
+void RateController::reportResponse()
+{
+    QMutexLocker locker(&m_mutex);
+    // Close the previous window first, this outcome belongs to the next one
+    evaluateWindow(m_clock.elapsed());
+    m_windowResponses++;
+}
+
+void RateController::reportTimeout()
+{
+    QMutexLocker locker(&m_mutex);
+    evaluateWindow(m_clock.elapsed());
+    m_windowTimeouts++;
+}
+
+void RateController::reportCongestion()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_ceiling > 0) {
+        decrease(m_clock.elapsed());
+    }
+}
+
+void RateController::refill(qint64 nowNs)
+{
+    double elapsed = (nowNs - m_lastRefillNs) / 1e9;
+    double capacity = qMax(1.0, m_rate * BURST_SECONDS);
+
+    m_tokens = qMin(capacity, m_tokens + elapsed * m_rate);
+    m_lastRefillNs = nowNs;
+}
+
+void RateController::recordSent(int tokens, qint64 nowMs)
+{
+    qint64 slot = nowMs / 100;
+
+    if (slot > m_bucketEpoch) {
+        qint64 stale = qMin<qint64>(slot - m_bucketEpoch, RATE_BUCKETS);
+        for (qint64 i = 1; i <= stale; ++i) {
+            m_sentBuckets[(m_bucketEpoch + i) % RATE_BUCKETS] = 0;
+        }
+        m_bucketEpoch = slot;
+    }
+
+    m_sentBuckets[slot % RATE_BUCKETS] += tokens;
+}
+
+void RateController::evaluateWindow(qint64 nowMs)
+{
+    if (nowMs - m_windowStartMs < WINDOW_MS) {
+        return;
+    }
+
+    int total = m_windowResponses + m_windowTimeouts;
+    if (total < MIN_WINDOW_SAMPLES) {
+        return;
+    }
+
+    double ratio = static_cast<double>(m_windowTimeouts) / total;
+
+    if (m_baseline < 0) {
+        m_baseline = ratio;
+    } else if (ratio > m_baseline + LOSS_MARGIN) {
+        // More timeouts than the target set explains: the path is dropping probes
+        if (m_ceiling > 0) {
+            decrease(nowMs);
+        }
+    } else if (m_ceiling > 0 && m_rate < m_ceiling) {
+        m_rate = qMin(m_ceiling, m_rate + m_ceiling * INCREASE_FRACTION);
+    }
+
+    // Follows lasting shifts too, e.g. a scan moving into sparse address space;
+    // a frozen baseline would keep halving the rate down to MIN_RATE
+    m_baseline = m_baseline * (1.0 - BASELINE_WEIGHT) + ratio * BASELINE_WEIGHT;
+
+    m_windowStartMs = nowMs;
+    m_windowResponses = 0;
+    m_windowTimeouts = 0;
+}
+
+void RateController::decrease(qint64 nowMs)
+{
+    // At most one decrease per window, one loss event must not cascade
+    if (nowMs - m_lastDecreaseMs < WINDOW_MS) {
+        return;
+    }
+
+    double floor = qMin(MIN_RATE, m_ceiling);
+    m_rate = qMax(floor, m_rate * DECREASE_FACTOR);
+    m_tokens = qMin(m_tokens, qMax(1.0, m_rate * BURST_SECONDS));
+    m_lastDecreaseMs = nowMs;
+
+    Logger::debug(QString("RateController: Backing off to %1 pps").arg(m_rate, 0, 'f', 0));
+}
@@ -0,0 +1,107 @@
+#ifndef RATECONTROLLER_H
+#define RATECONTROLLER_H
+
+#include <QMutex>
+#include <QElapsedTimer>
+
+/**
+ * @brief Probe rate limiter with AIMD congestion control
+ *
+ * Shared by the probe engines (ICMP echo, TCP connect, DNS). A token
+ * bucket enforces the current rate, which never exceeds the configured
+ * ceiling. Engines report each probe's outcome: when the share of
+ * timeouts in a window rises clearly above its long-run baseline (dead
+ * hosts and filtered ports always time out), the rate is halved; while
+ * it stays at baseline the rate grows by a fixed step per window.
+ * Explicit congestion signals (ENOBUFS, EAGAIN on send) back off at once.
+ *
+ * A ceiling of 0 means unlimited; acquire() then never waits.
+ * All methods are thread-safe.
+ */
+class RateController
+{
+public:
+    static RateController* instance();
+
+    RateController();
+
+    RateController(const RateController&) = delete;
+    RateController& operator=(const RateController&) = delete;
+
+    /**
+     * @brief Set the packets-per-second ceiling (0 = unlimited)
+     *
+     * Restarts the controller at the ceiling with a fresh loss baseline.
+     */
+    void setTargetRate(double packetsPerSecond);
+    double targetRate() const;
+
+    /**
+     * @brief Current AIMD rate in packets per second (0 if unlimited)
+     */
+    double currentRate() const;
+
+    /**
+     * @brief Measured send rate over the last second
+     */
+    double effectiveRate() const;
+
+    /**
+     * @brief Take tokens without waiting
+     * @return True if the probes may be sent now
+     */
+    bool tryAcquire(int tokens = 1);
+
+    /**
+     * @brief Block until the tokens are available
+     */
+    void acquire(int tokens = 1);
+
+    /**
+     * @brief Milliseconds until tryAcquire(tokens) can succeed (0 if now)
+     */
+    int waitTimeMs(int tokens = 1) const;
+
+    void reportResponse();
+    void reportTimeout();
+
+    /**
+     * @brief Local congestion signal, e.g. a send failing with ENOBUFS
+     */
+    void reportCongestion();
+
+private:
+    static constexpr int WINDOW_MS = 200;            ///< AIMD evaluation window
+    static constexpr int MIN_WINDOW_SAMPLES = 10;
+    static constexpr double DECREASE_FACTOR = 0.5;
+    static constexpr double INCREASE_FRACTION = 0.05; ///< Additive step as share of the ceiling
+    static constexpr double LOSS_MARGIN = 0.15;       ///< Timeout ratio rise treated as congestion
+    static constexpr double BASELINE_WEIGHT = 0.1;
+    static constexpr double MIN_RATE = 10.0;
+    static constexpr double BURST_SECONDS = 0.05;     ///< Bucket depth in seconds of traffic
+    static constexpr int RATE_BUCKETS = 10;           ///< 100 ms buckets for effectiveRate()
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+
+    double m_ceiling;
+    double m_rate;
+    double m_tokens;
+    qint64 m_lastRefillNs;
+
+    qint64 m_windowStartMs;
+    int m_windowResponses;
+    int m_windowTimeouts;
+    double m_baseline;              ///< Long-run timeout ratio, -1 until the first window
+    qint64 m_lastDecreaseMs;
+
+    qint64 m_sentBuckets[RATE_BUCKETS];
+    qint64 m_bucketEpoch;           ///< 100 ms slot of the newest bucket
+
+    void refill(qint64 nowNs);
+    void recordSent(int tokens, qint64 nowMs);
+    void evaluateWindow(qint64 nowMs);
+    void decrease(qint64 nowMs);
+};
+
+#endif // RATECONTROLLER_H
@@ -0,0 +1,105 @@
+#include "RttEstimator.h"
+#include "utils/Logger.h"
+#include <QMutexLocker>
+#include <cmath>
+
+RttEstimator::RttEstimator()
+    : m_minTimeout(DEFAULT_MIN_TIMEOUT_MS)
+    , m_maxTimeout(DEFAULT_MAX_TIMEOUT_MS)
+{
+}
+
+RttEstimator* RttEstimator::instance()
+{
+    // Function-local static: initialized once, thread-safe
+    static RttEstimator* estimator = new RttEstimator();
+    return estimator;
+}
+
+void RttEstimator::setBounds(int minTimeoutMs, int maxTimeoutMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxTimeout = qMax(1, maxTimeoutMs);
+    m_minTimeout = qBound(1, minTimeoutMs, m_maxTimeout);
+
+    Logger::debug(QString("RttEstimator: Timeouts bounded to %1-%2 ms")
+                 .arg(m_minTimeout).arg(m_maxTimeout));
+}
+
+int RttEstimator::minTimeout() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_minTimeout;
+}
+
+int RttEstimator::maxTimeout() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxTimeout;
+}
+
+void RttEstimator::addSample(quint32 address, double rttMs)
+{
+    if (rttMs < 0) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_hosts.size() >= MAX_HOSTS && !m_hosts.contains(address)) {
+        m_hosts.clear();
+    }
+
+    update(m_hosts[address], rttMs);
+    update(m_subnets[address & SUBNET_MASK], rttMs);
+}
+
+int RttEstimator::timeoutFor(quint32 address) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto host = m_hosts.constFind(address);
+    if (host != m_hosts.constEnd()) {
+        return timeoutFrom(host.value());
+    }
+
+    auto subnet = m_subnets.constFind(address & SUBNET_MASK);
+    if (subnet != m_subnets.constEnd()) {
+        return timeoutFrom(subnet.value());
+    }
+
+    return qBound(m_minTimeout, INITIAL_TIMEOUT_MS, m_maxTimeout);
+}
+
+double RttEstimator::smoothedRtt(quint32 address) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto host = m_hosts.constFind(address);
+    return host != m_hosts.constEnd() ? host->srtt : -1.0;
+}
+
+void RttEstimator::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hosts.clear();
+    m_subnets.clear();
+}
+
+void RttEstimator::update(Estimate& estimate, double rttMs)
+{
+    if (estimate.srtt < 0) {
+        estimate.srtt = rttMs;
+        estimate.rttvar = rttMs / 2.0;
+        return;
+    }
+
+    // RFC 6298: beta = 1/4, alpha = 1/8; variance uses the previous SRTT
+    estimate.rttvar = 0.75 * estimate.rttvar + 0.25 * std::fabs(estimate.srtt - rttMs);
+    estimate.srtt = 0.875 * estimate.srtt + 0.125 * rttMs;
+}
+
+int RttEstimator::timeoutFrom(const Estimate& estimate) const
+{
+    double timeout = estimate.srtt + qMax(1.0, 4.0 * estimate.rttvar);
+    return qBound(m_minTimeout, static_cast<int>(std::ceil(timeout)), m_maxTimeout);
+}
@@ -0,0 +1,88 @@
+#ifndef RTTESTIMATOR_H
+#define RTTESTIMATOR_H
+
+#include <QHash>
+#include <QMutex>
+
+/**
+ * @brief Smoothed round-trip estimates used to derive probe timeouts
+ *
+ * Keeps a TCP-style (RFC 6298) smoothed RTT and RTT variance per host
+ * and per /24 subnet. The probe engines feed every measured round trip;
+ * scanners ask for a timeout instead of waiting a fixed time:
+ *
+ *   timeout = SRTT + max(1 ms, 4 * RTTVAR), clamped to [min, max]
+ *
+ * A host with samples uses its own estimate, an unknown host on a
+ * subnet with samples uses the subnet's (this is what bounds the wait
+ * on dead addresses), and with no samples at all the initial timeout
+ * of min(1 s, max) applies.
+ *
+ * Timeouts do not back the estimate off: a dead host never answers and
+ * must not slow down the rest of the subnet. All methods are thread-safe.
+ */
+class RttEstimator
+{
+public:
+    static RttEstimator* instance();
+
+    RttEstimator();
+
+    RttEstimator(const RttEstimator&) = delete;
+    RttEstimator& operator=(const RttEstimator&) = delete;
+
+    static constexpr int DEFAULT_MIN_TIMEOUT_MS = 100;
+    static constexpr int DEFAULT_MAX_TIMEOUT_MS = 3000;
+
+    /**
+     * @brief Set the bounds applied to every derived timeout
+     */
+    void setBounds(int minTimeoutMs, int maxTimeoutMs);
+    int minTimeout() const;
+    int maxTimeout() const;
+
+    /**
+     * @brief Record a measured round trip to an address
+     * @param address IPv4 address (host byte order)
+     * @param rttMs Round-trip time in milliseconds
+     */
+    void addSample(quint32 address, double rttMs);
+
+    /**
+     * @brief Timeout in milliseconds for the next probe to an address
+     */
+    int timeoutFor(quint32 address) const;
+
+    /**
+     * @brief Smoothed RTT of a host in milliseconds, -1 if it has no samples
+     */
+    double smoothedRtt(quint32 address) const;
+
+    /**
+     * @brief Forget all estimates
+     */
+    void clear();
+
+private:
+    struct Estimate {
+        double srtt;
+        double rttvar;
+
+        Estimate() : srtt(-1.0), rttvar(0.0) {}
+    };
+
+    static constexpr quint32 SUBNET_MASK = 0xFFFFFF00u;
+    static constexpr int INITIAL_TIMEOUT_MS = 1000;
+    static constexpr int MAX_HOSTS = 65536;     ///< Host table is reset beyond this
+
+    mutable QMutex m_mutex;
+    int m_minTimeout;
+    int m_maxTimeout;
+    QHash<quint32, Estimate> m_hosts;
+    QHash<quint32, Estimate> m_subnets;
+
+    static void update(Estimate& estimate, double rttMs);
+    int timeoutFrom(const Estimate& estimate) const;
+};
+
+#endif // RTTESTIMATOR_H
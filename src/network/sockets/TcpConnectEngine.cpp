@@ -0,0 +1,622 @@
+#include "TcpConnectEngine.h"
+#include "RateController.h"
+#include "RttEstimator.h"
+#include "utils/Logger.h"
+#include <QMutexLocker>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/resource.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace {
+// Descriptors kept free for the rest of the application
+const int RESERVED_DESCRIPTORS = 128;
+}
+
+TcpConnectEngine::TcpConnectEngine(int globalLimit, int perHostLimit)
+    : m_globalLimit(qMax(1, globalLimit))
+    , m_perHostLimit(qMax(1, perHostLimit))
+    , m_effectiveLimit(m_globalLimit)
+    , m_epollFd(-1)
+    , m_wakeFd(-1)
+    , m_cancelled(false)
+    , m_peakInFlight(0)
+    , m_roundRobin(0)
+    , m_rateLimited(false)
+    , m_probing(false)
+    , m_probeDeadlineMs(DEFAULT_PROBE_DEADLINE_MS)
+    , m_maxSessions(DEFAULT_PROBE_SESSIONS)
+{
+    m_clock.start();
+
+#ifdef Q_OS_LINUX
+    // Raise the soft descriptor limit; every probe holds one socket
+    rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        rlim_t wanted = qMin<rlim_t>(limit.rlim_max, 65536);
+        if (limit.rlim_cur < wanted) {
+            limit.rlim_cur = wanted;
+            ::setrlimit(RLIMIT_NOFILE, &limit);
+            ::getrlimit(RLIMIT_NOFILE, &limit);
+        }
+
+        int usable = static_cast<int>(limit.rlim_cur) - RESERVED_DESCRIPTORS;
+        if (usable < m_globalLimit) {
+            m_globalLimit = qMax(16, usable);
+            m_effectiveLimit = m_globalLimit;
+            Logger::debug(QString("TcpConnectEngine: Global limit capped to %1 by RLIMIT_NOFILE")
+                         .arg(m_globalLimit));
+        }
+    }
+
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (m_epollFd >= 0 && m_wakeFd >= 0) {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = m_wakeFd;
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+    } else {
+        Logger::error("TcpConnectEngine: Failed to create epoll instance");
+    }
+#endif
+}
+
+TcpConnectEngine::~TcpConnectEngine()
+{
+    abortAll();
+
+#ifdef Q_OS_LINUX
+    if (m_wakeFd >= 0) {
+        ::close(m_wakeFd);
+    }
+    if (m_epollFd >= 0) {
+        ::close(m_epollFd);
+    }
+#endif
+}
+
+bool TcpConnectEngine::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TcpConnectEngine::setResultCallback(ResultCallback callback)
+{
+    m_resultCallback = callback;
+}
+
+void TcpConnectEngine::setHostCompletedCallback(HostCallback callback)
+{
+    m_hostCallback = callback;
+}
+
+void TcpConnectEngine::setLimits(int globalLimit, int perHostLimit)
+{
+    m_globalLimit = qMax(1, globalLimit);
+    m_perHostLimit = qMax(1, perHostLimit);
+    m_effectiveLimit = m_globalLimit;
+}
+
+void TcpConnectEngine::setServiceProbing(bool enabled, int deadlineMs, int maxSessions)
+{
+    m_probing = enabled;
+    m_probeDeadlineMs = qMax(1, deadlineMs);
+    m_maxSessions = qMax(1, maxSessions);
+}
+
+void TcpConnectEngine::addHost(quint32 address, const QVector<quint16>& ports, int timeoutMs)
+{
+    HostJob* job = new HostJob;
+    job->address = address;
+    job->ports = ports;
+    job->timeoutMs = qMax(1, timeoutMs);
+    job->next = 0;
+    job->inFlight = 0;
+    job->completed = 0;
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_incoming.append(job);
+    }
+
+    wake();
+}
+
+void TcpConnectEngine::cancel()
+{
+    m_cancelled = true;
+    wake();
+}
+
+void TcpConnectEngine::reset()
+{
+    m_cancelled = false;
+    m_peakInFlight = 0;
+}
+
+int TcpConnectEngine::queuedHosts() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_incoming.size();
+}
+
+void TcpConnectEngine::run()
+{
+#ifdef Q_OS_LINUX
+    if (m_epollFd < 0) {
+        return;
+    }
+
+    epoll_event events[MAX_EVENTS];
+
+    while (!m_cancelled.load()) {
+        takeIncoming();
+        fill();
+        reapCompletedHosts();
+
+        if (m_active.isEmpty() && m_probes.isEmpty() && m_sessions.isEmpty()) {
+            QMutexLocker locker(&m_queueMutex);
+            if (m_incoming.isEmpty()) {
+                break;
+            }
+            continue;
+        }
+
+        int count = ::epoll_wait(m_epollFd, events, MAX_EVENTS, nextWaitMs());
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+
+            if (fd == m_wakeFd) {
+                quint64 value;
+                while (::read(m_wakeFd, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+
+            if (m_sessions.contains(fd)) {
+                serviceSession(fd, events[i].events);
+                continue;
+            }
+
+            int error = 0;
+            socklen_t length = sizeof(error);
+            if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0) {
+                error = errno;
+            }
+
+            RateController::instance()->reportResponse();
+
+            if (error == 0) {
+                finishProbe(fd, Open);
+            } else if (error == ECONNREFUSED) {
+                finishProbe(fd, Closed);
+            } else {
+                finishProbe(fd, Filtered);
+            }
+        }
+
+        expireDeadlines();
+    }
+
+    if (m_cancelled.load()) {
+        abortAll();
+    }
+#endif
+}
+
+void TcpConnectEngine::takeIncoming()
+{
+    QMutexLocker locker(&m_queueMutex);
+    m_active.append(m_incoming);
+    m_incoming.clear();
+}
+
+void TcpConnectEngine::fill()
+{
+    bool launched = true;
+    m_rateLimited = false;
+
+    // Open ports need a free session slot; hold new connects until one frees up
+    if (m_probing && m_sessions.size() >= m_maxSessions) {
+        return;
+    }
+
+    // Round-robin across hosts so one large host cannot starve the rest
+    while (launched && m_probes.size() + m_sessions.size() < m_effectiveLimit && !m_active.isEmpty()) {
+        launched = false;
+
+        for (int n = 0; n < m_active.size() && m_probes.size() + m_sessions.size() < m_effectiveLimit; ++n) {
+            HostJob* job = m_active[(m_roundRobin + n) % m_active.size()];
+
+            if (job->next < job->ports.size() && job->inFlight < m_perHostLimit) {
+                if (!RateController::instance()->tryAcquire()) {
+                    m_rateLimited = true;
+                    return;
+                }
+                if (!launch(job)) {
+                    return;
+                }
+                launched = true;
+            }
+        }
+
+        m_roundRobin = (m_roundRobin + 1) % qMax(1, static_cast<int>(m_active.size()));
+    }
+}
+
+bool TcpConnectEngine::launch(HostJob* job)
+{
+#ifdef Q_OS_LINUX
+    quint16 port = job->ports[job->next];
+    qint64 startNs = m_clock.nsecsElapsed();
+
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        if (errno == EMFILE || errno == ENFILE) {
+            // Out of descriptors - hold at the current level until probes complete
+            m_effectiveLimit = qMax(1, static_cast<int>(m_probes.size()));
+            Logger::debug(QString("TcpConnectEngine: Descriptor limit reached, in-flight capped at %1")
+                         .arg(m_effectiveLimit));
+            return false;
+        }
+        job->next++;
+        report(job, port, Filtered, elapsedMs(startNs));
+        return true;
+    }
+
+    // Reset on close: no FIN handshake and no TIME_WAIT for open ports
+    linger lingerOption;
+    lingerOption.l_onoff = 1;
+    lingerOption.l_linger = 0;
+    ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &lingerOption, sizeof(lingerOption));
+
+    sockaddr_in dest;
+    std::memset(&dest, 0, sizeof(dest));
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(port);
+    dest.sin_addr.s_addr = htonl(job->address);
+
+    int result = ::connect(fd, reinterpret_cast<sockaddr*>(&dest), sizeof(dest));
+    int error = (result == 0) ? 0 : errno;
+
+    // An immediate connect (loopback) goes through epoll too when it is to be probed
+    if (error == EINPROGRESS || (error == 0 && m_probing)) {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLOUT | EPOLLERR | EPOLLHUP;
+        event.data.fd = fd;
+
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            ::close(fd);
+            job->next++;
+            report(job, port, Filtered, elapsedMs(startNs));
+            return true;
+        }
+
+        Probe probe;
+        probe.job = job;
+        probe.port = port;
+        probe.startNs = startNs;
+        probe.deadlineMs = m_clock.elapsed() + job->timeoutMs;
+
+        m_probes.insert(fd, probe);
+        m_deadlines.insert(probe.deadlineMs, fd);
+        job->next++;
+        job->inFlight++;
+
+        int inFlight = static_cast<int>(m_probes.size() + m_sessions.size());
+        if (inFlight > m_peakInFlight.load()) {
+            m_peakInFlight = inFlight;
+        }
+        return true;
+    }
+
+    ::close(fd);
+
+    if (error == EADDRNOTAVAIL || error == EAGAIN) {
+        // Local ephemeral ports exhausted - retry this port once probes drain
+        m_effectiveLimit = qMax(1, static_cast<int>(m_probes.size()));
+        return false;
+    }
+
+    if (error == ENOBUFS) {
+        // Local send queue full - slow the shared probe rate as well
+        RateController::instance()->reportCongestion();
+        m_effectiveLimit = qMax(1, static_cast<int>(m_probes.size()));
+        return false;
+    }
+
+    job->next++;
+    if (error == 0 || error == ECONNREFUSED) {
+        RateController::instance()->reportResponse();
+    }
+    if (error == 0) {
+        report(job, port, Open, elapsedMs(startNs));
+    } else if (error == ECONNREFUSED) {
+        report(job, port, Closed, elapsedMs(startNs));
+    } else {
+        report(job, port, Filtered, elapsedMs(startNs));
+    }
+    return true;
+#else
+    Q_UNUSED(job);
+    return false;
+#endif
+}
+
+void TcpConnectEngine::finishProbe(int fd, PortState state)
+{
+#ifdef Q_OS_LINUX
+    auto it = m_probes.find(fd);
+    if (it == m_probes.end()) {
+        return;
+    }
+
+    Probe probe = it.value();
+    m_probes.erase(it);
+    m_deadlines.remove(probe.deadlineMs, fd);
+
+    // Keep open sockets for the probing stage while session slots are free
+    if (state == Open && m_probing && m_sessions.size() < m_maxSessions && startSession(fd, probe)) {
+        return;
+    }
+
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+
+    probe.job->inFlight--;
+    report(probe.job, probe.port, state, elapsedMs(probe.startNs));
+
+    // Recover additively after descriptor or port exhaustion
+    if (m_effectiveLimit < m_globalLimit) {
+        m_effectiveLimit++;
+    }
+#else
+    Q_UNUSED(fd);
+    Q_UNUSED(state);
+#endif
+}
+
+bool TcpConnectEngine::startSession(int fd, const Probe& probe)
+{
+#ifdef Q_OS_LINUX
+    Session session;
+    session.probe = probe;
+    session.kind = ServiceProbe::kindFor(probe.port);
+    session.request = ServiceProbe::request(session.kind, probe.job->address);
+    session.sent = 0;
+    session.connectTime = elapsedMs(probe.startNs);
+    session.deadlineMs = m_clock.elapsed() + m_probeDeadlineMs;
+
+    // Passive probes only read; the others write their request first
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLRDHUP | (session.request.isEmpty() ? 0 : EPOLLOUT);
+    event.data.fd = fd;
+    if (::epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &event) < 0) {
+        return false;
+    }
+
+    m_sessions.insert(fd, session);
+    m_sessionDeadlines.insert(session.deadlineMs, fd);
+    return true;
+#else
+    Q_UNUSED(fd);
+    Q_UNUSED(probe);
+    return false;
+#endif
+}
+
+void TcpConnectEngine::serviceSession(int fd, quint32 events)
+{
+#ifdef Q_OS_LINUX
+    auto it = m_sessions.find(fd);
+    if (it == m_sessions.end()) {
+        return;
+    }
+    Session& session = it.value();
+    bool done = false;
+
+    if ((events & EPOLLOUT) && session.sent < session.request.size()) {
+        ssize_t written = ::send(fd, session.request.constData() + session.sent,
+                                 session.request.size() - session.sent, MSG_NOSIGNAL);
+        if (written > 0) {
+            session.sent += static_cast<int>(written);
+        } else if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            done = true;
+        }
+
+        if (session.sent >= session.request.size()) {
+            epoll_event event;
+            std::memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.fd = fd;
+            ::epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &event);
+        }
+    }
+
+    if (!done && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+        int limit = ServiceProbe::responseLimit(session.kind);
+        char buffer[4096];
+
+        while (session.response.size() < limit) {
+            int wanted = qMin(static_cast<int>(sizeof(buffer)), limit - static_cast<int>(session.response.size()));
+            ssize_t received = ::recv(fd, buffer, wanted, 0);
+            if (received > 0) {
+                session.response.append(buffer, static_cast<int>(received));
+                continue;
+            }
+            if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                done = true;
+            }
+            break;
+        }
+    }
+
+    if (done || session.response.size() >= ServiceProbe::responseLimit(session.kind)
+        || ServiceProbe::isComplete(session.kind, session.response)) {
+        finishSession(fd);
+    }
+#else
+    Q_UNUSED(fd);
+    Q_UNUSED(events);
+#endif
+}
+
+void TcpConnectEngine::finishSession(int fd)
+{
+#ifdef Q_OS_LINUX
+    auto it = m_sessions.find(fd);
+    if (it == m_sessions.end()) {
+        return;
+    }
+
+    Session session = it.value();
+    m_sessions.erase(it);
+    m_sessionDeadlines.remove(session.deadlineMs, fd);
+
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+
+    HostJob* job = session.probe.job;
+    job->inFlight--;
+    report(job, session.probe.port, Open, session.connectTime,
+           ServiceProbe::identify(session.kind, session.probe.port, session.response));
+
+    if (m_effectiveLimit < m_globalLimit) {
+        m_effectiveLimit++;
+    }
+#else
+    Q_UNUSED(fd);
+#endif
+}
+
+void TcpConnectEngine::report(HostJob* job, quint16 port, PortState state, double responseTime,
+                              const ServiceProbe::Identity& identity)
+{
+    job->completed++;
+
+    // SYN-ACK and RST both measure a full round trip
+    if (state != Filtered) {
+        RttEstimator::instance()->addSample(job->address, responseTime);
+    }
+
+    if (m_resultCallback) {
+        ProbeResult result;
+        result.address = job->address;
+        result.port = port;
+        result.state = state;
+        result.responseTime = responseTime;
+        result.service = identity.service;
+        result.version = identity.version;
+        m_resultCallback(result);
+    }
+}
+
+double TcpConnectEngine::elapsedMs(qint64 startNs) const
+{
+    return (m_clock.nsecsElapsed() - startNs) / 1000000.0;
+}
+
+void TcpConnectEngine::expireDeadlines()
+{
+    qint64 now = m_clock.elapsed();
+
+    while (!m_deadlines.isEmpty() && m_deadlines.firstKey() <= now) {
+        RateController::instance()->reportTimeout();
+        finishProbe(m_deadlines.first(), Filtered);
+    }
+
+    // Slow or silent services: report with whatever arrived so far
+    while (!m_sessionDeadlines.isEmpty() && m_sessionDeadlines.firstKey() <= now) {
+        finishSession(m_sessionDeadlines.first());
+    }
+}
+
+void TcpConnectEngine::reapCompletedHosts()
+{
+    for (int i = m_active.size() - 1; i >= 0; --i) {
+        HostJob* job = m_active[i];
+        if (job->completed >= job->ports.size()) {
+            m_active.removeAt(i);
+            quint32 address = job->address;
+            delete job;
+
+            if (m_hostCallback) {
+                m_hostCallback(address);
+            }
+        }
+    }
+}
+
+void TcpConnectEngine::abortAll()
+{
+#ifdef Q_OS_LINUX
+    for (auto it = m_probes.constBegin(); it != m_probes.constEnd(); ++it) {
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, it.key(), nullptr);
+        ::close(it.key());
+    }
+    for (auto it = m_sessions.constBegin(); it != m_sessions.constEnd(); ++it) {
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, it.key(), nullptr);
+        ::close(it.key());
+    }
+#endif
+    m_probes.clear();
+    m_deadlines.clear();
+    m_sessions.clear();
+    m_sessionDeadlines.clear();
+
+    qDeleteAll(m_active);
+    m_active.clear();
+
+    QMutexLocker locker(&m_queueMutex);
+    qDeleteAll(m_incoming);
+    m_incoming.clear();
+}
+
+int TcpConnectEngine::nextWaitMs() const
+{
+    int wait = IDLE_WAIT_MS;
+
+    if (!m_deadlines.isEmpty()) {
+        qint64 deadline = m_deadlines.firstKey() - m_clock.elapsed();
+        wait = static_cast<int>(qBound<qint64>(0, deadline, IDLE_WAIT_MS));
+    }
+    if (!m_sessionDeadlines.isEmpty()) {
+        qint64 deadline = m_sessionDeadlines.firstKey() - m_clock.elapsed();
+        wait = qMin(wait, static_cast<int>(qBound<qint64>(0, deadline, IDLE_WAIT_MS)));
+    }
+
+    // Wake up again as soon as the rate limiter has a token
+    if (m_rateLimited) {
+        wait = qMin(wait, qMax(1, RateController::instance()->waitTimeMs()));
+    }
+
+    return wait;
+}
+
+void TcpConnectEngine::wake()
+{
+#ifdef Q_OS_LINUX
+    if (m_wakeFd >= 0) {
+        quint64 value = 1;
+        ssize_t written = ::write(m_wakeFd, &value, sizeof(value));
+        Q_UNUSED(written);
+    }
+#endif
+}
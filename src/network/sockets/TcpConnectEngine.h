@@ -0,0 +1,205 @@
+#ifndef TCPCONNECTENGINE_H
+#define TCPCONNECTENGINE_H
+
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QMultiMap>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <functional>
+#include <atomic>
+#include "network/services/ServiceProbe.h"
+
+/**
+ * @brief Event-driven mass TCP connect scanner
+ *
+ * Keeps thousands of non-blocking connect() calls in flight on one
+ * epoll instance and classifies each port from SO_ERROR or timeout:
+ * connected = open, ECONNREFUSED = closed, anything else or no answer
+ * before the deadline = filtered. Hosts are served round-robin under a
+ * global and a per-host in-flight cap, paced by the shared RateController.
+ *
+ * With service probing enabled, an open port's socket stays on the same
+ * epoll instance for a short exchange (see ServiceProbe) before it is
+ * reported, so the result carries the detected service and version.
+ * Probe sessions count against the in-flight caps, have their own
+ * deadline, keep at most a few KB each, and new connects wait while
+ * all session slots are taken.
+ *
+ * run() executes on the calling thread and invokes the callbacks there.
+ * addHost() and cancel() are thread-safe. Linux only; isSupported()
+ * returns false elsewhere and callers keep their blocking fallback.
+ */
+class TcpConnectEngine
+{
+public:
+    enum PortState {
+        Open,
+        Closed,
+        Filtered
+    };
+
+    struct ProbeResult {
+        quint32 address;        ///< Target IPv4 address (host byte order)
+        quint16 port;           ///< Probed port
+        PortState state;        ///< Classification
+        double responseTime;    ///< Time to classification in milliseconds
+        QString service;        ///< Service detected by probing, empty if none
+        QString version;        ///< Banner/version detected by probing, empty if none
+
+        ProbeResult()
+            : address(0), port(0), state(Filtered), responseTime(0.0) {}
+    };
+
+    using ResultCallback = std::function<void(const ProbeResult&)>;
+    using HostCallback = std::function<void(quint32 address)>;
+
+    static constexpr int DEFAULT_GLOBAL_LIMIT = 4096;
+    static constexpr int DEFAULT_PER_HOST_LIMIT = 1024;
+    static constexpr int DEFAULT_PROBE_DEADLINE_MS = 3000;
+    static constexpr int DEFAULT_PROBE_SESSIONS = 256;
+
+    explicit TcpConnectEngine(int globalLimit = DEFAULT_GLOBAL_LIMIT,
+                              int perHostLimit = DEFAULT_PER_HOST_LIMIT);
+    ~TcpConnectEngine();
+
+    TcpConnectEngine(const TcpConnectEngine&) = delete;
+    TcpConnectEngine& operator=(const TcpConnectEngine&) = delete;
+
+    /**
+     * @brief Check whether the engine can run on this platform
+     */
+    static bool isSupported();
+
+    void setResultCallback(ResultCallback callback);
+    void setHostCompletedCallback(HostCallback callback);
+
+    /**
+     * @brief Set concurrency caps (applies to probes launched afterwards)
+     */
+    void setLimits(int globalLimit, int perHostLimit);
+    int globalLimit() const { return m_globalLimit; }
+    int perHostLimit() const { return m_perHostLimit; }
+
+    /**
+     * @brief Identify services on open ports before reporting them
+     * @param enabled Run the probing stage
+     * @param deadlineMs Time allowed per probe session after connect
+     * @param maxSessions Probe sessions open at once
+     */
+    void setServiceProbing(bool enabled, int deadlineMs = DEFAULT_PROBE_DEADLINE_MS,
+                           int maxSessions = DEFAULT_PROBE_SESSIONS);
+    bool serviceProbing() const { return m_probing; }
+
+    /**
+     * @brief Queue a host for scanning
+     * @param address Target IPv4 address (host byte order)
+     * @param ports Ports to probe
+     * @param timeoutMs Per-connect deadline in milliseconds
+     */
+    void addHost(quint32 address, const QVector<quint16>& ports, int timeoutMs);
+
+    /**
+     * @brief Probe all queued hosts; returns when they are done or on cancel()
+     */
+    void run();
+
+    /**
+     * @brief Abort run(); outstanding probes are dropped without callbacks
+     */
+    void cancel();
+
+    /**
+     * @brief Clear a previous cancel() and the peak counter so the engine can be reused
+     */
+    void reset();
+
+    bool isCancelled() const { return m_cancelled.load(); }
+
+    /**
+     * @brief Most probes and service sessions in flight at once since reset()
+     */
+    int peakInFlight() const { return m_peakInFlight.load(); }
+
+    /**
+     * @brief Number of hosts added but not yet picked up by run()
+     */
+    int queuedHosts() const;
+
+private:
+    struct HostJob {
+        quint32 address;
+        QVector<quint16> ports;
+        int timeoutMs;
+        int next;
+        int inFlight;
+        int completed;
+    };
+
+    struct Probe {
+        HostJob* job;
+        quint16 port;
+        qint64 startNs;
+        qint64 deadlineMs;
+    };
+
+    struct Session {
+        Probe probe;
+        ServiceProbe::Kind kind;
+        QByteArray request;
+        int sent;
+        QByteArray response;
+        double connectTime;     ///< Connect round trip, reported as the response time
+        qint64 deadlineMs;
+    };
+
+    static constexpr int MAX_EVENTS = 256;
+    static constexpr int IDLE_WAIT_MS = 50;
+
+    int m_globalLimit;
+    int m_perHostLimit;
+    int m_effectiveLimit;       ///< Lowered temporarily on descriptor exhaustion
+
+    int m_epollFd;
+    int m_wakeFd;
+    std::atomic<bool> m_cancelled;
+    std::atomic<int> m_peakInFlight;
+
+    mutable QMutex m_queueMutex;
+    QList<HostJob*> m_incoming;
+
+    QList<HostJob*> m_active;
+    int m_roundRobin;
+    bool m_rateLimited;                     ///< fill() stopped for lack of rate tokens
+    QHash<int, Probe> m_probes;             ///< Socket descriptor -> probe
+    QMultiMap<qint64, int> m_deadlines;     ///< Deadline -> socket descriptor
+
+    bool m_probing;
+    int m_probeDeadlineMs;
+    int m_maxSessions;
+    QHash<int, Session> m_sessions;                 ///< Socket descriptor -> probe session
+    QMultiMap<qint64, int> m_sessionDeadlines;      ///< Deadline -> socket descriptor
+    QElapsedTimer m_clock;
+
+    ResultCallback m_resultCallback;
+    HostCallback m_hostCallback;
+
+    void takeIncoming();
+    void fill();
+    bool launch(HostJob* job);
+    void finishProbe(int fd, PortState state);
+    bool startSession(int fd, const Probe& probe);
+    void serviceSession(int fd, quint32 events);
+    void finishSession(int fd);
+    void report(HostJob* job, quint16 port, PortState state, double responseTime,
+                const ServiceProbe::Identity& identity = ServiceProbe::Identity());
+    double elapsedMs(qint64 startNs) const;
+    void expireDeadlines();
+    void reapCompletedHosts();
+    void abortAll();
+    int nextWaitMs() const;
+    void wake();
+};
+
+#endif // TCPCONNECTENGINE_H
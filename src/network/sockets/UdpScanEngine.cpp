@@ -0,0 +1,763 @@
+#include "UdpScanEngine.h"
+#include "RateController.h"
+#include "RttEstimator.h"
+#include "utils/Logger.h"
+#include <QMutexLocker>
+#include <QSet>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <linux/errqueue.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace {
+const int RECEIVE_BUFFER_BYTES = 1 << 20;
+const quint16 SSDP_PORT = 1900;
+const int ICMP_DEST_UNREACH = 3;
+
+QByteArray bytes(std::initializer_list<quint8> values)
+{
+    QByteArray data;
+    data.reserve(static_cast<int>(values.size()));
+    for (quint8 value : values) {
+        data.append(static_cast<char>(value));
+    }
+    return data;
+}
+
+QHash<quint16, QByteArray> buildPayloads()
+{
+    QHash<quint16, QByteArray> payloads;
+
+    // DNS: non-recursive query for the root NS set; any server answers (even REFUSED)
+    payloads.insert(53, bytes({
+        0x4C, 0x53, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x02, 0x00, 0x01 }));
+
+    // NTP: version 4 client request, LI unsynchronized
+    QByteArray ntp(48, '\0');
+    ntp[0] = static_cast<char>(0xE3);
+    payloads.insert(123, ntp);
+
+    // NetBIOS: node status (NBSTAT) query for the wildcard name "*"
+    QByteArray nbstat = bytes({
+        0x4C, 0x53, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20 });
+    nbstat.append("CK");
+    nbstat.append(QByteArray(30, 'A'));
+    nbstat.append(bytes({ 0x00, 0x00, 0x21, 0x00, 0x01 }));
+    payloads.insert(137, nbstat);
+
+    // SNMP: v1 GetRequest for sysDescr.0 with community "public"
+    payloads.insert(161, bytes({
+        0x30, 0x26, 0x02, 0x01, 0x00, 0x04, 0x06, 'p', 'u', 'b', 'l', 'i', 'c',
+        0xA0, 0x19, 0x02, 0x01, 0x01, 0x02, 0x01, 0x00, 0x02, 0x01, 0x00,
+        0x30, 0x0E, 0x30, 0x0C, 0x06, 0x08, 0x2B, 0x06, 0x01, 0x02, 0x01, 0x01, 0x01, 0x00,
+        0x05, 0x00 }));
+
+    // SSDP: unicast M-SEARCH for every device and service type
+    payloads.insert(SSDP_PORT, QByteArray(
+        "M-SEARCH * HTTP/1.1\r\n"
+        "HOST: 239.255.255.250:1900\r\n"
+        "MAN: \"ssdp:discover\"\r\n"
+        "MX: 1\r\n"
+        "ST: ssdp:all\r\n"
+        "\r\n"));
+
+    // mDNS: legacy unicast service enumeration; responders answer our source port directly
+    QByteArray mdns = bytes({ 0x4C, 0x53, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 });
+    for (const char* label : { "_services", "_dns-sd", "_udp", "local" }) {
+        mdns.append(static_cast<char>(std::strlen(label)));
+        mdns.append(label);
+    }
+    mdns.append(bytes({ 0x00, 0x00, 0x0C, 0x00, 0x01 }));
+    payloads.insert(5353, mdns);
+
+    return payloads;
+}
+}
+
+UdpScanEngine::UdpScanEngine(int globalLimit, int perHostLimit)
+    : m_globalLimit(qMax(1, globalLimit))
+    , m_perHostLimit(qMax(1, perHostLimit))
+    , m_maxRetries(DEFAULT_MAX_RETRIES)
+    , m_socketFd(-1)
+    , m_epollFd(-1)
+    , m_wakeFd(-1)
+    , m_cancelled(false)
+    , m_roundRobin(0)
+    , m_rateLimited(false)
+    , m_nextPacedMs(-1)
+    , m_pausedUntilMs(0)
+{
+    m_clock.start();
+
+#ifdef Q_OS_LINUX
+    m_socketFd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (m_socketFd < 0 || m_epollFd < 0 || m_wakeFd < 0) {
+        Logger::error("UdpScanEngine: Failed to create socket or epoll instance");
+        return;
+    }
+
+    // ICMP errors for our datagrams are queued on the socket with the original destination
+    int enable = 1;
+    if (::setsockopt(m_socketFd, IPPROTO_IP, IP_RECVERR, &enable, sizeof(enable)) < 0) {
+        Logger::warn("UdpScanEngine: IP_RECVERR unavailable, closed ports will look open|filtered");
+    }
+
+    // Replies from a whole subnet can arrive in one burst
+    int bufferSize = RECEIVE_BUFFER_BYTES;
+    ::setsockopt(m_socketFd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = m_wakeFd;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+
+    // EPOLLERR is always reported and signals a pending error queue entry
+    event.events = EPOLLIN;
+    event.data.fd = m_socketFd;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_socketFd, &event);
+#endif
+}
+
+UdpScanEngine::~UdpScanEngine()
+{
+    abortAll();
+
+#ifdef Q_OS_LINUX
+    if (m_socketFd >= 0) {
+        ::close(m_socketFd);
+    }
+    if (m_wakeFd >= 0) {
+        ::close(m_wakeFd);
+    }
+    if (m_epollFd >= 0) {
+        ::close(m_epollFd);
+    }
+#endif
+}
+
+bool UdpScanEngine::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+QByteArray UdpScanEngine::payloadFor(quint16 port)
+{
+    static const QHash<quint16, QByteArray> payloads = buildPayloads();
+    return payloads.value(port);
+}
+
+void UdpScanEngine::setResultCallback(ResultCallback callback)
+{
+    m_resultCallback = callback;
+}
+
+void UdpScanEngine::setHostCompletedCallback(HostCallback callback)
+{
+    m_hostCallback = callback;
+}
+
+void UdpScanEngine::setLimits(int globalLimit, int perHostLimit)
+{
+    m_globalLimit = qMax(1, globalLimit);
+    m_perHostLimit = qMax(1, perHostLimit);
+}
+
+void UdpScanEngine::setMaxRetries(int retries)
+{
+    m_maxRetries = qMax(0, retries);
+}
+
+void UdpScanEngine::addHost(quint32 address, const QVector<quint16>& ports, int timeoutMs)
+{
+    HostJob* job = new HostJob;
+    job->address = address;
+    job->timeoutMs = qMax(1, timeoutMs);
+    job->next = 0;
+    job->inFlight = 0;
+    job->completed = 0;
+    job->intervalMs = 0;
+    job->nextSendMs = 0;
+    job->lastBackoffMs = 0;
+    job->unreachables = 0;
+
+    // Probes are keyed by address and port, so each port is sent once per host
+    QSet<quint16> seen;
+    job->ports.reserve(ports.size());
+    for (quint16 port : ports) {
+        if (port != 0 && !seen.contains(port)) {
+            seen.insert(port);
+            job->ports.append(port);
+        }
+    }
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_incoming.append(job);
+    }
+
+    wake();
+}
+
+void UdpScanEngine::cancel()
+{
+    m_cancelled = true;
+    wake();
+}
+
+void UdpScanEngine::reset()
+{
+    m_cancelled = false;
+}
+
+int UdpScanEngine::queuedHosts() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_incoming.size();
+}
+
+void UdpScanEngine::run()
+{
+#ifdef Q_OS_LINUX
+    if (m_socketFd < 0 || m_epollFd < 0) {
+        return;
+    }
+
+    epoll_event events[MAX_EVENTS];
+
+    while (!m_cancelled.load()) {
+        takeIncoming();
+        fill();
+        reapCompletedHosts();
+
+        if (m_active.isEmpty() && m_probes.isEmpty()) {
+            QMutexLocker locker(&m_queueMutex);
+            if (m_incoming.isEmpty()) {
+                break;
+            }
+            continue;
+        }
+
+        int count = ::epoll_wait(m_epollFd, events, MAX_EVENTS, nextWaitMs());
+
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd == m_wakeFd) {
+                quint64 value;
+                while (::read(m_wakeFd, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+
+            if (events[i].events & EPOLLERR) {
+                receiveErrors();
+            }
+            if (events[i].events & EPOLLIN) {
+                receiveReplies();
+            }
+        }
+
+        expireDeadlines();
+    }
+
+    if (m_cancelled.load()) {
+        abortAll();
+    }
+#endif
+}
+
+void UdpScanEngine::takeIncoming()
+{
+    QMutexLocker locker(&m_queueMutex);
+    m_active.append(m_incoming);
+    m_incoming.clear();
+}
+
+void UdpScanEngine::fill()
+{
+    qint64 now = m_clock.elapsed();
+    m_rateLimited = false;
+    m_nextPacedMs = -1;
+
+    if (now < m_pausedUntilMs) {
+        return;
+    }
+
+    QVector<Outgoing> batch;
+    batch.reserve(SEND_BATCH);
+    bool queued = true;
+
+    // Round-robin across hosts: each host is paced on its own, the subnet is not
+    while (queued && !m_rateLimited && !m_active.isEmpty()
+           && m_probes.size() + batch.size() < m_globalLimit) {
+        queued = false;
+
+        for (int n = 0; n < m_active.size() && m_probes.size() + batch.size() < m_globalLimit; ++n) {
+            HostJob* job = m_active[(m_roundRobin + n) % m_active.size()];
+
+            bool hasWork = !job->retries.isEmpty() || job->next < job->ports.size();
+            if (!hasWork || job->inFlight >= m_perHostLimit) {
+                continue;
+            }
+
+            if (job->nextSendMs > now) {
+                if (m_nextPacedMs < 0 || job->nextSendMs < m_nextPacedMs) {
+                    m_nextPacedMs = job->nextSendMs;
+                }
+                continue;
+            }
+
+            Outgoing outgoing;
+            outgoing.job = job;
+            if (!job->retries.isEmpty()) {
+                outgoing.port = job->retries.first().port;
+                outgoing.attempt = job->retries.first().attempt;
+            } else {
+                outgoing.port = job->ports[job->next];
+                outgoing.attempt = 0;
+            }
+
+            // The same host may be queued twice; wait for the earlier probe of this port
+            if (m_probes.contains(probeKey(job->address, outgoing.port))) {
+                continue;
+            }
+
+            if (!RateController::instance()->tryAcquire()) {
+                m_rateLimited = true;
+                break;
+            }
+
+            if (outgoing.attempt > 0) {
+                job->retries.removeFirst();
+            } else {
+                job->next++;
+            }
+            job->inFlight++;
+            job->nextSendMs = now + job->intervalMs;
+
+            batch.append(outgoing);
+            queued = true;
+
+            if (batch.size() == SEND_BATCH) {
+                sendBatch(batch);
+                batch.clear();
+                if (m_clock.elapsed() < m_pausedUntilMs) {
+                    return;
+                }
+            }
+        }
+
+        m_roundRobin = (m_roundRobin + 1) % qMax(1, static_cast<int>(m_active.size()));
+    }
+
+    sendBatch(batch);
+}
+
+void UdpScanEngine::sendBatch(QVector<Outgoing>& batch)
+{
+#ifdef Q_OS_LINUX
+    if (batch.isEmpty()) {
+        return;
+    }
+
+    mmsghdr messages[SEND_BATCH];
+    sockaddr_in addresses[SEND_BATCH];
+    iovec vectors[SEND_BATCH];
+    QByteArray payloads[SEND_BATCH];
+
+    int count = static_cast<int>(batch.size());
+    std::memset(messages, 0, sizeof(mmsghdr) * count);
+
+    for (int i = 0; i < count; ++i) {
+        payloads[i] = payloadFor(batch[i].port);
+
+        std::memset(&addresses[i], 0, sizeof(sockaddr_in));
+        addresses[i].sin_family = AF_INET;
+        addresses[i].sin_port = htons(batch[i].port);
+        addresses[i].sin_addr.s_addr = htonl(batch[i].job->address);
+
+        vectors[i].iov_base = const_cast<char*>(payloads[i].constData());
+        vectors[i].iov_len = static_cast<size_t>(payloads[i].size());
+
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    qint64 startNs = m_clock.nsecsElapsed();
+    qint64 deadlineBase = m_clock.elapsed();
+    int sent = 0;
+    bool drained = false;   // Error queue drained for the datagram at `sent`
+
+    while (sent < count) {
+        int result = ::sendmmsg(m_socketFd, messages + sent, static_cast<unsigned int>(count - sent), 0);
+
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                // Local send queue full - slow the shared probe rate and resend the rest later
+                RateController::instance()->reportCongestion();
+                m_pausedUntilMs = m_clock.elapsed() + CONGESTION_PAUSE_MS;
+                for (int i = sent; i < count; ++i) {
+                    requeue(batch[i]);
+                }
+                return;
+            }
+
+            // With IP_RECVERR an ICMP error for an earlier probe fails the next send.
+            // Drain the error queue (which classifies that probe), then resend.
+            int error = errno;
+            bool routeError = error == EHOSTUNREACH || error == ENETUNREACH || error == EHOSTDOWN;
+            if ((routeError || error == ECONNREFUSED) && !drained) {
+                receiveErrors();
+                drained = true;
+                continue;
+            }
+
+            drained = false;
+            const Outgoing& failed = batch[sent];
+            if (error == ECONNREFUSED) {
+                // Never this datagram's own failure: another probe's error arrived meanwhile
+                requeue(failed);
+            } else {
+                // Its own send failed (no route, host known unreachable, blocked locally)
+                failed.job->inFlight--;
+                report(failed.job, failed.port, Filtered, startNs, failed.attempt);
+            }
+            sent++;
+            continue;
+        }
+
+        drained = false;
+
+        for (int i = sent; i < sent + result; ++i) {
+            Probe probe;
+            probe.job = batch[i].job;
+            probe.port = batch[i].port;
+            probe.attempt = batch[i].attempt;
+            probe.startNs = startNs;
+            probe.deadlineMs = deadlineBase + probe.job->timeoutMs;
+
+            quint64 key = probeKey(probe.job->address, probe.port);
+            m_probes.insert(key, probe);
+            m_deadlines.insert(probe.deadlineMs, key);
+        }
+        sent += result;
+    }
+#else
+    Q_UNUSED(batch);
+#endif
+}
+
+void UdpScanEngine::requeue(const Outgoing& outgoing)
+{
+    Retry retry;
+    retry.port = outgoing.port;
+    retry.attempt = outgoing.attempt;
+
+    outgoing.job->inFlight--;
+    outgoing.job->retries.prepend(retry);
+}
+
+void UdpScanEngine::receiveReplies()
+{
+#ifdef Q_OS_LINUX
+    mmsghdr messages[RECEIVE_BATCH];
+    sockaddr_in addresses[RECEIVE_BATCH];
+    iovec vectors[RECEIVE_BATCH];
+    static thread_local char buffers[RECEIVE_BATCH][RECEIVE_BUFFER];
+
+    // A pending socket error (set alongside the error queue) fails one call; retry a few times
+    for (int attempts = 0; attempts < 4;) {
+        std::memset(messages, 0, sizeof(messages));
+        for (int i = 0; i < RECEIVE_BATCH; ++i) {
+            vectors[i].iov_base = buffers[i];
+            vectors[i].iov_len = RECEIVE_BUFFER;
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int count = ::recvmmsg(m_socketFd, messages, RECEIVE_BATCH, MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            attempts++;
+            continue;
+        }
+        if (count == 0) {
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (messages[i].msg_hdr.msg_namelen < sizeof(sockaddr_in) || addresses[i].sin_family != AF_INET) {
+                continue;
+            }
+            int length = qMin(static_cast<int>(messages[i].msg_len), RECEIVE_BUFFER);
+            handleReply(ntohl(addresses[i].sin_addr.s_addr), ntohs(addresses[i].sin_port),
+                        buffers[i], length);
+        }
+
+        if (count < RECEIVE_BATCH) {
+            return;
+        }
+    }
+#endif
+}
+
+void UdpScanEngine::receiveErrors()
+{
+#ifdef Q_OS_LINUX
+    char control[512];
+    char data[64];
+
+    while (true) {
+        sockaddr_in offender;
+        iovec vector;
+        vector.iov_base = data;
+        vector.iov_len = sizeof(data);
+
+        msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_name = &offender;
+        message.msg_namelen = sizeof(offender);
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        if (::recvmsg(m_socketFd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            return;
+        }
+
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level != IPPROTO_IP || header->cmsg_type != IP_RECVERR) {
+                continue;
+            }
+
+            const sock_extended_err* error = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(header));
+            if (error->ee_origin != SO_EE_ORIGIN_ICMP || error->ee_type != ICMP_DEST_UNREACH) {
+                continue;
+            }
+
+            // msg_name holds the destination of the datagram that triggered the error
+            handleUnreachable(ntohl(offender.sin_addr.s_addr), ntohs(offender.sin_port), error->ee_code);
+        }
+    }
+#endif
+}
+
+void UdpScanEngine::handleReply(quint32 address, quint16 port, const char* data, int length)
+{
+    quint64 key = probeKey(address, port);
+
+    if (!m_probes.contains(key)) {
+        // SSDP devices often answer M-SEARCH from an ephemeral port
+        quint64 ssdpKey = probeKey(address, SSDP_PORT);
+        if (m_probes.contains(ssdpKey) && length >= 8 && std::memcmp(data, "HTTP/1.", 7) == 0) {
+            key = ssdpKey;
+        } else {
+            return;
+        }
+    }
+
+    RateController::instance()->reportResponse();
+    finishProbe(key, Open, QByteArray(data, qMin(length, MAX_RESPONSE_BYTES)));
+}
+
+void UdpScanEngine::handleUnreachable(quint32 address, quint16 port, int code)
+{
+    quint64 key = probeKey(address, port);
+    auto it = m_probes.find(key);
+    if (it == m_probes.end()) {
+        return;
+    }
+
+    PortState state;
+    switch (code) {
+        case 3:     // Port unreachable
+            it->job->unreachables++;
+            state = Closed;
+            break;
+        case 0:     // Network unreachable
+        case 1:     // Host unreachable
+        case 2:     // Protocol unreachable
+        case 9:     // Network administratively prohibited
+        case 10:    // Host administratively prohibited
+        case 13:    // Communication administratively prohibited
+            state = Filtered;
+            break;
+        default:
+            return;
+    }
+
+    RateController::instance()->reportResponse();
+    finishProbe(key, state);
+}
+
+void UdpScanEngine::finishProbe(quint64 key, PortState state, const QByteArray& response)
+{
+    auto it = m_probes.find(key);
+    if (it == m_probes.end()) {
+        return;
+    }
+
+    Probe probe = it.value();
+    m_probes.erase(it);
+    m_deadlines.remove(probe.deadlineMs, key);
+
+    probe.job->inFlight--;
+    report(probe.job, probe.port, state, probe.startNs, probe.attempt, response);
+}
+
+void UdpScanEngine::report(HostJob* job, quint16 port, PortState state, qint64 startNs, int attempt,
+                           const QByteArray& response)
+{
+    job->completed++;
+    double responseTime = (m_clock.nsecsElapsed() - startNs) / 1000000.0;
+
+    // Replies and ICMP errors both measure a round trip; skip retransmissions (ambiguous)
+    if ((state == Open || state == Closed) && attempt == 0) {
+        RttEstimator::instance()->addSample(job->address, responseTime);
+    }
+
+    if (m_resultCallback) {
+        ProbeResult result;
+        result.address = job->address;
+        result.port = port;
+        result.state = state;
+        result.responseTime = responseTime;
+        result.response = response;
+        m_resultCallback(result);
+    }
+}
+
+void UdpScanEngine::expireDeadlines()
+{
+    qint64 now = m_clock.elapsed();
+
+    while (!m_deadlines.isEmpty() && m_deadlines.firstKey() <= now) {
+        quint64 key = m_deadlines.first();
+        m_deadlines.erase(m_deadlines.begin());
+
+        Probe probe = m_probes.take(key);
+        HostJob* job = probe.job;
+        job->inFlight--;
+
+        // A host that sends port unreachables went quiet: its ICMP budget is spent
+        if (job->unreachables > 0) {
+            backoff(job, now);
+        }
+
+        if (probe.attempt < m_maxRetries) {
+            Retry retry;
+            retry.port = probe.port;
+            retry.attempt = probe.attempt + 1;
+            job->retries.append(retry);
+        } else {
+            report(job, probe.port, OpenFiltered, probe.startNs, probe.attempt);
+        }
+    }
+}
+
+void UdpScanEngine::backoff(HostJob* job, qint64 now)
+{
+    // At most one increase per timeout window: one burst of drops is one signal
+    if (job->lastBackoffMs != 0 && now - job->lastBackoffMs < job->timeoutMs) {
+        return;
+    }
+
+    int interval = qBound(MIN_BACKOFF_INTERVAL_MS, job->intervalMs * 2, MAX_HOST_INTERVAL_MS);
+    if (interval != job->intervalMs) {
+        job->intervalMs = interval;
+        Logger::debug(QString("UdpScanEngine: ICMP rate limiting suspected on %1.%2.%3.%4, send interval now %5 ms")
+                     .arg(job->address >> 24).arg((job->address >> 16) & 0xFF)
+                     .arg((job->address >> 8) & 0xFF).arg(job->address & 0xFF)
+                     .arg(interval));
+    }
+    job->lastBackoffMs = now;
+}
+
+void UdpScanEngine::reapCompletedHosts()
+{
+    for (int i = m_active.size() - 1; i >= 0; --i) {
+        HostJob* job = m_active[i];
+        if (job->completed >= job->ports.size()) {
+            m_active.removeAt(i);
+            quint32 address = job->address;
+            delete job;
+
+            if (m_hostCallback) {
+                m_hostCallback(address);
+            }
+        }
+    }
+}
+
+void UdpScanEngine::abortAll()
+{
+    m_probes.clear();
+    m_deadlines.clear();
+
+    qDeleteAll(m_active);
+    m_active.clear();
+
+    QMutexLocker locker(&m_queueMutex);
+    qDeleteAll(m_incoming);
+    m_incoming.clear();
+}
+
+int UdpScanEngine::nextWaitMs() const
+{
+    int wait = IDLE_WAIT_MS;
+    qint64 now = m_clock.elapsed();
+
+    if (!m_deadlines.isEmpty()) {
+        wait = static_cast<int>(qBound<qint64>(0, m_deadlines.firstKey() - now, wait));
+    }
+
+    // Wake up for the next paced host slot or the end of a send-queue pause
+    if (m_nextPacedMs >= 0) {
+        wait = static_cast<int>(qBound<qint64>(0, m_nextPacedMs - now, wait));
+    }
+    if (m_pausedUntilMs > now) {
+        wait = static_cast<int>(qBound<qint64>(0, m_pausedUntilMs - now, wait));
+    }
+
+    if (m_rateLimited) {
+        wait = qMin(wait, qMax(1, RateController::instance()->waitTimeMs()));
+    }
+
+    return wait;
+}
+
+void UdpScanEngine::wake()
+{
+#ifdef Q_OS_LINUX
+    if (m_wakeFd >= 0) {
+        quint64 value = 1;
+        ssize_t written = ::write(m_wakeFd, &value, sizeof(value));
+        Q_UNUSED(written);
+    }
+#endif
+}
@@ -0,0 +1,220 @@
+#ifndef UDPSCANENGINE_H
+#define UDPSCANENGINE_H
+
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QMultiMap>
+#include <QMutex>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <functional>
+#include <atomic>
+
+/**
+ * @brief Event-driven UDP port scanner with protocol-aware probes
+ *
+ * Sends one datagram per port from a single unconnected socket, batched
+ * with sendmmsg(). Well-known services get a payload that elicits a reply
+ * (DNS, NTP, SNMP, mDNS, SSDP, NetBIOS, see payloadFor()); other ports get
+ * an empty datagram. Ports are classified from what comes back:
+ * a reply = open, ICMP port unreachable (read from the socket error queue
+ * with IP_RECVERR) = closed, other ICMP unreachables = filtered, and no
+ * answer after the retries = open|filtered.
+ *
+ * Most hosts rate-limit ICMP errors (Linux: a small burst, then about one
+ * per second), so a silent port on a host that has already sent port
+ * unreachables is more likely throttled than open. Each host therefore
+ * has its own send interval, doubled when such a host starts timing out,
+ * while hosts are served round-robin so a subnet keeps the global rate.
+ * Timeouts are not reported to the shared RateController: silence is the
+ * normal answer for UDP and says nothing about path congestion.
+ *
+ * run() executes on the calling thread and invokes the callbacks there.
+ * addHost() and cancel() are thread-safe. Linux only; isSupported()
+ * returns false elsewhere.
+ */
+class UdpScanEngine
+{
+public:
+    enum PortState {
+        Open,
+        Closed,
+        Filtered,
+        OpenFiltered
+    };
+
+    struct ProbeResult {
+        quint32 address;        ///< Target IPv4 address (host byte order)
+        quint16 port;           ///< Probed port
+        PortState state;        ///< Classification
+        double responseTime;    ///< Time from the last attempt to classification in milliseconds
+        QByteArray response;    ///< Start of the reply payload (open ports only)
+
+        ProbeResult()
+            : address(0), port(0), state(OpenFiltered), responseTime(0.0) {}
+    };
+
+    using ResultCallback = std::function<void(const ProbeResult&)>;
+    using HostCallback = std::function<void(quint32 address)>;
+
+    static constexpr int DEFAULT_GLOBAL_LIMIT = 1024;
+    static constexpr int DEFAULT_PER_HOST_LIMIT = 32;
+    static constexpr int DEFAULT_MAX_RETRIES = 1;
+    static constexpr int MAX_RESPONSE_BYTES = 512;
+
+    explicit UdpScanEngine(int globalLimit = DEFAULT_GLOBAL_LIMIT,
+                           int perHostLimit = DEFAULT_PER_HOST_LIMIT);
+    ~UdpScanEngine();
+
+    UdpScanEngine(const UdpScanEngine&) = delete;
+    UdpScanEngine& operator=(const UdpScanEngine&) = delete;
+
+    /**
+     * @brief Check whether the engine can run on this platform
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Probe datagram for a port, empty for ports without a known payload
+     */
+    static QByteArray payloadFor(quint16 port);
+
+    void setResultCallback(ResultCallback callback);
+    void setHostCompletedCallback(HostCallback callback);
+
+    /**
+     * @brief Set concurrency caps (applies to probes sent afterwards)
+     */
+    void setLimits(int globalLimit, int perHostLimit);
+    int globalLimit() const { return m_globalLimit; }
+    int perHostLimit() const { return m_perHostLimit; }
+
+    /**
+     * @brief Retransmissions before a silent port is reported open|filtered
+     */
+    void setMaxRetries(int retries);
+    int maxRetries() const { return m_maxRetries; }
+
+    /**
+     * @brief Queue a host for scanning
+     * @param address Target IPv4 address (host byte order)
+     * @param ports Ports to probe (duplicates are ignored)
+     * @param timeoutMs Per-attempt deadline in milliseconds
+     */
+    void addHost(quint32 address, const QVector<quint16>& ports, int timeoutMs);
+
+    /**
+     * @brief Probe all queued hosts; returns when they are done or on cancel()
+     */
+    void run();
+
+    /**
+     * @brief Abort run(); outstanding probes are dropped without callbacks
+     */
+    void cancel();
+
+    /**
+     * @brief Clear a previous cancel() so the engine can be reused
+     */
+    void reset();
+
+    bool isCancelled() const { return m_cancelled.load(); }
+
+    /**
+     * @brief Number of hosts added but not yet picked up by run()
+     */
+    int queuedHosts() const;
+
+private:
+    struct Retry {
+        quint16 port;
+        int attempt;
+    };
+
+    struct HostJob {
+        quint32 address;
+        QVector<quint16> ports;
+        int timeoutMs;
+        int next;
+        int inFlight;
+        int completed;
+        QList<Retry> retries;       ///< Timed-out ports waiting to be resent
+        int intervalMs;             ///< Minimum gap between datagrams to this host
+        qint64 nextSendMs;
+        qint64 lastBackoffMs;
+        int unreachables;           ///< ICMP port unreachables received from this host
+    };
+
+    struct Probe {
+        HostJob* job;
+        quint16 port;
+        int attempt;
+        qint64 startNs;
+        qint64 deadlineMs;
+    };
+
+    struct Outgoing {
+        HostJob* job;
+        quint16 port;
+        int attempt;
+    };
+
+    static constexpr int SEND_BATCH = 64;
+    static constexpr int RECEIVE_BATCH = 32;
+    static constexpr int RECEIVE_BUFFER = 2048;
+    static constexpr int MAX_EVENTS = 16;
+    static constexpr int IDLE_WAIT_MS = 50;
+    static constexpr int MIN_BACKOFF_INTERVAL_MS = 50;
+    static constexpr int MAX_HOST_INTERVAL_MS = 1000;
+    static constexpr int CONGESTION_PAUSE_MS = 10;
+
+    int m_globalLimit;
+    int m_perHostLimit;
+    int m_maxRetries;
+
+    int m_socketFd;
+    int m_epollFd;
+    int m_wakeFd;
+    std::atomic<bool> m_cancelled;
+
+    mutable QMutex m_queueMutex;
+    QList<HostJob*> m_incoming;
+
+    QList<HostJob*> m_active;
+    int m_roundRobin;
+    bool m_rateLimited;                         ///< fill() stopped for lack of rate tokens
+    qint64 m_nextPacedMs;                       ///< Earliest host send slot fill() waited for, -1 if none
+    qint64 m_pausedUntilMs;                     ///< Send queue was full; resume after this
+    QHash<quint64, Probe> m_probes;             ///< (address << 16 | port) -> probe
+    QMultiMap<qint64, quint64> m_deadlines;     ///< Deadline -> probe key
+    QElapsedTimer m_clock;
+
+    ResultCallback m_resultCallback;
+    HostCallback m_hostCallback;
+
+    static quint64 probeKey(quint32 address, quint16 port)
+    {
+        return (static_cast<quint64>(address) << 16) | port;
+    }
+
+    void takeIncoming();
+    void fill();
+    void sendBatch(QVector<Outgoing>& batch);
+    void requeue(const Outgoing& outgoing);
+    void receiveReplies();
+    void receiveErrors();
+    void handleReply(quint32 address, quint16 port, const char* data, int length);
+    void handleUnreachable(quint32 address, quint16 port, int code);
+    void finishProbe(quint64 key, PortState state, const QByteArray& response = QByteArray());
+    void report(HostJob* job, quint16 port, PortState state, qint64 startNs, int attempt,
+                const QByteArray& response = QByteArray());
+    void expireDeadlines();
+    void backoff(HostJob* job, qint64 now);
+    void reapCompletedHosts();
+    void abortAll();
+    int nextWaitMs() const;
+    void wake();
+};
+
+#endif // UDPSCANENGINE_H
@@ -34,7 +34,8 @@ bool HistoryService::initialize()
     return true;
 }
 
-bool HistoryService::saveMetrics(const QString& deviceId, const NetworkMetrics& metrics)
+bool HistoryService::saveMetrics(const QString& deviceId, const NetworkMetrics& metrics,
+                                 const LatencyHistogram& histogram)
 {
     if (!m_dbManager || !m_dbManager->isOpen()) {
         Logger::error("HistoryService: Cannot save metrics, database not open");
@@ -43,8 +44,8 @@ bool HistoryService::saveMetrics(const QString& deviceId, const NetworkMetrics&
 
     QString query = "INSERT INTO metrics_history "
                    "(device_id, timestamp, latency_avg, latency_min, latency_max, "
-                   "latency_median, jitter, packet_loss, quality_score) "
-                   "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)";
+                   "latency_median, jitter, packet_loss, quality_score, latency_histogram) "
+                   "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
 
     QSqlQuery sqlQuery = m_dbManager->prepareQuery(query);
     sqlQuery.addBindValue(deviceId);
@@ -56,6 +57,7 @@ bool HistoryService::saveMetrics(const QString& deviceId, const NetworkMetrics&
     sqlQuery.addBindValue(metrics.getJitter());
     sqlQuery.addBindValue(metrics.getPacketLoss());
     sqlQuery.addBindValue(static_cast<int>(metrics.getQualityScore()));
+    sqlQuery.addBindValue(histogram.isEmpty() ? QVariant() : QVariant(histogram.toBlob()));
 
     if (!sqlQuery.exec()) {
         Logger::error("Failed to save metrics: " + sqlQuery.lastError().text());
@@ -160,6 +162,48 @@ QList<NetworkMetrics> HistoryService::getAllMetricsForDevice(const QString& devi
     return metricsList;
 }
 
+LatencyHistogram HistoryService::getLatencyHistogram(const QString& deviceId,
+                                                     const QDateTime& start,
+                                                     const QDateTime& end)
+{
+    LatencyHistogram histogram;
+
+    if (!m_dbManager || !m_dbManager->isOpen()) {
+        Logger::error("HistoryService: Cannot get latency histogram, database not open");
+        return histogram;
+    }
+
+    QString query = "SELECT latency_histogram FROM metrics_history "
+                   "WHERE device_id = ? AND timestamp >= ? AND timestamp <= ? "
+                   "AND latency_histogram IS NOT NULL";
+
+    QSqlQuery sqlQuery = m_dbManager->prepareQuery(query);
+    sqlQuery.addBindValue(deviceId);
+    sqlQuery.addBindValue(start.toString(Qt::ISODate));
+    sqlQuery.addBindValue(end.toString(Qt::ISODate));
+
+    if (!sqlQuery.exec()) {
+        Logger::error("Failed to get latency histogram: " + sqlQuery.lastError().text());
+        return histogram;
+    }
+
+    int malformed = 0;
+    while (sqlQuery.next()) {
+        bool ok = false;
+        histogram.merge(LatencyHistogram::fromBlob(sqlQuery.value(0).toByteArray(), &ok));
+        if (!ok) {
+            malformed++;
+        }
+    }
+
+    if (malformed > 0) {
+        Logger::warn(QString("HistoryService: Skipped %1 malformed latency histograms for %2")
+                     .arg(malformed).arg(deviceId));
+    }
+
+    return histogram;
+}
+
 QList<HistoryEvent> HistoryService::getEventHistory(const QString& deviceId,
                                                      const QDateTime& start,
                                                      const QDateTime& end)
@@ -384,7 +428,8 @@ bool HistoryService::createMetricsHistoryTable()
             latency_median REAL,
             jitter REAL,
             packet_loss REAL,
-            quality_score INTEGER
+            quality_score INTEGER,
+            latency_histogram BLOB
         )
     )";
 
@@ -393,6 +438,12 @@ bool HistoryService::createMetricsHistoryTable()
         return false;
     }
 
+    // Tables created before latency histograms were stored lack the column
+    if (!m_dbManager->addColumnIfMissing("metrics_history", "latency_histogram", "BLOB")) {
+        Logger::error("Failed to migrate metrics_history table: " + m_dbManager->getLastError());
+        return false;
+    }
+
     Logger::debug("metrics_history table created or already exists");
     return true;
 }
@@ -340,7 +340,14 @@ void MonitoringService::storeMetrics(const QString& deviceId, const NetworkMetri
         return;
     }
 
-    if (!m_historyService->saveMetrics(deviceId, metrics)) {
+    // Each row carries the latencies since the previous one, so the rows of
+    // any time range merge into that range's distribution
+    LatencyHistogram histogram;
+    if (m_metricsController) {
+        histogram = m_metricsController->takeLatencyHistogram(deviceId);
+    }
+
+    if (!m_historyService->saveMetrics(deviceId, metrics, histogram)) {
         Logger::error(QString("MonitoringService: Failed to save metrics for device %1")
                      .arg(deviceId));
     }
@@ -0,0 +1,241 @@
+#include "LatencyHistogram.h"
+#include <QtAlgorithms>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// LEB128: seven bits per byte, high bit set on all but the last
+void writeVarint(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+bool readVarint(const QByteArray& in, int& pos, quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        quint8 byte = static_cast<quint8>(in.at(pos++));
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram()
+{
+    clear();
+}
+
+void LatencyHistogram::record(double latencyMs, quint64 count)
+{
+    if (!(latencyMs >= 0.0) || count == 0) {
+        return;  // Negative or NaN
+    }
+
+    quint64 valueUs = qMin(static_cast<quint64>(std::llround(qMin(latencyMs * 1000.0, 1e18))),
+                           MAX_VALUE_US);
+    m_counts[bucketIndex(valueUs)] += count;
+    m_minUs = m_total == 0 ? valueUs : qMin(m_minUs, valueUs);
+    m_maxUs = m_total == 0 ? valueUs : qMax(m_maxUs, valueUs);
+    m_total += count;
+    m_sumUs += valueUs * count;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    if (other.m_total == 0) {
+        return;
+    }
+
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_minUs = m_total == 0 ? other.m_minUs : qMin(m_minUs, other.m_minUs);
+    m_maxUs = m_total == 0 ? other.m_maxUs : qMax(m_maxUs, other.m_maxUs);
+    m_total += other.m_total;
+    m_sumUs += other.m_sumUs;
+}
+
+void LatencyHistogram::clear()
+{
+    std::memset(m_counts, 0, sizeof(m_counts));
+    m_total = 0;
+    m_minUs = 0;
+    m_maxUs = 0;
+    m_sumUs = 0;
+}
+
+bool LatencyHistogram::isEmpty() const
+{
+    return m_total == 0;
+}
+
+quint64 LatencyHistogram::totalCount() const
+{
+    return m_total;
+}
+
+double LatencyHistogram::min() const
+{
+    return m_minUs / 1000.0;
+}
+
+double LatencyHistogram::max() const
+{
+    return m_maxUs / 1000.0;
+}
+
+double LatencyHistogram::mean() const
+{
+    return m_total == 0 ? 0.0 : m_sumUs / 1000.0 / m_total;
+}
+
+double LatencyHistogram::percentile(double percentile) const
+{
+    if (m_total == 0) {
+        return 0.0;
+    }
+
+    // Nearest rank; the extremes are known exactly
+    quint64 rank = static_cast<quint64>(std::ceil(qBound(0.0, percentile, 100.0) / 100.0 * m_total));
+    if (rank <= 1) {
+        return min();
+    }
+    if (rank >= m_total) {
+        return max();
+    }
+
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_counts[i];
+        if (seen >= rank) {
+            double midpointUs = bucketLower(i) + (bucketWidth(i) - 1) / 2.0;
+            return qBound(m_minUs / 1.0, midpointUs, m_maxUs / 1.0) / 1000.0;
+        }
+    }
+    return max();
+}
+
+QVector<LatencyHistogram::Bucket> LatencyHistogram::buckets() const
+{
+    QVector<Bucket> result;
+    for (int i = 0; i < BUCKET_COUNT && m_total > 0; ++i) {
+        if (m_counts[i] > 0) {
+            quint64 lower = bucketLower(i);
+            result.append(Bucket{lower / 1000.0, (lower + bucketWidth(i)) / 1000.0, m_counts[i]});
+        }
+    }
+    return result;
+}
+
+QByteArray LatencyHistogram::toBlob() const
+{
+    QByteArray blob;
+    if (m_total == 0) {
+        return blob;
+    }
+
+    // Version, min, max, sum, then (index gap, count) per non-empty bucket
+    blob.append(static_cast<char>(BLOB_VERSION));
+    writeVarint(blob, m_minUs);
+    writeVarint(blob, m_maxUs);
+    writeVarint(blob, m_sumUs);
+
+    int previous = -1;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        if (m_counts[i] > 0) {
+            writeVarint(blob, static_cast<quint64>(i - previous));
+            writeVarint(blob, m_counts[i]);
+            previous = i;
+        }
+    }
+    return blob;
+}
+
+LatencyHistogram LatencyHistogram::fromBlob(const QByteArray& blob, bool* ok)
+{
+    LatencyHistogram histogram;
+    if (ok) {
+        *ok = true;
+    }
+    if (blob.isEmpty()) {
+        return histogram;
+    }
+
+    int pos = 1;
+    quint64 minUs = 0;
+    quint64 maxUs = 0;
+    quint64 sumUs = 0;
+    bool valid = static_cast<quint8>(blob.at(0)) == BLOB_VERSION &&
+                 readVarint(blob, pos, minUs) &&
+                 readVarint(blob, pos, maxUs) &&
+                 readVarint(blob, pos, sumUs) &&
+                 minUs <= maxUs && maxUs <= MAX_VALUE_US;
+
+    int index = -1;
+    while (valid && pos < blob.size()) {
+        quint64 gap = 0;
+        quint64 count = 0;
+        valid = readVarint(blob, pos, gap) && readVarint(blob, pos, count) &&
+                gap > 0 && gap < static_cast<quint64>(BUCKET_COUNT - index) &&
+                count > 0 && count <= ~quint64(0) - histogram.m_total;
+        if (valid) {
+            index += static_cast<int>(gap);
+            histogram.m_counts[index] = count;
+            histogram.m_total += count;
+        }
+    }
+
+    if (!valid || histogram.m_total == 0) {
+        histogram.clear();
+        if (ok) {
+            *ok = false;
+        }
+        return histogram;
+    }
+
+    histogram.m_minUs = minUs;
+    histogram.m_maxUs = maxUs;
+    histogram.m_sumUs = sumUs;
+    return histogram;
+}
+
+int LatencyHistogram::bucketIndex(quint64 valueUs)
+{
+    if (valueUs < static_cast<quint64>(SUB_BUCKET_COUNT)) {
+        return static_cast<int>(valueUs);
+    }
+
+    // Keep the top SUB_BUCKET_BITS bits; the shift picks the power of two
+    int msb = 63 - qCountLeadingZeroBits(valueUs);
+    int shift = msb - (SUB_BUCKET_BITS - 1);
+    return SUB_BUCKET_HALF * shift + static_cast<int>(valueUs >> shift);
+}
+
+quint64 LatencyHistogram::bucketLower(int index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return static_cast<quint64>(index);
+    }
+
+    int shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF + 1;
+    quint64 subBucket = static_cast<quint64>(index - SUB_BUCKET_HALF * shift);
+    return subBucket << shift;
+}
+
+quint64 LatencyHistogram::bucketWidth(int index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return 1;
+    }
+    return quint64(1) << ((index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF + 1);
+}
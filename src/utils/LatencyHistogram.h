@@ -0,0 +1,100 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief Fixed-memory log-linear latency histogram (HDR style)
+ *
+ * Latencies are recorded in microseconds. Below SUB_BUCKET_COUNT µs every
+ * value has its own bucket; above, each power of two is split into
+ * SUB_BUCKET_HALF equal buckets, so a bucket is never wider than 1/32 of
+ * its values and percentiles are within about 1.6% from 1 µs up to
+ * MAX_VALUE_US (larger values land in the last bucket).
+ *
+ * Histograms with the same layout merge by adding bucket counts, which
+ * makes percentiles over several time windows or devices exact to the
+ * bucket resolution without the raw samples. toBlob() stores only the
+ * non-empty buckets, typically a few dozen bytes.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int SUB_BUCKET_BITS = 6;
+    static constexpr int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr int SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr int MAGNITUDE_BITS = 26;                      ///< Tracks up to ~67 s
+    static constexpr quint64 MAX_VALUE_US = (quint64(1) << MAGNITUDE_BITS) - 1;
+    static constexpr int BUCKET_COUNT =
+        (MAGNITUDE_BITS - SUB_BUCKET_BITS) * SUB_BUCKET_HALF + SUB_BUCKET_COUNT;
+
+    struct Bucket {
+        double lowerMs;     ///< Smallest latency in the bucket
+        double upperMs;     ///< Smallest latency of the next bucket
+        quint64 count;
+    };
+
+    LatencyHistogram();
+
+    /**
+     * @brief Record a latency
+     * @param latencyMs Latency in milliseconds; negative values are ignored
+     * @param count Number of samples with this latency
+     */
+    void record(double latencyMs, quint64 count = 1);
+
+    /**
+     * @brief Add the samples of another histogram to this one
+     */
+    void merge(const LatencyHistogram& other);
+
+    void clear();
+
+    bool isEmpty() const;
+    quint64 totalCount() const;
+
+    double min() const;     ///< Exact to 1 µs, 0 if empty
+    double max() const;     ///< Exact to 1 µs, 0 if empty
+    double mean() const;    ///< Exact to 1 µs, 0 if empty
+
+    /**
+     * @brief Latency at or below which @p percentile percent of the samples fall
+     * @param percentile Percentile in [0, 100]
+     * @return Latency in milliseconds (bucket midpoint, clamped to min/max), 0 if empty
+     */
+    double percentile(double percentile) const;
+
+    /**
+     * @brief Non-empty buckets, lowest first
+     */
+    QVector<Bucket> buckets() const;
+
+    /**
+     * @brief Compact serialization of the non-empty buckets
+     * @return Empty array for an empty histogram
+     */
+    QByteArray toBlob() const;
+
+    /**
+     * @brief Rebuild a histogram from toBlob() output
+     * @param ok Set to false if the blob is malformed (the result is then empty)
+     */
+    static LatencyHistogram fromBlob(const QByteArray& blob, bool* ok = nullptr);
+
+private:
+    static constexpr quint8 BLOB_VERSION = 1;
+
+    quint64 m_counts[BUCKET_COUNT];    ///< 64-bit: long-lived merged histograms pass 2^32
+    quint64 m_total;
+    quint64 m_minUs;
+    quint64 m_maxUs;
+    quint64 m_sumUs;
+
+    static int bucketIndex(quint64 valueUs);
+    static quint64 bucketLower(int index);
+    static quint64 bucketWidth(int index);
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,237 @@
+#include "StreamingStatistics.h"
+#include <algorithm>
+#include <cmath>
+
+// RunningStats
+
+RunningStats::RunningStats()
+    : m_count(0), m_mean(0.0), m_m2(0.0)
+{
+}
+
+void RunningStats::add(double value)
+{
+    ++m_count;
+    double delta = value - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (value - m_mean);
+}
+
+void RunningStats::remove(double value)
+{
+    if (m_count <= 1) {
+        clear();
+        return;
+    }
+
+    // Welford's update run backwards
+    --m_count;
+    double delta = value - m_mean;
+    m_mean -= delta / m_count;
+    m_m2 -= delta * (value - m_mean);
+    if (m_m2 < 0.0) {
+        m_m2 = 0.0;  // Rounding
+    }
+}
+
+void RunningStats::clear()
+{
+    m_count = 0;
+    m_mean = 0.0;
+    m_m2 = 0.0;
+}
+
+qint64 RunningStats::count() const
+{
+    return m_count;
+}
+
+double RunningStats::mean() const
+{
+    return m_mean;
+}
+
+double RunningStats::variance() const
+{
+    return m_count > 1 ? m_m2 / (m_count - 1) : 0.0;
+}
+
+double RunningStats::stdDev() const
+{
+    return std::sqrt(variance());
+}
+
+// P2Quantile
+
+P2Quantile::P2Quantile(double quantile)
+    : m_quantile(qBound(0.0, quantile, 1.0))
+    , m_count(0)
+{
+    clear();
+}
+
+void P2Quantile::clear()
+{
+    m_count = 0;
+    for (int i = 0; i < MARKERS; ++i) {
+        m_heights[i] = 0.0;
+        m_positions[i] = i + 1;
+    }
+
+    const double p = m_quantile;
+    m_desired[0] = 1.0;
+    m_desired[1] = 1.0 + 2.0 * p;
+    m_desired[2] = 1.0 + 4.0 * p;
+    m_desired[3] = 3.0 + 2.0 * p;
+    m_desired[4] = 5.0;
+
+    m_increments[0] = 0.0;
+    m_increments[1] = p / 2.0;
+    m_increments[2] = p;
+    m_increments[3] = (1.0 + p) / 2.0;
+    m_increments[4] = 1.0;
+}
+
+void P2Quantile::add(double value)
+{
+    if (m_count < MARKERS) {
+        m_heights[m_count++] = value;
+        if (m_count == MARKERS) {
+            std::sort(m_heights, m_heights + MARKERS);
+        }
+        return;
+    }
+    ++m_count;
+
+    // Cell holding the value; extremes widen the outer markers
+    int cell;
+    if (value < m_heights[0]) {
+        m_heights[0] = value;
+        cell = 0;
+    } else if (value >= m_heights[MARKERS - 1]) {
+        m_heights[MARKERS - 1] = value;
+        cell = MARKERS - 2;
+    } else {
+        cell = 0;
+        while (cell < MARKERS - 2 && value >= m_heights[cell + 1]) {
+            ++cell;
+        }
+    }
+
+    for (int i = cell + 1; i < MARKERS; ++i) {
+        m_positions[i] += 1.0;
+    }
+    for (int i = 0; i < MARKERS; ++i) {
+        m_desired[i] += m_increments[i];
+    }
+
+    // Move the inner markers towards their desired positions
+    for (int i = 1; i < MARKERS - 1; ++i) {
+        double offset = m_desired[i] - m_positions[i];
+        if ((offset >= 1.0 && m_positions[i + 1] - m_positions[i] > 1.0) ||
+            (offset <= -1.0 && m_positions[i - 1] - m_positions[i] < -1.0)) {
+            int direction = offset > 0.0 ? 1 : -1;
+            double height = parabolic(i, direction);
+            if (m_heights[i - 1] < height && height < m_heights[i + 1]) {
+                m_heights[i] = height;
+            } else {
+                m_heights[i] = linear(i, direction);
+            }
+            m_positions[i] += direction;
+        }
+    }
+}
+
+double P2Quantile::value() const
+{
+    if (m_count == 0) {
+        return 0.0;
+    }
+    if (m_count >= MARKERS) {
+        return m_heights[2];
+    }
+
+    // Too few values for the markers: interpolate between the sorted ones
+    double sorted[MARKERS];
+    std::copy(m_heights, m_heights + m_count, sorted);
+    std::sort(sorted, sorted + m_count);
+
+    double rank = m_quantile * (m_count - 1);
+    int lower = static_cast<int>(rank);
+    int upper = qMin(lower + 1, static_cast<int>(m_count) - 1);
+    return sorted[lower] + (rank - lower) * (sorted[upper] - sorted[lower]);
+}
+
+qint64 P2Quantile::count() const
+{
+    return m_count;
+}
+
+double P2Quantile::quantile() const
+{
+    return m_quantile;
+}
+
+double P2Quantile::parabolic(int i, double direction) const
+{
+    const double* n = m_positions;
+    const double* q = m_heights;
+    return q[i] + direction / (n[i + 1] - n[i - 1]) *
+        ((n[i] - n[i - 1] + direction) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+         (n[i + 1] - n[i] - direction) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+double P2Quantile::linear(int i, int direction) const
+{
+    return m_heights[i] + direction * (m_heights[i + direction] - m_heights[i]) /
+        (m_positions[i + direction] - m_positions[i]);
+}
+
+// InterarrivalJitter
+
+InterarrivalJitter::InterarrivalJitter()
+    : m_count(0), m_last(0.0), m_jitter(0.0), m_differenceSum(0.0)
+{
+}
+
+void InterarrivalJitter::add(double transit)
+{
+    if (m_count++ == 0) {
+        m_last = transit;
+        return;
+    }
+
+    double difference = std::abs(transit - m_last);
+    m_last = transit;
+    m_jitter += (difference - m_jitter) * GAIN;
+
+    double evicted = 0.0;
+    if (m_differences.push(difference, &evicted)) {
+        m_differenceSum -= evicted;
+    }
+    m_differenceSum = std::max(0.0, m_differenceSum + difference);  // Rounding
+}
+
+void InterarrivalJitter::clear()
+{
+    m_count = 0;
+    m_last = 0.0;
+    m_jitter = 0.0;
+    m_differences.clear();
+    m_differenceSum = 0.0;
+}
+
+qint64 InterarrivalJitter::count() const
+{
+    return m_count;
+}
+
+double InterarrivalJitter::smoothed() const
+{
+    return m_jitter;
+}
+
+double InterarrivalJitter::windowed() const
+{
+    return m_differences.isEmpty() ? 0.0 : m_differenceSum / m_differences.size();
+}
@@ -0,0 +1,269 @@
+#ifndef STREAMINGSTATISTICS_H
+#define STREAMINGSTATISTICS_H
+
+#include <QtGlobal>
+
+/**
+ * Building blocks for per-sample statistics: every update is O(1) and
+ * none of them allocates, so they can sit in per-target state and be fed
+ * from a hot path. Batch helpers for stored vectors live in
+ * StatisticsCalculator.
+ */
+
+/**
+ * @brief Fixed-capacity FIFO that overwrites its oldest item when full
+ */
+template <typename T, int Capacity>
+class RingBuffer
+{
+    static_assert(Capacity > 0, "RingBuffer needs a capacity");
+
+public:
+    RingBuffer() : m_next(0), m_size(0) {}
+
+    /**
+     * @brief Append a value
+     * @param evicted Receives the overwritten value, if any
+     * @return True if the buffer was full and its oldest value was dropped
+     */
+    bool push(const T& value, T* evicted = nullptr)
+    {
+        bool full = m_size == Capacity;
+        if (full && evicted) {
+            *evicted = m_items[m_next];
+        }
+        m_items[m_next] = value;
+        m_next = (m_next + 1) % Capacity;
+        if (!full) {
+            ++m_size;
+        }
+        return full;
+    }
+
+    /**
+     * @brief Item by age, 0 being the oldest
+     */
+    const T& at(int index) const
+    {
+        return m_items[(m_next - m_size + index + Capacity) % Capacity];
+    }
+
+    const T& oldest() const { return at(0); }
+    const T& newest() const { return at(m_size - 1); }
+
+    int size() const { return m_size; }
+    static constexpr int capacity() { return Capacity; }
+    bool isEmpty() const { return m_size == 0; }
+    bool isFull() const { return m_size == Capacity; }
+
+    void clear()
+    {
+        m_next = 0;
+        m_size = 0;
+    }
+
+private:
+    T m_items[Capacity];
+    int m_next;     ///< Slot written by the next push
+    int m_size;
+};
+
+/**
+ * @brief Mean and variance by Welford's online algorithm
+ *
+ * Values can also be removed again, which keeps the moments of a sliding
+ * window exact without revisiting the window.
+ */
+class RunningStats
+{
+public:
+    RunningStats();
+
+    void add(double value);
+
+    /**
+     * @brief Remove a value previously added
+     */
+    void remove(double value);
+
+    void clear();
+
+    qint64 count() const;
+    double mean() const;
+
+    /**
+     * @brief Sample variance (n - 1), 0 below two values
+     */
+    double variance() const;
+    double stdDev() const;
+
+private:
+    qint64 m_count;
+    double m_mean;
+    double m_m2;    ///< Sum of squared deviations from the mean
+};
+
+/**
+ * @brief Single quantile estimate by the P² algorithm (Jain & Chlamtac)
+ *
+ * Tracks five markers whose heights are adjusted with a piecewise
+ * parabolic fit as values arrive; memory is constant however long the
+ * stream runs. Exact while fewer than five values have been seen.
+ */
+class P2Quantile
+{
+public:
+    /**
+     * @param quantile Target quantile in (0, 1), e.g. 0.95
+     */
+    explicit P2Quantile(double quantile);
+
+    void add(double value);
+    void clear();
+
+    /**
+     * @brief Current estimate, 0 if no value was added
+     */
+    double value() const;
+
+    qint64 count() const;
+    double quantile() const;
+
+private:
+    static constexpr int MARKERS = 5;
+
+    double m_quantile;
+    qint64 m_count;
+    double m_heights[MARKERS];
+    double m_positions[MARKERS];
+    double m_desired[MARKERS];
+    double m_increments[MARKERS];
+
+    double parabolic(int i, double direction) const;
+    double linear(int i, int direction) const;
+};
+
+/**
+ * @brief Interarrival jitter of a stream of transit times (RFC 3550, 6.4.1)
+ *
+ * D is the difference between the transit times of two consecutive
+ * replies; for echo probes the round-trip time is the transit time.
+ * smoothed() is the RFC estimator J += (|D| - J) / 16, which starts at 0
+ * and forgets old differences geometrically. windowed() is the plain mean
+ * of the last WINDOW values of |D|, which reacts to a change completely
+ * after WINDOW replies and has no start-up bias.
+ */
+class InterarrivalJitter
+{
+public:
+    static constexpr int WINDOW = 16;
+
+    InterarrivalJitter();
+
+    /**
+     * @brief Add the transit time of the next reply
+     *
+     * Lost probes are simply not added: D spans the gap to the last reply.
+     */
+    void add(double transit);
+    void clear();
+
+    qint64 count() const;       ///< Transit times added
+    double smoothed() const;    ///< RFC 3550 jitter, 0 below two transit times
+    double windowed() const;    ///< Mean |D| over the window, 0 below two transit times
+
+private:
+    static constexpr double GAIN = 1.0 / 16.0;
+
+    qint64 m_count;
+    double m_last;
+    double m_jitter;
+    RingBuffer<double, WINDOW> m_differences;
+    double m_differenceSum;
+};
+
+/**
+ * @brief Minimum and maximum of the last Capacity sequence positions
+ *
+ * Each extreme is kept by a monotonic deque: a new value pops every
+ * queued value it dominates, so the front is always the extreme of the
+ * window and every value is pushed and popped at most once. skip()
+ * advances the window without a value (e.g. for a lost probe).
+ */
+template <int Capacity>
+class WindowedMinMax
+{
+    static_assert(Capacity > 0, "WindowedMinMax needs a capacity");
+
+public:
+    WindowedMinMax() : m_sequence(0) {}
+
+    void push(double value)
+    {
+        ++m_sequence;
+        m_min.push(m_sequence, value, m_sequence - Capacity, true);
+        m_max.push(m_sequence, value, m_sequence - Capacity, false);
+    }
+
+    void skip()
+    {
+        ++m_sequence;
+        m_min.expire(m_sequence - Capacity);
+        m_max.expire(m_sequence - Capacity);
+    }
+
+    bool isEmpty() const { return m_min.size == 0; }
+
+    /**
+     * @brief Window minimum, 0 if the window holds no value
+     */
+    double min() const { return isEmpty() ? 0.0 : m_min.front().value; }
+    double max() const { return isEmpty() ? 0.0 : m_max.front().value; }
+
+    void clear()
+    {
+        m_min = Deque();
+        m_max = Deque();
+        m_sequence = 0;
+    }
+
+private:
+    struct Entry {
+        qint64 sequence;
+        double value;
+    };
+
+    // Ring deque; never holds more than Capacity entries
+    struct Deque {
+        Entry entries[Capacity];
+        int head = 0;
+        int size = 0;
+
+        const Entry& front() const { return entries[head]; }
+        const Entry& back() const { return entries[(head + size - 1) % Capacity]; }
+
+        void expire(qint64 oldestGone)
+        {
+            while (size > 0 && front().sequence <= oldestGone) {
+                head = (head + 1) % Capacity;
+                --size;
+            }
+        }
+
+        void push(qint64 sequence, double value, qint64 oldestGone, bool keepMin)
+        {
+            expire(oldestGone);
+            while (size > 0 && (keepMin ? back().value >= value : back().value <= value)) {
+                --size;
+            }
+            entries[(head + size) % Capacity] = Entry{sequence, value};
+            ++size;
+        }
+    };
+
+    Deque m_min;
+    Deque m_max;
+    qint64 m_sequence;
+};
+
+#endif // STREAMINGSTATISTICS_H
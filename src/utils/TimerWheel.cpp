@@ -0,0 +1,208 @@
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(int tickMs, qint64 startMs)
+    : m_tickMs(qMax(1, tickMs))
+    , m_currentTick(0)
+    , m_slots(ROOT_SLOTS + (LEVELS - 1) * LEVEL_SLOTS, -1)
+    , m_pending(0)
+{
+    // Next tick to process; a timer due now fires on the first advance()
+    m_currentTick = startMs >= 0 ? startMs / m_tickMs : (startMs - m_tickMs + 1) / m_tickMs;
+}
+
+TimerWheel::Id TimerWheel::schedule(qint64 dueMs, quint64 payload)
+{
+    int index;
+    if (!m_free.isEmpty()) {
+        index = m_free.takeLast();
+    } else {
+        index = m_nodes.size();
+        m_nodes.append(Node{0, 0, -1, -1, -1, 1, false});
+    }
+
+    Node& node = m_nodes[index];
+    node.payload = payload;
+    node.dueTick = toTick(dueMs);
+    node.allocated = true;
+    link(index);
+    ++m_pending;
+
+    return (static_cast<Id>(node.generation) << 32) | static_cast<Id>(index + 1);
+}
+
+bool TimerWheel::reschedule(Id id, qint64 dueMs)
+{
+    int index;
+    if (!resolve(id, index)) {
+        return false;
+    }
+
+    if (m_nodes[index].slot >= 0) {
+        unlink(index);
+        --m_pending;
+    }
+    m_nodes[index].dueTick = toTick(dueMs);
+    link(index);
+    ++m_pending;
+    return true;
+}
+
+bool TimerWheel::remove(Id id)
+{
+    int index;
+    if (!resolve(id, index)) {
+        return false;
+    }
+
+    if (m_nodes[index].slot >= 0) {
+        unlink(index);
+        --m_pending;
+    }
+    m_nodes[index].allocated = false;
+    m_nodes[index].generation++;
+    m_free.append(index);
+    return true;
+}
+
+bool TimerWheel::isPending(Id id) const
+{
+    int index;
+    return resolve(id, index) && m_nodes[index].slot >= 0;
+}
+
+qint64 TimerWheel::dueMs(Id id) const
+{
+    int index;
+    if (!resolve(id, index) || m_nodes[index].slot < 0) {
+        return -1;
+    }
+    return m_nodes[index].dueTick * m_tickMs;
+}
+
+int TimerWheel::pendingCount() const
+{
+    return m_pending;
+}
+
+int TimerWheel::tickMs() const
+{
+    return m_tickMs;
+}
+
+void TimerWheel::advance(qint64 nowMs, QVector<quint64>& fired)
+{
+    const qint64 target = nowMs >= 0 ? nowMs / m_tickMs : (nowMs - m_tickMs + 1) / m_tickMs;
+
+    while (m_currentTick <= target) {
+        if (m_pending == 0) {
+            m_currentTick = target + 1;  // Nothing to cascade or fire
+            return;
+        }
+
+        int index = static_cast<int>(m_currentTick & (ROOT_SLOTS - 1));
+        if (index == 0) {
+            // Root wrapped: pull the next slot of each level down while they wrap too
+            for (int level = 1; level < LEVELS; ++level) {
+                if (cascade(level) != 0) {
+                    break;
+                }
+            }
+        }
+
+        int node = m_slots[index];
+        m_slots[index] = -1;
+        while (node >= 0) {
+            Node& expired = m_nodes[node];
+            int next = expired.next;
+            expired.prev = -1;
+            expired.next = -1;
+            expired.slot = -1;
+            --m_pending;
+            fired.append(expired.payload);
+            node = next;
+        }
+
+        ++m_currentTick;
+    }
+}
+
+bool TimerWheel::resolve(Id id, int& index) const
+{
+    index = static_cast<int>(id & 0xffffffffu) - 1;
+    return index >= 0 && index < m_nodes.size()
+        && m_nodes[index].allocated
+        && m_nodes[index].generation == static_cast<quint32>(id >> 32);
+}
+
+qint64 TimerWheel::toTick(qint64 ms) const
+{
+    // Round up: a timer never fires before its deadline
+    return ms >= 0 ? (ms + m_tickMs - 1) / m_tickMs : ms / m_tickMs;
+}
+
+void TimerWheel::link(int index)
+{
+    Node& node = m_nodes[index];
+    qint64 delta = node.dueTick - m_currentTick;
+    int slot;
+
+    if (delta < 0) {
+        slot = static_cast<int>(m_currentTick & (ROOT_SLOTS - 1));
+    } else if (delta < ROOT_SLOTS) {
+        slot = static_cast<int>(node.dueTick & (ROOT_SLOTS - 1));
+    } else {
+        if (delta > MAX_DELTA) {
+            node.dueTick = m_currentTick + MAX_DELTA;
+            delta = MAX_DELTA;
+        }
+
+        int level = 1;
+        while (delta >= (qint64(1) << (ROOT_BITS + level * LEVEL_BITS))) {
+            ++level;
+        }
+        int shift = ROOT_BITS + (level - 1) * LEVEL_BITS;
+        slot = ROOT_SLOTS + (level - 1) * LEVEL_SLOTS
+             + static_cast<int>((node.dueTick >> shift) & (LEVEL_SLOTS - 1));
+    }
+
+    node.slot = slot;
+    node.prev = -1;
+    node.next = m_slots[slot];
+    if (node.next >= 0) {
+        m_nodes[node.next].prev = index;
+    }
+    m_slots[slot] = index;
+}
+
+void TimerWheel::unlink(int index)
+{
+    Node& node = m_nodes[index];
+    if (node.prev >= 0) {
+        m_nodes[node.prev].next = node.next;
+    } else {
+        m_slots[node.slot] = node.next;
+    }
+    if (node.next >= 0) {
+        m_nodes[node.next].prev = node.prev;
+    }
+    node.prev = -1;
+    node.next = -1;
+    node.slot = -1;
+}
+
+int TimerWheel::cascade(int level)
+{
+    int shift = ROOT_BITS + (level - 1) * LEVEL_BITS;
+    int index = static_cast<int>((m_currentTick >> shift) & (LEVEL_SLOTS - 1));
+    int slot = ROOT_SLOTS + (level - 1) * LEVEL_SLOTS + index;
+
+    // Detach first: nodes still a full rotation away land in this slot again
+    int node = m_slots[slot];
+    m_slots[slot] = -1;
+    while (node >= 0) {
+        int next = m_nodes[node].next;
+        link(node);
+        node = next;
+    }
+    return index;
+}
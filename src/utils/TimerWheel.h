@@ -0,0 +1,104 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * @brief Hierarchical hashed timing wheel
+ *
+ * Holds any number of one-shot timers with tick resolution. The first
+ * level has one slot per tick for the next 256 ticks; each further level
+ * covers 64 times the span of the one below, and its slots are cascaded
+ * down as time reaches them. At 10 ms per tick the four levels reach
+ * about 7.6 hours; later deadlines are clamped to that horizon.
+ *
+ * schedule(), reschedule() and remove() are O(1); advance() costs one
+ * step per elapsed tick plus the timers it fires or cascades. A timer
+ * that fired stays allocated, so reschedule() can rearm it with the same
+ * id until it is removed.
+ *
+ * Times are milliseconds on any monotonic clock, e.g. QElapsedTimer.
+ * Not thread-safe.
+ */
+class TimerWheel
+{
+public:
+    using Id = quint64;     ///< 0 is never a valid id
+
+    /**
+     * @param tickMs Resolution; deadlines are rounded up to a tick
+     * @param startMs Current time
+     */
+    explicit TimerWheel(int tickMs = 10, qint64 startMs = 0);
+
+    /**
+     * @brief Arm a new timer
+     * @param dueMs Deadline; past deadlines fire on the next advance()
+     * @param payload Returned by advance() when the timer fires
+     */
+    Id schedule(qint64 dueMs, quint64 payload);
+
+    /**
+     * @brief Move a pending or fired timer to a new deadline
+     * @return False if @p id was removed or never existed
+     */
+    bool reschedule(Id id, qint64 dueMs);
+
+    /**
+     * @brief Disarm and free a timer
+     * @return False if @p id was removed or never existed
+     */
+    bool remove(Id id);
+
+    bool isPending(Id id) const;
+
+    /**
+     * @brief Deadline of a pending timer (tick-rounded), -1 otherwise
+     */
+    qint64 dueMs(Id id) const;
+
+    int pendingCount() const;
+
+    /**
+     * @brief Advance to @p nowMs and append the payloads of every timer due
+     *
+     * Fired timers are appended in deadline order.
+     */
+    void advance(qint64 nowMs, QVector<quint64>& fired);
+
+    int tickMs() const;
+
+private:
+    static constexpr int ROOT_BITS = 8;
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr int LEVELS = 4;
+    static constexpr int ROOT_SLOTS = 1 << ROOT_BITS;
+    static constexpr int LEVEL_SLOTS = 1 << LEVEL_BITS;
+    static constexpr qint64 MAX_DELTA = (qint64(1) << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS)) - 1;
+
+    struct Node {
+        quint64 payload;
+        qint64 dueTick;
+        int prev;
+        int next;
+        int slot;           ///< Slot list holding the node, -1 if not pending
+        quint32 generation; ///< Bumped on removal so stale ids are rejected
+        bool allocated;
+    };
+
+    int m_tickMs;
+    qint64 m_currentTick;
+    QVector<Node> m_nodes;
+    QVector<int> m_slots;   ///< Head node per slot, root level first
+    QVector<int> m_free;
+    int m_pending;
+
+    bool resolve(Id id, int& index) const;
+    qint64 toTick(qint64 ms) const;
+    void link(int index);
+    void unlink(int index);
+    int cascade(int level);
+};
+
+#endif // TIMERWHEEL_H
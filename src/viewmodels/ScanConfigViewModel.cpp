@@ -1,4 +1,5 @@
 #include "viewmodels/ScanConfigViewModel.h"
+#include "managers/ProfileManager.h"
 #include "../network/services/NetworkInterfaceDetector.h"
 #include "../utils/IpAddressValidator.h"
 #include "../utils/Logger.h"
@@ -12,6 +13,8 @@ ScanConfigViewModel::ScanConfigViewModel(QObject* parent)
     , resolveDns(true)
     , resolveArp(false)
     , scanPorts(false)
+    , topPorts(0)
+    , detectVersions(false)
     , interfaceDetector(nullptr)
 {
     // Initialize with Quick scan preset
@@ -51,6 +54,14 @@ QList<int> ScanConfigViewModel::getPortsToScan() const {
     return portsToScan;
 }
 
+int ScanConfigViewModel::getTopPorts() const {
+    return topPorts;
+}
+
+bool ScanConfigViewModel::isDetectVersions() const {
+    return detectVersions;
+}
+
 void ScanConfigViewModel::setSubnet(const QString& subnet) {
     if (this->subnet != subnet) {
         this->subnet = subnet;
@@ -91,6 +102,14 @@ void ScanConfigViewModel::setPortsToScan(const QList<int>& ports) {
     this->portsToScan = ports;
 }
 
+void ScanConfigViewModel::setTopPorts(int count) {
+    this->topPorts = qMax(0, count);
+}
+
+void ScanConfigViewModel::setDetectVersions(bool detect) {
+    this->detectVersions = detect;
+}
+
 bool ScanConfigViewModel::isSubnetValid() const {
     return IpAddressValidator::isValidCidr(subnet);
 }
@@ -117,6 +136,8 @@ void ScanConfigViewModel::loadQuickScanPreset() {
     timeout = 1000;  // 1 second
     threadCount = QThread::idealThreadCount();
     portsToScan.clear();
+    topPorts = 0;
+    detectVersions = false;
 
     Logger::debug("Loaded Quick scan preset");
     updateValidation();
@@ -129,7 +150,9 @@ void ScanConfigViewModel::loadDeepScanPreset() {
     scanPorts = true;
     timeout = 3000;  // 3 seconds
     threadCount = QThread::idealThreadCount();
-    portsToScan = {21, 22, 23, 25, 53, 80, 110, 135, 139, 143, 443, 445, 3389, 8080};
+    portsToScan.clear();
+    topPorts = ScanCoordinator::DEEP_SCAN_TOP_PORTS;
+    detectVersions = false;
 
     Logger::debug("Loaded Deep scan preset");
     updateValidation();
@@ -142,6 +165,23 @@ void ScanConfigViewModel::loadCustomScanPreset() {
     updateValidation();
 }
 
+void ScanConfigViewModel::loadProfile(const ScanProfile& profile) {
+    scanType = Custom;
+    subnet = profile.subnet;
+    resolveDns = profile.resolveDns;
+    resolveArp = profile.resolveArp;
+    scanPorts = profile.scanPorts;
+    portsToScan = profile.portsToScan;
+    topPorts = profile.topPorts;
+    detectVersions = profile.detectVersions;
+    timeout = profile.timeout;
+
+    emit subnetChanged(subnet);
+    emit scanTypeChanged(scanType);
+    Logger::debug("Loaded profile " + profile.name);
+    updateValidation();
+}
+
 void ScanConfigViewModel::loadPreset(ScanType type) {
     switch (type) {
         case Quick:
@@ -176,6 +216,8 @@ ScanCoordinator::ScanConfig ScanConfigViewModel::toScanConfig() const {
     config.resolveArp = resolveArp;
     config.scanPorts = scanPorts;
     config.portsToScan = portsToScan;
+    config.topPorts = topPorts;
+    config.detectVersions = detectVersions;
     config.timeout = timeout;
     config.maxThreads = threadCount;
     return config;
@@ -2,10 +2,12 @@
 #include "ui_devicedetaildialog.h"
 #include "views/MetricsWidget.h"
 #include "views/BandwidthTestDialog.h"
+#include "charts/LatencyDistributionChart.h"
 #include "viewmodels/MetricsViewModel.h"
 #include "controllers/MetricsController.h"
 #include "utils/Logger.h"
 #include "utils/TimeFormatter.h"
+#include "utils/StreamingStatistics.h"
 #include <QDateTime>
 #include <QMessageBox>
 #include <QVBoxLayout>
@@ -33,6 +35,7 @@ DeviceDetailDialog::DeviceDetailDialog(
     , m_dnsDiagnostics(dnsDiagnostics)
     , m_metricsWidget(nullptr)
     , m_metricsViewModel(nullptr)
+    , m_latencyDistributionChart(nullptr)
 {
     ui->setupUi(this);
     setupUi();
@@ -73,6 +76,9 @@ void DeviceDetailDialog::setupOverviewTab()
 {
     // Header information
     ui->ipAddressLabel->setText(m_device.getIp());
+    if (!m_device.getIpv6Addresses().isEmpty()) {
+        ui->ipAddressLabel->setToolTip(tr("IPv6: %1").arg(m_device.getIpv6Addresses().join(", ")));
+    }
     ui->hostnameLabel->setText(m_device.hostname().isEmpty() ?
                               tr("No hostname") : m_device.hostname());
 
@@ -123,6 +129,13 @@ void DeviceDetailDialog::setupMetricsTab()
     gaugeContainerLayout->setContentsMargins(0, 0, 0, 0);
     gaugeContainerLayout->addWidget(m_qualityGauge, 0, Qt::AlignCenter);
 
+    // Latency distribution since monitoring started
+    m_latencyDistributionChart = new LatencyDistributionChart(this);
+    m_latencyDistributionChart->clearData();
+    QVBoxLayout* distributionLayout = new QVBoxLayout(ui->latencyDistributionContainer);
+    distributionLayout->setContentsMargins(0, 0, 0, 0);
+    distributionLayout->addWidget(m_latencyDistributionChart);
+
     // Create MetricsViewModel for data updates
     m_metricsViewModel = new MetricsViewModel(
         m_metricsController,
@@ -135,12 +148,25 @@ void DeviceDetailDialog::setupMetricsTab()
             this, [this](const NetworkMetrics& metrics) {
                 // Update latency (using average)
                 ui->valueLatency->setText(QString("%1 ms").arg(metrics.latencyAvg(), 0, 'f', 1));
+                ui->valueLatency->setToolTip(tr("Median: %1 ms, p95: %2 ms, p99: %3 ms")
+                    .arg(metrics.latencyMedian(), 0, 'f', 1)
+                    .arg(metrics.latencyP95(), 0, 'f', 1)
+                    .arg(metrics.latencyP99(), 0, 'f', 1));
+
+                // Update latency distribution
+                if (m_metricsController) {
+                    m_latencyDistributionChart->setHistogram(
+                        m_metricsController->latencyHistogram(m_device.getIp()));
+                }
 
                 // Update packet loss
                 ui->valuePacketLoss->setText(QString("%1%").arg(metrics.packetLoss(), 0, 'f', 1));
 
                 // Update jitter
                 ui->valueJitter->setText(QString("%1 ms").arg(metrics.jitter(), 0, 'f', 1));
+                ui->valueJitter->setToolTip(tr("RFC 3550 interarrival jitter; last %1 replies: %2 ms")
+                    .arg(InterarrivalJitter::WINDOW)
+                    .arg(metrics.jitterWindowed(), 0, 'f', 1));
 
                 // Update quality score text
                 QString qualityText;
@@ -290,6 +316,9 @@ void DeviceDetailDialog::loadPorts()
             port.service().isEmpty() ? tr("Unknown") : port.service()
         );
         ui->portsTableWidget->setItem(i, 3, serviceItem);
+
+        // Version (banner detection, empty when not probed)
+        ui->portsTableWidget->setItem(i, 4, new QTableWidgetItem(port.version()));
     }
 
     Logger::debug(QString("DeviceDetailDialog: Loaded %1 ports").arg(ports.size()));
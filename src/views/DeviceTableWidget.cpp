@@ -104,6 +104,7 @@ void DeviceTableWidget::setupContextMenu() {
 
     contextMenu->addAction(tr("Device Metrics"), this, &DeviceTableWidget::onPingDevice);
     contextMenu->addAction(tr("Show Details"), this, &DeviceTableWidget::onShowDetails);
+    contextMenu->addAction(tr("Rescan Device"), this, &DeviceTableWidget::onRescanDevice);
     contextMenu->addSeparator();
     contextMenu->addAction(tr("Wake on LAN"), this, &DeviceTableWidget::onWakeOnLan);
     contextMenu->addSeparator();
@@ -188,6 +189,15 @@ void DeviceTableWidget::onShowDetails() {
     emit deviceDoubleClicked(device);
 }
 
+void DeviceTableWidget::onRescanDevice() {
+    Device device = getSelectedDevice();
+    if (device.getIp().isEmpty()) {
+        return;
+    }
+
+    emit rescanDeviceRequested(device);
+}
+
 void DeviceTableWidget::onWakeOnLan() {
     Device device = getSelectedDevice();
     if (device.getIp().isEmpty()) {
@@ -64,6 +64,7 @@ MainWindow::MainWindow(
     , progressBar(nullptr)
     , statusLabel(nullptr)
     , deviceCountLabel(nullptr)
+    , rateLabel(nullptr)
     , metricsWidget(nullptr)
     , metricsViewModel(nullptr)
     , metricsDock(nullptr)
@@ -142,6 +143,19 @@ void MainWindow::setupMenuBar() {
     QAction* stopScanMenuAction = scanMenu->addAction(IconLoader::loadIcon("stop"), tr("&Stop Scan"), this, &MainWindow::onStopScanTriggered, QKeySequence(Qt::CTRL | Qt::Key_S));
     stopScanMenuAction->setProperty("iconName", "stop");
 
+    resumeScanAction = scanMenu->addAction(tr("&Resume Interrupted Scan"), this, &MainWindow::onResumeInterruptedScan);
+    resumeScanAction->setToolTip(tr("Continue the last stopped or crashed scan from its checkpoint"));
+    resumeScanAction->setEnabled(scanController->hasResumableScan());
+
+    scanMenu->addSeparator();
+
+    passiveListenAction = scanMenu->addAction(tr("Passive &Listen"));
+    passiveListenAction->setCheckable(true);
+    passiveListenAction->setToolTip(tr("Discover devices from ARP, DHCP, mDNS and SSDP traffic without probing"));
+    connect(passiveListenAction, &QAction::toggled, this, &MainWindow::onPassiveListenToggled);
+
+    scanMenu->addAction(tr("&Replay Capture..."), this, &MainWindow::onReplayCapture);
+
     // View Menu
     QMenu* viewMenu = menuBar()->addMenu(tr("&View"));
 
@@ -196,6 +210,8 @@ void MainWindow::setupToolBar() {
 void MainWindow::setupStatusBar() {
     statusLabel = new QLabel(tr("Ready"), this);
     deviceCountLabel = new QLabel(tr("Devices: 0"), this);
+    rateLabel = new QLabel(this);
+    rateLabel->setVisible(false);
 
     // Use GradientProgressBar instead of QProgressBar
     progressBar = new GradientProgressBar(this);
@@ -211,6 +227,7 @@ void MainWindow::setupStatusBar() {
 
     ui->statusBar->addWidget(statusLabel, 1);
     ui->statusBar->addWidget(progressBar);
+    ui->statusBar->addPermanentWidget(rateLabel);
     ui->statusBar->addPermanentWidget(activityIndicator);
     ui->statusBar->addPermanentWidget(deviceCountLabel);
 }
@@ -313,12 +330,16 @@ void MainWindow::setupConnections() {
             this, &MainWindow::onDeviceDiscovered);
     connect(scanController, &ScanController::scanProgressUpdated,
             this, &MainWindow::onScanProgressUpdated);
+    connect(scanController, &ScanController::scanRateUpdated,
+            this, &MainWindow::onScanRateUpdated);
 
     // DeviceTableWidget signals
     connect(deviceTable, &DeviceTableWidget::deviceDoubleClicked,
             this, &MainWindow::onShowDeviceDetails);
     connect(deviceTable, &DeviceTableWidget::pingDeviceRequested,
             this, &MainWindow::onPingDevice);
+    connect(deviceTable, &DeviceTableWidget::rescanDeviceRequested,
+            this, &MainWindow::onRescanDevice);
 
     // DeviceTableViewModel signals
     connect(deviceTableViewModel, &DeviceTableViewModel::deviceCountChanged,
@@ -348,6 +369,7 @@ void MainWindow::onNewScanTriggered() {
 void MainWindow::onStopScanTriggered() {
     scanController->stopCurrentScan();
     updateStatusMessage(tr("Scan stopped"));
+    resumeScanAction->setEnabled(scanController->hasResumableScan());
 }
 
 void MainWindow::onExportTriggered() {
@@ -422,6 +444,62 @@ void MainWindow::onDeepScan() {
     }
 }
 
+void MainWindow::onPassiveListenToggled(bool enabled) {
+    if (!enabled) {
+        scanController->stopPassiveDiscovery();
+        return;
+    }
+
+    if (!scanController->startPassiveDiscovery()) {
+        QSignalBlocker blocker(passiveListenAction);
+        passiveListenAction->setChecked(false);
+        QMessageBox::warning(this, tr("Passive Listen"),
+                             tr("Could not start packet capture. Listening requires the CAP_NET_RAW "
+                                "capability (or root) and is only available on Linux."));
+    }
+}
+
+void MainWindow::onReplayCapture() {
+    QString fileName = QFileDialog::getOpenFileName(
+        this,
+        tr("Replay Capture"),
+        QString(),
+        tr("Packet Captures (*.pcap *.cap);;All Files (*)")
+    );
+
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    if (scanController->replayPassiveCapture(fileName) < 0) {
+        QMessageBox::warning(this, tr("Replay Capture"), tr("Could not read %1").arg(fileName));
+    }
+}
+
+void MainWindow::onResumeInterruptedScan() {
+    ScanCheckpoint checkpoint = scanController->latestResumableScan();
+    if (!checkpoint.isResumable()) {
+        resumeScanAction->setEnabled(false);
+        return;
+    }
+
+    QMessageBox::StandardButton answer = QMessageBox::question(
+        this, tr("Resume Scan"),
+        tr("Resume the scan of %1 from %2 of %3 hosts (%4 devices found, last saved %5)?")
+            .arg(checkpoint.targetSpec)
+            .arg(checkpoint.completedIndex)
+            .arg(checkpoint.totalHosts)
+            .arg(checkpoint.devicesFound)
+            .arg(checkpoint.updatedAt.toString("yyyy-MM-dd HH:mm:ss")));
+    if (answer != QMessageBox::Yes) {
+        return;
+    }
+
+    if (!scanController->resumeInterruptedScan(checkpoint.id)) {
+        QMessageBox::warning(this, tr("Resume Scan"), tr("The scan could not be resumed."));
+    }
+}
+
 void MainWindow::onRefresh() {
     deviceTableViewModel->loadDevices();
     updateStatusMessage(tr("Devices refreshed"));
@@ -440,6 +518,7 @@ void MainWindow::onScanStarted(int totalHosts) {
 
     // Set activity indicator to blinking during scan
     activityIndicator->setState(NetworkActivityIndicator::Blinking);
+    resumeScanAction->setEnabled(false);
 
     Logger::info(QString("Scan starting - marked all devices as offline"));
 }
@@ -454,6 +533,8 @@ void MainWindow::onScanStatusChanged(const QString& status) {
         // Scan finished - turn off indicator
         activityIndicator->setState(NetworkActivityIndicator::Off);
         progressBar->setVisible(false);
+        rateLabel->setVisible(false);
+        resumeScanAction->setEnabled(scanController->hasResumableScan());
     }
 }
 
@@ -474,6 +555,14 @@ void MainWindow::onScanProgressUpdated(int current, int total, double percentage
     progressBar->setFormat(QString("%1/%2 (%p%)").arg(current).arg(total));
 }
 
+void MainWindow::onScanRateUpdated(double effectivePps, double limitPps) {
+    rateLabel->setVisible(true);
+    rateLabel->setText(tr("%1 pps").arg(effectivePps, 0, 'f', 0));
+    rateLabel->setToolTip(limitPps > 0
+        ? tr("Probe rate limit: %1 pps").arg(limitPps, 0, 'f', 0)
+        : tr("Probe rate: unlimited"));
+}
+
 void MainWindow::onDeviceDoubleClicked(const Device& device) {
     // Deprecated - now using onShowDeviceDetails
     onShowDeviceDetails(device);
@@ -500,6 +589,11 @@ void MainWindow::onShowDeviceDetails(const Device& device) {
     dialog->exec();
 }
 
+void MainWindow::onRescanDevice(const Device& device) {
+    scanController->rescanDevice(device.getIp());
+    updateStatusMessage(tr("Rescanning %1...").arg(device.getIp()));
+}
+
 void MainWindow::onPingDevice(const Device& device) {
     if (device.getIp().isEmpty()) {
         Logger::warn("Cannot ping device: empty IP address");
@@ -115,6 +115,14 @@ void ProfileDialog::displayProfileDetails(const ScanProfile& profile) {
     html += "<p><b>ARP Resolution:</b> " + QString(profile.resolveArp ? "Enabled" : "Disabled") + "</p>";
     html += "<p><b>Port Scanning:</b> " + QString(profile.scanPorts ? "Enabled" : "Disabled") + "</p>";
 
+    if (profile.scanPorts && profile.topPorts > 0) {
+        html += "<p><b>Top Ports:</b> " + QString::number(profile.topPorts) + " most frequently open</p>";
+    }
+
+    if (profile.scanPorts && profile.detectVersions) {
+        html += "<p><b>Version Detection:</b> Enabled</p>";
+    }
+
     if (profile.scanPorts && !profile.portsToScan.isEmpty()) {
         html += "<p><b>Ports to Scan:</b> ";
         QStringList portStrings;
@@ -257,16 +257,26 @@ void TrendsWidget::updateStatistics(const QList<NetworkMetrics>& metrics) {
     double maxLatency = metricsDao->getMaxLatency(currentDeviceId, startDate, endDate);
     double minLatency = metricsDao->getMinLatency(currentDeviceId, startDate, endDate);
 
+    // Percentiles of the whole range from the merged per-row histograms
+    LatencyHistogram histogram = metricsDao->getLatencyHistogram(currentDeviceId, startDate, endDate);
+    QString percentiles;
+    if (!histogram.isEmpty()) {
+        percentiles = QString(", P95: %1ms, P99: %2ms")
+            .arg(QString::number(histogram.percentile(95.0), 'f', 2))
+            .arg(QString::number(histogram.percentile(99.0), 'f', 2));
+    }
+
     QString statsText = QString(
         "📊 <b>Statistics:</b> %1 data points | "
-        "<b>Latency:</b> Min: %2ms, Avg: %3ms, Max: %4ms | "
-        "<b>Packet Loss:</b> %5% | "
-        "<b>Jitter:</b> %6ms | "
-        "<b>Quality:</b> %7/100"
+        "<b>Latency:</b> Min: %2ms, Avg: %3ms, Max: %4ms%5 | "
+        "<b>Packet Loss:</b> %6% | "
+        "<b>Jitter:</b> %7ms | "
+        "<b>Quality:</b> %8/100"
     ).arg(metrics.size())
      .arg(QString::number(minLatency, 'f', 2))
      .arg(QString::number(avgMetrics.getLatencyAvg(), 'f', 2))
      .arg(QString::number(maxLatency, 'f', 2))
+     .arg(percentiles)
      .arg(QString::number(avgMetrics.getPacketLoss(), 'f', 2))
      .arg(QString::number(avgMetrics.getJitter(), 'f', 2))
      .arg(static_cast<int>(avgMetrics.getQualityScore()));
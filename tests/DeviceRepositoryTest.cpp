@@ -19,6 +19,7 @@ private slots:
     void testRemove();
     void testExists();
     void testCache();
+    void testIpv6Addresses();
 
 private:
     DatabaseManager* db;
@@ -156,5 +157,45 @@ void DeviceRepositoryTest::testCache() {
     QCOMPARE(found3.getId(), QString("device-8"));
 }
 
+void DeviceRepositoryTest::testIpv6Addresses() {
+    Device device;
+    device.setId("device-9");
+    device.setIp("192.168.1.90");
+    device.setMacAddress("00:11:22:33:44:09");
+    device.addIpv6Address("2001:db8::9");
+    repo->save(device);
+
+    repo->clearCache();
+    Device found = repo->findByIp("192.168.1.90");
+    QCOMPARE(found.getIpv6Addresses(), QStringList() << "2001:db8::9");
+    QCOMPARE(repo->findByIpv6("2001:DB8::9").getId(), QString("device-9"));
+
+    // Found over IPv6 only: joins the IPv4 record with the same MAC
+    Device ipv6Host;
+    ipv6Host.setIp("fe80::211:22ff:fe33:4409%eth0");
+    ipv6Host.setMacAddress("00:11:22:33:44:09");
+    ipv6Host.addIpv6Address("fe80::211:22ff:fe33:4409%eth0");
+    repo->save(ipv6Host);
+
+    QCOMPARE(repo->count(), 1);
+    repo->clearCache();
+    found = repo->findById("device-9");
+    QCOMPARE(found.getIp(), QString("192.168.1.90"));
+    QCOMPARE(found.getIpv6Addresses().size(), 2);
+    QVERIFY(found.hasIpv6Address("fe80::211:22ff:fe33:4409%eth0"));
+
+    // No MAC match: stored with the IPv6 address as its primary address
+    Device stranger;
+    stranger.setIp("2001:db8::77");
+    stranger.addIpv6Address("2001:db8::77");
+    repo->save(stranger);
+
+    QCOMPARE(repo->count(), 2);
+    QCOMPARE(repo->findByIp("2001:db8::77").getIpv6Addresses(), QStringList() << "2001:db8::77");
+
+    repo->remove("device-9");
+    QVERIFY(repo->findByIpv6("2001:db8::9").getId().isEmpty());
+}
+
 QTEST_MAIN(DeviceRepositoryTest)
 #include "DeviceRepositoryTest.moc"
@@ -16,6 +16,7 @@ private slots:
     void testServiceConstruction();
     void testInitialize();
     void testSaveMetrics();
+    void testGetLatencyHistogram();
     void testSaveEvent();
     void testGetMetricsHistory();
     void testGetAllMetricsForDevice();
@@ -112,6 +113,31 @@ void HistoryServiceTest::testSaveMetrics()
     QCOMPARE(count, 1);
 }
 
+void HistoryServiceTest::testGetLatencyHistogram()
+{
+    LatencyHistogram first;
+    first.record(10.0);
+    first.record(20.0);
+    LatencyHistogram second;
+    second.record(200.0);
+
+    QVERIFY(service->saveMetrics("192.168.1.1", createTestMetrics(15.0, 1.0, 0.0), first));
+    QVERIFY(service->saveMetrics("192.168.1.1", createTestMetrics(200.0, 1.0, 0.0), second));
+    QVERIFY(service->saveMetrics("192.168.1.1", createTestMetrics(25.0, 1.0, 0.0)));   // No histogram
+    QVERIFY(service->saveMetrics("192.168.1.2", createTestMetrics(25.0, 1.0, 0.0), second));
+
+    QDateTime now = QDateTime::currentDateTime();
+    LatencyHistogram merged = service->getLatencyHistogram("192.168.1.1", now.addSecs(-3600), now.addSecs(3600));
+    QCOMPARE(merged.totalCount(), quint64(3));
+    QCOMPARE(merged.min(), 10.0);
+    QCOMPARE(merged.max(), 200.0);
+    QVERIFY(qAbs(merged.percentile(50.0) - 20.0) <= 20.0 * 0.02);   // Bucket resolution
+
+    // Outside the range
+    merged = service->getLatencyHistogram("192.168.1.1", now.addDays(-2), now.addDays(-1));
+    QVERIFY(merged.isEmpty());
+}
+
 void HistoryServiceTest::testSaveEvent()
 {
     QSignalSpy spy(service, &HistoryService::eventStored);
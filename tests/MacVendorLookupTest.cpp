@@ -1,4 +1,5 @@
 #include <QtTest/QtTest>
+#include <QTemporaryDir>
 #include "network/services/MacVendorLookup.h"
 
 class MacVendorLookupTest : public QObject
@@ -18,6 +19,7 @@ private slots:
     void testEmptyMac();
     void testShortMac();
     void testLocallyAdministeredMac();
+    void testBuiltinFallback();
 
 private:
     MacVendorLookup* vendorLookup;
@@ -150,5 +152,27 @@ void MacVendorLookupTest::testLocallyAdministeredMac()
     QVERIFY(vendor4 != QString("Locally Administered"));
 }
 
+void MacVendorLookupTest::testBuiltinFallback()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QString textPath = dir.filePath("oui_database.txt");
+    QFile text(textPath);
+    QVERIFY(text.open(QIODevice::WriteOnly | QIODevice::Text));
+    text.write("C0FFEE\tCoffee Devices\n"
+               "001B21\tIntel Corporate\n");
+    text.close();
+    QVERIFY(vendorLookup->loadOuiDatabase(textPath));
+
+    // The file wins where it has an entry; the built-in table covers the rest
+    QCOMPARE(vendorLookup->lookupVendor("C0:FF:EE:00:00:01"), QString("Coffee Devices"));
+    QCOMPARE(vendorLookup->lookupVendor("00:1B:21:00:00:01"), QString("Intel Corporate"));
+    QCOMPARE(vendorLookup->lookupVendor("00:0D:3A:44:55:66"), QString("Microsoft"));
+    QCOMPARE(vendorLookup->lookupVendor("08:00:27:00:00:01"), QString("Unknown"));
+
+    vendorLookup->loadDefaultDatabase();
+}
+
 QTEST_MAIN(MacVendorLookupTest)
 #include "MacVendorLookupTest.moc"
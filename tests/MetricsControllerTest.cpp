@@ -6,49 +6,66 @@
 #include "models/NetworkMetrics.h"
 #include "models/Device.h"
 #include "database/DatabaseManager.h"
+#include "network/diagnostics/MonitoringEngine.h"
+#include "network/diagnostics/LatencyCalculator.h"
+#include "network/diagnostics/JitterCalculator.h"
+#include "network/diagnostics/PacketLossCalculator.h"
+#include "network/diagnostics/QualityScoreCalculator.h"
+#include "network/sockets/IcmpEchoEngine.h"
+#include <QMutex>
+#include <QWaitCondition>
+#include <QHostAddress>
+#include <QSet>
+#include <cstring>
 
 /**
- * @brief Mock MetricsAggregator for testing
+ * @brief Echo transport that answers requests at once
  *
- * This mock allows us to test MetricsController without actually performing network operations.
- * We can simulate metrics collection and verify that MetricsController handles them correctly.
+ * Lets MetricsController run its real monitoring engine without touching
+ * the network.
  */
-class MockMetricsAggregator : public MetricsAggregator {
-    Q_OBJECT
-
+class LoopbackIcmpTransport : public IcmpTransport {
 public:
-    explicit MockMetricsAggregator(QObject* parent = nullptr)
-        : MetricsAggregator(nullptr, nullptr, nullptr, nullptr, parent)
-        , mockCollecting(false)
-    {}
-
-    void startContinuousCollection(const QString& targetIp, int intervalMs = 1000) {
-        Q_UNUSED(intervalMs);
-        mockCollecting = true;
-        currentTargetIp = targetIp;
-    }
-
-    void stopContinuousCollection() {
-        mockCollecting = false;
-        currentTargetIp.clear();
-    }
-
-    bool isCollecting() const {
-        return mockCollecting;
-    }
-
-    // Helper methods for testing
-    void simulateMetricsUpdate(const NetworkMetrics& metrics) {
-        emit metricsUpdated(metrics);
+    QSet<quint32> silent;   ///< Addresses that never answer
+
+    bool open() override { return true; }
+    void close() override {}
+    quint16 identifier() const override { return 0x4d43; }
+    QString name() const override { return "loopback responder"; }
+
+    bool send(quint32 address, const quint8* data, int length) override {
+        QMutexLocker locker(&mutex);
+        if (silent.contains(address)) {
+            return true;
+        }
+        QByteArray reply(reinterpret_cast<const char*>(data), length);
+        reply[0] = 0;  // Echo reply
+        queue.append(qMakePair(address, reply));
+        ready.wakeAll();
+        return true;
     }
 
-    QString getCurrentTargetIp() const {
-        return currentTargetIp;
+    int receive(quint32& address, quint8* buffer, int capacity, int& ttl, int timeoutMs) override {
+        QMutexLocker locker(&mutex);
+        if (queue.isEmpty()) {
+            ready.wait(&mutex, static_cast<unsigned long>(timeoutMs));
+        }
+        if (queue.isEmpty()) {
+            return 0;
+        }
+
+        auto reply = queue.takeFirst();
+        int length = qMin(capacity, static_cast<int>(reply.second.size()));
+        std::memcpy(buffer, reply.second.constData(), length);
+        address = reply.first;
+        ttl = 64;
+        return length;
     }
 
 private:
-    bool mockCollecting;
-    QString currentTargetIp;
+    QMutex mutex;
+    QWaitCondition ready;
+    QList<QPair<quint32, QByteArray>> queue;
 };
 
 /**
@@ -62,6 +79,7 @@ private:
  * - Timer management
  * - Error handling
  * - Device tracking
+ * - Per-device metrics attribution
  */
 class MetricsControllerTest : public QObject {
     Q_OBJECT
@@ -79,6 +97,7 @@ private slots:
     void testStartContinuousMonitoring();
     void testStartContinuousMonitoring_EmptyDeviceId();
     void testStartContinuousMonitoring_AlreadyMonitoring();
+    void testStartContinuousMonitoring_InvalidAddress();
     void testStopContinuousMonitoring();
     void testStopContinuousMonitoring_NotMonitoring();
 
@@ -99,18 +118,26 @@ private slots:
     void testSignal_MonitoringStopped();
     void testSignal_MetricsCollected();
     void testSignal_MetricsError();
+    void testMetricsAttributedPerDevice();
 
     // Timer tests
     void testTimerCleanup();
 
 private:
     MetricsController* controller;
-    MockMetricsAggregator* mockAggregator;
+    LatencyCalculator latencyCalc;
+    JitterCalculator jitterCalc;
+    PacketLossCalculator lossCalc;
+    QualityScoreCalculator qualityCalc;
+    MetricsAggregator* aggregator;
+    LoopbackIcmpTransport* transport;
+    IcmpEchoEngine* echoEngine;
+    MonitoringEngine* engine;
     DeviceRepository* repository;
     DatabaseManager* dbManager;
 
     Device createTestDevice(const QString& ip, const QString& hostname, bool online = true);
-    NetworkMetrics createTestMetrics(double latency, double jitter, double packetLoss);
+    static QSet<QString> reportedDevices(const QSignalSpy& spy);
 };
 
 void MetricsControllerTest::initTestCase() {
@@ -127,20 +154,28 @@ void MetricsControllerTest::cleanupTestCase() {
 
 void MetricsControllerTest::init() {
     // Create fresh instances for each test
-    mockAggregator = new MockMetricsAggregator();
+    aggregator = new MetricsAggregator(&latencyCalc, &jitterCalc, &lossCalc, &qualityCalc);
+    transport = new LoopbackIcmpTransport();
+    echoEngine = new IcmpEchoEngine(transport);
+    engine = new MonitoringEngine(aggregator, echoEngine);
     repository = new DeviceRepository(dbManager);
-    controller = new MetricsController(mockAggregator, repository);
+    controller = new MetricsController(aggregator, repository, engine);
 }
 
 void MetricsControllerTest::cleanup() {
     // Clean up after each test
     delete controller;
     delete repository;
-    delete mockAggregator;
+    delete engine;
+    delete echoEngine;
+    delete aggregator;
 
     controller = nullptr;
     repository = nullptr;
-    mockAggregator = nullptr;
+    engine = nullptr;
+    echoEngine = nullptr;
+    transport = nullptr;
+    aggregator = nullptr;
 }
 
 // ============================================================================
@@ -173,8 +208,11 @@ void MetricsControllerTest::testStartContinuousMonitoring() {
     QCOMPARE(monitoringStartedSpy.count(), 1);
     QCOMPARE(monitoringStartedSpy.takeFirst().at(0).toString(), deviceId);
 
-    // Verify aggregator was called
-    QVERIFY(mockAggregator->isCollecting());
+    // Verify the engine probes the device
+    QVERIFY(engine->hasTarget(deviceId));
+    QSignalSpy metricsCollectedSpy(controller, &MetricsController::metricsCollected);
+    QTRY_VERIFY_WITH_TIMEOUT(metricsCollectedSpy.count() > 0, 2000);
+    QCOMPARE(metricsCollectedSpy.first().at(0).toString(), deviceId);
 }
 
 void MetricsControllerTest::testStartContinuousMonitoring_EmptyDeviceId() {
@@ -210,6 +248,18 @@ void MetricsControllerTest::testStartContinuousMonitoring_AlreadyMonitoring() {
     QCOMPARE(controller->getMonitoredDeviceCount(), 1);
 }
 
+void MetricsControllerTest::testStartContinuousMonitoring_InvalidAddress() {
+    QSignalSpy monitoringStartedSpy(controller, &MetricsController::monitoringStarted);
+    QSignalSpy metricsErrorSpy(controller, &MetricsController::metricsError);
+
+    controller->startContinuousMonitoring("not-an-address");
+
+    QVERIFY(!controller->isMonitoring("not-an-address"));
+    QCOMPARE(monitoringStartedSpy.count(), 0);
+    QCOMPARE(metricsErrorSpy.count(), 1);
+    QCOMPARE(metricsErrorSpy.first().at(0).toString(), QString("not-an-address"));
+}
+
 void MetricsControllerTest::testStopContinuousMonitoring() {
     QString deviceId = "192.168.1.100";
 
@@ -250,15 +300,14 @@ void MetricsControllerTest::testStopContinuousMonitoring_NotMonitoring() {
 void MetricsControllerTest::testCollectMetricsOnce() {
     QString deviceId = "192.168.1.100";
 
+    QSignalSpy metricsCollectedSpy(controller, &MetricsController::metricsCollected);
+
     // Collect metrics once
     controller->collectMetricsOnce(deviceId);
 
-    // Wait for processing
-    QTest::qWait(100);
-
-    // Verify aggregator was called
-    QVERIFY(mockAggregator->isCollecting());
-    QCOMPARE(mockAggregator->getCurrentTargetIp(), deviceId);
+    // Verify one report for the device
+    QTRY_COMPARE_WITH_TIMEOUT(metricsCollectedSpy.count(), 1, 2000);
+    QCOMPARE(metricsCollectedSpy.first().at(0).toString(), deviceId);
 
     // Verify no continuous monitoring was started
     QVERIFY(!controller->isMonitoring(deviceId));
@@ -401,25 +450,16 @@ void MetricsControllerTest::testSignal_MetricsCollected() {
     QString deviceId = "192.168.1.100";
     controller->collectMetricsOnce(deviceId);
 
-    // Wait for collection to start
-    QTest::qWait(100);
-
-    // Simulate metrics update from aggregator
-    NetworkMetrics testMetrics = createTestMetrics(10.5, 1.2, 0.0);
-    mockAggregator->simulateMetricsUpdate(testMetrics);
+    // Wait for the probes to be answered
+    QTRY_COMPARE_WITH_TIMEOUT(metricsCollectedSpy.count(), 1, 2000);
 
-    // Wait for signal processing
-    QTest::qWait(100);
-
-    // Verify metricsCollected signal was emitted
-    QCOMPARE(metricsCollectedSpy.count(), 1);
+    // Verify metricsCollected carries the device and its metrics
     QList<QVariant> arguments = metricsCollectedSpy.takeFirst();
     QCOMPARE(arguments.at(0).toString(), deviceId);
 
     NetworkMetrics collectedMetrics = arguments.at(1).value<NetworkMetrics>();
-    QCOMPARE(collectedMetrics.latencyAvg(), testMetrics.latencyAvg());
-    QCOMPARE(collectedMetrics.jitter(), testMetrics.jitter());
-    QCOMPARE(collectedMetrics.packetLoss(), testMetrics.packetLoss());
+    QCOMPARE(collectedMetrics.packetLoss(), 0.0);
+    QVERIFY(collectedMetrics.latencyAvg() >= 0.0);
 }
 
 void MetricsControllerTest::testSignal_MetricsError() {
@@ -438,6 +478,26 @@ void MetricsControllerTest::testSignal_MetricsError() {
     QVERIFY(!arguments.at(1).toString().isEmpty()); // Error message should not be empty
 }
 
+void MetricsControllerTest::testMetricsAttributedPerDevice() {
+    transport->silent.insert(QHostAddress("192.168.1.101").toIPv4Address());
+
+    QSignalSpy metricsCollectedSpy(controller, &MetricsController::metricsCollected);
+    controller->startContinuousMonitoring("192.168.1.100", 100);
+    controller->startContinuousMonitoring("192.168.1.101", 100);
+
+    QTRY_COMPARE_WITH_TIMEOUT(reportedDevices(metricsCollectedSpy).size(), 2, 2000);
+
+    // Each device gets its own metrics, never the other's
+    for (const QList<QVariant>& args : metricsCollectedSpy) {
+        NetworkMetrics metrics = args.at(1).value<NetworkMetrics>();
+        if (args.at(0).toString() == "192.168.1.100") {
+            QCOMPARE(metrics.packetLoss(), 0.0);
+        } else {
+            QCOMPARE(metrics.packetLoss(), 100.0);
+        }
+    }
+}
+
 // ============================================================================
 // Timer Tests
 // ============================================================================
@@ -475,16 +535,12 @@ Device MetricsControllerTest::createTestDevice(const QString& ip, const QString&
     return device;
 }
 
-NetworkMetrics MetricsControllerTest::createTestMetrics(double latency, double jitter, double packetLoss) {
-    NetworkMetrics metrics;
-    metrics.setLatencyAvg(latency);
-    metrics.setLatencyMin(latency - 2.0);
-    metrics.setLatencyMax(latency + 2.0);
-    metrics.setJitter(jitter);
-    metrics.setPacketLoss(packetLoss);
-    metrics.calculateQualityScore();
-    metrics.setTimestamp(QDateTime::currentDateTime());
-    return metrics;
+QSet<QString> MetricsControllerTest::reportedDevices(const QSignalSpy& spy) {
+    QSet<QString> ids;
+    for (const QList<QVariant>& args : spy) {
+        ids.insert(args.at(0).toString());
+    }
+    return ids;
 }
 
 QTEST_MAIN(MetricsControllerTest)
@@ -5,6 +5,7 @@
 #include "utils/Logger.h"
 #include <QTemporaryDir>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 
 class MetricsDaoTest : public QObject {
     Q_OBJECT
@@ -29,6 +30,8 @@ private slots:
     void testDeleteOlderThan();
     void testDeleteByDevice();
     void testGetMetricsCount();
+    void testGetLatencyHistogram();
+    void testLatencyHistogramColumnMigrated();
 
 private:
     DatabaseManager* dbManager;
@@ -302,5 +305,63 @@ void MetricsDaoTest::testGetMetricsCount() {
     QCOMPARE(device1Count, 1);
 }
 
+void MetricsDaoTest::testGetLatencyHistogram() {
+    QDateTime now = QDateTime::currentDateTime();
+    QString deviceId = "device-1";
+
+    // Three rows in range, each with the samples of its own interval
+    for (int row = 0; row < 3; ++row) {
+        LatencyHistogram histogram;
+        for (int i = 1; i <= 100; ++i) {
+            histogram.record(row * 100 + i);
+        }
+        NetworkMetrics metrics = createTestMetrics();
+        metrics.setTimestamp(now.addSecs(-row * 60));
+        QVERIFY(metricsDao->insert(deviceId, metrics, histogram));
+    }
+
+    // Out of range, no histogram, other device
+    LatencyHistogram old;
+    old.record(5000.0);
+    NetworkMetrics oldMetrics = createTestMetrics();
+    oldMetrics.setTimestamp(now.addDays(-2));
+    QVERIFY(metricsDao->insert(deviceId, oldMetrics, old));
+    QVERIFY(metricsDao->insert(deviceId, createTestMetrics()));
+    QVERIFY(metricsDao->insert("device-2", createTestMetrics(), old));
+
+    LatencyHistogram merged = metricsDao->getLatencyHistogram(deviceId, now.addDays(-1), now.addDays(1));
+    QCOMPARE(merged.totalCount(), quint64(300));
+    QCOMPARE(merged.min(), 1.0);
+    QCOMPARE(merged.max(), 300.0);
+    QVERIFY(qAbs(merged.percentile(50.0) - 150.0) <= 150.0 * 0.02);
+    QVERIFY(qAbs(merged.percentile(99.0) - 297.0) <= 297.0 * 0.02);
+
+    QVERIFY(metricsDao->getLatencyHistogram("device-3", now.addDays(-1), now.addDays(1)).isEmpty());
+}
+
+void MetricsDaoTest::testLatencyHistogramColumnMigrated() {
+    // A table from before histograms were stored
+    delete metricsDao;
+    QSqlQuery query(dbManager->database());
+    QVERIFY(query.exec("DROP TABLE metrics_history"));
+    QVERIFY(query.exec("CREATE TABLE metrics_history (id TEXT PRIMARY KEY, device_id TEXT NOT NULL, "
+                       "latency_min REAL, latency_avg REAL, latency_max REAL, latency_median REAL, "
+                       "latency_stddev REAL, jitter REAL, packet_loss REAL, packets_sent INTEGER, "
+                       "packets_received INTEGER, quality_score INTEGER, timestamp DATETIME NOT NULL)"));
+
+    metricsDao = new MetricsDao(dbManager);
+
+    LatencyHistogram histogram;
+    histogram.record(12.5);
+    NetworkMetrics metrics = createTestMetrics();
+    metrics.setTimestamp(QDateTime::currentDateTime());
+    QVERIFY(metricsDao->insert("device-1", metrics, histogram));
+
+    LatencyHistogram stored = metricsDao->getLatencyHistogram(
+        "device-1", QDateTime::currentDateTime().addDays(-1), QDateTime::currentDateTime().addDays(1));
+    QCOMPARE(stored.totalCount(), quint64(1));
+    QCOMPARE(stored.max(), 12.5);
+}
+
 QTEST_MAIN(MetricsDaoTest)
 #include "MetricsDaoTest.moc"
@@ -0,0 +1,189 @@
+#include <QtTest/QtTest>
+#include "database/ScanCheckpointDao.h"
+#include "database/DatabaseManager.h"
+#include "utils/Logger.h"
+#include <QTemporaryDir>
+#include <QJsonObject>
+
+class ScanCheckpointDaoTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testSaveAndFind();
+    void testSaveInvalid();
+    void testOverwrite();
+    void testResumable();
+    void testLatestResumable();
+    void testRemove();
+    void testDeleteCompletedBefore();
+
+private:
+    DatabaseManager* dbManager;
+    ScanCheckpointDao* checkpointDao;
+    QTemporaryDir* tempDir;
+    QString dbPath;
+
+    ScanCheckpoint createCheckpoint(const QString& id, quint64 completedIndex = 100,
+                                    const QString& status = ScanCheckpoint::STATUS_RUNNING);
+};
+
+void ScanCheckpointDaoTest::initTestCase() {
+    Logger::setLogLevel(Logger::ERROR);
+    tempDir = new QTemporaryDir();
+    QVERIFY(tempDir->isValid());
+}
+
+void ScanCheckpointDaoTest::cleanupTestCase() {
+    delete tempDir;
+}
+
+void ScanCheckpointDaoTest::init() {
+    dbPath = tempDir->path() + "/test_checkpoints.db";
+    QFile::remove(dbPath);
+
+    dbManager = DatabaseManager::instance();
+    QVERIFY(dbManager->open(dbPath));
+
+    checkpointDao = new ScanCheckpointDao(dbManager);
+}
+
+void ScanCheckpointDaoTest::cleanup() {
+    delete checkpointDao;
+    dbManager->close();
+    QFile::remove(dbPath);
+}
+
+ScanCheckpoint ScanCheckpointDaoTest::createCheckpoint(const QString& id, quint64 completedIndex,
+                                                       const QString& status) {
+    ScanCheckpoint checkpoint;
+    checkpoint.id = id;
+    checkpoint.targetSpec = "10.0.0.0/16";
+    checkpoint.orderSeed = 0xFEDCBA9876543210ULL;  // Above INT64_MAX
+    checkpoint.completedIndex = completedIndex;
+    checkpoint.totalHosts = 65534;
+    checkpoint.devicesFound = 12;
+    checkpoint.pendingHosts = QStringList() << "10.0.3.7" << "10.0.9.1";
+    checkpoint.status = status;
+    checkpoint.startedAt = QDateTime::currentDateTime().addSecs(-600);
+    checkpoint.updatedAt = QDateTime::currentDateTime();
+
+    QJsonObject config;
+    config["subnet"] = "10.0.0.0/16";
+    config["scanPorts"] = true;
+    checkpoint.config = config;
+    return checkpoint;
+}
+
+void ScanCheckpointDaoTest::testSaveAndFind() {
+    ScanCheckpoint checkpoint = createCheckpoint("scan-1");
+    QVERIFY(checkpointDao->save(checkpoint));
+
+    ScanCheckpoint found = checkpointDao->findById("scan-1");
+    QVERIFY(found.isValid());
+    QCOMPARE(found.targetSpec, checkpoint.targetSpec);
+    QCOMPARE(found.orderSeed, checkpoint.orderSeed);
+    QCOMPARE(found.completedIndex, checkpoint.completedIndex);
+    QCOMPARE(found.totalHosts, checkpoint.totalHosts);
+    QCOMPARE(found.devicesFound, 12);
+    QCOMPARE(found.pendingHosts, checkpoint.pendingHosts);
+    QCOMPARE(found.status, ScanCheckpoint::STATUS_RUNNING);
+    QCOMPARE(found.config.value("subnet").toString(), QString("10.0.0.0/16"));
+    QVERIFY(found.config.value("scanPorts").toBool());
+    QCOMPARE(found.startedAt, checkpoint.startedAt);
+    QCOMPARE(found.updatedAt, checkpoint.updatedAt);
+
+    QVERIFY(!checkpointDao->findById("missing").isValid());
+}
+
+void ScanCheckpointDaoTest::testSaveInvalid() {
+    ScanCheckpoint noId = createCheckpoint("");
+    QVERIFY(!checkpointDao->save(noId));
+
+    ScanCheckpoint noHosts = createCheckpoint("scan-1");
+    noHosts.totalHosts = 0;
+    QVERIFY(!checkpointDao->save(noHosts));
+}
+
+void ScanCheckpointDaoTest::testOverwrite() {
+    QVERIFY(checkpointDao->save(createCheckpoint("scan-1", 100)));
+    QVERIFY(checkpointDao->save(createCheckpoint("scan-1", 5000, ScanCheckpoint::STATUS_INTERRUPTED)));
+
+    ScanCheckpoint found = checkpointDao->findById("scan-1");
+    QCOMPARE(found.completedIndex, quint64(5000));
+    QCOMPARE(found.status, ScanCheckpoint::STATUS_INTERRUPTED);
+    QCOMPARE(checkpointDao->findResumable().size(), 1);
+}
+
+void ScanCheckpointDaoTest::testResumable() {
+    QVERIFY(checkpointDao->save(createCheckpoint("running", 100)));
+    QVERIFY(checkpointDao->save(createCheckpoint("interrupted", 200, ScanCheckpoint::STATUS_INTERRUPTED)));
+    QVERIFY(checkpointDao->save(createCheckpoint("completed", 65534, ScanCheckpoint::STATUS_COMPLETED)));
+
+    // Every position probed, but hosts still waiting for their port scans
+    ScanCheckpoint pendingOnly = createCheckpoint("pending-only", 65534, ScanCheckpoint::STATUS_INTERRUPTED);
+    QVERIFY(checkpointDao->save(pendingOnly));
+
+    // Nothing left to do
+    ScanCheckpoint done = createCheckpoint("done", 65534, ScanCheckpoint::STATUS_INTERRUPTED);
+    done.pendingHosts.clear();
+    QVERIFY(checkpointDao->save(done));
+
+    QStringList ids;
+    for (const ScanCheckpoint& checkpoint : checkpointDao->findResumable()) {
+        ids << checkpoint.id;
+    }
+    ids.sort();
+    QCOMPARE(ids, QStringList() << "interrupted" << "pending-only" << "running");
+}
+
+void ScanCheckpointDaoTest::testLatestResumable() {
+    QVERIFY(!checkpointDao->findLatestResumable().isValid());
+
+    ScanCheckpoint older = createCheckpoint("older", 100, ScanCheckpoint::STATUS_INTERRUPTED);
+    older.updatedAt = QDateTime::currentDateTime().addSecs(-3600);
+    QVERIFY(checkpointDao->save(older));
+
+    ScanCheckpoint newer = createCheckpoint("newer", 100, ScanCheckpoint::STATUS_INTERRUPTED);
+    QVERIFY(checkpointDao->save(newer));
+
+    ScanCheckpoint completed = createCheckpoint("completed", 65534, ScanCheckpoint::STATUS_COMPLETED);
+    completed.updatedAt = QDateTime::currentDateTime().addSecs(60);
+    QVERIFY(checkpointDao->save(completed));
+
+    QCOMPARE(checkpointDao->findLatestResumable().id, QString("newer"));
+}
+
+void ScanCheckpointDaoTest::testRemove() {
+    QVERIFY(checkpointDao->save(createCheckpoint("scan-1")));
+
+    QVERIFY(checkpointDao->remove("scan-1"));
+    QVERIFY(!checkpointDao->findById("scan-1").isValid());
+    QVERIFY(!checkpointDao->remove("scan-1"));
+}
+
+void ScanCheckpointDaoTest::testDeleteCompletedBefore() {
+    ScanCheckpoint oldCompleted = createCheckpoint("old-completed", 65534, ScanCheckpoint::STATUS_COMPLETED);
+    oldCompleted.updatedAt = QDateTime::currentDateTime().addDays(-40);
+    QVERIFY(checkpointDao->save(oldCompleted));
+
+    ScanCheckpoint oldInterrupted = createCheckpoint("old-interrupted", 100, ScanCheckpoint::STATUS_INTERRUPTED);
+    oldInterrupted.updatedAt = QDateTime::currentDateTime().addDays(-40);
+    QVERIFY(checkpointDao->save(oldInterrupted));
+
+    QVERIFY(checkpointDao->save(createCheckpoint("new-completed", 65534, ScanCheckpoint::STATUS_COMPLETED)));
+
+    int deleted = checkpointDao->deleteCompletedBefore(QDateTime::currentDateTime().addDays(-30));
+    QCOMPARE(deleted, 1);
+    QVERIFY(!checkpointDao->findById("old-completed").isValid());
+    QVERIFY(checkpointDao->findById("old-interrupted").isValid());
+    QVERIFY(checkpointDao->findById("new-completed").isValid());
+}
+
+QTEST_MAIN(ScanCheckpointDaoTest)
+#include "ScanCheckpointDaoTest.moc"
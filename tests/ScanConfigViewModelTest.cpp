@@ -2,6 +2,7 @@
 #include <QSignalSpy>
 #include "viewmodels/ScanConfigViewModel.h"
 #include "coordinators/ScanCoordinator.h"
+#include "managers/ProfileManager.h"
 
 /**
  * @brief Unit tests for ScanConfigViewModel
@@ -49,6 +50,7 @@ private slots:
     void testLoadDeepScanPreset();
     void testLoadCustomScanPreset();
     void testLoadPreset();
+    void testLoadProfile();
 
     // Signal emission tests
     void testSignal_SubnetChanged();
@@ -275,13 +277,11 @@ void ScanConfigViewModelTest::testLoadDeepScanPreset() {
     QVERIFY(viewModel->isResolveArp());
     QVERIFY(viewModel->isScanPorts());
     QCOMPARE(viewModel->getTimeout(), 3000);
-    QVERIFY(!viewModel->getPortsToScan().isEmpty());
 
-    // Verify common ports are included
-    QList<int> ports = viewModel->getPortsToScan();
-    QVERIFY(ports.contains(22));   // SSH
-    QVERIFY(ports.contains(80));   // HTTP
-    QVERIFY(ports.contains(443));  // HTTPS
+    // Frequency-ranked ports instead of a fixed list
+    QCOMPARE(viewModel->getTopPorts(), ScanCoordinator::DEEP_SCAN_TOP_PORTS);
+    QVERIFY(viewModel->getPortsToScan().isEmpty());
+    QCOMPARE(viewModel->toScanConfig().topPorts, ScanCoordinator::DEEP_SCAN_TOP_PORTS);
 }
 
 void ScanConfigViewModelTest::testLoadCustomScanPreset() {
@@ -312,6 +312,28 @@ void ScanConfigViewModelTest::testLoadPreset() {
     QCOMPARE(viewModel->getScanType(), ScanConfigViewModel::Custom);
 }
 
+void ScanConfigViewModelTest::testLoadProfile() {
+    ScanProfile profile;
+    profile.name = "Audit";
+    profile.subnet = "10.0.0.0/24";
+    profile.scanPorts = true;
+    profile.portsToScan = {8443};
+    profile.topPorts = 100;
+    profile.detectVersions = true;
+    profile.timeout = 5000;
+
+    viewModel->loadProfile(profile);
+    QCOMPARE(viewModel->getScanType(), ScanConfigViewModel::Custom);
+
+    ScanCoordinator::ScanConfig config = viewModel->toScanConfig();
+    QCOMPARE(config.subnet, QString("10.0.0.0/24"));
+    QVERIFY(config.scanPorts);
+    QCOMPARE(config.portsToScan, QList<int>({8443}));
+    QCOMPARE(config.topPorts, 100);
+    QVERIFY(config.detectVersions);
+    QCOMPARE(config.timeout, 5000);
+}
+
 // ============================================================================
 // Signal Emission Tests
 // ============================================================================
@@ -369,6 +391,8 @@ void ScanConfigViewModelTest::testToScanConfig() {
     viewModel->setResolveArp(false);
     viewModel->setScanPorts(true);
     viewModel->setPortsToScan({22, 80, 443});
+    viewModel->setTopPorts(50);
+    viewModel->setDetectVersions(true);
     viewModel->setTimeout(2000);
     viewModel->setThreadCount(8);
 
@@ -384,6 +408,8 @@ void ScanConfigViewModelTest::testToScanConfig() {
     QVERIFY(config.portsToScan.contains(22));
     QVERIFY(config.portsToScan.contains(80));
     QVERIFY(config.portsToScan.contains(443));
+    QCOMPARE(config.topPorts, 50);
+    QVERIFY(config.detectVersions);
     QCOMPARE(config.timeout, 2000);
     QCOMPARE(config.maxThreads, 8);
 }
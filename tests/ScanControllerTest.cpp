@@ -135,6 +135,7 @@ private slots:
     // Integration tests
     void testDevicePersistence();
     void testMultipleDeviceDiscovery();
+    void testPassiveObservationKeepsScanResults();
 
 private:
     ScanController* controller;
@@ -248,13 +249,11 @@ void ScanControllerTest::testExecuteDeepScan_Config() {
     QVERIFY(config.resolveDns);
     QVERIFY(config.resolveArp);
     QVERIFY(config.scanPorts);
-    QVERIFY(!config.portsToScan.isEmpty());  // Should have common ports
     QCOMPARE(config.timeout, 3000);  // Deep scan: 3 second timeout
 
-    // Verify common ports are included
-    QVERIFY(config.portsToScan.contains(22));   // SSH
-    QVERIFY(config.portsToScan.contains(80));   // HTTP
-    QVERIFY(config.portsToScan.contains(443));  // HTTPS
+    // Most frequently open ports rather than a fixed list
+    QCOMPARE(config.topPorts, ScanCoordinator::DEEP_SCAN_TOP_PORTS);
+    QVERIFY(config.portsToScan.isEmpty());
 }
 
 void ScanControllerTest::testExecuteCustomScan() {
@@ -558,6 +557,40 @@ void ScanControllerTest::testMultipleDeviceDiscovery() {
     QCOMPARE(cachedDevices.size(), 5);
 }
 
+void ScanControllerTest::testPassiveObservationKeepsScanResults() {
+    QSignalSpy deviceDiscoveredSpy(controller, &ScanController::deviceDiscovered);
+
+    // Found by an active scan: name and an open port
+    Device scanned = createTestDevice("192.168.1.120", "nas");
+    scanned.setMacAddress(QString());
+    scanned.addPort(PortInfo(445));
+    cache->put(scanned.getIp(), scanned);
+
+    // Seen in traffic: MAC only
+    Device observed;
+    observed.setIp(scanned.getIp());
+    observed.setMacAddress("00:11:22:33:44:66");
+    observed.setOnline(true);
+    observed.setLastSeen(QDateTime::currentDateTime());
+
+    QVERIFY(QMetaObject::invokeMethod(controller, "onDevicesObserved", Qt::DirectConnection,
+                                      Q_ARG(QList<Device>, QList<Device>{observed})));
+
+    Device cached = cache->get(scanned.getIp());
+    QCOMPARE(cached.getHostname(), QString("nas"));
+    QVERIFY(cached.hasPort(445));
+    QCOMPARE(cached.getMacAddress(), QString("00:11:22:33:44:66"));
+    QCOMPARE(deviceDiscoveredSpy.count(), 1);
+    QVERIFY(deviceDiscoveredSpy.first().at(0).value<Device>().hasPort(445));
+
+    // A later sighting with nothing new only refreshes last seen
+    observed.setLastSeen(observed.getLastSeen().addSecs(60));
+    QVERIFY(QMetaObject::invokeMethod(controller, "onDevicesObserved", Qt::DirectConnection,
+                                      Q_ARG(QList<Device>, QList<Device>{observed})));
+    QCOMPARE(deviceDiscoveredSpy.count(), 1);
+    QCOMPARE(cache->get(scanned.getIp()).getLastSeen(), observed.getLastSeen());
+}
+
 // ============================================================================
 // Helper Methods
 // ============================================================================
@@ -12,6 +12,7 @@ private slots:
     void testAddPort();
     void testRemovePort();
     void testHasPort();
+    void testIpv6Addresses();
 };
 
 void DeviceTest::testDefaultConstructor()
@@ -66,6 +67,12 @@ void DeviceTest::testAddPort()
     // Adding duplicate should not increase count
     device.addPort(port);
     QCOMPARE(device.openPorts().size(), 1);
+
+    // Same number over UDP is a different port
+    device.addPort(PortInfo(80, PortInfo::UDP));
+    QCOMPARE(device.openPorts().size(), 2);
+    QVERIFY(device.hasPort(80, PortInfo::UDP));
+    QVERIFY(!device.hasPort(443, PortInfo::UDP));
 }
 
 void DeviceTest::testRemovePort()
@@ -95,5 +102,26 @@ void DeviceTest::testHasPort()
     QVERIFY(device.hasPort(22));
 }
 
+void DeviceTest::testIpv6Addresses()
+{
+    Device device("192.168.1.20");
+    QVERIFY(device.ipv6Addresses().isEmpty());
+
+    device.addIpv6Address("2001:DB8::1");
+    device.addIpv6Address("fe80::211:22ff:fe33:4402%eth0");
+    QCOMPARE(device.ipv6Addresses().size(), 2);
+    QCOMPARE(device.ipv6Addresses().first(), QString("2001:db8::1"));
+
+    // Duplicates differ only in case; the zone keeps its case
+    device.addIpv6Address("2001:db8::1");
+    device.addIpv6Address("FE80::211:22FF:FE33:4402%eth0");
+    QCOMPARE(device.ipv6Addresses().size(), 2);
+    QVERIFY(device.hasIpv6Address("2001:Db8::1"));
+    QVERIFY(!device.hasIpv6Address("2001:db8::2"));
+
+    device.setIpv6Addresses(QStringList() << "fd00::2" << "FD00::2" << "");
+    QCOMPARE(device.getIpv6Addresses(), QStringList() << "fd00::2");
+}
+
 QTEST_MAIN(DeviceTest)
 #include "DeviceTest.moc"
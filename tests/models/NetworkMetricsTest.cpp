@@ -13,6 +13,7 @@ private slots:
     void testCalculateQualityScore_Fair();
     void testCalculateQualityScore_Poor();
     void testCalculateQualityScore_Critical();
+    void testCalculateQualityScore_WindowedJitter();
     void testQualityScoreString();
     void testIsValid();
 };
@@ -23,7 +24,10 @@ void NetworkMetricsTest::testDefaultConstructor()
     QCOMPARE(metrics.latencyMin(), 0.0);
     QCOMPARE(metrics.latencyAvg(), 0.0);
     QCOMPARE(metrics.latencyMax(), 0.0);
+    QCOMPARE(metrics.latencyP95(), 0.0);
+    QCOMPARE(metrics.latencyP99(), 0.0);
     QCOMPARE(metrics.jitter(), 0.0);
+    QCOMPARE(metrics.jitterWindowed(), 0.0);
     QCOMPARE(metrics.packetLoss(), 0.0);
     QCOMPARE(metrics.qualityScore(), NetworkMetrics::Critical);
 }
@@ -44,9 +48,22 @@ void NetworkMetricsTest::testSettersAndGetters()
     metrics.setLatencyMedian(9.5);
     QCOMPARE(metrics.latencyMedian(), 9.5);
 
+    metrics.setLatencyP95(14.0);
+    QCOMPARE(metrics.latencyP95(), 14.0);
+    QCOMPARE(metrics.getLatencyP95(), 14.0);
+
+    metrics.setLatencyP99(14.8);
+    QCOMPARE(metrics.latencyP99(), 14.8);
+    QCOMPARE(metrics.getLatencyP99(), 14.8);
+
     metrics.setJitter(1.0);
     QCOMPARE(metrics.jitter(), 1.0);
 
+    metrics.setJitterWindowed(1.4);
+    QCOMPARE(metrics.jitterWindowed(), 1.4);
+    QCOMPARE(metrics.getJitterWindowed(), 1.4);
+    QCOMPARE(metrics.scoringJitter(), 1.4);
+
     metrics.setPacketLoss(2.5);
     QCOMPARE(metrics.packetLoss(), 2.5);
 
@@ -110,6 +127,19 @@ void NetworkMetricsTest::testCalculateQualityScore_Critical()
     QCOMPARE(metrics.qualityScore(), NetworkMetrics::Critical);
 }
 
+void NetworkMetricsTest::testCalculateQualityScore_WindowedJitter()
+{
+    NetworkMetrics metrics;
+    metrics.setLatencyAvg(15.0);
+    metrics.setJitter(1.5);
+    metrics.setJitterWindowed(8.0);
+    metrics.setPacketLoss(3.0);
+    metrics.calculateQualityScore();
+
+    // Scored on the window mean while the RFC 3550 estimate catches up
+    QCOMPARE(metrics.qualityScore(), NetworkMetrics::Fair);
+}
+
 void NetworkMetricsTest::testQualityScoreString()
 {
     NetworkMetrics metrics;
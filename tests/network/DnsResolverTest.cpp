@@ -1,4 +1,5 @@
 #include <QtTest>
+#include <QSemaphore>
 #include "network/discovery/DnsResolver.h"
 
 class DnsResolverTest : public QObject
@@ -13,6 +14,7 @@ private slots:
     void testResolveInvalidIp();
     void testResolveSyncLocalhost();
     void testResolveSyncTimeout();
+    void testResolveAsyncMatchesSync();
     void testSignalEmission();
 
 private:
@@ -86,6 +88,25 @@ void DnsResolverTest::testResolveSyncTimeout()
     Q_UNUSED(hostname);
 }
 
+void DnsResolverTest::testResolveAsyncMatchesSync()
+{
+    QString expected = m_resolver->resolveSync("127.0.0.1", 5000);
+
+    // Served from the cache the sync lookup filled, or looked up again
+    QSemaphore done;
+    QString hostname;
+    int calls = 0;
+    m_resolver->resolveAsync("127.0.0.1", 5000, 1, [&](const QString& name) {
+        hostname = name;
+        calls++;
+        done.release();
+    });
+
+    QVERIFY(done.tryAcquire(1, 20000));
+    QCOMPARE(calls, 1);
+    QCOMPARE(hostname, expected);
+}
+
 void DnsResolverTest::testSignalEmission()
 {
     // Verify signal parameters
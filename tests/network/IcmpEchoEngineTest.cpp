@@ -0,0 +1,238 @@
+#include <QtTest>
+#include <QHostAddress>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <cstring>
+#include "network/sockets/IcmpEchoEngine.h"
+#include "network/sockets/RateController.h"
+
+/**
+ * In-process responder: answers echo requests for scripted addresses
+ * after a configurable delay, without touching the network.
+ */
+class ScriptedIcmpTransport : public IcmpTransport
+{
+public:
+    QHash<quint32, int> replyDelayMs;   ///< Responding address -> reply delay
+    bool corruptIdentifier = false;      ///< Reply with a foreign identifier
+    int sentCount = 0;
+
+    ScriptedIcmpTransport() { m_clock.start(); }
+
+    bool open() override { return true; }
+    void close() override {}
+    quint16 identifier() const override { return 0x4242; }
+    QString name() const override { return "scripted responder"; }
+
+    bool send(quint32 address, const quint8* data, int length) override
+    {
+        QMutexLocker locker(&m_mutex);
+        sentCount++;
+
+        if (!replyDelayMs.contains(address)) {
+            return true;
+        }
+
+        Reply reply;
+        reply.due = m_clock.elapsed() + replyDelayMs.value(address);
+        reply.address = address;
+        reply.data = QByteArray(reinterpret_cast<const char*>(data), length);
+        reply.data[0] = 0;  // Echo reply
+        if (corruptIdentifier) {
+            reply.data[4] = 0x13;
+        }
+
+        int pos = 0;
+        while (pos < m_queue.size() && m_queue[pos].due <= reply.due) {
+            ++pos;
+        }
+        m_queue.insert(pos, reply);
+        m_ready.wakeAll();
+        return true;
+    }
+
+    int receive(quint32& address, quint8* buffer, int capacity, int& ttl, int timeoutMs) override
+    {
+        QMutexLocker locker(&m_mutex);
+        qint64 deadline = m_clock.elapsed() + timeoutMs;
+
+        while (true) {
+            qint64 now = m_clock.elapsed();
+            if (!m_queue.isEmpty() && m_queue.first().due <= now) {
+                Reply reply = m_queue.takeFirst();
+                int length = qMin(capacity, static_cast<int>(reply.data.size()));
+                std::memcpy(buffer, reply.data.constData(), length);
+                address = reply.address;
+                ttl = 64;
+                return length;
+            }
+            if (now >= deadline) {
+                return 0;
+            }
+
+            qint64 wake = deadline;
+            if (!m_queue.isEmpty()) {
+                wake = qMin(wake, m_queue.first().due);
+            }
+            m_ready.wait(&m_mutex, static_cast<unsigned long>(qMax<qint64>(1, wake - now)));
+        }
+    }
+
+private:
+    struct Reply {
+        qint64 due;
+        quint32 address;
+        QByteArray data;
+    };
+
+    QMutex m_mutex;
+    QWaitCondition m_ready;
+    QElapsedTimer m_clock;
+    QList<Reply> m_queue;
+};
+
+class IcmpEchoEngineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testScriptedBatch();
+    void testTimeout();
+    void testIgnoresForeignIdentifier();
+    void testCancel();
+    void testUnpacedBypassesRateController();
+    void testLoopbackRange();
+
+private:
+    static quint32 address(const QString& ip) { return QHostAddress(ip).toIPv4Address(); }
+};
+
+void IcmpEchoEngineTest::testScriptedBatch()
+{
+    ScriptedIcmpTransport* transport = new ScriptedIcmpTransport();
+    QVector<quint32> targets;
+    for (int i = 1; i <= 10; ++i) {
+        quint32 target = address(QString("10.0.0.%1").arg(i));
+        targets.append(target);
+        if (i % 2 == 0) {
+            transport->replyDelayMs.insert(target, i * 5);
+        }
+    }
+
+    IcmpEchoEngine engine(transport);
+    QVERIFY(engine.isAvailable());
+
+    QVector<IcmpEchoEngine::EchoResult> results = engine.echoBatch(targets, 500);
+    QCOMPARE(results.size(), 10);
+
+    for (int i = 0; i < results.size(); ++i) {
+        QCOMPARE(results[i].address, targets[i]);
+        QCOMPARE(results[i].success, (i + 1) % 2 == 0);
+        if (results[i].success) {
+            QVERIFY(results[i].latency >= 0.0);
+            QCOMPARE(results[i].ttl, 64);
+        }
+    }
+
+    QCOMPARE(transport->sentCount, 10);
+    QCOMPARE(engine.pendingCount(), 0);
+}
+
+void IcmpEchoEngineTest::testTimeout()
+{
+    IcmpEchoEngine engine(new ScriptedIcmpTransport());
+
+    QElapsedTimer timer;
+    timer.start();
+    IcmpEchoEngine::EchoResult result = engine.echo(address("10.0.0.99"), 200);
+
+    QVERIFY(!result.success);
+    QVERIFY(timer.elapsed() >= 190);
+    QVERIFY(timer.elapsed() < 1000);
+}
+
+void IcmpEchoEngineTest::testIgnoresForeignIdentifier()
+{
+    ScriptedIcmpTransport* transport = new ScriptedIcmpTransport();
+    transport->replyDelayMs.insert(address("10.0.0.1"), 1);
+    transport->corruptIdentifier = true;
+
+    IcmpEchoEngine engine(transport);
+    QVERIFY(!engine.echo(address("10.0.0.1"), 150).success);
+}
+
+void IcmpEchoEngineTest::testCancel()
+{
+    ScriptedIcmpTransport* transport = new ScriptedIcmpTransport();
+    transport->replyDelayMs.insert(address("10.0.0.1"), 100);
+
+    IcmpEchoEngine engine(transport);
+    QAtomicInt callbacks(0);
+    int owner = 0;
+
+    engine.submit(address("10.0.0.1"), 500, [&](const IcmpEchoEngine::EchoResult&) {
+        callbacks.fetchAndAddRelaxed(1);
+    }, &owner);
+    QCOMPARE(engine.pendingCount(), 1);
+
+    engine.cancel(&owner);
+    QCOMPARE(engine.pendingCount(), 0);
+
+    QTest::qWait(200);
+    QCOMPARE(callbacks.loadRelaxed(), 0);
+}
+
+void IcmpEchoEngineTest::testUnpacedBypassesRateController()
+{
+    ScriptedIcmpTransport* transport = new ScriptedIcmpTransport();
+    QVector<quint32> targets;
+    for (int i = 1; i <= 10; ++i) {
+        targets.append(address(QString("10.0.1.%1").arg(i)));
+        transport->replyDelayMs.insert(targets.last(), 1);
+    }
+
+    IcmpEchoEngine engine(transport);
+    RateController* rate = RateController::instance();
+    rate->setTargetRate(20.0);
+
+    // Monitoring probes go out at once whatever the scan budget is
+    QElapsedTimer timer;
+    timer.start();
+    QVector<IcmpEchoEngine::EchoResult> results =
+        engine.echoBatch(targets, 500, IcmpEchoEngine::Unpaced);
+    qint64 unpacedMs = timer.elapsed();
+    for (const IcmpEchoEngine::EchoResult& result : results) {
+        QVERIFY(result.success);
+    }
+    QVERIFY2(unpacedMs < 250, qPrintable(QString::number(unpacedMs)));
+
+    // Scan probes wait for tokens at 20 per second
+    timer.restart();
+    engine.echoBatch(targets, 500);
+    QVERIFY2(timer.elapsed() >= 300, qPrintable(QString::number(timer.elapsed())));
+
+    rate->setTargetRate(0.0);
+}
+
+void IcmpEchoEngineTest::testLoopbackRange()
+{
+    IcmpEchoEngine* engine = IcmpEchoEngine::instance();
+    if (!engine->isAvailable()) {
+        QSKIP("No ICMP socket permission (check net.ipv4.ping_group_range)");
+    }
+
+    QVector<quint32> targets;
+    for (int i = 1; i <= 8; ++i) {
+        targets.append(address(QString("127.0.0.%1").arg(i)));
+    }
+
+    QVector<IcmpEchoEngine::EchoResult> results = engine->echoBatch(targets, 1000);
+    for (const IcmpEchoEngine::EchoResult& result : results) {
+        QVERIFY(result.success);
+        QVERIFY(result.latency >= 0.0);
+    }
+}
+
+QTEST_MAIN(IcmpEchoEngineTest)
+#include "IcmpEchoEngineTest.moc"
@@ -0,0 +1,85 @@
+#include <QtTest>
+#include <QBitArray>
+#include "network/services/IndexPermutation.h"
+
+class IndexPermutationTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testBijection_data();
+    void testBijection();
+    void testReproducible();
+    void testSeedChangesOrder();
+    void testResumeFromIndex();
+};
+
+void IndexPermutationTest::testBijection_data()
+{
+    QTest::addColumn<quint64>("size");
+
+    QTest::newRow("empty") << quint64(0);
+    QTest::newRow("single") << quint64(1);
+    QTest::newRow("two") << quint64(2);
+    QTest::newRow("/24") << quint64(254);
+    QTest::newRow("odd") << quint64(1000003);
+}
+
+void IndexPermutationTest::testBijection()
+{
+    QFETCH(quint64, size);
+
+    IndexPermutation permutation(size, 42);
+    QBitArray seen(static_cast<int>(size));
+
+    for (quint64 i = 0; i < size; ++i) {
+        quint64 value = permutation.map(i);
+        QVERIFY(value < size);
+        QVERIFY(!seen.testBit(static_cast<int>(value)));
+        seen.setBit(static_cast<int>(value));
+    }
+}
+
+void IndexPermutationTest::testReproducible()
+{
+    IndexPermutation first(65534, 1234);
+    IndexPermutation second(65534, 1234);
+
+    for (quint64 i = 0; i < 65534; i += 97) {
+        QCOMPARE(first.map(i), second.map(i));
+    }
+}
+
+void IndexPermutationTest::testSeedChangesOrder()
+{
+    IndexPermutation first(254, 1);
+    IndexPermutation second(254, 2);
+
+    int sequential = 0;
+    int different = 0;
+    for (quint64 i = 0; i < 254; ++i) {
+        different += first.map(i) != second.map(i) ? 1 : 0;
+        sequential += (i > 0 && first.map(i) == first.map(i - 1) + 1) ? 1 : 0;
+    }
+
+    QVERIFY(different > 200);
+    QVERIFY(sequential < 20);
+}
+
+void IndexPermutationTest::testResumeFromIndex()
+{
+    // Resuming is just mapping the remaining positions again
+    IndexPermutation full(5000, 99);
+    QList<quint64> order;
+    for (quint64 i = 0; i < 5000; ++i) {
+        order.append(full.map(i));
+    }
+
+    IndexPermutation resumed(5000, 99);
+    for (quint64 i = 3210; i < 5000; ++i) {
+        QCOMPARE(resumed.map(i), order.at(static_cast<int>(i)));
+    }
+}
+
+QTEST_MAIN(IndexPermutationTest)
+#include "IndexPermutationTest.moc"
@@ -1,11 +1,57 @@
 #include <QtTest>
+#include <QMutex>
+#include <QSet>
+#include <QThread>
 #include "network/scanner/IpScanner.h"
 #include "network/scanner/QuickScanStrategy.h"
 #include "network/scanner/DeepScanStrategy.h"
+#include "network/scanner/ScanScheduler.h"
 
 // Register Device type for Qt signals/slots
 Q_DECLARE_METATYPE(Device)
 
+// Instant strategy: every host with an even last octet is online
+class StubScanStrategy : public IScanStrategy
+{
+public:
+    QAtomicInt calls;
+
+    Device scan(const QString& ip) override
+    {
+        calls.fetchAndAddRelaxed(1);
+        Device device;
+        device.setIp(ip);
+        device.setOnline(ip.section('.', 3, 3).toInt() % 2 == 0);
+        return device;
+    }
+
+    QString getName() const override { return "Stub"; }
+    QString getDescription() const override { return "Test strategy"; }
+};
+
+// Slow strategy that records every address it probes
+class RecordingScanStrategy : public IScanStrategy
+{
+public:
+    QMutex mutex;
+    QSet<QString> probed;
+    QAtomicInt calls;
+
+    Device scan(const QString& ip) override
+    {
+        calls.fetchAndAddRelaxed(1);
+        QThread::msleep(2);
+        QMutexLocker locker(&mutex);
+        probed.insert(ip);
+        Device device;
+        device.setIp(ip);
+        return device;
+    }
+
+    QString getName() const override { return "Recording"; }
+    QString getDescription() const override { return "Test strategy"; }
+};
+
 class IpScannerTest : public QObject
 {
     Q_OBJECT
@@ -17,6 +63,9 @@ private slots:
     void testSetStrategy();
     void testQuickScanStrategy();
     void testDeepScanStrategy();
+    void testBatchedDelivery();
+    void testCompletedIndexResume();
+    void testPauseResume();
 
 private:
     IpScanner* m_scanner;
@@ -80,5 +129,109 @@ void IpScannerTest::testDeepScanStrategy()
     // Just verify the scan completed without crashing
 }
 
+void IpScannerTest::testBatchedDelivery()
+{
+    StubScanStrategy strategy;
+    IpScanner scanner;
+    scanner.setScanStrategy(&strategy);
+
+    int batches = 0;
+    int devices = 0;
+    int progressUpdates = 0;
+    int lastProgress = 0;
+
+    connect(&scanner, &IpScanner::devicesDiscovered, this, [&](const QVector<Device>& batch) {
+        batches++;
+        devices += batch.size();
+    });
+    connect(&scanner, &IpScanner::scanProgress, this, [&](int current, int) {
+        progressUpdates++;
+        lastProgress = current;
+    });
+
+    QSignalSpy finishedSpy(&scanner, &IpScanner::scanFinished);
+    scanner.startScan("10.10.0.0/22");
+    QVERIFY(finishedSpy.wait(10000));
+
+    // 1022 usable hosts, 511 with an even last octet
+    QCOMPARE(strategy.calls.loadRelaxed(), 1022);
+    QCOMPARE(devices, 511);
+    QCOMPARE(finishedSpy.first().first().toInt(), 511);
+    QCOMPARE(lastProgress, 1022);
+
+    // Deliveries are per chunk, not per host
+    QVERIFY(batches < 511);
+    QVERIFY(progressUpdates < 1022);
+    QVERIFY(!scanner.isScanning());
+}
+
+void IpScannerTest::testCompletedIndexResume()
+{
+    const quint64 seed = 0x5EED;
+    RecordingScanStrategy first;
+    IpScanner scanner;
+    scanner.setScanStrategy(&first);
+    scanner.setRandomOrder(true, seed);
+
+    QSignalSpy finishedSpy(&scanner, &IpScanner::scanFinished);
+    scanner.startScan("10.20.0.0/24");
+    QTRY_VERIFY_WITH_TIMEOUT(scanner.getProgress() >= 64, 10000);
+    scanner.stopScan();
+
+    // The cursor never passes a position that was not probed
+    quint64 cursor = scanner.completedIndex();
+    QVERIFY(cursor > 0);
+    QVERIFY(cursor <= static_cast<quint64>(scanner.getProgress()));
+    QVERIFY(cursor < 254);
+
+    // Resuming with the same order covers everything the first run left out
+    RecordingScanStrategy second;
+    scanner.setScanStrategy(&second);
+    scanner.setStartIndex(cursor);
+    finishedSpy.clear();
+    scanner.startScan("10.20.0.0/24");
+    QVERIFY(finishedSpy.wait(10000));
+    QCOMPARE(scanner.completedIndex(), quint64(254));
+
+    QSet<QString> covered = first.probed;
+    covered.unite(second.probed);
+    QCOMPARE(covered.size(), 254);
+    QCOMPARE(second.probed.size(), 254 - static_cast<int>(cursor));
+}
+
+void IpScannerTest::testPauseResume()
+{
+    ScanScheduler scheduler;
+    int job = scheduler.registerJob(ScanScheduler::Normal);
+
+    RecordingScanStrategy strategy;
+    IpScanner scanner;
+    scanner.setScanStrategy(&strategy);
+    scanner.setScheduler(&scheduler, job);
+
+    QSignalSpy finishedSpy(&scanner, &IpScanner::scanFinished);
+    scanner.startScan("10.30.0.0/24");
+    QTRY_VERIFY_WITH_TIMEOUT(strategy.calls.loadAcquire() >= 32, 10000);
+
+    // Probes in flight finish, then nothing new is issued
+    scheduler.pause(job);
+    QTest::qWait(50);
+    int issued = strategy.calls.loadAcquire();
+    QTest::qWait(200);
+    QCOMPARE(strategy.calls.loadAcquire(), issued);
+    QVERIFY(issued < 254);
+    QVERIFY(scanner.isScanning());
+
+    // Everything probed before the pause is delivered while paused
+    QTRY_COMPARE_WITH_TIMEOUT(scanner.getProgress(), issued, 2000);
+
+    // Each worker continues at its own position: no gaps, no repeats
+    scheduler.resume(job);
+    QVERIFY(finishedSpy.wait(10000));
+    QCOMPARE(strategy.calls.loadAcquire(), 254);
+    QCOMPARE(strategy.probed.size(), 254);
+    QCOMPARE(scanner.completedIndex(), quint64(254));
+}
+
 QTEST_MAIN(IpScannerTest)
 #include "IpScannerTest.moc"
@@ -0,0 +1,141 @@
+#include <QtTest>
+#include <QHostAddress>
+#include "network/discovery/Ipv6Discovery.h"
+
+class Ipv6DiscoveryTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEchoPacket();
+    void testEui64InterfaceId();
+    void testEui64Address();
+    void testEui64Candidates();
+    void testLoopbackEcho();
+    void testCandidateEcho();
+};
+
+void Ipv6DiscoveryTest::testEchoPacket()
+{
+    QByteArray request = Ipv6Discovery::echoRequest(0x1234, 7);
+    QVERIFY(request.size() >= 8);
+    QCOMPARE(static_cast<quint8>(request[0]), quint8(128));
+    QCOMPARE(static_cast<quint8>(request[4]), quint8(0x12));
+    QCOMPARE(static_cast<quint8>(request[5]), quint8(0x34));
+    QCOMPARE(static_cast<quint8>(request[7]), quint8(7));
+
+    // Turn it into the matching reply
+    QByteArray reply = request;
+    reply[0] = static_cast<char>(129);
+    const quint8* data = reinterpret_cast<const quint8*>(reply.constData());
+
+    quint16 sequence = 0;
+    QVERIFY(Ipv6Discovery::parseEchoReply(data, reply.size(), 0x1234, &sequence));
+    QCOMPARE(sequence, quint16(7));
+    QVERIFY(Ipv6Discovery::parseEchoReply(data, reply.size(), 0, &sequence));
+    QVERIFY(!Ipv6Discovery::parseEchoReply(data, reply.size(), 0x4321, &sequence));
+    QVERIFY(!Ipv6Discovery::parseEchoReply(data, 7, 0x1234, &sequence));
+
+    // A request is not a reply
+    QVERIFY(!Ipv6Discovery::parseEchoReply(reinterpret_cast<const quint8*>(request.constData()),
+                                           request.size(), 0, &sequence));
+}
+
+void Ipv6DiscoveryTest::testEui64InterfaceId()
+{
+    // RFC 4291 appendix A: U/L bit inverted, FFFE inserted
+    QCOMPARE(Ipv6Discovery::eui64InterfaceId("00:11:22:33:44:55"), QByteArray::fromHex("021122fffe334455"));
+    QCOMPARE(Ipv6Discovery::eui64InterfaceId("02-11-22-33-44-55"), QByteArray::fromHex("001122fffe334455"));
+    QCOMPARE(Ipv6Discovery::eui64InterfaceId("aabb.ccdd.eeff"), QByteArray::fromHex("a8bbccfffeddeeff"));
+
+    QVERIFY(Ipv6Discovery::eui64InterfaceId("").isEmpty());
+    QVERIFY(Ipv6Discovery::eui64InterfaceId("00:11:22:33:44").isEmpty());
+    QVERIFY(Ipv6Discovery::eui64InterfaceId("00:11:22:33:44:5g").isEmpty());
+    QVERIFY(Ipv6Discovery::eui64InterfaceId("00 11 22 33 44 55").isEmpty());
+}
+
+void Ipv6DiscoveryTest::testEui64Address()
+{
+    QByteArray linkLocal = QByteArray::fromHex("fe80000000000000");
+    QCOMPARE(Ipv6Discovery::eui64Address(linkLocal, "00:11:22:33:44:08"),
+             QString("fe80::211:22ff:fe33:4408"));
+
+    QByteArray global = QByteArray::fromHex("20010db800010002");
+    QCOMPARE(Ipv6Discovery::eui64Address(global, "00:11:22:33:44:08"),
+             QString("2001:db8:1:2:211:22ff:fe33:4408"));
+
+    QVERIFY(Ipv6Discovery::eui64Address(QByteArray::fromHex("fe80"), "00:11:22:33:44:08").isEmpty());
+    QVERIFY(Ipv6Discovery::eui64Address(linkLocal, "not a mac").isEmpty());
+}
+
+void Ipv6DiscoveryTest::testEui64Candidates()
+{
+    // Depends on the host's interfaces: every candidate must carry the interface identifier
+    QStringList candidates = Ipv6Discovery::eui64Candidates(QStringList() << "00:11:22:33:44:08" << "bogus");
+    for (const QString& candidate : candidates) {
+        QHostAddress address(candidate);
+        QVERIFY2(!address.isNull(), qPrintable(candidate));
+        QVERIFY(candidate.section('%', 0, 0).endsWith("211:22ff:fe33:4408"));
+        if (address.isLinkLocal()) {
+            QVERIFY(!address.scopeId().isEmpty());
+        }
+    }
+
+    QVERIFY(Ipv6Discovery::eui64Candidates(QStringList(), QString()).isEmpty());
+    QVERIFY(Ipv6Discovery::eui64Candidates(QStringList() << "00:11:22:33:44:08", "lanscan-none0").isEmpty());
+}
+
+void Ipv6DiscoveryTest::testLoopbackEcho()
+{
+    if (!Ipv6Discovery::isSupported()) {
+        QSKIP("Ipv6Discovery is not supported on this platform");
+    }
+
+    Ipv6Discovery discovery;
+    discovery.setMulticastDestination("::1");
+    discovery.setUseNeighborTable(false);
+
+    QList<Ipv6Discovery::Host> hosts = discovery.discover(300);
+    if (discovery.transportName().isEmpty()) {
+        QSKIP("No ICMPv6 socket available (needs ping_group_range or CAP_NET_RAW)");
+    }
+    if (hosts.isEmpty()) {
+        QSKIP("Loopback does not answer ICMPv6 echo (IPv6 disabled?)");
+    }
+
+    QCOMPARE(hosts.size(), 1);
+    QCOMPARE(hosts.first().address, QString("::1"));
+    QCOMPARE(hosts.first().sources, int(Ipv6Discovery::Echo));
+    QVERIFY(hosts.first().latencyMs >= 0.0);
+    QVERIFY(hosts.first().mac.isEmpty());
+}
+
+void Ipv6DiscoveryTest::testCandidateEcho()
+{
+    if (!Ipv6Discovery::isSupported()) {
+        QSKIP("Ipv6Discovery is not supported on this platform");
+    }
+
+    // Unicast candidates only; the invalid one is skipped without ending the pass
+    Ipv6Discovery discovery;
+    discovery.setMulticastDestination(QString());
+    discovery.setUseNeighborTable(false);
+    discovery.setCandidates(QStringList() << "not-an-address" << "::1" << "fe80::1%lanscan-none0");
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<Ipv6Discovery::Host> hosts = discovery.discover(300);
+    if (discovery.transportName().isEmpty()) {
+        QSKIP("No ICMPv6 socket available (needs ping_group_range or CAP_NET_RAW)");
+    }
+    if (hosts.isEmpty()) {
+        QSKIP("Loopback does not answer ICMPv6 echo (IPv6 disabled?)");
+    }
+
+    QCOMPARE(hosts.size(), 1);
+    QCOMPARE(hosts.first().address, QString("::1"));
+    QVERIFY(timer.elapsed() < 5000);
+}
+
+QTEST_MAIN(Ipv6DiscoveryTest)
+#include "Ipv6DiscoveryTest.moc"
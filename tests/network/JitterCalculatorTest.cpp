@@ -1,5 +1,6 @@
 #include <QtTest>
 #include "network/diagnostics/JitterCalculator.h"
+#include "utils/StreamingStatistics.h"
 
 class JitterCalculatorTest : public QObject
 {
@@ -8,6 +9,8 @@ class JitterCalculatorTest : public QObject
 private slots:
     void testCalculateJitter();
     void testCalculateConsecutiveJitter();
+    void testCalculateFollowsRfc3550();
+    void testCalculateWindowedJitter();
     void testEmptyVector();
     void testSingleValue();
     void testConstantValues();
@@ -37,6 +40,37 @@ void JitterCalculatorTest::testCalculateConsecutiveJitter()
     QCOMPARE(jitter, 4.5);
 }
 
+void JitterCalculatorTest::testCalculateFollowsRfc3550()
+{
+    JitterCalculator calc;
+    QVector<double> values = {10.0, 15.0, 12.0, 18.0, 14.0};
+
+    // J += (|D| - J) / 16 for |D| = 5, 3, 6, 4, starting at 0
+    double expected = 0.0;
+    for (double difference : {5.0, 3.0, 6.0, 4.0}) {
+        expected += (difference - expected) / 16.0;
+    }
+
+    QCOMPARE(calc.calculate(values), expected);
+}
+
+void JitterCalculatorTest::testCalculateWindowedJitter()
+{
+    JitterCalculator calc;
+
+    // Fewer pairs than the window: same as consecutive jitter
+    QVector<double> values = {10.0, 15.0, 12.0, 18.0, 14.0};
+    QCOMPARE(calc.calculateWindowedJitter(values), 4.5);
+
+    // Only the last WINDOW differences count
+    QVector<double> stepped = {0.0, 100.0};
+    for (int i = 0; i < InterarrivalJitter::WINDOW; ++i) {
+        stepped.append(i % 2 == 0 ? 101.0 : 100.0);
+    }
+    QCOMPARE(calc.calculateWindowedJitter(stepped), 1.0);
+    QVERIFY(calc.calculateConsecutiveJitter(stepped) > 1.0);
+}
+
 void JitterCalculatorTest::testEmptyVector()
 {
     JitterCalculator calc;
@@ -76,12 +110,16 @@ void JitterCalculatorTest::testConstantValues()
 void JitterCalculatorTest::testHighVariability()
 {
     JitterCalculator calc;
-    QVector<double> values = {10.0, 50.0, 10.0, 50.0, 10.0};
+    QVector<double> values;
+    for (int i = 0; i < 50; ++i) {
+        values.append(i % 2 == 0 ? 10.0 : 50.0);
+    }
 
     double jitter = calc.calculate(values);
 
-    // High variability should result in high jitter
+    // High variability should result in high jitter (converging to |D| = 40)
     QVERIFY(jitter > 15.0);
+    QVERIFY(jitter < 40.0);
 }
 
 QTEST_MAIN(JitterCalculatorTest)
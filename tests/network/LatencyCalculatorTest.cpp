@@ -13,6 +13,7 @@ private slots:
     void testCalculateMedian_Odd();
     void testCalculateMedian_Even();
     void testCalculateStdDev();
+    void testCalculatePercentiles();
     void testEmptyVector();
     void testSingleValue();
 };
@@ -87,6 +88,24 @@ void LatencyCalculatorTest::testCalculateStdDev()
     QVERIFY(qAbs(stats.stdDev - 2.0) < 0.1);
 }
 
+void LatencyCalculatorTest::testCalculatePercentiles()
+{
+    LatencyCalculator calc;
+    QVector<double> values;
+    for (int i = 100; i >= 1; --i) {
+        values.append(i);
+    }
+
+    LatencyCalculator::LatencyStats stats = calc.calculateStats(values);
+
+    // Nearest rank; the median stays the interpolated middle
+    QCOMPARE(stats.p95, 95.0);
+    QCOMPARE(stats.p99, 99.0);
+    QCOMPARE(stats.median, 50.5);
+    QCOMPARE(stats.min, 1.0);
+    QCOMPARE(stats.max, 100.0);
+}
+
 void LatencyCalculatorTest::testEmptyVector()
 {
     LatencyCalculator calc;
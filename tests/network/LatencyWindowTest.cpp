@@ -0,0 +1,187 @@
+#include <QtTest>
+#include <cmath>
+#include "network/diagnostics/LatencyWindow.h"
+
+class LatencyWindowTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEmptyWindow();
+    void testStatistics();
+    void testLostProbes();
+    void testEvictionUpdatesStatistics();
+    void testPercentiles();
+    void testJitterSkipsLostProbes();
+    void testClear();
+
+private:
+    static PingService::PingResult reply(double latency);
+    static PingService::PingResult lost();
+};
+
+PingService::PingResult LatencyWindowTest::reply(double latency)
+{
+    PingService::PingResult result;
+    result.host = "10.0.0.1";
+    result.latency = latency;
+    result.success = true;
+    return result;
+}
+
+PingService::PingResult LatencyWindowTest::lost()
+{
+    PingService::PingResult result;
+    result.host = "10.0.0.1";
+    result.success = false;
+    return result;
+}
+
+void LatencyWindowTest::testEmptyWindow()
+{
+    LatencyWindow window;
+    QCOMPARE(window.count(), 0);
+    QCOMPARE(window.replies(), 0);
+    QCOMPARE(window.packetLoss(), 0.0);
+    QCOMPARE(window.min(), 0.0);
+    QCOMPARE(window.median(), 0.0);
+    QCOMPARE(window.p95(), 0.0);
+}
+
+void LatencyWindowTest::testStatistics()
+{
+    LatencyWindow window;
+    for (double latency : {30.0, 10.0, 50.0, 20.0, 40.0}) {
+        window.add(reply(latency));
+    }
+
+    QCOMPARE(window.count(), 5);
+    QCOMPARE(window.replies(), 5);
+    QCOMPARE(window.min(), 10.0);
+    QCOMPARE(window.max(), 50.0);
+    QCOMPARE(window.mean(), 30.0);
+    QCOMPARE(window.median(), 30.0);
+    QVERIFY(qAbs(window.stdDev() - std::sqrt(250.0)) < 1e-9);
+
+    window.add(reply(60.0));
+    QCOMPARE(window.median(), 35.0);
+}
+
+void LatencyWindowTest::testLostProbes()
+{
+    LatencyWindow window;
+    window.add(reply(10.0));
+    window.add(lost());
+    window.add(reply(20.0));
+    window.add(lost());
+
+    QCOMPARE(window.count(), 4);
+    QCOMPARE(window.replies(), 2);
+    QCOMPARE(window.packetLoss(), 50.0);
+    QCOMPARE(window.mean(), 15.0);
+
+    // A zero latency counts as lost, as in MetricsAggregator::aggregate()
+    window.add(reply(0.0));
+    QCOMPARE(window.replies(), 2);
+    QCOMPARE(window.packetLoss(), 60.0);
+}
+
+void LatencyWindowTest::testEvictionUpdatesStatistics()
+{
+    LatencyWindow window;
+    window.add(reply(100.0));
+    window.add(lost());
+    for (int i = 0; i < LatencyWindow::SIZE - 2; ++i) {
+        window.add(reply(10.0 + i));
+    }
+    QCOMPARE(window.count(), LatencyWindow::SIZE);
+    QCOMPARE(window.max(), 100.0);
+    QCOMPARE(window.packetLoss(), 10.0);
+
+    // The 100 ms reply leaves, then the lost probe
+    window.add(reply(5.0));
+    QCOMPARE(window.count(), LatencyWindow::SIZE);
+    QCOMPARE(window.max(), 17.0);
+    QCOMPARE(window.min(), 5.0);
+    QCOMPARE(window.packetLoss(), 10.0);
+
+    window.add(reply(6.0));
+    QCOMPARE(window.packetLoss(), 0.0);
+    QCOMPARE(window.replies(), LatencyWindow::SIZE);
+
+    // Window is now 10..17, 5, 6
+    double sum = 5.0 + 6.0;
+    for (int i = 0; i < LatencyWindow::SIZE - 2; ++i) {
+        sum += 10.0 + i;
+    }
+    QVERIFY(qAbs(window.mean() - sum / LatencyWindow::SIZE) < 1e-9);
+    QCOMPARE(window.median(), (12.0 + 13.0) / 2.0);
+}
+
+void LatencyWindowTest::testPercentiles()
+{
+    LatencyWindow window;
+    for (int round = 0; round < 50; ++round) {
+        for (int i = 1; i <= 100; ++i) {
+            window.add(reply(i));
+        }
+    }
+
+    // Estimated over every reply, not just the window
+    QVERIFY2(qAbs(window.lifetimeP95() - 95.0) < 3.0, qPrintable(QString::number(window.lifetimeP95())));
+    QVERIFY2(qAbs(window.lifetimeP99() - 99.0) < 3.0, qPrintable(QString::number(window.lifetimeP99())));
+
+    // Nearest rank over the last SIZE replies (91..100), like the batch path
+    QCOMPARE(window.p95(), 100.0);
+    window.add(reply(1.0));
+    window.add(lost());
+
+    // Window is now 93..100, 1 and a loss: 9 replies sorted 1, 93, ..., 100.
+    // p95 rank ceil(0.95 * 9) = 9 and p99 rank ceil(0.99 * 9) = 9, the 9th reply: 100
+    QCOMPARE(window.p95(), 100.0);
+    QCOMPARE(window.p99(), 100.0);
+    for (int i = 0; i < LatencyWindow::SIZE; ++i) {
+        window.add(reply(5.0 + i));
+    }
+    QCOMPARE(window.p95(), 14.0);
+    QCOMPARE(window.p99(), 14.0);
+}
+
+void LatencyWindowTest::testJitterSkipsLostProbes()
+{
+    LatencyWindow window;
+    window.add(reply(10.0));
+    window.add(lost());
+    window.add(reply(14.0));    // |D| = 4 across the lost probe
+    window.add(reply(11.0));    // |D| = 3
+
+    double expected = 4.0 / 16.0;
+    expected += (3.0 - expected) / 16.0;
+    QCOMPARE(window.jitter(), expected);
+    QCOMPARE(window.windowedJitter(), 3.5);
+
+    // Kept across window evictions, like the lifetime percentiles
+    for (int i = 0; i < LatencyWindow::SIZE * 5; ++i) {
+        window.add(reply(i % 2 == 0 ? 10.0 : 20.0));
+    }
+    QVERIFY(window.jitter() > 5.0);
+    QCOMPARE(window.windowedJitter(), 10.0);
+}
+
+void LatencyWindowTest::testClear()
+{
+    LatencyWindow window;
+    window.add(reply(10.0));
+    window.add(lost());
+    window.clear();
+
+    QCOMPARE(window.count(), 0);
+    QCOMPARE(window.replies(), 0);
+    QCOMPARE(window.mean(), 0.0);
+    QCOMPARE(window.max(), 0.0);
+    QCOMPARE(window.p99(), 0.0);
+    QCOMPARE(window.jitter(), 0.0);
+}
+
+QTEST_MAIN(LatencyWindowTest)
+#include "LatencyWindowTest.moc"
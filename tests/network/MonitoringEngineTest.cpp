@@ -0,0 +1,275 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QHostAddress>
+#include <QMutex>
+#include <QSet>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <cstring>
+#include "network/diagnostics/MonitoringEngine.h"
+#include "network/diagnostics/ProbeScheduler.h"
+#include "network/diagnostics/MetricsAggregator.h"
+#include "network/diagnostics/LatencyCalculator.h"
+#include "network/diagnostics/JitterCalculator.h"
+#include "network/diagnostics/PacketLossCalculator.h"
+#include "network/diagnostics/QualityScoreCalculator.h"
+#include "network/sockets/IcmpEchoEngine.h"
+
+/**
+ * In-process responder: answers echo requests for the responding
+ * addresses at once, stays silent for the rest.
+ */
+class InstantIcmpTransport : public IcmpTransport
+{
+public:
+    QSet<quint32> responding;
+
+    bool open() override { return true; }
+    void close() override {}
+    quint16 identifier() const override { return 0x5151; }
+    QString name() const override { return "instant responder"; }
+
+    bool send(quint32 address, const quint8* data, int length) override
+    {
+        QMutexLocker locker(&m_mutex);
+        m_sent++;
+        if (responding.contains(address)) {
+            QByteArray reply(reinterpret_cast<const char*>(data), length);
+            reply[0] = 0;  // Echo reply
+            m_queue.append(qMakePair(address, reply));
+            m_ready.wakeAll();
+        }
+        return true;
+    }
+
+    int receive(quint32& address, quint8* buffer, int capacity, int& ttl, int timeoutMs) override
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_queue.isEmpty()) {
+            m_ready.wait(&m_mutex, static_cast<unsigned long>(timeoutMs));
+        }
+        if (m_queue.isEmpty()) {
+            return 0;
+        }
+
+        auto reply = m_queue.takeFirst();
+        int length = qMin(capacity, static_cast<int>(reply.second.size()));
+        std::memcpy(buffer, reply.second.constData(), length);
+        address = reply.first;
+        ttl = 64;
+        return length;
+    }
+
+    int sentCount()
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_sent;
+    }
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_ready;
+    QList<QPair<quint32, QByteArray>> m_queue;
+    int m_sent = 0;
+};
+
+class MonitoringEngineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testMetricsPerTarget();
+    void testRemoveTarget();
+    void testReAddedTargetIgnoresOldReplies();
+    void testProbeOnce();
+    void testInvalidAddress();
+    void testManyTargets();
+    void testLatencyHistogram();
+
+private:
+    LatencyCalculator latencyCalc;
+    JitterCalculator jitterCalc;
+    PacketLossCalculator lossCalc;
+    QualityScoreCalculator qualityCalc;
+    MetricsAggregator* aggregator = nullptr;
+    InstantIcmpTransport* transport = nullptr;
+    IcmpEchoEngine* echo = nullptr;
+    ProbeScheduler* scheduler = nullptr;
+    MonitoringEngine* engine = nullptr;
+
+    static quint32 address(const QString& ip) { return QHostAddress(ip).toIPv4Address(); }
+};
+
+void MonitoringEngineTest::init()
+{
+    aggregator = new MetricsAggregator(&latencyCalc, &jitterCalc, &lossCalc, &qualityCalc);
+    transport = new InstantIcmpTransport();
+    echo = new IcmpEchoEngine(transport);
+    scheduler = new ProbeScheduler();
+    engine = new MonitoringEngine(aggregator, echo, scheduler);
+}
+
+void MonitoringEngineTest::cleanup()
+{
+    delete engine;
+    delete scheduler;
+    delete echo;    // Owns the transport
+    delete aggregator;
+}
+
+void MonitoringEngineTest::testMetricsPerTarget()
+{
+    transport->responding.insert(address("10.0.0.1"));
+
+    QSignalSpy spy(engine, &MonitoringEngine::metricsUpdated);
+    QVERIFY(engine->addTarget("10.0.0.1", 100));
+    QVERIFY(engine->addTarget("10.0.0.2", 100));
+    QCOMPARE(engine->targetCount(), 2);
+    QCOMPARE(engine->intervalMs("10.0.0.1"), 100);
+    QVERIFY(!engine->addTarget("10.0.0.1", 100));
+
+    // The silent target reports once its probes expire
+    QTRY_VERIFY_WITH_TIMEOUT(engine->latestMetrics("10.0.0.2").packetLoss() > 0.0, 2000);
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() >= 6, 2000);
+
+    // Each device's metrics reflect its own replies only
+    for (const QList<QVariant>& args : spy) {
+        QString deviceId = args.at(0).toString();
+        NetworkMetrics metrics = args.at(1).value<NetworkMetrics>();
+        if (deviceId == "10.0.0.1") {
+            QCOMPARE(metrics.packetLoss(), 0.0);
+        } else {
+            QCOMPARE(deviceId, QString("10.0.0.2"));
+            QCOMPARE(metrics.packetLoss(), 100.0);
+        }
+    }
+}
+
+void MonitoringEngineTest::testRemoveTarget()
+{
+    transport->responding.insert(address("10.0.0.1"));
+    QVERIFY(engine->addTarget("10.0.0.1", 100));
+
+    QSignalSpy spy(engine, &MonitoringEngine::metricsUpdated);
+    QTRY_VERIFY_WITH_TIMEOUT(spy.count() > 0, 1000);
+
+    engine->removeTarget("10.0.0.1");
+    QVERIFY(!engine->hasTarget("10.0.0.1"));
+    QCOMPARE(engine->targetCount(), 0);
+
+    // Replies in flight are dropped, nothing new is sent
+    QTest::qWait(50);
+    int sent = transport->sentCount();
+    spy.clear();
+    QTest::qWait(300);
+    QCOMPARE(transport->sentCount(), sent);
+    QCOMPARE(spy.count(), 0);
+}
+
+void MonitoringEngineTest::testReAddedTargetIgnoresOldReplies()
+{
+    // The first session's probe goes unanswered and times out after 1 s
+    QVERIFY(engine->addTarget("10.0.0.1", 1000));
+    QTRY_VERIFY_WITH_TIMEOUT(transport->sentCount() >= 1, 1000);
+
+    QSignalSpy spy(engine, &MonitoringEngine::metricsUpdated);
+    engine->removeTarget("10.0.0.1");
+    transport->responding.insert(address("10.0.0.1"));
+    QVERIFY(engine->addTarget("10.0.0.1", 1000));
+
+    // The new session only ever sees its own replies, not the old timeout
+    QTest::qWait(1600);
+    QVERIFY(spy.count() > 0);
+    for (const QList<QVariant>& args : spy) {
+        QCOMPARE(args.at(1).value<NetworkMetrics>().packetLoss(), 0.0);
+    }
+    QCOMPARE(engine->latestMetrics("10.0.0.1").packetLoss(), 0.0);
+}
+
+void MonitoringEngineTest::testProbeOnce()
+{
+    transport->responding.insert(address("10.0.0.7"));
+
+    QSignalSpy spy(engine, &MonitoringEngine::metricsUpdated);
+    QVERIFY(engine->probeOnce("10.0.0.7"));
+    QVERIFY(!engine->hasTarget("10.0.0.7"));
+
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, 2000);
+    QCOMPARE(spy.first().at(0).toString(), QString("10.0.0.7"));
+    QCOMPARE(spy.first().at(1).value<NetworkMetrics>().packetLoss(), 0.0);
+    QCOMPARE(transport->sentCount(), MonitoringEngine::ONE_SHOT_PROBES);
+
+    // Reported exactly once
+    QTest::qWait(100);
+    QCOMPARE(spy.count(), 1);
+    QTRY_COMPARE_WITH_TIMEOUT(engine->outstandingProbes(), 0, 1000);
+}
+
+void MonitoringEngineTest::testInvalidAddress()
+{
+    QSignalSpy errors(engine, &MonitoringEngine::errorOccurred);
+    QVERIFY(!engine->addTarget("not-an-address"));
+    QVERIFY(!engine->addTarget("fe80::1"));
+    QVERIFY(!engine->probeOnce(""));
+    QCOMPARE(engine->targetCount(), 0);
+    QCOMPARE(errors.count(), 2);
+}
+
+void MonitoringEngineTest::testManyTargets()
+{
+    const int count = 5000;
+    for (int i = 0; i < count; ++i) {
+        quint32 target = address("10.1.0.0") + static_cast<quint32>(i);
+        if (i % 2 == 0) {
+            transport->responding.insert(target);
+        }
+    }
+
+    QSet<QString> reported;
+    connect(engine, &MonitoringEngine::metricsUpdated, this,
+            [&reported](const QString& deviceId, const NetworkMetrics&) { reported.insert(deviceId); });
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        QVERIFY(engine->addTarget(QHostAddress(address("10.1.0.0") + static_cast<quint32>(i)).toString(), 1000));
+    }
+    QVERIFY(timer.elapsed() < 1000);
+
+    // Every target reports within a couple of intervals; the event loop keeps turning
+    QTRY_VERIFY_WITH_TIMEOUT(reported.size() == count, 5000);
+
+    timer.restart();
+    engine->removeAllTargets();
+    QVERIFY(timer.elapsed() < 100);
+    QCOMPARE(engine->targetCount(), 0);
+}
+
+void MonitoringEngineTest::testLatencyHistogram()
+{
+    transport->responding.insert(address("10.0.0.1"));
+    QVERIFY(engine->addTarget("10.0.0.1", 50));
+    QVERIFY(engine->addTarget("10.0.0.2", 50));
+
+    QTRY_VERIFY_WITH_TIMEOUT(engine->latencyHistogram("10.0.0.1").totalCount() >= 3, 2000);
+
+    // Taking resets only the untaken part; the running distribution keeps everything
+    LatencyHistogram taken = engine->takeLatencyHistogram("10.0.0.1");
+    QVERIFY(taken.totalCount() >= 3);
+    QTRY_VERIFY_WITH_TIMEOUT(engine->latencyHistogram("10.0.0.1").totalCount() >= taken.totalCount() + 2, 2000);
+
+    quint64 total = engine->latencyHistogram("10.0.0.1").totalCount();
+    LatencyHistogram next = engine->takeLatencyHistogram("10.0.0.1");
+    QVERIFY(next.totalCount() >= 2);
+    QCOMPARE(taken.totalCount() + next.totalCount(), total);   // Replies are folded in on this thread
+
+    // Lost probes are not latencies
+    QVERIFY(engine->latencyHistogram("10.0.0.2").isEmpty());
+    QVERIFY(engine->takeLatencyHistogram("10.0.0.3").isEmpty());
+}
+
+QTEST_MAIN(MonitoringEngineTest)
+#include "MonitoringEngineTest.moc"
@@ -0,0 +1,243 @@
+#include <QtTest>
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include "network/discovery/NameDiscovery.h"
+#include "network/discovery/PtrResolver.h"
+
+class NameDiscoveryTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testQueries();
+    void testParseMdns();
+    void testParseLlmnr();
+    void testParseNodeStatus();
+    void testDiscoveryOverLoopback();
+
+private:
+    static quint32 host(int last) { return (127u << 24) | static_cast<quint32>(last); }
+
+    static void appendU16(QByteArray& data, int value)
+    {
+        data.append(static_cast<char>((value >> 8) & 0xFF));
+        data.append(static_cast<char>(value & 0xFF));
+    }
+
+    static QByteArray name(const QString& dotted)
+    {
+        QByteArray out;
+        for (const QString& label : dotted.split('.', Qt::SkipEmptyParts)) {
+            out.append(static_cast<char>(label.size()));
+            out.append(label.toLatin1());
+        }
+        out.append('\0');
+        return out;
+    }
+
+    static QByteArray record(const QString& owner, int type, const QByteArray& rdata)
+    {
+        QByteArray out = name(owner);
+        appendU16(out, type);
+        appendU16(out, 1);
+        out.append("\x00\x00\x00\x78", 4);
+        appendU16(out, rdata.size());
+        return out + rdata;
+    }
+
+    static QByteArray response(quint16 id, const QByteArray& question, const QList<QByteArray>& answers)
+    {
+        QByteArray out;
+        appendU16(out, id);
+        appendU16(out, 0x8400);
+        appendU16(out, question.isEmpty() ? 0 : 1);
+        appendU16(out, answers.size());
+        appendU16(out, 0);
+        appendU16(out, 0);
+        out.append(question);
+        for (const QByteArray& answer : answers) {
+            out.append(answer);
+        }
+        return out;
+    }
+
+    static QByteArray nodeStatusResponse(const QList<QPair<QByteArray, int>>& names)
+    {
+        QByteArray rdata;
+        rdata.append(static_cast<char>(names.size()));
+        for (const auto& entry : names) {
+            QByteArray padded = entry.first.leftJustified(15, ' ', true);
+            rdata.append(padded);
+            rdata.append('\0');                                 // Workstation suffix
+            appendU16(rdata, entry.second);                     // Name flags
+        }
+        rdata.append(QByteArray(46, '\0'));                     // Statistics
+
+        QByteArray answer;
+        answer.append('\x20');
+        answer.append("CK");
+        answer.append(QByteArray(30, 'A'));
+        answer.append('\0');
+        appendU16(answer, 0x21);
+        appendU16(answer, 1);
+        answer.append("\x00\x00\x00\x00", 4);
+        appendU16(answer, rdata.size());
+        answer.append(rdata);
+        return response(0x4C53, QByteArray(), QList<QByteArray>() << answer);
+    }
+};
+
+void NameDiscoveryTest::testQueries()
+{
+    QByteArray nbstat = NameDiscovery::nodeStatusQuery(7);
+    QCOMPARE(nbstat.size(), 50);
+    QVERIFY(nbstat.contains("CKAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA"));
+    QCOMPARE(nbstat.right(4), QByteArray::fromHex("00210001"));
+
+    // LLMNR: DNS reverse query with no flags at all (RD would be the T bit)
+    QByteArray llmnr = NameDiscovery::llmnrQuery(0x1234, host(5));
+    QCOMPARE(llmnr.mid(0, 4), QByteArray::fromHex("12340000"));
+    QVERIFY(llmnr.contains(name("5.0.0.127.in-addr.arpa")));
+
+    // mDNS: service enumeration plus one reverse question per address
+    QByteArray mdns = NameDiscovery::mdnsQuery(QVector<quint32>() << host(1) << host(2), true);
+    QCOMPARE(static_cast<int>(static_cast<quint8>(mdns[5])), 3);
+    QVERIFY(mdns.contains(name("_services._dns-sd._udp.local")));
+    QVERIFY(mdns.contains(name("2.0.0.127.in-addr.arpa")));
+
+    // A full chunk of 32 reverse questions fits a single packet
+    QVector<quint32> chunk;
+    for (int i = 0; i < 32; ++i) {
+        chunk.append(0xC0A80AC8 + i);             // 192.168.10.200+: longest reverse names
+    }
+    QVERIFY(NameDiscovery::mdnsQuery(chunk, true).size() < 1200);
+}
+
+void NameDiscoveryTest::testParseMdns()
+{
+    QByteArray packet = response(0, QByteArray(), QList<QByteArray>()
+        << record("_services._dns-sd._udp.local", 12, name("_ipp._tcp.local"))
+        << record("10.1.168.192.in-addr.arpa", 12, name("printer.local"))
+        << record("nas.local", 1, QByteArray::fromHex("C0A8010B")));
+
+    bool services = false;
+    QList<NameDiscovery::NameResult> results = NameDiscovery::parseMdns(
+        reinterpret_cast<const quint8*>(packet.constData()), packet.size(), &services);
+
+    QVERIFY(services);
+    QCOMPARE(results.size(), 2);
+    QCOMPARE(results[0].address, quint32(0xC0A8010A));
+    QCOMPARE(results[0].hostname, QString("printer.local"));
+    QCOMPARE(results[0].source, NameDiscovery::Mdns);
+    QCOMPARE(results[1].address, quint32(0xC0A8010B));
+    QCOMPARE(results[1].hostname, QString("nas.local"));
+
+    // Queries and truncated packets yield nothing
+    QByteArray query = NameDiscovery::mdnsQuery(QVector<quint32>() << host(1), true);
+    QVERIFY(NameDiscovery::parseMdns(reinterpret_cast<const quint8*>(query.constData()), query.size()).isEmpty());
+    QVERIFY(NameDiscovery::parseMdns(reinterpret_cast<const quint8*>(packet.constData()), 20).isEmpty());
+}
+
+void NameDiscoveryTest::testParseLlmnr()
+{
+    QByteArray question = name("7.0.0.127.in-addr.arpa") + QByteArray::fromHex("000c0001");
+    QByteArray packet = response(1, question, QList<QByteArray>()
+        << record("7.0.0.127.in-addr.arpa", 12, name("DESKTOP-7")));
+    const quint8* data = reinterpret_cast<const quint8*>(packet.constData());
+
+    QCOMPARE(NameDiscovery::parseLlmnr(data, packet.size(), host(7)), QString("DESKTOP-7"));
+
+    // The answer must be for the address that sent it
+    QVERIFY(NameDiscovery::parseLlmnr(data, packet.size(), host(8)).isEmpty());
+}
+
+void NameDiscoveryTest::testParseNodeStatus()
+{
+    QByteArray packet = nodeStatusResponse(QList<QPair<QByteArray, int>>()
+        << qMakePair(QByteArray("WORKGROUP"), 0x8400)           // Group name comes first
+        << qMakePair(QByteArray("FILESERVER"), 0x0400));
+    QCOMPARE(NameDiscovery::parseNodeStatus(reinterpret_cast<const quint8*>(packet.constData()), packet.size()),
+             QString("FILESERVER"));
+
+    QByteArray groupsOnly = nodeStatusResponse(QList<QPair<QByteArray, int>>()
+        << qMakePair(QByteArray("WORKGROUP"), 0x8400));
+    QVERIFY(NameDiscovery::parseNodeStatus(reinterpret_cast<const quint8*>(groupsOnly.constData()),
+                                           groupsOnly.size()).isEmpty());
+
+    QVERIFY(NameDiscovery::parseNodeStatus(reinterpret_cast<const quint8*>(packet.constData()), 30).isEmpty());
+}
+
+void NameDiscoveryTest::testDiscoveryOverLoopback()
+{
+    if (!NameDiscovery::isSupported()) {
+        QSKIP("NameDiscovery is not supported on this platform");
+    }
+
+    // 127.0.0.1 speaks mDNS, 127.0.0.2 NetBIOS, 127.0.0.3 LLMNR and NetBIOS, 127.0.0.4 nothing
+    QUdpSocket mdns;
+    QVERIFY(mdns.bind(QHostAddress(host(1)), 0));
+    connect(&mdns, &QUdpSocket::readyRead, [&]() {
+        while (mdns.hasPendingDatagrams()) {
+            QNetworkDatagram datagram = mdns.receiveDatagram();
+            mdns.writeDatagram(datagram.makeReply(response(0, QByteArray(), QList<QByteArray>()
+                << record("1.0.0.127.in-addr.arpa", 12, name("printer.local")))));
+        }
+    });
+
+    QUdpSocket netbios2;
+    QVERIFY(netbios2.bind(QHostAddress(host(2)), 0));
+    quint16 netbiosPort = netbios2.localPort();
+    QUdpSocket netbios3;
+    if (!netbios3.bind(QHostAddress(host(3)), netbiosPort)) {
+        QSKIP("Cannot bind the same port on 127.0.0.2 and 127.0.0.3");
+    }
+    auto answerNodeStatus = [](QUdpSocket* socket, const QByteArray& workstation) {
+        QObject::connect(socket, &QUdpSocket::readyRead, [socket, workstation]() {
+            while (socket->hasPendingDatagrams()) {
+                QNetworkDatagram datagram = socket->receiveDatagram();
+                socket->writeDatagram(datagram.makeReply(nodeStatusResponse(
+                    QList<QPair<QByteArray, int>>() << qMakePair(workstation, 0x0400))));
+            }
+        });
+    };
+    answerNodeStatus(&netbios2, "OFFICE-PC");
+    answerNodeStatus(&netbios3, "LAPTOP3");
+
+    QUdpSocket llmnr;
+    QVERIFY(llmnr.bind(QHostAddress(host(3)), 0));
+    connect(&llmnr, &QUdpSocket::readyRead, [&]() {
+        while (llmnr.hasPendingDatagrams()) {
+            QNetworkDatagram datagram = llmnr.receiveDatagram();
+            QByteArray query = datagram.data();
+            quint16 id = static_cast<quint16>((static_cast<quint8>(query[0]) << 8) | static_cast<quint8>(query[1]));
+            QByteArray question = query.mid(12);
+            llmnr.writeDatagram(datagram.makeReply(response(id, question, QList<QByteArray>()
+                << record("3.0.0.127.in-addr.arpa", 12, name("laptop3.corp.example")))));
+        }
+    });
+
+    NameDiscovery discovery;
+    discovery.setMdnsDestination(host(1), mdns.localPort());
+    discovery.setUnicastPorts(llmnr.localPort(), netbiosPort);
+
+    QVERIFY(discovery.start(QVector<quint32>() << host(1) << host(2) << host(3) << host(4), 300));
+    QVERIFY(discovery.isRunning());
+
+    QElapsedTimer timer;
+    timer.start();
+    while (discovery.isRunning() && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    QVERIFY(discovery.wait(1000));
+
+    QCOMPARE(discovery.hostname(host(1)), QString("printer.local"));
+    QCOMPARE(discovery.hostname(host(2)), QString("OFFICE-PC"));
+    QCOMPARE(discovery.hostname(host(3)), QString("laptop3.corp.example"));     // LLMNR beats NetBIOS
+    QVERIFY(discovery.hostname(host(4)).isEmpty());
+    QCOMPARE(discovery.names().size(), 3);
+}
+
+QTEST_MAIN(NameDiscoveryTest)
+#include "NameDiscoveryTest.moc"
@@ -0,0 +1,191 @@
+#include <QtTest>
+#include <QHostAddress>
+#include <QNetworkInterface>
+#include <cstring>
+#include "network/discovery/NeighborTable.h"
+
+#ifdef Q_OS_LINUX
+    #include <linux/netlink.h>
+    #include <linux/rtnetlink.h>
+    #include <linux/neighbour.h>
+    #include <arpa/inet.h>
+#endif
+
+class NeighborTableTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testParseProcNetArp();
+    void testParseNeighborDump();
+    void testParseNeighborDump6();
+    void testSnapshotRefresh();
+
+private:
+    static quint32 address(const QString& ip) { return QHostAddress(ip).toIPv4Address(); }
+
+#ifdef Q_OS_LINUX
+    static void appendNeighbor(QByteArray& buffer, const QString& ip, const quint8* mac, quint16 state);
+    static void appendNeighbor6(QByteArray& buffer, const QString& ip, const quint8* mac, quint16 state,
+                                int ifindex);
+#endif
+};
+
+void NeighborTableTest::testParseProcNetArp()
+{
+    QByteArray content =
+        "IP address       HW type     Flags       HW address            Mask     Device\n"
+        "192.168.1.1      0x1         0x2         aa:bb:cc:dd:ee:ff     *        eth0\n"
+        "192.168.1.20     0x1         0x0         00:00:00:00:00:00     *        eth0\n"
+        "192.168.1.30     0x1         0x6         00:11:22:33:44:55     *        eth0\n"
+        "garbage line\n";
+
+    QHash<quint32, QString> table = NeighborTable::parseProcNetArp(content);
+
+    QCOMPARE(table.size(), 2);
+    QCOMPARE(table.value(address("192.168.1.1")), QString("AA:BB:CC:DD:EE:FF"));
+    QCOMPARE(table.value(address("192.168.1.30")), QString("00:11:22:33:44:55"));
+    QVERIFY(!table.contains(address("192.168.1.20")));
+}
+
+#ifdef Q_OS_LINUX
+void NeighborTableTest::appendNeighbor(QByteArray& buffer, const QString& ip, const quint8* mac, quint16 state)
+{
+    int payload = NLMSG_ALIGN(sizeof(ndmsg)) + RTA_SPACE(4) + RTA_SPACE(6);
+    QByteArray message(NLMSG_SPACE(payload), '\0');
+
+    nlmsghdr* header = reinterpret_cast<nlmsghdr*>(message.data());
+    header->nlmsg_len = NLMSG_LENGTH(payload);
+    header->nlmsg_type = RTM_NEWNEIGH;
+
+    ndmsg* neighbor = static_cast<ndmsg*>(NLMSG_DATA(header));
+    neighbor->ndm_family = AF_INET;
+    neighbor->ndm_state = state;
+
+    rtattr* attribute = reinterpret_cast<rtattr*>(reinterpret_cast<char*>(neighbor) + NLMSG_ALIGN(sizeof(ndmsg)));
+    attribute->rta_type = NDA_DST;
+    attribute->rta_len = RTA_LENGTH(4);
+    quint32 networkOrder = htonl(address(ip));
+    std::memcpy(RTA_DATA(attribute), &networkOrder, 4);
+
+    attribute = reinterpret_cast<rtattr*>(reinterpret_cast<char*>(attribute) + RTA_SPACE(4));
+    attribute->rta_type = NDA_LLADDR;
+    attribute->rta_len = RTA_LENGTH(6);
+    std::memcpy(RTA_DATA(attribute), mac, 6);
+
+    buffer.append(message);
+}
+
+void NeighborTableTest::appendNeighbor6(QByteArray& buffer, const QString& ip, const quint8* mac, quint16 state,
+                                        int ifindex)
+{
+    int payload = NLMSG_ALIGN(sizeof(ndmsg)) + RTA_SPACE(16) + RTA_SPACE(6);
+    QByteArray message(NLMSG_SPACE(payload), '\0');
+
+    nlmsghdr* header = reinterpret_cast<nlmsghdr*>(message.data());
+    header->nlmsg_len = NLMSG_LENGTH(payload);
+    header->nlmsg_type = RTM_NEWNEIGH;
+
+    ndmsg* neighbor = static_cast<ndmsg*>(NLMSG_DATA(header));
+    neighbor->ndm_family = AF_INET6;
+    neighbor->ndm_state = state;
+    neighbor->ndm_ifindex = ifindex;
+
+    rtattr* attribute = reinterpret_cast<rtattr*>(reinterpret_cast<char*>(neighbor) + NLMSG_ALIGN(sizeof(ndmsg)));
+    attribute->rta_type = NDA_DST;
+    attribute->rta_len = RTA_LENGTH(16);
+    Q_IPV6ADDR bytes = QHostAddress(ip).toIPv6Address();
+    std::memcpy(RTA_DATA(attribute), bytes.c, 16);
+
+    attribute = reinterpret_cast<rtattr*>(reinterpret_cast<char*>(attribute) + RTA_SPACE(16));
+    attribute->rta_type = NDA_LLADDR;
+    attribute->rta_len = RTA_LENGTH(6);
+    std::memcpy(RTA_DATA(attribute), mac, 6);
+
+    buffer.append(message);
+}
+#endif
+
+void NeighborTableTest::testParseNeighborDump()
+{
+#ifdef Q_OS_LINUX
+    const quint8 reachable[6] = { 0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5e };
+    const quint8 failed[6] = { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11 };
+
+    QByteArray buffer;
+    appendNeighbor(buffer, "10.0.0.1", reachable, NUD_REACHABLE);
+    appendNeighbor(buffer, "10.0.0.2", failed, NUD_FAILED);
+
+    QHash<quint32, QString> table;
+    QCOMPARE(NeighborTable::parseNeighborDump(buffer.constData(), buffer.size(), table), 1);
+    QCOMPARE(table.size(), 1);
+    QCOMPARE(table.value(address("10.0.0.1")), QString("00:1A:2B:3C:4D:5E"));
+
+    QByteArray done(NLMSG_SPACE(sizeof(int)), '\0');
+    nlmsghdr* header = reinterpret_cast<nlmsghdr*>(done.data());
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(int));
+    header->nlmsg_type = NLMSG_DONE;
+    QCOMPARE(NeighborTable::parseNeighborDump(done.constData(), done.size(), table), 0);
+#else
+    QSKIP("rtnetlink is Linux only");
+#endif
+}
+
+void NeighborTableTest::testParseNeighborDump6()
+{
+#ifdef Q_OS_LINUX
+    const quint8 host[6] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x02 };
+    const quint8 router[6] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0xfe };
+    const quint8 multicast[6] = { 0x33, 0x33, 0x00, 0x00, 0x00, 0x01 };
+
+    QString loopback = QNetworkInterface::interfaceNameFromIndex(1);
+
+    QByteArray buffer;
+    appendNeighbor6(buffer, "2001:db8::2", host, NUD_STALE, 1);
+    appendNeighbor6(buffer, "fe80::211:22ff:fe33:44fe", router, NUD_REACHABLE, 1);
+    appendNeighbor6(buffer, "ff02::1", multicast, NUD_NOARP, 1);
+    appendNeighbor6(buffer, "2001:db8::9", host, NUD_INCOMPLETE, 1);
+
+    QHash<QString, QString> table;
+    QCOMPARE(NeighborTable::parseNeighborDump6(buffer.constData(), buffer.size(), table), 1);
+    QCOMPARE(table.size(), 2);
+    QCOMPARE(table.value("2001:db8::2"), QString("00:11:22:33:44:02"));
+
+    // Link-local entries are only usable together with their interface
+    QString linkLocal = loopback.isEmpty() ? QString("fe80::211:22ff:fe33:44fe")
+                                           : QString("fe80::211:22ff:fe33:44fe%") + loopback;
+    QCOMPARE(table.value(linkLocal), QString("00:11:22:33:44:FE"));
+
+    // IPv4 entries in the same buffer are not IPv6 neighbours
+    QByteArray ipv4;
+    appendNeighbor(ipv4, "10.0.0.1", host, NUD_REACHABLE);
+    table.clear();
+    NeighborTable::parseNeighborDump6(ipv4.constData(), ipv4.size(), table);
+    QVERIFY(table.isEmpty());
+#else
+    QSKIP("rtnetlink is Linux only");
+#endif
+}
+
+void NeighborTableTest::testSnapshotRefresh()
+{
+    NeighborTable* table = NeighborTable::instance();
+    table->beginScan();
+    int refreshes = table->refreshCount();
+
+    // A miss re-reads the kernel table once; invalid input never does
+    QVERIFY(table->macAddress("192.0.2.254").isEmpty());
+    QCOMPARE(table->refreshCount(), refreshes + 1);
+
+    QVERIFY(table->macAddress("invalid").isEmpty());
+    QCOMPARE(table->refreshCount(), refreshes + 1);
+
+    QHash<quint32, QString> kernel = NeighborTable::readKernelTable();
+    if (!kernel.isEmpty()) {
+        QString ip = QHostAddress(kernel.constBegin().key()).toString();
+        QVERIFY(!table->macAddress(ip).isEmpty());
+    }
+}
+
+QTEST_MAIN(NeighborTableTest)
+#include "NeighborTableTest.moc"
@@ -0,0 +1,179 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "network/services/OuiIndex.h"
+
+class OuiIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testParseLine();
+    void testParseMac();
+    void testLongestPrefixMatch();
+    void testInternedVendors();
+    void testCompileAndMap();
+    void testRejectsCorruptIndex();
+
+private:
+    static OuiIndex::Record record(quint64 prefix, int bits, const QString& vendor)
+    {
+        OuiIndex::Record result;
+        result.prefix = prefix;
+        result.bits = bits;
+        result.vendor = vendor;
+        return result;
+    }
+
+    static QString vendorOf(const OuiIndex& index, const QString& mac, int* bits = nullptr)
+    {
+        quint64 value = 0;
+        OuiIndex::parseMac(mac, value);
+        return QString::fromUtf8(index.lookup(value, bits));
+    }
+};
+
+void OuiIndexTest::testParseLine()
+{
+    OuiIndex::Record parsed;
+
+    QVERIFY(OuiIndex::parseLine(QString("00000C\tCisco Systems, Inc"), parsed));
+    QCOMPARE(parsed.prefix, quint64(0x00000C));
+    QCOMPARE(parsed.bits, 24);
+    QCOMPARE(parsed.vendor, QString("Cisco Systems, Inc"));
+
+    QVERIFY(OuiIndex::parseLine(QString("00:1B:21\tIntel"), parsed));
+    QCOMPARE(parsed.prefix, quint64(0x001B21));
+
+    // MA-M and MA-S by digit count and in /bits notation
+    QVERIFY(OuiIndex::parseLine(QString("70B3D57\tBlock Vendor"), parsed));
+    QCOMPARE(parsed.bits, 28);
+    QCOMPARE(parsed.prefix, quint64(0x70B3D57));
+
+    QVERIFY(OuiIndex::parseLine(QString("70:B3:D5:F2:F0:00/36\tSensor Co"), parsed));
+    QCOMPARE(parsed.bits, 36);
+    QCOMPARE(parsed.prefix, quint64(0x70B3D5F2F));
+
+    QVERIFY(!OuiIndex::parseLine(QString("# comment"), parsed));
+    QVERIFY(!OuiIndex::parseLine(QString(""), parsed));
+    QVERIFY(!OuiIndex::parseLine(QString("00000C"), parsed));
+    QVERIFY(!OuiIndex::parseLine(QString("0000\tShort"), parsed));
+    QVERIFY(!OuiIndex::parseLine(QString("00000C/32\tOdd length"), parsed));
+    QVERIFY(!OuiIndex::parseLine(QString("GG000C\tNot hex"), parsed));
+}
+
+void OuiIndexTest::testParseMac()
+{
+    quint64 mac = 0;
+    QVERIFY(OuiIndex::parseMac(u"00:30:65:12:34:56", mac));
+    QCOMPARE(mac, quint64(0x003065123456));
+    QVERIFY(OuiIndex::parseMac(u"00-30-65-12-34-56", mac));
+    QCOMPARE(mac, quint64(0x003065123456));
+    QVERIFY(OuiIndex::parseMac(u"0030.6512.3456", mac));
+    QCOMPARE(mac, quint64(0x003065123456));
+
+    // OUI only: remaining digits are zero
+    QVERIFY(OuiIndex::parseMac(u"003065", mac));
+    QCOMPARE(mac, quint64(0x003065000000));
+
+    QVERIFY(!OuiIndex::parseMac(u"00:30", mac));
+    QVERIFY(!OuiIndex::parseMac(u"", mac));
+    QVERIFY(!OuiIndex::parseMac(u"zz:30:65:12:34:56", mac));
+    QVERIFY(!OuiIndex::parseMac(u"00:30:65:12:34:56:78", mac));
+}
+
+void OuiIndexTest::testLongestPrefixMatch()
+{
+    QVector<OuiIndex::Record> records;
+    records << record(0x70B3D5, 24, "IEEE Registration Authority")
+            << record(0x70B3D57, 28, "Block Vendor")
+            << record(0x70B3D5F2F, 36, "Sensor Co")
+            << record(0x001B21, 24, "Intel");
+
+    OuiIndex index;
+    QVERIFY(index.load(OuiIndex::build(records)));
+    QCOMPARE(index.size(), 4);
+
+    int bits = 0;
+    QCOMPARE(vendorOf(index, "70:B3:D5:F2:F1:23", &bits), QString("Sensor Co"));
+    QCOMPARE(bits, 36);
+    QCOMPARE(vendorOf(index, "70:B3:D5:F2:E1:23", &bits), QString("IEEE Registration Authority"));
+    QCOMPARE(bits, 24);
+    QCOMPARE(vendorOf(index, "70:B3:D5:71:00:01", &bits), QString("Block Vendor"));
+    QCOMPARE(bits, 28);
+    QCOMPARE(vendorOf(index, "00:1B:21:AA:BB:CC"), QString("Intel"));
+    QVERIFY(vendorOf(index, "AA:BB:CC:DD:EE:FF").isEmpty());
+}
+
+void OuiIndexTest::testInternedVendors()
+{
+    QVector<OuiIndex::Record> records;
+    for (int i = 0; i < 100; ++i) {
+        records << record(0x100000 + i, 24, i % 2 ? "Apple, Inc." : "Cisco Systems, Inc");
+    }
+    // Later duplicates replace earlier ones
+    records << record(0x100000, 24, "Renamed");
+
+    OuiIndex index;
+    QVERIFY(index.load(OuiIndex::build(records)));
+    QCOMPARE(index.size(), 100);
+    QCOMPARE(index.vendorCount(), 3);
+    QCOMPARE(vendorOf(index, "10:00:00:00:00:01"), QString("Renamed"));
+    QCOMPARE(vendorOf(index, "10:00:01:00:00:01"), QString("Apple, Inc."));
+}
+
+void OuiIndexTest::testCompileAndMap()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QString textPath = dir.filePath("oui_database.txt");
+    QString indexPath = dir.filePath("oui_database.idx");
+
+    QFile text(textPath);
+    QVERIFY(text.open(QIODevice::WriteOnly | QIODevice::Text));
+    text.write("# IEEE OUI Database\n"
+               "003065\tApple\n"
+               "70B3D5\tIEEE Registration Authority\n"
+               "70B3D5F2F/36\tSensor Co\n"
+               "C0FFEE\tCaf\xc3\xa9 Devices\n");
+    text.close();
+
+    QCOMPARE(OuiIndex::compile(textPath, indexPath), 4);
+
+    quint64 stamp = OuiIndex::stampOf(textPath);
+    QVERIFY(stamp != 0);
+
+    OuiIndex index;
+    QVERIFY(index.open(indexPath, stamp));
+    QCOMPARE(index.sourceStamp(), stamp);
+    QCOMPARE(vendorOf(index, "00:30:65:12:34:56"), QString("Apple"));
+    QCOMPARE(vendorOf(index, "70:B3:D5:F2:F0:01"), QString("Sensor Co"));
+    QCOMPARE(vendorOf(index, "C0:FF:EE:00:00:01"), QString::fromUtf8("Caf\xc3\xa9 Devices"));
+
+    // A different source stamp means the text changed and the index is stale
+    OuiIndex stale;
+    QVERIFY(!stale.open(indexPath, stamp + 1));
+    QVERIFY(!stale.isValid());
+}
+
+void OuiIndexTest::testRejectsCorruptIndex()
+{
+    QVector<OuiIndex::Record> records;
+    records << record(0x003065, 24, "Apple");
+    QByteArray image = OuiIndex::build(records);
+
+    OuiIndex index;
+    QVERIFY(!index.load(image.left(image.size() - 3)));
+    QVERIFY(!index.isValid());
+
+    QByteArray badMagic = image;
+    badMagic[0] = 'X';
+    QVERIFY(!index.load(badMagic));
+
+    QVERIFY(!index.load(QByteArray()));
+    QVERIFY(index.load(image));
+    QCOMPARE(index.size(), 1);
+}
+
+QTEST_MAIN(OuiIndexTest)
+#include "OuiIndexTest.moc"
@@ -0,0 +1,355 @@
+#include <QtTest>
+#include <QTemporaryFile>
+#include <QtEndian>
+#include <QHostAddress>
+#include "network/discovery/PassiveDiscovery.h"
+#include "network/discovery/FrameParser.h"
+#include "network/discovery/PcapReader.h"
+
+/*
+ * data/passive-lan.pcap (Ethernet, microsecond timestamps), one frame per second from 1700000000.25:
+ *  0  ARP reply          00:11:22:33:44:01  192.168.1.10
+ *  1  DHCP REQUEST       00:11:22:33:44:02  requests 192.168.1.20, hostname "laptop-02"
+ *  2  DHCP ACK           server -> 00:11:22:33:44:02, yiaddr 192.168.1.20
+ *  3  mDNS response      00:11:22:33:44:03  192.168.1.30, A printer-03.local
+ *  4  SSDP NOTIFY        00:11:22:33:44:04  192.168.1.40
+ *  5  ARP request        00:11:22:33:44:05  192.168.1.50, 802.1Q VLAN 10
+ *  6  TCP segment        00:11:22:33:44:06  (ignored)
+ *  7  ARP probe          00:11:22:33:44:07  sender 0.0.0.0 (ignored)
+ *  8  ARP reply          sender MAC ff:ff:ff:ff:ff:ff
+ *  9  ARP reply          00:11:22:33:44:01  again at 1700000090.25
+ * 10  ICMPv6 NA          00:11:22:33:44:05  target 2001:db8::50, target link-layer option
+ * 11  ICMPv6 NS          00:11:22:33:44:08  from fe80::211:22ff:fe33:4408 (IPv6 only)
+ */
+class PassiveDiscoveryTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testPcapReader();
+    void testSwappedNanosecondPcap();
+    void testFrameParser();
+    void testLinuxCooked();
+    void testTruncatedFrames();
+    void testReplay();
+    void testCaptureFailure();
+
+private:
+    QString m_capture;
+    QList<QByteArray> m_frames;
+
+    static quint32 address(int last) { return 0xC0A80100 | static_cast<quint32>(last); }
+    static quint64 mac(int last) { return 0x001122334400ULL | static_cast<quint64>(last); }
+
+    static bool parse(const QByteArray& frame, FrameParser::Observation& observation,
+                      int linkType = FrameParser::Ethernet)
+    {
+        return FrameParser::parse(reinterpret_cast<const quint8*>(frame.constData()), frame.size(),
+                                  observation, linkType);
+    }
+
+    static quint64 macOf(const FrameParser::Observation& observation)
+    {
+        quint64 key = 0;
+        for (int i = 0; i < 6; ++i) {
+            key = (key << 8) | observation.mac[i];
+        }
+        return key;
+    }
+
+    static const PassiveDiscovery::HostRecord* find(const QList<PassiveDiscovery::HostRecord>& hosts, quint64 key)
+    {
+        for (const PassiveDiscovery::HostRecord& host : hosts) {
+            if (host.mac == key) {
+                return &host;
+            }
+        }
+        return nullptr;
+    }
+};
+
+void PassiveDiscoveryTest::initTestCase()
+{
+    m_capture = QFINDTESTDATA("data/passive-lan.pcap");
+    QVERIFY(!m_capture.isEmpty());
+
+    PcapReader reader;
+    QVERIFY(reader.open(m_capture));
+    const quint8* data = nullptr;
+    int length = 0;
+    qint64 timestampUs = 0;
+    while (reader.next(data, length, timestampUs)) {
+        m_frames.append(QByteArray(reinterpret_cast<const char*>(data), length));
+    }
+    QCOMPARE(m_frames.size(), 12);
+}
+
+void PassiveDiscoveryTest::testPcapReader()
+{
+    PcapReader reader;
+    QVERIFY(reader.open(m_capture));
+    QCOMPARE(reader.linkType(), int(FrameParser::Ethernet));
+
+    const quint8* data = nullptr;
+    int length = 0;
+    qint64 timestampUs = 0;
+    QVERIFY(reader.next(data, length, timestampUs));
+    QCOMPARE(length, 60);
+    QCOMPARE(timestampUs, Q_INT64_C(1700000000250000));
+    QVERIFY(reader.errorString().isEmpty());
+
+    QTemporaryFile notPcap;
+    QVERIFY(notPcap.open());
+    notPcap.write("\x0a\x0d\x0d\x0a pcapng section header block");
+    notPcap.close();
+    QVERIFY(!reader.open(notPcap.fileName()));
+    QVERIFY(!reader.errorString().isEmpty());
+}
+
+void PassiveDiscoveryTest::testSwappedNanosecondPcap()
+{
+    // Big-endian file with nanosecond timestamps, written by hand
+    QByteArray file;
+    auto appendU32 = [&file](quint32 value) {
+        char bytes[4];
+        qToBigEndian(value, bytes);
+        file.append(bytes, 4);
+    };
+    appendU32(0xA1B23C4D);
+    appendU32(0x00020004);                  // Version 2.4
+    appendU32(0);
+    appendU32(0);
+    appendU32(65535);
+    appendU32(FrameParser::Ethernet);
+
+    const QByteArray& frame = m_frames[3];
+    appendU32(1700000003);
+    appendU32(123456789);
+    appendU32(frame.size());
+    appendU32(frame.size());
+    file.append(frame);
+    file.append("\x00\x00\x00", 3);         // Truncated second record
+
+    QTemporaryFile capture;
+    QVERIFY(capture.open());
+    capture.write(file);
+    capture.close();
+
+    PcapReader reader;
+    QVERIFY(reader.open(capture.fileName()));
+    QCOMPARE(reader.linkType(), int(FrameParser::Ethernet));
+
+    const quint8* data = nullptr;
+    int length = 0;
+    qint64 timestampUs = 0;
+    QVERIFY(reader.next(data, length, timestampUs));
+    QCOMPARE(timestampUs, Q_INT64_C(1700000003123456));
+    QCOMPARE(QByteArray(reinterpret_cast<const char*>(data), length), frame);
+
+    QVERIFY(!reader.next(data, length, timestampUs));
+    QVERIFY(!reader.errorString().isEmpty());
+}
+
+void PassiveDiscoveryTest::testFrameParser()
+{
+    FrameParser::Observation observation;
+
+    QVERIFY(parse(m_frames[0], observation));
+    QCOMPARE(observation.protocol, FrameParser::Arp);
+    QCOMPARE(macOf(observation), mac(1));
+    QCOMPARE(observation.address, address(10));
+    QCOMPARE(observation.hostnameLength, 0);
+
+    // Client request: requested address and option 12
+    QVERIFY(parse(m_frames[1], observation));
+    QCOMPARE(observation.protocol, FrameParser::Dhcp);
+    QCOMPARE(macOf(observation), mac(2));
+    QCOMPARE(observation.address, address(20));
+    QCOMPARE(QByteArray(observation.hostname), QByteArray("laptop-02"));
+
+    // Server ACK: attributed to the client hardware address, server-supplied name ignored
+    QVERIFY(parse(m_frames[2], observation));
+    QCOMPARE(observation.protocol, FrameParser::Dhcp);
+    QCOMPARE(macOf(observation), mac(2));
+    QCOMPARE(observation.address, address(20));
+    QCOMPARE(observation.hostnameLength, 0);
+
+    QVERIFY(parse(m_frames[3], observation));
+    QCOMPARE(observation.protocol, FrameParser::Mdns);
+    QCOMPARE(macOf(observation), mac(3));
+    QCOMPARE(observation.address, address(30));
+    QCOMPARE(QByteArray(observation.hostname), QByteArray("printer-03.local"));
+
+    QVERIFY(parse(m_frames[4], observation));
+    QCOMPARE(observation.protocol, FrameParser::Ssdp);
+    QCOMPARE(macOf(observation), mac(4));
+    QCOMPARE(observation.address, address(40));
+
+    QVERIFY(parse(m_frames[5], observation));
+    QCOMPARE(observation.protocol, FrameParser::Arp);
+    QCOMPARE(macOf(observation), mac(5));
+    QCOMPARE(observation.address, address(50));
+
+    QVERIFY(!parse(m_frames[6], observation));
+    QVERIFY(!parse(m_frames[7], observation));
+
+    // The parser reports it; PassiveDiscovery drops group addresses
+    QVERIFY(parse(m_frames[8], observation));
+    QCOMPARE(macOf(observation), Q_UINT64_C(0xFFFFFFFFFFFF));
+    QVERIFY(!observation.hasAddress6);
+
+    // Neighbor advertisement: the target address, with the MAC from the option
+    QVERIFY(parse(m_frames[10], observation));
+    QCOMPARE(observation.protocol, FrameParser::Ndp);
+    QCOMPARE(macOf(observation), mac(5));
+    QCOMPARE(observation.address, quint32(0));
+    QVERIFY(observation.hasAddress6);
+    QCOMPARE(QHostAddress(observation.address6), QHostAddress("2001:db8::50"));
+
+    QVERIFY(parse(m_frames[11], observation));
+    QCOMPARE(observation.protocol, FrameParser::Ndp);
+    QCOMPARE(macOf(observation), mac(8));
+    QCOMPARE(QHostAddress(observation.address6), QHostAddress("fe80::211:22ff:fe33:4408"));
+
+    // Forwarded NDP (hop limit below 255) is not trusted
+    QByteArray forwarded = m_frames[11];
+    forwarded[14 + 7] = static_cast<char>(254);
+    QVERIFY(!parse(forwarded, observation));
+
+    // Duplicate address detection comes from the unspecified address
+    QByteArray dad = m_frames[11];
+    for (int i = 0; i < 16; ++i) {
+        dad[14 + 8 + i] = 0;
+    }
+    QVERIFY(!parse(dad, observation));
+}
+
+void PassiveDiscoveryTest::testLinuxCooked()
+{
+    // Rewrite the Ethernet header of the mDNS frame as a Linux cooked header
+    const QByteArray& ethernet = m_frames[3];
+    QByteArray cooked;
+    cooked.append("\x00\x00\x00\x01\x00\x06", 6);    // Packet type, ARPHRD_ETHER, address length
+    cooked.append(ethernet.mid(6, 6));
+    cooked.append("\x00\x00", 2);
+    cooked.append(ethernet.mid(12));                // Protocol and payload
+
+    FrameParser::Observation observation;
+    QVERIFY(parse(cooked, observation, FrameParser::LinuxCooked));
+    QCOMPARE(observation.protocol, FrameParser::Mdns);
+    QCOMPARE(macOf(observation), mac(3));
+    QCOMPARE(QByteArray(observation.hostname), QByteArray("printer-03.local"));
+
+    QVERIFY(!parse(cooked, observation, 228));       // Raw IPv4 link type is not handled
+}
+
+void PassiveDiscoveryTest::testTruncatedFrames()
+{
+    // Every prefix of every frame must be rejected or decoded without reading past the end
+    FrameParser::Observation observation;
+    for (const QByteArray& frame : m_frames) {
+        for (int length = 0; length < frame.size(); ++length) {
+            QByteArray prefix = frame.left(length);
+            parse(prefix, observation);
+            QVERIFY(observation.hostnameLength <= FrameParser::MAX_HOSTNAME);
+        }
+    }
+
+    // ARP needs the full 28-byte body
+    QVERIFY(!parse(m_frames[0].left(14 + 27), observation));
+
+    // A compression pointer loop in the mDNS answer is caught
+    QByteArray looped = m_frames[3];
+    int answer = looped.indexOf(QByteArray("\x0aprinter-03"));
+    QVERIFY(answer > 0);
+    looped[answer] = static_cast<char>(0xC0);
+    looped[answer + 1] = static_cast<char>(answer - 14 - 20 - 8);
+    QVERIFY(parse(looped, observation));
+    QCOMPARE(observation.hostnameLength, 0);
+}
+
+void PassiveDiscoveryTest::testReplay()
+{
+    PassiveDiscovery discovery;
+    QList<Device> observed;
+    int batches = 0;
+    QObject::connect(&discovery, &PassiveDiscovery::devicesObserved, [&](const QList<Device>& devices) {
+        observed.append(devices);
+        batches++;
+    });
+
+    QCOMPARE(discovery.replay(m_capture), 12);
+    QCOMPARE(discovery.framesProcessed(), quint64(12));
+    QCOMPARE(batches, 1);
+    QCOMPARE(observed.size(), 6);
+
+    QList<PassiveDiscovery::HostRecord> hosts = discovery.inventory();
+    QCOMPARE(hosts.size(), 6);
+
+    const PassiveDiscovery::HostRecord* laptop = find(hosts, mac(2));
+    QVERIFY(laptop);
+    QCOMPARE(laptop->address, address(20));
+    QCOMPARE(laptop->hostname, QString("laptop-02"));
+    QCOMPARE(laptop->protocols, int(FrameParser::Dhcp));
+
+    const PassiveDiscovery::HostRecord* first = find(hosts, mac(1));
+    QVERIFY(first);
+    QCOMPARE(first->firstSeenUs, Q_INT64_C(1700000000250000));
+    QCOMPARE(first->lastSeenUs, Q_INT64_C(1700000090250000));
+
+    QVERIFY(!find(hosts, mac(6)));
+    QVERIFY(!find(hosts, mac(7)));
+
+    const PassiveDiscovery::HostRecord* dualStack = find(hosts, mac(5));
+    QVERIFY(dualStack);
+    QCOMPARE(dualStack->address, address(50));
+    QCOMPARE(dualStack->ipv6.size(), 1);
+    QCOMPARE(dualStack->protocols, int(FrameParser::Arp | FrameParser::Ndp));
+
+    bool printerFound = false;
+    bool dualStackFound = false;
+    bool v6OnlyFound = false;
+    for (const Device& device : observed) {
+        QVERIFY(device.isOnline());
+        if (device.getIp() == "192.168.1.30") {
+            printerFound = true;
+            QCOMPARE(device.getHostname(), QString("printer-03.local"));
+            QCOMPARE(device.getMacAddress(), QString("00:11:22:33:44:03"));
+        } else if (device.getIp() == "192.168.1.50") {
+            dualStackFound = true;
+            QCOMPARE(device.getIpv6Addresses(), QStringList{"2001:db8::50"});
+        } else if (device.getMacAddress() == "00:11:22:33:44:08") {
+            // IPv6-only hosts are listed under their IPv6 address
+            v6OnlyFound = true;
+            QCOMPARE(device.getIp(), QString("fe80::211:22ff:fe33:4408"));
+            QCOMPARE(device.getIpv6Addresses(), QStringList{"fe80::211:22ff:fe33:4408"});
+        }
+    }
+    QVERIFY(printerFound);
+    QVERIFY(dualStackFound);
+    QVERIFY(v6OnlyFound);
+
+    // Nothing changed: a second pass emits nothing
+    QCOMPARE(discovery.replay(m_capture), 12);
+    QCOMPARE(batches, 1);
+
+    QCOMPARE(discovery.replay(m_capture + ".missing"), -1);
+}
+
+void PassiveDiscoveryTest::testCaptureFailure()
+{
+    PassiveDiscovery discovery;
+    QString error;
+    QObject::connect(&discovery, &PassiveDiscovery::captureError, [&](const QString& message) {
+        error = message;
+    });
+
+    // Fails either for lack of CAP_NET_RAW or on the unknown interface
+    QVERIFY(!discovery.startCapture("lanscan-none0"));
+    QVERIFY(!discovery.isCapturing());
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_MAIN(PassiveDiscoveryTest)
+#include "PassiveDiscoveryTest.moc"
@@ -1,5 +1,6 @@
 #include <QtTest>
 #include "network/diagnostics/PingService.h"
+#include "network/sockets/IcmpEchoEngine.h"
 
 class PingServiceTest : public QObject
 {
@@ -11,6 +12,8 @@ private slots:
     void testPingSyncSuccess();
     void testPingSyncTimeout();
     void testBuildPingCommand();
+    void testPingPacesEchoes();
+    void testStopContinuousPingAllowsNewPing();
 };
 
 void PingServiceTest::testParseWindowsPing()
@@ -63,5 +66,48 @@ void PingServiceTest::testBuildPingCommand()
     QVERIFY(true);
 }
 
+void PingServiceTest::testPingPacesEchoes()
+{
+    PingService service;
+    QSignalSpy completedSpy(&service, &PingService::pingCompleted);
+
+    QElapsedTimer timer;
+    timer.start();
+    service.ping("127.0.0.1", 3);
+
+    // Three echoes one second apart, like ping -c 3, rather than one burst
+    QVERIFY(completedSpy.wait(10000));
+    QVERIFY(timer.elapsed() >= 1800);
+
+    QVector<PingService::PingResult> results =
+        completedSpy.first().first().value<QVector<PingService::PingResult>>();
+    QCOMPARE(results.size(), 3);
+}
+
+void PingServiceTest::testStopContinuousPingAllowsNewPing()
+{
+    if (!IcmpEchoEngine::instance()->isAvailable()) {
+        QSKIP("No ICMP socket available (needs ping_group_range or CAP_NET_RAW)");
+    }
+
+    PingService service;
+    QSignalSpy completedSpy(&service, &PingService::pingCompleted);
+
+    service.continuousPing("127.0.0.1", 1000);
+    service.stopContinuousPing();
+    QVERIFY(!service.isContinuousPingActive());
+
+    // Echoes of the stopped session must neither block nor leak into this run
+    service.ping("127.0.0.1", 1);
+    QVERIFY(completedSpy.wait(5000));
+
+    QVector<PingService::PingResult> results =
+        completedSpy.first().first().value<QVector<PingService::PingResult>>();
+    QCOMPARE(results.size(), 1);
+
+    QTest::qWait(500);
+    QCOMPARE(completedSpy.count(), 1);
+}
+
 QTEST_MAIN(PingServiceTest)
 #include "PingServiceTest.moc"
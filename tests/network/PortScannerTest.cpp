@@ -0,0 +1,90 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QSet>
+#include "network/diagnostics/PortScanner.h"
+#include "network/sockets/TcpConnectEngine.h"
+
+class PortScannerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testQueueHostsCompleteOnce();
+};
+
+void PortScannerTest::initTestCase()
+{
+    if (!TcpConnectEngine::isSupported()) {
+        QSKIP("TcpConnectEngine is not supported on this platform");
+    }
+}
+
+void PortScannerTest::testQueueHostsCompleteOnce()
+{
+    const QStringList hosts = {"127.0.0.1", "127.0.0.2", "127.0.0.3"};
+    const int listenersPerHost = 6;
+    const int maxInFlightProbes = 4;
+
+    QList<QTcpServer*> servers;
+    QHash<QString, QSet<int>> listening;
+    QList<int> scanPorts;
+    for (const QString& host : hosts) {
+        for (int i = 0; i < listenersPerHost; ++i) {
+            QTcpServer* server = new QTcpServer(this);
+            if (!server->listen(QHostAddress(host))) {
+                qDeleteAll(servers);
+                delete server;
+                QSKIP("Cannot listen on 127.0.0.2 and 127.0.0.3");
+            }
+            // Greets and hangs up, so each service session ends right away
+            connect(server, &QTcpServer::newConnection, [server]() {
+                while (QTcpSocket* client = server->nextPendingConnection()) {
+                    client->write("220 ready\r\n");
+                    client->disconnectFromHost();
+                    connect(client, &QTcpSocket::disconnected, client, &QObject::deleteLater);
+                }
+            });
+            servers.append(server);
+            listening[host].insert(server->serverPort());
+            scanPorts.append(server->serverPort());  // Every host is probed on every listener's port
+        }
+    }
+
+    PortScanner scanner;
+    scanner.setConcurrencyLimits(maxInFlightProbes, maxInFlightProbes);
+    scanner.setServiceDetection(true);  // Connects go through epoll, so probes overlap
+
+    QHash<QString, int> completions;
+    QHash<QString, QSet<int>> openPorts;
+    connect(&scanner, &PortScanner::hostScanCompleted, this,
+            [&](const QString& host, const QList<PortScanner::PortScanResult>& results) {
+        completions[host]++;
+        for (const PortScanner::PortScanResult& result : results) {
+            openPorts[host].insert(result.port);
+        }
+    });
+
+    for (const QString& host : hosts) {
+        scanner.queueHost(host, scanPorts);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(completions.size(), hosts.size(), 15000);
+    QTRY_VERIFY_WITH_TIMEOUT(!scanner.isScanningHosts(), 5000);
+    QTest::qWait(200);  // A duplicate completion would arrive by now
+
+    for (const QString& host : hosts) {
+        QCOMPARE(completions.value(host), 1);
+        QCOMPARE(openPorts.value(host), listening.value(host));
+    }
+
+    QVERIFY(scanner.peakInFlightProbes() > 0);
+    QVERIFY(scanner.peakInFlightProbes() <= maxInFlightProbes);
+
+    qDeleteAll(servers);
+}
+
+QTEST_MAIN(PortScannerTest)
+#include "PortScannerTest.moc"
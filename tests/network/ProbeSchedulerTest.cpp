@@ -0,0 +1,127 @@
+#include <QtTest>
+#include <algorithm>
+#include "network/diagnostics/ProbeScheduler.h"
+
+class ProbeSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRunsAtInterval();
+    void testPhasesSpreadAcrossInterval();
+    void testRemove();
+    void testRemoveFromCallback();
+    void testRunSoon();
+    void testSetInterval();
+    void testContextDestroyed();
+};
+
+void ProbeSchedulerTest::testRunsAtInterval()
+{
+    ProbeScheduler scheduler;
+    int runs = 0;
+    int task = scheduler.add(this, 50, [&runs]() { runs++; });
+    QVERIFY(task > 0);
+    QVERIFY(scheduler.contains(task));
+    QCOMPARE(scheduler.interval(task), 50);
+
+    // First run within one interval, then one per interval without drift
+    QTest::qWait(1025);
+    QVERIFY2(runs >= 15 && runs <= 22, qPrintable(QString::number(runs)));
+}
+
+void ProbeSchedulerTest::testPhasesSpreadAcrossInterval()
+{
+    ProbeScheduler scheduler;
+    QVector<qint64> due;
+    for (int i = 0; i < 8; ++i) {
+        int task = scheduler.add(this, 1000, []() {});
+        due.append(scheduler.remainingMs(task));
+    }
+
+    // Phases 0, 1/8, ... 7/8 of the interval, each off by at most the jitter
+    std::sort(due.begin(), due.end());
+    const int slack = 1000 * ProbeScheduler::JITTER_PERCENT / 100 + ProbeScheduler::TICK_MS;
+    for (int i = 0; i < due.size(); ++i) {
+        QVERIFY2(qAbs(due[i] - i * 125) <= slack,
+                 qPrintable(QString("task %1 due in %2ms").arg(i).arg(due[i])));
+    }
+}
+
+void ProbeSchedulerTest::testRemove()
+{
+    ProbeScheduler scheduler;
+    int runs = 0;
+    int task = scheduler.add(this, 20, [&runs]() { runs++; });
+    QTRY_VERIFY_WITH_TIMEOUT(runs > 0, 500);
+
+    scheduler.remove(task);
+    QVERIFY(!scheduler.contains(task));
+    QCOMPARE(scheduler.taskCount(), 0);
+
+    int held = runs;
+    QTest::qWait(100);
+    QCOMPARE(runs, held);
+}
+
+void ProbeSchedulerTest::testRemoveFromCallback()
+{
+    ProbeScheduler scheduler;
+    int runs = 0;
+    int task = 0;
+    task = scheduler.add(this, 20, [&]() {
+        runs++;
+        scheduler.remove(task);
+    });
+
+    QTRY_COMPARE_WITH_TIMEOUT(runs, 1, 500);
+    QTest::qWait(100);
+    QCOMPARE(runs, 1);
+    QCOMPARE(scheduler.taskCount(), 0);
+}
+
+void ProbeSchedulerTest::testRunSoon()
+{
+    ProbeScheduler scheduler;
+    scheduler.add(this, 60000, []() {});   // Takes phase 0
+
+    int runs = 0;
+    int task = scheduler.add(this, 60000, [&runs]() { runs++; });
+    QVERIFY(scheduler.remainingMs(task) > 1000);
+
+    scheduler.runSoon(task);
+    QTRY_COMPARE_WITH_TIMEOUT(runs, 1, 500);
+
+    // Back on its interval afterwards
+    QVERIFY(scheduler.remainingMs(task) > 1000);
+}
+
+void ProbeSchedulerTest::testSetInterval()
+{
+    ProbeScheduler scheduler;
+    scheduler.add(this, 60000, []() {});   // Takes phase 0
+
+    int runs = 0;
+    int task = scheduler.add(this, 60000, [&runs]() { runs++; });
+    QVERIFY(scheduler.remainingMs(task) > 1000);
+
+    scheduler.setInterval(task, 20);
+    QCOMPARE(scheduler.interval(task), 20);
+    QTRY_VERIFY_WITH_TIMEOUT(runs >= 3, 1000);
+}
+
+void ProbeSchedulerTest::testContextDestroyed()
+{
+    ProbeScheduler scheduler;
+    QObject* context = new QObject();
+    int runs = 0;
+    scheduler.add(context, 20, [&runs]() { runs++; });
+    delete context;
+
+    QTest::qWait(100);
+    QCOMPARE(runs, 0);
+    QCOMPARE(scheduler.taskCount(), 0);
+}
+
+QTEST_MAIN(ProbeSchedulerTest)
+#include "ProbeSchedulerTest.moc"
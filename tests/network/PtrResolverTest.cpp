@@ -0,0 +1,407 @@
+#include <QtTest>
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QSemaphore>
+#include <QMutex>
+#include <atomic>
+#include "network/discovery/PtrResolver.h"
+
+namespace {
+
+const quint32 LOOPBACK = 0x7F000001;
+
+quint32 ipv4(int a, int b, int c, int d)
+{
+    return (static_cast<quint32>(a) << 24) | (b << 16) | (c << 8) | d;
+}
+
+void appendU16(QByteArray& data, quint16 value)
+{
+    data.append(static_cast<char>(value >> 8));
+    data.append(static_cast<char>(value & 0xFF));
+}
+
+void appendU32(QByteArray& data, quint32 value)
+{
+    appendU16(data, static_cast<quint16>(value >> 16));
+    appendU16(data, static_cast<quint16>(value & 0xFFFF));
+}
+
+void appendName(QByteArray& data, const QString& name)
+{
+    for (const QString& label : name.split('.', Qt::SkipEmptyParts)) {
+        data.append(static_cast<char>(label.size()));
+        data.append(label.toLatin1());
+    }
+    data.append('\0');
+}
+
+/**
+ * @brief Behaviour of the stub server for one address
+ */
+struct StubRule {
+    enum Kind { Answer, NxDomain, Drop };
+
+    Kind kind = Drop;
+    QString hostname;
+    quint32 ttl = 0;
+    quint32 soaMinimum = 0;
+};
+
+/**
+ * @brief Build a reply to @p query; the question is copied verbatim
+ */
+QByteArray buildReply(const QByteArray& query, quint16 id, const StubRule& rule)
+{
+    QByteArray question = query.mid(12);
+    QByteArray reply;
+
+    appendU16(reply, id);
+    appendU16(reply, rule.kind == StubRule::NxDomain ? 0x8183 : 0x8180);
+    appendU16(reply, 1);
+    appendU16(reply, rule.kind == StubRule::Answer ? 1 : 0);
+    appendU16(reply, rule.kind == StubRule::NxDomain ? 1 : 0);
+    appendU16(reply, 0);
+    reply.append(question);
+
+    if (rule.kind == StubRule::Answer) {
+        // Owner name compressed to the question at offset 12
+        appendU16(reply, 0xC00C);
+        appendU16(reply, 12);
+        appendU16(reply, 1);
+        appendU32(reply, rule.ttl);
+
+        QByteArray rdata;
+        appendName(rdata, rule.hostname);
+        appendU16(reply, static_cast<quint16>(rdata.size()));
+        reply.append(rdata);
+    } else {
+        // SOA for in-addr.arpa with a long record TTL and the given minimum
+        appendName(reply, "in-addr.arpa");
+        appendU16(reply, 6);
+        appendU16(reply, 1);
+        appendU32(reply, 3600);
+
+        QByteArray rdata;
+        appendName(rdata, "ns.example");
+        appendName(rdata, "hostmaster.example");
+        appendU32(rdata, 1);
+        appendU32(rdata, 7200);
+        appendU32(rdata, 900);
+        appendU32(rdata, 604800);
+        appendU32(rdata, rule.soaMinimum);
+        appendU16(reply, static_cast<quint16>(rdata.size()));
+        reply.append(rdata);
+    }
+
+    return reply;
+}
+
+/**
+ * @brief Address a PTR query asks for, 0 if malformed
+ */
+quint32 queriedAddress(const QByteArray& query)
+{
+    quint32 address = 0;
+    int offset = 12;
+    for (int i = 0; i < 4; ++i) {
+        if (offset >= query.size()) {
+            return 0;
+        }
+        int length = static_cast<quint8>(query[offset]);
+        address |= query.mid(offset + 1, length).toUInt() << (8 * i);
+        offset += 1 + length;
+    }
+    return address;
+}
+
+/**
+ * @brief Minimal DNS server on 127.0.0.1 answering PTR queries from a rule table
+ */
+class StubDnsServer : public QThread
+{
+public:
+    QHash<quint32, StubRule> rules;
+    int reverseAfter = 0;       ///< Hold replies until this many queries arrived, then send in reverse
+    bool forgeFirst = false;    ///< Send a reply with a wrong ID before the real one
+
+    ~StubDnsServer() override { stop(); }
+
+    quint16 start()
+    {
+        QThread::start();
+        m_ready.acquire();
+        return m_port;
+    }
+
+    void stop()
+    {
+        m_stop = true;
+        wait();
+    }
+
+    int queries() const { return m_queries.load(); }
+
+protected:
+    void run() override
+    {
+        QUdpSocket socket;
+        socket.bind(QHostAddress::LocalHost, 0);
+        m_port = socket.localPort();
+        m_ready.release();
+
+        QList<QNetworkDatagram> held;
+
+        while (!m_stop) {
+            if (!socket.waitForReadyRead(20)) {
+                continue;
+            }
+
+            while (socket.hasPendingDatagrams()) {
+                QNetworkDatagram datagram = socket.receiveDatagram();
+                QByteArray query = datagram.data();
+                if (query.size() < 12) {
+                    continue;
+                }
+                m_queries++;
+
+                StubRule rule = rules.value(queriedAddress(query));
+                if (rule.kind == StubRule::Drop) {
+                    continue;
+                }
+
+                quint16 id = static_cast<quint16>((static_cast<quint8>(query[0]) << 8) | static_cast<quint8>(query[1]));
+
+                if (forgeFirst) {
+                    StubRule forged = rule;
+                    forged.hostname = "forged.example";
+                    socket.writeDatagram(datagram.makeReply(buildReply(query, id ^ 0x5A5A, forged)));
+                }
+
+                QNetworkDatagram reply = datagram.makeReply(buildReply(query, id, rule));
+                if (reverseAfter > 0) {
+                    held.prepend(reply);
+                    if (held.size() == reverseAfter) {
+                        for (const QNetworkDatagram& pending : held) {
+                            socket.writeDatagram(pending);
+                        }
+                        held.clear();
+                    }
+                } else {
+                    socket.writeDatagram(reply);
+                }
+            }
+        }
+    }
+
+private:
+    QSemaphore m_ready;
+    quint16 m_port = 0;
+    std::atomic<int> m_queries{0};
+    std::atomic<bool> m_stop{false};
+};
+
+}
+
+class PtrResolverTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testBuildAndParse();
+    void testMultiplexedBatch();
+    void testNegativeCaching();
+    void testTimeoutRetries();
+    void testTtlExpiry();
+    void testMismatchedIdIgnored();
+};
+
+void PtrResolverTest::testBuildAndParse()
+{
+    quint32 address = ipv4(192, 168, 1, 10);
+    QCOMPARE(PtrResolver::reverseName(address), QString("10.1.168.192.in-addr.arpa"));
+
+    QByteArray query = PtrResolver::buildQuery(0x1234, address);
+    QCOMPARE(static_cast<quint8>(query[0]), quint8(0x12));
+    QCOMPARE(static_cast<quint8>(query[1]), quint8(0x34));
+    QCOMPARE(queriedAddress(query), address);
+
+    StubRule rule;
+    rule.kind = StubRule::Answer;
+    rule.hostname = "printer.lan";
+    rule.ttl = 600;
+    QByteArray reply = buildReply(query, 0x1234, rule);
+
+    PtrResolver::Response response;
+    QVERIFY(PtrResolver::parseResponse(reinterpret_cast<const quint8*>(reply.constData()), reply.size(), response));
+    QCOMPARE(response.id, quint16(0x1234));
+    QCOMPARE(response.rcode, 0);
+    QCOMPARE(response.questionName, QString("10.1.168.192.in-addr.arpa"));
+    QCOMPARE(response.hostname, QString("printer.lan"));
+    QCOMPARE(response.ttl, quint32(600));
+
+    rule.kind = StubRule::NxDomain;
+    rule.soaMinimum = 120;
+    reply = buildReply(query, 0x1234, rule);
+    QVERIFY(PtrResolver::parseResponse(reinterpret_cast<const quint8*>(reply.constData()), reply.size(), response));
+    QCOMPARE(response.rcode, 3);
+    QVERIFY(response.hostname.isEmpty());
+    QCOMPARE(response.negativeTtl, qint64(120));
+
+    // Truncated replies and queries are rejected
+    QVERIFY(!PtrResolver::parseResponse(reinterpret_cast<const quint8*>(reply.constData()), reply.size() - 5, response));
+    QVERIFY(!PtrResolver::parseResponse(reinterpret_cast<const quint8*>(query.constData()), query.size(), response));
+}
+
+void PtrResolverTest::testMultiplexedBatch()
+{
+    StubDnsServer server;
+    QVector<quint32> addresses;
+    for (int i = 1; i <= 50; ++i) {
+        quint32 address = ipv4(10, 0, 0, i);
+        addresses.append(address);
+
+        StubRule rule;
+        rule.kind = StubRule::Answer;
+        rule.hostname = QString("host-%1.lan").arg(i);
+        rule.ttl = 300;
+        server.rules.insert(address, rule);
+    }
+    // Replies only come once every query is in flight, and in reverse order
+    server.reverseAfter = 50;
+
+    PtrResolver resolver(LOOPBACK, server.start());
+    if (!resolver.isAvailable()) {
+        QSKIP("PTR resolver sockets not available on this platform");
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<PtrResolver::PtrResult> results = resolver.resolveBatch(addresses, 2000, 0);
+
+    QVERIFY(timer.elapsed() < 2000);
+    QCOMPARE(results.size(), 50);
+    for (int i = 0; i < results.size(); ++i) {
+        QCOMPARE(results[i].address, addresses[i]);
+        QCOMPARE(results[i].status, PtrResolver::Resolved);
+        QCOMPARE(results[i].hostname, QString("host-%1.lan").arg(i + 1));
+        QVERIFY(!results[i].cached);
+    }
+    QCOMPARE(server.queries(), 50);
+    QCOMPARE(resolver.pendingCount(), 0);
+    QCOMPARE(resolver.cacheSize(), 50);
+
+    // Second pass is served from the cache
+    PtrResolver::PtrResult again = resolver.resolve(addresses[7], 2000);
+    QVERIFY(again.cached);
+    QCOMPARE(again.hostname, QString("host-8.lan"));
+    QVERIFY(again.ttl <= 300);
+    QCOMPARE(server.queries(), 50);
+}
+
+void PtrResolverTest::testNegativeCaching()
+{
+    StubDnsServer server;
+    StubRule rule;
+    rule.kind = StubRule::NxDomain;
+    rule.soaMinimum = 120;
+    server.rules.insert(ipv4(10, 0, 1, 1), rule);
+
+    PtrResolver resolver(LOOPBACK, server.start());
+    if (!resolver.isAvailable()) {
+        QSKIP("PTR resolver sockets not available on this platform");
+    }
+
+    PtrResolver::PtrResult result = resolver.resolve(ipv4(10, 0, 1, 1), 1000);
+    QCOMPARE(result.status, PtrResolver::NotFound);
+    QCOMPARE(result.ttl, quint32(120));
+
+    result = resolver.resolve(ipv4(10, 0, 1, 1), 1000);
+    QCOMPARE(result.status, PtrResolver::NotFound);
+    QVERIFY(result.cached);
+    QCOMPARE(server.queries(), 1);
+}
+
+void PtrResolverTest::testTimeoutRetries()
+{
+    StubDnsServer server;
+
+    PtrResolver resolver(LOOPBACK, server.start());
+    if (!resolver.isAvailable()) {
+        QSKIP("PTR resolver sockets not available on this platform");
+    }
+
+    // No rule: the server drops the query
+    QElapsedTimer timer;
+    timer.start();
+    PtrResolver::PtrResult result = resolver.resolve(ipv4(10, 0, 2, 1), 100, 2);
+
+    QCOMPARE(result.status, PtrResolver::Timeout);
+    QCOMPARE(server.queries(), 3);
+    // 100 + 150 + 200 ms with the per-attempt backoff
+    QVERIFY(timer.elapsed() >= 440);
+
+    result = resolver.resolve(ipv4(10, 0, 2, 1), 100, 2);
+    QCOMPARE(result.status, PtrResolver::Timeout);
+    QVERIFY(result.cached);
+    QVERIFY(result.ttl <= PtrResolver::TIMEOUT_TTL);
+    QCOMPARE(server.queries(), 3);
+}
+
+void PtrResolverTest::testTtlExpiry()
+{
+    StubDnsServer server;
+    StubRule shortLived;
+    shortLived.kind = StubRule::Answer;
+    shortLived.hostname = "short.lan";
+    shortLived.ttl = 1;
+    server.rules.insert(ipv4(10, 0, 3, 1), shortLived);
+
+    StubRule uncached = shortLived;
+    uncached.hostname = "uncached.lan";
+    uncached.ttl = 0;
+    server.rules.insert(ipv4(10, 0, 3, 2), uncached);
+
+    PtrResolver resolver(LOOPBACK, server.start());
+    if (!resolver.isAvailable()) {
+        QSKIP("PTR resolver sockets not available on this platform");
+    }
+
+    QCOMPARE(resolver.resolve(ipv4(10, 0, 3, 1), 1000).hostname, QString("short.lan"));
+    QVERIFY(resolver.resolve(ipv4(10, 0, 3, 1), 1000).cached);
+    QCOMPARE(server.queries(), 1);
+
+    QThread::msleep(1100);
+    PtrResolver::PtrResult result = resolver.resolve(ipv4(10, 0, 3, 1), 1000);
+    QVERIFY(!result.cached);
+    QCOMPARE(server.queries(), 2);
+
+    // TTL 0 answers are used but never cached
+    QCOMPARE(resolver.resolve(ipv4(10, 0, 3, 2), 1000).hostname, QString("uncached.lan"));
+    QCOMPARE(resolver.resolve(ipv4(10, 0, 3, 2), 1000).hostname, QString("uncached.lan"));
+    QCOMPARE(server.queries(), 4);
+    QCOMPARE(resolver.cacheSize(), 1);
+}
+
+void PtrResolverTest::testMismatchedIdIgnored()
+{
+    StubDnsServer server;
+    StubRule rule;
+    rule.kind = StubRule::Answer;
+    rule.hostname = "real.lan";
+    rule.ttl = 60;
+    server.rules.insert(ipv4(10, 0, 4, 1), rule);
+    server.forgeFirst = true;
+
+    PtrResolver resolver(LOOPBACK, server.start());
+    if (!resolver.isAvailable()) {
+        QSKIP("PTR resolver sockets not available on this platform");
+    }
+
+    PtrResolver::PtrResult result = resolver.resolve(ipv4(10, 0, 4, 1), 1000);
+    QCOMPARE(result.status, PtrResolver::Resolved);
+    QCOMPARE(result.hostname, QString("real.lan"));
+}
+
+QTEST_MAIN(PtrResolverTest)
+#include "PtrResolverTest.moc"
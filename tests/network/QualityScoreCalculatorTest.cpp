@@ -15,6 +15,7 @@ private slots:
     void testLatencyScoring();
     void testPacketLossScoring();
     void testJitterScoring();
+    void testMetricsUseWindowedJitterBurst();
     void testWeightedScore();
 };
 
@@ -109,6 +110,23 @@ void QualityScoreCalculatorTest::testJitterScoring()
     QVERIFY(score1.score > score2.score);
 }
 
+void QualityScoreCalculatorTest::testMetricsUseWindowedJitterBurst()
+{
+    QualityScoreCalculator calc;
+
+    NetworkMetrics metrics;
+    metrics.setLatencyAvg(15.0);
+    metrics.setJitter(3.0);
+    QCOMPARE(calc.calculate(metrics).score, calc.calculate(15.0, 0.0, 3.0).score);
+
+    // The smoothed estimate still lags a burst the window already shows
+    metrics.setJitterWindowed(40.0);
+    QCOMPARE(calc.calculate(metrics).score, calc.calculate(15.0, 0.0, 40.0).score);
+
+    metrics.setJitterWindowed(1.0);
+    QCOMPARE(calc.calculate(metrics).score, calc.calculate(15.0, 0.0, 3.0).score);
+}
+
 void QualityScoreCalculatorTest::testWeightedScore()
 {
     QualityScoreCalculator calc;
@@ -0,0 +1,160 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include "network/sockets/RateController.h"
+
+class RateControllerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testUnlimitedNeverBlocks();
+    void testCeilingEnforced();
+    void testBackOffOnTimeoutSpike();
+    void testAdditiveRecovery();
+    void testRecoveryAfterLastingTimeoutShift();
+    void testCongestionSignal();
+    void testEffectiveRate();
+
+private:
+    static void reportWindow(RateController& controller, int responses, int timeouts)
+    {
+        // A window is evaluated by the first report after its 200 ms have passed
+        for (int i = 0; i < responses; ++i) {
+            controller.reportResponse();
+        }
+        for (int i = 0; i < timeouts; ++i) {
+            controller.reportTimeout();
+        }
+        QTest::qWait(210);
+    }
+};
+
+void RateControllerTest::testUnlimitedNeverBlocks()
+{
+    RateController controller;
+    controller.setTargetRate(0);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 100000; ++i) {
+        QVERIFY(controller.tryAcquire());
+    }
+    QVERIFY(timer.elapsed() < 1000);
+    QCOMPARE(controller.waitTimeMs(), 0);
+
+    // Loss reports do not invent a limit
+    controller.reportCongestion();
+    QCOMPARE(controller.currentRate(), 0.0);
+}
+
+void RateControllerTest::testCeilingEnforced()
+{
+    RateController controller;
+    controller.setTargetRate(200);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 100; ++i) {
+        controller.acquire();
+    }
+    qint64 elapsed = timer.elapsed();
+
+    // 100 probes at 200 pps take ~0.5 s, minus the initial burst (10 tokens)
+    QVERIFY2(elapsed >= 400, qPrintable(QString("elapsed %1 ms").arg(elapsed)));
+    QVERIFY2(elapsed < 1500, qPrintable(QString("elapsed %1 ms").arg(elapsed)));
+}
+
+void RateControllerTest::testBackOffOnTimeoutSpike()
+{
+    RateController controller;
+    controller.setTargetRate(1000);
+
+    // Baseline: a quarter of the targets never answer
+    reportWindow(controller, 30, 10);
+    reportWindow(controller, 30, 10);
+
+    // Steady dead hosts are not congestion
+    reportWindow(controller, 30, 10);
+    QCOMPARE(controller.currentRate(), 1000.0);
+
+    // Timeout ratio jumps well above the baseline
+    reportWindow(controller, 10, 30);
+    controller.reportTimeout();
+    QCOMPARE(controller.currentRate(), 500.0);
+}
+
+void RateControllerTest::testAdditiveRecovery()
+{
+    RateController controller;
+    controller.setTargetRate(1000);
+    reportWindow(controller, 40, 0);
+
+    controller.reportCongestion();
+    QCOMPARE(controller.currentRate(), 500.0);
+
+    // First window sets the baseline, each clean one after adds 5% of the ceiling
+    reportWindow(controller, 40, 0);
+    reportWindow(controller, 40, 0);
+    QCOMPARE(controller.currentRate(), 550.0);
+
+    controller.reportResponse();
+    QCOMPARE(controller.currentRate(), 600.0);
+}
+
+void RateControllerTest::testRecoveryAfterLastingTimeoutShift()
+{
+    RateController controller;
+    controller.setTargetRate(100);
+
+    // Dense part of the scan: a tenth of the targets never answer
+    reportWindow(controller, 36, 4);
+    reportWindow(controller, 36, 4);
+
+    // Sparse part: most targets are dead from here on, without any loss
+    for (int i = 0; i < 20; ++i) {
+        reportWindow(controller, 16, 24);
+    }
+    controller.reportTimeout();
+
+    // Backed off at first, then the baseline caught up and the rate grew again
+    QVERIFY2(controller.currentRate() > 10.0, qPrintable(QString::number(controller.currentRate())));
+}
+
+void RateControllerTest::testCongestionSignal()
+{
+    RateController controller;
+    controller.setTargetRate(100);
+
+    controller.reportCongestion();
+    QCOMPARE(controller.currentRate(), 50.0);
+
+    // Back-to-back signals within one window count once
+    controller.reportCongestion();
+    QCOMPARE(controller.currentRate(), 50.0);
+
+    // Never below the floor
+    for (int i = 0; i < 5; ++i) {
+        QTest::qWait(210);
+        controller.reportCongestion();
+    }
+    QCOMPARE(controller.currentRate(), 10.0);
+}
+
+void RateControllerTest::testEffectiveRate()
+{
+    RateController controller;
+    controller.setTargetRate(0);
+    QCOMPARE(controller.effectiveRate(), 0.0);
+
+    for (int i = 0; i < 250; ++i) {
+        controller.tryAcquire();
+    }
+    QCOMPARE(controller.effectiveRate(), 250.0);
+
+    // Sends fall out of the one-second window
+    QTest::qWait(1150);
+    QCOMPARE(controller.effectiveRate(), 0.0);
+}
+
+QTEST_MAIN(RateControllerTest)
+#include "RateControllerTest.moc"
@@ -0,0 +1,110 @@
+#include <QtTest>
+#include "network/sockets/RttEstimator.h"
+
+class RttEstimatorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testInitialTimeout();
+    void testFirstSample();
+    void testConvergesOnStableRtt();
+    void testVarianceWidensTimeout();
+    void testSubnetFallback();
+    void testBounds();
+
+private:
+    static constexpr quint32 HOST = 0xC0A8010A;       // 192.168.1.10
+    static constexpr quint32 NEIGHBOUR = 0xC0A80114;  // 192.168.1.20
+    static constexpr quint32 OTHER = 0xC0A80205;      // 192.168.2.5
+};
+
+void RttEstimatorTest::testInitialTimeout()
+{
+    RttEstimator estimator;
+    estimator.setBounds(100, 3000);
+    QCOMPARE(estimator.timeoutFor(HOST), 1000);
+    QCOMPARE(estimator.smoothedRtt(HOST), -1.0);
+
+    // The initial timeout never exceeds the configured maximum
+    estimator.setBounds(100, 500);
+    QCOMPARE(estimator.timeoutFor(HOST), 500);
+}
+
+void RttEstimatorTest::testFirstSample()
+{
+    RttEstimator estimator;
+    estimator.setBounds(1, 3000);
+
+    // SRTT = R, RTTVAR = R/2, timeout = SRTT + 4 * RTTVAR
+    estimator.addSample(HOST, 10.0);
+    QCOMPARE(estimator.smoothedRtt(HOST), 10.0);
+    QCOMPARE(estimator.timeoutFor(HOST), 30);
+}
+
+void RttEstimatorTest::testConvergesOnStableRtt()
+{
+    RttEstimator estimator;
+    estimator.setBounds(1, 3000);
+
+    for (int i = 0; i < 200; ++i) {
+        estimator.addSample(HOST, 2.0);
+    }
+
+    QVERIFY(qAbs(estimator.smoothedRtt(HOST) - 2.0) < 0.01);
+    QCOMPARE(estimator.timeoutFor(HOST), 3);
+}
+
+void RttEstimatorTest::testVarianceWidensTimeout()
+{
+    RttEstimator estimator;
+    estimator.setBounds(1, 3000);
+
+    for (int i = 0; i < 100; ++i) {
+        estimator.addSample(HOST, (i % 2) ? 50.0 : 10.0);
+    }
+
+    // Mean is 30 ms, the jitter must push the timeout well past the slowest replies
+    QVERIFY(estimator.smoothedRtt(HOST) > 20.0 && estimator.smoothedRtt(HOST) < 40.0);
+    QVERIFY(estimator.timeoutFor(HOST) > 80);
+}
+
+void RttEstimatorTest::testSubnetFallback()
+{
+    RttEstimator estimator;
+    estimator.setBounds(1, 3000);
+
+    for (int i = 0; i < 50; ++i) {
+        estimator.addSample(HOST, 1.0);
+    }
+
+    // Unknown hosts on the same /24 use the subnet estimate
+    QVERIFY(estimator.timeoutFor(NEIGHBOUR) < 10);
+    QCOMPARE(estimator.smoothedRtt(NEIGHBOUR), -1.0);
+
+    // Other subnets start from the initial timeout
+    QCOMPARE(estimator.timeoutFor(OTHER), 1000);
+
+    estimator.clear();
+    QCOMPARE(estimator.timeoutFor(NEIGHBOUR), 1000);
+}
+
+void RttEstimatorTest::testBounds()
+{
+    RttEstimator estimator;
+    estimator.setBounds(100, 2000);
+
+    estimator.addSample(HOST, 0.2);
+    QCOMPARE(estimator.timeoutFor(HOST), 100);
+
+    estimator.addSample(OTHER, 5000.0);
+    QCOMPARE(estimator.timeoutFor(OTHER), 2000);
+
+    // Inverted bounds collapse onto the maximum
+    estimator.setBounds(500, 200);
+    QCOMPARE(estimator.minTimeout(), 200);
+    QCOMPARE(estimator.maxTimeout(), 200);
+}
+
+QTEST_MAIN(RttEstimatorTest)
+#include "RttEstimatorTest.moc"
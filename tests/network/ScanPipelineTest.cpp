@@ -0,0 +1,270 @@
+#include <QtTest>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QThread>
+#include <QSemaphore>
+#include <QElapsedTimer>
+#include "network/scanner/ScanPipeline.h"
+
+class ScanPipelineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testStagesRunInOrder();
+    void testSkippedStages();
+    void testConcurrencyLimit();
+    void testAsyncStageOverlaps();
+    void testBoundedQueue();
+    void testCancel();
+    void testRunInline();
+    void testPendingHosts();
+
+private:
+    static Device makeDevice(int index)
+    {
+        Device device;
+        device.setIp(QString("10.0.0.%1").arg(index));
+        device.setOnline(true);
+        return device;
+    }
+};
+
+void ScanPipelineTest::testStagesRunInOrder()
+{
+    ScanPipeline pipeline;
+    pipeline.setHandler(ScanPipeline::Identity, [](Device& device) { device.setVendor("Vendor"); });
+    pipeline.setHandler(ScanPipeline::Dns, [](Device& device) {
+        // Each stage sees the previous stages' results
+        device.setHostname(device.getVendor() + "-host");
+    });
+    pipeline.setHandler(ScanPipeline::Ports, [](Device& device) {
+        device.addPort(PortInfo(device.getHostname().size(), PortInfo::TCP));
+    });
+
+    QMutex mutex;
+    QList<int> updates;
+    QList<Device> completed;
+
+    connect(&pipeline, &ScanPipeline::deviceUpdated, this, [&](const Device&, int stage) {
+        QMutexLocker locker(&mutex);
+        updates.append(stage);
+    }, Qt::DirectConnection);
+    connect(&pipeline, &ScanPipeline::deviceCompleted, this, [&](const Device& device) {
+        QMutexLocker locker(&mutex);
+        completed.append(device);
+    }, Qt::DirectConnection);
+
+    for (int i = 1; i <= 20; ++i) {
+        QVERIFY(pipeline.submit(makeDevice(i)));
+    }
+    QVERIFY(pipeline.waitForIdle(5000));
+
+    // One partial update per stage and device
+    QCOMPARE(updates.size(), 60);
+    QCOMPARE(updates.count(ScanPipeline::Identity), 20);
+    QCOMPARE(updates.count(ScanPipeline::Dns), 20);
+    QCOMPARE(updates.count(ScanPipeline::Ports), 20);
+
+    QCOMPARE(completed.size(), 20);
+    for (const Device& device : completed) {
+        QCOMPARE(device.getHostname(), QString("Vendor-host"));
+        QCOMPARE(device.getOpenPorts().size(), 1);
+    }
+
+    ScanPipeline::StageStats stats = pipeline.stats(ScanPipeline::Dns);
+    QCOMPARE(stats.processed, quint64(20));
+    QCOMPARE(stats.queueDepth, 0);
+    QCOMPARE(stats.active, 0);
+}
+
+void ScanPipelineTest::testSkippedStages()
+{
+    ScanPipeline pipeline;
+    pipeline.setHandler(ScanPipeline::Ports, [](Device&) {});
+
+    QAtomicInt portUpdates(0);
+    QAtomicInt otherUpdates(0);
+    connect(&pipeline, &ScanPipeline::deviceUpdated, this, [&](const Device&, int stage) {
+        (stage == ScanPipeline::Ports ? portUpdates : otherUpdates).ref();
+    }, Qt::DirectConnection);
+
+    for (int i = 1; i <= 5; ++i) {
+        pipeline.submit(makeDevice(i));
+    }
+    QVERIFY(pipeline.waitForIdle(5000));
+
+    QCOMPARE(portUpdates.loadAcquire(), 5);
+    QCOMPARE(otherUpdates.loadAcquire(), 0);
+    QVERIFY(!pipeline.isEnabled(ScanPipeline::Dns));
+}
+
+void ScanPipelineTest::testConcurrencyLimit()
+{
+    ScanPipeline pipeline;
+    pipeline.setConcurrency(ScanPipeline::Dns, 3);
+
+    QAtomicInt running(0);
+    QAtomicInt peak(0);
+    pipeline.setHandler(ScanPipeline::Dns, [&](Device&) {
+        int now = running.fetchAndAddOrdered(1) + 1;
+        int seen = peak.loadAcquire();
+        while (now > seen && !peak.testAndSetOrdered(seen, now)) {
+            seen = peak.loadAcquire();
+        }
+        QThread::msleep(30);
+        running.deref();
+    });
+
+    for (int i = 1; i <= 12; ++i) {
+        pipeline.submit(makeDevice(i));
+    }
+    QVERIFY(pipeline.waitForIdle(5000));
+
+    QCOMPARE(peak.loadAcquire(), 3);
+    QCOMPARE(pipeline.stats(ScanPipeline::Dns).concurrency, 3);
+    QVERIFY(pipeline.stats(ScanPipeline::Dns).averageLatencyMs >= 25.0);
+    QCOMPARE(pipeline.stats(ScanPipeline::Liveness).concurrency, 0);  // Caller's threads, no pool
+}
+
+void ScanPipelineTest::testAsyncStageOverlaps()
+{
+    ScanPipeline pipeline;
+    pipeline.setConcurrency(ScanPipeline::Dns, 1);
+
+    // Completed 100 ms later from another thread, like a resolver's receiver
+    QMutex mutex;
+    QList<QThread*> completers;
+    pipeline.setAsyncHandler(ScanPipeline::Dns, [&](const Device& device, ScanPipeline::Completion done) {
+        QThread* completer = QThread::create([device, done]() {
+            QThread::msleep(100);
+            Device named = device;
+            named.setHostname("host-" + device.getIp());
+            done(named);
+        });
+        completer->start();
+        QMutexLocker locker(&mutex);
+        completers.append(completer);
+    });
+
+    QList<Device> completed;
+    connect(&pipeline, &ScanPipeline::deviceCompleted, this, [&](const Device& device) {
+        QMutexLocker locker(&mutex);
+        completed.append(device);
+    }, Qt::DirectConnection);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 1; i <= 20; ++i) {
+        QVERIFY(pipeline.submit(makeDevice(i)));
+    }
+    QVERIFY(pipeline.waitForIdle(5000));
+
+    // One worker, yet the lookups overlapped instead of taking 20 x 100 ms
+    QVERIFY2(timer.elapsed() < 1000, qPrintable(QString::number(timer.elapsed())));
+    QCOMPARE(completed.size(), 20);
+    for (const Device& device : completed) {
+        QCOMPARE(device.getHostname(), "host-" + device.getIp());
+    }
+    QCOMPARE(pipeline.stats(ScanPipeline::Dns).processed, quint64(20));
+
+    for (QThread* completer : completers) {
+        completer->wait();
+        delete completer;
+    }
+}
+
+void ScanPipelineTest::testBoundedQueue()
+{
+    ScanPipeline pipeline;
+    pipeline.setQueueCapacity(ScanPipeline::Dns, 2);
+    pipeline.setConcurrency(ScanPipeline::Dns, 1);
+
+    // A slow DNS stage backs up its own queue only up to its capacity
+    pipeline.setHandler(ScanPipeline::Identity, [](Device&) {});
+    pipeline.setHandler(ScanPipeline::Dns, [](Device&) { QThread::msleep(20); });
+
+    for (int i = 1; i <= 10; ++i) {
+        pipeline.submit(makeDevice(i));
+    }
+
+    int maxDepth = 0;
+    while (!pipeline.isIdle()) {
+        maxDepth = qMax(maxDepth, pipeline.stats(ScanPipeline::Dns).queueDepth);
+        QThread::msleep(2);
+    }
+
+    QVERIFY(maxDepth <= 2);
+    QCOMPARE(pipeline.stats(ScanPipeline::Identity).processed, quint64(10));
+    QCOMPARE(pipeline.stats(ScanPipeline::Dns).processed, quint64(10));
+}
+
+void ScanPipelineTest::testCancel()
+{
+    ScanPipeline pipeline;
+    pipeline.setConcurrency(ScanPipeline::Dns, 1);
+    pipeline.setHandler(ScanPipeline::Dns, [](Device&) { QThread::msleep(50); });
+
+    QAtomicInt completed(0);
+    connect(&pipeline, &ScanPipeline::deviceCompleted, this, [&](const Device&) {
+        completed.ref();
+    }, Qt::DirectConnection);
+
+    for (int i = 1; i <= 20; ++i) {
+        pipeline.submit(makeDevice(i));
+    }
+    QThread::msleep(60);
+    pipeline.cancel();
+
+    QVERIFY(pipeline.waitForIdle(2000));
+    QVERIFY(completed.loadAcquire() < 20);
+    QVERIFY(!pipeline.submit(makeDevice(99)));
+
+    pipeline.reset();
+    QVERIFY(pipeline.submit(makeDevice(100)));
+    QVERIFY(pipeline.waitForIdle(2000));
+}
+
+void ScanPipelineTest::testRunInline()
+{
+    ScanPipeline pipeline;
+    pipeline.setHandler(ScanPipeline::Identity, [](Device& device) { device.setVendor("Vendor"); });
+    pipeline.setHandler(ScanPipeline::Dns, [](Device& device) { device.setHostname("host"); });
+
+    QAtomicInt updates(0);
+    connect(&pipeline, &ScanPipeline::deviceUpdated, this, [&](const Device&, int) {
+        updates.ref();
+    }, Qt::DirectConnection);
+
+    Device device = makeDevice(1);
+    pipeline.runInline(device);
+
+    QCOMPARE(device.getVendor(), QString("Vendor"));
+    QCOMPARE(device.getHostname(), QString("host"));
+    QCOMPARE(updates.loadAcquire(), 0);
+    QCOMPARE(pipeline.stats(ScanPipeline::Identity).processed, quint64(1));
+}
+
+void ScanPipelineTest::testPendingHosts()
+{
+    ScanPipeline pipeline;
+    QSemaphore release;
+    pipeline.setConcurrency(ScanPipeline::Ports, 2);
+    pipeline.setHandler(ScanPipeline::Ports, [&release](Device&) { release.acquire(); });
+
+    for (int i = 1; i <= 3; ++i) {
+        QVERIFY(pipeline.submit(makeDevice(i)));
+    }
+
+    // Queued and running devices are both reported, each IP once
+    QStringList pending = pipeline.pendingHosts();
+    pending.sort();
+    QCOMPARE(pending, QStringList({"10.0.0.1", "10.0.0.2", "10.0.0.3"}));
+
+    release.release(3);
+    QVERIFY(pipeline.waitForIdle(2000));
+    QVERIFY(pipeline.pendingHosts().isEmpty());
+}
+
+QTEST_MAIN(ScanPipelineTest)
+#include "ScanPipelineTest.moc"
@@ -0,0 +1,159 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QThread>
+#include <atomic>
+#include "network/scanner/ScanScheduler.h"
+
+class ScanSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testUnknownJobNeverWaits();
+    void testPauseBlocksUntilResume();
+    void testHigherPriorityPreempts();
+    void testPausedJobDoesNotPreempt();
+    void testEqualPriorityRunsTogether();
+    void testCancelEndsWait();
+
+private:
+    // Worker that passes the gate repeatedly until stopped
+    static QThread* startWorker(ScanScheduler& scheduler, int jobId, std::atomic<int>& passes,
+                                QAtomicInt& stop)
+    {
+        QThread* thread = QThread::create([&scheduler, jobId, &passes, &stop]() {
+            while (!stop.loadAcquire()) {
+                if (scheduler.waitTurn(jobId, &stop)) {
+                    passes++;
+                    QThread::msleep(1);
+                }
+            }
+        });
+        thread->start();
+        return thread;
+    }
+};
+
+void ScanSchedulerTest::testUnknownJobNeverWaits()
+{
+    ScanScheduler scheduler;
+    QVERIFY(scheduler.mayRun(0));
+    QVERIFY(scheduler.waitTurn(0));
+    QVERIFY(scheduler.waitTurn(42));
+    QVERIFY(!scheduler.isPaused(42));
+}
+
+void ScanSchedulerTest::testPauseBlocksUntilResume()
+{
+    ScanScheduler scheduler;
+    int job = scheduler.registerJob(ScanScheduler::Normal);
+    QVERIFY(job > 0);
+    QVERIFY(scheduler.mayRun(job));
+
+    scheduler.pause(job);
+    QVERIFY(scheduler.isPaused(job));
+    QVERIFY(!scheduler.mayRun(job));
+
+    std::atomic<int> passes(0);
+    QAtomicInt stop(0);
+    QThread* worker = startWorker(scheduler, job, passes, stop);
+
+    QTest::qWait(100);
+    QCOMPARE(passes.load(), 0);
+
+    // Resume wakes the waiter at once, not on the next poll
+    QElapsedTimer timer;
+    timer.start();
+    scheduler.resume(job);
+    QTRY_VERIFY_WITH_TIMEOUT(passes.load() > 0, 1000);
+    QVERIFY(timer.elapsed() < 500);
+
+    stop.storeRelease(1);
+    worker->wait();
+    delete worker;
+}
+
+void ScanSchedulerTest::testHigherPriorityPreempts()
+{
+    ScanScheduler scheduler;
+    int sweep = scheduler.registerJob(ScanScheduler::Background);
+
+    std::atomic<int> passes(0);
+    QAtomicInt stop(0);
+    QThread* worker = startWorker(scheduler, sweep, passes, stop);
+    QTRY_VERIFY_WITH_TIMEOUT(passes.load() > 0, 1000);
+
+    // An interactive job holds the sweep back from its next turn on
+    int rescan = scheduler.registerJob(ScanScheduler::Interactive);
+    QVERIFY(scheduler.mayRun(rescan));
+    QVERIFY(!scheduler.mayRun(sweep));
+    QTest::qWait(20);
+    int held = passes.load();
+    QTest::qWait(100);
+    QCOMPARE(passes.load(), held);
+
+    // And releases it when done
+    scheduler.unregisterJob(rescan);
+    QTRY_VERIFY_WITH_TIMEOUT(passes.load() > held, 1000);
+
+    stop.storeRelease(1);
+    worker->wait();
+    delete worker;
+}
+
+void ScanSchedulerTest::testPausedJobDoesNotPreempt()
+{
+    ScanScheduler scheduler;
+    int low = scheduler.registerJob(ScanScheduler::Background);
+    int high = scheduler.registerJob(ScanScheduler::Normal);
+    QVERIFY(!scheduler.mayRun(low));
+
+    scheduler.pause(high);
+    QVERIFY(scheduler.mayRun(low));
+
+    scheduler.resume(high);
+    QVERIFY(!scheduler.mayRun(low));
+
+    scheduler.setPriority(low, ScanScheduler::Interactive);
+    QVERIFY(scheduler.mayRun(low));
+    QVERIFY(!scheduler.mayRun(high));
+}
+
+void ScanSchedulerTest::testEqualPriorityRunsTogether()
+{
+    ScanScheduler scheduler;
+    int first = scheduler.registerJob(ScanScheduler::Normal);
+    int second = scheduler.registerJob(ScanScheduler::Normal);
+    QVERIFY(scheduler.mayRun(first));
+    QVERIFY(scheduler.mayRun(second));
+    QCOMPARE(scheduler.jobCount(), 2);
+
+    scheduler.unregisterJob(first);
+    scheduler.unregisterJob(second);
+    QCOMPARE(scheduler.jobCount(), 0);
+}
+
+void ScanSchedulerTest::testCancelEndsWait()
+{
+    ScanScheduler scheduler;
+    int job = scheduler.registerJob(ScanScheduler::Normal);
+    scheduler.pause(job);
+
+    QAtomicInt cancelled(0);
+    std::atomic<bool> result(true);
+    QThread* waiter = QThread::create([&]() {
+        result = scheduler.waitTurn(job, &cancelled);
+    });
+    waiter->start();
+
+    QTest::qWait(50);
+    QVERIFY(!waiter->isFinished());
+
+    cancelled.storeRelease(1);
+    QVERIFY(waiter->wait(1000));
+    QVERIFY(!result.load());
+    delete waiter;
+}
+
+QTEST_MAIN(ScanSchedulerTest)
+#include "ScanSchedulerTest.moc"
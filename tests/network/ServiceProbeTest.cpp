@@ -0,0 +1,234 @@
+#include <QtTest>
+#include "network/services/ServiceProbe.h"
+
+class ServiceProbeTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testKindForPort();
+    void testGreetings();
+    void testHttpServerHeader();
+    void testCompletion();
+    void testClientHelloStructure();
+    void testCertificateCommonName();
+    void testCertificateFromRecords();
+
+private:
+    static QByteArray der(quint8 tag, const QByteArray& content)
+    {
+        QByteArray out;
+        out.append(static_cast<char>(tag));
+        if (content.size() < 0x80) {
+            out.append(static_cast<char>(content.size()));
+        } else {
+            out.append('\x82');
+            out.append(static_cast<char>((content.size() >> 8) & 0xFF));
+            out.append(static_cast<char>(content.size() & 0xFF));
+        }
+        out.append(content);
+        return out;
+    }
+
+    static QByteArray name(const QByteArray& organization, const QByteArray& commonName)
+    {
+        QByteArray o = der(0x31, der(0x30, der(0x06, QByteArray("\x55\x04\x0A", 3)) + der(0x0C, organization)));
+        QByteArray cn = der(0x31, der(0x30, der(0x06, QByteArray("\x55\x04\x03", 3)) + der(0x0C, commonName)));
+        return der(0x30, o + cn);
+    }
+
+    static QByteArray certificate(const QByteArray& commonName)
+    {
+        QByteArray algorithm = der(0x30, der(0x06, QByteArray::fromHex("2A864886F70D01010B")) + der(0x05, QByteArray()));
+        QByteArray validity = der(0x30, der(0x17, "250101000000Z") + der(0x17, "350101000000Z"));
+        QByteArray tbs = der(0x30,
+            der(0xA0, der(0x02, QByteArray("\x02", 1)))
+            + der(0x02, QByteArray::fromHex("1234"))
+            + algorithm
+            + name("Issuer Org", "Issuer CA")
+            + validity
+            + name("Example", commonName)
+            + der(0x30, QByteArray(40, 'k')));
+        return der(0x30, tbs + algorithm + der(0x03, QByteArray(65, '\0')));
+    }
+
+    static QByteArray handshake(quint8 type, const QByteArray& body)
+    {
+        QByteArray out;
+        out.append(static_cast<char>(type));
+        out.append(static_cast<char>((body.size() >> 16) & 0xFF));
+        out.append(static_cast<char>((body.size() >> 8) & 0xFF));
+        out.append(static_cast<char>(body.size() & 0xFF));
+        return out + body;
+    }
+
+    static QByteArray record(const QByteArray& fragment, quint8 type = 22)
+    {
+        QByteArray out;
+        out.append(static_cast<char>(type));
+        out.append('\x03');
+        out.append('\x03');
+        out.append(static_cast<char>((fragment.size() >> 8) & 0xFF));
+        out.append(static_cast<char>(fragment.size() & 0xFF));
+        return out + fragment;
+    }
+
+    static QByteArray u24(int value)
+    {
+        QByteArray out;
+        out.append(static_cast<char>((value >> 16) & 0xFF));
+        out.append(static_cast<char>((value >> 8) & 0xFF));
+        out.append(static_cast<char>(value & 0xFF));
+        return out;
+    }
+};
+
+void ServiceProbeTest::testKindForPort()
+{
+    QCOMPARE(ServiceProbe::kindFor(80), ServiceProbe::HttpHead);
+    QCOMPARE(ServiceProbe::kindFor(8080), ServiceProbe::HttpHead);
+    QCOMPARE(ServiceProbe::kindFor(443), ServiceProbe::TlsHello);
+    QCOMPARE(ServiceProbe::kindFor(993), ServiceProbe::TlsHello);
+    QCOMPARE(ServiceProbe::kindFor(22), ServiceProbe::Passive);
+    QCOMPARE(ServiceProbe::kindFor(25), ServiceProbe::Passive);
+
+    QVERIFY(ServiceProbe::request(ServiceProbe::Passive, 0).isEmpty());
+    QByteArray head = ServiceProbe::request(ServiceProbe::HttpHead, 0xC0A80001);
+    QVERIFY(head.startsWith("HEAD / HTTP/1.0\r\n"));
+    QVERIFY(head.contains("Host: 192.168.0.1\r\n"));
+    QVERIFY(head.endsWith("\r\n\r\n"));
+}
+
+void ServiceProbeTest::testGreetings()
+{
+    ServiceProbe::Identity ssh = ServiceProbe::identify(ServiceProbe::Passive, 22,
+                                                        "SSH-2.0-OpenSSH_9.6p1 Ubuntu-3ubuntu13\r\n");
+    QCOMPARE(ssh.service, QString("SSH"));
+    QCOMPARE(ssh.version, QString("OpenSSH_9.6p1 Ubuntu-3ubuntu13"));
+
+    ServiceProbe::Identity smtp = ServiceProbe::identify(ServiceProbe::Passive, 2525,
+                                                         "220 mail.example.com ESMTP Postfix\r\n");
+    QCOMPARE(smtp.service, QString("SMTP"));
+    QCOMPARE(smtp.version, QString("mail.example.com ESMTP Postfix"));
+
+    ServiceProbe::Identity ftp = ServiceProbe::identify(ServiceProbe::Passive, 21, "220 (vsFTPd 3.0.5)\r\n");
+    QCOMPARE(ftp.service, QString("FTP"));
+    QCOMPARE(ftp.version, QString("(vsFTPd 3.0.5)"));
+
+    ServiceProbe::Identity imap = ServiceProbe::identify(ServiceProbe::Passive, 143,
+                                                         "* OK [CAPABILITY IMAP4rev1] Dovecot ready.\r\n");
+    QCOMPARE(imap.service, QString("IMAP"));
+
+    // Unknown greeting: version only, control bytes stripped
+    ServiceProbe::Identity other = ServiceProbe::identify(ServiceProbe::Passive, 6379, QByteArray("RE\x01" "DY\r\n"));
+    QVERIFY(other.service.isEmpty());
+    QCOMPARE(other.version, QString("REDY"));
+
+    // Long banners are capped
+    ServiceProbe::Identity longBanner = ServiceProbe::identify(ServiceProbe::Passive, 22,
+                                                               "SSH-2.0-" + QByteArray(1000, 'x') + "\r\n");
+    QCOMPARE(longBanner.version.size(), ServiceProbe::MAX_VERSION_LENGTH);
+
+    QVERIFY(!ServiceProbe::identify(ServiceProbe::Passive, 22, QByteArray()).isValid());
+}
+
+void ServiceProbeTest::testHttpServerHeader()
+{
+    QByteArray response = "HTTP/1.1 200 OK\r\nDate: Thu, 01 Jan 2026 00:00:00 GMT\r\n"
+                          "server: nginx/1.24.0\r\nContent-Length: 0\r\n\r\n";
+    ServiceProbe::Identity http = ServiceProbe::identify(ServiceProbe::HttpHead, 80, response);
+    QCOMPARE(http.service, QString("HTTP"));
+    QCOMPARE(http.version, QString("nginx/1.24.0"));
+
+    ServiceProbe::Identity noServer = ServiceProbe::identify(ServiceProbe::HttpHead, 80,
+                                                             "HTTP/1.0 404 Not Found\r\n\r\n");
+    QCOMPARE(noServer.service, QString("HTTP"));
+    QVERIFY(noServer.version.isEmpty());
+
+    QVERIFY(!ServiceProbe::identify(ServiceProbe::HttpHead, 80, "SSH-2.0-x\r\n").isValid());
+}
+
+void ServiceProbeTest::testCompletion()
+{
+    QVERIFY(!ServiceProbe::isComplete(ServiceProbe::Passive, "SSH-2.0-Open"));
+    QVERIFY(ServiceProbe::isComplete(ServiceProbe::Passive, "SSH-2.0-OpenSSH\r\n"));
+    QVERIFY(!ServiceProbe::isComplete(ServiceProbe::HttpHead, "HTTP/1.1 200 OK\r\nServer: x\r\n"));
+    QVERIFY(ServiceProbe::isComplete(ServiceProbe::HttpHead, "HTTP/1.1 200 OK\r\nServer: x\r\n\r\n"));
+
+    QVERIFY(ServiceProbe::responseLimit(ServiceProbe::Passive) < ServiceProbe::responseLimit(ServiceProbe::TlsHello));
+}
+
+void ServiceProbeTest::testClientHelloStructure()
+{
+    QByteArray hello = ServiceProbe::clientHello();
+
+    QVERIFY(hello.size() > 9);
+    QCOMPARE(static_cast<quint8>(hello[0]), quint8(22));                    // handshake record
+    int recordLength = (static_cast<quint8>(hello[3]) << 8) | static_cast<quint8>(hello[4]);
+    QCOMPARE(recordLength + 5, hello.size());
+
+    QCOMPARE(static_cast<quint8>(hello[5]), quint8(1));                     // ClientHello
+    int bodyLength = (static_cast<quint8>(hello[6]) << 16) | (static_cast<quint8>(hello[7]) << 8)
+                     | static_cast<quint8>(hello[8]);
+    QCOMPARE(bodyLength + 4, recordLength);
+
+    QCOMPARE(static_cast<quint8>(hello[9]), quint8(0x03));                  // client_version 1.2
+    QCOMPARE(static_cast<quint8>(hello[10]), quint8(0x03));
+
+    // Fresh random per hello
+    QVERIFY(hello.mid(11, 32) != ServiceProbe::clientHello().mid(11, 32));
+}
+
+void ServiceProbeTest::testCertificateCommonName()
+{
+    QCOMPARE(ServiceProbe::certificateCommonName(certificate("router.lan")), QString("router.lan"));
+
+    // Long-form lengths inside the certificate
+    QByteArray longName(200, 'a');
+    QCOMPARE(ServiceProbe::certificateCommonName(certificate(longName)),
+             QString(longName).left(ServiceProbe::MAX_VERSION_LENGTH));
+
+    // Control characters and non-ASCII bytes are dropped, as in banners
+    QCOMPARE(ServiceProbe::certificateCommonName(certificate("evil\x1b[31m\r\nname\xc3\xa9")),
+             QString("evil[31mname"));
+
+    // Truncated and garbage input
+    QByteArray cert = certificate("router.lan");
+    QVERIFY(ServiceProbe::certificateCommonName(cert.left(cert.size() / 2)).isEmpty());
+    QVERIFY(ServiceProbe::certificateCommonName(QByteArray("\x30\x84garbage", 9)).isEmpty());
+    QVERIFY(ServiceProbe::certificateCommonName(QByteArray()).isEmpty());
+}
+
+void ServiceProbeTest::testCertificateFromRecords()
+{
+    QByteArray cert = certificate("nas.example.com");
+    QByteArray serverHello = handshake(2, QByteArray(70, '\x01'));
+    QByteArray certificateMessage = handshake(11, u24(cert.size() + 3) + u24(cert.size()) + cert);
+    QByteArray stream = serverHello + certificateMessage + handshake(14, QByteArray());
+
+    // Split the handshake stream across two records, mid-certificate
+    int split = serverHello.size() + 20;
+    QByteArray records = record(stream.left(split)) + record(stream.mid(split));
+
+    bool complete = false;
+    QCOMPARE(ServiceProbe::firstCertificate(records, &complete), cert);
+    QVERIFY(ServiceProbe::isComplete(ServiceProbe::TlsHello, records));
+
+    ServiceProbe::Identity identity = ServiceProbe::identify(ServiceProbe::TlsHello, 443, records);
+    QVERIFY(identity.service.isEmpty());
+    QCOMPARE(identity.version, QString("CN=nas.example.com"));
+
+    // Only the first record so far: not complete yet
+    QVERIFY(ServiceProbe::firstCertificate(records.left(split + 5), &complete).isEmpty());
+    QVERIFY(!complete);
+    QVERIFY(!ServiceProbe::isComplete(ServiceProbe::TlsHello, records.left(split + 5)));
+
+    // A handshake alert ends the exchange without a certificate
+    QByteArray alert = record(QByteArray("\x02\x28", 2), 21);
+    QVERIFY(ServiceProbe::firstCertificate(alert, &complete).isEmpty());
+    QVERIFY(complete);
+    QVERIFY(ServiceProbe::isComplete(ServiceProbe::TlsHello, alert));
+}
+
+QTEST_MAIN(ServiceProbeTest)
+#include "ServiceProbeTest.moc"
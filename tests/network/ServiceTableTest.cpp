@@ -0,0 +1,97 @@
+#include <QtTest>
+#include <QSet>
+#include "network/services/ServiceTable.h"
+
+class ServiceTableTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testServiceNames();
+    void testFrequencyOrder();
+    void testTopPorts();
+    void testRankMatchesFind();
+    void testExpectedOpen();
+    void testProtocolFromString();
+};
+
+void ServiceTableTest::testServiceNames()
+{
+    const ServiceTable& services = ServiceTable::instance();
+
+    QCOMPARE(services.serviceName(22), QString("SSH"));
+    QCOMPARE(services.serviceName(80), QString("HTTP"));
+    QCOMPARE(services.serviceName(161, ServiceTable::Udp), QString("SNMP"));
+    QCOMPARE(services.serviceName(1), QString("Unknown"));
+    QCOMPARE(services.serviceName(-1), QString("Unknown"));
+    QCOMPARE(services.serviceName(70000), QString("Unknown"));
+    QVERIFY(services.find(1) == nullptr);
+}
+
+void ServiceTableTest::testFrequencyOrder()
+{
+    const ServiceTable& services = ServiceTable::instance();
+
+    for (ServiceTable::Protocol protocol : { ServiceTable::Tcp, ServiceTable::Udp }) {
+        QList<int> ports = services.topPorts(services.size(protocol), protocol);
+        QVERIFY(!ports.isEmpty());
+        for (int i = 1; i < ports.size(); ++i) {
+            QVERIFY(services.find(ports[i - 1], protocol)->frequency
+                    >= services.find(ports[i], protocol)->frequency);
+        }
+    }
+
+    QCOMPARE(services.topPorts(1).first(), 80);
+    QCOMPARE(services.rank(80), 1);
+}
+
+void ServiceTableTest::testTopPorts()
+{
+    const ServiceTable& services = ServiceTable::instance();
+
+    QList<int> top = services.topPorts(20);
+    QCOMPARE(top.size(), 20);
+    QCOMPARE(QSet<int>(top.begin(), top.end()).size(), 20);
+    QVERIFY(top.contains(22));
+    QVERIFY(top.contains(443));
+
+    // Larger requests are clamped to the table size
+    QCOMPARE(services.topPorts(100000).size(), services.size());
+    QVERIFY(services.topPorts(0).isEmpty());
+    QVERIFY(services.topPorts(-5).isEmpty());
+}
+
+void ServiceTableTest::testRankMatchesFind()
+{
+    const ServiceTable& services = ServiceTable::instance();
+
+    QList<int> ports = services.topPorts(services.size());
+    for (int i = 0; i < ports.size(); ++i) {
+        QCOMPARE(services.rank(ports[i]), i + 1);
+        QCOMPARE(services.find(ports[i])->port, ports[i]);
+    }
+    QCOMPARE(services.rank(1), 0);
+}
+
+void ServiceTableTest::testExpectedOpen()
+{
+    const ServiceTable& services = ServiceTable::instance();
+
+    double top10 = services.expectedOpen(10);
+    double top100 = services.expectedOpen(100);
+    QVERIFY(top10 > 0.0);
+    QVERIFY(top100 > top10);
+    QCOMPARE(services.expectedOpen(0), 0.0);
+    QCOMPARE(services.expectedOpen(1), services.find(80)->frequency);
+}
+
+void ServiceTableTest::testProtocolFromString()
+{
+    QCOMPARE(ServiceTable::protocolFromString("udp"), ServiceTable::Udp);
+    QCOMPARE(ServiceTable::protocolFromString("UDP"), ServiceTable::Udp);
+    QCOMPARE(ServiceTable::protocolFromString("tcp"), ServiceTable::Tcp);
+    QCOMPARE(ServiceTable::protocolFromString("sctp"), ServiceTable::Tcp);
+}
+
+QTEST_MAIN(ServiceTableTest)
+#include "ServiceTableTest.moc"
@@ -0,0 +1,112 @@
+#include <QtTest>
+#include <QTemporaryFile>
+#include "network/services/TargetSet.h"
+
+class TargetSetTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCidr();
+    void testRangesAndExclusions();
+    void testIndexMatchesIteration();
+    void testInvalidSpec();
+    void testLargeSetsAreCompact();
+    void testFromFile();
+
+private:
+    static quint32 address(const char* ip)
+    {
+        quint32 value = 0;
+        TargetSet::parseAddress(ip, ip + qstrlen(ip), value);
+        return value;
+    }
+};
+
+void TargetSetTest::testCidr()
+{
+    TargetSet set = TargetSet::fromCidr("192.168.1.0/30");
+    QCOMPARE(set.size(), quint64(2));
+    QCOMPARE(set.at(0), address("192.168.1.1"));
+    QCOMPARE(set.at(1), address("192.168.1.2"));
+
+    QCOMPARE(TargetSet::fromCidr("192.168.1.0/24").size(), quint64(254));
+    QCOMPARE(TargetSet::fromCidr("10.0.0.5/32").size(), quint64(1));
+    QVERIFY(TargetSet::fromCidr("10.0.0.5").isEmpty());
+}
+
+void TargetSetTest::testRangesAndExclusions()
+{
+    QString error;
+    TargetSet set = TargetSet::parse("10.0.0.1-5, 10.0.0.3 10.0.0.9\n!10.0.0.2 # gateway", &error);
+    QVERIFY(error.isEmpty());
+
+    QList<quint32> addresses;
+    for (quint32 value : set) {
+        addresses.append(value & 0xFF);
+    }
+    QCOMPARE(addresses, QList<quint32>() << 1 << 3 << 4 << 5 << 9);
+
+    QVERIFY(set.contains(address("10.0.0.9")));
+    QVERIFY(!set.contains(address("10.0.0.2")));
+    QVERIFY(!set.contains(address("10.0.0.6")));
+
+    // Ranges are merged, the exclusion splits them
+    QCOMPARE(set.ranges().size(), 3);
+}
+
+void TargetSetTest::testIndexMatchesIteration()
+{
+    TargetSet set = TargetSet::parse("172.16.0.0/28, 172.16.1.10-172.16.1.20, !172.16.0.4-6");
+
+    quint64 index = 0;
+    for (quint32 value : set) {
+        QCOMPARE(set.at(index), value);
+        index++;
+    }
+    QCOMPARE(index, set.size());
+    QCOMPARE(set.size(), quint64(14 - 3 + 11));
+}
+
+void TargetSetTest::testInvalidSpec()
+{
+    QString error;
+    QVERIFY(TargetSet::parse("192.168.1.256", &error).isEmpty());
+    QVERIFY(error.contains("192.168.1.256"));
+
+    QVERIFY(TargetSet::parse("10.0.0.9-3").isEmpty());
+    QVERIFY(TargetSet::parse("10.0.0.0/33").isEmpty());
+    QVERIFY(TargetSet::parse("hostname").isEmpty());
+    QVERIFY(TargetSet::parse("").isEmpty());
+}
+
+void TargetSetTest::testLargeSetsAreCompact()
+{
+    TargetSet set = TargetSet::parse("10.0.0.0/8, !10.0.0.0/16");
+
+    QCOMPARE(set.size(), quint64(16777214 - 65534));
+    QCOMPARE(set.ranges().size(), 1);
+    QCOMPARE(set.at(0), address("10.0.255.255"));
+    QCOMPARE(set.at(set.size() - 1), address("10.255.255.254"));
+}
+
+void TargetSetTest::testFromFile()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write("# targets\n192.168.0.0/24\n\n10.1.1.1\n!192.168.0.100\n");
+    file.close();
+
+    QString error;
+    TargetSet set = TargetSet::fromFile(file.fileName(), &error);
+    QVERIFY(error.isEmpty());
+    QCOMPARE(set.size(), quint64(254));
+    QVERIFY(set.contains(address("10.1.1.1")));
+    QVERIFY(!set.contains(address("192.168.0.100")));
+
+    QVERIFY(TargetSet::fromFile("/nonexistent/targets.txt", &error).isEmpty());
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_MAIN(TargetSetTest)
+#include "TargetSetTest.moc"
@@ -0,0 +1,188 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QMutex>
+#include "network/sockets/TcpConnectEngine.h"
+
+class TcpConnectEngineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testOpenAndClosedPorts();
+    void testFilteredTimeout();
+    void testMultipleHostsCompletion();
+    void testFullRangeLocalhost();
+    void testServiceProbing();
+
+private:
+    static quint32 loopback() { return QHostAddress(QHostAddress::LocalHost).toIPv4Address(); }
+};
+
+void TcpConnectEngineTest::initTestCase()
+{
+    if (!TcpConnectEngine::isSupported()) {
+        QSKIP("TcpConnectEngine is not supported on this platform");
+    }
+}
+
+void TcpConnectEngineTest::testOpenAndClosedPorts()
+{
+    // The kernel completes handshakes into the backlog, no accept() needed
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    quint16 openPort = server.serverPort();
+
+    QTcpServer probe;
+    QVERIFY(probe.listen(QHostAddress::LocalHost));
+    quint16 closedPort = probe.serverPort();
+    probe.close();
+
+    QHash<quint16, TcpConnectEngine::PortState> states;
+    TcpConnectEngine engine;
+    engine.setResultCallback([&](const TcpConnectEngine::ProbeResult& result) {
+        states.insert(result.port, result.state);
+    });
+
+    engine.addHost(loopback(), QVector<quint16>() << openPort << closedPort, 1000);
+    engine.run();
+
+    QCOMPARE(states.size(), 2);
+    QCOMPARE(states.value(openPort), TcpConnectEngine::Open);
+    QCOMPARE(states.value(closedPort), TcpConnectEngine::Closed);
+}
+
+void TcpConnectEngineTest::testFilteredTimeout()
+{
+    // TEST-NET-1 is never routed; probes time out or fail as unreachable
+    QList<TcpConnectEngine::ProbeResult> results;
+    TcpConnectEngine engine;
+    engine.setResultCallback([&](const TcpConnectEngine::ProbeResult& result) {
+        results.append(result);
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    engine.addHost(QHostAddress("192.0.2.1").toIPv4Address(), QVector<quint16>() << 80 << 443, 200);
+    engine.run();
+
+    QCOMPARE(results.size(), 2);
+    for (const TcpConnectEngine::ProbeResult& result : results) {
+        QCOMPARE(result.state, TcpConnectEngine::Filtered);
+    }
+    QVERIFY(timer.elapsed() < 2000);
+}
+
+void TcpConnectEngineTest::testMultipleHostsCompletion()
+{
+    QList<quint32> completed;
+    int probes = 0;
+
+    TcpConnectEngine engine(64, 8);
+    engine.setResultCallback([&](const TcpConnectEngine::ProbeResult&) { probes++; });
+    engine.setHostCompletedCallback([&](quint32 address) { completed.append(address); });
+
+    QVector<quint16> ports;
+    for (quint16 port = 40000; port < 40050; ++port) {
+        ports.append(port);
+    }
+
+    for (int i = 1; i <= 4; ++i) {
+        engine.addHost(QHostAddress(QString("127.0.0.%1").arg(i)).toIPv4Address(), ports, 1000);
+    }
+    engine.run();
+
+    QCOMPARE(probes, 200);
+    QCOMPARE(completed.size(), 4);
+}
+
+void TcpConnectEngineTest::testFullRangeLocalhost()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QVector<quint16> ports;
+    ports.reserve(65535);
+    for (int port = 1; port <= 65535; ++port) {
+        ports.append(static_cast<quint16>(port));
+    }
+
+    int probes = 0;
+    bool serverPortOpen = false;
+
+    TcpConnectEngine engine;
+    engine.setResultCallback([&](const TcpConnectEngine::ProbeResult& result) {
+        probes++;
+        if (result.port == server.serverPort()) {
+            serverPortOpen = (result.state == TcpConnectEngine::Open);
+        }
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    engine.addHost(loopback(), ports, 1000);
+    engine.run();
+
+    qDebug() << "Full localhost scan took" << timer.elapsed() << "ms";
+    QCOMPARE(probes, 65535);
+    QVERIFY(serverPortOpen);
+    QVERIFY(timer.elapsed() < 30000);
+}
+
+void TcpConnectEngineTest::testServiceProbing()
+{
+    // Greets every client like sshd; served from this thread's event loop
+    QTcpServer ssh;
+    QVERIFY(ssh.listen(QHostAddress::LocalHost));
+    connect(&ssh, &QTcpServer::newConnection, [&ssh]() {
+        while (QTcpSocket* client = ssh.nextPendingConnection()) {
+            client->write("SSH-2.0-OpenSSH_9.6\r\n");
+            client->flush();
+            connect(client, &QTcpSocket::disconnected, client, &QObject::deleteLater);
+        }
+    });
+
+    // Accepts but never speaks: the session ends at the probe deadline
+    QTcpServer silent;
+    QVERIFY(silent.listen(QHostAddress::LocalHost));
+
+    QMutex mutex;
+    QHash<quint16, TcpConnectEngine::ProbeResult> results;
+    TcpConnectEngine engine;
+    engine.setServiceProbing(true, 300);
+    engine.setResultCallback([&](const TcpConnectEngine::ProbeResult& result) {
+        QMutexLocker locker(&mutex);
+        results.insert(result.port, result);
+    });
+    engine.addHost(loopback(), QVector<quint16>() << ssh.serverPort() << silent.serverPort(), 1000);
+
+    QThread* worker = QThread::create([&engine]() { engine.run(); });
+    worker->start();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!worker->isFinished() && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    bool finished = worker->isFinished();
+    if (!finished) {
+        engine.cancel();
+    }
+    worker->wait();
+    delete worker;
+    QVERIFY(finished);
+
+    QCOMPARE(results.size(), 2);
+    QCOMPARE(results.value(ssh.serverPort()).state, TcpConnectEngine::Open);
+    QCOMPARE(results.value(ssh.serverPort()).service, QString("SSH"));
+    QCOMPARE(results.value(ssh.serverPort()).version, QString("OpenSSH_9.6"));
+    QCOMPARE(results.value(silent.serverPort()).state, TcpConnectEngine::Open);
+    QVERIFY(results.value(silent.serverPort()).version.isEmpty());
+}
+
+QTEST_MAIN(TcpConnectEngineTest)
+#include "TcpConnectEngineTest.moc"
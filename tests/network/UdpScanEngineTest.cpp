@@ -0,0 +1,233 @@
+#include <QtTest>
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QHostAddress>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QMutex>
+#include "network/sockets/UdpScanEngine.h"
+
+class UdpScanEngineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testPayloads();
+    void testOpenClosedAndSilentPorts();
+    void testRetriesBeforeOpenFiltered();
+    void testMultipleHostsCompletion();
+    void testPendingErrorDoesNotFailNextBatch();
+
+private:
+    static quint32 loopback() { return QHostAddress(QHostAddress::LocalHost).toIPv4Address(); }
+
+    /**
+     * @brief Run the engine on a worker so this thread's sockets can answer
+     */
+    static bool runInBackground(UdpScanEngine& engine, int timeoutMs)
+    {
+        QThread* worker = QThread::create([&engine]() { engine.run(); });
+        worker->start();
+
+        QElapsedTimer timer;
+        timer.start();
+        while (!worker->isFinished() && timer.elapsed() < timeoutMs) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        }
+
+        bool finished = worker->isFinished();
+        if (!finished) {
+            engine.cancel();
+        }
+        worker->wait();
+        delete worker;
+        return finished;
+    }
+};
+
+void UdpScanEngineTest::initTestCase()
+{
+    if (!UdpScanEngine::isSupported()) {
+        QSKIP("UdpScanEngine is not supported on this platform");
+    }
+}
+
+void UdpScanEngineTest::testPayloads()
+{
+    QByteArray dns = UdpScanEngine::payloadFor(53);
+    QCOMPARE(dns.size(), 17);
+    QCOMPARE(dns.right(4), QByteArray::fromHex("00020001"));
+
+    QByteArray ntp = UdpScanEngine::payloadFor(123);
+    QCOMPARE(ntp.size(), 48);
+    QCOMPARE(static_cast<quint8>(ntp[0]), quint8(0xE3));
+
+    QByteArray nbstat = UdpScanEngine::payloadFor(137);
+    QCOMPARE(nbstat.size(), 50);
+    QVERIFY(nbstat.contains("CKAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA"));
+
+    QByteArray snmp = UdpScanEngine::payloadFor(161);
+    QCOMPARE(static_cast<quint8>(snmp[0]), quint8(0x30));
+    QCOMPARE(static_cast<quint8>(snmp[1]) + 2, snmp.size());
+    QVERIFY(snmp.contains("public"));
+
+    QVERIFY(UdpScanEngine::payloadFor(1900).startsWith("M-SEARCH * HTTP/1.1\r\n"));
+    QVERIFY(UdpScanEngine::payloadFor(5353).contains("_services"));
+
+    // Ports without a known protocol get an empty datagram
+    QVERIFY(UdpScanEngine::payloadFor(40000).isEmpty());
+}
+
+void UdpScanEngineTest::testOpenClosedAndSilentPorts()
+{
+    // Echo responder: any reply means open
+    QUdpSocket responder;
+    QVERIFY(responder.bind(QHostAddress::LocalHost, 0));
+    connect(&responder, &QUdpSocket::readyRead, [&responder]() {
+        while (responder.hasPendingDatagrams()) {
+            QNetworkDatagram datagram = responder.receiveDatagram();
+            responder.writeDatagram(datagram.makeReply("pong"));
+        }
+    });
+
+    // Bound but never answering: no reply and no ICMP error
+    QUdpSocket silent;
+    QVERIFY(silent.bind(QHostAddress::LocalHost, 0));
+
+    // Nothing listening: the kernel answers with ICMP port unreachable
+    QUdpSocket probe;
+    QVERIFY(probe.bind(QHostAddress::LocalHost, 0));
+    quint16 closedPort = probe.localPort();
+    probe.close();
+
+    QMutex mutex;
+    QHash<quint16, UdpScanEngine::ProbeResult> results;
+
+    UdpScanEngine engine;
+    engine.setMaxRetries(0);
+    engine.setResultCallback([&](const UdpScanEngine::ProbeResult& result) {
+        QMutexLocker locker(&mutex);
+        results.insert(result.port, result);
+    });
+
+    engine.addHost(loopback(), QVector<quint16>() << responder.localPort() << silent.localPort() << closedPort, 300);
+    QVERIFY(runInBackground(engine, 5000));
+
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(results.value(responder.localPort()).state, UdpScanEngine::Open);
+    QCOMPARE(results.value(responder.localPort()).response, QByteArray("pong"));
+    QCOMPARE(results.value(closedPort).state, UdpScanEngine::Closed);
+    QCOMPARE(results.value(silent.localPort()).state, UdpScanEngine::OpenFiltered);
+}
+
+void UdpScanEngineTest::testRetriesBeforeOpenFiltered()
+{
+    QUdpSocket silent;
+    QVERIFY(silent.bind(QHostAddress::LocalHost, 0));
+
+    int reports = 0;
+    UdpScanEngine engine;
+    engine.setMaxRetries(2);
+    engine.setResultCallback([&](const UdpScanEngine::ProbeResult& result) {
+        QCOMPARE(result.state, UdpScanEngine::OpenFiltered);
+        reports++;
+    });
+
+    // Engine runs on this thread: nothing reads the socket until it returns
+    QElapsedTimer timer;
+    timer.start();
+    engine.addHost(loopback(), QVector<quint16>() << silent.localPort() << silent.localPort(), 100);
+    engine.run();
+
+    QCOMPARE(reports, 1);
+    QVERIFY(timer.elapsed() >= 300);
+
+    int datagrams = 0;
+    while (silent.hasPendingDatagrams()) {
+        silent.receiveDatagram();
+        datagrams++;
+    }
+    QCOMPARE(datagrams, 3);
+}
+
+void UdpScanEngineTest::testMultipleHostsCompletion()
+{
+    QUdpSocket probe;
+    QVERIFY(probe.bind(QHostAddress::LocalHost, 0));
+    quint16 closedPort = probe.localPort();
+    probe.close();
+
+    QList<quint32> completed;
+    int probes = 0;
+
+    UdpScanEngine engine;
+    engine.setResultCallback([&](const UdpScanEngine::ProbeResult&) { probes++; });
+    engine.setHostCompletedCallback([&](quint32 address) { completed.append(address); });
+
+    // The whole 127.0.0.0/8 is local on Linux; unreachables come back immediately
+    QVector<quint16> ports;
+    for (int i = 0; i < 20; ++i) {
+        ports.append(static_cast<quint16>(closedPort + i));
+    }
+    engine.addHost(loopback(), ports, 500);
+    engine.addHost(loopback() + 1, ports, 500);
+    engine.addHost(loopback() + 2, QVector<quint16>(), 500);
+    engine.run();
+
+    QCOMPARE(completed.size(), 3);
+    QVERIFY(completed.contains(loopback()));
+    QVERIFY(completed.contains(loopback() + 1));
+    QVERIFY(completed.contains(loopback() + 2));
+    QCOMPARE(probes, 40);
+}
+
+void UdpScanEngineTest::testPendingErrorDoesNotFailNextBatch()
+{
+    QUdpSocket responder;
+    QVERIFY(responder.bind(QHostAddress::LocalHost, 0));
+    connect(&responder, &QUdpSocket::readyRead, [&responder]() {
+        while (responder.hasPendingDatagrams()) {
+            QNetworkDatagram datagram = responder.receiveDatagram();
+            responder.writeDatagram(datagram.makeReply("pong"));
+        }
+    });
+
+    QUdpSocket probe;
+    QVERIFY(probe.bind(QHostAddress::LocalHost, 0));
+    quint16 closedPort = probe.localPort();
+    probe.close();
+
+    // Fill the first send batch so the closed port is its last datagram; its
+    // unreachable is pending on the socket when the responder's batch goes out
+    QList<QUdpSocket*> silent;
+    QVector<quint16> ports;
+    for (int i = 0; i < 63; ++i) {
+        QUdpSocket* socket = new QUdpSocket(this);
+        QVERIFY(socket->bind(QHostAddress::LocalHost, 0));
+        silent.append(socket);
+        ports.append(socket->localPort());
+    }
+    ports << closedPort << responder.localPort();
+
+    QMutex mutex;
+    QHash<quint16, UdpScanEngine::ProbeResult> results;
+
+    UdpScanEngine engine(UdpScanEngine::DEFAULT_GLOBAL_LIMIT, 128);
+    engine.setMaxRetries(0);
+    engine.setResultCallback([&](const UdpScanEngine::ProbeResult& result) {
+        QMutexLocker locker(&mutex);
+        results.insert(result.port, result);
+    });
+
+    engine.addHost(loopback(), ports, 300);
+    QVERIFY(runInBackground(engine, 5000));
+    qDeleteAll(silent);
+
+    QCOMPARE(results.size(), ports.size());
+    QCOMPARE(results.value(closedPort).state, UdpScanEngine::Closed);
+    QCOMPARE(results.value(responder.localPort()).state, UdpScanEngine::Open);
+}
+
+QTEST_MAIN(UdpScanEngineTest)
+#include "UdpScanEngineTest.moc"
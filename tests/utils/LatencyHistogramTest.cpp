@@ -0,0 +1,195 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+#include "utils/LatencyHistogram.h"
+
+class LatencyHistogramTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEmpty();
+    void testBucketsCoverValues();
+    void testPercentilesWithinResolution();
+    void testMergeEqualsCombinedRecording();
+    void testOutOfRangeValues();
+    void testBlobRoundTrip();
+    void testMalformedBlob();
+    void testCountsPastUint32();
+};
+
+void LatencyHistogramTest::testEmpty()
+{
+    LatencyHistogram histogram;
+    QVERIFY(histogram.isEmpty());
+    QCOMPARE(histogram.totalCount(), quint64(0));
+    QCOMPARE(histogram.percentile(99.0), 0.0);
+    QCOMPARE(histogram.mean(), 0.0);
+    QVERIFY(histogram.buckets().isEmpty());
+    QVERIFY(histogram.toBlob().isEmpty());
+}
+
+void LatencyHistogramTest::testBucketsCoverValues()
+{
+    // Each value lands in one bucket that contains it and is at most 1/32 wide
+    for (double latency : {0.0, 0.001, 0.063, 0.064, 0.5, 1.0, 12.345, 99.999, 1500.0, 60000.0}) {
+        LatencyHistogram histogram;
+        histogram.record(latency);
+
+        QVector<LatencyHistogram::Bucket> buckets = histogram.buckets();
+        QCOMPARE(buckets.size(), 1);
+        QVERIFY2(buckets[0].lowerMs <= latency && latency < buckets[0].upperMs,
+                 qPrintable(QString::number(latency)));
+        if (buckets[0].lowerMs >= 0.064) {
+            QVERIFY((buckets[0].upperMs - buckets[0].lowerMs) * 32 <= buckets[0].lowerMs + 1e-9);
+        }
+        QCOMPARE(buckets[0].count, quint64(1));
+    }
+}
+
+void LatencyHistogramTest::testPercentilesWithinResolution()
+{
+    QRandomGenerator random(5);
+    LatencyHistogram histogram;
+    QVector<double> samples;
+    for (int i = 0; i < 20000; ++i) {
+        // Bulk around 2-20 ms with a tail up to 500 ms
+        double latency = std::round((i % 50 == 0 ? 20.0 + random.bounded(480.0)
+                                                 : 2.0 + random.bounded(18.0)) * 1000.0) / 1000.0;
+        histogram.record(latency);
+        samples.append(latency);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    for (double percentile : {50.0, 90.0, 95.0, 99.0, 99.9}) {
+        double exact = samples[static_cast<int>(std::ceil(percentile / 100.0 * samples.size())) - 1];
+        double estimate = histogram.percentile(percentile);
+        QVERIFY2(qAbs(estimate - exact) <= exact * 0.02,
+                 qPrintable(QString("p%1: %2 vs %3").arg(percentile).arg(estimate).arg(exact)));
+    }
+
+    QCOMPARE(histogram.percentile(0.0), samples.first());
+    QCOMPARE(histogram.percentile(100.0), samples.last());
+    QCOMPARE(histogram.min(), samples.first());
+    QCOMPARE(histogram.max(), samples.last());
+}
+
+void LatencyHistogramTest::testMergeEqualsCombinedRecording()
+{
+    LatencyHistogram first;
+    LatencyHistogram second;
+    LatencyHistogram combined;
+    for (int i = 1; i <= 1000; ++i) {
+        double latency = i * 0.37;
+        (i % 3 == 0 ? first : second).record(latency);
+        combined.record(latency);
+    }
+
+    LatencyHistogram merged;
+    merged.merge(first);
+    merged.merge(second);
+    merged.merge(LatencyHistogram());
+
+    QCOMPARE(merged.totalCount(), combined.totalCount());
+    QCOMPARE(merged.min(), combined.min());
+    QCOMPARE(merged.max(), combined.max());
+    QCOMPARE(merged.mean(), combined.mean());
+    QCOMPARE(merged.toBlob(), combined.toBlob());
+}
+
+void LatencyHistogramTest::testOutOfRangeValues()
+{
+    LatencyHistogram histogram;
+    histogram.record(-1.0);
+    histogram.record(std::nan(""));
+    QVERIFY(histogram.isEmpty());
+
+    // Clamped into the last bucket
+    histogram.record(1e9);
+    QCOMPARE(histogram.totalCount(), quint64(1));
+    QCOMPARE(histogram.max(), LatencyHistogram::MAX_VALUE_US / 1000.0);
+
+    histogram.record(5.0, 10);
+    QCOMPARE(histogram.totalCount(), quint64(11));
+    QVERIFY(qAbs(histogram.percentile(50.0) - 5.0) <= 5.0 * 0.02);
+}
+
+void LatencyHistogramTest::testBlobRoundTrip()
+{
+    LatencyHistogram histogram;
+    for (int i = 0; i < 500; ++i) {
+        histogram.record(1.0 + (i % 37) * 0.25);
+    }
+    histogram.record(250.0);
+
+    QByteArray blob = histogram.toBlob();
+    QVERIFY(blob.size() < 200);
+
+    bool ok = false;
+    LatencyHistogram restored = LatencyHistogram::fromBlob(blob, &ok);
+    QVERIFY(ok);
+    QCOMPARE(restored.totalCount(), histogram.totalCount());
+    QCOMPARE(restored.min(), histogram.min());
+    QCOMPARE(restored.max(), histogram.max());
+    QCOMPARE(restored.mean(), histogram.mean());
+    QCOMPARE(restored.percentile(95.0), histogram.percentile(95.0));
+    QCOMPARE(restored.toBlob(), blob);
+
+    restored = LatencyHistogram::fromBlob(QByteArray(), &ok);
+    QVERIFY(ok);
+    QVERIFY(restored.isEmpty());
+}
+
+void LatencyHistogramTest::testMalformedBlob()
+{
+    LatencyHistogram histogram;
+    histogram.record(10.0);
+    histogram.record(20.0);
+    QByteArray blob = histogram.toBlob();
+
+    bool ok = true;
+    QByteArray truncated = blob;
+    truncated.append(static_cast<char>(0x80));
+    QVERIFY(LatencyHistogram::fromBlob(truncated, &ok).isEmpty());
+    QVERIFY(!ok);
+
+    QByteArray otherVersion = blob;
+    otherVersion[0] = 0x7F;
+    QVERIFY(LatencyHistogram::fromBlob(otherVersion, &ok).isEmpty());
+    QVERIFY(!ok);
+
+    QVERIFY(LatencyHistogram::fromBlob(blob.left(1), &ok).isEmpty());
+    QVERIFY(!ok);
+}
+
+void LatencyHistogramTest::testCountsPastUint32()
+{
+    const quint64 large = 0xFFFFFFFFull;
+
+    LatencyHistogram histogram;
+    histogram.record(5.0, large);
+    LatencyHistogram other;
+    other.record(5.0, 2);
+    other.record(8.0, large);
+
+    // Same bucket summed past 2^32 must not wrap
+    histogram.merge(other);
+    QCOMPARE(histogram.totalCount(), 2 * large + 2);
+
+    QVector<LatencyHistogram::Bucket> buckets = histogram.buckets();
+    QCOMPARE(buckets.size(), 2);
+    QCOMPARE(buckets[0].count, large + 2);
+    QCOMPARE(buckets[1].count, large);
+    QVERIFY(qAbs(histogram.percentile(50.0) - 5.0) <= 5.0 * 0.02);
+    QVERIFY(qAbs(histogram.percentile(51.0) - 8.0) <= 8.0 * 0.02);
+
+    bool ok = false;
+    LatencyHistogram restored = LatencyHistogram::fromBlob(histogram.toBlob(), &ok);
+    QVERIFY(ok);
+    QCOMPARE(restored.totalCount(), histogram.totalCount());
+    QCOMPARE(restored.buckets()[0].count, large + 2);
+}
+
+QTEST_MAIN(LatencyHistogramTest)
+#include "LatencyHistogramTest.moc"
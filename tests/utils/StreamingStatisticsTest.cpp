@@ -0,0 +1,235 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+#include "utils/StreamingStatistics.h"
+
+class StreamingStatisticsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRingBufferEvictsOldest();
+    void testRunningStatsMatchesBatch();
+    void testRunningStatsSlidingWindow();
+    void testP2QuantileExactForFewValues();
+    void testP2QuantileUniformStream();
+    void testWindowedMinMaxMatchesBruteForce();
+    void testWindowedMinMaxSkip();
+    void testInterarrivalJitterFollowsRfc3550();
+    void testInterarrivalJitterWindow();
+};
+
+void StreamingStatisticsTest::testRingBufferEvictsOldest()
+{
+    RingBuffer<int, 3> buffer;
+    QVERIFY(buffer.isEmpty());
+
+    int evicted = -1;
+    QVERIFY(!buffer.push(1, &evicted));
+    QVERIFY(!buffer.push(2, &evicted));
+    QVERIFY(!buffer.push(3, &evicted));
+    QVERIFY(buffer.isFull());
+    QCOMPARE(evicted, -1);
+
+    QVERIFY(buffer.push(4, &evicted));
+    QCOMPARE(evicted, 1);
+    QCOMPARE(buffer.size(), 3);
+    QCOMPARE(buffer.oldest(), 2);
+    QCOMPARE(buffer.at(1), 3);
+    QCOMPARE(buffer.newest(), 4);
+
+    buffer.clear();
+    QVERIFY(buffer.isEmpty());
+    buffer.push(5);
+    QCOMPARE(buffer.oldest(), 5);
+    QCOMPARE(buffer.newest(), 5);
+}
+
+void StreamingStatisticsTest::testRunningStatsMatchesBatch()
+{
+    // Same data as LatencyCalculatorTest::testCalculateStdDev
+    const double values[] = {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0};
+    RunningStats stats;
+    for (double value : values) {
+        stats.add(value);
+    }
+
+    QCOMPARE(stats.count(), qint64(8));
+    QCOMPARE(stats.mean(), 5.0);
+    QVERIFY(qAbs(stats.variance() - 32.0 / 7.0) < 1e-9);
+
+    stats.clear();
+    QCOMPARE(stats.count(), qint64(0));
+    QCOMPARE(stats.stdDev(), 0.0);
+    stats.add(42.0);
+    QCOMPARE(stats.mean(), 42.0);
+    QCOMPARE(stats.stdDev(), 0.0);
+}
+
+void StreamingStatisticsTest::testRunningStatsSlidingWindow()
+{
+    QRandomGenerator random(7);
+    RingBuffer<double, 10> window;
+    RunningStats stats;
+
+    for (int i = 0; i < 1000; ++i) {
+        double value = 1.0 + random.bounded(100.0);
+        double evicted = 0.0;
+        if (window.push(value, &evicted)) {
+            stats.remove(evicted);
+        }
+        stats.add(value);
+
+        double sum = 0.0;
+        for (int j = 0; j < window.size(); ++j) {
+            sum += window.at(j);
+        }
+        double mean = sum / window.size();
+        double squares = 0.0;
+        for (int j = 0; j < window.size(); ++j) {
+            squares += (window.at(j) - mean) * (window.at(j) - mean);
+        }
+        double variance = window.size() > 1 ? squares / (window.size() - 1) : 0.0;
+
+        QVERIFY(qAbs(stats.mean() - mean) < 1e-6);
+        QVERIFY(qAbs(stats.variance() - variance) < 1e-6);
+    }
+}
+
+void StreamingStatisticsTest::testP2QuantileExactForFewValues()
+{
+    P2Quantile median(0.5);
+    QCOMPARE(median.value(), 0.0);
+
+    median.add(30.0);
+    median.add(10.0);
+    median.add(20.0);
+    QCOMPARE(median.count(), qint64(3));
+    QCOMPARE(median.value(), 20.0);
+
+    median.add(40.0);
+    QCOMPARE(median.value(), 25.0);
+}
+
+void StreamingStatisticsTest::testP2QuantileUniformStream()
+{
+    QRandomGenerator random(11);
+    P2Quantile p50(0.5);
+    P2Quantile p95(0.95);
+    P2Quantile p99(0.99);
+
+    for (int i = 0; i < 20000; ++i) {
+        double value = random.bounded(1000.0);
+        p50.add(value);
+        p95.add(value);
+        p99.add(value);
+    }
+
+    // Within 2% of the range of the true quantiles
+    QVERIFY2(qAbs(p50.value() - 500.0) < 20.0, qPrintable(QString::number(p50.value())));
+    QVERIFY2(qAbs(p95.value() - 950.0) < 20.0, qPrintable(QString::number(p95.value())));
+    QVERIFY2(qAbs(p99.value() - 990.0) < 20.0, qPrintable(QString::number(p99.value())));
+
+    p95.clear();
+    QCOMPARE(p95.count(), qint64(0));
+    QCOMPARE(p95.quantile(), 0.95);
+}
+
+void StreamingStatisticsTest::testWindowedMinMaxMatchesBruteForce()
+{
+    QRandomGenerator random(3);
+    WindowedMinMax<8> range;
+    QVector<double> history;
+
+    for (int i = 0; i < 500; ++i) {
+        double value = random.bounded(50);     // Repeats exercise ties
+        range.push(value);
+        history.append(value);
+
+        auto first = history.end() - qMin(8, static_cast<int>(history.size()));
+        QCOMPARE(range.min(), *std::min_element(first, history.end()));
+        QCOMPARE(range.max(), *std::max_element(first, history.end()));
+    }
+}
+
+void StreamingStatisticsTest::testWindowedMinMaxSkip()
+{
+    WindowedMinMax<3> range;
+    QVERIFY(range.isEmpty());
+    QCOMPARE(range.min(), 0.0);
+
+    range.push(5.0);
+    range.push(1.0);
+    range.skip();
+    QCOMPARE(range.min(), 1.0);
+    QCOMPARE(range.max(), 5.0);
+
+    range.skip();               // 5.0 leaves the window
+    QCOMPARE(range.min(), 1.0);
+    QCOMPARE(range.max(), 1.0);
+
+    range.skip();               // Only skipped positions left
+    QVERIFY(range.isEmpty());
+
+    range.push(7.0);
+    QCOMPARE(range.min(), 7.0);
+    range.clear();
+    QVERIFY(range.isEmpty());
+}
+
+void StreamingStatisticsTest::testInterarrivalJitterFollowsRfc3550()
+{
+    QRandomGenerator random(13);
+    InterarrivalJitter jitter;
+    QCOMPARE(jitter.smoothed(), 0.0);
+
+    jitter.add(20.0);
+    QCOMPARE(jitter.count(), qint64(1));
+    QCOMPARE(jitter.smoothed(), 0.0);
+    QCOMPARE(jitter.windowed(), 0.0);
+
+    double previous = 20.0;
+    double expected = 0.0;
+    for (int i = 0; i < 1000; ++i) {
+        double transit = 15.0 + random.bounded(10.0);
+        expected += (std::abs(transit - previous) - expected) / 16.0;
+        previous = transit;
+        jitter.add(transit);
+    }
+    QCOMPARE(jitter.smoothed(), expected);
+
+    // Uniform on [15, 25): E|D| = 10/3
+    QVERIFY2(qAbs(jitter.smoothed() - 10.0 / 3.0) < 1.0, qPrintable(QString::number(jitter.smoothed())));
+
+    jitter.clear();
+    QCOMPARE(jitter.count(), qint64(0));
+    QCOMPARE(jitter.smoothed(), 0.0);
+    QCOMPARE(jitter.windowed(), 0.0);
+}
+
+void StreamingStatisticsTest::testInterarrivalJitterWindow()
+{
+    InterarrivalJitter jitter;
+
+    // Alternating 10/12 ms: |D| = 2 for every pair
+    for (int i = 0; i <= InterarrivalJitter::WINDOW; ++i) {
+        jitter.add(i % 2 == 0 ? 10.0 : 12.0);
+    }
+    QCOMPARE(jitter.windowed(), 2.0);
+    QVERIFY(jitter.smoothed() < 2.0);   // Still converging from 0
+
+    // A step of 30 ms enters the window at full weight
+    jitter.add(40.0);
+    QCOMPARE(jitter.windowed(), (2.0 * (InterarrivalJitter::WINDOW - 1) + 30.0) / InterarrivalJitter::WINDOW);
+
+    // ...and leaves it after WINDOW more differences
+    for (int i = 0; i < InterarrivalJitter::WINDOW; ++i) {
+        jitter.add(40.0);
+    }
+    QCOMPARE(jitter.windowed(), 0.0);
+    QVERIFY(jitter.smoothed() > 0.0);
+}
+
+QTEST_MAIN(StreamingStatisticsTest)
+#include "StreamingStatisticsTest.moc"
@@ -0,0 +1,174 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QHash>
+#include "utils/TimerWheel.h"
+
+class TimerWheelTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testFiresAtDeadline();
+    void testPastDeadlineFiresNext();
+    void testRemove();
+    void testRescheduleFiredTimer();
+    void testStaleIdRejected();
+    void testCascadesFromUpperLevels();
+    void testMatchesReferenceSchedule();
+};
+
+void TimerWheelTest::testFiresAtDeadline()
+{
+    TimerWheel wheel(10, 0);
+    wheel.schedule(25, 1);      // Rounded up to tick 3 (30 ms)
+    wheel.schedule(30, 2);
+    wheel.schedule(100, 3);
+    QCOMPARE(wheel.pendingCount(), 3);
+
+    QVector<quint64> fired;
+    wheel.advance(29, fired);
+    QVERIFY(fired.isEmpty());
+
+    wheel.advance(30, fired);
+    std::sort(fired.begin(), fired.end());
+    QCOMPARE(fired, QVector<quint64>({1, 2}));
+
+    fired.clear();
+    wheel.advance(99, fired);
+    QVERIFY(fired.isEmpty());
+    wheel.advance(100, fired);
+    QCOMPARE(fired, QVector<quint64>({3}));
+    QCOMPARE(wheel.pendingCount(), 0);
+}
+
+void TimerWheelTest::testPastDeadlineFiresNext()
+{
+    TimerWheel wheel(10, 1000);
+    QVector<quint64> fired;
+    wheel.advance(5000, fired);
+
+    wheel.schedule(100, 7);
+    wheel.advance(5000, fired);
+    QCOMPARE(fired, QVector<quint64>({7}));
+}
+
+void TimerWheelTest::testRemove()
+{
+    TimerWheel wheel(10, 0);
+    TimerWheel::Id keep = wheel.schedule(50, 1);
+    TimerWheel::Id drop = wheel.schedule(50, 2);
+
+    QVERIFY(wheel.remove(drop));
+    QVERIFY(!wheel.remove(drop));
+    QVERIFY(!wheel.isPending(drop));
+    QVERIFY(wheel.isPending(keep));
+
+    QVector<quint64> fired;
+    wheel.advance(60, fired);
+    QCOMPARE(fired, QVector<quint64>({1}));
+}
+
+void TimerWheelTest::testRescheduleFiredTimer()
+{
+    TimerWheel wheel(10, 0);
+    TimerWheel::Id id = wheel.schedule(10, 4);
+
+    QVector<quint64> fired;
+    wheel.advance(10, fired);
+    QCOMPARE(fired.size(), 1);
+    QVERIFY(!wheel.isPending(id));
+    QCOMPARE(wheel.dueMs(id), qint64(-1));
+
+    // The same id rearms
+    QVERIFY(wheel.reschedule(id, 40));
+    QVERIFY(wheel.isPending(id));
+    QCOMPARE(wheel.dueMs(id), qint64(40));
+
+    // Pulling a pending timer earlier moves it
+    QVERIFY(wheel.reschedule(id, 20));
+    fired.clear();
+    wheel.advance(20, fired);
+    QCOMPARE(fired, QVector<quint64>({4}));
+}
+
+void TimerWheelTest::testStaleIdRejected()
+{
+    TimerWheel wheel(10, 0);
+    TimerWheel::Id first = wheel.schedule(10, 1);
+    wheel.remove(first);
+
+    // The slot is reused under a new id
+    TimerWheel::Id second = wheel.schedule(10, 2);
+    QVERIFY(second != first);
+    QVERIFY(!wheel.reschedule(first, 100));
+    QVERIFY(!wheel.remove(first));
+    QVERIFY(!wheel.isPending(0));
+    QVERIFY(wheel.isPending(second));
+}
+
+void TimerWheelTest::testCascadesFromUpperLevels()
+{
+    TimerWheel wheel(1, 0);
+    // One deadline per level: root, level 1, level 2, level 3
+    const QVector<qint64> deadlines = {200, 5000, 300000, 20000000};
+    for (int i = 0; i < deadlines.size(); ++i) {
+        wheel.schedule(deadlines[i], static_cast<quint64>(i));
+    }
+
+    QVector<quint64> fired;
+    for (int i = 0; i < deadlines.size(); ++i) {
+        wheel.advance(deadlines[i] - 1, fired);
+        QCOMPARE(fired.size(), i);
+        wheel.advance(deadlines[i], fired);
+        QCOMPARE(fired.size(), i + 1);
+        QCOMPARE(fired.last(), static_cast<quint64>(i));
+    }
+}
+
+void TimerWheelTest::testMatchesReferenceSchedule()
+{
+    // Random adds, removes and reschedules checked against a plain map
+    QRandomGenerator random(1234);
+    TimerWheel wheel(10, 0);
+    QHash<quint64, qint64> expected;    // Payload -> tick-rounded deadline
+    QHash<quint64, TimerWheel::Id> ids;
+    quint64 nextPayload = 1;
+    qint64 now = 0;
+
+    for (int step = 0; step < 2000; ++step) {
+        int action = random.bounded(10);
+        if (action < 5) {
+            qint64 due = now + random.bounded(400000);
+            quint64 payload = nextPayload++;
+            ids.insert(payload, wheel.schedule(due, payload));
+            expected.insert(payload, (due + 9) / 10 * 10);
+        } else if (action < 7 && !ids.isEmpty()) {
+            quint64 payload = ids.keys().at(random.bounded(ids.size()));
+            qint64 due = now + random.bounded(400000);
+            QVERIFY(wheel.reschedule(ids.value(payload), due));
+            expected.insert(payload, (due + 9) / 10 * 10);
+        } else if (action < 8 && !ids.isEmpty()) {
+            quint64 payload = ids.keys().at(random.bounded(ids.size()));
+            QVERIFY(wheel.remove(ids.take(payload)));
+            expected.remove(payload);
+        }
+
+        now += random.bounded(3000);
+        QVector<quint64> fired;
+        wheel.advance(now, fired);
+
+        for (quint64 payload : fired) {
+            QVERIFY(expected.contains(payload));
+            QVERIFY(expected.value(payload) <= now);
+            expected.remove(payload);
+            wheel.remove(ids.take(payload));
+        }
+        for (auto it = expected.constBegin(); it != expected.constEnd(); ++it) {
+            QVERIFY2(it.value() > now, "Timer due but not fired");
+        }
+        QCOMPARE(wheel.pendingCount(), expected.size());
+    }
+}
+
+QTEST_MAIN(TimerWheelTest)
+#include "TimerWheelTest.moc"